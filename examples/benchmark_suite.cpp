@@ -0,0 +1,869 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <string.h>
+#include <cstdio>
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/OrganizedPointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborFLANN.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborANN.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborSTANN.h"
+#include "brics_3d/algorithm/registration/PointCorrespondenceKDTree.h"
+#include "brics_3d/algorithm/registration/IterativeClosestPoint.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationSVD.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationQUAT.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationHELIX.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationAPX.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationORTHO.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationPointToPlane.h"
+#include "brics_3d/algorithm/segmentation/objectModels/ObjectModelPlane.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACMethodRANSAC.h"
+#include "brics_3d/algorithm/segmentation/EuclideanClustering.h"
+#include "brics_3d/algorithm/segmentation/OrganizedConnectedComponents.h"
+#include "brics_3d/algorithm/featureExtraction/ParallelNormalEstimation.h"
+#include "brics_3d/algorithm/featureExtraction/IntegralImageNormalEstimation.h"
+#include "brics_3d/algorithm/filtering/Octree.h"
+#include "brics_3d/algorithm/filtering/VoxelGridFilter.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphFacade.h"
+#include "brics_3d/worldModel/sceneGraph/UpdateObserverDispatcher.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphLogWriter.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphLogReader.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphToUpdatesTraverser.h"
+#include "brics_3d/worldModel/sceneGraph/Box.h"
+#ifdef BRICS_OPENCV_ENABLE
+#include "brics_3d/algorithm/depthPerception/DepthImageToPointCloudTransformation.h"
+#endif
+#include "brics_3d/util/SimplePointCloudGeneratorCube.h"
+#include "brics_3d/util/BenchmarkRunner.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+using namespace brics_3d::rsg;
+
+/*
+ * Headless benchmark suite for regression tracking between releases. All cases work on synthetic data
+ * (mostly the surface of a cube), so no data files and no visualization are required.
+ *
+ * Usage: benchmark_suite [--points <n>] [--repetitions <n>] [--warmup <n>] [--filter <substring>] [--json <file>] [--csv <file>]
+ *
+ * Without --json or --csv the results are written to benchmark_suite.json and benchmark_suite.csv in
+ * the time stamp folder of the log files directory (see Benchmark).
+ */
+
+namespace {
+
+void constructPointCloud(const vector<double>* coordinates) {
+	PointCloud3D pointCloud;
+	for (unsigned int i = 0; i + 2 < coordinates->size(); i += 3) {
+		pointCloud.addPoint(Point3D((*coordinates)[i], (*coordinates)[i + 1], (*coordinates)[i + 2]));
+	}
+}
+
+void transformPointCloud(PointCloud3D* pointCloud, IHomogeneousMatrix44* transformation) {
+	pointCloud->homogeneousTransformation(transformation);
+}
+
+void setNearestNeighborData(INearestPoint3DNeighbor* nearestNeighborSearch, PointCloud3D* pointCloud) {
+	nearestNeighborSearch->setData(pointCloud);
+}
+
+void queryNearestNeighbors(INearestPoint3DNeighbor* nearestNeighborSearch, PointCloud3D* queries, unsigned int k) {
+	vector<int> indices;
+	vector<double> distances;
+	nearestNeighborSearch->findNearestNeighbors(queries, &indices, &distances, k);
+}
+
+void findCorrespondences(IPointCorrespondence* assigner, PointCloud3D* model, PointCloud3D* data) {
+	vector<CorrespondencePoint3DPair> pointPairs;
+	assigner->createNearestNeighborCorrespondence(model, data, &pointPairs);
+}
+
+void resetRandomSeed() {
+	srand(0);
+}
+
+void computeSACModel(ISACMethods* sacMethod) {
+	sacMethod->computeModel();
+}
+
+void extractClusters(EuclideanClustering* clustering, PointCloud3D* pointCloud) {
+	clustering->setPointCloud(pointCloud);
+	clustering->segment();
+	vector<PointCloud3D*> clusters;
+	clustering->getExtractedClusters(clusters);
+	for (unsigned int i = 0; i < clusters.size(); ++i) {
+		delete clusters[i]; // the clusters belong to the caller
+	}
+}
+
+/* A depth camera view of a table with boxes: back projected with a pinhole model, 1/9 of the pixels invalid */
+void createOrganizedScene(unsigned int width, unsigned int height, OrganizedPointCloud3D* organizedCloud) {
+	organizedCloud->resize(width, height);
+	double focalLength = 0.82 * width;
+	for (unsigned int row = 0; row < height; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			if ((row * width + col) % 9 == 4) {
+				continue;
+			}
+			double depth = 1.5 + 0.5 * row / height;
+			if ((col / (width / 8)) % 2 == 1 && row > height / 2) { // boxes in front of the table
+				depth -= 0.3;
+			}
+			double rayX = (col - 0.5 * width) / focalLength;
+			double rayZ = -(row - 0.5 * height) / focalLength;
+			organizedCloud->setPoint(row, col, depth * rayX, depth, depth * rayZ);
+		}
+	}
+}
+
+void estimateOrganizedNormals(IntegralImageNormalEstimation* estimator, OrganizedPointCloud3D* organizedCloud, NormalSet3D* normals) {
+	estimator->estimateNormals(organizedCloud, normals);
+}
+
+void estimateNormals(INormalEstimation* estimator, PointCloud3D* pointCloud, NormalSet3D* normals) {
+	estimator->estimateNormals(pointCloud, normals);
+}
+
+void segmentOrganizedCloud(OrganizedConnectedComponents* connectedComponents) {
+	connectedComponents->segment();
+}
+
+void filterPointCloud(IFiltering* filter, PointCloud3D* pointCloud) {
+	PointCloud3D result;
+	filter->filter(pointCloud, &result);
+}
+
+void queryNodesByAttributes(SceneGraphFacade* scene, vector<Attribute>* queries) {
+	vector<unsigned int> ids;
+	vector<Attribute> query(1);
+	for (unsigned int i = 0; i < queries->size(); ++i) {
+		query[0] = (*queries)[i];
+		scene->getNodes(query, ids);
+	}
+}
+
+void queryTransformsForNodes(SceneGraphFacade* scene, vector<unsigned int>* ids, unsigned int referenceId) {
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+	for (unsigned int i = 0; i < ids->size(); ++i) {
+		scene->getTransformForNode((*ids)[i], referenceId, TimeStamp(1.0), transform);
+	}
+}
+
+/* a uniformly distributed random number in [min, max] */
+double randomValue(double min, double max) {
+	return min + (max - min) * (std::rand() / static_cast<double>(RAND_MAX));
+}
+
+/*
+ * A synthetic indoor scene: floor, three walls of a 6 x 4 x 2.5 m room and a box on the floor,
+ * sampled with 5 mm noise.
+ */
+void createIndoorScene(PointCloud3D* scene, unsigned int numberOfPoints) {
+	const double noise = 0.005;
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		double x = 0, y = 0, z = 0;
+		switch (i % 5) {
+		case 0: // floor
+			x = randomValue(0.0, 6.0); y = randomValue(0.0, 4.0); z = 0.0;
+			break;
+		case 1: // back wall
+			x = randomValue(0.0, 6.0); y = 4.0; z = randomValue(0.0, 2.5);
+			break;
+		case 2: // left wall
+			x = 0.0; y = randomValue(0.0, 4.0); z = randomValue(0.0, 2.5);
+			break;
+		case 3: // right wall
+			x = 6.0; y = randomValue(0.0, 4.0); z = randomValue(0.0, 2.5);
+			break;
+		default: // top and front side of a box
+			if (std::rand() % 2 == 0) {
+				x = randomValue(2.0, 3.0); y = randomValue(1.0, 1.8); z = 0.8;
+			} else {
+				x = randomValue(2.0, 3.0); y = 1.0; z = randomValue(0.0, 0.8);
+			}
+			break;
+		}
+		scene->addPoint(Point3D(x + randomValue(-noise, noise), y + randomValue(-noise, noise), z + randomValue(-noise, noise)));
+	}
+}
+
+void copyTransformedPointCloud(PointCloud3D* source, IHomogeneousMatrix44* transformation, PointCloud3D* destination) {
+	destination->getPointCloud()->clear();
+	for (unsigned int i = 0; i < source->getSize(); ++i) {
+		destination->addPoint((*source->getConstPointCloud())[i]);
+	}
+	destination->homogeneousTransformation(transformation);
+}
+
+void matchPointClouds(IterativeClosestPoint* icp, PointCloud3D* model, PointCloud3D* data, string* error) {
+	HomogeneousMatrix44 resultTransformation;
+	try {
+		icp->match(model, data, &resultTransformation);
+	} catch (std::runtime_error& e) {
+		*error = e.what();
+	}
+}
+
+/* root mean square distance of corresponding points */
+double computeRMSError(PointCloud3D* expected, PointCloud3D* actual) {
+	double squaredError = 0.0;
+	for (unsigned int i = 0; i < expected->getSize(); ++i) {
+		double dx = (*expected->getConstPointCloud())[i].getX() - (*actual->getConstPointCloud())[i].getX();
+		double dy = (*expected->getConstPointCloud())[i].getY() - (*actual->getConstPointCloud())[i].getY();
+		double dz = (*expected->getConstPointCloud())[i].getZ() - (*actual->getConstPointCloud())[i].getZ();
+		squaredError += dx * dx + dy * dy + dz * dz;
+	}
+	return std::sqrt(squaredError / expected->getSize());
+}
+
+/*
+ * Concurrent access to a SceneGraphFacade: 10 robots with a kinematic chain of 10 transforms each, every link
+ * has a leaf node. Readers query global transforms and attributes, writers update random transforms.
+ */
+class SceneGraphStressTest {
+public:
+	SceneGraphStressTest(bool useExternalMutex) : useExternalMutex(useExternalMutex), stop(false) {
+		vector<Attribute> leafAttributes;
+		leafAttributes.push_back(Attribute("type","leaf"));
+		vector<Attribute> noAttributes;
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr identity(new HomogeneousMatrix44());
+		for (int robot = 0; robot < 10; ++robot) {
+			unsigned int parentId = scene.getRootId();
+			for (int link = 0; link < 10; ++link) {
+				unsigned int transformId = 0;
+				unsigned int leafId = 0;
+				scene.addTransformNode(parentId, transformId, noAttributes, identity, TimeStamp(0.0));
+				scene.addNode(transformId, leafId, leafAttributes);
+				transformIds.push_back(transformId);
+				leafIds.push_back(leafId);
+				parentId = transformId;
+			}
+		}
+		if (!useExternalMutex) {
+			scene.setConcurrencyMode(SceneGraphFacade::snapshotIsolation);
+		}
+	};
+
+	/* a fixed number of random global transform queries; every 16th query is followed by an attribute query */
+	void read(unsigned int seed, unsigned int numberOfQueries) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+		vector<Attribute> attributes;
+		attributes.push_back(Attribute("type","leaf"));
+		vector<unsigned int> ids;
+		for (unsigned int count = 0; count < numberOfQueries; ++count) {
+			unsigned int leafId = leafIds[rand_r(&seed) % leafIds.size()];
+			boost::mutex::scoped_lock lock(mutex, boost::defer_lock);
+			if (useExternalMutex) {
+				lock.lock();
+			}
+			scene.getTransformForNode(leafId, scene.getRootId(), TimeStamp(0.0), transform);
+			if (count % 16 == 0) {
+				scene.getNodes(attributes, ids);
+			}
+		}
+	}
+
+	/* random transform updates until stop is set */
+	void write(unsigned int seed) {
+		unsigned long count = 0;
+		while (!stop) {
+			unsigned int transformId = transformIds[rand_r(&seed) % transformIds.size()];
+			IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 0.01 * (count % 100),0,0));
+			boost::mutex::scoped_lock lock(mutex, boost::defer_lock);
+			if (useExternalMutex) {
+				lock.lock();
+			}
+			scene.setTransform(transformId, transform, TimeStamp(count * 0.001));
+			count++;
+		}
+	}
+
+	/* the readers perform their queries while the writers keep updating */
+	void run(unsigned int numberOfReaders, unsigned int numberOfWriters, unsigned int queriesPerReader) {
+		stop = false;
+		boost::thread_group writers;
+		for (unsigned int i = 0; i < numberOfWriters; ++i) {
+			writers.create_thread(boost::bind(&SceneGraphStressTest::write, this, 100 + i));
+		}
+		boost::thread_group readers;
+		for (unsigned int i = 0; i < numberOfReaders; ++i) {
+			readers.create_thread(boost::bind(&SceneGraphStressTest::read, this, i + 1, queriesPerReader));
+		}
+		readers.join_all();
+		stop = true;
+		writers.join_all();
+	}
+
+	SceneGraphFacade scene;
+	bool useExternalMutex;
+	boost::atomic<bool> stop;
+	boost::mutex mutex;
+	vector<unsigned int> transformIds;
+	vector<unsigned int> leafIds;
+};
+
+/* Observer that needs a fixed time per transform update, like a visualizer or a network bridge */
+class SlowObserver : public ISceneGraphUpdateObserver {
+public:
+	SlowObserver(unsigned int microsecondsPerUpdate) : microsecondsPerUpdate(microsecondsPerUpdate) {};
+
+	bool addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false) { return true; };
+	bool addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false) { return true; };
+	bool addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool setNodeAttributes(Id id, vector<Attribute> newAttributes) { return true; };
+	bool setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) {
+		boost::this_thread::sleep(boost::posix_time::microseconds(microsecondsPerUpdate));
+		return true;
+	};
+	bool setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) { return true; };
+	bool deleteNode(Id id) { return true; };
+	bool addParent(Id id, Id parentId) { return true; };
+	bool removeParent(Id id, Id parentId) { return true; };
+
+	unsigned int microsecondsPerUpdate;
+};
+
+/* A burst of setTransform calls on a set of transform nodes; the slow observer is attached to the scene graph. */
+void updateTransforms(SceneGraphFacade* scene, vector<unsigned int>* transformIds, unsigned int numberOfUpdates) {
+	for (unsigned int i = 0; i < numberOfUpdates; ++i) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 0.001 * i,0,0));
+		scene->setTransform((*transformIds)[i % transformIds->size()], transform, TimeStamp(i * 0.001));
+	}
+}
+
+/* Deliver the backlog of the previous run, so every run starts with an empty queue */
+void flushDispatcher(UpdateObserverDispatcher* dispatcher) {
+	if (dispatcher != 0) {
+		dispatcher->flush();
+	}
+}
+
+/* Receiver that ignores all updates, to measure the decoding of a log alone */
+class NullReceiver : public ISceneGraphUpdate {
+public:
+	bool addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false) { return true; };
+	bool addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false) { return true; };
+	bool addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId = false) { return true; };
+	bool setNodeAttributes(Id id, vector<Attribute> newAttributes) { return true; };
+	bool setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) { return true; };
+	bool setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) { return true; };
+	bool deleteNode(Id id) { return true; };
+	bool addParent(Id id, Id parentId) { return true; };
+	bool removeParent(Id id, Id parentId) { return true; };
+};
+
+/* groups of 100 transforms with 3 history entries each; every transform has a box as child */
+void createLoggedScene(SceneGraphFacade* scene, unsigned int numberOfNodes) {
+	vector<Attribute> attributes;
+	unsigned int groupId = 0;
+	for (unsigned int i = 0; 2 * i < numberOfNodes; ++i) {
+		if (i % 100 == 0) {
+			attributes.clear();
+			attributes.push_back(Attribute("type","group"));
+			scene->addGroup(scene->getRootId(), groupId, attributes);
+		}
+		unsigned int transformId = 0;
+		unsigned int boxId = 0;
+		attributes.clear();
+		stringstream name;
+		name << "object_" << i;
+		attributes.push_back(Attribute("name", name.str()));
+		for (int t = 0; t < 3; ++t) {
+			IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, i,t,0));
+			if (t == 0) {
+				scene->addTransformNode(groupId, transformId, attributes, transform, TimeStamp(t));
+			} else {
+				scene->setTransform(transformId, transform, TimeStamp(t));
+			}
+		}
+		Box::BoxPtr box(new Box(0.1, 0.2, 0.3));
+		scene->addGeometricNode(transformId, boxId, attributes, box, TimeStamp(0.0));
+	}
+}
+
+void writeLogSnapshot(SceneGraphFacade* scene, string* logFile) {
+	SceneGraphLogWriter logWriter;
+	logWriter.open(*logFile, scene->getRootId());
+	logWriter.writeSnapshot(scene);
+	logWriter.close();
+}
+
+void decodeLog(string* logFile) {
+	NullReceiver nullReceiver;
+	SceneGraphLogReader logReader;
+	logReader.open(*logFile);
+	logReader.replay(&nullReceiver, 0);
+}
+
+void restoreLog(string* logFile, boost::scoped_ptr<SceneGraphFacade>* scene) {
+	SceneGraphLogReader logReader;
+	logReader.open(*logFile);
+	logReader.restore(scene->get());
+}
+
+/* only the latest transforms, as the traverser is used for replication by default */
+void replicateScene(SceneGraphFacade* scene, boost::scoped_ptr<SceneGraphFacade>* replicatedScene) {
+	SceneGraphToUpdatesTraverser traverser(replicatedScene->get());
+	scene->executeGraphTraverser(&traverser, scene->getRootId());
+}
+
+/* A new empty target for restore and replication; the previous one is deleted outside of the timed run */
+void resetScene(boost::scoped_ptr<SceneGraphFacade>* scene) {
+	scene->reset(new SceneGraphFacade());
+}
+
+#ifdef BRICS_OPENCV_ENABLE
+/* The former depth image projection: cvGet2D and addPoint per pixel, uncalibrated */
+void referenceProjection(IplImage* depthImage, PointCloud3D* pointCloud) {
+	for (int row = 0; row < depthImage->height; ++row) {
+		for (int col = 0; col < depthImage->width; ++col) {
+			double pixelValue = cvGet2D(depthImage, row, col).val[0];
+			pointCloud->addPoint(Point3D(col, MAX_DEPTHIMAGE_VALUE - pixelValue, depthImage->height - row));
+		}
+	}
+}
+
+void projectDepthImage(DepthImageToPointCloudTransformation* projection, IplImage* depthImage, PointCloud3D* pointCloud) {
+	projection->transformDepthImageToPointCloud(depthImage, pointCloud);
+}
+
+/* Fill a depth image with a tilted plane; every 13th pixel has no measurement. */
+IplImage* createDepthImage(int width, int height, int depth) {
+	IplImage* image = cvCreateImage(cvSize(width, height), depth, 1);
+	for (int row = 0; row < height; ++row) {
+		char* rowData = image->imageData + row * image->widthStep;
+		for (int col = 0; col < width; ++col) {
+			unsigned int value = ((row * width + col) % 13 == 0) ? 0 : 800 + row + col / 2;
+			if (depth == IPL_DEPTH_16U) {
+				reinterpret_cast<unsigned short*>(rowData)[col] = static_cast<unsigned short>(value);
+			} else {
+				reinterpret_cast<unsigned char*>(rowData)[col] = static_cast<unsigned char>(value % 256);
+			}
+		}
+	}
+	return image;
+}
+#endif
+
+void clearPointCloud(PointCloud3D* pointCloud) {
+	pointCloud->getPointCloud()->clear();
+}
+
+string toString(double value) {
+	stringstream stream;
+	stream << value;
+	return stream.str();
+}
+
+string toString(unsigned int value) {
+	stringstream stream;
+	stream << value;
+	return stream.str();
+}
+
+}
+
+int main(int argc, char **argv) {
+
+	/* parse arguments */
+	unsigned int numberOfPoints = 100000;
+	BenchmarkRunner runner;
+	string jsonFileName = "";
+	string csvFileName = "";
+	for (int i = 1; i < argc; ++i) {
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--points") == 0 && hasValue) {
+			numberOfPoints = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--repetitions") == 0 && hasValue) {
+			runner.setRepetitions(atoi(argv[++i]));
+		} else if (strcmp(argv[i], "--warmup") == 0 && hasValue) {
+			runner.setWarmupRuns(atoi(argv[++i]));
+		} else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+			runner.setFilter(argv[++i]);
+		} else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+			jsonFileName = argv[++i];
+		} else if (strcmp(argv[i], "--csv") == 0 && hasValue) {
+			csvFileName = argv[++i];
+		} else {
+			cout << "Usage: " << argv[0] << " [--points <n>] [--repetitions <n>] [--warmup <n>] [--filter <substring>] [--json <file>] [--csv <file>]" << endl;
+			return -1;
+		}
+	}
+
+	/* synthetic data: the six faces of a unit cube */
+	SimplePointCloudGeneratorCube cubeGenerator;
+	int pointsOnEachSide = static_cast<int>(std::sqrt(numberOfPoints / 6.0) + 0.5);
+	cubeGenerator.setNumOfFaces(6);
+	cubeGenerator.setPointsOnEachSide(std::max(pointsOnEachSide, 2));
+	PointCloud3D pointCloud;
+	cubeGenerator.generatePointCloud(&pointCloud);
+	unsigned int size = pointCloud.getSize();
+	double pointDistance = 1.0 / cubeGenerator.getPointsOnEachSide();
+
+	vector<double> coordinates;
+	coordinates.reserve(3 * size);
+	for (unsigned int i = 0; i < size; ++i) {
+		coordinates.push_back((*pointCloud.getPointCloud())[i].getX());
+		coordinates.push_back((*pointCloud.getPointCloud())[i].getY());
+		coordinates.push_back((*pointCloud.getPointCloud())[i].getZ());
+	}
+
+	PointCloud3D queries; // every 10th point, slightly displaced
+	PointCloud3D displacedPointCloud; // all points, slightly displaced
+	for (unsigned int i = 0; i < size; ++i) {
+		Point3D displacedPoint(coordinates[3 * i] + 0.1 * pointDistance, coordinates[3 * i + 1] - 0.2 * pointDistance, coordinates[3 * i + 2] + 0.3 * pointDistance);
+		displacedPointCloud.addPoint(displacedPoint);
+		if (i % 10 == 0) {
+			queries.addPoint(displacedPoint);
+		}
+	}
+
+	runner.setContext("points", toString(size));
+	cout << "Running benchmark suite on " << size << " points with " << runner.getWarmupRuns() << " warmup runs and "
+			<< runner.getRepetitions() << " repetitions." << endl;
+
+	/* point cloud */
+	runner.run("pointcloud/construction", boost::bind(&constructPointCloud, &coordinates), size);
+
+	HomogeneousMatrix44 transformation(0.99500416527802582, 0.099833416646828155, 0, -0.099833416646828155, 0.99500416527802582, 0, 0, 0, 1, 0.001, 0.002, 0.003);
+	PointCloud3D transformedPointCloud;
+	for (unsigned int i = 0; i < size; ++i) {
+		transformedPointCloud.addPoint((*pointCloud.getPointCloud())[i]);
+	}
+	runner.run("pointcloud/transformation", boost::bind(&transformPointCloud, &transformedPointCloud, &transformation), size);
+
+	/* nearest neighbor backends */
+	const unsigned int k = 10;
+	vector<string> backendNames;
+	vector<INearestPoint3DNeighbor*> backends;
+	backendNames.push_back("flann");
+	backends.push_back(new NearestNeighborFLANN());
+	backendNames.push_back("ann");
+	backends.push_back(new NearestNeighborANN());
+	backendNames.push_back("stann");
+	backends.push_back(new NearestNeighborSTANN());
+	for (unsigned int i = 0; i < backends.size(); ++i) {
+		runner.run("nearestneighbor/" + backendNames[i] + "/build", boost::bind(&setNearestNeighborData, backends[i], &pointCloud), size);
+		backends[i]->setData(&pointCloud);
+		runner.run("nearestneighbor/" + backendNames[i] + "/query_k" + toString(k), boost::bind(&queryNearestNeighbors, backends[i], &queries, k), queries.getSize());
+		delete backends[i];
+	}
+
+	/* point correspondence (cached model k-d tree) */
+	PointCorrespondenceKDTree assigner;
+	runner.run("registration/correspondence_kdtree", boost::bind(&findCorrespondences, &assigner, &pointCloud, &displacedPointCloud), size);
+
+	/*
+	 * ICP with the point-to-point estimators and the point-to-plane estimator: the model and the data are two
+	 * independent samplings of an indoor scene, the data is displaced by 4 degrees and 11 cm. The iterations until
+	 * convergence and the remaining error are reported as context.
+	 */
+	const unsigned int numberOfScenePoints = std::max(numberOfPoints / 5, 1000u);
+	srand(0);
+	PointCloud3D indoorModel;
+	PointCloud3D indoorScan;
+	createIndoorScene(&indoorModel, numberOfScenePoints);
+	createIndoorScene(&indoorScan, numberOfScenePoints);
+	const double displacementAngle = 4.0 * M_PI / 180.0;
+	HomogeneousMatrix44 displacement(std::cos(displacementAngle), std::sin(displacementAngle), 0, -std::sin(displacementAngle), std::cos(displacementAngle), 0, 0, 0, 1, 0.1, -0.08, 0.04);
+	vector<string> estimatorNames;
+	vector<IRigidTransformationEstimation*> estimators;
+	estimatorNames.push_back("svd");
+	estimators.push_back(new RigidTransformationEstimationSVD());
+	estimatorNames.push_back("quat");
+	estimators.push_back(new RigidTransformationEstimationQUAT());
+	estimatorNames.push_back("helix");
+	estimators.push_back(new RigidTransformationEstimationHELIX());
+	estimatorNames.push_back("apx");
+	estimators.push_back(new RigidTransformationEstimationAPX());
+	estimatorNames.push_back("ortho");
+	estimators.push_back(new RigidTransformationEstimationORTHO());
+	estimatorNames.push_back("point_to_plane");
+	estimators.push_back(new RigidTransformationEstimationPointToPlane());
+	runner.setContext("icpPoints", toString(numberOfScenePoints));
+	for (unsigned int i = 0; i < estimators.size(); ++i) {
+		IterativeClosestPoint icp(new PointCorrespondenceKDTree(), estimators[i], 0.000001, 100); // takes ownership
+		PointCloud3D data;
+		string error = "";
+		string name = "registration/icp_" + estimatorNames[i];
+		if (!runner.run(name, boost::bind(&matchPointClouds, &icp, &indoorModel, &data, &error), numberOfScenePoints,
+				boost::bind(&copyTransformedPointCloud, &indoorScan, &displacement, &data))) {
+			continue;
+		}
+		if (error.empty()) {
+			runner.setContext(name + "/iterations", toString(static_cast<unsigned int>(icp.icpresultIterations)));
+			runner.setContext(name + "/rmsError", toString(computeRMSError(&indoorScan, &data)));
+		} else {
+			runner.setContext(name + "/error", error);
+			cout << name << " failed: " << error << endl;
+		}
+	}
+
+	/* sample consensus segmentation */
+	ObjectModelPlane plane;
+	plane.setInputCloud(&pointCloud);
+	SACMethodRANSAC ransac;
+	ransac.setObjectModel(&plane);
+	ransac.setPointCloud(&pointCloud);
+	ransac.setDistanceThreshold(0.5 * pointDistance);
+	runner.run("segmentation/ransac_plane", boost::bind(&computeSACModel, &ransac), size, &resetRandomSeed);
+	ransac.setHypothesesPerBatch(32);
+	ransac.setPretestSize(200);
+	runner.run("segmentation/ransac_plane_batched", boost::bind(&computeSACModel, &ransac), size, &resetRandomSeed);
+
+	/* clustering */
+	EuclideanClustering clustering;
+	clustering.setClusterTolerance(static_cast<float>(2.0 * pointDistance));
+	clustering.setMinClusterSize(1);
+	clustering.setMaxClusterSize(size);
+	runner.run("segmentation/euclidean_clustering", boost::bind(&extractClusters, &clustering, &pointCloud), size);
+
+	/*
+	 * normals and clusters of QQVGA to VGA depth images: the organized algorithms (integral images, connected
+	 * components in pixel space) versus the ParallelNormalEstimation (k-d tree) and the EuclideanClustering
+	 * (voxel grid) on the flattened point cloud
+	 */
+	const unsigned int organizedWidths[] = {160, 320, 640};
+	const unsigned int organizedHeights[] = {120, 240, 480};
+	for (unsigned int organizedSize = 0; organizedSize < sizeof(organizedWidths) / sizeof(organizedWidths[0]); ++organizedSize) {
+		OrganizedPointCloud3D organizedCloud;
+		createOrganizedScene(organizedWidths[organizedSize], organizedHeights[organizedSize], &organizedCloud);
+		PointCloud3D flattenedCloud;
+		organizedCloud.copyTo(&flattenedCloud);
+		unsigned int numberOfPixels = organizedWidths[organizedSize] * organizedHeights[organizedSize];
+		unsigned int numberOfValidPoints = flattenedCloud.getSize();
+		string resolution = toString(organizedWidths[organizedSize]) + "x" + toString(organizedHeights[organizedSize]);
+		NormalSet3D normals;
+
+		IntegralImageNormalEstimation integralImageEstimator;
+		runner.run("organized/integral_image_normals_" + resolution,
+				boost::bind(&estimateOrganizedNormals, &integralImageEstimator, &organizedCloud, &normals), numberOfPixels);
+
+		NearestNeighborSTANN normalSearch;
+		ParallelNormalEstimation parallelEstimator;
+		parallelEstimator.setSearchMethod(&normalSearch);
+		runner.run("organized/parallel_normals_" + resolution,
+				boost::bind(&estimateNormals, &parallelEstimator, &flattenedCloud, &normals), numberOfValidPoints);
+
+		OrganizedConnectedComponents connectedComponents;
+		connectedComponents.setPointCloud(&organizedCloud);
+		connectedComponents.setDistanceThreshold(0.05);
+		connectedComponents.setMinClusterSize(100);
+		if (runner.run("organized/connected_components_" + resolution, boost::bind(&segmentOrganizedCloud, &connectedComponents), numberOfPixels)) {
+			vector<vector<unsigned int> > clusterIndices;
+			connectedComponents.getClusterIndices(clusterIndices);
+			runner.setContext("organized/connected_components_" + resolution + "/clusters", toString(static_cast<unsigned int>(clusterIndices.size())));
+		}
+
+		EuclideanClustering organizedClustering;
+		organizedClustering.setClusterTolerance(0.05f);
+		organizedClustering.setMinClusterSize(100);
+		runner.run("organized/euclidean_clustering_" + resolution,
+				boost::bind(&extractClusters, &organizedClustering, &flattenedCloud), numberOfValidPoints);
+	}
+
+	/* filtering */
+	const double voxelSize = 0.05;
+	Octree octree;
+	octree.setVoxelSize(voxelSize);
+	runner.run("filtering/octree", boost::bind(&filterPointCloud, &octree, &pointCloud), size);
+	VoxelGridFilter voxelGrid;
+	voxelGrid.setVoxelSize(voxelSize);
+	runner.run("filtering/voxelgrid", boost::bind(&filterPointCloud, &voxelGrid, &pointCloud), size);
+
+#ifdef BRICS_OPENCV_ENABLE
+	/*
+	 * depth image projection of VGA and XGA images: the former per pixel implementation versus the uncalibrated
+	 * 8 bit and the calibrated 16 bit projection with 1, 2 and 4 threads
+	 */
+	const int imageWidths[] = {640, 1024};
+	const int imageHeights[] = {480, 768};
+	const unsigned int projectionThreadCounts[] = {1, 2, 4};
+	PointCloud3D projectedPointCloud;
+	for (int imageSize = 0; imageSize < 2; ++imageSize) {
+		IplImage* grayImage = createDepthImage(imageWidths[imageSize], imageHeights[imageSize], IPL_DEPTH_8U);
+		IplImage* depthImage = createDepthImage(imageWidths[imageSize], imageHeights[imageSize], IPL_DEPTH_16U);
+		unsigned int numberOfPixels = imageWidths[imageSize] * imageHeights[imageSize];
+		string resolution = toString(static_cast<unsigned int>(imageWidths[imageSize])) + "x" + toString(static_cast<unsigned int>(imageHeights[imageSize]));
+
+		runner.run("depthperception/reference_8bit_" + resolution, boost::bind(&referenceProjection, grayImage, &projectedPointCloud),
+				numberOfPixels, boost::bind(&clearPointCloud, &projectedPointCloud));
+		for (int mode = 0; mode < 2; ++mode) {
+			for (unsigned int i = 0; i < sizeof(projectionThreadCounts) / sizeof(projectionThreadCounts[0]); ++i) {
+				DepthImageToPointCloudTransformation projection;
+				if (mode == 1) {
+					projection.setIntrinsics(0.82 * imageWidths[imageSize], 0.82 * imageWidths[imageSize], 0.5 * (imageWidths[imageSize] - 1), 0.5 * (imageHeights[imageSize] - 1));
+				}
+				projection.setNumberOfThreads(projectionThreadCounts[i]);
+				string name = string("depthperception/") + ((mode == 0) ? "uncalibrated_8bit_" : "calibrated_16bit_") + resolution + "/threads" + toString(projectionThreadCounts[i]);
+				runner.run(name, boost::bind(&projectDepthImage, &projection, (mode == 0) ? grayImage : depthImage, &projectedPointCloud),
+						numberOfPixels, boost::bind(&clearPointCloud, &projectedPointCloud));
+			}
+		}
+
+		cvReleaseImage(&grayImage);
+		cvReleaseImage(&depthImage);
+	}
+	clearPointCloud(&projectedPointCloud);
+#endif
+
+	/* scene graph: a tree of transforms with tagged leaves */
+	const unsigned int numberOfFrames = 1000;
+	const unsigned int depth = 5;
+	SceneGraphFacade scene;
+	vector<unsigned int> leafIds;
+	vector<Attribute> attributeQueries;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr frameTransform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 0.1,0,0));
+	for (unsigned int i = 0; i < numberOfFrames / depth; ++i) {
+		unsigned int parentId = scene.getRootId();
+		for (unsigned int level = 0; level < depth; ++level) {
+			vector<Attribute> attributes;
+			attributes.push_back(Attribute("frame", toString(i * depth + level)));
+			unsigned int frameId;
+			scene.addTransformNode(parentId, frameId, attributes, frameTransform, TimeStamp(1.0));
+			parentId = frameId;
+		}
+		vector<Attribute> attributes;
+		attributes.push_back(Attribute("taskType", "sceneObject"));
+		attributes.push_back(Attribute("name", "object" + toString(i)));
+		unsigned int leafId;
+		scene.addNode(parentId, leafId, attributes);
+		leafIds.push_back(leafId);
+		attributeQueries.push_back(Attribute("name", "object" + toString(i)));
+	}
+	runner.setContext("sceneGraphFrames", toString(numberOfFrames));
+	runner.run("scenegraph/attribute_query", boost::bind(&queryNodesByAttributes, &scene, &attributeQueries), attributeQueries.size());
+	runner.run("scenegraph/transform_for_node", boost::bind(&queryTransformsForNodes, &scene, &leafIds, scene.getRootId()), leafIds.size());
+
+	/*
+	 * scene graph: writer throughput of a burst of transform updates with an observer that needs 1 ms per update,
+	 * inline observer calls versus an UpdateObserverDispatcher with and without coalescing
+	 */
+	const unsigned int numberOfTransforms = 10;
+	const unsigned int numberOfUpdates = 100;
+	for (int mode = 0; mode < 3; ++mode) {
+		SceneGraphFacade observedScene;
+		SlowObserver observer(1000);
+		UpdateObserverDispatcher* dispatcher = 0;
+		if (mode == 0) {
+			observedScene.attachUpdateObserver(&observer);
+		} else {
+			dispatcher = new UpdateObserverDispatcher(&observer, 1024, mode == 2);
+			observedScene.attachUpdateObserver(dispatcher);
+		}
+		vector<unsigned int> transformIds;
+		vector<Attribute> noAttributes;
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr identity(new HomogeneousMatrix44());
+		for (unsigned int i = 0; i < numberOfTransforms; ++i) {
+			unsigned int transformId = 0;
+			observedScene.addTransformNode(observedScene.getRootId(), transformId, noAttributes, identity, TimeStamp(0.0));
+			transformIds.push_back(transformId);
+		}
+
+		string name = string("scenegraph/observer_updates/") + ((mode == 0) ? "inline" : ((mode == 1) ? "dispatched" : "dispatched_coalescing"));
+		if (runner.run(name, boost::bind(&updateTransforms, &observedScene, &transformIds, numberOfUpdates), numberOfUpdates,
+				boost::bind(&flushDispatcher, dispatcher)) && dispatcher != 0) {
+			dispatcher->flush(); // the counters accumulate over the warmup and the timed runs
+			runner.setContext(name + "/coalesced", toString(static_cast<unsigned int>(dispatcher->getNumberOfCoalescedUpdates())));
+			runner.setContext(name + "/dropped", toString(static_cast<unsigned int>(dispatcher->getNumberOfDroppedUpdates())));
+			runner.setContext(name + "/maxQueueDepth", toString(dispatcher->getMaxQueueDepth()));
+		}
+		if (dispatcher != 0) {
+			observedScene.detachUpdateObserver(dispatcher);
+			delete dispatcher;
+		}
+	}
+
+	/* scene graph: read throughput of 4 readers with a growing number of writers, external mutex versus snapshot isolation */
+	const unsigned int numberOfReaders = 4;
+	const unsigned int queriesPerReader = 5000;
+	const unsigned int writerCounts[] = {0, 1, 2, 4};
+	for (int mode = 0; mode < 2; ++mode) {
+		for (unsigned int w = 0; w < sizeof(writerCounts) / sizeof(writerCounts[0]); ++w) {
+			SceneGraphStressTest stressTest(mode == 0);
+			string name = string("scenegraph/concurrent_reads/") + ((mode == 0) ? "external_mutex" : "snapshot_isolation") + "_writers" + toString(writerCounts[w]);
+			runner.run(name, boost::bind(&SceneGraphStressTest::run, &stressTest, numberOfReaders, writerCounts[w], queriesPerReader), numberOfReaders * queriesPerReader);
+		}
+	}
+
+	/* scene graph: restore from the binary log (snapshot, decode, restore) versus the replay with the SceneGraphToUpdatesTraverser */
+	const unsigned int numberOfLoggedNodes = 10000;
+	string logFile = "benchmark_suite.rsg";
+	SceneGraphFacade loggedScene;
+	createLoggedScene(&loggedScene, numberOfLoggedNodes);
+	writeLogSnapshot(&loggedScene, &logFile); // the input for decode and restore, even if the snapshot case is filtered out
+	boost::scoped_ptr<SceneGraphFacade> targetScene;
+	runner.setContext("loggedNodes", toString(numberOfLoggedNodes));
+	runner.run("scenegraph/log/snapshot", boost::bind(&writeLogSnapshot, &loggedScene, &logFile), numberOfLoggedNodes);
+	runner.run("scenegraph/log/decode", boost::bind(&decodeLog, &logFile), numberOfLoggedNodes);
+	runner.run("scenegraph/log/restore", boost::bind(&restoreLog, &logFile, &targetScene), numberOfLoggedNodes, boost::bind(&resetScene, &targetScene));
+	runner.run("scenegraph/log/traverser_replay", boost::bind(&replicateScene, &loggedScene, &targetScene), numberOfLoggedNodes, boost::bind(&resetScene, &targetScene));
+	targetScene.reset();
+	std::remove(logFile.c_str());
+
+	/* report */
+	const vector<BenchmarkRunner::Result>& results = runner.getResults();
+	cout << endl << "name, median [ms], percentile90 [ms], throughput [items/s]" << endl;
+	for (unsigned int i = 0; i < results.size(); ++i) {
+		cout << results[i].name << ", " << results[i].median << ", " << results[i].percentile90 << ", " << results[i].throughput << endl;
+	}
+
+	if (jsonFileName.empty() && csvFileName.empty()) {
+		Benchmark jsonOutput("benchmark_suite", "json");
+		runner.writeJSON(jsonOutput.output);
+		Benchmark csvOutput("benchmark_suite", "csv");
+		runner.writeCSV(csvOutput.output);
+	}
+	if (!jsonFileName.empty()) {
+		ofstream jsonOutput(jsonFileName.c_str(), ios::trunc);
+		runner.writeJSON(jsonOutput);
+	}
+	if (!csvFileName.empty()) {
+		ofstream csvOutput(csvFileName.c_str(), ios::trunc);
+		runner.writeCSV(csvOutput);
+	}
+
+	cout << "Done." << endl;
+	return 0;
+}
+
+/* EOF */
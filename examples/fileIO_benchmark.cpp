@@ -0,0 +1,105 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/PointCloud3DFileHandler.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+
+/*
+ * Compares the loading times of the text format (PointCloud3D::readFromTxtFile) with
+ * ASCII and binary PLY and PCD files.
+ */
+int main(int argc, char **argv) {
+
+	const int repetitions = 5;
+	const int numberOfSteps = 5;
+	const int stepSize = 200000;
+	unsigned int seed = 0; // make sure, seed is always the same.
+
+	std::srand(seed);
+	Timer timer;
+	long double elapsedTime = 0.0;
+	PointCloud3DFileHandler fileHandler;
+
+	const string txtFilename = "fileIO_benchmark.txt";
+	const string plyFilename = "fileIO_benchmark.ply";
+	const string pcdFilename = "fileIO_benchmark.pcd";
+
+	Benchmark fileIOBenchmark("fileIO_benchmark");
+	fileIOBenchmark.output << "#nPts, format, read timing [ms] (mean of " << repetitions << " runs)" << endl;
+
+	PointCloud3D pointCloud;
+	for (int step = 0; step < numberOfSteps; ++step) {
+		for (int j = 0; j < stepSize; ++j) {
+			pointCloud.addPoint(Point3D(std::rand() / static_cast<double>(RAND_MAX), std::rand() / static_cast<double>(RAND_MAX), std::rand() / static_cast<double>(RAND_MAX)));
+		}
+		unsigned int size = pointCloud.getSize();
+
+		pointCloud.storeToTxtFile(txtFilename);
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			PointCloud3D result;
+			result.readFromTxtFile(txtFilename);
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		fileIOBenchmark.output << size << ", txt, " << elapsedTime << endl;
+		cout << size << ", txt, " << elapsedTime << " [ms]" << endl;
+
+		for (int encoding = PointCloud3DFileHandler::ascii; encoding <= PointCloud3DFileHandler::binary; ++encoding) {
+			const char* encodingName = (encoding == PointCloud3DFileHandler::binary) ? "binary" : "ascii";
+
+			fileHandler.storeToPlyFile(plyFilename, &pointCloud, static_cast<PointCloud3DFileHandler::Encoding>(encoding));
+			timer.reset();
+			for (int run = 0; run < repetitions; ++run) {
+				PointCloud3D result;
+				fileHandler.readFromPlyFile(plyFilename, &result);
+			}
+			elapsedTime = timer.getElapsedTime() / repetitions;
+			fileIOBenchmark.output << size << ", ply_" << encodingName << ", " << elapsedTime << endl;
+			cout << size << ", ply_" << encodingName << ", " << elapsedTime << " [ms]" << endl;
+
+			fileHandler.storeToPcdFile(pcdFilename, &pointCloud, static_cast<PointCloud3DFileHandler::Encoding>(encoding));
+			timer.reset();
+			for (int run = 0; run < repetitions; ++run) {
+				PointCloud3D result;
+				fileHandler.readFromPcdFile(pcdFilename, &result);
+			}
+			elapsedTime = timer.getElapsedTime() / repetitions;
+			fileIOBenchmark.output << size << ", pcd_" << encodingName << ", " << elapsedTime << endl;
+			cout << size << ", pcd_" << encodingName << ", " << elapsedTime << " [ms]" << endl;
+		}
+	}
+
+	std::remove(txtFilename.c_str());
+	std::remove(plyFilename.c_str());
+	std::remove(pcdFilename.c_str());
+
+	cout << "Done." << endl;
+	return 0;
+}
+
+/* EOF */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+#include "brics_3d/algorithm/featureExtraction/NormalEstimation.h"
+#include "brics_3d/algorithm/featureExtraction/ParallelNormalEstimation.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborSTANN.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+
+/*
+ * Compares the NormalEstimation (per point centroid, covariance and iterative eigen solver) with the
+ * ParallelNormalEstimation (single pass covariance, closed form eigenvector, worker threads).
+ */
+int main(int argc, char **argv) {
+
+	const int numberOfSteps = 4;
+	const int stepSize = 50000;
+	const unsigned int k = 10;
+	const unsigned int threadCounts[] = {1, 2, 4};
+	const int numberOfThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+	unsigned int seed = 0; // make sure, seed is always the same.
+
+	std::srand(seed);
+	Timer timer;
+	long double elapsedTime = 0.0;
+
+	Benchmark normalBenchmark("normalEstimation_benchmark");
+	normalBenchmark.output << "#nPts, method, threads, timing [ms]" << endl;
+
+	PointCloud3D pointCloud;
+	for (int step = 0; step < numberOfSteps; ++step) {
+		for (int j = 0; j < stepSize; ++j) { // a wavy surface
+			double x = std::rand() / static_cast<double>(RAND_MAX) * 10.0;
+			double y = std::rand() / static_cast<double>(RAND_MAX) * 10.0;
+			pointCloud.addPoint(Point3D(x, y, 0.5 * sin(x) * cos(y)));
+		}
+		unsigned int size = pointCloud.getSize();
+
+		/* reference */
+		NearestNeighborSTANN referenceSearch;
+		NormalEstimation referenceEstimator;
+		referenceEstimator.setInputCloud(&pointCloud);
+		referenceEstimator.setSearchMethod(&referenceSearch);
+		referenceEstimator.setkneighbours(k);
+		NormalSet3D referenceNormals;
+		timer.reset();
+		referenceEstimator.estimateNormals(&pointCloud, &referenceNormals);
+		elapsedTime = timer.getElapsedTime();
+		normalBenchmark.output << size << ", NormalEstimation, 1, " << elapsedTime << endl;
+		cout << size << ", NormalEstimation, 1, " << elapsedTime << " [ms]" << endl;
+
+		for (int t = 0; t < numberOfThreadCounts; ++t) {
+			NearestNeighborSTANN nearestNeighborSearch;
+			ParallelNormalEstimation normalEstimator;
+			normalEstimator.setSearchMethod(&nearestNeighborSearch);
+			normalEstimator.setkNeighbors(k);
+			normalEstimator.setNumberOfThreads(threadCounts[t]);
+			NormalSet3D normals;
+			timer.reset();
+			normalEstimator.estimateNormals(&pointCloud, &normals);
+			elapsedTime = timer.getElapsedTime();
+			normalBenchmark.output << size << ", ParallelNormalEstimation, " << threadCounts[t] << ", " << elapsedTime << endl;
+			cout << size << ", ParallelNormalEstimation, " << threadCounts[t] << ", " << elapsedTime << " [ms]" << endl;
+		}
+	}
+
+	cout << "Done." << endl;
+	return 0;
+}
+
+/* EOF */
@@ -0,0 +1,126 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/algorithm/segmentation/objectModels/ObjectModelPlane.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACMethodRANSAC.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACMethodMSAC.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+
+/*
+ * Plane extraction on a frame sized (640x480) point cloud: one hypothesis at a time compared to
+ * batches of hypotheses with early rejection and several threads.
+ */
+int main(int argc, char **argv) {
+
+	const int repetitions = 5;
+	const int width = 640;
+	const int height = 480;
+	const double threshold = 0.01;
+	const double planeRatio = 0.4; // the fraction of points that belongs to the dominant plane
+	const unsigned int batchSize = 32;
+	const unsigned int threadCounts[] = {1, 2, 4};
+	const int numberOfThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+	const unsigned int pretestSizes[] = {0, 200};
+	const int numberOfPretestSizes = sizeof(pretestSizes) / sizeof(pretestSizes[0]);
+	unsigned int seed = 0; // make sure, seed is always the same.
+
+	std::srand(seed);
+	PointCloud3D pointCloud;
+	for (int v = 0; v < height; ++v) {
+		for (int u = 0; u < width; ++u) {
+			double x = u / static_cast<double>(width);
+			double y = v / static_cast<double>(height);
+			double z;
+			if (std::rand() / static_cast<double>(RAND_MAX) < planeRatio) {
+				z = 1.0 + 0.2 * x + (std::rand() / static_cast<double>(RAND_MAX) - 0.5) * threshold; // slightly tilted floor
+			} else {
+				z = 1.5 + std::rand() / static_cast<double>(RAND_MAX); // clutter
+			}
+			pointCloud.addPoint(Point3D(x, y, z));
+		}
+	}
+
+	ObjectModelPlane plane;
+	plane.setInputCloud(&pointCloud);
+	Timer timer;
+	long double elapsedTime = 0.0;
+	std::vector<int> inliers;
+
+	Benchmark sacBenchmark("sac_benchmark");
+	sacBenchmark.output << "#method, hypothesesPerBatch, threads, pretestSize, inliers, timing [ms] (mean of " << repetitions << " runs)" << endl;
+
+	for (int method = 0; method < 2; ++method) {
+		ISACMethods* sacMethod;
+		string methodName;
+		if (method == 0) {
+			sacMethod = new SACMethodRANSAC();
+			methodName = "RANSAC";
+		} else {
+			sacMethod = new SACMethodMSAC();
+			methodName = "MSAC";
+		}
+		sacMethod->setObjectModel(&plane);
+		sacMethod->setPointCloud(&pointCloud);
+		sacMethod->setDistanceThreshold(threshold);
+
+		/* reference: one hypothesis at a time */
+		std::srand(seed);
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			sacMethod->computeModel();
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		sacMethod->getInliers(inliers);
+		sacBenchmark.output << methodName << ", 1, 1, 0, " << inliers.size() << ", " << elapsedTime << endl;
+		cout << methodName << ", 1, 1, 0, " << inliers.size() << ", " << elapsedTime << " [ms]" << endl;
+
+		/* batches */
+		sacMethod->setHypothesesPerBatch(batchSize);
+		for (int p = 0; p < numberOfPretestSizes; ++p) {
+			sacMethod->setPretestSize(pretestSizes[p]);
+			for (int t = 0; t < numberOfThreadCounts; ++t) {
+				sacMethod->setNumberOfThreads(threadCounts[t]);
+				std::srand(seed);
+				timer.reset();
+				for (int run = 0; run < repetitions; ++run) {
+					sacMethod->computeModel();
+				}
+				elapsedTime = timer.getElapsedTime() / repetitions;
+				sacMethod->getInliers(inliers);
+				sacBenchmark.output << methodName << ", " << batchSize << ", " << threadCounts[t] << ", " << pretestSizes[p] << ", " << inliers.size() << ", " << elapsedTime << endl;
+				cout << methodName << ", " << batchSize << ", " << threadCounts[t] << ", " << pretestSizes[p] << ", " << inliers.size() << ", " << elapsedTime << " [ms]" << endl;
+			}
+		}
+		delete sacMethod;
+	}
+
+	cout << "Done." << endl;
+	return 0;
+}
+
+/* EOF */
@@ -0,0 +1,152 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/TriangleMeshExplicit.h"
+#include "brics_3d/core/TriangleMeshImplicit.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/HomogeneousTransformationKernel.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+
+/*
+ * Compares the per point homogeneous transformation (a virtual call per point) with the
+ * bulk transformation of the HomogeneousTransformationKernel for point clouds and meshes.
+ */
+int main(int argc, char **argv) {
+
+	const int repetitions = 10;
+	const int numberOfSteps = 5;
+	const int stepSize = 200000;
+	const unsigned int threadCounts[] = {1, 2, 4};
+	const int numberOfThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+	unsigned int seed = 0; // make sure, seed is always the same.
+
+	std::srand(seed);
+	Timer timer;
+	long double elapsedTime = 0.0;
+	HomogeneousMatrix44 transformation(0.36, 0.48, -0.8, -0.8, 0.6, 0.0, 0.48, 0.64, 0.6, 1.0, 2.0, 3.0);
+
+	Benchmark transformationBenchmark("transformation_benchmark");
+	transformationBenchmark.output << "#data, nPts, method, threads, timing [ms] (mean of " << repetitions << " runs)" << endl;
+
+	PointCloud3D pointCloud;
+	TriangleMeshImplicit implicitMesh;
+	TriangleMeshExplicit explicitMesh;
+	std::vector<Triangle>* triangles = explicitMesh.getTriangles();
+
+	for (int step = 0; step < numberOfSteps; ++step) {
+		for (int j = 0; j < stepSize; ++j) {
+			Point3D point(std::rand() / static_cast<double>(RAND_MAX), std::rand() / static_cast<double>(RAND_MAX), std::rand() / static_cast<double>(RAND_MAX));
+			pointCloud.addPoint(point);
+			implicitMesh.getVertices()->push_back(point);
+			if (j % 3 == 2) {
+				triangles->push_back(Triangle((*pointCloud.getPointCloud())[pointCloud.getSize() - 3],
+						(*pointCloud.getPointCloud())[pointCloud.getSize() - 2], point));
+			}
+		}
+		unsigned int size = pointCloud.getSize();
+
+		/* reference: per point path */
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			for (unsigned int i = 0; i < size; ++i) {
+				(*pointCloud.getPointCloud())[i].homogeneousTransformation(&transformation);
+			}
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		transformationBenchmark.output << "pointCloud, " << size << ", perPoint, 1, " << elapsedTime << endl;
+		cout << "pointCloud, " << size << ", perPoint, 1, " << elapsedTime << " [ms]" << endl;
+
+		/* bulk path */
+		for (int t = 0; t < numberOfThreadCounts; ++t) {
+			timer.reset();
+			for (int run = 0; run < repetitions; ++run) {
+				pointCloud.homogeneousTransformation(&transformation, threadCounts[t]);
+			}
+			elapsedTime = timer.getElapsedTime() / repetitions;
+			transformationBenchmark.output << "pointCloud, " << size << ", bulk, " << threadCounts[t] << ", " << elapsedTime << endl;
+			cout << "pointCloud, " << size << ", bulk, " << threadCounts[t] << ", " << elapsedTime << " [ms]" << endl;
+		}
+
+		/* implicit mesh: contiguous vertices */
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			for (unsigned int i = 0; i < implicitMesh.getVertices()->size(); ++i) {
+				(*implicitMesh.getVertices())[i].homogeneousTransformation(&transformation);
+			}
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		transformationBenchmark.output << "implicitMesh, " << size << ", perPoint, 1, " << elapsedTime << endl;
+		cout << "implicitMesh, " << size << ", perPoint, 1, " << elapsedTime << " [ms]" << endl;
+
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			implicitMesh.homogeneousTransformation(&transformation);
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		transformationBenchmark.output << "implicitMesh, " << size << ", bulk, 1, " << elapsedTime << endl;
+		cout << "implicitMesh, " << size << ", bulk, 1, " << elapsedTime << " [ms]" << endl;
+
+		for (int t = 1; t < numberOfThreadCounts; ++t) {
+			HomogeneousTransformationKernel kernel(&transformation);
+			kernel.setNumberOfThreads(threadCounts[t]);
+			timer.reset();
+			for (int run = 0; run < repetitions; ++run) {
+				kernel.transformPoints(&(*implicitMesh.getVertices())[0], static_cast<unsigned int>(implicitMesh.getVertices()->size()));
+			}
+			elapsedTime = timer.getElapsedTime() / repetitions;
+			transformationBenchmark.output << "implicitMesh, " << size << ", bulk, " << threadCounts[t] << ", " << elapsedTime << endl;
+			cout << "implicitMesh, " << size << ", bulk, " << threadCounts[t] << ", " << elapsedTime << " [ms]" << endl;
+		}
+
+		/* explicit mesh: three vertices per triangle */
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			for (unsigned int i = 0; i < triangles->size(); ++i) {
+				for (int vertexIndex = 0; vertexIndex < 3; ++vertexIndex) {
+					(*triangles)[i].getVertex(vertexIndex)->homogeneousTransformation(&transformation);
+				}
+			}
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		transformationBenchmark.output << "explicitMesh, " << 3 * triangles->size() << ", perPoint, 1, " << elapsedTime << endl;
+		cout << "explicitMesh, " << 3 * triangles->size() << ", perPoint, 1, " << elapsedTime << " [ms]" << endl;
+
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			explicitMesh.homogeneousTransformation(&transformation);
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		transformationBenchmark.output << "explicitMesh, " << 3 * triangles->size() << ", bulk, 1, " << elapsedTime << endl;
+		cout << "explicitMesh, " << 3 * triangles->size() << ", bulk, 1, " << elapsedTime << " [ms]" << endl;
+	}
+
+	cout << "Done." << endl;
+	return 0;
+}
+
+/* EOF */
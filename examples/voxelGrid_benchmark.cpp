@@ -0,0 +1,112 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include <iostream>
+#include <string.h>
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/algorithm/filtering/Octree.h"
+#include "brics_3d/algorithm/filtering/VoxelGridFilter.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/util/Benchmark.h"
+
+using namespace std;
+using namespace brics_3d;
+
+/*
+ * Compares the downsampling of the Octree with the VoxelGridFilter in its different
+ * reduction modes and with a varying number of threads.
+ */
+int main(int argc, char **argv) {
+
+	/* check arguments */
+	string filename;
+	if (argc == 1) {
+		cout << "Usage: " << argv[0] << " <filename>" << endl;
+
+		char defaultFilename[255] = { BRICS_MODELS_DIR };
+		strcat(defaultFilename, "/bunny000.txt\0");
+		filename = defaultFilename;
+
+		cout << "Trying to get default file: " << filename << endl;
+	} else if (argc == 2) {
+		filename = argv[1];
+		cout << filename << endl;
+	} else {
+		cout << "Usage: " << argv[0] << " <filename>" << endl;
+		return -1;
+	}
+
+	const int repetitions = 10;
+	const double voxelSizes[] = {0.001, 0.002, 0.005, 0.01, 0.02};
+	const int numberOfVoxelSizes = sizeof(voxelSizes) / sizeof(voxelSizes[0]);
+	const unsigned int threadCounts[] = {1, 2, 4};
+	const int numberOfThreadCounts = sizeof(threadCounts) / sizeof(threadCounts[0]);
+
+	Timer timer;
+	long double elapsedTime = 0.0;
+	Benchmark voxelGridBenchmark("voxelGrid_benchmark");
+	voxelGridBenchmark.output << "#voxelSize, filter, threads, resultSize, timing [ms] (mean of " << repetitions << " runs)" << endl;
+
+	PointCloud3D pointCloud;
+	pointCloud.readFromTxtFile(filename);
+	cout << "Size of point cloud: " << pointCloud.getSize() << endl;
+
+	PointCloud3D resultPointCloud;
+	Octree octree;
+	VoxelGridFilter voxelGrid;
+
+	for (int i = 0; i < numberOfVoxelSizes; ++i) {
+		double voxelSize = voxelSizes[i];
+
+		/* reference: Octree */
+		octree.setVoxelSize(voxelSize);
+		timer.reset();
+		for (int run = 0; run < repetitions; ++run) {
+			octree.filter(&pointCloud, &resultPointCloud);
+		}
+		elapsedTime = timer.getElapsedTime() / repetitions;
+		cout << "voxelSize " << voxelSize << ": Octree -> " << resultPointCloud.getSize() << " points in " << elapsedTime << "ms" << endl;
+		voxelGridBenchmark.output << voxelSize << ", Octree, 1, " << resultPointCloud.getSize() << ", " << elapsedTime << endl;
+
+		/* VoxelGridFilter in all reduction modes */
+		const VoxelGridFilter::ReductionMode modes[] = {VoxelGridFilter::centroid, VoxelGridFilter::center, VoxelGridFilter::firstPoint};
+		const char* modeNames[] = {"VoxelGridFilter(centroid)", "VoxelGridFilter(center)", "VoxelGridFilter(firstPoint)"};
+		voxelGrid.setVoxelSize(voxelSize);
+		for (int mode = 0; mode < 3; ++mode) {
+			voxelGrid.setReductionMode(modes[mode]);
+			for (int j = 0; j < numberOfThreadCounts; ++j) {
+				voxelGrid.setNumberOfThreads(threadCounts[j]);
+				timer.reset();
+				for (int run = 0; run < repetitions; ++run) {
+					voxelGrid.filter(&pointCloud, &resultPointCloud);
+				}
+				elapsedTime = timer.getElapsedTime() / repetitions;
+				cout << "voxelSize " << voxelSize << ": " << modeNames[mode] << " with " << threadCounts[j] << " threads -> "
+						<< resultPointCloud.getSize() << " points in " << elapsedTime << "ms" << endl;
+				voxelGridBenchmark.output << voxelSize << ", " << modeNames[mode] << ", " << threadCounts[j] << ", "
+						<< resultPointCloud.getSize() << ", " << elapsedTime << endl;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/* EOF */
@@ -18,16 +18,28 @@
 ******************************************************************************/
 
 #include "DepthImageToPointCloudTransformation.h"
-#include <iostream>
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
+
+#include <algorithm>
 #include <assert.h>
-#include <stdio.h>
+#include <cmath>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 using namespace std;
 
 namespace brics_3d {
 
-DepthImageToPointCloudTransformation::DepthImageToPointCloudTransformation() {
+const unsigned int DepthImageToPointCloudTransformation::minPixelsPerThread = 50000;
+
+/// Number of fixed point iterations to remove the lens distortion.
+static const int undistortionIterations = 20;
 
+DepthImageToPointCloudTransformation::DepthImageToPointCloudTransformation() {
+	resetIntrinsics();
+	depthScale = 0.001;
+	numberOfThreads = 1;
 }
 
 DepthImageToPointCloudTransformation::~DepthImageToPointCloudTransformation() {
@@ -37,48 +49,311 @@ DepthImageToPointCloudTransformation::~DepthImageToPointCloudTransformation() {
 void DepthImageToPointCloudTransformation::transformDepthImageToPointCloud(IplImage *depthImage,
 		PointCloud3D *pointCloud, double threshold) {
 
-	double x = 0.0;
-	double y = 0.0;
-	double z = 0.0;
-	CvScalar pixel;
-	double pixelValue = 0.0;
+	unsigned int minValue = 0;
+	unsigned int threadCount = 1;
+	if (pointCloud == NULL) {
+		LOG(ERROR) << "DepthImageToPointCloudTransformation: NULL pointer in input parameters";
+		return;
+	}
+	if (!prepare(depthImage, threshold, minValue, threadCount)) {
+		return;
+	}
+	int height = depthImage->height;
+	std::vector<int> rowBegin(threadCount + 1, height);
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		unsigned int begin = 0;
+		unsigned int end = 0;
+		ParallelExecution::getRange(static_cast<unsigned int>(height), threadCount, i, begin, end);
+		rowBegin[i] = static_cast<int>(begin);
+	}
 
-	/* check if input parameters are valid */
-	if (depthImage == NULL || pointCloud == NULL) {
-		cerr << "ERROR: NULL pointer in input parameters" << endl;
+	/* first pass: count the points of each block of rows */
+	std::vector<unsigned int> counts(threadCount, 0);
+	if (threadCount == 1) {
+		countPoints(depthImage, minValue, 0, height, &counts[0]);
+	} else {
+		boost::thread_group workers;
+		for (unsigned int i = 0; i < threadCount; ++i) {
+			workers.create_thread(boost::bind(&DepthImageToPointCloudTransformation::countPoints, this, depthImage,
+					minValue, rowBegin[i], rowBegin[i + 1], &counts[i]));
+		}
+		workers.join_all();
+	}
+
+	/* grow the point cloud once */
+	PointContainer* points = pointCloud->getPointCloud();
+	std::vector<unsigned int> firstIndices(threadCount);
+	unsigned int size = static_cast<unsigned int>(points->size());
+	for (unsigned int i = 0; i < threadCount; ++i) {
+		firstIndices[i] = size;
+		size += counts[i];
+	}
+	points->resize(size);
+
+	/* second pass: each block writes its points into its own range */
+	if (threadCount == 1) {
+		projectRows(depthImage, minValue, 0, height, points, firstIndices[0]);
+	} else {
+		boost::thread_group workers;
+		for (unsigned int i = 0; i < threadCount; ++i) {
+			workers.create_thread(boost::bind(&DepthImageToPointCloudTransformation::projectRows, this, depthImage,
+					minValue, rowBegin[i], rowBegin[i + 1], points, firstIndices[i]));
+		}
+		workers.join_all();
+	}
+}
+
+void DepthImageToPointCloudTransformation::transformDepthImageToOrganizedPointCloud(IplImage *depthImage,
+		OrganizedPointCloud3D *pointCloud, double threshold) {
+
+	unsigned int minValue = 0;
+	unsigned int threadCount = 1;
+	if (pointCloud == NULL) {
+		LOG(ERROR) << "DepthImageToPointCloudTransformation: NULL pointer in input parameters";
 		return;
 	}
+	if (!prepare(depthImage, threshold, minValue, threadCount)) {
+		return;
+	}
+	int height = depthImage->height;
+	pointCloud->resize(depthImage->width, height);
+
+	/* each pixel has a fixed position, so no counting pass is needed */
+	ParallelExecution::forEachRange(static_cast<unsigned int>(height), threadCount,
+			boost::bind(&DepthImageToPointCloudTransformation::projectRowsOrganized, this, depthImage, minValue, _1, _2, pointCloud));
+}
+
+bool DepthImageToPointCloudTransformation::prepare(IplImage* depthImage, double threshold, unsigned int& minValue,
+		unsigned int& threadCount) {
+
+	/* check if input parameters are valid */
+	if (depthImage == NULL) {
+		LOG(ERROR) << "DepthImageToPointCloudTransformation: NULL pointer in input parameters";
+		return false;
+	}
+	if (depthImage->nChannels != 1 || (depthImage->depth != IPL_DEPTH_8U && depthImage->depth != IPL_DEPTH_16U)) {
+		LOG(ERROR) << "DepthImageToPointCloudTransformation: Only single channel images with 8 or 16 bit unsigned depth are supported.";
+		return false;
+	}
+	if (depthImage->depth == IPL_DEPTH_16U && !isCalibrated) {
+		LOG(ERROR) << "DepthImageToPointCloudTransformation: 16 bit depth images require camera intrinsics.";
+		return false;
+	}
+
+	int width = depthImage->width;
+	int height = depthImage->height;
+	if (width <= 0 || height <= 0) {
+		return false;
+	}
+	if (isCalibrated && (width != rayWidth || height != rayHeight)) {
+		updateRays(width, height);
+	}
+
+	/* the threshold as smallest accepted pixel value; 0 carries no measurement for calibrated depth images */
+	double maxValue = (depthImage->depth == IPL_DEPTH_16U) ? 65535.0 : MAX_DEPTHIMAGE_VALUE;
+	minValue = (threshold > 0.0) ? static_cast<unsigned int>(ceil(std::min(threshold, maxValue + 1.0))) : 0u;
+	if (isCalibrated) {
+		minValue = std::max(minValue, 1u);
+	}
+
+	/* distribute the rows among the workers */
+	unsigned int numberOfPixels = static_cast<unsigned int>(width) * static_cast<unsigned int>(height);
+	threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfPixels, minPixelsPerThread);
+	threadCount = std::max(std::min(threadCount, static_cast<unsigned int>(height)), 1u);
+	return true;
+}
 
-	/* loop over all pixels and add those who are above a certain threshold */
-	for (int row = 0; row < depthImage->height; ++row) {
+void DepthImageToPointCloudTransformation::countPoints(const IplImage* depthImage, unsigned int minValue, int rowBegin,
+		int rowEnd, unsigned int* count) const {
+	std::vector<Coordinate> depth(depthImage->width);
+	std::vector<unsigned char> valid(depthImage->width);
+	unsigned int result = 0;
+	for (int row = rowBegin; row < rowEnd; ++row) {
+		convertRow(depthImage, minValue, row, &depth[0], &valid[0]);
 		for (int col = 0; col < depthImage->width; ++col) {
+			result += valid[col];
+		}
+	}
+	*count = result;
+}
+
+void DepthImageToPointCloudTransformation::projectRows(const IplImage* depthImage, unsigned int minValue, int rowBegin,
+		int rowEnd, PointContainer* points, unsigned int firstIndex) const {
+	int width = depthImage->width;
+	std::vector<Coordinate> depth(width);
+	std::vector<unsigned char> valid(width);
+	unsigned int index = firstIndex;
 
-			/* access pixel in image */
-			pixel = cvGet2D(depthImage, row, col);
-			pixelValue = pixel.val[0]; // assumption: input is gray scale
-			//cout << "pixelValue: " << pixelValue /*<< endl*/; //DBG
-
-			/* faster variant: (but should be more tested before usage) */
-			//double pixelValue_test = (double)(uchar)*(depthImage->imageData + row*depthImage->widthStep + col);
-			//cout << " pixelValue_test: " << pixelValue_test << endl; //DBG
-			//assert(pixelValue == pixelValue_test);
-
-			if (pixelValue >= threshold) {
-				/* TODO is now uncalibrated */
-				//x = col;
-				//y = row;
-				//z = pixelValue;
-				x = col;
-				assert((0.0 <= pixelValue) && (pixelValue <= 255.0)); //comment out for optimization
-				y = MAX_DEPTHIMAGE_VALUE - pixelValue; // invert here because bright regions appears nearer (at least for zcam) TODO: check if this common
-				z = depthImage->height - row; //flips the image (because of negative y axis definition in depth images)
-				pointCloud->addPoint(Point3D(x,y,z));
+	for (int row = rowBegin; row < rowEnd; ++row) {
+		convertRow(depthImage, minValue, row, &depth[0], &valid[0]);
+
+		if (isCalibrated) {
+			const float* rowRayX = &rayX[static_cast<size_t>(row) * width];
+			const float* rowRayZ = &rayZ[static_cast<size_t>(row) * width];
+			for (int col = 0; col < width; ++col) {
+				if (valid[col]) {
+					(*points)[index++] = Point3D(depth[col] * rowRayX[col], depth[col], depth[col] * rowRayZ[col]);
+				}
+			}
+		} else {
+			Coordinate z = depthImage->height - row; //flips the image (because of negative y axis definition in depth images)
+			for (int col = 0; col < width; ++col) {
+				if (valid[col]) {
+					(*points)[index++] = Point3D(col, depth[col], z);
+				}
+			}
+		}
+	}
+}
+
+void DepthImageToPointCloudTransformation::projectRowsOrganized(const IplImage* depthImage, unsigned int minValue,
+		int rowBegin, int rowEnd, OrganizedPointCloud3D* pointCloud) const {
+	int width = depthImage->width;
+	std::vector<Coordinate> depth(width);
+	std::vector<unsigned char> valid(width);
+
+	for (int row = rowBegin; row < rowEnd; ++row) {
+		convertRow(depthImage, minValue, row, &depth[0], &valid[0]);
+
+		if (isCalibrated) {
+			const float* rowRayX = &rayX[static_cast<size_t>(row) * width];
+			const float* rowRayZ = &rayZ[static_cast<size_t>(row) * width];
+			for (int col = 0; col < width; ++col) {
+				if (valid[col]) {
+					pointCloud->setPoint(row, col, depth[col] * rowRayX[col], depth[col], depth[col] * rowRayZ[col]);
+				}
+			}
+		} else {
+			Coordinate z = depthImage->height - row;
+			for (int col = 0; col < width; ++col) {
+				if (valid[col]) {
+					pointCloud->setPoint(row, col, col, depth[col], z);
+				}
+			}
+		}
+	}
+}
+
+void DepthImageToPointCloudTransformation::convertRow(const IplImage* depthImage, unsigned int minValue, int row,
+		Coordinate* depth, unsigned char* valid) const {
+	int width = depthImage->width;
+	const char* rowData = depthImage->imageData + static_cast<size_t>(row) * depthImage->widthStep;
+
+	/* branch free loops over the raw buffer */
+	if (depthImage->depth == IPL_DEPTH_16U) {
+		const unsigned short* pixels = reinterpret_cast<const unsigned short*>(rowData);
+		for (int col = 0; col < width; ++col) {
+			depth[col] = pixels[col] * depthScale;
+			valid[col] = (pixels[col] >= minValue) ? 1 : 0;
+		}
+	} else if (isCalibrated) {
+		const unsigned char* pixels = reinterpret_cast<const unsigned char*>(rowData);
+		for (int col = 0; col < width; ++col) {
+			depth[col] = pixels[col] * depthScale;
+			valid[col] = (pixels[col] >= minValue) ? 1 : 0;
+		}
+	} else {
+		const unsigned char* pixels = reinterpret_cast<const unsigned char*>(rowData);
+		for (int col = 0; col < width; ++col) {
+			depth[col] = MAX_DEPTHIMAGE_VALUE - pixels[col]; // invert here because bright regions appears nearer (at least for zcam)
+			valid[col] = (pixels[col] >= minValue) ? 1 : 0;
+		}
+	}
+}
+
+void DepthImageToPointCloudTransformation::updateRays(int width, int height) {
+	size_t numberOfPixels = static_cast<size_t>(width) * height;
+	rayX.resize(numberOfPixels);
+	rayZ.resize(numberOfPixels);
+	bool isDistorted = (k1 != 0.0 || k2 != 0.0 || p1 != 0.0 || p2 != 0.0 || k3 != 0.0);
+
+	size_t index = 0;
+	for (int row = 0; row < height; ++row) {
+		double yDistorted = (row - cy) / fy;
+		for (int col = 0; col < width; ++col, ++index) {
+			double xDistorted = (col - cx) / fx;
+			double x = xDistorted;
+			double y = yDistorted;
+
+			/* invert the distortion model by fixed point iteration (as cvUndistortPoints does) */
+			for (int i = 0; isDistorted && i < undistortionIterations; ++i) {
+				double r2 = x * x + y * y;
+				double radialInverse = 1.0 / (1.0 + ((k3 * r2 + k2) * r2 + k1) * r2);
+				double deltaX = 2.0 * p1 * x * y + p2 * (r2 + 2.0 * x * x);
+				double deltaY = p1 * (r2 + 2.0 * y * y) + 2.0 * p2 * x * y;
+				x = (xDistorted - deltaX) * radialInverse;
+				y = (yDistorted - deltaY) * radialInverse;
 			}
+
+			rayX[index] = static_cast<float>(x);
+			rayZ[index] = static_cast<float>(-y); // image rows point downwards, z points upwards
 		}
 	}
+	rayWidth = width;
+	rayHeight = height;
+}
+
+void DepthImageToPointCloudTransformation::setIntrinsics(double fx, double fy, double cx, double cy) {
+	assert(fx != 0.0 && fy != 0.0);
+	this->fx = fx;
+	this->fy = fy;
+	this->cx = cx;
+	this->cy = cy;
+	isCalibrated = true;
+	rayWidth = 0;
+	rayHeight = 0;
+}
+
+bool DepthImageToPointCloudTransformation::getIntrinsics(double& fx, double& fy, double& cx, double& cy) const {
+	fx = this->fx;
+	fy = this->fy;
+	cx = this->cx;
+	cy = this->cy;
+	return isCalibrated;
+}
+
+void DepthImageToPointCloudTransformation::setDistortion(double k1, double k2, double p1, double p2, double k3) {
+	this->k1 = k1;
+	this->k2 = k2;
+	this->p1 = p1;
+	this->p2 = p2;
+	this->k3 = k3;
+	rayWidth = 0;
+	rayHeight = 0;
+}
+
+void DepthImageToPointCloudTransformation::resetIntrinsics() {
+	isCalibrated = false;
+	fx = 1.0;
+	fy = 1.0;
+	cx = 0.0;
+	cy = 0.0;
+	k1 = 0.0;
+	k2 = 0.0;
+	p1 = 0.0;
+	p2 = 0.0;
+	k3 = 0.0;
+	rayX.clear();
+	rayZ.clear();
+	rayWidth = 0;
+	rayHeight = 0;
+}
+
+double DepthImageToPointCloudTransformation::getDepthScale() const {
+	return depthScale;
+}
+
+void DepthImageToPointCloudTransformation::setDepthScale(double depthScale) {
+	this->depthScale = depthScale;
+}
+
+unsigned int DepthImageToPointCloudTransformation::getNumberOfThreads() const {
+	return numberOfThreads;
+}
 
-	/* plausibility check */
-	assert(pointCloud->getSize() >= 0u && pointCloud->getSize() <= static_cast<unsigned int>(depthImage->imageSize));
+void DepthImageToPointCloudTransformation::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
 }
 
 }
@@ -21,9 +21,12 @@
 #define BRICS_3D_DEPTHIMAGETOPOINTCLOUDTRANSFORMATION_H_
 
 #include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/OrganizedPointCloud3D.h"
 #include <cv.h>
 #include <highgui.h>
 
+#include <vector>
+
 /// Maximum value for depth image as it is assumed to be an (unsigned) 8bit grayscale image
 #define MAX_DEPTHIMAGE_VALUE 255
 
@@ -37,6 +40,31 @@ namespace brics_3d {
  *
  * @ingroup depth_perception
  *
+ * Two projections are supported:
+ *  - <b>Uncalibrated</b> (default): the image coordinates are used as point coordinates. This works for 8bit
+ *    gray scale images only, where brighter regions appear nearer to the camera (x = col,
+ *    y = MAX_DEPTHIMAGE_VALUE - pixelValue, z = height - row).
+ *  - <b>Calibrated</b> (see setIntrinsics()): a pinhole projection with optional radial and tangential
+ *    distortion. The pixel value multiplied by the depth scale is the distance along the optical axis, e.g.
+ *    a scale of 0.001 for 16bit depth images in millimeters (default). Pixels with value 0 carry no measurement
+ *    and are skipped.
+ *
+ * For the calibrated projection the viewing ray of each pixel is precomputed once per image size and set of
+ * intrinsics. The depth buffer is read row by row (8bit and 16bit unsigned, single channel). The rows are
+ * distributed among several worker threads (see setNumberOfThreads()), and the point cloud grows only once per image.
+ *
+ * Example usage for a 16bit depth stream:
+ *
+ * @code
+ *
+ *  DepthImageToPointCloudTransformation projection;
+ *  projection.setIntrinsics(525.0, 525.0, 319.5, 239.5);
+ *  projection.setDepthScale(0.001); // millimeters to meters
+ *  projection.setNumberOfThreads(0); // use all available cores
+ *  projection.transformDepthImageToPointCloud(depthImage, pointCloud);
+ *
+ * @endcode
+ *
  *  Point cloud frame:
  *
  *  z&nbsp;&nbsp;&nbsp;&nbsp;y		<br>
@@ -71,25 +99,155 @@ public:
 
 	/**
 	 * @brief Transforms a depth image into a point cloud
-	 * @param[in] depthImage Input pointer to depth image
-	 * @param[out] pointCloud Output pointer to point cloud
+	 * @param[in] depthImage Input pointer to depth image. Single channel, either IPL_DEPTH_8U or IPL_DEPTH_16U
+	 * (calibrated projection only).
+	 * @param[out] pointCloud Output pointer to point cloud. The points are appended.
 	 * @param threshold Threshold where to cut off background pixels. Only pixels greater or equal than this threshold are taken
 	 * Default is 0.0, that means all pixels are taken
 	 *
-	 * TODO: camera is not calibrated!!!
-	 *
 	 * <b>Implicit assumptions</b>:
 	 *
 	 * 1.) point cloud is in camera frame
 	 *
-	 * 2.) image is in gray scale and 8bit
-	 *
-	 * 3.) brighter regions appears nearer to camera
+	 * 2.) without intrinsics: image is in gray scale and 8bit, brighter regions appears nearer to camera
 	 */
 	void transformDepthImageToPointCloud(IplImage *depthImage, PointCloud3D *pointCloud, double threshold = 0.0);
 
+	/**
+	 * @brief Transforms a depth image into an organized point cloud that keeps the pixel grid.
+	 *
+	 * Same projection as transformDepthImageToPointCloud(), but the point of pixel (row, col) is stored at that
+	 * position of the organized cloud. Pixels below the threshold (and pixels without measurement) are invalid.
+	 *
+	 * @param[in] depthImage Input pointer to depth image.
+	 * @param[out] pointCloud Output pointer to the organized point cloud. It is resized to the size of the image.
+	 * @param threshold Threshold where to cut off background pixels.
+	 */
+	void transformDepthImageToOrganizedPointCloud(IplImage *depthImage, OrganizedPointCloud3D *pointCloud, double threshold = 0.0);
+
+	/**
+	 * @brief Set the pinhole camera intrinsics. Enables the calibrated projection.
+	 * @param fx Focal length in x direction (pixels).
+	 * @param fy Focal length in y direction (pixels).
+	 * @param cx Principal point, x coordinate (column).
+	 * @param cy Principal point, y coordinate (row).
+	 */
+	void setIntrinsics(double fx, double fy, double cx, double cy);
+
+	/**
+	 * @brief Get the pinhole camera intrinsics.
+	 * @return False if no intrinsics are set, i.e. the uncalibrated projection is used.
+	 */
+	bool getIntrinsics(double& fx, double& fy, double& cx, double& cy) const;
+
+	/**
+	 * @brief Set the lens distortion coefficients of the calibrated projection.
+	 *
+	 * Same model as OpenCV (Brown-Conrady). The distortion is removed when the viewing rays are precomputed.
+	 * Default is no distortion.
+	 *
+	 * @param k1 First radial coefficient.
+	 * @param k2 Second radial coefficient.
+	 * @param p1 First tangential coefficient.
+	 * @param p2 Second tangential coefficient.
+	 * @param k3 Third radial coefficient.
+	 */
+	void setDistortion(double k1, double k2, double p1, double p2, double k3 = 0.0);
+
+	/**
+	 * @brief Disable the calibrated projection. Intrinsics and distortion are reset.
+	 */
+	void resetIntrinsics();
+
+	/**
+	 * @brief Get the depth scale.
+	 * @return Distance per depth image unit.
+	 */
+	double getDepthScale() const;
+
+	/**
+	 * @brief Set the depth scale of the calibrated projection.
+	 * @param depthScale Distance per depth image unit. Default is 0.001, i.e. millimeters to meters.
+	 */
+	void setDepthScale(double depthScale);
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Minimal number of pixels that are assigned to a worker thread. Smaller images are processed by fewer threads.
+	static const unsigned int minPixelsPerThread;
+
+private:
+
+	/// Recompute the viewing rays for an image of the given size.
+	void updateRays(int width, int height);
+
+#ifdef USE_POINTER_VECTOR
+	typedef boost::ptr_vector<Point3D> PointContainer;
+#else
+	typedef std::vector<Point3D> PointContainer;
+#endif
+
+	/// Count the pixels of the rows [rowBegin, rowEnd) that are turned into points.
+	void countPoints(const IplImage* depthImage, unsigned int minValue, int rowBegin, int rowEnd, unsigned int* count) const;
+
+	/**
+	 * @brief Project the rows [rowBegin, rowEnd) of a depth image.
+	 * @param points The already resized container of the point cloud.
+	 * @param firstIndex Index of the first point of these rows in points.
+	 */
+	void projectRows(const IplImage* depthImage, unsigned int minValue, int rowBegin, int rowEnd,
+			PointContainer* points, unsigned int firstIndex) const;
+
+	/// Project the rows [rowBegin, rowEnd) of a depth image into the pixels of an organized point cloud.
+	void projectRowsOrganized(const IplImage* depthImage, unsigned int minValue, int rowBegin, int rowEnd,
+			OrganizedPointCloud3D* pointCloud) const;
+
+	/**
+	 * @brief Check the image and the parameters, and prepare the rays.
+	 * @param[out] minValue The threshold as smallest accepted pixel value.
+	 * @param[out] threadCount Number of workers for this image.
+	 * @return False if the image cannot be transformed.
+	 */
+	bool prepare(IplImage* depthImage, double threshold, unsigned int& minValue, unsigned int& threadCount);
+
+	/// Convert one row of the depth image to depth values. valid is set to 1 for the pixels that are turned into points,
+	/// i.e. pixels with a value of at least minValue.
+	void convertRow(const IplImage* depthImage, unsigned int minValue, int row, Coordinate* depth, unsigned char* valid) const;
+
+	/// True if the calibrated projection is used.
+	bool isCalibrated;
+
+	/// Pinhole intrinsics
+	double fx, fy, cx, cy;
+
+	/// Distortion coefficients
+	double k1, k2, p1, p2, k3;
+
+	/// Distance per depth image unit.
+	double depthScale;
+
+	/// Viewing ray of each pixel in row major order: x / depth
+	std::vector<float> rayX;
+
+	/// Viewing ray of each pixel in row major order: z / depth
+	std::vector<float> rayZ;
 
+	/// Image size that the rays belong to. 0 if they have to be recomputed.
+	int rayWidth, rayHeight;
 
+	/// Number of worker threads
+	unsigned int numberOfThreads;
 };
 
 }
@@ -21,6 +21,7 @@
 #include "Centroid3D.h"
 #include "brics_3d/core/Logger.h"
 #include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/HomogeneousTransformationKernel.h"
 #include <limits>
 
 namespace brics_3d {
@@ -43,8 +44,8 @@ void BoundingBox3DExtractor::computeBoundingBox(PointCloud3D* inputPointCloud, P
 
 	/* get min/max */
 	for (unsigned int i = 0; i < inputPointCloud->getSize(); ++i) {
-		Point3D* currentPoint;
-		currentPoint = &(*inputPointCloud->getPointCloud())[i];
+		const Point3D* currentPoint;
+		currentPoint = &(*inputPointCloud->getConstPointCloud())[i];
 
 		/* adjust lower bound if necessary */
 		if (currentPoint->getX() <= lowerBound.getX()) {
@@ -103,7 +104,7 @@ void BoundingBox3DExtractor::computeOrientedBoundingBox(PointCloud3D* inputPoint
 	*inverseRotation = *(resultTransform);
 	inverseRotation->inverse();
 	for (unsigned int i = 0; i < inputPointCloud->getSize(); ++i) {
-		Point3D tmpPoint = (*inputPointCloud->getPointCloud())[i];
+		Point3D tmpPoint = (*inputPointCloud->getConstPointCloud())[i];
 		tmpPoint.homogeneousTransformation(inverseRotation); // move _all_ points to new frame
 		Point3D* currentPoint = &tmpPoint;
 
@@ -176,31 +177,37 @@ void BoundingBox3DExtractor::computeOrientedBoundingBox(IPoint3DIterator::IPoint
 	*inverseRotation = *(resultTransform);
 	inverseRotation->inverse();
 
-	for (inputPointCloud->begin(); !inputPointCloud->end(); inputPointCloud->next()) {
-		Point3D tmpPoint(inputPointCloud->getX(), inputPointCloud->getY(), inputPointCloud->getZ());
-		tmpPoint.homogeneousTransformation(inverseRotation); // move _all_ points to new frame
-		Point3D* currentPoint = &tmpPoint;
-
-		/* adjust lower bound if necessary */
-		if (currentPoint->getX() <= lowerBound.getX()) {
-			lowerBound.setX(currentPoint->getX());
-		}
-		if (currentPoint->getY() <= lowerBound.getY()) {
-			lowerBound.setY(currentPoint->getY());
-		}
-		if (currentPoint->getZ() <= lowerBound.getZ()) {
-			lowerBound.setZ(currentPoint->getZ());
-		}
-
-		/* adjust upper bound if necessary */
-		if ( currentPoint->getX() >= upperBound.getX()) {
-			upperBound.setX(currentPoint->getX());
-		}
-		if	(currentPoint->getY() >= upperBound.getY()) {
-			upperBound.setY(currentPoint->getY());
-		}
-		if	(currentPoint->getZ() >= upperBound.getZ()) {
-			upperBound.setZ(currentPoint->getZ());
+	HomogeneousTransformationKernel inverseRotationKernel(inverseRotation);
+	std::vector<Coordinate> chunk(3 * IPoint3DIterator::defaultChunkSize);
+	unsigned int chunkSize;
+	inputPointCloud->begin();
+	while ((chunkSize = inputPointCloud->getNextChunk(&chunk[0], IPoint3DIterator::defaultChunkSize)) > 0) {
+		inverseRotationKernel.transformPackedCoordinates(&chunk[0], chunkSize); // move _all_ points to new frame
+
+		for (unsigned int i = 0; i < chunkSize; ++i) {
+			const Coordinate* currentPoint = &chunk[3 * i];
+
+			/* adjust lower bound if necessary */
+			if (currentPoint[0] <= lowerBound.getX()) {
+				lowerBound.setX(currentPoint[0]);
+			}
+			if (currentPoint[1] <= lowerBound.getY()) {
+				lowerBound.setY(currentPoint[1]);
+			}
+			if (currentPoint[2] <= lowerBound.getZ()) {
+				lowerBound.setZ(currentPoint[2]);
+			}
+
+			/* adjust upper bound if necessary */
+			if (currentPoint[0] >= upperBound.getX()) {
+				upperBound.setX(currentPoint[0]);
+			}
+			if (currentPoint[1] >= upperBound.getY()) {
+				upperBound.setY(currentPoint[1]);
+			}
+			if (currentPoint[2] >= upperBound.getZ()) {
+				upperBound.setZ(currentPoint[2]);
+			}
 		}
 	}
 	delete inverseRotation;
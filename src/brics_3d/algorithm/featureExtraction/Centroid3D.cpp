@@ -42,9 +42,9 @@ Eigen::Vector3d Centroid3D::computeCentroid(brics_3d::PointCloud3D *inCloud){
 	centroid[2] = 0;
 
 	for (unsigned int i = 0; i < inCloud->getSize(); i++){
-		tempX = (*inCloud->getPointCloud())[i].getX();
-		tempY = (*inCloud->getPointCloud())[i].getY();
-		tempZ = (*inCloud->getPointCloud())[i].getZ();
+		tempX = (*inCloud->getConstPointCloud())[i].getX();
+		tempY = (*inCloud->getConstPointCloud())[i].getY();
+		tempZ = (*inCloud->getConstPointCloud())[i].getZ();
 
 		if(!isnan(tempX) && !isinf(tempX) && !isnan(tempY) && !isinf(tempY) &&
 				!isnan(tempZ) && !isinf(tempZ) ) {
@@ -80,17 +80,22 @@ Eigen::Vector3d Centroid3D::computeCentroid(IPoint3DIterator::IPoint3DIteratorPt
 	centroid[1] = 0;
 	centroid[2] = 0;
 
-	for (inCloud->begin(); !inCloud->end(); inCloud->next()) {
-		tempX = inCloud->getX();
-		tempY = inCloud->getY();
-		tempZ = inCloud->getZ();
-
-		if(!isnan(tempX) && !isinf(tempX) && !isnan(tempY) && !isinf(tempY) &&
-				!isnan(tempZ) && !isinf(tempZ) ) {
-			centroid[0] = centroid[0] + tempX;
-			centroid[1] = centroid[1] + tempY;
-			centroid[2] = centroid[2] + tempZ;
-			count++;
+	std::vector<Coordinate> chunk(3 * IPoint3DIterator::defaultChunkSize);
+	unsigned int chunkSize;
+	inCloud->begin();
+	while ((chunkSize = inCloud->getNextChunk(&chunk[0], IPoint3DIterator::defaultChunkSize)) > 0) {
+		for (unsigned int i = 0; i < chunkSize; ++i) {
+			tempX = chunk[3 * i + 0];
+			tempY = chunk[3 * i + 1];
+			tempZ = chunk[3 * i + 2];
+
+			if(!isnan(tempX) && !isinf(tempX) && !isnan(tempY) && !isinf(tempY) &&
+					!isnan(tempZ) && !isinf(tempZ) ) {
+				centroid[0] = centroid[0] + tempX;
+				centroid[1] = centroid[1] + tempY;
+				centroid[2] = centroid[2] + tempZ;
+				count++;
+			}
 		}
 	}
 
@@ -120,12 +125,12 @@ Eigen::Vector4d Centroid3D::computeCentroid (PointCloud3D *inCloud, const std::v
 	int cp = 0;
 	for (size_t i = 0; i < indices.size (); ++i) {
 		// Check if the point is invalid
-		if ( isnan( (*inCloud->getPointCloud())[indices[i]].getX() ) || isnan( (*inCloud->getPointCloud())[indices[i]].getY() ) || isnan( (*inCloud->getPointCloud())[indices[i]].getZ() ))
+		if ( isnan( (*inCloud->getConstPointCloud())[indices[i]].getX() ) || isnan( (*inCloud->getConstPointCloud())[indices[i]].getY() ) || isnan( (*inCloud->getConstPointCloud())[indices[i]].getZ() ))
 			continue;
 
-		centroid[0] += (*inCloud->getPointCloud())[indices[i]].getX();
-		centroid[1] += (*inCloud->getPointCloud())[indices[i]].getY();
-		centroid[2] += (*inCloud->getPointCloud())[indices[i]].getZ();
+		centroid[0] += (*inCloud->getConstPointCloud())[indices[i]].getX();
+		centroid[1] += (*inCloud->getConstPointCloud())[indices[i]].getY();
+		centroid[2] += (*inCloud->getConstPointCloud())[indices[i]].getZ();
 		cp++;
 	}
 
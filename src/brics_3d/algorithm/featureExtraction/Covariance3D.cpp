@@ -39,13 +39,13 @@ Eigen::Matrix3d Covariance3D::computeCovarianceMatrix(PointCloud3D* cloud, const
 
 	for (size_t i = 0; i < cloud->getSize(); ++i) {
 		// Check if the point is invalid
-		if ( isnan( (*cloud->getPointCloud())[i].getX() ) || isnan( (*cloud->getPointCloud())[i].getY() ) || isnan( (*cloud->getPointCloud())[i].getZ() ))
+		if ( isnan( (*cloud->getConstPointCloud())[i].getX() ) || isnan( (*cloud->getConstPointCloud())[i].getY() ) || isnan( (*cloud->getConstPointCloud())[i].getZ() ))
 			continue;
 
 		Point3D p;
-		p.setX( (*cloud->getPointCloud())[i].getX() - centroid[0]);
-		p.setY( (*cloud->getPointCloud())[i].getY() - centroid[1]);
-		p.setZ( (*cloud->getPointCloud())[i].getZ() - centroid[2]);
+		p.setX( (*cloud->getConstPointCloud())[i].getX() - centroid[0]);
+		p.setY( (*cloud->getConstPointCloud())[i].getY() - centroid[1]);
+		p.setZ( (*cloud->getConstPointCloud())[i].getZ() - centroid[2]);
 
 		double demean_xy = p.getX() * p.getY();
 		double demean_xz = p.getX() * p.getZ();
@@ -76,13 +76,13 @@ Eigen::Matrix3d Covariance3D::computeCovarianceMatrix(PointCloud3D* cloud, const
 	// For each point in the cloud
 	for (size_t i = 0; i < indices.size (); ++i) {
 		// Check if the point is invalid
-		if ( isnan( (*cloud->getPointCloud())[indices[i]].getX() ) || isnan( (*cloud->getPointCloud())[indices[i]].getY() ) || isnan( (*cloud->getPointCloud())[indices[i]].getZ() ))
+		if ( isnan( (*cloud->getConstPointCloud())[indices[i]].getX() ) || isnan( (*cloud->getConstPointCloud())[indices[i]].getY() ) || isnan( (*cloud->getConstPointCloud())[indices[i]].getZ() ))
 			continue;
 
 		Point3D p;
-		p.setX( (*cloud->getPointCloud())[indices[i]].getX() - centroid[0]);
-		p.setY( (*cloud->getPointCloud())[indices[i]].getY() - centroid[1]);
-		p.setZ( (*cloud->getPointCloud())[indices[i]].getZ() - centroid[2]);
+		p.setX( (*cloud->getConstPointCloud())[indices[i]].getX() - centroid[0]);
+		p.setY( (*cloud->getConstPointCloud())[indices[i]].getY() - centroid[1]);
+		p.setZ( (*cloud->getConstPointCloud())[indices[i]].getZ() - centroid[2]);
 
 		double demean_xy = p.getX() * p.getY();
 		double demean_xz = p.getX() * p.getZ();
@@ -44,7 +44,7 @@ public:
 	 * @param[out] estimatedNormals Resulting set of estimated normals.
 	 *
 	 */
-	void estimateNormals(PointCloud3D* pointCloud, NormalSet3D* estimatedNormals);
+	virtual void estimateNormals(PointCloud3D* pointCloud, NormalSet3D* estimatedNormals) = 0;
 };
 
 }
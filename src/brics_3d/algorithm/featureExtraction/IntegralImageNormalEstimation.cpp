@@ -0,0 +1,315 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include "IntegralImageNormalEstimation.h"
+#include "ParallelNormalEstimation.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
+
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <assert.h>
+#include <boost/bind.hpp>
+
+namespace brics_3d {
+
+const unsigned int IntegralImageNormalEstimation::numberOfSums = 10;
+
+const unsigned int IntegralImageNormalEstimation::minPixelsPerThread = 20000;
+
+IntegralImageNormalEstimation::IntegralImageNormalEstimation() {
+	this->windowRadius = 3;
+	this->minNeighbors = 3;
+	this->maxDepthChangeFactor = 0.05;
+	this->vpx = 0.0;
+	this->vpy = 0.0;
+	this->vpz = 0.0;
+	this->numberOfThreads = 1;
+}
+
+IntegralImageNormalEstimation::~IntegralImageNormalEstimation() {
+
+}
+
+void IntegralImageNormalEstimation::estimateNormals(const OrganizedPointCloud3D* pointCloud, NormalSet3D* estimatedNormals) {
+	assert(pointCloud != 0);
+	assert(estimatedNormals != 0);
+
+	unsigned int width = pointCloud->getWidth();
+	unsigned int height = pointCloud->getHeight();
+	std::vector<Normal3D>* normals = estimatedNormals->getNormals();
+	normals->resize(pointCloud->getSize());
+	if (pointCloud->getSize() == 0) {
+		return;
+	}
+
+	const Coordinate* x = pointCloud->getXCoordinates();
+	const Coordinate* y = pointCloud->getYCoordinates();
+	const Coordinate* z = pointCloud->getZCoordinates();
+	const unsigned char* valid = pointCloud->getValidMask();
+
+	/* the sums are taken relative to a point of the cloud, which avoids cancellation for clouds far from the origin */
+	double offset[3] = {0.0, 0.0, 0.0};
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		if (valid[i]) {
+			offset[0] = x[i];
+			offset[1] = y[i];
+			offset[2] = z[i];
+			break;
+		}
+	}
+
+	/* summed area table with an additional zero row and column: entry (r, c) holds the sums of rows [0, r) and columns [0, c) */
+	const unsigned int stride = (width + 1) * numberOfSums;
+	std::vector<double> integralImage(stride * (height + 1), 0.0);
+	double rowSums[numberOfSums];
+	for (unsigned int row = 0; row < height; ++row) {
+		std::fill(rowSums, rowSums + numberOfSums, 0.0);
+		const double* above = &integralImage[row * stride + numberOfSums];
+		double* current = &integralImage[(row + 1) * stride + numberOfSums];
+		for (unsigned int col = 0; col < width; ++col) {
+			unsigned int index = row * width + col;
+			if (valid[index]) {
+				double px = x[index] - offset[0];
+				double py = y[index] - offset[1];
+				double pz = z[index] - offset[2];
+				rowSums[0] += 1.0;
+				rowSums[1] += px;
+				rowSums[2] += py;
+				rowSums[3] += pz;
+				rowSums[4] += px * px;
+				rowSums[5] += px * py;
+				rowSums[6] += px * pz;
+				rowSums[7] += py * py;
+				rowSums[8] += py * pz;
+				rowSums[9] += pz * pz;
+			}
+			for (unsigned int k = 0; k < numberOfSums; ++k) {
+				current[col * numberOfSums + k] = above[col * numberOfSums + k] + rowSums[k];
+			}
+		}
+	}
+
+	std::vector<unsigned int> windowRadii;
+	const std::vector<unsigned int>* windowRadiiPtr = 0;
+	if (maxDepthChangeFactor > 0.0) {
+		computeWindowRadii(pointCloud, windowRadii);
+		windowRadiiPtr = &windowRadii;
+	}
+
+	unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, pointCloud->getSize(), minPixelsPerThread);
+	threadCount = std::min(threadCount, height);
+	ParallelExecution::forEachRange(height, threadCount,
+			boost::bind(&IntegralImageNormalEstimation::estimateNormalRows, this, pointCloud, &integralImage, windowRadiiPtr, _1, _2, normals));
+	LOG(DEBUG) << "IntegralImageNormalEstimation: " << pointCloud->getSize() << " normals estimated by " << threadCount << " threads.";
+}
+
+void IntegralImageNormalEstimation::computeWindowRadii(const OrganizedPointCloud3D* pointCloud, std::vector<unsigned int>& windowRadii) const {
+	const unsigned int width = pointCloud->getWidth();
+	const unsigned int height = pointCloud->getHeight();
+	const Coordinate* x = pointCloud->getXCoordinates();
+	const Coordinate* y = pointCloud->getYCoordinates();
+	const Coordinate* z = pointCloud->getZCoordinates();
+	const unsigned char* valid = pointCloud->getValidMask();
+
+	std::vector<double> depth(pointCloud->getSize(), 0.0);
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		if (valid[i]) {
+			depth[i] = sqrt((x[i] - vpx) * (x[i] - vpx) + (y[i] - vpy) * (y[i] - vpy) + (z[i] - vpz) * (z[i] - vpz));
+		}
+	}
+
+	/* mark both pixels of a depth jump to the right or downwards with radius 0 */
+	windowRadii.assign(pointCloud->getSize(), windowRadius);
+	for (unsigned int row = 0; row < height; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			unsigned int index = row * width + col;
+			if (!valid[index]) {
+				continue;
+			}
+			if (col + 1 < width && valid[index + 1] &&
+					fabs(depth[index + 1] - depth[index]) > maxDepthChangeFactor * std::min(depth[index + 1], depth[index])) {
+				windowRadii[index] = 0;
+				windowRadii[index + 1] = 0;
+			}
+			if (row + 1 < height && valid[index + width] &&
+					fabs(depth[index + width] - depth[index]) > maxDepthChangeFactor * std::min(depth[index + width], depth[index])) {
+				windowRadii[index] = 0;
+				windowRadii[index + width] = 0;
+			}
+		}
+	}
+
+	/* chessboard distance to the nearest marked pixel (two pass distance transform), capped at windowRadius */
+	for (unsigned int row = 0; row < height; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			unsigned int& radius = windowRadii[row * width + col];
+			if (col > 0) {
+				radius = std::min(radius, windowRadii[row * width + col - 1] + 1);
+			}
+			if (row > 0) {
+				unsigned int above = (row - 1) * width + col;
+				radius = std::min(radius, windowRadii[above] + 1);
+				if (col > 0) {
+					radius = std::min(radius, windowRadii[above - 1] + 1);
+				}
+				if (col + 1 < width) {
+					radius = std::min(radius, windowRadii[above + 1] + 1);
+				}
+			}
+		}
+	}
+	for (int row = static_cast<int>(height) - 1; row >= 0; --row) {
+		for (int col = static_cast<int>(width) - 1; col >= 0; --col) {
+			unsigned int& radius = windowRadii[row * width + col];
+			if (col + 1 < static_cast<int>(width)) {
+				radius = std::min(radius, windowRadii[row * width + col + 1] + 1);
+			}
+			if (row + 1 < static_cast<int>(height)) {
+				unsigned int below = (row + 1) * width + col;
+				radius = std::min(radius, windowRadii[below] + 1);
+				if (col > 0) {
+					radius = std::min(radius, windowRadii[below - 1] + 1);
+				}
+				if (col + 1 < static_cast<int>(width)) {
+					radius = std::min(radius, windowRadii[below + 1] + 1);
+				}
+			}
+		}
+	}
+}
+
+void IntegralImageNormalEstimation::estimateNormalRows(const OrganizedPointCloud3D* pointCloud, const std::vector<double>* integralImage,
+		const std::vector<unsigned int>* windowRadii, unsigned int rowBegin, unsigned int rowEnd, std::vector<Normal3D>* normals) const {
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const unsigned int width = pointCloud->getWidth();
+	const unsigned int height = pointCloud->getHeight();
+	const unsigned int stride = (width + 1) * numberOfSums;
+	const unsigned int minCount = std::max(minNeighbors, 3u);
+	const Coordinate* x = pointCloud->getXCoordinates();
+	const Coordinate* y = pointCloud->getYCoordinates();
+	const Coordinate* z = pointCloud->getZCoordinates();
+	const unsigned char* valid = pointCloud->getValidMask();
+	const double* table = &(*integralImage)[0];
+
+	for (unsigned int row = rowBegin; row < rowEnd; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			unsigned int index = row * width + col;
+			if (!valid[index]) {
+				(*normals)[index] = Normal3D(nan, nan, nan);
+				continue;
+			}
+
+			/* sums of the window from four entries of the table */
+			unsigned int radius = (windowRadii != 0) ? (*windowRadii)[index] : windowRadius;
+			unsigned int top = (row > radius) ? row - radius : 0;
+			unsigned int bottom = std::min(row + radius + 1, height);
+			unsigned int left = (col > radius) ? col - radius : 0;
+			unsigned int right = std::min(col + radius + 1, width);
+			const double* bottomRight = &table[bottom * stride + right * numberOfSums];
+			const double* bottomLeft = &table[bottom * stride + left * numberOfSums];
+			const double* topRight = &table[top * stride + right * numberOfSums];
+			const double* topLeft = &table[top * stride + left * numberOfSums];
+			double sums[numberOfSums];
+			for (unsigned int k = 0; k < numberOfSums; ++k) {
+				sums[k] = bottomRight[k] - bottomLeft[k] - topRight[k] + topLeft[k];
+			}
+
+			double count = sums[0];
+			if (count < minCount - 0.5) {
+				(*normals)[index] = Normal3D(nan, nan, nan);
+				continue;
+			}
+			double mean[3] = {sums[1] / count, sums[2] / count, sums[3] / count};
+			double covariance[6] = {
+					sums[4] / count - mean[0] * mean[0],
+					sums[5] / count - mean[0] * mean[1],
+					sums[6] / count - mean[0] * mean[2],
+					sums[7] / count - mean[1] * mean[1],
+					sums[8] / count - mean[1] * mean[2],
+					sums[9] / count - mean[2] * mean[2]};
+
+			double normalVector[3];
+			if (!ParallelNormalEstimation::computeSmallestEigenvector(covariance, normalVector)) {
+				(*normals)[index] = Normal3D(nan, nan, nan);
+				continue;
+			}
+
+			/* flip towards the viewpoint */
+			double cosTheta = (vpx - x[index]) * normalVector[0] + (vpy - y[index]) * normalVector[1] + (vpz - z[index]) * normalVector[2];
+			if (cosTheta < 0) {
+				normalVector[0] = -normalVector[0];
+				normalVector[1] = -normalVector[1];
+				normalVector[2] = -normalVector[2];
+			}
+			(*normals)[index] = Normal3D(normalVector[0], normalVector[1], normalVector[2]);
+		}
+	}
+}
+
+unsigned int IntegralImageNormalEstimation::getWindowRadius() const {
+	return windowRadius;
+}
+
+void IntegralImageNormalEstimation::setWindowRadius(unsigned int windowRadius) {
+	this->windowRadius = windowRadius;
+}
+
+unsigned int IntegralImageNormalEstimation::getMinNeighbors() const {
+	return minNeighbors;
+}
+
+void IntegralImageNormalEstimation::setMinNeighbors(unsigned int minNeighbors) {
+	this->minNeighbors = minNeighbors;
+}
+
+double IntegralImageNormalEstimation::getMaxDepthChangeFactor() const {
+	return maxDepthChangeFactor;
+}
+
+void IntegralImageNormalEstimation::setMaxDepthChangeFactor(double maxDepthChangeFactor) {
+	this->maxDepthChangeFactor = maxDepthChangeFactor;
+}
+
+void IntegralImageNormalEstimation::setViewPoint(double vpx, double vpy, double vpz) {
+	this->vpx = vpx;
+	this->vpy = vpy;
+	this->vpz = vpz;
+}
+
+void IntegralImageNormalEstimation::getViewPoint(double& vpx, double& vpy, double& vpz) const {
+	vpx = this->vpx;
+	vpy = this->vpy;
+	vpz = this->vpz;
+}
+
+unsigned int IntegralImageNormalEstimation::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void IntegralImageNormalEstimation::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+}
+
+/* EOF */
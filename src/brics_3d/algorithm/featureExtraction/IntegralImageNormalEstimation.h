@@ -0,0 +1,192 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef BRICS_3D_INTEGRALIMAGENORMALESTIMATION_H_
+#define BRICS_3D_INTEGRALIMAGENORMALESTIMATION_H_
+
+#include "brics_3d/core/OrganizedPointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+
+#include <vector>
+
+namespace brics_3d {
+
+/**
+ * @brief Normal estimation for organized point clouds with integral images.
+ * @ingroup featureExtraction
+ *
+ * The neighborhood of a point is the square window of pixels around it (see setWindowRadius()), so no
+ * nearest neighbor index is needed. The sums of the coordinates and of their pairwise products are accumulated
+ * once into integral images (summed area tables). Then the centroid and covariance of any window are obtained from
+ * four lookups, independent of the window size, i.e. the whole estimation runs in linear time in the number of pixels.
+ * The normal is the eigenvector of the covariance matrix that belongs to the smallest eigenvalue, flipped towards the
+ * viewpoint, as for the ParallelNormalEstimation.
+ *
+ * The normals are written to a NormalSet3D that is resized to the size of the organized cloud, so the ith normal
+ * belongs to the ith pixel. Invalid pixels and pixels with less than getMinNeighbors() valid points in
+ * their window get a NaN normal.
+ *
+ * As the window is defined in pixel space, it may cover points of different surfaces at depth discontinuities.
+ * Therefore neighboring pixels whose distances to the viewpoint differ by more than getMaxDepthChangeFactor() times
+ * that distance are marked as a depth discontinuity, and the window of a pixel is shrunk so that it does not extend
+ * beyond the nearest marked pixel (see setMaxDepthChangeFactor()). Pixels directly at a discontinuity thus get a NaN
+ * normal.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  IntegralImageNormalEstimation normalEstimator;
+ *  normalEstimator.setWindowRadius(4); // 9x9 pixels
+ *  normalEstimator.estimateNormals(organizedCloud, normals);
+ *
+ * @endcode
+ */
+class IntegralImageNormalEstimation {
+public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	IntegralImageNormalEstimation();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~IntegralImageNormalEstimation();
+
+	/**
+	 * @brief Estimates the normals of an organized point cloud.
+	 * @param[in] pointCloud The input point cloud.
+	 * @param[out] estimatedNormals The resulting normals, one per pixel. Previous content will be overwritten.
+	 */
+	void estimateNormals(const OrganizedPointCloud3D* pointCloud, NormalSet3D* estimatedNormals);
+
+	/**
+	 * @brief Get the window radius.
+	 * @return The radius in pixels.
+	 */
+	unsigned int getWindowRadius() const;
+
+	/**
+	 * @brief Set the window radius. The window of a pixel covers (2 * windowRadius + 1)^2 pixels, clipped at the
+	 * border of the image. Default is 3.
+	 * @param windowRadius The radius in pixels.
+	 */
+	void setWindowRadius(unsigned int windowRadius);
+
+	/**
+	 * @brief Get the minimal number of valid points in a window.
+	 * @return The number of points.
+	 */
+	unsigned int getMinNeighbors() const;
+
+	/**
+	 * @brief Set the minimal number of valid points in a window (including the point itself). Default is 3.
+	 * @param minNeighbors The number of points. Values below 3 are treated as 3.
+	 */
+	void setMinNeighbors(unsigned int minNeighbors);
+
+	/**
+	 * @brief Get the maximal relative depth change between neighboring pixels of the same surface.
+	 * @return The factor.
+	 */
+	double getMaxDepthChangeFactor() const;
+
+	/**
+	 * @brief Set the maximal relative depth change between neighboring pixels of the same surface. Two neighboring
+	 * pixels whose distances to the viewpoint differ by more than maxDepthChangeFactor times the smaller distance
+	 * belong to a depth discontinuity. Default is 0.05.
+	 * @param maxDepthChangeFactor The factor. 0 disables the check, i.e. every window has the full size.
+	 */
+	void setMaxDepthChangeFactor(double maxDepthChangeFactor);
+
+	/**
+	 * @brief Set the viewpoint. The normals are flipped towards it. Default is the origin.
+	 * @param vpx The X coordinate of the viewpoint.
+	 * @param vpy The Y coordinate of the viewpoint.
+	 * @param vpz The Z coordinate of the viewpoint.
+	 */
+	void setViewPoint(double vpx, double vpy, double vpz);
+
+	/**
+	 * @brief Get the viewpoint.
+	 * @param[out] vpx The X coordinate of the viewpoint.
+	 * @param[out] vpy The Y coordinate of the viewpoint.
+	 * @param[out] vpz The Z coordinate of the viewpoint.
+	 */
+	void getViewPoint(double& vpx, double& vpy, double& vpz) const;
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads for the normal computation. The integral images are built serially.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Number of sums per integral image entry: count, x, y, z, xx, xy, xz, yy, yz, zz
+	static const unsigned int numberOfSums;
+
+	/// Minimal number of pixels that are assigned to a worker thread. Smaller images are processed by fewer threads.
+	static const unsigned int minPixelsPerThread;
+
+private:
+
+	/**
+	 * @brief Compute the window radius of each pixel, so that no window extends beyond a depth discontinuity.
+	 * @param[out] windowRadii The radius per pixel, at most windowRadius.
+	 */
+	void computeWindowRadii(const OrganizedPointCloud3D* pointCloud, std::vector<unsigned int>& windowRadii) const;
+
+	/**
+	 * @brief Estimate the normals of the rows [rowBegin, rowEnd).
+	 * @param integralImage The summed area table with (width + 1) * (height + 1) entries of numberOfSums values.
+	 * @param windowRadii The window radius per pixel or null if all windows have the radius windowRadius.
+	 */
+	void estimateNormalRows(const OrganizedPointCloud3D* pointCloud, const std::vector<double>* integralImage,
+			const std::vector<unsigned int>* windowRadii, unsigned int rowBegin, unsigned int rowEnd, std::vector<Normal3D>* normals) const;
+
+	/// Window radius
+	unsigned int windowRadius;
+
+	/// Minimal number of valid points in a window
+	unsigned int minNeighbors;
+
+	/// Maximal relative depth change between neighboring pixels of the same surface
+	double maxDepthChangeFactor;
+
+	/// Viewpoint
+	double vpx, vpy, vpz;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
+};
+
+}
+
+#endif /* BRICS_3D_INTEGRALIMAGENORMALESTIMATION_H_ */
+
+/* EOF */
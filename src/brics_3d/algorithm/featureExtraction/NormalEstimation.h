@@ -340,11 +340,11 @@ public:
 		for (size_t i = 0; i < cloud->getSize(); ++i)
 		{
 			// Check if the point is invalid
-			if (isnan ((*cloud->getPointCloud())[i].getX()) || isnan ((*cloud->getPointCloud())[i].getY())
-					|| isnan ((*cloud->getPointCloud())[i].getZ()))
+			if (isnan ((*cloud->getConstPointCloud())[i].getX()) || isnan ((*cloud->getConstPointCloud())[i].getY())
+					|| isnan ((*cloud->getConstPointCloud())[i].getZ()))
 				continue;
 
-			double x = (*cloud->getPointCloud())[i].getX();
+			double x = (*cloud->getConstPointCloud())[i].getX();
 			centroid += Eigen::Vector4d::MapAligned (&x);
 			cp++;
 		}
@@ -390,18 +390,27 @@ public:
 		//using the default number of nearrest-neighbours used.
 		//ToDo enable configuration of 'k'
 		std::vector<int> nn_indices;
+		std::vector<int> batch_indices;
 //		nn_indices.resize(k_neighbours);
 		double curvature;
 		// Iterating over the entire index vector
 		nnSearchMethod->setData(this->inputPointCloud);
 
+		// query the neighborhoods of all points at once
+		nnSearchMethod->findNearestNeighbors(this->inputPointCloud, &batch_indices, 0, k_neighbours);
+
 //		std::vector<Point3D>* points;
 //		points = inputPointCloud->getPointCloud();
 
 		for (size_t idx = 0; idx < this->inputPointCloud->getSize(); ++idx)
 		{
 
-			nnSearchMethod->findNearestNeighbors(&(*inputPointCloud->getPointCloud())[idx], &nn_indices, k_neighbours);
+			nn_indices.clear();
+			for (size_t j = idx * k_neighbours; j < (idx + 1) * k_neighbours; ++j) {
+				if (batch_indices[j] >= 0) {
+					nn_indices.push_back(batch_indices[j]);
+				}
+			}
 
 			if (nn_indices.size()==0)
 			{
@@ -452,11 +461,6 @@ public:
 	      normal.setX(-1*normal.getX());
 	      normal.setY(-1*normal.getY());
 	      normal.setZ(-1*normal.getZ());
-	      // Hessian form (D = nc . p_plane (centroid here) + p)
-	      normal.setZ(-1 * (
-	    		  normal.getX() * point.getX() +
-	    		  normal.getY() * point.getY() +
-	    		  normal.getZ() * point.getZ()));
 	    }
 	  }
 
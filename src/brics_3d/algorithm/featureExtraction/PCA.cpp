@@ -42,9 +42,9 @@ void PCA::computePrincipleComponents(PointCloud3D* inputPointCloud, Eigen::Matri
 	covariance.setZero ();
 	for (unsigned int i = 0; i < inputPointCloud->getSize(); ++i) {
 		Eigen::Vector4d pt;
-		pt[0] = (*inputPointCloud->getPointCloud())[i].getX() - centroid[0];
-		pt[1] = (*inputPointCloud->getPointCloud())[i].getY() - centroid[1];
-		pt[2] = (*inputPointCloud->getPointCloud())[i].getZ() - centroid[2];
+		pt[0] = (*inputPointCloud->getConstPointCloud())[i].getX() - centroid[0];
+		pt[1] = (*inputPointCloud->getConstPointCloud())[i].getY() - centroid[1];
+		pt[2] = (*inputPointCloud->getConstPointCloud())[i].getZ() - centroid[2];
 		pt[3] = 1.0; //homogeneous point
 
 		covariance (1, 1) += pt.y () * pt.y (); //the non X parts
@@ -94,23 +94,27 @@ void PCA::computePrincipleComponents(IPoint3DIterator::IPoint3DIteratorPtr input
 	/*** compute covariance matrix  ***/
 	covariance.setZero ();
 	int pointCount  = 0;
-	for (inputPointCloud->begin(); !inputPointCloud->end(); inputPointCloud->next()) {
-		Eigen::Vector4d pt;
-		pt[0] = inputPointCloud->getX() - centroid[0];
-		pt[1] = inputPointCloud->getY() - centroid[1];
-		pt[2] = inputPointCloud->getZ() - centroid[2];
-		pt[3] = 1.0; //homogeneous point
-
-		covariance (1, 1) += pt.y () * pt.y (); //the non X parts
-		covariance (1, 2) += pt.y () * pt.z ();
-		covariance (2, 2) += pt.z () * pt.z ();
-
-		pt *= pt.x ();
-		covariance (0, 0) += pt.x (); //the X related parts
-		covariance (0, 1) += pt.y ();
-		covariance (0, 2) += pt.z ();
-
-		pointCount++;
+	std::vector<Coordinate> chunk(3 * IPoint3DIterator::defaultChunkSize);
+	unsigned int chunkSize;
+	inputPointCloud->begin();
+	while ((chunkSize = inputPointCloud->getNextChunk(&chunk[0], IPoint3DIterator::defaultChunkSize)) > 0) {
+		for (unsigned int i = 0; i < chunkSize; ++i) {
+			Eigen::Vector4d pt;
+			pt[0] = chunk[3 * i + 0] - centroid[0];
+			pt[1] = chunk[3 * i + 1] - centroid[1];
+			pt[2] = chunk[3 * i + 2] - centroid[2];
+			pt[3] = 1.0; //homogeneous point
+
+			covariance (1, 1) += pt.y () * pt.y (); //the non X parts
+			covariance (1, 2) += pt.y () * pt.z ();
+			covariance (2, 2) += pt.z () * pt.z ();
+
+			pt *= pt.x ();
+			covariance (0, 0) += pt.x (); //the X related parts
+			covariance (0, 1) += pt.y ();
+			covariance (0, 2) += pt.z ();
+		}
+		pointCount += chunkSize;
 	}
 
 	//copy upper triangle to lower triangle as it is symmetric
@@ -0,0 +1,310 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "ParallelNormalEstimation.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <assert.h>
+#include <boost/bind.hpp>
+
+namespace brics_3d {
+
+namespace {
+
+inline void crossProduct(const double* a, const double* b, double* result) {
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/*
+ * Eigenvector of a symmetric matrix a (a00 a01 a02 a11 a12 a22) for the eigenvalue lambda: the rows of (A - lambda*I)
+ * are orthogonal to it, so the largest cross product of two rows is used. Returns the squared length of that product.
+ */
+inline double computeEigenvector(const double* a, double lambda, double* eigenvector) {
+	double rows[3][3] = {
+			{a[0] - lambda, a[1], a[2]},
+			{a[1], a[3] - lambda, a[4]},
+			{a[2], a[4], a[5] - lambda}};
+	double products[3][3];
+	crossProduct(rows[0], rows[1], products[0]);
+	crossProduct(rows[0], rows[2], products[1]);
+	crossProduct(rows[1], rows[2], products[2]);
+
+	int best = 0;
+	double bestSquaredLength = -1.0;
+	for (int i = 0; i < 3; ++i) {
+		double squaredLength = products[i][0] * products[i][0] + products[i][1] * products[i][1] + products[i][2] * products[i][2];
+		if (squaredLength > bestSquaredLength) {
+			bestSquaredLength = squaredLength;
+			best = i;
+		}
+	}
+	std::copy(products[best], products[best] + 3, eigenvector);
+	return bestSquaredLength;
+}
+
+}
+
+const unsigned int ParallelNormalEstimation::minPointsPerThread = 1000;
+
+const unsigned int ParallelNormalEstimation::queryBlockSize = 1024;
+
+ParallelNormalEstimation::ParallelNormalEstimation() {
+	this->nnSearchMethod = 0;
+	this->kNeighbors = 10;
+	this->vpx = 0.0;
+	this->vpy = 0.0;
+	this->vpz = 0.0;
+	this->numberOfThreads = 1;
+}
+
+ParallelNormalEstimation::~ParallelNormalEstimation() {
+
+}
+
+void ParallelNormalEstimation::estimateNormals(PointCloud3D* pointCloud, NormalSet3D* estimatedNormals) {
+	assert(pointCloud != 0);
+	assert(estimatedNormals != 0);
+	assert(nnSearchMethod != 0);
+
+	unsigned int numberOfPoints = pointCloud->getSize();
+	std::vector<Normal3D>* normals = estimatedNormals->getNormals();
+	normals->resize(numberOfPoints);
+	if (numberOfPoints == 0) {
+		return;
+	}
+
+	/* the packed coordinates are cached by the point cloud; the decoration layers are not relevant here */
+	PointCloud3D::PackedCoordinatesConstPtr coordinates = pointCloud->getPackedCoordinates();
+	nnSearchMethod->setData(pointCloud);
+
+	unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfPoints, minPointsPerThread);
+	std::vector<int> neighborIndices;
+	const std::vector<int>* sharedNeighborIndices = 0;
+	if (threadCount <= 1 || !nnSearchMethod->supportsConcurrentQueries()) {
+		nnSearchMethod->findNearestNeighbors(pointCloud, &neighborIndices, 0, kNeighbors);
+		sharedNeighborIndices = &neighborIndices;
+	}
+
+	ParallelExecution::forEachRange(numberOfPoints, threadCount,
+			boost::bind(&ParallelNormalEstimation::estimateNormalRange, this, coordinates.get(), sharedNeighborIndices, _1, _2, normals));
+	LOG(DEBUG) << "ParallelNormalEstimation: " << numberOfPoints << " normals estimated by " << threadCount << " threads.";
+}
+
+void ParallelNormalEstimation::estimateNormalRange(const std::vector<double>* coordinates, const std::vector<int>* neighborIndices,
+		unsigned int begin, unsigned int end, std::vector<Normal3D>* normals) const {
+	PointCloud3D queryBlock;
+	std::vector<int> blockNeighborIndices;
+
+	for (unsigned int blockBegin = begin; blockBegin < end; blockBegin += queryBlockSize) {
+		unsigned int blockEnd = std::min(blockBegin + queryBlockSize, end);
+		const int* neighbors;
+		if (neighborIndices != 0) {
+			neighbors = &(*neighborIndices)[blockBegin * kNeighbors];
+		} else {
+			queryBlock.getPointCloud()->clear();
+			for (unsigned int i = blockBegin; i < blockEnd; ++i) {
+				queryBlock.addPoint(Point3D((*coordinates)[3 * i + 0], (*coordinates)[3 * i + 1], (*coordinates)[3 * i + 2]));
+			}
+			nnSearchMethod->findNearestNeighbors(&queryBlock, &blockNeighborIndices, 0, kNeighbors);
+			neighbors = &blockNeighborIndices[0];
+		}
+
+		for (unsigned int i = blockBegin; i < blockEnd; ++i) {
+			estimateNormal(&(*coordinates)[0], i, &neighbors[(i - blockBegin) * kNeighbors], (*normals)[i]);
+		}
+	}
+}
+
+void ParallelNormalEstimation::estimateNormal(const double* coordinates, unsigned int pointIndex, const int* neighbors, Normal3D& normal) const {
+	const double* point = &coordinates[3 * pointIndex];
+
+	/*
+	 * Single pass over the neighbors: sums of the coordinates and of their products. The coordinates are taken
+	 * relative to the query point, so the sums stay small and the covariance does not suffer from cancellation.
+	 */
+	double sum[3] = {0.0, 0.0, 0.0};
+	double products[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0}; // xx xy xz yy yz zz
+	unsigned int count = 0;
+	for (unsigned int j = 0; j < kNeighbors; ++j) {
+		if (neighbors[j] < 0) {
+			continue;
+		}
+		const double* neighbor = &coordinates[3 * neighbors[j]];
+		double dx = neighbor[0] - point[0];
+		double dy = neighbor[1] - point[1];
+		double dz = neighbor[2] - point[2];
+		if (dx != dx || dy != dy || dz != dz) { // NaN
+			continue;
+		}
+		sum[0] += dx;
+		sum[1] += dy;
+		sum[2] += dz;
+		products[0] += dx * dx;
+		products[1] += dx * dy;
+		products[2] += dx * dz;
+		products[3] += dy * dy;
+		products[4] += dy * dz;
+		products[5] += dz * dz;
+		++count;
+	}
+
+	double normalVector[3];
+	if (count < 3) {
+		normal = Normal3D(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+		return;
+	}
+
+	double mean[3] = {sum[0] / count, sum[1] / count, sum[2] / count};
+	double covariance[6] = {
+			products[0] / count - mean[0] * mean[0],
+			products[1] / count - mean[0] * mean[1],
+			products[2] / count - mean[0] * mean[2],
+			products[3] / count - mean[1] * mean[1],
+			products[4] / count - mean[1] * mean[2],
+			products[5] / count - mean[2] * mean[2]};
+
+	if (!computeSmallestEigenvector(covariance, normalVector)) {
+		normal = Normal3D(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+		return;
+	}
+
+	/* flip towards the viewpoint */
+	double cosTheta = (vpx - point[0]) * normalVector[0] + (vpy - point[1]) * normalVector[1] + (vpz - point[2]) * normalVector[2];
+	if (cosTheta < 0) {
+		normalVector[0] = -normalVector[0];
+		normalVector[1] = -normalVector[1];
+		normalVector[2] = -normalVector[2];
+	}
+	normal = Normal3D(normalVector[0], normalVector[1], normalVector[2]);
+}
+
+bool ParallelNormalEstimation::computeSmallestEigenvector(const double* covariance, double* normal) {
+	assert(covariance != 0);
+	assert(normal != 0);
+
+	/* scale to [-1, 1] to avoid over- and underflows */
+	double scale = 0.0;
+	for (int i = 0; i < 6; ++i) {
+		scale = std::max(scale, std::fabs(covariance[i]));
+	}
+	if (!(scale > 0.0) || scale == std::numeric_limits<double>::infinity()) { // zero, NaN or infinite
+		return false;
+	}
+	double a[6];
+	for (int i = 0; i < 6; ++i) {
+		a[i] = covariance[i] / scale;
+	}
+
+	/*
+	 * Trigonometric solution of the characteristic polynomial: with m = trace(A)/3, B = (A - m*I)/sqrt(p) and
+	 * p = |A - m*I|^2/6 the eigenvalues are m + 2*sqrt(p)*cos(phi + 2*pi*j/3), j = 0, 1, 2, where phi = acos(det(B)/2)/3.
+	 */
+	double m = (a[0] + a[3] + a[5]) / 3.0;
+	double b00 = a[0] - m;
+	double b11 = a[3] - m;
+	double b22 = a[5] - m;
+	double p = (b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * (a[1] * a[1] + a[2] * a[2] + a[4] * a[4])) / 6.0;
+	if (p <= 0.0) { // isotropic: every direction is an eigenvector
+		return false;
+	}
+	double sqrtP = std::sqrt(p);
+	double determinant = b00 * (b11 * b22 - a[4] * a[4]) - a[1] * (a[1] * b22 - a[4] * a[2]) + a[2] * (a[1] * a[4] - b11 * a[2]);
+	double r = determinant / (2.0 * p * sqrtP);
+	r = std::min(std::max(r, -1.0), 1.0);
+	double phi = std::acos(r) / 3.0;
+	const double twoPiThirds = 2.0943951023931954923; // 2*pi/3
+	double smallestEigenvalue = m + 2.0 * sqrtP * std::cos(phi + twoPiThirds);
+
+	double squaredLength = computeEigenvector(a, smallestEigenvalue, normal);
+	if (squaredLength <= std::numeric_limits<double>::epsilon()) {
+		/*
+		 * The smallest eigenvalue is a double root (e.g. points on a line), its eigenspace is a plane. Take
+		 * any vector that is orthogonal to the eigenvector of the largest eigenvalue.
+		 */
+		double largestEigenvalue = m + 2.0 * sqrtP * std::cos(phi);
+		double axis[3];
+		computeEigenvector(a, largestEigenvalue, axis);
+		int smallestComponent = 0;
+		for (int i = 1; i < 3; ++i) {
+			if (std::fabs(axis[i]) < std::fabs(axis[smallestComponent])) {
+				smallestComponent = i;
+			}
+		}
+		double unit[3] = {0.0, 0.0, 0.0};
+		unit[smallestComponent] = 1.0;
+		crossProduct(axis, unit, normal);
+		squaredLength = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+		if (!(squaredLength > 0.0)) {
+			return false;
+		}
+	}
+
+	double inverseLength = 1.0 / std::sqrt(squaredLength);
+	normal[0] *= inverseLength;
+	normal[1] *= inverseLength;
+	normal[2] *= inverseLength;
+	return true;
+}
+
+INearestPoint3DNeighbor* ParallelNormalEstimation::getSearchMethod() const {
+	return nnSearchMethod;
+}
+
+void ParallelNormalEstimation::setSearchMethod(INearestPoint3DNeighbor* nnSearchMethod) {
+	this->nnSearchMethod = nnSearchMethod;
+}
+
+unsigned int ParallelNormalEstimation::getkNeighbors() const {
+	return kNeighbors;
+}
+
+void ParallelNormalEstimation::setkNeighbors(unsigned int kNeighbors) {
+	this->kNeighbors = kNeighbors;
+}
+
+void ParallelNormalEstimation::setViewPoint(double vpx, double vpy, double vpz) {
+	this->vpx = vpx;
+	this->vpy = vpy;
+	this->vpz = vpz;
+}
+
+void ParallelNormalEstimation::getViewPoint(double& vpx, double& vpy, double& vpz) const {
+	vpx = this->vpx;
+	vpy = this->vpy;
+	vpz = this->vpz;
+}
+
+unsigned int ParallelNormalEstimation::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void ParallelNormalEstimation::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+}
+
+/* EOF */
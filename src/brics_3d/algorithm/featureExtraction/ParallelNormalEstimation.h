@@ -0,0 +1,184 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_PARALLELNORMALESTIMATION_H_
+#define BRICS_3D_PARALLELNORMALESTIMATION_H_
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+#include "brics_3d/algorithm/nearestNeighbor/INearestPoint3DNeighbor.h"
+#include "brics_3d/algorithm/featureExtraction/INormalEstimation.h"
+
+#include <vector>
+
+namespace brics_3d {
+
+/**
+ * @brief Multithreaded estimation of point normals from the k nearest neighbors.
+ * @ingroup featureExtraction
+ *
+ * Computes the same normals as NormalEstimation - the eigenvector of the neighborhood covariance matrix that
+ * belongs to the smallest eigenvalue, flipped towards the viewpoint - but is designed for large point clouds:
+ *  - The coordinates are packed once, the neighbor queries are issued as batches.
+ *  - Centroid and covariance are accumulated in a single pass over the neighbors (relative to the query point,
+ *    which avoids the cancellation of the naive one pass formula).
+ *  - The smallest eigenvalue and its eigenvector are computed in closed form instead of running a general iterative
+ *    eigen solver per point.
+ *  - The points are distributed among several worker threads (see setNumberOfThreads()). If the search method
+ *    supports concurrent queries, each thread queries the neighbors of its own points. Otherwise the neighbors
+ *    of all points are queried in one batch beforehand and only the normal computation is parallel.
+ *
+ * The normals are written to a NormalSet3D that is resized to the size of the point cloud, so
+ * the ith normal belongs to the ith point. Points with less than three valid neighbors get a NaN normal.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  NearestNeighborSTANN nearestNeighborSearch;
+ *  ParallelNormalEstimation normalEstimator;
+ *  normalEstimator.setSearchMethod(&nearestNeighborSearch);
+ *  normalEstimator.setNumberOfThreads(0); // use all available cores
+ *  normalEstimator.estimateNormals(pointCloud, normals);
+ *
+ * @endcode
+ */
+class ParallelNormalEstimation : public INormalEstimation {
+public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	ParallelNormalEstimation();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~ParallelNormalEstimation();
+
+	/**
+	 * @brief Estimates the normals of a point cloud.
+	 * @param[in] pointCloud The input point cloud. It is set as data of the search method.
+	 * @param[out] estimatedNormals The resulting normals. Previous content will be overwritten.
+	 */
+	void estimateNormals(PointCloud3D* pointCloud, NormalSet3D* estimatedNormals);
+
+	/**
+	 * @brief Get the nearest neighbor search method.
+	 * @return Pointer to the search method.
+	 */
+	INearestPoint3DNeighbor* getSearchMethod() const;
+
+	/**
+	 * @brief Set the nearest neighbor search method.
+	 * @param nnSearchMethod The search method. Ownership is not transferred.
+	 */
+	void setSearchMethod(INearestPoint3DNeighbor* nnSearchMethod);
+
+	/**
+	 * @brief Get the number of nearest neighbors that are used per point.
+	 * @return The number of neighbors.
+	 */
+	unsigned int getkNeighbors() const;
+
+	/**
+	 * @brief Set the number of nearest neighbors that are used per point (including the point itself). Default is 10.
+	 * @param kNeighbors The number of neighbors.
+	 */
+	void setkNeighbors(unsigned int kNeighbors);
+
+	/**
+	 * @brief Set the viewpoint. The normals are flipped towards it. Default is the origin.
+	 * @param vpx The X coordinate of the viewpoint.
+	 * @param vpy The Y coordinate of the viewpoint.
+	 * @param vpz The Z coordinate of the viewpoint.
+	 */
+	void setViewPoint(double vpx, double vpy, double vpz);
+
+	/**
+	 * @brief Get the viewpoint.
+	 * @param[out] vpx The X coordinate of the viewpoint.
+	 * @param[out] vpy The Y coordinate of the viewpoint.
+	 * @param[out] vpz The Z coordinate of the viewpoint.
+	 */
+	void getViewPoint(double& vpx, double& vpy, double& vpz) const;
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/**
+	 * @brief Computes the normalized eigenvector of the smallest eigenvalue of a symmetric 3x3 matrix in closed form.
+	 *
+	 * The eigenvalues are the roots of the characteristic polynomial, computed with the trigonometric solution.
+	 * The eigenvector is the largest cross product of two rows of (A - lambda*I).
+	 *
+	 * @param covariance The six distinct elements of the matrix: a00 a01 a02 a11 a12 a22
+	 * @param[out] normal The resulting eigenvector with unit length.
+	 * @return False if the matrix is zero, i.e. the eigenvector is undefined.
+	 */
+	static bool computeSmallestEigenvector(const double* covariance, double* normal);
+
+	/// Minimal number of points that are assigned to a worker thread. Smaller point clouds are processed by fewer threads.
+	static const unsigned int minPointsPerThread;
+
+	/// Number of points whose neighbors are queried with one batch query by a worker thread.
+	static const unsigned int queryBlockSize;
+
+private:
+
+	/**
+	 * @brief Estimate the normals of the points in the range [begin, end).
+	 * @param coordinates The packed coordinates of the point cloud (x0 y0 z0 x1 y1 z1 ...).
+	 * @param neighborIndices The neighbors of all points, as returned by the batch query. If null, the neighbors are
+	 * queried block wise within this function.
+	 */
+	void estimateNormalRange(const std::vector<double>* coordinates, const std::vector<int>* neighborIndices,
+			unsigned int begin, unsigned int end, std::vector<Normal3D>* normals) const;
+
+	/// Estimate the normal of one point from its k neighbor indices (-1 marks missing neighbors).
+	void estimateNormal(const double* coordinates, unsigned int pointIndex, const int* neighbors, Normal3D& normal) const;
+
+	/// Nearest neighbor search method.
+	INearestPoint3DNeighbor* nnSearchMethod;
+
+	/// Number of nearest neighbors.
+	unsigned int kNeighbors;
+
+	/// Viewpoint
+	double vpx, vpy, vpz;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
+};
+
+}
+
+#endif /* BRICS_3D_PARALLELNORMALESTIMATION_H_ */
+
+/* EOF */
@@ -41,11 +41,11 @@ BoxROIExtractor::~BoxROIExtractor() {
 void BoxROIExtractor::filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointCloud) {
 	if (boxOrigin == 0 || boxOrigin->isIdentity()) { //lazy evaluation...
 		for (unsigned int i = 0; i < originalPointCloud->getSize(); ++i) {
-			Point3D tmpPoint = (*originalPointCloud->getPointCloud())[i];
+			Point3D tmpPoint = (*originalPointCloud->getConstPointCloud())[i];
 			if (tmpPoint.getX() >= -sizeX/2 && tmpPoint.getX() <= sizeX/2 &&
 					tmpPoint.getY() >= -sizeY/2 && tmpPoint.getY() <= sizeY/2 &&
 					tmpPoint.getZ() >= -sizeZ/2 && tmpPoint.getZ() <= sizeZ/2) {
-				resultPointCloud->addPointPtr((*originalPointCloud->getPointCloud())[i].clone());
+				resultPointCloud->addPointPtr((*originalPointCloud->getConstPointCloud())[i].clone());
 			}
 		}
 	} else {
@@ -53,12 +53,12 @@ void BoxROIExtractor::filter(PointCloud3D* originalPointCloud, PointCloud3D* res
 		*inverseOrigin = *(boxOrigin.get());
 		inverseOrigin->inverse();
 		for (unsigned int i = 0; i < originalPointCloud->getSize(); ++i) {
-			Point3D tmpPoint = (*originalPointCloud->getPointCloud())[i];
+			Point3D tmpPoint = (*originalPointCloud->getConstPointCloud())[i];
 			tmpPoint.homogeneousTransformation(inverseOrigin); // move all points to the origin and then compare
 			if (tmpPoint.getX() >= -sizeX/2 && tmpPoint.getX() <= sizeX/2 &&
 					tmpPoint.getY() >= -sizeY/2 && tmpPoint.getY() <= sizeY/2 &&
 					tmpPoint.getZ() >= -sizeZ/2 && tmpPoint.getZ() <= sizeZ/2) {
-				resultPointCloud->addPointPtr((*originalPointCloud->getPointCloud())[i].clone());
+				resultPointCloud->addPointPtr((*originalPointCloud->getConstPointCloud())[i].clone());
 			}
 		}
 		delete inverseOrigin;
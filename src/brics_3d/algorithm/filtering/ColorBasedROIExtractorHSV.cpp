@@ -153,7 +153,7 @@ void ColorBasedROIExtractorHSV::filter(brics_3d::PointCloud3D* originalPointClou
 			//		printf("H-S Limits: [%f %f %f %f]\n", minH, maxH, minS, maxS);
 			//		printf("Actual H-S Values: [%d %d %d %f %f]\n", tempR, tempG, tempB, tempH, tempS);
 			if(passed){
-				resultPointCloud->addPointPtr((*originalPointCloud->getPointCloud())[i].clone());
+				resultPointCloud->addPointPtr((*originalPointCloud->getConstPointCloud())[i].clone());
 			}
 
 
@@ -171,7 +171,7 @@ void ColorBasedROIExtractorHSV::filter(brics_3d::PointCloud3D* originalPointClou
 			//		printf("H-S Limits: [%f %f %f %f]\n", minH, maxH, minS, maxS);
 			//		printf("Actual H-S Values: [%d %d %d %f %f]\n", tempR, tempG, tempB, tempH, tempS);
 			if(passed){
-				resultPointCloud->addPointPtr((*originalPointCloud->getPointCloud())[i].clone());
+				resultPointCloud->addPointPtr((*originalPointCloud->getConstPointCloud())[i].clone());
 			}
 		}
 	}
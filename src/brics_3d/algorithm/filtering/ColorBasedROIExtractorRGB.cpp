@@ -81,7 +81,7 @@ void ColorBasedROIExtractorRGB::filter(PointCloud3D *originalPointCloud, PointCl
 //					originalPointCloud->getPointCloud()->data()[i].blue);
 //
 //			out_cloud->addPoint(tempColoredPoint3D);
-			resultPointCloud->addPointPtr((*originalPointCloud->getPointCloud())[i].clone());
+			resultPointCloud->addPointPtr((*originalPointCloud->getConstPointCloud())[i].clone());
 //			delete tempPoint3D;
 //			delete tempColoredPoint3D;
 		}
@@ -0,0 +1,562 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "IncrementalOctree.h"
+#include "brics_3d/core/Logger.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <assert.h>
+
+using std::runtime_error;
+
+namespace brics_3d {
+
+/* Leaf indices are limited to +/- 2^40, so the root cell can grow without overflows. */
+static const double maxLeafIndex = 1099511627776.0;
+
+IncrementalOctree::Node::Node() {
+	for (unsigned int i = 0; i < 8; ++i) {
+		children[i] = 0;
+	}
+}
+
+IncrementalOctree::Node::~Node() {
+	for (unsigned int i = 0; i < 8; ++i) {
+		delete children[i];
+	}
+}
+
+bool IncrementalOctree::Node::isEmpty() const {
+	if (!points.empty()) {
+		return false;
+	}
+	for (unsigned int i = 0; i < 8; ++i) {
+		if (children[i] != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+IncrementalOctree::IncrementalOctree() {
+	this->voxelSize = 0;
+	this->root = 0;
+	this->rootCell.x = 0;
+	this->rootCell.y = 0;
+	this->rootCell.z = 0;
+	this->rootDepth = 0;
+	this->numberOfPoints = 0;
+	this->numberOfLeaves = 0;
+}
+
+IncrementalOctree::~IncrementalOctree() {
+	clear();
+}
+
+void IncrementalOctree::filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointCloud) {
+	assert(originalPointCloud != 0);
+	assert(resultPointCloud != 0);
+
+	insertPoints(originalPointCloud);
+	resultPointCloud->getPointCloud()->clear();
+	getVoxelCenters(resultPointCloud);
+}
+
+void IncrementalOctree::partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointCloud3D*>* pointCloudCells) {
+	assert(pointCloud != 0);
+	assert(pointCloudCells != 0);
+
+	insertPoints(pointCloud);
+	getPartition(pointCloudCells);
+}
+
+void IncrementalOctree::setVoxelSize(double voxelSize) {
+	if (voxelSize < 0.0) {
+		throw runtime_error("ERROR: voxelSize for IncrementalOctree cannot be less than 0.");
+	}
+	if (voxelSize == this->voxelSize) {
+		return;
+	}
+
+	/* the leaves change, so the existing points have to be sorted into a new tree */
+	PointCloud3D storedPoints;
+	if (root != 0) {
+		std::vector<PointCloud3D*> cells;
+		getPartition(&cells);
+		for (unsigned int i = 0; i < cells.size(); ++i) {
+			PointCloud3D* cell = cells[i];
+			for (unsigned int j = 0; j < cell->getSize(); ++j) {
+				storedPoints.addPoint((*cell->getConstPointCloud())[j]);
+			}
+			delete cell;
+		}
+		LOG(DEBUG) << "IncrementalOctree: reinserting " << storedPoints.getSize() << " points due to new voxel size.";
+	}
+
+	clear();
+	this->voxelSize = voxelSize;
+	insertPoints(&storedPoints);
+}
+
+double IncrementalOctree::getVoxelSize() {
+	return this->voxelSize;
+}
+
+void IncrementalOctree::insertPoints(PointCloud3D* pointCloud) {
+	assert(pointCloud != 0);
+
+	if (pointCloud->getSize() == 0) {
+		return;
+	}
+
+	PointCloud3D::PackedCoordinatesConstPtr packedPoints = pointCloud->getPackedCoordinates();
+	unsigned int skippedPoints = 0;
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		const double* point = &(*packedPoints)[3 * i];
+		Node* leaf = 0;
+
+		if (voxelSize <= 0) { // a single cell for all points
+			if (root == 0) {
+				root = new Node();
+			}
+			leaf = root;
+		} else {
+			CellIndex leafCell;
+			if (!computeLeafIndex(point[0], point[1], point[2], &leafCell)) {
+				skippedPoints++;
+				continue;
+			}
+			growRoot(leafCell);
+
+			/* descend to the leaf and create missing cells on the way */
+			leaf = root;
+			CellIndex cell = rootCell;
+			for (unsigned int depth = rootDepth; depth > 0; --depth) {
+				unsigned int octant = getOctant(cell, depth, leafCell, &cell);
+				if (leaf->children[octant] == 0) {
+					leaf->children[octant] = new Node();
+				}
+				leaf = leaf->children[octant];
+			}
+		}
+
+		if (leaf->points.empty()) {
+			numberOfLeaves++;
+		}
+		leaf->points.push_back(point[0]);
+		leaf->points.push_back(point[1]);
+		leaf->points.push_back(point[2]);
+		numberOfPoints++;
+	}
+
+	if (skippedPoints > 0) {
+		LOG(WARNING) << "IncrementalOctree: " << skippedPoints << " invalid points or points out of the voxel grid range have been skipped.";
+	}
+}
+
+void IncrementalOctree::insertPoint(const Point3D& point) {
+	PointCloud3D pointCloud;
+	pointCloud.addPoint(point);
+	insertPoints(&pointCloud);
+}
+
+unsigned int IncrementalOctree::removePoints(PointCloud3D* pointCloud) {
+	assert(pointCloud != 0);
+
+	unsigned int removedPoints = 0;
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		if (removePoint((*pointCloud->getConstPointCloud())[i])) {
+			removedPoints++;
+		}
+	}
+	return removedPoints;
+}
+
+bool IncrementalOctree::removePoint(const Point3D& point) {
+	if (root == 0) {
+		return false;
+	}
+
+	CellIndex leafCell;
+	if (voxelSize <= 0) {
+		leafCell = rootCell;
+	} else if (!computeLeafIndex(point.getX(), point.getY(), point.getZ(), &leafCell)) {
+		return false;
+	}
+
+	/* points outside of the root cell cannot be part of the map */
+	boost::int64_t rootSize = static_cast<boost::int64_t>(1) << rootDepth;
+	if (leafCell.x < rootCell.x || leafCell.x >= rootCell.x + rootSize ||
+			leafCell.y < rootCell.y || leafCell.y >= rootCell.y + rootSize ||
+			leafCell.z < rootCell.z || leafCell.z >= rootCell.z + rootSize) {
+		return false;
+	}
+
+	bool removed = removePoint(root, rootCell, rootDepth, leafCell, point.getX(), point.getY(), point.getZ());
+	if (root->isEmpty()) {
+		clear();
+	}
+	return removed;
+}
+
+unsigned int IncrementalOctree::removePointsInBox(const Point3D& minCorner, const Point3D& maxCorner) {
+	if (root == 0) {
+		return 0;
+	}
+
+	Coordinate minCoordinates[3] = {minCorner.getX(), minCorner.getY(), minCorner.getZ()};
+	Coordinate maxCoordinates[3] = {maxCorner.getX(), maxCorner.getY(), maxCorner.getZ()};
+	unsigned int removedPoints = removePointsInBox(root, rootCell, rootDepth, minCoordinates, maxCoordinates);
+	if (root->isEmpty()) {
+		clear();
+	}
+	return removedPoints;
+}
+
+void IncrementalOctree::clear() {
+	delete root;
+	root = 0;
+	rootCell.x = 0;
+	rootCell.y = 0;
+	rootCell.z = 0;
+	rootDepth = 0;
+	numberOfPoints = 0;
+	numberOfLeaves = 0;
+}
+
+void IncrementalOctree::getVoxelCenters(PointCloud3D* voxelCenters, std::vector<unsigned int>* pointCounts) {
+	assert(voxelCenters != 0);
+
+	if (root == 0) {
+		return;
+	}
+
+	if (voxelSize <= 0) { // no reduction
+		for (unsigned int i = 0; i < root->points.size(); i += 3) {
+			voxelCenters->addPoint(Point3D(root->points[i], root->points[i + 1], root->points[i + 2]));
+			if (pointCounts != 0) {
+				pointCounts->push_back(1);
+			}
+		}
+		return;
+	}
+
+	voxelCenters->getPointCloud()->reserve(voxelCenters->getSize() + numberOfLeaves);
+	getVoxelCenters(root, rootCell, rootDepth, voxelCenters, pointCounts);
+}
+
+void IncrementalOctree::getPartition(std::vector<PointCloud3D*>* pointCloudCells) {
+	assert(pointCloudCells != 0);
+
+	pointCloudCells->clear();
+	if (root == 0) {
+		return;
+	}
+	getPartition(root, pointCloudCells);
+}
+
+void IncrementalOctree::getPointsInBox(const Point3D& minCorner, const Point3D& maxCorner, PointCloud3D* resultPointCloud) {
+	assert(resultPointCloud != 0);
+
+	if (root == 0) {
+		return;
+	}
+
+	Coordinate minCoordinates[3] = {minCorner.getX(), minCorner.getY(), minCorner.getZ()};
+	Coordinate maxCoordinates[3] = {maxCorner.getX(), maxCorner.getY(), maxCorner.getZ()};
+	getPointsInBox(root, rootCell, rootDepth, minCoordinates, maxCoordinates, resultPointCloud);
+}
+
+unsigned int IncrementalOctree::getSize() const {
+	return numberOfPoints;
+}
+
+unsigned int IncrementalOctree::getNumberOfLeaves() const {
+	return numberOfLeaves;
+}
+
+bool IncrementalOctree::computeLeafIndex(Coordinate x, Coordinate y, Coordinate z, CellIndex* index) const {
+	assert(index != 0);
+	assert(voxelSize > 0);
+
+	double scaledX = std::floor(x / voxelSize);
+	double scaledY = std::floor(y / voxelSize);
+	double scaledZ = std::floor(z / voxelSize);
+	if (!(std::abs(scaledX) < maxLeafIndex && std::abs(scaledY) < maxLeafIndex && std::abs(scaledZ) < maxLeafIndex)) { // also catches NaN
+		return false;
+	}
+
+	index->x = static_cast<boost::int64_t>(scaledX);
+	index->y = static_cast<boost::int64_t>(scaledY);
+	index->z = static_cast<boost::int64_t>(scaledZ);
+	return true;
+}
+
+void IncrementalOctree::growRoot(const CellIndex& leaf) {
+	if (root == 0) { // the first leaf is the root
+		root = new Node();
+		rootCell = leaf;
+		rootDepth = 0;
+		return;
+	}
+
+	boost::int64_t rootSize = static_cast<boost::int64_t>(1) << rootDepth;
+	while (leaf.x < rootCell.x || leaf.x >= rootCell.x + rootSize ||
+			leaf.y < rootCell.y || leaf.y >= rootCell.y + rootSize ||
+			leaf.z < rootCell.z || leaf.z >= rootCell.z + rootSize) {
+
+		/* double the root cell towards the leaf; the old root becomes one of its children */
+		unsigned int octant = 0;
+		if (leaf.x < rootCell.x) {
+			rootCell.x -= rootSize;
+			octant |= 1;
+		}
+		if (leaf.y < rootCell.y) {
+			rootCell.y -= rootSize;
+			octant |= 2;
+		}
+		if (leaf.z < rootCell.z) {
+			rootCell.z -= rootSize;
+			octant |= 4;
+		}
+
+		Node* newRoot = new Node();
+		newRoot->children[octant] = root;
+		root = newRoot;
+		rootDepth++;
+		rootSize <<= 1;
+	}
+}
+
+bool IncrementalOctree::removePoint(Node* node, CellIndex cell, unsigned int depth, const CellIndex& leaf, Coordinate x, Coordinate y, Coordinate z) {
+	assert(node != 0);
+
+	if (depth == 0) {
+		std::vector<Coordinate>& points = node->points;
+		for (unsigned int i = 0; i < points.size(); i += 3) {
+			if (points[i] == x && points[i + 1] == y && points[i + 2] == z) {
+				/* order within a leaf does not matter: move the last point into the gap */
+				points[i] = points[points.size() - 3];
+				points[i + 1] = points[points.size() - 2];
+				points[i + 2] = points[points.size() - 1];
+				points.resize(points.size() - 3);
+				numberOfPoints--;
+				if (points.empty()) {
+					numberOfLeaves--;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	unsigned int octant = getOctant(cell, depth, leaf, &cell);
+	Node* child = node->children[octant];
+	if (child == 0) {
+		return false;
+	}
+	bool removed = removePoint(child, cell, depth - 1, leaf, x, y, z);
+	if (child->isEmpty()) {
+		delete child;
+		node->children[octant] = 0;
+	}
+	return removed;
+}
+
+unsigned int IncrementalOctree::removePointsInBox(Node* node, CellIndex cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner) {
+	assert(node != 0);
+
+	int overlap = (voxelSize <= 0) ? 1 : classifyCell(cell, depth, minCorner, maxCorner);
+	if (overlap == 0) {
+		return 0;
+	}
+
+	unsigned int removedPoints = 0;
+	if (depth == 0) {
+		std::vector<Coordinate>& points = node->points;
+		if (points.empty()) {
+			return 0;
+		}
+		unsigned int remainingSize = 0;
+		for (unsigned int i = 0; i < points.size(); i += 3) {
+			if (overlap == 2 || isInBox(&points[i], minCorner, maxCorner)) {
+				removedPoints++;
+			} else { // compact the remaining points
+				points[remainingSize] = points[i];
+				points[remainingSize + 1] = points[i + 1];
+				points[remainingSize + 2] = points[i + 2];
+				remainingSize += 3;
+			}
+		}
+		points.resize(remainingSize);
+		numberOfPoints -= removedPoints;
+		if (points.empty()) {
+			numberOfLeaves--;
+		}
+		return removedPoints;
+	}
+
+	boost::int64_t halfSize = static_cast<boost::int64_t>(1) << (depth - 1);
+	for (unsigned int octant = 0; octant < 8; ++octant) {
+		Node* child = node->children[octant];
+		if (child == 0) {
+			continue;
+		}
+		CellIndex childCell = cell;
+		childCell.x += (octant & 1) ? halfSize : 0;
+		childCell.y += (octant & 2) ? halfSize : 0;
+		childCell.z += (octant & 4) ? halfSize : 0;
+		removedPoints += removePointsInBox(child, childCell, depth - 1, minCorner, maxCorner);
+		if (child->isEmpty()) {
+			delete child;
+			node->children[octant] = 0;
+		}
+	}
+	return removedPoints;
+}
+
+void IncrementalOctree::getVoxelCenters(Node* node, CellIndex cell, unsigned int depth, PointCloud3D* voxelCenters, std::vector<unsigned int>* pointCounts) {
+	assert(node != 0);
+
+	if (depth == 0) {
+		if (node->points.empty()) {
+			return;
+		}
+		voxelCenters->addPoint(Point3D((cell.x + 0.5) * voxelSize, (cell.y + 0.5) * voxelSize, (cell.z + 0.5) * voxelSize));
+		if (pointCounts != 0) {
+			pointCounts->push_back(static_cast<unsigned int>(node->points.size() / 3));
+		}
+		return;
+	}
+
+	boost::int64_t halfSize = static_cast<boost::int64_t>(1) << (depth - 1);
+	for (unsigned int octant = 0; octant < 8; ++octant) {
+		if (node->children[octant] == 0) {
+			continue;
+		}
+		CellIndex childCell = cell;
+		childCell.x += (octant & 1) ? halfSize : 0;
+		childCell.y += (octant & 2) ? halfSize : 0;
+		childCell.z += (octant & 4) ? halfSize : 0;
+		getVoxelCenters(node->children[octant], childCell, depth - 1, voxelCenters, pointCounts);
+	}
+}
+
+void IncrementalOctree::getPartition(Node* node, std::vector<PointCloud3D*>* pointCloudCells) {
+	assert(node != 0);
+
+	if (!node->points.empty()) {
+		PointCloud3D* cellPointCloud = new PointCloud3D();
+		cellPointCloud->getPointCloud()->reserve(node->points.size() / 3);
+		for (unsigned int i = 0; i < node->points.size(); i += 3) {
+			cellPointCloud->addPoint(Point3D(node->points[i], node->points[i + 1], node->points[i + 2]));
+		}
+		pointCloudCells->push_back(cellPointCloud);
+	}
+
+	for (unsigned int octant = 0; octant < 8; ++octant) {
+		if (node->children[octant] != 0) {
+			getPartition(node->children[octant], pointCloudCells);
+		}
+	}
+}
+
+void IncrementalOctree::getPointsInBox(Node* node, CellIndex cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner, PointCloud3D* resultPointCloud) {
+	assert(node != 0);
+
+	int overlap = (voxelSize <= 0) ? 1 : classifyCell(cell, depth, minCorner, maxCorner);
+	if (overlap == 0) {
+		return;
+	}
+
+	if (depth == 0) {
+		const std::vector<Coordinate>& points = node->points;
+		for (unsigned int i = 0; i < points.size(); i += 3) {
+			if (overlap == 2 || isInBox(&points[i], minCorner, maxCorner)) {
+				resultPointCloud->addPoint(Point3D(points[i], points[i + 1], points[i + 2]));
+			}
+		}
+		return;
+	}
+
+	boost::int64_t halfSize = static_cast<boost::int64_t>(1) << (depth - 1);
+	for (unsigned int octant = 0; octant < 8; ++octant) {
+		if (node->children[octant] == 0) {
+			continue;
+		}
+		CellIndex childCell = cell;
+		childCell.x += (octant & 1) ? halfSize : 0;
+		childCell.y += (octant & 2) ? halfSize : 0;
+		childCell.z += (octant & 4) ? halfSize : 0;
+		getPointsInBox(node->children[octant], childCell, depth - 1, minCorner, maxCorner, resultPointCloud);
+	}
+}
+
+int IncrementalOctree::classifyCell(const CellIndex& cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner) const {
+	double cellSize = static_cast<double>(static_cast<boost::int64_t>(1) << depth) * voxelSize;
+	double cellMin[3] = {cell.x * voxelSize, cell.y * voxelSize, cell.z * voxelSize};
+	double margin = 1e-6 * voxelSize; // the leaf index of a point close to a cell border is subject to rounding
+
+	bool inside = true;
+	for (unsigned int i = 0; i < 3; ++i) {
+		cellMin[i] -= margin;
+		double cellMax = cellMin[i] + cellSize + 2 * margin;
+		if (cellMax < minCorner[i] || cellMin[i] > maxCorner[i]) {
+			return 0;
+		}
+		if (cellMin[i] < minCorner[i] || cellMax > maxCorner[i]) {
+			inside = false;
+		}
+	}
+	return inside ? 2 : 1;
+}
+
+bool IncrementalOctree::isInBox(const Coordinate* point, const Coordinate* minCorner, const Coordinate* maxCorner) {
+	return (point[0] >= minCorner[0] && point[0] <= maxCorner[0] &&
+			point[1] >= minCorner[1] && point[1] <= maxCorner[1] &&
+			point[2] >= minCorner[2] && point[2] <= maxCorner[2]);
+}
+
+unsigned int IncrementalOctree::getOctant(const CellIndex& cell, unsigned int depth, const CellIndex& leaf, CellIndex* childCell) {
+	assert(depth > 0);
+	assert(childCell != 0);
+
+	boost::int64_t halfSize = static_cast<boost::int64_t>(1) << (depth - 1);
+	CellIndex origin = cell; // cell and childCell may be identical
+	unsigned int octant = 0;
+	*childCell = origin;
+	if (leaf.x >= origin.x + halfSize) {
+		octant |= 1;
+		childCell->x += halfSize;
+	}
+	if (leaf.y >= origin.y + halfSize) {
+		octant |= 2;
+		childCell->y += halfSize;
+	}
+	if (leaf.z >= origin.z + halfSize) {
+		octant |= 4;
+		childCell->z += halfSize;
+	}
+	return octant;
+}
+
+}
+
+/* EOF */
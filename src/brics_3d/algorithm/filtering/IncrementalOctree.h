@@ -0,0 +1,247 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_INCREMENTALOCTREE_H_
+#define BRICS_3D_INCREMENTALOCTREE_H_
+
+#include "brics_3d/algorithm/filtering/IOctreeReductionFilter.h"
+#include "brics_3d/algorithm/filtering/IOctreePartition.h"
+#include "brics_3d/algorithm/filtering/IOctreeSetup.h"
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace brics_3d {
+
+/**
+ * @brief Octree that is updated incrementally with batches of points.
+ * @ingroup filtering
+ *
+ * In contrast to the Octree, which builds a new tree for every call, this octree persists between calls and
+ * acts as a map: new batches of points (e.g. consecutive scans) are inserted into the existing tree, and points
+ * can be removed again. Queries for the voxel centers, the partition or the points within a box are answered from
+ * the current tree without a rebuild.
+ *
+ * The leaf cells are cubes with an edge length of voxelSize that are aligned to the origin of the coordinate frame.
+ * Every leaf stores its points, thus the point count (occupancy) of a leaf is available. The root cell grows
+ * on demand, when points outside the current bounds are inserted.
+ *
+ * The map is updated with insertPoints(), removePoints() and clear(); getVoxelCenters() and getPartition() return its
+ * current state. The generic interfaces work on the map as well: filter() and partitionPointCloud() insert the given
+ * points and then return the voxel centers respectively the partition of the whole map. Thus a consumer of
+ * IOctreeReductionFilter can feed consecutive scans and always receives the reduced map. Call clear() before to
+ * reduce a single point cloud only.
+ *
+ * The tree owns its nodes, hence an IncrementalOctree cannot be copied.
+ *
+ * With a voxelSize of 0 (default), all points are stored in a single cell and no reduction is applied.
+ */
+class IncrementalOctree : public IOctreeReductionFilter, public IOctreePartition, public IOctreeSetup {
+public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	IncrementalOctree();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~IncrementalOctree();
+
+	/**
+	 * @brief Insert the points into the map and return the centers of all occupied leaves of the map.
+	 * @param[in] originalPointCloud The points to be inserted. This data will not be modified.
+	 * @param[out] resultPointCloud The voxel centers of the map. Existing content is replaced.
+	 */
+	void filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointCloud);
+
+	/**
+	 * @brief Insert the points into the map and return the partition of the map.
+	 * @param[in] pointCloud The points to be inserted. This data will not be modified.
+	 * @param[out] pointCloudCells One point cloud per occupied leaf of the map, allocated with new.
+	 */
+	void partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointCloud3D*>* pointCloudCells);
+
+	/**
+	 * @brief Set the edge length of the leaf cells.
+	 *
+	 * If the map already contains points, they are inserted again into a tree with the new voxel size.
+	 */
+	void setVoxelSize(double voxelSize);
+
+	double getVoxelSize();
+
+	/**
+	 * @brief Insert a batch of points into the map.
+	 * @param[in] pointCloud The points to be inserted. This data will not be modified.
+	 */
+	void insertPoints(PointCloud3D* pointCloud);
+
+	/**
+	 * @brief Insert a single point into the map.
+	 */
+	void insertPoint(const Point3D& point);
+
+	/**
+	 * @brief Remove a batch of points from the map.
+	 *
+	 * A point of the map is removed if its coordinates are identical with one of the given points.
+	 * For each given point at most one point of the map is removed.
+	 *
+	 * @param[in] pointCloud The points to be removed. This data will not be modified.
+	 * @return Number of removed points.
+	 */
+	unsigned int removePoints(PointCloud3D* pointCloud);
+
+	/**
+	 * @brief Remove a single point from the map.
+	 * @return True if a point with identical coordinates has been removed.
+	 */
+	bool removePoint(const Point3D& point);
+
+	/**
+	 * @brief Remove all points within an axis aligned box from the map.
+	 * @param minCorner Corner of the box with the minimal coordinates.
+	 * @param maxCorner Corner of the box with the maximal coordinates.
+	 * @return Number of removed points.
+	 */
+	unsigned int removePointsInBox(const Point3D& minCorner, const Point3D& maxCorner);
+
+	/**
+	 * @brief Delete all points of the map.
+	 */
+	void clear();
+
+	/**
+	 * @brief Get the centers of all occupied leaf cells.
+	 * @param[out] voxelCenters Point cloud where the centers will be appended to.
+	 * @param[out] pointCounts Optional. The number of points of each leaf will be appended in the same order as the centers.
+	 */
+	void getVoxelCenters(PointCloud3D* voxelCenters, std::vector<unsigned int>* pointCounts = 0);
+
+	/**
+	 * @brief Get the points of all occupied leaf cells.
+	 * @param[out] pointCloudCells Resulting vector of point clouds. Each point cloud represents one leaf.
+	 * The point clouds are allocated with new; the caller takes the ownership.
+	 */
+	void getPartition(std::vector<PointCloud3D*>* pointCloudCells);
+
+	/**
+	 * @brief Get all points within an axis aligned box.
+	 * @param minCorner Corner of the box with the minimal coordinates.
+	 * @param maxCorner Corner of the box with the maximal coordinates.
+	 * @param[out] resultPointCloud Point cloud where the points will be appended to.
+	 */
+	void getPointsInBox(const Point3D& minCorner, const Point3D& maxCorner, PointCloud3D* resultPointCloud);
+
+	/**
+	 * @brief Get the number of points in the map.
+	 */
+	unsigned int getSize() const;
+
+	/**
+	 * @brief Get the number of occupied leaf cells.
+	 */
+	unsigned int getNumberOfLeaves() const;
+
+private:
+
+	/// Not copyable: the nodes are owned by the tree.
+	IncrementalOctree(const IncrementalOctree&);
+
+	/// @see IncrementalOctree(const IncrementalOctree&)
+	IncrementalOctree& operator=(const IncrementalOctree&);
+
+	/// A cell of the octree. Only leaves (depth 0) have points.
+	struct Node {
+		Node();
+		~Node();
+
+		bool isEmpty() const;
+
+		/// Children indexed by octant: bit 0 for x, bit 1 for y, bit 2 for z.
+		Node* children[8];
+
+		/// Packed x,y,z coordinates of the points in a leaf.
+		std::vector<Coordinate> points;
+	};
+
+	/// Integer coordinates of a cell, in multiples of voxelSize.
+	struct CellIndex {
+		boost::int64_t x;
+		boost::int64_t y;
+		boost::int64_t z;
+	};
+
+	/**
+	 * @brief Compute the leaf index of a point.
+	 * @return False if the point is invalid or exceeds the range of the voxel grid.
+	 */
+	bool computeLeafIndex(Coordinate x, Coordinate y, Coordinate z, CellIndex* index) const;
+
+	/// Grow the root cell until it contains the leaf.
+	void growRoot(const CellIndex& leaf);
+
+	/// Remove the first point with identical coordinates in the subtree. Empty children are pruned.
+	bool removePoint(Node* node, CellIndex cell, unsigned int depth, const CellIndex& leaf, Coordinate x, Coordinate y, Coordinate z);
+
+	/// Remove all points within the box in the subtree. Empty children are pruned.
+	unsigned int removePointsInBox(Node* node, CellIndex cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner);
+
+	void getVoxelCenters(Node* node, CellIndex cell, unsigned int depth, PointCloud3D* voxelCenters, std::vector<unsigned int>* pointCounts);
+
+	void getPartition(Node* node, std::vector<PointCloud3D*>* pointCloudCells);
+
+	void getPointsInBox(Node* node, CellIndex cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner, PointCloud3D* resultPointCloud);
+
+	/// Check how a cell overlaps with a box: 0 = disjoint, 1 = intersecting, 2 = completely inside.
+	int classifyCell(const CellIndex& cell, unsigned int depth, const Coordinate* minCorner, const Coordinate* maxCorner) const;
+
+	/// Check if a point is within a box.
+	static bool isInBox(const Coordinate* point, const Coordinate* minCorner, const Coordinate* maxCorner);
+
+	/// Index of the child cell that contains a leaf.
+	static unsigned int getOctant(const CellIndex& cell, unsigned int depth, const CellIndex& leaf, CellIndex* childCell);
+
+	/// The edge length of a leaf cell
+	double voxelSize;
+
+	/// The root cell. Null if the map is empty.
+	Node* root;
+
+	/// Index of the corner of the root cell with the minimal coordinates
+	CellIndex rootCell;
+
+	/// Depth of the root cell. Leaves have depth 0.
+	unsigned int rootDepth;
+
+	/// Total number of points
+	unsigned int numberOfPoints;
+
+	/// Number of occupied leaves
+	unsigned int numberOfLeaves;
+
+};
+
+}
+
+#endif /* BRICS_3D_INCREMENTALOCTREE_H_ */
+
+/* EOF */
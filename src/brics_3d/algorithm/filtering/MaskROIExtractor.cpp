@@ -50,7 +50,7 @@ void MaskROIExtractor::extractIndexedPointCloud(brics_3d::PointCloud3D* inputPoi
 	(*outputPointCloud->getPointCloud()).resize(inliers.size());
 	//copy over inliers
 	for (int i = 0; i < static_cast<int>(inliers.size()); ++i) {
-		(*outputPointCloud->getPointCloud())[i] = (*inputPoinCloud->getPointCloud())[inliers[i]];
+		(*outputPointCloud->getPointCloud())[i] = (*inputPoinCloud->getConstPointCloud())[inliers[i]];
 	}
 }
 
@@ -46,22 +46,20 @@ void Octree::filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointC
 
 	if (voxelSize <=0) {
 		for (int i = 0; i < static_cast<int>(originalPointCloud->getSize()); ++i) { //just copy data
-			resultPointCloud->addPoint((*originalPointCloud->getPointCloud())[i]);
+			resultPointCloud->addPoint((*originalPointCloud->getConstPointCloud())[i]);
 		}
 		return;
 	}
 
-	/* prepare data */
-	double** tmpPointCloudPoints = new double*[originalPointCloud->getSize()];
+	/* prepare data: the octree refers to the points, so we let it point into the packed coordinates */
+	PointCloud3D::PackedCoordinatesConstPtr packedPoints = originalPointCloud->getPackedCoordinates();
+	std::vector<double*> tmpPointCloudPoints(originalPointCloud->getSize());
 	for (unsigned int i = 0; i < originalPointCloud->getSize(); i++) {
-		tmpPointCloudPoints[i] = new double[3];
-		tmpPointCloudPoints[i][0] = (*originalPointCloud->getPointCloud())[i].getX();
-		tmpPointCloudPoints[i][1] = (*originalPointCloud->getPointCloud())[i].getY();
-		tmpPointCloudPoints[i][2] = (*originalPointCloud->getPointCloud())[i].getZ();
+		tmpPointCloudPoints[i] = const_cast<double*>(&(*packedPoints)[3 * i]); // OctTree does not modify the data
 	}
 
 	/* create octree */
-	OctTree *octree = new OctTree(tmpPointCloudPoints, originalPointCloud->getSize(), this->voxelSize);
+	OctTree *octree = new OctTree(&tmpPointCloudPoints[0], originalPointCloud->getSize(), this->voxelSize);
 
 	/* process results */
 	resultPointCloud->getPointCloud()->clear();
@@ -83,10 +81,6 @@ void Octree::filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointC
 
 	/* clean up */
 	delete octree;
-	for (int i = 0; i < static_cast<int>(originalPointCloud->getSize()); ++i) {
-		delete [] tmpPointCloudPoints[i];
-	}
-	delete [] tmpPointCloudPoints;
 }
 
 void Octree::partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointCloud3D*>* pointCloudCells) {
@@ -99,7 +93,7 @@ void Octree::partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointClou
 	if (voxelSize <=0) {
 		PointCloud3D* tmpPointCloud = new PointCloud3D();
 		for (int i = 0; i < static_cast<int>(pointCloud->getSize()); ++i) { //just copy data
-			tmpPointCloud->addPoint((*pointCloud->getPointCloud())[i]);
+			tmpPointCloud->addPoint((*pointCloud->getConstPointCloud())[i]);
 			totalPointsCount++;
 		}
 		pointCloudCells->push_back(tmpPointCloud);
@@ -107,17 +101,15 @@ void Octree::partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointClou
 		return;
 	}
 
-	/* prepare data */
-	double** tmpPointCloudPoints = new double*[pointCloud->getSize()];
+	/* prepare data: the octree refers to the points, so we let it point into the packed coordinates */
+	PointCloud3D::PackedCoordinatesConstPtr packedPoints = pointCloud->getPackedCoordinates();
+	std::vector<double*> tmpPointCloudPoints(pointCloud->getSize());
 	for (unsigned int i = 0; i < pointCloud->getSize(); i++) {
-		tmpPointCloudPoints[i] = new double[3];
-		tmpPointCloudPoints[i][0] = (*pointCloud->getPointCloud())[i].getX();
-		tmpPointCloudPoints[i][1] = (*pointCloud->getPointCloud())[i].getY();
-		tmpPointCloudPoints[i][2] = (*pointCloud->getPointCloud())[i].getZ();
+		tmpPointCloudPoints[i] = const_cast<double*>(&(*packedPoints)[3 * i]); // OctTree does not modify the data
 	}
 
 	/* create octree */
-	OctTree *octree = new OctTree(tmpPointCloudPoints, pointCloud->getSize(), this->voxelSize);
+	OctTree *octree = new OctTree(&tmpPointCloudPoints[0], pointCloud->getSize(), this->voxelSize);
 
 	/* process results */
 	vector<vector<double*> > partition;
@@ -144,10 +136,6 @@ void Octree::partitionPointCloud(PointCloud3D* pointCloud, std::vector<PointClou
 
 	/* clean up */
 	delete octree;
-	for (int i = 0; i < static_cast<int>(pointCloud->getSize()); ++i) {
-		delete [] tmpPointCloudPoints[i];
-	}
-	delete [] tmpPointCloudPoints;
 }
 
 void Octree::setVoxelSize(double voxelSize) {
@@ -0,0 +1,213 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "VoxelGridFilter.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
+#include "VoxelKey.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <assert.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+using std::runtime_error;
+
+namespace brics_3d {
+
+const unsigned int VoxelGridFilter::minPointsPerThread = 10000;
+
+VoxelGridFilter::VoxelGridFilter() {
+	this->voxelSize = 0;
+	this->reductionMode = centroid;
+	this->numberOfThreads = 1;
+}
+
+VoxelGridFilter::~VoxelGridFilter() {
+
+}
+
+void VoxelGridFilter::filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointCloud) {
+	assert(originalPointCloud != 0);
+	assert(resultPointCloud != 0);
+
+	resultPointCloud->getPointCloud()->clear();
+
+	if(originalPointCloud->getSize() == 0) {
+		return; //Nothing to do here..
+	}
+
+	if (voxelSize <= 0) {
+		for (int i = 0; i < static_cast<int>(originalPointCloud->getSize()); ++i) { //just copy data
+			resultPointCloud->addPoint((*originalPointCloud->getConstPointCloud())[i]);
+		}
+		return;
+	}
+
+	PointCloud3D::PackedCoordinatesConstPtr packedPoints = originalPointCloud->getPackedCoordinates();
+	unsigned int numberOfPoints = originalPointCloud->getSize();
+	unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfPoints, minPointsPerThread);
+
+	std::vector<Voxel> voxels;
+	if (threadCount <= 1) {
+		accumulateVoxels(packedPoints.get(), 0, numberOfPoints, &voxels);
+	} else {
+
+		/* each thread works on a contiguous range with its own voxel table */
+		std::vector< std::vector<Voxel> > threadVoxels(threadCount);
+		boost::thread_group workers;
+		for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+			unsigned int begin = 0;
+			unsigned int end = 0;
+			ParallelExecution::getRange(numberOfPoints, threadCount, threadNum, begin, end);
+			workers.create_thread(boost::bind(&VoxelGridFilter::accumulateVoxels, this,
+					packedPoints.get(), begin, end, &threadVoxels[threadNum]));
+		}
+		workers.join_all();
+
+		/* merge in range order, so the first occurrence of a voxel is preserved */
+		VoxelTable table;
+		voxels.swap(threadVoxels[0]);
+		table.rehash(voxels.size() * 2);
+		for (unsigned int i = 0; i < voxels.size(); ++i) {
+			VoxelKey key = {voxels[i].x, voxels[i].y, voxels[i].z};
+			table[key] = i;
+		}
+		for (unsigned int threadNum = 1; threadNum < threadCount; ++threadNum) {
+			for (unsigned int i = 0; i < threadVoxels[threadNum].size(); ++i) {
+				const Voxel& voxel = threadVoxels[threadNum][i];
+				VoxelKey key = {voxel.x, voxel.y, voxel.z};
+				std::pair<VoxelTable::iterator, bool> entry = table.insert(std::make_pair(key, static_cast<unsigned int>(voxels.size())));
+				if (entry.second) {
+					voxels.push_back(voxel);
+				} else {
+					Voxel& mergedVoxel = voxels[entry.first->second];
+					mergedVoxel.sumX += voxel.sumX;
+					mergedVoxel.sumY += voxel.sumY;
+					mergedVoxel.sumZ += voxel.sumZ;
+					mergedVoxel.count += voxel.count;
+				}
+			}
+		}
+	}
+
+	/* process results */
+	resultPointCloud->getPointCloud()->reserve(voxels.size());
+	for (unsigned int i = 0; i < voxels.size(); ++i) {
+		const Voxel& voxel = voxels[i];
+		switch (reductionMode) {
+		case centroid:
+			resultPointCloud->addPoint(Point3D(voxel.sumX / voxel.count, voxel.sumY / voxel.count, voxel.sumZ / voxel.count));
+			break;
+		case center:
+			resultPointCloud->addPoint(Point3D((voxel.x + 0.5) * voxelSize, (voxel.y + 0.5) * voxelSize, (voxel.z + 0.5) * voxelSize));
+			break;
+		case firstPoint:
+			resultPointCloud->addPoint((*originalPointCloud->getConstPointCloud())[voxel.firstIndex]);
+			break;
+		default:
+			throw runtime_error("ERROR: Unknown reduction mode for VoxelGridFilter.");
+			break;
+		}
+	}
+
+	LOG(DEBUG) << "VoxelGridFilter: " << numberOfPoints << " points reduced to " << voxels.size() << " voxels by " << std::max(threadCount, 1u) << " threads.";
+}
+
+void VoxelGridFilter::accumulateVoxels(const std::vector<double>* data, unsigned int begin, unsigned int end, std::vector<Voxel>* voxels) {
+	assert(data != 0);
+	assert(voxels != 0);
+
+	const double inverseVoxelSize = 1.0 / voxelSize;
+	const double maxIndex = static_cast<double>(std::numeric_limits<int>::max());
+	unsigned int skippedPoints = 0;
+
+	VoxelTable table;
+	voxels->clear();
+	for (unsigned int i = begin; i < end; ++i) {
+		const double* point = &(*data)[3 * i];
+		double scaledX = std::floor(point[0] * inverseVoxelSize);
+		double scaledY = std::floor(point[1] * inverseVoxelSize);
+		double scaledZ = std::floor(point[2] * inverseVoxelSize);
+		if (!(std::abs(scaledX) < maxIndex && std::abs(scaledY) < maxIndex && std::abs(scaledZ) < maxIndex)) { // also catches NaN
+			skippedPoints++;
+			continue;
+		}
+
+		VoxelKey key = {static_cast<int>(scaledX), static_cast<int>(scaledY), static_cast<int>(scaledZ)};
+		std::pair<VoxelTable::iterator, bool> entry = table.insert(std::make_pair(key, static_cast<unsigned int>(voxels->size())));
+		if (entry.second) {
+			Voxel voxel;
+			voxel.x = key.x;
+			voxel.y = key.y;
+			voxel.z = key.z;
+			voxel.sumX = point[0];
+			voxel.sumY = point[1];
+			voxel.sumZ = point[2];
+			voxel.count = 1;
+			voxel.firstIndex = i;
+			voxels->push_back(voxel);
+		} else {
+			Voxel& voxel = (*voxels)[entry.first->second];
+			voxel.sumX += point[0];
+			voxel.sumY += point[1];
+			voxel.sumZ += point[2];
+			voxel.count++;
+		}
+	}
+
+	if (skippedPoints > 0) {
+		LOG(WARNING) << "VoxelGridFilter: " << skippedPoints << " invalid points or points out of the voxel grid range have been skipped.";
+	}
+}
+
+void VoxelGridFilter::setVoxelSize(double voxelSize) {
+	if (voxelSize < 0.0) {
+		throw runtime_error("ERROR: voxelSize for VoxelGridFilter cannot be less than 0.");
+	}
+	this->voxelSize = voxelSize;
+}
+
+double VoxelGridFilter::getVoxelSize() {
+	return this->voxelSize;
+}
+
+void VoxelGridFilter::setReductionMode(ReductionMode reductionMode) {
+	this->reductionMode = reductionMode;
+}
+
+VoxelGridFilter::ReductionMode VoxelGridFilter::getReductionMode() {
+	return this->reductionMode;
+}
+
+unsigned int VoxelGridFilter::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void VoxelGridFilter::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,139 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_VOXELGRIDFILTER_H_
+#define BRICS_3D_VOXELGRIDFILTER_H_
+
+#include "brics_3d/algorithm/filtering/IFiltering.h"
+
+#include <vector>
+
+namespace brics_3d {
+
+/**
+ * @brief Downsampling of a point cloud with a regular voxel grid.
+ * @ingroup filtering
+ *
+ * Every point is assigned to the axis aligned voxel with edge length voxelSize that contains it.
+ * The voxel grid is aligned to the origin of the coordinate frame. For every occupied voxel exactly
+ * one point is created, depending on the ReductionMode:
+ *  - centroid: the mean of all points in the voxel (default)
+ *  - center: the geometric center of the voxel
+ *  - firstPoint: the first point of the input that falls into the voxel
+ *
+ * The occupied voxels are collected in a hash table within a single pass over the data, so the
+ * runtime is linear in the number of points. In contrast to the Octree no tree is built. The
+ * resulting points are ordered by the first occurrence of their voxel in the input.
+ *
+ * The input can be distributed among several worker threads (see setNumberOfThreads()). Each thread
+ * accumulates a contiguous range of the input into its own table. The tables are merged in the order
+ * of the ranges, thus the result is identical to the one of a single threaded run (up to rounding of
+ * the centroids).
+ */
+class VoxelGridFilter : public IFiltering {
+public:
+
+	/**
+	 * @brief Defines the point that represents an occupied voxel.
+	 */
+	enum ReductionMode {
+		centroid,
+		center,
+		firstPoint
+	};
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	VoxelGridFilter();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~VoxelGridFilter();
+
+	void filter(PointCloud3D* originalPointCloud, PointCloud3D* resultPointCloud);
+
+	/**
+	 * @brief Set the edge length of a voxel.
+	 * @param voxelSize The edge length. 0 means no filtering at all: the data is just copied.
+	 */
+	void setVoxelSize(double voxelSize);
+
+	double getVoxelSize();
+
+	void setReductionMode(ReductionMode reductionMode);
+
+	ReductionMode getReductionMode();
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Minimal number of points that are assigned to a worker thread. Smaller data is processed by fewer threads.
+	static const unsigned int minPointsPerThread;
+
+private:
+
+	/// Accumulated data of a single occupied voxel.
+	struct Voxel {
+		int x;
+		int y;
+		int z;
+		double sumX;
+		double sumY;
+		double sumZ;
+		unsigned int count;
+		unsigned int firstIndex;
+	};
+
+	/**
+	 * @brief Accumulate a range of points into voxels.
+	 * @param[in] data Packed x,y,z coordinates.
+	 * @param begin Index of the first point.
+	 * @param end Index behind the last point.
+	 * @param[out] voxels The occupied voxels in the order of their first occurrence.
+	 */
+	void accumulateVoxels(const std::vector<double>* data, unsigned int begin, unsigned int end, std::vector<Voxel>* voxels);
+
+	/// The edge length of a voxel
+	double voxelSize;
+
+	/// Selects the representative point of a voxel
+	ReductionMode reductionMode;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
+
+};
+
+}
+
+#endif /* BRICS_3D_VOXELGRIDFILTER_H_ */
+
+/* EOF */
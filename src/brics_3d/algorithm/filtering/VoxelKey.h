@@ -0,0 +1,60 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef BRICS_3D_VOXELKEY_H_
+#define BRICS_3D_VOXELKEY_H_
+
+#include <cstddef>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace brics_3d {
+
+/**
+ * @brief Integer coordinates of a voxel. Used as key for hash tables of occupied voxels.
+ * @ingroup filtering
+ */
+struct VoxelKey {
+	int x;
+	int y;
+	int z;
+
+	bool operator==(const VoxelKey& other) const {
+		return (x == other.x) && (y == other.y) && (z == other.z);
+	}
+};
+
+/// Hash function for VoxelKey, as required by boost::hash.
+inline std::size_t hash_value(const VoxelKey& key) {
+	std::size_t seed = 0;
+	boost::hash_combine(seed, key.x);
+	boost::hash_combine(seed, key.y);
+	boost::hash_combine(seed, key.z);
+	return seed;
+}
+
+/// Hash table that maps a voxel to an index.
+typedef boost::unordered_map<VoxelKey, unsigned int, boost::hash<VoxelKey> > VoxelTable;
+
+}
+
+#endif /* BRICS_3D_VOXELKEY_H_ */
+
+/* EOF */
@@ -49,9 +49,9 @@ void DelaunayTriangulationOSG::triangulate(PointCloud3D* pointCloud, ITriangleMe
 
 	osg::Vec3Array* points = new osg::Vec3Array;
 	for(unsigned int i = 0; i < pointCloud->getSize(); ++i) {
-		points->push_back(osg::Vec3((float) ((*pointCloud->getPointCloud())[i].getX()),
-				(float) ((*pointCloud->getPointCloud())[i].getY()),
-				(float) ((*pointCloud->getPointCloud())[i].getZ()))); //NOTE: possible BUG fixed here
+		points->push_back(osg::Vec3((float) ((*pointCloud->getConstPointCloud())[i].getX()),
+				(float) ((*pointCloud->getConstPointCloud())[i].getY()),
+				(float) ((*pointCloud->getConstPointCloud())[i].getZ()))); //NOTE: possible BUG fixed here
 	}
 
 	/* create triangulator and set the points as the area */
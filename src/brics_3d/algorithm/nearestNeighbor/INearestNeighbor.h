@@ -83,6 +83,22 @@ public:
 	 */
 	virtual void findNearestNeighbors(vector<double>* query, std::vector<int>* resultIndices, unsigned int k = 1) = 0;
 
+	/**
+	 * @brief Find the $k$ nearest neighbors for a batch of queries with a single invocation.
+	 *
+	 * @param[in] queries Vectors that will be queried to the data. Each inner vector must have the
+	 * same dimensionality as the data, set with setData(). Otherwise an exception is thrown.
+	 * @param[out] resultIndices Returns the indices of the $k$ nearest neighbors for every query in a flat array
+	 * of size <code>queries->size() * k</code>. The neighbors of query $i$ are stored at positions $i*k$ to $i*k + k-1$, sorted
+	 * by increasing distance. Neighbors that exceed the maximum distance are marked with the index -1.
+	 * @param[out] resultDistances Returns the distances to the nearest neighbors with the same layout as resultIndices.
+	 * Marked neighbors have a distance of -1. Pass a null pointer if the distances are not of interest.
+	 * @param[in] k Sets how many nearest neighbors will be searched for each query.
+	 *
+	 * <b>NOTE:</b> setData() must be invoked before.
+	 */
+	virtual void findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1) = 0;
+
 };
 
 }  // namespace brics_3d
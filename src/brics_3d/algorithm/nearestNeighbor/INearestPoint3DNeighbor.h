@@ -66,6 +66,62 @@ public:
 	 * <b>NOTE:</b> setData() must be invoked before.
 	 */
 	virtual void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, unsigned int k = 1) = 0; //TODO typo: findNearestNeighbors
+
+	/**
+	 * @brief Find the nearest neighbor points of the query and their distances to the query.
+	 *
+	 * @param[in] query Point that will be queried to the data.
+	 * @param[out] resultIndices Returns the indices of the $k$ nearest neighbors with respect to the data point cloud,
+	 * sorted by increasing distance. Neighbors that exceed the maximum distance are omitted.
+	 * @param[out] resultDistances Returns the Euclidean distances of the neighbors in resultIndices.
+	 * @param[in] k Sets how many nearest neighbors will be searched.
+	 *
+	 * <b>NOTE:</b> setData() must be invoked before.
+	 */
+	virtual void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1) = 0;
+
+	/**
+	 * @brief Find all points of the data that lie within a radius around the query.
+	 *
+	 * In contrast to a $k$ nearest neighbor search with a maximum distance, the number of
+	 * neighbors is not limited. The maximum distance setting is not taken into account.
+	 *
+	 * @param[in] query Point that will be queried to the data.
+	 * @param[in] radius The search radius. Points at a distance equal to the radius are included.
+	 * @param[out] resultIndices Returns the indices of all neighbors within the radius, sorted by increasing distance.
+	 * @param[out] resultDistances Returns the Euclidean distances of the neighbors in resultIndices.
+	 * Pass a null pointer if the distances are not of interest.
+	 *
+	 * <b>NOTE:</b> setData() must be invoked before.
+	 */
+	virtual void findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances = 0) = 0;
+
+	/**
+	 * @brief Find the $k$ nearest neighbors for all points of a point cloud with a single invocation.
+	 *
+	 * @param[in] queries Points that will be queried to the data.
+	 * @param[out] resultIndices Returns the indices of the $k$ nearest neighbors for every query point in a flat array
+	 * of size <code>queries->getSize() * k</code>. The neighbors of query $i$ are stored at positions $i*k$ to $i*k + k-1$, sorted
+	 * by increasing distance. Neighbors that exceed the maximum distance are marked with the index -1.
+	 * @param[out] resultDistances Returns the distances to the nearest neighbors with the same layout as resultIndices.
+	 * Marked neighbors have a distance of -1. Pass a null pointer if the distances are not of interest.
+	 * @param[in] k Sets how many nearest neighbors will be searched for each query point.
+	 *
+	 * <b>NOTE:</b> setData() must be invoked before.
+	 */
+	virtual void findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1) = 0;
+
+	/**
+	 * @brief Tells if findNearestNeighbors() can be invoked concurrently by multiple threads.
+	 *
+	 * Concurrent queries are only allowed after setData() has been completed.
+	 * Implementations that keep any search state in members or globals must return false.
+	 *
+	 * @return True if concurrent queries are safe. Default is false.
+	 */
+	virtual bool supportsConcurrentQueries() const {
+		return false;
+	}
 };
 
 }  // namespace brics_3d
@@ -61,6 +61,8 @@ void NearestNeighborANN::setData(vector<vector<double> >* data) {
 	if (dataPoints != 0) {
 			annDeallocPts(dataPoints);
 	}
+	packedDataPoints.clear();
+	packedData.reset();
 
 	dimension = (*data)[0].size();
 	dataPoints = annAllocPts(data->size(), dimension);			// allocate data points
@@ -88,21 +90,24 @@ void NearestNeighborANN::setData(PointCloud3D* data) {
 	}
 	if (dataPoints != 0) {
 			annDeallocPts(dataPoints);
+			dataPoints = 0;
 	}
 
 	dimension = 3; //we work with a 3D points...
-	dataPoints = annAllocPts(data->getSize(), dimension);			// allocate data points
-	int nPts = static_cast<int>(data->getSize());									// read data points
-
-	/* fill in the data int the ANN specific representation */
-	for (int i = 0; i < static_cast<int>(data->getSize()); ++i) {
-		dataPoints[i][0] = static_cast<ANNcoord>( (*data->getPointCloud())[i].getX() );
-		dataPoints[i][1] = static_cast<ANNcoord>( (*data->getPointCloud())[i].getY() );
-		dataPoints[i][2] = static_cast<ANNcoord>( (*data->getPointCloud())[i].getZ() );
+	int nPts = static_cast<int>(data->getSize());
+
+	/*
+	 * The ANN k-d tree only refers to the points. So instead of copying them, we let
+	 * the point array directly point into the packed coordinates of the point cloud.
+	 */
+	packedData = data->getPackedCoordinates();
+	packedDataPoints.resize(nPts);
+	for (int i = 0; i < nPts; ++i) {
+		packedDataPoints[i] = const_cast<ANNpoint>(&(*packedData)[3 * i]); // ANN does not modify the data
 	}
 
 	kdTree = new ANNkd_tree(					// build search structure
-					dataPoints,					// the data points
+					(nPts > 0) ? &packedDataPoints[0] : 0,	// the data points
 					nPts,						// number of points
 					dimension);					// dimension of space
 
@@ -212,6 +217,150 @@ void NearestNeighborANN::findNearestNeighbors(Point3D* query, std::vector<int>*
 
 }
 
+void NearestNeighborANN::findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (resultDistances != 0);
+	assert (dimension == 3);
+
+	if (static_cast<int>(k) > kdTree->nPoints()) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	this->k = static_cast<int>(k);
+	queryBuffer.resize(3);
+	queryBuffer[0] = static_cast<ANNcoord>( query->getX() );
+	queryBuffer[1] = static_cast<ANNcoord>( query->getY() );
+	queryBuffer[2] = static_cast<ANNcoord>( query->getZ() );
+
+	std::vector<int> indices(k);
+	std::vector<double> distances(k);
+	findNearestNeighbors(&queryBuffer[0], 0, &indices, &distances);
+
+	resultIndices->clear();
+	resultDistances->clear();
+	for (unsigned int i = 0; i < k; i++) {
+		if (indices[i] >= 0) {
+			resultIndices->push_back(indices[i]);
+			resultDistances->push_back(distances[i]);
+		}
+	}
+}
+
+void NearestNeighborANN::findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (dimension == 3);
+
+	resultIndices->clear();
+	if (resultDistances != 0) {
+		resultDistances->clear();
+	}
+	if (kdTree == 0 || radius < 0.0) {
+		return;
+	}
+
+	queryBuffer.resize(3);
+	queryBuffer[0] = static_cast<ANNcoord>( query->getX() );
+	queryBuffer[1] = static_cast<ANNcoord>( query->getY() );
+	queryBuffer[2] = static_cast<ANNcoord>( query->getZ() );
+	ANNdist squaredRadius = static_cast<ANNdist>(radius * radius);
+
+	/* first count the points in the radius, then retrieve them sorted by distance */
+	int count = kdTree->annkFRSearch(&queryBuffer[0], squaredRadius, 0, 0, 0, eps);
+	if (count == 0) {
+		return;
+	}
+	resultIndices->resize(count);
+	distanceBuffer.resize(count);
+	kdTree->annkFRSearch(&queryBuffer[0], squaredRadius, count, &(*resultIndices)[0], &distanceBuffer[0], eps);
+
+	if (resultDistances != 0) {
+		resultDistances->resize(count);
+		for (int i = 0; i < count; i++) {
+			(*resultDistances)[i] = static_cast<brics_3d::Coordinate>(sqrt(distanceBuffer[i]));	//unsquare distance
+		}
+	}
+}
+
+void NearestNeighborANN::findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+
+	if (static_cast<int>(k) > kdTree->nPoints()) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	this->k = static_cast<int>(k);
+	int queryCount = static_cast<int>(queries->size());
+	resultIndices->resize(queryCount * this->k);
+	if (resultDistances != 0) {
+		resultDistances->resize(queryCount * this->k);
+	}
+
+	queryBuffer.resize(dimension);
+	for (int queryIndex = 0; queryIndex < queryCount; ++queryIndex) {
+		if (static_cast<int>((*queries)[queryIndex].size()) != dimension) {
+			throw runtime_error("Mismatch of query and data dimension.");
+		}
+		for (int j = 0; j < dimension; ++j) {
+			queryBuffer[j] = static_cast<ANNcoord>( (*queries)[queryIndex][j] );
+		}
+		findNearestNeighbors(&queryBuffer[0], queryIndex, resultIndices, resultDistances);
+	}
+}
+
+void NearestNeighborANN::findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+	assert (dimension == 3);
+
+	if (static_cast<int>(k) > kdTree->nPoints()) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	this->k = static_cast<int>(k);
+	int queryCount = static_cast<int>(queries->getSize());
+	resultIndices->resize(queryCount * this->k);
+	if (resultDistances != 0) {
+		resultDistances->resize(queryCount * this->k);
+	}
+
+	/* ANNcoord is a double, so the packed coordinates can be queried without a copy */
+	PointCloud3D::PackedCoordinatesConstPtr packedQueries = queries->getPackedCoordinates();
+	for (int queryIndex = 0; queryIndex < queryCount; ++queryIndex) {
+		ANNpoint query = const_cast<ANNpoint>(&(*packedQueries)[3 * queryIndex]); // ANN does not modify the query
+		findNearestNeighbors(query, queryIndex, resultIndices, resultDistances);
+	}
+}
+
+void NearestNeighborANN::findNearestNeighbors(ANNpoint query, int queryIndex, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	if (this->k == 0) {
+		return;
+	}
+	distanceBuffer.resize(this->k);
+	int offset = queryIndex * this->k;
+
+	kdTree->annkSearch(						// search
+			query,							// query point
+			this->k,						// number of near neighbors
+			&(*resultIndices)[offset],		// nearest neighbors (returned)
+			&distanceBuffer[0],				// distance (returned)
+			eps);							// error bound
+
+	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different
+	for (int i = 0; i < this->k; i++) {
+		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(distanceBuffer[i]));	//unsquare distance
+		if (!(resultDistance <= maxDistance || maxDistance < 0.0)) { //if max distance is < 0 then the distance should have no influence
+			(*resultIndices)[offset + i] = -1;
+			resultDistance = -1.0;
+		}
+		if (resultDistances != 0) {
+			(*resultDistances)[offset + i] = resultDistance;
+		}
+	}
+}
+
 }
 
 /* EOF */
@@ -56,6 +56,10 @@ public:
 	void findNearestNeighbors(vector<float>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(vector<double>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, unsigned int k = 1);
+	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances = 0);
+	void findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
 
 private:
 
@@ -71,6 +75,12 @@ private:
 	/// data points
 	ANNpointArray dataPoints;
 
+	/// Packed coordinates of a point cloud passed via setData(PointCloud3D*)
+	PointCloud3D::PackedCoordinatesConstPtr packedData;
+
+	/// Array of pointers into packedData as used by the k-d tree
+	std::vector<ANNpoint> packedDataPoints;
+
 	/// query point
 	ANNpoint queryPoint;
 
@@ -83,6 +93,21 @@ private:
 	/// search structure
 	ANNkd_tree* kdTree;
 
+	/**
+	 * @brief Search the $k$ nearest neighbors for one query of a batch.
+	 * @param query The query point.
+	 * @param queryIndex Position of the query in the batch.
+	 * @param[out] resultIndices Flat array of indices with sufficient size, see INearestNeighbor::findNearestNeighbors().
+	 * @param[out] resultDistances Flat array of distances with sufficient size or null.
+	 */
+	void findNearestNeighbors(ANNpoint query, int queryIndex, std::vector<int>* resultIndices, std::vector<double>* resultDistances);
+
+	/// Reused buffer for the query of a batch
+	std::vector<ANNcoord> queryBuffer;
+
+	/// Reused buffer for the squared distances of a single query of a batch
+	std::vector<ANNdist> distanceBuffer;
+
 };
 
 }
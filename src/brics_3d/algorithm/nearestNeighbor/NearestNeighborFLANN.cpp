@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <stdexcept>
 #include <cmath>
+#include <limits>
 
 using std::runtime_error;
 
@@ -63,16 +64,18 @@ void NearestNeighborFLANN::setData(vector<vector<double> >* data) {
 	rows = data->size();
 	cols = dimension;
 
-	dataMatrix = new float[rows * cols];
+	std::vector<float>* matrix = new std::vector<float>(rows * cols);
 
 	// convert data
 	int matrixIndex = 0;
 	for (int rowIndex = 0; rowIndex < rows; ++rowIndex) {
 		for (int j = 0; j < dimension; ++j) {
-			dataMatrix[matrixIndex + j] = static_cast<float> ( (*data)[rowIndex][j] );
+			(*matrix)[matrixIndex + j] = static_cast<float> ( (*data)[rowIndex][j] );
 		}
 		matrixIndex += dimension;
 	}
+	dataBuffer.reset(matrix); // releases a previous buffer
+	dataMatrix = const_cast<float*>(&(*dataBuffer)[0]);
 
 	// create underlying data structure
 	index_id = flann_build_index(dataMatrix, rows, cols, &speedup, &parameters);
@@ -89,16 +92,12 @@ void NearestNeighborFLANN::setData(PointCloud3D* data) {
 	rows = data->getSize();
 	cols = dimension;
 
-	dataMatrix = new float[rows * cols];
-
-	// convert data
-	int matrixIndex = 0;
-	for (int rowIndex = 0; rowIndex < rows; ++rowIndex) {
-		dataMatrix[matrixIndex + 0] = static_cast<float> ((*data->getPointCloud())[rowIndex].getX());
-		dataMatrix[matrixIndex + 1] = static_cast<float> ((*data->getPointCloud())[rowIndex].getY());
-		dataMatrix[matrixIndex + 2] = static_cast<float> ((*data->getPointCloud())[rowIndex].getZ());
-		matrixIndex += 3;
-	}
+	/*
+	 * FLANN does not copy the data set but refers to it. So we hold a reference to the
+	 * (cached) packed coordinates of the point cloud as long as the index exists.
+	 */
+	dataBuffer = data->getPackedFloatCoordinates();
+	dataMatrix = (rows > 0) ? const_cast<float*>(&(*dataBuffer)[0]) : NULL; // FLANN does not modify the data
 
 	// create underlying data structure
 	index_id = flann_build_index(dataMatrix, rows, cols, &speedup, &parameters);
@@ -121,32 +120,19 @@ void NearestNeighborFLANN::findNearestNeighbors(vector<double>* query, std::vect
 		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
 	}
 
-	resultIndices->clear();
-	int nn = static_cast<int>(k);
-	int tcount = 1;
-	int* result = new int[nn];
-	float* dists = new float[nn];
-
-	float* queryData = new float[dimension]; //TODO: is there also a double version?!?
+	queryBuffer.resize(dimension); //TODO: is there also a double version?!?
 	for (int i = 0; i < dimension; ++i) {
-		queryData[i] = static_cast<float>( (*query)[i] );
+		queryBuffer[i] = static_cast<float>( (*query)[i] );
 	}
 
-	flann_find_nearest_neighbors_index(index_id, queryData, tcount, result, dists, nn, parameters.checks, &parameters);
+	findNearestNeighbors(&queryBuffer[0], 1, static_cast<int>(k), &indexBuffer, 0);
 
-	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different TODO: global distance typedef?
-	int resultIndex;
-	for (int i = 0; i < nn; i++) {
-		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(dists[i])); //seems to return squared distance (although documentation does not suggest)
-		resultIndex = result[i];
-		if (resultDistance <= maxDistance || maxDistance < 0.0) { //if max distance is < 0 then the distance should have no influence
-			resultIndices->push_back(resultIndex);
+	resultIndices->clear();
+	for (unsigned int i = 0; i < k; i++) {
+		if (indexBuffer[i] >= 0) {
+			resultIndices->push_back(indexBuffer[i]);
 		}
 	}
-
-	delete[] queryData;
-	delete[] dists;
-	delete[] result;
 }
 
 void NearestNeighborFLANN::findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, unsigned int k) {
@@ -158,32 +144,153 @@ void NearestNeighborFLANN::findNearestNeighbors(Point3D* query, std::vector<int>
 		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
 	}
 
+	queryBuffer.resize(3);
+	queryBuffer[0] = static_cast<float> (query->getX());
+	queryBuffer[1] = static_cast<float> (query->getY());
+	queryBuffer[2] = static_cast<float> (query->getZ());
+
+	findNearestNeighbors(&queryBuffer[0], 1, static_cast<int>(k), &indexBuffer, 0);
+
 	resultIndices->clear();
-	int nn = static_cast<int>(k);
-	int tcount = 1;
-	int* result = new int[nn];
-	float* dists = new float[nn];
+	for (unsigned int i = 0; i < k; i++) {
+		if (indexBuffer[i] >= 0) {
+			resultIndices->push_back(indexBuffer[i]);
+		}
+	}
+}
 
-	float* queryData = new float[dimension];
-	queryData[0] = static_cast<float> (query->getX());
-	queryData[1] = static_cast<float> (query->getY());
-	queryData[2] = static_cast<float> (query->getZ());
+void NearestNeighborFLANN::findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (resultDistances != 0);
+	assert (dimension == 3);
 
-	flann_find_nearest_neighbors_index(index_id, queryData, tcount, result, dists, nn, parameters.checks, &parameters);
+	if (static_cast<int>(k) > this->rows) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
 
-	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different TODO: global distance typedef?
-	int resultIndex;
-	for (int i = 0; i < nn; i++) {
-		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(dists[i])); //seems to return squared distance (although documentation does not suggest)
-		resultIndex = result[i];
-		if (resultDistance <= maxDistance || maxDistance < 0.0) { //if max distance is < 0 then the distance should have no influence
-			resultIndices->push_back(resultIndex);
+	queryBuffer.resize(3);
+	queryBuffer[0] = static_cast<float> (query->getX());
+	queryBuffer[1] = static_cast<float> (query->getY());
+	queryBuffer[2] = static_cast<float> (query->getZ());
+
+	std::vector<double> distances;
+	findNearestNeighbors(&queryBuffer[0], 1, static_cast<int>(k), &indexBuffer, &distances);
+
+	resultIndices->clear();
+	resultDistances->clear();
+	for (unsigned int i = 0; i < k; i++) {
+		if (indexBuffer[i] >= 0) {
+			resultIndices->push_back(indexBuffer[i]);
+			resultDistances->push_back(distances[i]);
+		}
+	}
+}
+
+void NearestNeighborFLANN::findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (dimension == 3);
+
+	resultIndices->clear();
+	if (resultDistances != 0) {
+		resultDistances->clear();
+	}
+	if (this->rows == 0 || radius < 0.0) {
+		return;
+	}
+
+	queryBuffer.resize(3);
+	queryBuffer[0] = static_cast<float> (query->getX());
+	queryBuffer[1] = static_cast<float> (query->getY());
+	queryBuffer[2] = static_cast<float> (query->getZ());
+
+	/* FLANN does not limit the results to the buffer size, so the buffers have to be able to hold all points */
+	indexBuffer.resize(this->rows);
+	distanceBuffer.resize(this->rows);
+	float squaredRadius = static_cast<float>(radius * radius);
+	float searchRadius = squaredRadius * (1.0f + 4.0f * std::numeric_limits<float>::epsilon()); // FLANN prunes branches that touch the radius
+	int count = flann_radius_search(index_id, &queryBuffer[0], &indexBuffer[0], &distanceBuffer[0], this->rows, searchRadius, parameters.checks, &parameters);
+	if (count < 0) {
+		throw runtime_error("FLANN radius search failed.");
+	}
+	while (count > 0 && distanceBuffer[count - 1] > squaredRadius) { // results are sorted by distance
+		count--;
+	}
+
+	resultIndices->assign(indexBuffer.begin(), indexBuffer.begin() + count);
+	if (resultDistances != 0) {
+		resultDistances->resize(count);
+		for (int i = 0; i < count; i++) {
+			(*resultDistances)[i] = static_cast<brics_3d::Coordinate>(sqrt(distanceBuffer[i])); // FLANN returns squared distances
 		}
 	}
+}
+
+void NearestNeighborFLANN::findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+
+	if (static_cast<int>(k) > this->rows) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	int queryCount = static_cast<int>(queries->size());
+	queryBuffer.resize(queryCount * dimension);
+	int matrixIndex = 0;
+	for (int rowIndex = 0; rowIndex < queryCount; ++rowIndex) {
+		if (static_cast<int>((*queries)[rowIndex].size()) != dimension) {
+			throw runtime_error("Mismatch of query and data dimension.");
+		}
+		for (int j = 0; j < dimension; ++j) {
+			queryBuffer[matrixIndex + j] = static_cast<float> ( (*queries)[rowIndex][j] );
+		}
+		matrixIndex += dimension;
+	}
+
+	findNearestNeighbors((queryCount > 0) ? &queryBuffer[0] : 0, queryCount, static_cast<int>(k), resultIndices, resultDistances);
+}
 
-	delete[] queryData;
-	delete[] dists;
-	delete[] result;
+void NearestNeighborFLANN::findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+	assert (dimension == 3);
+
+	if (static_cast<int>(k) > this->rows) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	/* the packed float coordinates already have the layout of a FLANN query matrix */
+	PointCloud3D::PackedFloatCoordinatesConstPtr queryMatrix = queries->getPackedFloatCoordinates();
+	int queryCount = static_cast<int>(queries->getSize());
+	float* queryData = (queryCount > 0) ? const_cast<float*>(&(*queryMatrix)[0]) : 0; // FLANN does not modify the queries
+
+	findNearestNeighbors(queryData, queryCount, static_cast<int>(k), resultIndices, resultDistances);
+}
+
+void NearestNeighborFLANN::findNearestNeighbors(float* queryMatrix, int queryCount, int nn, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	resultIndices->resize(queryCount * nn);
+	distanceBuffer.resize(queryCount * nn);
+	if (resultDistances != 0) {
+		resultDistances->resize(queryCount * nn);
+	}
+	if (queryCount == 0 || nn == 0) {
+		return;
+	}
+
+	flann_find_nearest_neighbors_index(index_id, queryMatrix, queryCount, &(*resultIndices)[0], &distanceBuffer[0], nn, parameters.checks, &parameters);
+
+	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different TODO: global distance typedef?
+	for (int i = 0; i < queryCount * nn; i++) {
+		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(distanceBuffer[i])); //seems to return squared distance (although documentation does not suggest)
+		if (!(resultDistance <= maxDistance || maxDistance < 0.0)) { //if max distance is < 0 then the distance should have no influence
+			(*resultIndices)[i] = -1;
+			resultDistance = -1.0;
+		}
+		if (resultDistances != 0) {
+			(*resultDistances)[i] = resultDistance;
+		}
+	}
 }
 
 FLANNParameters NearestNeighborFLANN::getParameters() const {
@@ -31,6 +31,9 @@ namespace brics_3d {
  * @ingroup nearestNeighbor
  * @brief Implementation for the nearest neighbor search algorithm with the FLANN library.
  *
+ * All searches are approximate according to the "checks" parameter (see setParameters()). This
+ * applies to the radius search as well: not all neighbors within the radius might be found.
+ * A "checks" value that is not smaller than the number of data points results in an exhaustive search.
  */
 class NearestNeighborFLANN : public INearestNeighbor, public INearestPoint3DNeighbor, public INearestNeighborSetup {
 public:
@@ -52,6 +55,10 @@ public:
 	void findNearestNeighbors(vector<float>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(vector<double>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, unsigned int k = 1);
+	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances = 0);
+	void findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
 
 	FLANNParameters getParameters() const;
 
@@ -65,9 +72,12 @@ public:
 
 private:
 
-	/// Matrix in major-row representation
+	/// Matrix in major-row representation. Points into dataBuffer.
 	float* dataMatrix;
 
+	/// Owner of the memory where dataMatrix points to. The FLANN index refers to it, so it has to live as long as the index.
+	PointCloud3D::PackedFloatCoordinatesConstPtr dataBuffer;
+
 	/// Number of rows in the dataMatrix
 	int rows;
 
@@ -82,6 +92,25 @@ private:
 
 	/// Estimated speedup of used algorithm with respect to a brute force approach
 	float speedup;
+
+	/**
+	 * @brief Query all rows of a query matrix with a single FLANN invocation.
+	 * @param queryMatrix Query matrix in major-row representation with the same number of columns as the data.
+	 * @param queryCount Number of rows in the queryMatrix.
+	 * @param nn Number of nearest neighbors per query.
+	 * @param[out] resultIndices Flat array of indices, see INearestNeighbor::findNearestNeighbors().
+	 * @param[out] resultDistances Flat array of distances or null.
+	 */
+	void findNearestNeighbors(float* queryMatrix, int queryCount, int nn, std::vector<int>* resultIndices, std::vector<double>* resultDistances);
+
+	/// Reused buffer for the queries, so single queries do not allocate memory
+	std::vector<float> queryBuffer;
+
+	/// Reused buffer for the resulting indices
+	std::vector<int> indexBuffer;
+
+	/// Reused buffer for the resulting (squared) distances
+	std::vector<float> distanceBuffer;
 };
 
 }
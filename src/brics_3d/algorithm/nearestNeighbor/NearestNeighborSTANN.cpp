@@ -20,7 +20,9 @@
 #include "NearestNeighborSTANN.h"
 #include <assert.h>
 #include <cmath>
+#include <algorithm>
 #include <stdexcept>
+#include <boost/static_assert.hpp>
 
 using std::cout;
 using std::endl;
@@ -28,12 +30,15 @@ using std::runtime_error;
 
 namespace brics_3d {
 
+const unsigned int NearestNeighborSTANN::initialRadiusSearchNeighbors = 16;
+
 NearestNeighborSTANN::NearestNeighborSTANN() {
 	this->dimension = -1;
 	this->maxDistance = -1; //default = disable
 
 	nearestPoint3DNeigborHandle = 0;
 	nearestNeigborHandle = 0;
+	numberOfPoints3D = 0;
 
 	points3D = new vector<STANNPoint3D>();
 	points = new vector<STANNPoint>;
@@ -100,23 +105,22 @@ void NearestNeighborSTANN::setData(PointCloud3D* data) {
 
 	if (nearestPoint3DNeigborHandle != 0) {
 		delete nearestPoint3DNeigborHandle; // clean up old stuff first
-		points3D->clear();
+		nearestPoint3DNeigborHandle = 0;
 	}
 
-	double tmpX = 0.0;
-	double tmpY = 0.0;
-	double tmpZ = 0.0;
-
-	for (int i = 0; i < static_cast<int>(data->getSize()); ++i) {
-		tmpX = (*data->getPointCloud())[i].getX();
-		tmpY = (*data->getPointCloud())[i].getY();
-		tmpZ = (*data->getPointCloud())[i].getZ();
-		STANNPoint3D tmpPoint(tmpX, tmpY, tmpZ);
-		points3D->push_back(tmpPoint);
-//		cout << tmpPoint;
+	/*
+	 * STANN copies the data into its own Morton ordered representation. A STANNPoint3D is a plain
+	 * array of three doubles, so the packed coordinates can be handed over without an intermediate copy.
+	 */
+	BOOST_STATIC_ASSERT(sizeof(STANNPoint3D) == 3 * sizeof(double));
+	PointCloud3D::PackedCoordinatesConstPtr packedData = data->getPackedCoordinates();
+	numberOfPoints3D = data->getSize();
+	if (numberOfPoints3D == 0) {
+		return;
 	}
 
-	nearestPoint3DNeigborHandle = new sfcnn<STANNPoint3D, STANNPoint3DDimension, double> (&(*points3D)[0], static_cast<int>(data->getSize())); // create morton ordering
+	STANNPoint3D* stannPoints = const_cast<STANNPoint3D*>(reinterpret_cast<const STANNPoint3D*>(&(*packedData)[0]));
+	nearestPoint3DNeigborHandle = new sfcnn<STANNPoint3D, STANNPoint3DDimension, double> (stannPoints, static_cast<int>(numberOfPoints3D)); // create morton ordering
 
 }
 
@@ -167,7 +171,7 @@ void NearestNeighborSTANN::findNearestNeighbors(Point3D* query, std::vector<int>
 	assert (resultIndices != 0);
 	assert (STANNPoint3DDimension == 3);
 
-	if (static_cast<unsigned int>(k) > this->points3D->size()) {
+	if (static_cast<unsigned int>(k) > numberOfPoints3D) {
 		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
 	}
 
@@ -178,25 +182,183 @@ void NearestNeighborSTANN::findNearestNeighbors(Point3D* query, std::vector<int>
 
 
 	STANNPoint3D queryPoint(tmpX, tmpY, tmpZ);
-	this->resultIndices->clear();
-	squaredResultDistances->clear();
-	nearestPoint3DNeigborHandle->ksearch(queryPoint, k, *(this->resultIndices), *squaredResultDistances);
-	assert( static_cast<unsigned int>(this->resultIndices->size()) == static_cast<unsigned int>(k));
-	assert( static_cast<unsigned int>(this->resultIndices->size()) > 0);
-	assert( static_cast<unsigned int>(squaredResultDistances->size()) == static_cast<unsigned int>(k));
-	assert( static_cast<unsigned int>(squaredResultDistances->size()) > 0);
+	vector<long unsigned int> foundIndices; // local buffers, so concurrent queries do not interfere
+	vector<double> foundSquaredDistances;
+	nearestPoint3DNeigborHandle->ksearch(queryPoint, k, foundIndices, foundSquaredDistances);
+	assert( static_cast<unsigned int>(foundIndices.size()) == static_cast<unsigned int>(k));
+	assert( static_cast<unsigned int>(foundIndices.size()) > 0);
+	assert( static_cast<unsigned int>(foundSquaredDistances.size()) == static_cast<unsigned int>(k));
+	assert( static_cast<unsigned int>(foundSquaredDistances.size()) > 0);
 
 	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different
 	int resultIndex;
 	for (int i = 0; i < static_cast<int>(k); i++) {
-		resultDistance = static_cast<brics_3d::Coordinate>(sqrt((*squaredResultDistances)[i])); //seems to return squared distance (although documentation does not suggest)
-		resultIndex = static_cast<int>((*(this->resultIndices))[i]);
+		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(foundSquaredDistances[i])); //seems to return squared distance (although documentation does not suggest)
+		resultIndex = static_cast<int>(foundIndices[i]);
 		if (resultDistance <= maxDistance || maxDistance < 0.0) { //if max distance is < 0 then the distance should have no influence
 			resultIndices->push_back(resultIndex);
 		}
 	}
 }
 
+void NearestNeighborSTANN::findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (resultDistances != 0);
+	assert (STANNPoint3DDimension == 3);
+
+	if (static_cast<unsigned int>(k) > numberOfPoints3D) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	resultIndices->clear();
+	resultDistances->clear();
+	if (k == 0) {
+		return;
+	}
+
+	STANNPoint3D queryPoint(query->getX(), query->getY(), query->getZ());
+	vector<long unsigned int> foundIndices;
+	vector<double> foundSquaredDistances;
+	nearestPoint3DNeigborHandle->ksearch(queryPoint, k, foundIndices, foundSquaredDistances);
+
+	brics_3d::Coordinate resultDistance;
+	for (unsigned int i = 0; i < k; i++) {
+		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(foundSquaredDistances[i]));
+		if (resultDistance <= maxDistance || maxDistance < 0.0) { //if max distance is < 0 then the distance should have no influence
+			resultIndices->push_back(static_cast<int>(foundIndices[i]));
+			resultDistances->push_back(resultDistance);
+		}
+	}
+}
+
+void NearestNeighborSTANN::findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	assert (query != 0);
+	assert (resultIndices != 0);
+	assert (STANNPoint3DDimension == 3);
+
+	resultIndices->clear();
+	if (resultDistances != 0) {
+		resultDistances->clear();
+	}
+	if (numberOfPoints3D == 0 || radius < 0.0) {
+		return;
+	}
+
+	/*
+	 * STANN has no fixed radius search. So we query an increasing number of nearest neighbors
+	 * until the farthest one is outside of the radius (or all points are found).
+	 */
+	STANNPoint3D queryPoint(query->getX(), query->getY(), query->getZ());
+	double squaredRadius = radius * radius;
+	vector<long unsigned int> foundIndices;
+	vector<double> foundSquaredDistances;
+	unsigned int k = std::min(initialRadiusSearchNeighbors, numberOfPoints3D);
+	while (true) {
+		foundIndices.clear();
+		foundSquaredDistances.clear();
+		nearestPoint3DNeigborHandle->ksearch(queryPoint, k, foundIndices, foundSquaredDistances);
+		if (foundSquaredDistances.back() > squaredRadius || k == numberOfPoints3D) {
+			break;
+		}
+		k = std::min(2 * k, numberOfPoints3D);
+	}
+
+	for (unsigned int i = 0; i < foundIndices.size() && foundSquaredDistances[i] <= squaredRadius; i++) {
+		resultIndices->push_back(static_cast<int>(foundIndices[i]));
+		if (resultDistances != 0) {
+			resultDistances->push_back(sqrt(foundSquaredDistances[i]));
+		}
+	}
+}
+
+void NearestNeighborSTANN::findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+
+	if (static_cast<unsigned int>(k) > this->points->size()) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	unsigned int queryCount = static_cast<unsigned int>(queries->size());
+	resultIndices->resize(queryCount * k);
+	if (resultDistances != 0) {
+		resultDistances->resize(queryCount * k);
+	}
+	if (k == 0) {
+		return;
+	}
+
+	STANNPoint queryPoint;
+	for (unsigned int queryIndex = 0; queryIndex < queryCount; ++queryIndex) {
+		if (static_cast<int>((*queries)[queryIndex].size()) != dimension) {
+			throw runtime_error("Mismatch of query and data dimension.");
+		}
+		for (int i = 0; i < dimension; ++i) {
+			queryPoint[i] = (*queries)[queryIndex][i];
+		}
+		this->resultIndices->clear();
+		squaredResultDistances->clear();
+		nearestNeigborHandle->ksearch(queryPoint, k, *(this->resultIndices), *squaredResultDistances);
+		storeBatchResult(*(this->resultIndices), *squaredResultDistances, queryIndex, k, resultIndices, resultDistances);
+	}
+}
+
+void NearestNeighborSTANN::findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k) {
+	assert (queries != 0);
+	assert (resultIndices != 0);
+	assert (STANNPoint3DDimension == 3);
+
+	if (static_cast<unsigned int>(k) > numberOfPoints3D) {
+		throw runtime_error("Number of neighbors k is bigger than the amount of data points.");
+	}
+
+	unsigned int queryCount = queries->getSize();
+	resultIndices->resize(queryCount * k);
+	if (resultDistances != 0) {
+		resultDistances->resize(queryCount * k);
+	}
+	if (k == 0 || queryCount == 0) {
+		return;
+	}
+
+	/* a STANNPoint3D is a plain array of three doubles, see setData() */
+	PointCloud3D::PackedCoordinatesConstPtr packedQueries = queries->getPackedCoordinates();
+	const STANNPoint3D* queryPoints = reinterpret_cast<const STANNPoint3D*>(&(*packedQueries)[0]);
+	vector<long unsigned int> foundIndices;
+	vector<double> foundSquaredDistances;
+	for (unsigned int queryIndex = 0; queryIndex < queryCount; ++queryIndex) {
+		foundIndices.clear();
+		foundSquaredDistances.clear();
+		nearestPoint3DNeigborHandle->ksearch(queryPoints[queryIndex], k, foundIndices, foundSquaredDistances);
+		storeBatchResult(foundIndices, foundSquaredDistances, queryIndex, k, resultIndices, resultDistances);
+	}
+}
+
+void NearestNeighborSTANN::storeBatchResult(const vector<long unsigned int>& foundIndices, const vector<double>& foundSquaredDistances,
+		unsigned int queryIndex, unsigned int k, std::vector<int>* resultIndices, std::vector<double>* resultDistances) {
+	assert(static_cast<unsigned int>(foundIndices.size()) == k);
+	assert(static_cast<unsigned int>(foundSquaredDistances.size()) == k);
+	unsigned int offset = queryIndex * k;
+
+	brics_3d::Coordinate resultDistance; //distance has same data-type as Coordinate, although the meaning is different
+	for (unsigned int i = 0; i < k; i++) {
+		resultDistance = static_cast<brics_3d::Coordinate>(sqrt(foundSquaredDistances[i])); //seems to return squared distance (although documentation does not suggest)
+		(*resultIndices)[offset + i] = static_cast<int>(foundIndices[i]);
+		if (!(resultDistance <= maxDistance || maxDistance < 0.0)) { //if max distance is < 0 then the distance should have no influence
+			(*resultIndices)[offset + i] = -1;
+			resultDistance = -1.0;
+		}
+		if (resultDistances != 0) {
+			(*resultDistances)[offset + i] = resultDistance;
+		}
+	}
+}
+
+bool NearestNeighborSTANN::supportsConcurrentQueries() const {
+	return false;
+}
+
 }
 
 /* EOF */
@@ -81,6 +81,18 @@ public:
 	void findNearestNeighbors(vector<float>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(vector<double>* query, std::vector<int>* resultIndices, unsigned int k = 1);
 	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, unsigned int k = 1);
+	void findNearestNeighbors(Point3D* query, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNeighborsWithinRadius(Point3D* query, double radius, std::vector<int>* resultIndices, std::vector<double>* resultDistances = 0);
+	void findNearestNeighbors(vector< vector<double> >* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+	void findNearestNeighbors(PointCloud3D* queries, std::vector<int>* resultIndices, std::vector<double>* resultDistances, unsigned int k = 1);
+
+	/**
+	 * @brief Concurrent queries are not supported: every STANN k-NN search writes the eps member and the search buffers of the shared sfcnn instance.
+	 */
+	bool supportsConcurrentQueries() const;
+
+	/// Number of nearest neighbors that is initially queried by findNeighborsWithinRadius(). It is doubled until the radius is covered.
+	static const unsigned int initialRadiusSearchNeighbors;
 
 protected:
 
@@ -93,6 +105,9 @@ protected:
 	/// Point 3D data in STANN-like format
 	vector<STANNPoint3D>* points3D;
 
+	/// Number of points that have been passed via setData(PointCloud3D*)
+	unsigned int numberOfPoints3D;
+
 	/// Point data in STANN-like format for arbitrary dimensions
 	vector<STANNPoint>* points;
 
@@ -102,6 +117,18 @@ protected:
 	/// Vector with the resulting distances (should be only one distance). STANN search method returns this as the squared distance.
 	vector <double>* squaredResultDistances;
 
+	/**
+	 * @brief Copy the result of one query of a batch into the flat result arrays.
+	 * @param foundIndices Indices as returned by STANN.
+	 * @param foundSquaredDistances Squared distances as returned by STANN.
+	 * @param queryIndex Position of the query in the batch.
+	 * @param k Number of nearest neighbors per query.
+	 * @param[out] resultIndices Flat array of indices with sufficient size, see INearestNeighbor::findNearestNeighbors().
+	 * @param[out] resultDistances Flat array of distances with sufficient size or null.
+	 */
+	void storeBatchResult(const vector<long unsigned int>& foundIndices, const vector<double>& foundSquaredDistances,
+			unsigned int queryIndex, unsigned int k, std::vector<int>* resultIndices, std::vector<double>* resultDistances);
+
 };
 
 }
@@ -23,6 +23,8 @@
 #include "brics_3d/algorithm/registration/IPointCorrespondence.h"
 #include "brics_3d/algorithm/registration/IRigidTransformationEstimation.h"
 
+#include <vector>
+
 namespace brics_3d {
 
 /**
@@ -32,6 +34,24 @@ namespace brics_3d {
 class IIterativeClosestPointSetup {
 public:
 
+	/**
+	 * @brief Parameters of one level of a coarse-to-fine (pyramid) ICP.
+	 */
+	class ResolutionLevel {
+	public:
+		ResolutionLevel(double voxelSize = 0.0, int maxIterations = 20, double convergenceThreshold = 0.00001) :
+			voxelSize(voxelSize), maxIterations(maxIterations), convergenceThreshold(convergenceThreshold) {};
+
+		/// Edge length of the voxel grid that model and data are downsampled with. 0 means full resolution.
+		double voxelSize;
+
+		/// Maximum amount of iterations on this level.
+		int maxIterations;
+
+		/// The threshold to define convergence on this level.
+		double convergenceThreshold;
+	};
+
 	/**
 	 * @brief Standard constructor
 	 */
@@ -89,6 +109,23 @@ public:
 	 * @return Read-only pointer to transformation estimator
 	 */
 	virtual IRigidTransformationEstimation* getEstimator() const = 0;
+
+	/**
+	 * @brief Set the levels of a coarse-to-fine ICP.
+	 *
+	 * The levels are processed in the given order, so the coarsest level comes first. Each level continues
+	 * with the transformation accumulated so far. An empty vector (default) disables the pyramid: all
+	 * iterations run on the full resolution with maxIterations and convergenceThreshold.
+	 *
+	 * @param resolutionLevels The schedule of voxel sizes, iterations and convergence thresholds.
+	 */
+	virtual void setResolutionLevels(const std::vector<ResolutionLevel>& resolutionLevels) = 0;
+
+	/**
+	 * @brief Get the levels of a coarse-to-fine ICP.
+	 * @return The schedule of voxel sizes, iterations and convergence thresholds. Empty if the pyramid is disabled.
+	 */
+	virtual const std::vector<ResolutionLevel>& getResolutionLevels() const = 0;
 };
 
 }
@@ -60,6 +60,17 @@ public:
 	 */
 	virtual double estimateTransformation(std::vector<CorrespondencePoint3DPair>* pointPairs, IHomogeneousMatrix44* resultTransformation) = 0;
 
+	/**
+	 * @brief Announce the model (first point cloud) of the following correspondences.
+	 *
+	 * The ICP calls this before the point pairs of a model are passed to estimateTransformation(). Estimators that
+	 * need additional data of the model, like normals, can prepare it here and look it up via
+	 * CorrespondencePoint3DPair::firstIndex. The default implementation does nothing.
+	 *
+	 * @param[in] model The model point cloud.
+	 */
+	virtual void prepareModel(PointCloud3D* model) {};
+
 };
 
 }
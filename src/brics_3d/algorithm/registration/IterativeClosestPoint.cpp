@@ -19,6 +19,7 @@
 
 #include "IterativeClosestPoint.h"
 #include "brics_3d/core/HomogeneousMatrix44.h" //TODO? now it depends  on implementation of HomogeneousMatrix44
+#include "brics_3d/algorithm/filtering/VoxelGridFilter.h"
 #include <cmath>
 #include <assert.h>
 #include <stdexcept>
@@ -40,6 +41,9 @@ IterativeClosestPoint::IterativeClosestPoint() {
 	this->data = 0;
 	this->intermadiateTransformation = 0;
 	this->resultTransformation = 0;
+
+	this->icpResultError = 0.0;
+	this->icpresultIterations = 0;
 }
 
 IterativeClosestPoint::IterativeClosestPoint(IPointCorrespondence *assigner, IRigidTransformationEstimation *estimator, double convergenceThreshold, int maxIterations) {
@@ -53,6 +57,9 @@ IterativeClosestPoint::IterativeClosestPoint(IPointCorrespondence *assigner, IRi
 	this->data = 0;
 	this->intermadiateTransformation = 0;
 	this->resultTransformation = 0;
+
+	this->icpResultError = 0.0;
+	this->icpresultIterations = 0;
 }
 
 IterativeClosestPoint::~IterativeClosestPoint() {
@@ -79,12 +86,52 @@ void IterativeClosestPoint::match(PointCloud3D* model, PointCloud3D* data, IHomo
 	assert(model != 0); // check input parameters
 	assert(data != 0);
 
+	if (resolutionLevels.empty()) {
+		icpResultError = matchLevel(model, data, resultTransformation, maxIterations, convergenceThreshold, icpresultIterations);
+		LOG(DEBUG) << "RMS Error is: " << icpResultError; //DBG output
+		return;
+	}
+
+	/* coarse-to-fine: each level starts where the previous one stopped, as data is transformed in place */
+	VoxelGridFilter downsampler;
+	icpResultError = 0.0;
+	icpresultIterations = 0;
+	for (unsigned int level = 0; level < resolutionLevels.size(); ++level) {
+		const ResolutionLevel& parameters = resolutionLevels[level];
+		int iterations = 0;
+
+		if (parameters.voxelSize <= 0.0) { // full resolution
+			icpResultError = matchLevel(model, data, resultTransformation, parameters.maxIterations, parameters.convergenceThreshold, iterations);
+		} else {
+			PointCloud3D levelModel;
+			PointCloud3D levelData;
+			downsampler.setVoxelSize(parameters.voxelSize);
+			downsampler.filter(model, &levelModel);
+			downsampler.filter(data, &levelData);
+
+			IHomogeneousMatrix44* levelTransformation = new HomogeneousMatrix44();
+			icpResultError = matchLevel(&levelModel, &levelData, levelTransformation, parameters.maxIterations, parameters.convergenceThreshold, iterations);
+			data->homogeneousTransformation(levelTransformation);
+			*resultTransformation = *((*levelTransformation) * (*resultTransformation)); // accumulate transformations
+			delete levelTransformation;
+		}
+
+		LOG(DEBUG) << "ICP level " << level << " (voxel size " << parameters.voxelSize << "): " << iterations << " iterations, RMS Error is: " << icpResultError;
+		icpresultIterations += iterations;
+	}
+}
+
+double IterativeClosestPoint::matchLevel(PointCloud3D* model, PointCloud3D* data, IHomogeneousMatrix44* resultTransformation,
+		int maxIterations, double convergenceThreshold, int& iterations) {
 	double error = 0.0;
 	double previousError = 0.0;
 	double previousPreviousError = 0.0;
+	iterations = maxIterations;
 
 	IHomogeneousMatrix44* tmpResultTransformation = new HomogeneousMatrix44();
+	HomogeneousMatrix44 accumulatedTransformation;
 	std::vector<CorrespondencePoint3DPair>* pointPairs = new std::vector<CorrespondencePoint3DPair>();
+	estimator->prepareModel(model);
 
 	/* perform generic ICP */
 	for (int i = 0; i < maxIterations; ++i) {
@@ -97,7 +144,8 @@ void IterativeClosestPoint::match(PointCloud3D* model, PointCloud3D* data, IHomo
 		/* estimate transformation */
 		error = estimator->estimateTransformation(pointPairs, tmpResultTransformation);
 //		cout << "Estimated transformation: " << endl  << *tmpResultTransformation; //DBG output
-		*resultTransformation = *((*resultTransformation) * (*tmpResultTransformation)); // accumulate transformations
+		accumulatedTransformation = *tmpResultTransformation; // the new transformation is applied after the previous ones
+		*resultTransformation = *(accumulatedTransformation * (*resultTransformation)); // accumulate transformations
 
 		/* perform transformation on data point cloud */
 		data->homogeneousTransformation(tmpResultTransformation);
@@ -106,16 +154,14 @@ void IterativeClosestPoint::match(PointCloud3D* model, PointCloud3D* data, IHomo
 		if ((std::abs(error - previousError) < convergenceThreshold) &&
 				(std::abs(error - previousPreviousError) < convergenceThreshold)) {
 			LOG(DEBUG) << "ICP converged after " << i << " iterations. "; //DBG output
-			icpresultIterations = i;//benchmark only
+			iterations = i;
 			break;
 		}
 	}
 
-	LOG(DEBUG) << "RMS Error is: " << error; //DBG output
-	icpResultError = error;//benchmark only
 	delete pointPairs;
 	delete tmpResultTransformation;
-
+	return error;
 }
 
 
@@ -163,6 +209,25 @@ void IterativeClosestPoint::setMaxIterations(int maxIterations)
 }
 
 
+void IterativeClosestPoint::setResolutionLevels(const std::vector<ResolutionLevel>& resolutionLevels) {
+	for (unsigned int i = 0; i < resolutionLevels.size(); ++i) {
+		if (resolutionLevels[i].voxelSize < 0.0) {
+			throw runtime_error("ERROR: voxelSize of an ICP resolution level cannot be less than 0.");
+		}
+		if (resolutionLevels[i].maxIterations < 0) {
+			throw runtime_error("ERROR: maxIterations of an ICP resolution level cannot be less than 0.");
+		}
+		if (resolutionLevels[i].convergenceThreshold < 0.0) {
+			throw runtime_error("ERROR: convergenceThreshold of an ICP resolution level cannot be less than 0.");
+		}
+	}
+	this->resolutionLevels = resolutionLevels;
+}
+
+const std::vector<IterativeClosestPoint::ResolutionLevel>& IterativeClosestPoint::getResolutionLevels() const {
+	return resolutionLevels;
+}
+
 void IterativeClosestPoint::setData(PointCloud3D* data) {
 	this->data = data;
 }
@@ -200,11 +265,14 @@ double IterativeClosestPoint::performNextIteration() {
 
 	/* find closest points */
 	assigner->createNearestNeighborCorrespondence(this->model, this->data, pointPairs);
+	estimator->prepareModel(this->model);
 
 	/* estimate transformation */
 	error = estimator->estimateTransformation(pointPairs, this->intermadiateTransformation);
 	//cout << "Estimated transformation: " << endl  << *tmpResultTransformation; //DBG output
-	*(this->resultTransformation) = *((*(this->resultTransformation)) * (*(this->intermadiateTransformation))); // accumulate transformations
+	HomogeneousMatrix44 accumulatedTransformation;
+	accumulatedTransformation = *(this->intermadiateTransformation); // the new transformation is applied after the previous ones
+	*(this->resultTransformation) = *(accumulatedTransformation * (*(this->resultTransformation))); // accumulate transformations
 
 	/* perform transformation on data point cloud */
 	this->data->homogeneousTransformation(this->intermadiateTransformation);
@@ -36,6 +36,11 @@ namespace brics_3d {
  * This class serves a generic implementation of the Iterative Closest Point Algorithm.
  * It follows the "strategy" software design pattern (except that context and strategy are implemented in the same class).
  * That means the actual point correspondence and the rigid transformation estimation algorithms are exchangeable during runtime.
+ *
+ * If resolution levels are set (see setResolutionLevels()), match() works coarse-to-fine: for every level
+ * model and data are downsampled with a VoxelGridFilter, the ICP runs on the reduced clouds and the
+ * resulting transformation is applied to the full data before the next level starts. Thus most iterations
+ * are spent on few points and only the last levels work on the full resolution.
  */
 class IterativeClosestPoint : public IIterativeClosestPoint, public IIterativeClosestPointSetup, public IIterativeClosestPointDetailed {
 public:
@@ -73,6 +78,10 @@ public:
 
 	IRigidTransformationEstimation* getEstimator() const;
 
+	void setResolutionLevels(const std::vector<ResolutionLevel>& resolutionLevels);
+
+	const std::vector<ResolutionLevel>& getResolutionLevels() const;
+
 	void setData(PointCloud3D* data);
 
 	void setModel(PointCloud3D* model);
@@ -91,6 +100,19 @@ public:
 
 private:
 
+	/**
+	 * @brief Run the ICP iterations of a single resolution level.
+	 * @param model The model point cloud.
+	 * @param data The data point cloud. It will be transformed.
+	 * @param[in,out] resultTransformation The estimated transformations are accumulated here.
+	 * @param maxIterations Maximum amount of iterations.
+	 * @param convergenceThreshold The threshold to define convergence.
+	 * @param[out] iterations The number of performed iterations.
+	 * @return The RMS error of the last iteration.
+	 */
+	double matchLevel(PointCloud3D* model, PointCloud3D* data, IHomogeneousMatrix44* resultTransformation,
+			int maxIterations, double convergenceThreshold, int& iterations);
+
 	///Pointer to point-to-point assigner strategy
 	IPointCorrespondence* assigner;
 
@@ -103,6 +125,9 @@ private:
 	/// The threshold to define convergence.
 	double convergenceThreshold;
 
+	/// Levels of the coarse-to-fine ICP. Empty if disabled.
+	std::vector<ResolutionLevel> resolutionLevels;
+
 	///Pointer to the model for the stateful interface (IIterativeClosestPointDetailed)
 	PointCloud3D* model;
 
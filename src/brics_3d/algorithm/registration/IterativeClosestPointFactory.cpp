@@ -26,10 +26,13 @@
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationAPX.h"
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationQUAT.h"
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationORTHO.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationPointToPlane.h"
+#include "brics_3d/core/Logger.h"
 
 
 #include <iostream>
 #include <sstream>
+#include <assert.h>
 
 using std::cout;
 using std::cerr;
@@ -122,6 +125,10 @@ IIterativeClosestPointPtr IterativeClosestPointFactory::createIterativeClosestPo
 				estimator = new RigidTransformationEstimationORTHO();
 				summary << "#  Subalgorithm: " << subalgorithm << endl;
 
+			} else if (subalgorithm.compare("RigidTransformationEstimationPointToPlane") == 0) {
+				estimator = new RigidTransformationEstimationPointToPlane();
+				summary << "#  Subalgorithm: " << subalgorithm << endl;
+
 //			} else if (...) {	//add more implementation here
 
 			} else {
@@ -168,9 +175,24 @@ IIterativeClosestPointPtr IterativeClosestPointFactory::createIterativeClosestPo
 		icpConfigurator->setConvergenceThreshold(convergenceThreshold);
 	}
 
+	string resolutionLevelsDescription;
+	if (configReader.getAttribute("IterativeClosestPoint", "resolutionLevels", &resolutionLevelsDescription)) {
+		std::vector<IIterativeClosestPointSetup::ResolutionLevel> resolutionLevels;
+		if (parseResolutionLevels(resolutionLevelsDescription, &resolutionLevels)) {
+			icpConfigurator->setResolutionLevels(resolutionLevels);
+		} else {
+			LOG(WARNING) << "Malformed resolutionLevels. Factory will provide default configuration: full resolution only";
+		}
+	}
+
 	summary << "#" << endl << "# Parameters:" << endl;
 	summary << "#  maxIterations = " << icpConfigurator->getMaxIterations() << endl;
 	summary << "#  convergenceThreshold = " << icpConfigurator->getConvergenceThreshold() << endl;
+	for (unsigned int i = 0; i < icpConfigurator->getResolutionLevels().size(); ++i) {
+		const IIterativeClosestPointSetup::ResolutionLevel& level = icpConfigurator->getResolutionLevels()[i];
+		summary << "#  resolutionLevel[" << i << "] = voxelSize " << level.voxelSize << ", maxIterations " << level.maxIterations
+				<< ", convergenceThreshold " << level.convergenceThreshold << endl;
+	}
 	summary << "#" << endl << "###########################################################" << endl;
 
 	LOG(INFO) << "Summary: " << std::endl << summary.str();
@@ -183,6 +205,29 @@ IIterativeClosestPointSetupPtr IterativeClosestPointFactory::getIcpSetupHandle()
 	return this->icpConfigurator;
 }
 
+bool IterativeClosestPointFactory::parseResolutionLevels(std::string description, std::vector<IIterativeClosestPointSetup::ResolutionLevel>* resolutionLevels) {
+	assert(resolutionLevels != 0);
+	resolutionLevels->clear();
+
+	std::stringstream levels(description);
+	string levelDescription;
+	while (std::getline(levels, levelDescription, ';')) {
+		if (levelDescription.find_first_not_of(" \t\n") == string::npos) { // allow a trailing separator
+			continue;
+		}
+		std::stringstream levelStream(levelDescription);
+		IIterativeClosestPointSetup::ResolutionLevel level;
+		string remainder;
+		if (!(levelStream >> level.voxelSize >> level.maxIterations >> level.convergenceThreshold) || (levelStream >> remainder) ||
+				level.voxelSize < 0.0 || level.maxIterations < 0 || level.convergenceThreshold < 0.0) {
+			resolutionLevels->clear();
+			return false;
+		}
+		resolutionLevels->push_back(level);
+	}
+	return true;
+}
+
 
 }
 
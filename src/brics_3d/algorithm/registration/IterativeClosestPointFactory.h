@@ -24,6 +24,7 @@
 #include "brics_3d/algorithm/registration/IIterativeClosestPoint.h"
 #include "brics_3d/algorithm/registration/IIterativeClosestPointSetup.h"
 #include <string>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
@@ -77,6 +78,11 @@ public:
      * </BRICS_3D-Configuration>
 	 * </code>
 	 * <br><br>
+	 * The optional attribute <code>resolutionLevels</code> of the IterativeClosestPoint element enables the coarse-to-fine ICP
+	 * (see IIterativeClosestPointSetup::setResolutionLevels()). It lists the levels from coarse to fine, separated by semicolons.
+	 * Each level consists of voxel size, maximum iterations and convergence threshold, e.g.<br>
+	 * <code>resolutionLevels="0.2 10 0.001; 0.05 10 0.0001; 0 5 0.00001"</code>
+	 * <br><br>
 	 * <b>NOTE1:</b> The current implementation of the <code>ConfigurationFileHandlerTest</code> configuration file parser bases on the Xerces library.
 	 * If it is not installed the default configuration is choosen.<br>
 	 */
@@ -89,6 +95,14 @@ public:
 	 */
 	IIterativeClosestPointSetupPtr getIcpSetupHandle();
 
+	/**
+	 * @brief Parse the resolution levels of a coarse-to-fine ICP.
+	 * @param[in] description Levels separated by semicolons. Each level is given as "voxelSize maxIterations convergenceThreshold".
+	 * @param[out] resolutionLevels The parsed levels. Previous content will be overwritten.
+	 * @return False if the description is malformed. In this case resolutionLevels is empty.
+	 */
+	static bool parseResolutionLevels(std::string description, std::vector<IIterativeClosestPointSetup::ResolutionLevel>* resolutionLevels);
+
 private:
 
 	IIterativeClosestPointSetupPtr icpConfigurator;
@@ -18,18 +18,28 @@
 ******************************************************************************/
 
 #include "PointCorrespondenceGenericNN.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 namespace brics_3d {
 
+const unsigned int PointCorrespondenceGenericNN::minQueriesPerThread = 1000;
+
 PointCorrespondenceGenericNN::PointCorrespondenceGenericNN() {
 	this->nearestNeighborAlgorithm = 0;
-
+	this->cachedModel = 0;
+	this->numberOfThreads = 1;
 }
 
 PointCorrespondenceGenericNN::PointCorrespondenceGenericNN(INearestPoint3DNeighbor* nearestNeighborAlgorithm) {
     this->nearestNeighborAlgorithm = nearestNeighborAlgorithm;
+    this->cachedModel = 0;
+    this->numberOfThreads = 1;
 }
 
 PointCorrespondenceGenericNN::~PointCorrespondenceGenericNN() {
@@ -48,26 +58,89 @@ void PointCorrespondenceGenericNN::createNearestNeighborCorrespondence(PointClou
 
 	resultPointPairs->clear();
 
-	/* prepare data */
-	nearestNeighborAlgorithm->setData(pointCloud1);
+	/* prepare data: only (re)build the search structure if the model has changed */
+	PointCloud3D::PackedCoordinatesConstPtr modelCoordinates = pointCloud1->getPackedCoordinates();
+	if (pointCloud1 != cachedModel || modelCoordinates != cachedModelCoordinates) {
+		nearestNeighborAlgorithm->setData(pointCloud1);
+		cachedModel = pointCloud1;
+		cachedModelCoordinates = pointCloud1->getPackedCoordinates();
+	}
 
 	/* search for each point in pointCloud2 */
+	PointCloud3D::PackedCoordinatesConstPtr packedPointCloud2 = pointCloud2->getPackedCoordinates();
+	unsigned int numberOfQueries = pointCloud2->getSize();
+
+	unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfQueries, minQueriesPerThread);
+	if (threadCount <= 1 || !nearestNeighborAlgorithm->supportsConcurrentQueries()) {
+
+		/* serial search: query all points at once to avoid the per query overhead */
+		vector<int> resultIndices;
+		nearestNeighborAlgorithm->findNearestNeighbors(pointCloud2, &resultIndices, 0, 1);
+		resultPointPairs->reserve(numberOfQueries);
+		for (unsigned int i = 0; i < numberOfQueries; i++) {
+			int resultIndex = resultIndices[i];
+			if (resultIndex < 0) {
+				continue;
+			}
+			assert (resultIndex < static_cast<int>(cachedModelCoordinates->size() / 3)); //plausibility check if result is in range
+
+			Point3D firstPoint = Point3D ((*cachedModelCoordinates)[3 * resultIndex + 0],
+					(*cachedModelCoordinates)[3 * resultIndex + 1],
+					(*cachedModelCoordinates)[3 * resultIndex + 2]);
+			Point3D secondPoint = Point3D ((*packedPointCloud2)[3 * i + 0], (*packedPointCloud2)[3 * i + 1], (*packedPointCloud2)[3 * i + 2]);
+
+			CorrespondencePoint3DPair foundPair(firstPoint, secondPoint, resultIndex, static_cast<int>(i));
+			resultPointPairs->push_back(foundPair);
+		}
+		return;
+	}
+
+	/* each thread works on a contiguous range with its own result buffer */
+	std::vector< std::vector<CorrespondencePoint3DPair> > threadResults(threadCount);
+	boost::thread_group workers;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		unsigned int begin = 0;
+		unsigned int end = 0;
+		ParallelExecution::getRange(numberOfQueries, threadCount, threadNum, begin, end);
+		threadResults[threadNum].reserve(end - begin);
+		workers.create_thread(boost::bind(&PointCorrespondenceGenericNN::findCorrespondences, this,
+				packedPointCloud2.get(), begin, end, &threadResults[threadNum]));
+	}
+	workers.join_all();
+
+	/* merge in the order of the ranges, so the result equals the one of the serial search */
+	unsigned int resultSize = 0;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		resultSize += static_cast<unsigned int>(threadResults[threadNum].size());
+	}
+	resultPointPairs->reserve(resultSize);
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		resultPointPairs->insert(resultPointPairs->end(), threadResults[threadNum].begin(), threadResults[threadNum].end());
+	}
+	LOG(DEBUG) << "PointCorrespondenceGenericNN: " << resultSize << " correspondences found by " << threadCount << " threads.";
+}
+
+void PointCorrespondenceGenericNN::findCorrespondences(const std::vector<double>* data, unsigned int begin, unsigned int end,
+		std::vector<CorrespondencePoint3DPair>* resultPointPairs) {
+
 	vector<int> resultIndices;
 	int resultIndex;
 	int k = 1; //only the nearest neighbor is considered
 
-	for (unsigned int i = 0; i < pointCloud2->getSize(); i++) {
+	for (unsigned int i = begin; i < end; i++) {
 
-		nearestNeighborAlgorithm->findNearestNeighbors( &(*pointCloud2->getPointCloud())[i], &resultIndices, k);
+		Point3D secondPoint = Point3D ((*data)[3 * i + 0], (*data)[3 * i + 1], (*data)[3 * i + 2]);
+		nearestNeighborAlgorithm->findNearestNeighbors(&secondPoint, &resultIndices, k);
 
 		if (resultIndices.size() > 0) {
 			resultIndex = resultIndices[0];
-			assert (resultIndex < static_cast<int>(pointCloud1->getSize())); //plausibility check if result is in range
+			assert (resultIndex < static_cast<int>(cachedModelCoordinates->size() / 3)); //plausibility check if result is in range
 
-			Point3D firstPoint = Point3D (&((*pointCloud1->getPointCloud())[resultIndex]));
-			Point3D secondPoint = Point3D (&((*pointCloud2->getPointCloud())[i]));
+			Point3D firstPoint = Point3D ((*cachedModelCoordinates)[3 * resultIndex + 0],
+					(*cachedModelCoordinates)[3 * resultIndex + 1],
+					(*cachedModelCoordinates)[3 * resultIndex + 2]); // avoid getPointCloud() as it would invalidate the model cache
 
-			CorrespondencePoint3DPair foundPair(firstPoint, secondPoint);
+			CorrespondencePoint3DPair foundPair(firstPoint, secondPoint, resultIndex, static_cast<int>(i));
 			resultPointPairs->push_back(foundPair);
 		}
 	}
@@ -79,6 +152,21 @@ INearestPoint3DNeighbor* PointCorrespondenceGenericNN::getNearestNeighborAlgorit
 
 void PointCorrespondenceGenericNN::setNearestNeighborAlgorithm(INearestPoint3DNeighbor* nearestNeighborAlgorithm) {
 	this->nearestNeighborAlgorithm = nearestNeighborAlgorithm;
+	invalidateModelCache();
+}
+
+void PointCorrespondenceGenericNN::invalidateModelCache() {
+	cachedModel = 0;
+	cachedModelCoordinates.reset();
+}
+
+unsigned int PointCorrespondenceGenericNN::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void PointCorrespondenceGenericNN::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
 }
 
 }
@@ -28,6 +28,15 @@ namespace brics_3d {
 /**
  * @ingroup registration
  * @brief Implementation of correspondence problem for points using generic nearest neighbor search
+ *
+ * The search structure is only rebuilt (via INearestPoint3DNeighbor::setData()) if the first
+ * point cloud (the model) differs from the previous invocation or has been modified since then.
+ *
+ * The queries of the second point cloud (the data) can be distributed among several worker threads
+ * (see setNumberOfThreads()), given that the nearest neighbor search strategy supports concurrent
+ * queries (see INearestPoint3DNeighbor::supportsConcurrentQueries()). Otherwise the search is serial.
+ * Each thread processes a contiguous range of the data with a separate result buffer. The buffers are
+ * concatenated in the order of the ranges, thus the result is identical to the one of a serial search.
  */
 class PointCorrespondenceGenericNN: public brics_3d::IPointCorrespondence {
 public:
@@ -62,10 +71,50 @@ public:
 	 */
 	void setNearestNeighborAlgorithm(INearestPoint3DNeighbor* nearestNeighborAlgorithm);
 
+	/**
+	 * @brief Force a rebuild of the search structure with the next query.
+	 */
+	void invalidateModelCache();
+
+	/**
+	 * @brief Get the number of worker threads for the correspondence search.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads for the correspondence search.
+	 * @param numberOfThreads Number of threads. 1 means serial search (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Minimal number of queries that are assigned to a worker thread. Smaller data is processed by fewer threads.
+	static const unsigned int minQueriesPerThread;
+
 private:
 
+	/**
+	 * @brief Find correspondences for a range of the data points.
+	 * @param data Packed data coordinates.
+	 * @param begin Index of the first query point.
+	 * @param end Index behind the last query point.
+	 * @param[out] resultPointPairs Found correspondences will be appended.
+	 */
+	void findCorrespondences(const std::vector<double>* data, unsigned int begin, unsigned int end,
+			std::vector<CorrespondencePoint3DPair>* resultPointPairs);
+
 	/// Internal handle to the nearest neighbor search strategy
 	INearestPoint3DNeighbor* nearestNeighborAlgorithm;
+
+	/// The model point cloud that was last passed to the nearest neighbor search strategy
+	PointCloud3D* cachedModel;
+
+	/// Packed coordinates of the cached model. Used to detect modifications.
+	PointCloud3D::PackedCoordinatesConstPtr cachedModelCoordinates;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
 };
 
 }
@@ -18,25 +18,37 @@
 ******************************************************************************/
 
 #include "brics_3d/algorithm/registration/PointCorrespondenceKDTree.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
 
-#define MAX_OPENMP_NUM_THREADS 4
+#ifndef MAX_OPENMP_NUM_THREADS
+#error "MAX_OPENMP_NUM_THREADS has to be defined by the build system with the same value as for the 6dslam library."
+#endif
 #include "6dslam/src/d2tree.h"
 #include "6dslam/src/kd.h"
 #include "6dslam/src/kdc.h"
 
 #include <iostream>
+#include <algorithm>
 #include <assert.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 using std::cout;
 using std::endl;
 namespace brics_3d {
 
-PointCorrespondenceKDTree::PointCorrespondenceKDTree() {
+const unsigned int PointCorrespondenceKDTree::maxNumberOfThreads = MAX_OPENMP_NUM_THREADS;
+
+const unsigned int PointCorrespondenceKDTree::minQueriesPerThread = 1000;
 
+PointCorrespondenceKDTree::PointCorrespondenceKDTree() {
+	this->cachedModel = 0;
+	this->numberOfThreads = 1;
 }
 
 PointCorrespondenceKDTree::~PointCorrespondenceKDTree() {
-
+	invalidateModelCache();
 }
 
 void PointCorrespondenceKDTree::createNearestNeighborCorrespondence(PointCloud3D* pointCloud1, PointCloud3D* pointCloud2, std::vector<CorrespondencePoint3DPair>* resultPointPairs) {
@@ -44,63 +56,111 @@ void PointCorrespondenceKDTree::createNearestNeighborCorrespondence(PointCloud3D
 	assert(pointCloud2 != 0);
 	assert(resultPointPairs != 0);
 
-	double *centroid_m = new double[3];
-	double *centroid_d = new double[3];
-	double maxMatchingDistance = 50;
-
 	resultPointPairs->clear();
 
+	if (pointCloud1->getSize() == 0) {
+		return;
+	}
+
 	/* prepare data */
-	double** pointCloud1Points = new double*[pointCloud1->getSize()];
-	for (unsigned int i = 0; i < pointCloud1->getSize(); i++) {
-		pointCloud1Points[i] = new double[3];
-		pointCloud1Points[i][0] = (*pointCloud1->getPointCloud())[i].getX();
-		pointCloud1Points[i][1] = (*pointCloud1->getPointCloud())[i].getY();
-		pointCloud1Points[i][2] = (*pointCloud1->getPointCloud())[i].getZ();
+	updateModelCache(pointCloud1);
+
+	PointCloud3D::PackedCoordinatesConstPtr packedPointCloud2 = pointCloud2->getPackedCoordinates();
+	unsigned int numberOfQueries = pointCloud2->getSize();
+
+	unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfQueries, minQueriesPerThread);
+	if (threadCount <= 1) {
+		findCorrespondences(packedPointCloud2.get(), 0, numberOfQueries, 0, resultPointPairs);
+		return;
+	}
+
+	/* each thread works on a contiguous range with its own result buffer */
+	std::vector< std::vector<CorrespondencePoint3DPair> > threadResults(threadCount);
+	boost::thread_group workers;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		unsigned int begin = 0;
+		unsigned int end = 0;
+		ParallelExecution::getRange(numberOfQueries, threadCount, threadNum, begin, end);
+		threadResults[threadNum].reserve(end - begin);
+		workers.create_thread(boost::bind(&PointCorrespondenceKDTree::findCorrespondences, this,
+				packedPointCloud2.get(), begin, end, static_cast<int>(threadNum), &threadResults[threadNum]));
+	}
+	workers.join_all();
+
+	/* merge in the order of the ranges, so the result equals the one of the serial search */
+	unsigned int resultSize = 0;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		resultSize += static_cast<unsigned int>(threadResults[threadNum].size());
 	}
+	resultPointPairs->reserve(resultSize);
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		resultPointPairs->insert(resultPointPairs->end(), threadResults[threadNum].begin(), threadResults[threadNum].end());
+	}
+	LOG(DEBUG) << "PointCorrespondenceKDTree: " << resultSize << " correspondences found by " << threadCount << " threads.";
+}
 
-	KDtree* kDTree = new KDtree(pointCloud1Points, pointCloud1->getSize());
-//	cout << "k-d tree created" << endl;
+void PointCorrespondenceKDTree::findCorrespondences(const std::vector<double>* data, unsigned int begin, unsigned int end,
+		int threadNum, std::vector<CorrespondencePoint3DPair>* resultPointPairs) {
 
-//	unsigned int numpts_target;
-//	KDtree *kd = 0;
-//	kd = new KDtree(Source->points_red, Source->points_red_size);
-//	numpts_target = Target->points_red_size;
+	double maxMatchingDistance = 50;
 
-	for (unsigned int i = 0; i < pointCloud2->getSize(); i++) {
+	for (unsigned int i = begin; i < end; i++) {
 		//if (rnd > 1 && rand(rnd) != 0) continue;  // take about 1/rnd-th of the numbers only
 
 		double queryPoint[3];
-		queryPoint[0] = (*pointCloud2->getPointCloud())[i].getX();
-		queryPoint[1] = (*pointCloud2->getPointCloud())[i].getY();
-		queryPoint[2] = (*pointCloud2->getPointCloud())[i].getZ();
+		queryPoint[0] = (*data)[3 * i + 0];
+		queryPoint[1] = (*data)[3 * i + 1];
+		queryPoint[2] = (*data)[3 * i + 2];
 
-		double *closest = kDTree->FindClosest(queryPoint, maxMatchingDistance, 0);
+		double *closest = kDTree->FindClosest(queryPoint, maxMatchingDistance, threadNum);
 		if (closest) {
-			centroid_m[0] += queryPoint[0];
-			centroid_m[1] += queryPoint[1];
-			centroid_m[2] += queryPoint[2];
-			centroid_d[0] += closest[0];
-			centroid_d[1] += closest[1];
-			centroid_d[2] += closest[2];
-
 			Point3D firstPoint = Point3D (closest[0], closest[1], closest[2]);
 			Point3D secondPoint = Point3D (queryPoint[0], queryPoint[1], queryPoint[2]);
 
-			CorrespondencePoint3DPair foundPair(firstPoint, secondPoint);
+			int firstIndex = static_cast<int>((closest - &(*cachedModelCoordinates)[0]) / 3); // the k-d tree points into the packed coordinates
+			CorrespondencePoint3DPair foundPair(firstPoint, secondPoint, firstIndex, static_cast<int>(i));
 			resultPointPairs->push_back(foundPair);
 		}
 	}
-//	centroid_m[0] /= pairs[thread_num].size();
-//	centroid_m[1] /= pairs[thread_num].size();
-//	centroid_m[2] /= pairs[thread_num].size();
-//	centroid_d[0] /= pairs[thread_num].size();
-//	centroid_d[1] /= pairs[thread_num].size();
-//	centroid_d[2] /= pairs[thread_num].size();
+}
+
+void PointCorrespondenceKDTree::invalidateModelCache() {
+	kDTree.reset();
+	cachedModel = 0;
+	cachedModelCoordinates.reset();
+	cachedModelPoints.clear();
+}
+
+void PointCorrespondenceKDTree::updateModelCache(PointCloud3D* model) {
+	PointCloud3D::PackedCoordinatesConstPtr modelCoordinates = model->getPackedCoordinates();
+	if (kDTree.get() != 0 && model == cachedModel && modelCoordinates == cachedModelCoordinates) {
+		return; // model has not changed, so we can reuse the k-d tree
+	}
+	invalidateModelCache();
+
+	/* the k-d tree refers to the points, so we let it point into the packed coordinates */
+	cachedModel = model;
+	cachedModelCoordinates = modelCoordinates;
+	cachedModelPoints.resize(model->getSize());
+	for (unsigned int i = 0; i < model->getSize(); i++) {
+		cachedModelPoints[i] = const_cast<double*>(&(*cachedModelCoordinates)[3 * i]); // KDtree does not modify the data
+	}
 
-	delete kDTree;
+	kDTree.reset(new KDtree(&cachedModelPoints[0], static_cast<int>(cachedModelPoints.size())));
+	LOG(DEBUG) << "PointCorrespondenceKDTree: k-d tree created for " << cachedModelPoints.size() << " points.";
+}
 
-	return;
+unsigned int PointCorrespondenceKDTree::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void PointCorrespondenceKDTree::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	if (numberOfThreads > maxNumberOfThreads) {
+		LOG(WARNING) << "PointCorrespondenceKDTree: " << numberOfThreads << " threads requested, but only " << maxNumberOfThreads << " are supported.";
+		numberOfThreads = maxNumberOfThreads;
+	}
+	this->numberOfThreads = numberOfThreads;
 }
 
 }
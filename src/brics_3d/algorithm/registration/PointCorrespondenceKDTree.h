@@ -23,11 +23,31 @@
 
 #include "IPointCorrespondence.h"
 
+#include <boost/scoped_ptr.hpp>
+
+class KDtree;
+
 namespace brics_3d {
 
 /**
  * @ingroup registration
  * @brief Implementation of correspondence problem for points using k-d trees.
+ *
+ * The k-d tree for the first point cloud (the model) is cached. As long as the same, unmodified
+ * model is passed to createNearestNeighborCorrespondence(), the tree is reused. This is the
+ * case for all iterations of the ICP and for repeated matches against the same reference map.
+ * A model counts as modified when its packed coordinates have been invalidated
+ * (see PointCloud3D::getPackedCoordinates()).
+ *
+ * The queries of the second point cloud (the data) can be distributed among several worker threads
+ * (see setNumberOfThreads()). Each thread processes a contiguous range of the data and collects its
+ * correspondences in a separate buffer. The buffers are concatenated in the order of the ranges, thus
+ * the result is identical to the one of a single threaded search.
+ *
+ * <b>NOTE:</b> The search state of the underlying k-d tree implementation is shared by all k-d trees.
+ * Do not let multiple instances of this class search concurrently.
+ *
+ * The class owns its k-d tree, so it is not copyable.
  */
 class PointCorrespondenceKDTree: public brics_3d::IPointCorrespondence {
 public:
@@ -43,6 +63,64 @@ public:
 	virtual ~PointCorrespondenceKDTree();
 
 	void createNearestNeighborCorrespondence(PointCloud3D* pointCloud1, PointCloud3D* pointCloud2, std::vector<CorrespondencePoint3DPair>* resultPointPairs);
+
+	/**
+	 * @brief Discard the cached k-d tree, so it will be rebuilt with the next query.
+	 */
+	void invalidateModelCache();
+
+	/**
+	 * @brief Get the number of worker threads for the correspondence search.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads for the correspondence search.
+	 * @param numberOfThreads Number of threads. 1 means serial search (default). 0 means one thread per available
+	 * hardware thread. The value is limited to maxNumberOfThreads.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Maximum number of concurrent searches supported by the k-d tree implementation.
+	static const unsigned int maxNumberOfThreads;
+
+	/// Minimal number of queries that are assigned to a worker thread. Smaller data is processed by fewer threads.
+	static const unsigned int minQueriesPerThread;
+
+private:
+
+	/**
+	 * @brief Find correspondences for a range of the packed data coordinates.
+	 * @param data Packed data coordinates.
+	 * @param begin Index of the first query point.
+	 * @param end Index behind the last query point.
+	 * @param threadNum Index of the search state slot of the k-d tree. Must be unique for concurrent calls.
+	 * @param[out] resultPointPairs Found correspondences will be appended.
+	 */
+	void findCorrespondences(const std::vector<double>* data, unsigned int begin, unsigned int end, int threadNum,
+			std::vector<CorrespondencePoint3DPair>* resultPointPairs);
+
+	/**
+	 * @brief Make sure the cached k-d tree represents the given model.
+	 * @param model The point cloud that the k-d tree will be built for.
+	 */
+	void updateModelCache(PointCloud3D* model);
+
+	/// The model point cloud that the cached k-d tree has been built for
+	PointCloud3D* cachedModel;
+
+	/// Packed coordinates of the cached model. The k-d tree refers to them.
+	PointCloud3D::PackedCoordinatesConstPtr cachedModelCoordinates;
+
+	/// Pointers into cachedModelCoordinates as required by the k-d tree
+	std::vector<double*> cachedModelPoints;
+
+	/// The cached k-d tree
+	boost::scoped_ptr<KDtree> kDTree;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
 };
 
 }
@@ -0,0 +1,199 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "RigidTransformationEstimationPointToPlane.h"
+#include "brics_3d/core/Logger.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <assert.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/Cholesky>
+
+using std::runtime_error;
+
+namespace brics_3d {
+
+const unsigned int RigidTransformationEstimationPointToPlane::minPointPairs = 6;
+
+RigidTransformationEstimationPointToPlane::RigidTransformationEstimationPointToPlane() {
+	this->cachedModel = 0;
+	this->normalsModel = 0;
+	this->modelNormals = 0;
+	defaultNormalEstimator.setSearchMethod(&defaultSearchMethod);
+	this->normalEstimator = &defaultNormalEstimator;
+}
+
+RigidTransformationEstimationPointToPlane::~RigidTransformationEstimationPointToPlane() {
+
+}
+
+double RigidTransformationEstimationPointToPlane::estimateTransformation(std::vector<CorrespondencePoint3DPair>* pointPairs, IHomogeneousMatrix44* resultTransformation) {
+	assert(pointPairs != 0);
+	assert(resultTransformation != 0);
+	if (packedNormals.empty() && normalsModel != 0) { // used without ICP
+		prepareModel(normalsModel);
+	}
+	if (packedNormals.empty()) {
+		throw runtime_error("ERROR: No model normals available for the point-to-plane estimation. Call prepareModel() first.");
+	}
+	int numberOfNormals = static_cast<int>(packedNormals.size() / 3);
+
+	/* the rotation is linearized around the centroid of the data points for a better conditioning */
+	double centroid[3] = {0.0, 0.0, 0.0};
+	unsigned int numberOfPairs = static_cast<unsigned int>(pointPairs->size());
+	for (unsigned int i = 0; i < numberOfPairs; ++i) {
+		centroid[0] += (*pointPairs)[i].secondPoint.getX();
+		centroid[1] += (*pointPairs)[i].secondPoint.getY();
+		centroid[2] += (*pointPairs)[i].secondPoint.getZ();
+	}
+	if (numberOfPairs > 0) {
+		centroid[0] /= numberOfPairs;
+		centroid[1] /= numberOfPairs;
+		centroid[2] /= numberOfPairs;
+	}
+
+	/*
+	 * Residual of a data point p, its model point q and the model normal n for a small rotation w and translation t:
+	 * r = n.(p - q) + w.((p - c) x n) + n.t
+	 */
+	Eigen::Matrix<double, 6, 6> AtA = Eigen::Matrix<double, 6, 6>::Zero();
+	Eigen::Matrix<double, 6, 1> Atb = Eigen::Matrix<double, 6, 1>::Zero();
+	double squaredError = 0.0;
+	unsigned int usedPairs = 0;
+	for (unsigned int i = 0; i < numberOfPairs; ++i) {
+		const CorrespondencePoint3DPair& pair = (*pointPairs)[i];
+		if (pair.firstIndex < 0 || pair.firstIndex >= numberOfNormals) {
+			continue;
+		}
+		const double* normal = &packedNormals[3 * pair.firstIndex];
+		if (!(normal[0] == normal[0]) || !(normal[1] == normal[1]) || !(normal[2] == normal[2])) { // NaN
+			continue;
+		}
+
+		double p[3] = {pair.secondPoint.getX() - centroid[0], pair.secondPoint.getY() - centroid[1], pair.secondPoint.getZ() - centroid[2]};
+		double distance = normal[0] * (pair.secondPoint.getX() - pair.firstPoint.getX()) +
+				normal[1] * (pair.secondPoint.getY() - pair.firstPoint.getY()) +
+				normal[2] * (pair.secondPoint.getZ() - pair.firstPoint.getZ());
+
+		Eigen::Matrix<double, 6, 1> a;
+		a(0) = p[1] * normal[2] - p[2] * normal[1]; // (p - c) x n
+		a(1) = p[2] * normal[0] - p[0] * normal[2];
+		a(2) = p[0] * normal[1] - p[1] * normal[0];
+		a(3) = normal[0];
+		a(4) = normal[1];
+		a(5) = normal[2];
+
+		AtA += a * a.transpose();
+		Atb -= a * distance;
+		squaredError += distance * distance;
+		usedPairs++;
+	}
+
+	Eigen::Map<Eigen::Matrix4d> result(resultTransformation->setRawData()); // column major as Eigen
+	result.setIdentity();
+	if (usedPairs < minPointPairs) {
+		LOG(WARNING) << "RigidTransformationEstimationPointToPlane: Not enough point pairs with normals (" << usedPairs << ").";
+		return (usedPairs > 0) ? std::sqrt(squaredError / usedPairs) : 0.0;
+	}
+
+	/* solve the normal equations */
+	double damping = 1e-9 * AtA.trace() / 6.0 + 1e-15;
+	for (int i = 0; i < 6; ++i) {
+		AtA(i, i) += damping;
+	}
+	Eigen::Matrix<double, 6, 1> x;
+#ifdef EIGEN3
+	x = AtA.ldlt().solve(Atb);
+#else
+	AtA.ldlt().solve(Atb, &x);
+#endif
+	for (int i = 0; i < 6; ++i) {
+		if (!(x(i) == x(i)) || std::abs(x(i)) > 1e100) {
+			LOG(WARNING) << "RigidTransformationEstimationPointToPlane: Normal equations could not be solved.";
+			return std::sqrt(squaredError / usedPairs);
+		}
+	}
+
+	/* back to a rigid transformation: rotation around the centroid, then translation */
+	Eigen::Vector3d rotationVector(x(0), x(1), x(2));
+	Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+	double angle = rotationVector.norm();
+	if (angle > 0.0) {
+		rotation = Eigen::AngleAxis<double>(angle, rotationVector / angle).toRotationMatrix();
+	}
+	Eigen::Vector3d c(centroid[0], centroid[1], centroid[2]);
+	Eigen::Vector3d translation = c - rotation * c + Eigen::Vector3d(x(3), x(4), x(5));
+
+	result.block<3,3>(0,0) = rotation;
+	result.block<3,1>(0,3) = translation;
+
+	return std::sqrt(squaredError / usedPairs);
+}
+
+void RigidTransformationEstimationPointToPlane::prepareModel(PointCloud3D* model) {
+	assert(model != 0);
+	PointCloud3D::PackedCoordinatesConstPtr modelCoordinates = model->getPackedCoordinates();
+	if (!packedNormals.empty() && model == cachedModel && modelCoordinates == cachedModelCoordinates) {
+		return; // model has not changed, so we can reuse the normals
+	}
+
+	NormalSet3D estimatedNormals;
+	NormalSet3D* normals = modelNormals;
+	if (model != normalsModel || modelNormals == 0 || modelNormals->getSize() != model->getSize()) {
+		assert(normalEstimator != 0);
+		normalEstimator->estimateNormals(model, &estimatedNormals);
+		normals = &estimatedNormals;
+		LOG(DEBUG) << "RigidTransformationEstimationPointToPlane: normals estimated for " << model->getSize() << " points.";
+	}
+
+	packedNormals.resize(3 * normals->getSize());
+	for (unsigned int i = 0; i < normals->getSize(); ++i) {
+		const Normal3D& normal = (*normals->getNormals())[i];
+		packedNormals[3 * i + 0] = normal.getX();
+		packedNormals[3 * i + 1] = normal.getY();
+		packedNormals[3 * i + 2] = normal.getZ();
+	}
+	cachedModel = model;
+	cachedModelCoordinates = modelCoordinates;
+}
+
+void RigidTransformationEstimationPointToPlane::setModelNormals(PointCloud3D* model, NormalSet3D* normals) {
+	this->normalsModel = model;
+	this->modelNormals = normals;
+	packedNormals.clear(); // prepare again
+	cachedModel = 0;
+	cachedModelCoordinates.reset();
+}
+
+void RigidTransformationEstimationPointToPlane::setNormalEstimator(INormalEstimation* normalEstimator) {
+	this->normalEstimator = (normalEstimator != 0) ? normalEstimator : &defaultNormalEstimator;
+	packedNormals.clear(); // prepare again
+	cachedModel = 0;
+	cachedModelCoordinates.reset();
+}
+
+INormalEstimation* RigidTransformationEstimationPointToPlane::getNormalEstimator() const {
+	return normalEstimator;
+}
+
+}
+
+/* EOF */
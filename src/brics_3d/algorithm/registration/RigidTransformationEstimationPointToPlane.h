@@ -0,0 +1,122 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_RIGIDTRANSFORMATIONESTIMATIONPOINTTOPLANE_H_
+#define BRICS_3D_RIGIDTRANSFORMATIONESTIMATIONPOINTTOPLANE_H_
+
+#include "IRigidTransformationEstimation.h"
+#include "brics_3d/core/NormalSet3D.h"
+#include "brics_3d/algorithm/featureExtraction/INormalEstimation.h"
+#include "brics_3d/algorithm/featureExtraction/ParallelNormalEstimation.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborANN.h"
+
+namespace brics_3d {
+
+/**
+ * @ingroup registration
+ * @brief Implementation of rigid transformation estimation that minimizes the point-to-plane error.
+ *
+ * Instead of the distance between corresponding points, the distance of a data point to the tangent plane of
+ * its corresponding model point is minimized. This lets planar structures slide along each other, so
+ * the ICP typically needs much less iterations on structured scenes than with the point-to-point error.
+ *
+ * The rotation is linearized (small angle approximation), which leads to a linear 6x6 system for
+ * rotation and translation per iteration. A tiny damping keeps directions that are not constrained by the
+ * normals (e.g. sliding along a single plane) at zero motion.
+ *
+ * The model normals are looked up via CorrespondencePoint3DPair::firstIndex, thus the point correspondence has
+ * to provide the indices (as PointCorrespondenceKDTree and PointCorrespondenceGenericNN do). The normals are
+ * either set explicitly for a model (setModelNormals()), or they are computed with a normal estimator whenever
+ * prepareModel() announces a new model. The IterativeClosestPoint calls prepareModel() automatically. The default
+ * estimator is a ParallelNormalEstimation with NearestNeighborANN and 10 neighbors.
+ *
+ * The returned error is the RMS point-to-plane distance of the given point pairs.
+ */
+class RigidTransformationEstimationPointToPlane: public brics_3d::IRigidTransformationEstimation {
+public:
+
+	/**
+	 * Standard constructor
+	 */
+	RigidTransformationEstimationPointToPlane();
+
+	/**
+	 * Standard destructor
+	 */
+	virtual ~RigidTransformationEstimationPointToPlane();
+
+	double estimateTransformation(std::vector<CorrespondencePoint3DPair>* pointPairs, IHomogeneousMatrix44* resultTransformation);
+
+	void prepareModel(PointCloud3D* model);
+
+	/**
+	 * @brief Set precomputed normals of a model.
+	 * @param model The model point cloud the normals belong to. Other models get estimated normals.
+	 * @param normals The normals in the order of the model points. Ownership is not transferred.
+	 * Invalid (NaN) normals are ignored. Set both to 0 to remove the normals.
+	 */
+	void setModelNormals(PointCloud3D* model, NormalSet3D* normals);
+
+	/**
+	 * @brief Set the estimator for the model normals.
+	 * @param normalEstimator The normal estimator. Ownership is not transferred. 0 selects the default estimator.
+	 */
+	void setNormalEstimator(INormalEstimation* normalEstimator);
+
+	/**
+	 * @brief Get the estimator for the model normals.
+	 * @return The normal estimator.
+	 */
+	INormalEstimation* getNormalEstimator() const;
+
+	/// Minimal number of point pairs with valid normals. With less pairs the identity is returned.
+	static const unsigned int minPointPairs;
+
+private:
+
+	/// Packed normals (x0 y0 z0 x1 y1 z1 ...) of the prepared model. Empty if no model is prepared.
+	std::vector<double> packedNormals;
+
+	/// The model point cloud the packed normals belong to
+	PointCloud3D* cachedModel;
+
+	/// Packed coordinates of the cached model, to detect modifications
+	PointCloud3D::PackedCoordinatesConstPtr cachedModelCoordinates;
+
+	/// Model with explicitly set normals
+	PointCloud3D* normalsModel;
+
+	/// Explicitly set normals
+	NormalSet3D* modelNormals;
+
+	/// The normal estimator that is used for models without explicitly set normals
+	INormalEstimation* normalEstimator;
+
+	/// Default normal estimator
+	ParallelNormalEstimation defaultNormalEstimator;
+
+	/// Search method of the default normal estimator
+	NearestNeighborANN defaultSearchMethod;
+};
+
+}
+
+#endif /* BRICS_3D_RIGIDTRANSFORMATIONESTIMATIONPOINTTOPLANE_H_ */
+
+/* EOF */
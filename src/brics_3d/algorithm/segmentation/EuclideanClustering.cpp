@@ -18,95 +18,316 @@
  ******************************************************************************/
 
 #include "EuclideanClustering.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/ParallelExecution.h"
+#include "brics_3d/algorithm/filtering/VoxelKey.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <assert.h>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_array.hpp>
+
 namespace brics_3d {
 
-EuclideanClustering::EuclideanClustering() {
-	// TODO Auto-generated constructor stub
+namespace {
+
+/*
+ * Lock free disjoint-set forest: a parent is always smaller than its child, so the root of a set is its
+ * smallest element. Roots are only linked with a compare-and-swap, thus several threads can merge
+ * sets of the same forest concurrently.
+ */
 
+/// Root of the set that contains element. Halves the path on the way.
+int findRoot(boost::atomic<int>* parents, int element) {
+	while (true) {
+		int parent = parents[element].load();
+		if (parent == element) {
+			return element;
+		}
+		int grandParent = parents[parent].load();
+		if (grandParent != parent) { // failing is harmless, some other thread has shortened the path
+			parents[element].compare_exchange_weak(parent, grandParent);
+		}
+		element = grandParent;
+	}
 }
 
-EuclideanClustering::~EuclideanClustering() {
-	// TODO Auto-generated destructor stub
+/// Merge the sets of two elements. The root with the larger index is linked to the smaller one.
+void unite(boost::atomic<int>* parents, int first, int second) {
+	while (true) {
+		first = findRoot(parents, first);
+		second = findRoot(parents, second);
+		if (first == second) {
+			return;
+		}
+		if (first > second) {
+			std::swap(first, second);
+		}
+		int expected = second;
+		if (parents[second].compare_exchange_strong(expected, first)) {
+			return;
+		}
+	}
 }
 
-void EuclideanClustering::extractClusters(brics_3d::PointCloud3D *inCloud){
+/// Squared distance between two axis aligned boxes; 0 if they overlap.
+double squaredBoxDistance(const double* firstMin, const double* firstMax, const double* secondMin, const double* secondMax) {
+	double squaredDistance = 0;
+	for (int axis = 0; axis < 3; ++axis) {
+		double gap = std::max(firstMin[axis] - secondMax[axis], secondMin[axis] - firstMax[axis]);
+		if (gap > 0) {
+			squaredDistance += gap * gap;
+		}
+	}
+	return squaredDistance;
+}
+
+}
 
+struct EuclideanClustering::VoxelGrid {
 
-	int k = inCloud->getSize();
-	brics_3d::NearestNeighborANN nearestneighborSearch;
-	brics_3d::Point3D querryPoint3D;
-	vector<int> neighborIndices;
+	/// Packed x,y,z coordinates of all points
+	const double* points;
 
-	nearestneighborSearch.setData(inCloud);
-	nearestneighborSearch.setMaxDistance(this->clusterTolerance);
-	//	nearestneighborSearch.setMaxDistance(1000);
-	// Create a bool vector of processed point indices, and initialize it to false
-	std::vector<bool> processed (inCloud->getSize(), false);
+	/// squared cluster tolerance
+	double squaredTolerance;
 
+	/// Integer coordinates of each voxel
+	std::vector<VoxelKey> voxelKeys;
 
-	// Process all points in the indices vector
-	for (size_t i = 0; i < inCloud->getSize(); ++i)
-	{
-		if (processed[i])
-			continue;
+	/// Maps integer coordinates to the index of a voxel
+	VoxelTable voxelIndices;
 
-		std::vector<int> seed_queue;
-		int sq_idx = 0;
-		seed_queue.push_back (i);
-		//std::cout << "[CHEAT][EuclideanClustering3D] "<< i << " : " << seed_queue.size () << std::endl;
-		processed[i] = true;
+	/// Points of voxel i are voxelPoints[voxelBegin[i]] to voxelPoints[voxelBegin[i+1]-1]
+	std::vector<unsigned int> voxelBegin;
 
-		while (sq_idx < (int)seed_queue.size ())
-		{
+	/// Point indices sorted by voxel
+	std::vector<int> voxelPoints;
 
-			// Search for sq_idx
-			neighborIndices.clear();
-			querryPoint3D = (*inCloud->getPointCloud())[sq_idx];
-			nearestneighborSearch.findNearestNeighbors(&querryPoint3D, &neighborIndices, k);
+	/// Bounding box of the points of voxel i: voxelMin[3*i] to voxelMin[3*i+2] and voxelMax likewise
+	std::vector<double> voxelMin;
+
+	/// @see voxelMin
+	std::vector<double> voxelMax;
+
+	/// Offsets of the adjacent voxels that might contain neighbors; only one of two symmetric offsets is included
+	std::vector<VoxelKey> forwardOffsets;
+
+	/// Shared disjoint-set forest of the points
+	boost::atomic<int>* parents;
+};
+
+const unsigned int EuclideanClustering::minPointsPerThread = 10000;
+
+EuclideanClustering::EuclideanClustering() {
+	this->clusterTolerance = 0.02;
+	this->minClusterSize = 1;
+	this->maxClusterSize = std::numeric_limits<unsigned int>::max();
+	this->numberOfThreads = 1;
+	this->inputPointCloud = 0;
+}
+
+EuclideanClustering::~EuclideanClustering() {
+
+}
+
+void EuclideanClustering::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+void EuclideanClustering::extractClusters(brics_3d::PointCloud3D *inCloud){
+	assert (inCloud != 0);
+
+	extractedClusters.clear(); // the clusters of a previous run belong to the caller
+	unsigned int numberOfPoints = inCloud->getSize();
+	if (numberOfPoints == 0) {
+		return;
+	}
 
-			//if (!tree->radiusSearch (seed_queue[sq_idx], tolerance, nn_indices, nn_distances))
-			if(neighborIndices.size()==0)
-			{
-				sq_idx++;
+	/* every point starts as its own set */
+	boost::scoped_array< boost::atomic<int> > parents(new boost::atomic<int>[numberOfPoints]);
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		parents[i].store(static_cast<int>(i));
+	}
+	std::vector<bool> valid(numberOfPoints, true);
+
+	if (clusterTolerance > 0) {
+
+		/*
+		 * bin the points into voxels with half the tolerance as edge length: the diagonal of a voxel is shorter
+		 * than the tolerance, so all points of a voxel belong to the same cluster, and neighbors are at most two
+		 * voxels apart
+		 */
+		PointCloud3D::PackedCoordinatesConstPtr packedPoints = inCloud->getPackedCoordinates();
+		VoxelGrid grid;
+		grid.points = &(*packedPoints)[0];
+		grid.squaredTolerance = static_cast<double>(clusterTolerance) * static_cast<double>(clusterTolerance);
+		grid.parents = parents.get();
+
+		const double inverseVoxelSize = 2.0 / clusterTolerance;
+		const double maxIndex = static_cast<double>(std::numeric_limits<int>::max() - 2); // neighbors need index +/- 2
+		std::vector<unsigned int> pointVoxels(numberOfPoints);
+		std::vector<unsigned int> voxelSizes;
+		unsigned int skippedPoints = 0;
+		for (unsigned int i = 0; i < numberOfPoints; ++i) {
+			const double* point = &grid.points[3 * i];
+			double scaledX = std::floor(point[0] * inverseVoxelSize);
+			double scaledY = std::floor(point[1] * inverseVoxelSize);
+			double scaledZ = std::floor(point[2] * inverseVoxelSize);
+			if (!(std::abs(scaledX) < maxIndex && std::abs(scaledY) < maxIndex && std::abs(scaledZ) < maxIndex)) { // also catches NaN
+				valid[i] = false;
+				skippedPoints++;
 				continue;
 			}
 
-			for (size_t j = 0; j < neighborIndices.size(); ++j)             // nn_indices[0] should be sq_idx
-			{
-				if (processed[neighborIndices[j]])                             // Has this point been processed before ?
-					continue;
+			VoxelKey key = {static_cast<int>(scaledX), static_cast<int>(scaledY), static_cast<int>(scaledZ)};
+			std::pair<VoxelTable::iterator, bool> entry = grid.voxelIndices.insert(std::make_pair(key, static_cast<unsigned int>(grid.voxelKeys.size())));
+			if (entry.second) {
+				grid.voxelKeys.push_back(key);
+				voxelSizes.push_back(0);
+				grid.voxelMin.insert(grid.voxelMin.end(), point, point + 3);
+				grid.voxelMax.insert(grid.voxelMax.end(), point, point + 3);
+			}
+			unsigned int voxel = entry.first->second;
+			pointVoxels[i] = voxel;
+			voxelSizes[voxel]++;
+			for (int axis = 0; axis < 3; ++axis) {
+				grid.voxelMin[3 * voxel + axis] = std::min(grid.voxelMin[3 * voxel + axis], point[axis]);
+				grid.voxelMax[3 * voxel + axis] = std::max(grid.voxelMax[3 * voxel + axis], point[axis]);
+			}
+		}
+		if (skippedPoints > 0) {
+			LOG(WARNING) << "EuclideanClustering: " << skippedPoints << " invalid points or points out of the voxel grid range have been skipped.";
+		}
 
-				// Perform a simple Euclidean clustering
-				seed_queue.push_back (neighborIndices[j]);
-				processed[neighborIndices[j]] = true;
+		unsigned int numberOfVoxels = static_cast<unsigned int>(grid.voxelKeys.size());
+		grid.voxelBegin.resize(numberOfVoxels + 1);
+		grid.voxelBegin[0] = 0;
+		for (unsigned int i = 0; i < numberOfVoxels; ++i) {
+			grid.voxelBegin[i + 1] = grid.voxelBegin[i] + voxelSizes[i];
+		}
+		grid.voxelPoints.resize(grid.voxelBegin[numberOfVoxels]);
+		std::vector<unsigned int> voxelFill(grid.voxelBegin.begin(), grid.voxelBegin.end() - 1);
+		for (unsigned int i = 0; i < numberOfPoints; ++i) {
+			if (valid[i]) {
+				grid.voxelPoints[voxelFill[pointVoxels[i]]++] = static_cast<int>(i);
 			}
+		}
 
-			sq_idx++;
+		/* the neighbor relation is symmetric, so only the lexicographically positive half of the 5x5x5 block is visited */
+		for (int x = 0; x <= 2; ++x) {
+			for (int y = -2; y <= 2; ++y) {
+				for (int z = -2; z <= 2; ++z) {
+					if (x > 0 || y > 0 || (y == 0 && z > 0)) {
+						VoxelKey offset = {x, y, z};
+						grid.forwardOffsets.push_back(offset);
+					}
+				}
+			}
 		}
-//		std::cout << "[CHEAT][EuclideanClustering3D] {sq_id : seed_q.size}"<< sq_idx << " : "<< seed_queue.size() << std::endl;
-		// If this queue is satisfactory, add to the clusters
-		if (seed_queue.size () >= minClusterSize && seed_queue.size () <= maxClusterSize)
-		{
-//			std::cout << "[CHEAT][EuclideanClustering3D] found one cluster, size="<< seed_queue.size() << std::endl;
 
-			seed_queue.erase(std::unique(seed_queue.begin(), seed_queue.end()),seed_queue.end());
-			brics_3d::PointCloud3D *tempPointCloud =  new brics_3d::PointCloud3D();
+		/* merge neighboring points; all threads work on the same forest */
+		unsigned int threadCount = std::min(ParallelExecution::getThreadCount(numberOfThreads, numberOfPoints, minPointsPerThread), numberOfVoxels);
+		ParallelExecution::forEachRange(numberOfVoxels, threadCount,
+				boost::bind(&EuclideanClustering::mergeVoxelPoints, this, &grid, _1, _2));
+		ParallelExecution::forEachRange(numberOfVoxels, threadCount,
+				boost::bind(&EuclideanClustering::mergeNeighbors, this, &grid, _1, _2));
+		LOG(DEBUG) << "EuclideanClustering: " << numberOfPoints << " points in " << numberOfVoxels << " voxels processed by " << std::max(threadCount, 1u) << " threads.";
+	} else {
+		LOG(WARNING) << "EuclideanClustering: cluster tolerance is not positive. Each point forms a cluster.";
+	}
+
+	/* the root of a set is its smallest point index, so the clusters are created in the order of their first point */
+	std::vector<unsigned int> clusterSizes(numberOfPoints, 0);
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		if (valid[i]) {
+			clusterSizes[findRoot(parents.get(), static_cast<int>(i))]++;
+		}
+	}
 
-			for (size_t j = 0; j < seed_queue.size (); ++j) {
+	std::vector<brics_3d::PointCloud3D*> clusters(numberOfPoints, static_cast<brics_3d::PointCloud3D*>(0));
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		if (!valid[i]) {
+			continue;
+		}
+		int root = findRoot(parents.get(), static_cast<int>(i));
+		if (clusterSizes[root] < minClusterSize || clusterSizes[root] > maxClusterSize) {
+			continue;
+		}
+		if (root == static_cast<int>(i)) {
+			clusters[root] = new brics_3d::PointCloud3D();
+			clusters[root]->getPointCloud()->reserve(clusterSizes[root]);
+			extractedClusters.push_back(clusters[root]);
+		}
+		clusters[root]->addPointPtr((*inCloud->getConstPointCloud())[i].clone());
+	}
+}
 
-				tempPointCloud->addPointPtr((*inCloud->getPointCloud())[seed_queue[j]].clone());
+void EuclideanClustering::mergeVoxelPoints(const VoxelGrid* grid, unsigned int beginVoxel, unsigned int endVoxel) {
+	assert (grid != 0);
 
-			}
-			extractedClusters.push_back(tempPointCloud);
-//			delete tempPointCloud; //?
+	for (unsigned int voxel = beginVoxel; voxel < endVoxel; ++voxel) {
+		int first = grid->voxelPoints[grid->voxelBegin[voxel]];
+		for (unsigned int i = grid->voxelBegin[voxel] + 1; i < grid->voxelBegin[voxel + 1]; ++i) {
+			unite(grid->parents, first, grid->voxelPoints[i]);
 		}
-//		std::cout << "[CHEAT][EuclideanClustering3D] "<< i << " : " << seed_queue.size () << std::endl;
 	}
 }
 
+void EuclideanClustering::mergeNeighbors(const VoxelGrid* grid, unsigned int beginVoxel, unsigned int endVoxel) {
+	assert (grid != 0);
+
+	const double* points = grid->points;
+	for (unsigned int voxel = beginVoxel; voxel < endVoxel; ++voxel) {
+		unsigned int begin = grid->voxelBegin[voxel];
+		unsigned int end = grid->voxelBegin[voxel + 1];
+		const double* voxelMin = &grid->voxelMin[3 * voxel];
+		const double* voxelMax = &grid->voxelMax[3 * voxel];
+		const VoxelKey& key = grid->voxelKeys[voxel];
 
+		for (unsigned int k = 0; k < grid->forwardOffsets.size(); ++k) {
+			const VoxelKey& offset = grid->forwardOffsets[k];
+			VoxelKey neighborKey = {key.x + offset.x, key.y + offset.y, key.z + offset.z};
+			VoxelTable::const_iterator neighborVoxel = grid->voxelIndices.find(neighborKey);
+			if (neighborVoxel == grid->voxelIndices.end()) {
+				continue;
+			}
+			unsigned int neighborBegin = grid->voxelBegin[neighborVoxel->second];
+			unsigned int neighborEnd = grid->voxelBegin[neighborVoxel->second + 1];
+			const double* neighborMin = &grid->voxelMin[3 * neighborVoxel->second];
+			const double* neighborMax = &grid->voxelMax[3 * neighborVoxel->second];
+
+			/* the points of a voxel form one set, so a single pair within the tolerance connects both voxels */
+			if (findRoot(grid->parents, grid->voxelPoints[begin]) == findRoot(grid->parents, grid->voxelPoints[neighborBegin]) ||
+					squaredBoxDistance(voxelMin, voxelMax, neighborMin, neighborMax) > grid->squaredTolerance) {
+				continue;
+			}
+
+			bool connected = false;
+			for (unsigned int i = begin; i < end && !connected; ++i) {
+				const double* point = &points[3 * grid->voxelPoints[i]];
+				if (squaredBoxDistance(point, point, neighborMin, neighborMax) > grid->squaredTolerance) {
+					continue; // only points close to the border of the neighbor voxel are compared
+				}
+				for (unsigned int j = neighborBegin; j < neighborEnd; ++j) {
+					const double* neighbor = &points[3 * grid->voxelPoints[j]];
+					double dx = point[0] - neighbor[0];
+					double dy = point[1] - neighbor[1];
+					double dz = point[2] - neighbor[2];
+					if (dx * dx + dy * dy + dz * dz <= grid->squaredTolerance) {
+						unite(grid->parents, grid->voxelPoints[i], grid->voxelPoints[j]);
+						connected = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
 
 int EuclideanClustering::segment(){
 
@@ -33,6 +33,23 @@ namespace brics_3d {
 /**
  * @brief Segmentation based on Eucledian distance between point clusters.
  * @ingroup segmentation
+ *
+ * Two points belong to the same cluster if they are connected by a chain of points, where consecutive
+ * points are not farther apart than the cluster tolerance.
+ *
+ * The points are binned into a voxel grid with an edge length of half the cluster tolerance. The diagonal of
+ * such a voxel is shorter than the tolerance, thus all points of a voxel belong to the same cluster and are merged
+ * without any distance computations. Neighbors of a point can only be located in voxels that are at most two
+ * voxels apart. For a pair of voxels the distances are only computed until the first connecting pair of points is
+ * found, and only for points that are close enough to the bounding box of the other voxel. Voxel pairs that
+ * already belong to the same cluster are skipped.
+ *
+ * The connected points are merged with a lock free union-find (disjoint-set) structure. The voxels can be
+ * distributed among several worker threads (see setNumberOfThreads()) that merge into the same forest. The
+ * resulting clusters do not depend on the number of threads.
+ *
+ * The clusters are ordered by their smallest point index, and the points within a cluster are in the order of
+ * the input point cloud.
  */
 class EuclideanClustering : public ISegmentation{
 
@@ -55,6 +72,16 @@ private:
 	 */
 	unsigned int maxClusterSize;
 
+	/**
+	 * Number of worker threads
+	 */
+	unsigned int numberOfThreads;
+
+	/**
+	 * Points binned into voxels. Defined in the implementation.
+	 */
+	struct VoxelGrid;
+
 	/**
 	 * Takes a pointcloud and returns an array of pointcloud that make up the clusters.
 	 * The clusters are defined by the parameters being set
@@ -63,6 +90,23 @@ private:
 	 */
 	void extractClusters(brics_3d::PointCloud3D *inCloud);
 
+	/**
+	 * Merges all points within each voxel of a range of voxels.
+	 * @param grid The voxel grid with the points and the disjoint-set forest.
+	 * @param beginVoxel Index of the first voxel.
+	 * @param endVoxel Index behind the last voxel.
+	 */
+	void mergeVoxelPoints(const VoxelGrid* grid, unsigned int beginVoxel, unsigned int endVoxel);
+
+	/**
+	 * Merges the points of a range of voxels with the points of the nearby voxels
+	 * that are within the cluster tolerance.
+	 * @param grid The voxel grid with the points and the disjoint-set forest.
+	 * @param beginVoxel Index of the first voxel.
+	 * @param endVoxel Index behind the last voxel.
+	 */
+	void mergeNeighbors(const VoxelGrid* grid, unsigned int beginVoxel, unsigned int endVoxel);
+
 
 	std::vector<brics_3d::PointCloud3D*> extractedClusters;
 
@@ -131,11 +175,31 @@ public:
 	}
 
 
+	/**
+	 * @return the number of worker threads
+	 */
+	unsigned int getNumberOfThreads() const
+	{
+		return numberOfThreads;
+	}
+
+
+	/**
+	 *
+	 * @param numberOfThreads Number of worker threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+
 	void getExtractedClusters(std::vector<brics_3d::PointCloud3D*> &extractedClusters){
 		extractedClusters = this->extractedClusters;
 	}
 
 	int segment();
+
+	/// Minimal number of points that are assigned to a worker thread. Smaller data is processed by fewer threads.
+	static const unsigned int minPointsPerThread;
 };
 
 }
@@ -0,0 +1,226 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Pinaki Sunil Banerjee
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include "OrganizedConnectedComponents.h"
+#include "brics_3d/core/Logger.h"
+
+#include <cmath>
+#include <limits>
+#include <assert.h>
+
+namespace brics_3d {
+
+namespace {
+
+/// Root of the set that contains element. Halves the path on the way.
+unsigned int findRoot(std::vector<unsigned int>& parents, unsigned int element) {
+	while (parents[element] != element) {
+		parents[element] = parents[parents[element]];
+		element = parents[element];
+	}
+	return element;
+}
+
+/// Merge the sets of two elements. The root of a set is always its smallest element.
+void unite(std::vector<unsigned int>& parents, unsigned int first, unsigned int second) {
+	unsigned int firstRoot = findRoot(parents, first);
+	unsigned int secondRoot = findRoot(parents, second);
+	if (firstRoot < secondRoot) {
+		parents[secondRoot] = firstRoot;
+	} else if (secondRoot < firstRoot) {
+		parents[firstRoot] = secondRoot;
+	}
+}
+
+}
+
+OrganizedConnectedComponents::OrganizedConnectedComponents() {
+	this->inputPointCloud = 0;
+	this->normals = 0;
+	this->distanceThreshold = 0.02;
+	this->angleThreshold = 0.1;
+	this->minClusterSize = 1;
+	this->maxClusterSize = std::numeric_limits<unsigned int>::max();
+}
+
+OrganizedConnectedComponents::~OrganizedConnectedComponents() {
+
+}
+
+int OrganizedConnectedComponents::segment() {
+	assert(inputPointCloud != 0);
+	labels.clear();
+	clusterIndices.clear();
+
+	const unsigned int width = inputPointCloud->getWidth();
+	const unsigned int height = inputPointCloud->getHeight();
+	const unsigned int numberOfPixels = inputPointCloud->getSize();
+	const unsigned char* valid = inputPointCloud->getValidMask();
+	if (normals != 0 && normals->getSize() != numberOfPixels) {
+		LOG(ERROR) << "OrganizedConnectedComponents: The number of normals does not match the size of the point cloud. Aborting.";
+		return 0;
+	}
+	labels.assign(numberOfPixels, -1);
+
+	/* each connection is checked once: with the right neighbor and the three lower neighbors */
+	std::vector<unsigned int> parents(numberOfPixels);
+	for (unsigned int i = 0; i < numberOfPixels; ++i) {
+		parents[i] = i;
+	}
+	for (unsigned int row = 0; row < height; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			unsigned int index = row * width + col;
+			if (!valid[index]) {
+				continue;
+			}
+			if (col + 1 < width && valid[index + 1] && isConnected(index, index + 1)) {
+				unite(parents, index, index + 1);
+			}
+			if (row + 1 == height) {
+				continue;
+			}
+			if (col > 0 && valid[index + width - 1] && isConnected(index, index + width - 1)) {
+				unite(parents, index, index + width - 1);
+			}
+			if (valid[index + width] && isConnected(index, index + width)) {
+				unite(parents, index, index + width);
+			}
+			if (col + 1 < width && valid[index + width + 1] && isConnected(index, index + width + 1)) {
+				unite(parents, index, index + width + 1);
+			}
+		}
+	}
+
+	/* the root of a set is its first pixel, so the clusters are numbered in the order of their first pixel */
+	std::vector<unsigned int> clusterSizes(numberOfPixels, 0);
+	for (unsigned int i = 0; i < numberOfPixels; ++i) {
+		if (valid[i]) {
+			clusterSizes[findRoot(parents, i)]++;
+		}
+	}
+	for (unsigned int i = 0; i < numberOfPixels; ++i) {
+		if (!valid[i]) {
+			continue;
+		}
+		unsigned int root = findRoot(parents, i);
+		if (clusterSizes[root] < minClusterSize || clusterSizes[root] > maxClusterSize) {
+			continue;
+		}
+		if (root == i) {
+			labels[i] = static_cast<int>(clusterIndices.size());
+			clusterIndices.push_back(std::vector<unsigned int>());
+			clusterIndices.back().reserve(clusterSizes[root]);
+		} else {
+			labels[i] = labels[root];
+		}
+		clusterIndices[labels[i]].push_back(i);
+	}
+
+	LOG(DEBUG) << "OrganizedConnectedComponents: " << clusterIndices.size() << " clusters extracted from " << numberOfPixels << " pixels.";
+	return static_cast<int>(clusterIndices.size());
+}
+
+bool OrganizedConnectedComponents::isConnected(unsigned int first, unsigned int second) const {
+	const Coordinate* x = inputPointCloud->getXCoordinates();
+	const Coordinate* y = inputPointCloud->getYCoordinates();
+	const Coordinate* z = inputPointCloud->getZCoordinates();
+	double dx = x[first] - x[second];
+	double dy = y[first] - y[second];
+	double dz = z[first] - z[second];
+	if (dx * dx + dy * dy + dz * dz > distanceThreshold * distanceThreshold) {
+		return false;
+	}
+	if (normals == 0) {
+		return true;
+	}
+
+	/* false for NaN normals as well */
+	const Normal3D& firstNormal = (*normals->getNormals())[first];
+	const Normal3D& secondNormal = (*normals->getNormals())[second];
+	double cosAngle = firstNormal.getX() * secondNormal.getX() + firstNormal.getY() * secondNormal.getY() + firstNormal.getZ() * secondNormal.getZ();
+	return cosAngle >= cos(angleThreshold);
+}
+
+void OrganizedConnectedComponents::setPointCloud(const OrganizedPointCloud3D* inputPointCloud) {
+	this->inputPointCloud = inputPointCloud;
+}
+
+void OrganizedConnectedComponents::setNormals(NormalSet3D* normals) {
+	this->normals = normals;
+}
+
+double OrganizedConnectedComponents::getDistanceThreshold() const {
+	return distanceThreshold;
+}
+
+void OrganizedConnectedComponents::setDistanceThreshold(double distanceThreshold) {
+	this->distanceThreshold = distanceThreshold;
+}
+
+double OrganizedConnectedComponents::getAngleThreshold() const {
+	return angleThreshold;
+}
+
+void OrganizedConnectedComponents::setAngleThreshold(double angleThreshold) {
+	this->angleThreshold = angleThreshold;
+}
+
+unsigned int OrganizedConnectedComponents::getMinClusterSize() const {
+	return minClusterSize;
+}
+
+void OrganizedConnectedComponents::setMinClusterSize(unsigned int minClusterSize) {
+	this->minClusterSize = minClusterSize;
+}
+
+unsigned int OrganizedConnectedComponents::getMaxClusterSize() const {
+	return maxClusterSize;
+}
+
+void OrganizedConnectedComponents::setMaxClusterSize(unsigned int maxClusterSize) {
+	this->maxClusterSize = maxClusterSize;
+}
+
+void OrganizedConnectedComponents::getLabels(std::vector<int>& labels) const {
+	labels = this->labels;
+}
+
+void OrganizedConnectedComponents::getClusterIndices(std::vector<std::vector<unsigned int> >& clusterIndices) const {
+	clusterIndices = this->clusterIndices;
+}
+
+void OrganizedConnectedComponents::getExtractedClusters(std::vector<PointCloud3D*>& extractedClusters) const {
+	assert(inputPointCloud != 0 || clusterIndices.empty());
+	extractedClusters.clear();
+	for (unsigned int cluster = 0; cluster < clusterIndices.size(); ++cluster) {
+		PointCloud3D* pointCloud = new PointCloud3D();
+		pointCloud->getPointCloud()->reserve(clusterIndices[cluster].size());
+		for (unsigned int i = 0; i < clusterIndices[cluster].size(); ++i) {
+			unsigned int index = clusterIndices[cluster][i];
+			pointCloud->addPoint(Point3D(inputPointCloud->getXCoordinates()[index], inputPointCloud->getYCoordinates()[index],
+					inputPointCloud->getZCoordinates()[index]));
+		}
+		extractedClusters.push_back(pointCloud);
+	}
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,191 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Pinaki Sunil Banerjee
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef BRICS_3D_ORGANIZEDCONNECTEDCOMPONENTS_H_
+#define BRICS_3D_ORGANIZEDCONNECTEDCOMPONENTS_H_
+
+#include "brics_3d/core/OrganizedPointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+
+#include <vector>
+
+namespace brics_3d {
+
+/**
+ * @brief Segmentation of organized point clouds into connected components in pixel space.
+ * @ingroup segmentation
+ *
+ * Two valid points are connected if their pixels are adjacent (8-neighborhood, so diagonal lines of invalid
+ * pixels do not split a surface) and their Euclidean distance is at most the distance threshold. Optionally, the
+ * normals of both points have to agree up to an angle threshold as well (see setNormals()), which separates e.g.
+ * objects from the supporting plane. A cluster is a set of points that is connected by a chain of such pairs.
+ *
+ * In contrast to the EuclideanClustering no nearest neighbor index or voxel grid is built: each pixel is compared
+ * with its right and its three lower neighbors only, and the pairs are merged with a union-find (disjoint-set)
+ * structure. Thus the segmentation runs in (almost) linear time in the number of pixels.
+ *
+ * The result is available as label image (see getLabels()), as pixel indices per cluster and as point clouds, like
+ * for the EuclideanClustering. The clusters are ordered by their first pixel in row major order.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  OrganizedConnectedComponents segmentation;
+ *  segmentation.setPointCloud(organizedCloud);
+ *  segmentation.setDistanceThreshold(0.02);
+ *  segmentation.setMinClusterSize(100);
+ *  segmentation.segment();
+ *
+ *  std::vector<PointCloud3D*> clusters;
+ *  segmentation.getExtractedClusters(clusters); // ownership is transferred to the caller
+ *
+ * @endcode
+ */
+class OrganizedConnectedComponents {
+public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	OrganizedConnectedComponents();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~OrganizedConnectedComponents();
+
+	/**
+	 * @brief Set the point cloud to be segmented.
+	 * @param inputPointCloud The organized point cloud. Ownership is not transferred.
+	 */
+	void setPointCloud(const OrganizedPointCloud3D* inputPointCloud);
+
+	/**
+	 * @brief Set normals that have to agree for connected points.
+	 * @param normals One normal per pixel, e.g. computed with the IntegralImageNormalEstimation. Points with NaN normals
+	 * are not connected to any other point. Null disables the normal criterion (default). Ownership is not transferred.
+	 */
+	void setNormals(NormalSet3D* normals);
+
+	/**
+	 * @brief Get the distance threshold.
+	 * @return The maximal distance of connected neighbors.
+	 */
+	double getDistanceThreshold() const;
+
+	/**
+	 * @brief Set the distance threshold.
+	 * @param distanceThreshold The maximal Euclidean distance of two adjacent points that are connected. Default is 0.02.
+	 */
+	void setDistanceThreshold(double distanceThreshold);
+
+	/**
+	 * @brief Get the angle threshold.
+	 * @return The maximal angle between the normals of connected neighbors in radians.
+	 */
+	double getAngleThreshold() const;
+
+	/**
+	 * @brief Set the angle threshold. Only used if normals are set.
+	 * @param angleThreshold The maximal angle between the normals of connected neighbors in radians. Default is 0.1.
+	 */
+	void setAngleThreshold(double angleThreshold);
+
+	/**
+	 * @brief Get the minimal number of points of a cluster.
+	 */
+	unsigned int getMinClusterSize() const;
+
+	/**
+	 * @brief Set the minimal number of points of a cluster. Smaller clusters are discarded. Default is 1.
+	 */
+	void setMinClusterSize(unsigned int minClusterSize);
+
+	/**
+	 * @brief Get the maximal number of points of a cluster.
+	 */
+	unsigned int getMaxClusterSize() const;
+
+	/**
+	 * @brief Set the maximal number of points of a cluster. Larger clusters are discarded. Default is no limit.
+	 */
+	void setMaxClusterSize(unsigned int maxClusterSize);
+
+	/**
+	 * @brief Perform the segmentation.
+	 * @return The number of extracted clusters.
+	 */
+	int segment();
+
+	/**
+	 * @brief Get the label image of the last segmentation.
+	 * @param[out] labels One label per pixel in row major order: the cluster number or -1 for invalid points and
+	 * points of discarded clusters.
+	 */
+	void getLabels(std::vector<int>& labels) const;
+
+	/**
+	 * @brief Get the pixel indices of the clusters of the last segmentation.
+	 * @param[out] clusterIndices Indices in the organized point cloud, in row major order per cluster.
+	 */
+	void getClusterIndices(std::vector<std::vector<unsigned int> >& clusterIndices) const;
+
+	/**
+	 * @brief Create point clouds of the clusters of the last segmentation.
+	 * @param[out] extractedClusters One new point cloud per cluster. The caller takes the ownership.
+	 */
+	void getExtractedClusters(std::vector<PointCloud3D*>& extractedClusters) const;
+
+private:
+
+	/// Check the connection criteria for two valid points.
+	bool isConnected(unsigned int first, unsigned int second) const;
+
+	/// The input point cloud
+	const OrganizedPointCloud3D* inputPointCloud;
+
+	/// Optional normals
+	NormalSet3D* normals;
+
+	/// Maximal distance of connected neighbors
+	double distanceThreshold;
+
+	/// Maximal angle between the normals of connected neighbors
+	double angleThreshold;
+
+	/// Minimum number of points to consider it as a cluster
+	unsigned int minClusterSize;
+
+	/// Maximum number of points to be in the cluster
+	unsigned int maxClusterSize;
+
+	/// Result: label per pixel
+	std::vector<int> labels;
+
+	/// Result: pixel indices per cluster
+	std::vector<std::vector<unsigned int> > clusterIndices;
+};
+
+}
+
+#endif /* BRICS_3D_ORGANIZEDCONNECTEDCOMPONENTS_H_ */
+
+/* EOF */
@@ -162,9 +162,9 @@ int RGBColorBasedEuclideanClustering::getMaxClusterSize() const
 
 				brics_3d::ColoredPoint3D *tempPoint =  new brics_3d::ColoredPoint3D(
 						new brics_3d::Point3D(
-								(*inputPointCloud->getPointCloud())[seed_queue[j]].getX(),
-								(*inputPointCloud->getPointCloud())[seed_queue[j]].getY(),
-								(*inputPointCloud->getPointCloud())[seed_queue[j]].getZ()),
+								(*inputPointCloud->getConstPointCloud())[seed_queue[j]].getX(),
+								(*inputPointCloud->getConstPointCloud())[seed_queue[j]].getY(),
+								(*inputPointCloud->getConstPointCloud())[seed_queue[j]].getZ()),
 								(*inputPointCloud->getPointCloud())[seed_queue[j]].asColoredPoint3D()->getR(),
 								(*inputPointCloud->getPointCloud())[seed_queue[j]].asColoredPoint3D()->getG(),
 								(*inputPointCloud->getPointCloud())[seed_queue[j]].asColoredPoint3D()->getB());
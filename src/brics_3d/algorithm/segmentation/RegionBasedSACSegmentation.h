@@ -89,6 +89,15 @@ protected:
 	 * */
 	int SACMethodType;
 
+	/** @brief Number of hypotheses that are scored as one batch. Default value 1 */
+	unsigned int hypothesesPerBatch;
+
+	/** @brief Number of threads that score the hypotheses of a batch. Default value 1 */
+	unsigned int numberOfThreads;
+
+	/** @brief Number of points for the pretest of a hypothesis in batch mode. Default value 0 */
+	unsigned int pretestSize;
+
 //	/** @brief The input point-cloud to be processed*/
 //	PointCloud3D* inputPointCloud;
 
@@ -119,6 +128,9 @@ public:
 		this->threshold = -1;
 		this->maxIterations = 10000;
 		this->probability = 0.99;
+		this->hypothesesPerBatch = 1;
+		this->numberOfThreads = 1;
+		this->pretestSize = 0;
 
 		this->objectModel = 0;
 		this->sacMethod = 0;
@@ -169,6 +181,42 @@ public:
 		return (probability);
 	}
 
+	/** @brief Set the number of hypotheses that are generated and scored as one batch (see ISACMethods::setHypothesesPerBatch()).
+	 * @param hypothesesPerBatch number of hypotheses per batch. Values larger than 1 enable the batch mode of RANSAC and MSAC.
+	 */
+	inline void setHypothesesPerBatch(unsigned int hypothesesPerBatch) {
+		this->hypothesesPerBatch = hypothesesPerBatch;
+	}
+
+	/** @brief Get the number of hypotheses that are scored as one batch. */
+	inline unsigned int getHypothesesPerBatch() {
+		return (hypothesesPerBatch);
+	}
+
+	/** @brief Set the number of threads that score the hypotheses of a batch.
+	 * @param numberOfThreads number of threads. 0 means one thread per available hardware thread
+	 */
+	inline void setNumberOfThreads(unsigned int numberOfThreads) {
+		this->numberOfThreads = numberOfThreads;
+	}
+
+	/** @brief Get the number of threads that score the hypotheses of a batch. */
+	inline unsigned int getNumberOfThreads() {
+		return (numberOfThreads);
+	}
+
+	/** @brief Set the number of random points that a hypothesis is tested on first in batch mode.
+	 * @param pretestSize number of points of the pretest; 0 disables the pretest
+	 */
+	inline void setPretestSize(unsigned int pretestSize) {
+		this->pretestSize = pretestSize;
+	}
+
+	/** @brief Get the number of points of the pretest. */
+	inline unsigned int getPretestSize() {
+		return (pretestSize);
+	}
+
 	/** @brief Return the best model found so far.
 	 * @param model the resultant model
 	 */
@@ -359,6 +407,10 @@ public:
 			cout<<"[SAC Segmentation] Setting the maximum number of iterations to "<<maxIterations<<endl;
 			sacMethod->setMaxIterations(maxIterations);
 		}
+
+		sacMethod->setHypothesesPerBatch(hypothesesPerBatch);
+		sacMethod->setNumberOfThreads(numberOfThreads);
+		sacMethod->setPretestSize(pretestSize);
 	}
 
 
@@ -308,6 +308,10 @@ public:
 			cout<<"[SAC Segmentation] Setting the maximum number of iterations to "<<maxIterations<<endl;
 			sacMethod->setMaxIterations(maxIterations);
 		}
+
+		sacMethod->setHypothesesPerBatch(hypothesesPerBatch);
+		sacMethod->setNumberOfThreads(numberOfThreads);
+		sacMethod->setPretestSize(pretestSize);
 	}
 
 
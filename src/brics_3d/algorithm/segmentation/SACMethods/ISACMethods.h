@@ -12,6 +12,8 @@
 #include "brics_3d/algorithm/segmentation/objectModels/IObjectModel.h"
 #include "brics_3d/core/PointCloud3D.h"
 #include <algorithm>
+#include <limits>
+#include <cmath>
 #include <float.h>
 namespace brics_3d {
 
@@ -55,9 +57,36 @@ protected:
 
 	/** @brief The input point-cloud to be processed*/
 	PointCloud3D* inputPointCloud;
+
+	/** @brief Number of hypotheses that are generated and scored as one batch. Default value 1, i.e. one by one */
+	unsigned int hypothesesPerBatch;
+
+	/** @brief Number of threads that score the hypotheses of a batch. Default value 1 */
+	unsigned int numberOfThreads;
+
+	/** @brief Number of random points a hypothesis is tested on before the full evaluation in batch mode. Default value 0, i.e. no pretest */
+	unsigned int pretestSize;
+
+	/** @brief Compute the number of iterations that are required to find an outlier free sample with the desired probability
+	 *  (k=log(z)/log(1-w^n)).
+	 *  @param noInliers number of inliers of the best model so far
+	 */
+	inline double
+	computeRequiredIterations (unsigned int noInliers)
+	{
+		double w = (double)noInliers / (double)this->objectModel->getInputCloud()->getSize();
+		double pNoOutliers = 1 - pow (w, (double)this->objectModel->getNumberOfSamplesRequired());
+		pNoOutliers = std::max (std::numeric_limits<double>::epsilon (), pNoOutliers);       // Avoid division by -Inf
+		pNoOutliers = std::min (1 - std::numeric_limits<double>::epsilon (), pNoOutliers);   // Avoid division by 0.
+		return log (1 - this->probability) / log (pNoOutliers);
+	}
+
 public:
 	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-//	ISACMethods();
+
+	ISACMethods() :
+		objectModel(0), threshold(-1), maxIterations(10000), probability(0.99), iterations(0),
+		optimizeCoefficients(false), inputPointCloud(0), hypothesesPerBatch(1), numberOfThreads(1), pretestSize(0) {};
 
 
 	/** @brief Set the object model to be used
@@ -228,7 +257,66 @@ public:
 	}
 
 
-//	virtual ~ISACMethods();
+	/** @brief Set the number of hypotheses that are generated and scored as one batch.
+	 *
+	 *  A value larger than 1 enables the batch mode of the methods that support it (RANSAC and MSAC): the hypotheses
+	 *  of a batch are scored concurrently on a packed copy of the point cloud and rejected as soon as they cannot
+	 *  beat the best model so far. Inliers are only extracted for the final model. See SACHypothesisEvaluator.
+	 *  @param hypothesesPerBatch number of hypotheses per batch
+	 */
+	inline void
+	setHypothesesPerBatch (unsigned int hypothesesPerBatch)
+	{
+		this->hypothesesPerBatch = std::max (hypothesesPerBatch, 1u);
+	}
+
+
+	/** @brief Get the number of hypotheses that are generated and scored as one batch. */
+	inline unsigned int
+	getHypothesesPerBatch ()
+	{
+		return (this->hypothesesPerBatch);
+	}
+
+
+	/** @brief Set the number of threads that score the hypotheses of a batch.
+	 *  @param numberOfThreads number of threads. 0 means one thread per available hardware thread
+	 */
+	inline void
+	setNumberOfThreads (unsigned int numberOfThreads)
+	{
+		this->numberOfThreads = numberOfThreads;
+	}
+
+
+	/** @brief Get the number of threads that score the hypotheses of a batch. */
+	inline unsigned int
+	getNumberOfThreads ()
+	{
+		return (this->numberOfThreads);
+	}
+
+
+	/** @brief Set the number of random points that a hypothesis is tested on first in batch mode.
+	 *  Hypotheses with less than half of the inlier ratio of the best model on these points are rejected.
+	 *  @param pretestSize number of points of the pretest; 0 disables the pretest
+	 */
+	inline void
+	setPretestSize (unsigned int pretestSize)
+	{
+		this->pretestSize = pretestSize;
+	}
+
+
+	/** @brief Get the number of points of the pretest. */
+	inline unsigned int
+	getPretestSize ()
+	{
+		return (this->pretestSize);
+	}
+
+
+	virtual ~ISACMethods(){};
 };
 
 }
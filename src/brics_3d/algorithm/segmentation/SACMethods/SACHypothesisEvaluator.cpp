@@ -0,0 +1,162 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "SACHypothesisEvaluator.h"
+#include "brics_3d/core/ParallelExecution.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <boost/bind.hpp>
+
+namespace brics_3d {
+
+const unsigned int SACHypothesisEvaluator::chunkSize = 1024;
+
+const unsigned int SACHypothesisEvaluator::minDistancesPerThread = 200000;
+
+SACHypothesisEvaluator::SACHypothesisEvaluator(IObjectModel* objectModel, double threshold, ScoringFunction scoringFunction) {
+	assert(objectModel != 0);
+	this->objectModel = objectModel;
+	this->threshold = threshold;
+	this->scoringFunction = scoringFunction;
+	this->numberOfThreads = 1;
+	this->pretestSize = 0;
+
+	/* every prefix of the shuffled points is a random sample for the pretest */
+	PointCloud3D* inputCloud = objectModel->getInputCloud();
+	assert(inputCloud != 0);
+	pointIndices.resize(inputCloud->getSize());
+	for (unsigned int i = 0; i < pointIndices.size(); ++i) {
+		pointIndices[i] = i;
+	}
+	std::random_shuffle(pointIndices.begin(), pointIndices.end());
+	points.copyFrom(inputCloud, pointIndices);
+}
+
+SACHypothesisEvaluator::~SACHypothesisEvaluator() {
+
+}
+
+void SACHypothesisEvaluator::evaluate(const std::vector<Eigen::VectorXd>& hypotheses, const Score& bestScore, std::vector<Score>& scores) const {
+	const Score reference = bestScore; // bestScore might be an element of scores
+	unsigned int numberOfHypotheses = static_cast<unsigned int>(hypotheses.size());
+	scores.assign(numberOfHypotheses, Score());
+
+	double numberOfDistances = static_cast<double>(numberOfHypotheses) * points.getSize();
+	unsigned int threadCount = std::min(numberOfThreads, numberOfHypotheses);
+	threadCount = std::min(threadCount, static_cast<unsigned int>(numberOfDistances / minDistancesPerThread));
+
+	/* interleaved assignment, as hypotheses that are rejected early are cheaper */
+	ParallelExecution::forEachStride(threadCount, boost::bind(&SACHypothesisEvaluator::evaluateHypotheses, this, &hypotheses, &reference, &scores, _1, _2));
+}
+
+void SACHypothesisEvaluator::evaluateHypotheses(const std::vector<Eigen::VectorXd>* hypotheses, const Score* bestScore,
+		std::vector<Score>* scores, unsigned int first, unsigned int stride) const {
+	std::vector<double> distances(chunkSize);
+	for (unsigned int i = first; i < hypotheses->size(); i += stride) {
+		(*scores)[i] = evaluateHypothesis((*hypotheses)[i], *bestScore, &distances[0]);
+	}
+}
+
+SACHypothesisEvaluator::Score SACHypothesisEvaluator::evaluateHypothesis(const Eigen::VectorXd& hypothesis, const Score& bestScore, double* distances) const {
+	Score score;
+	score.residualPenalty = 0.0;
+	unsigned int numberOfPoints = points.getSize();
+	unsigned int pretestEnd = (bestScore.isValid) ? std::min(pretestSize, numberOfPoints) : 0;
+
+	unsigned int begin = 0;
+	while (begin < numberOfPoints) {
+		unsigned int end = std::min(begin + chunkSize, numberOfPoints);
+		if (begin < pretestEnd) {
+			end = std::min(end, pretestEnd);
+		}
+		objectModel->getPackedDistancesToModel(hypothesis, points, pointIndices, begin, end, distances);
+
+		unsigned int chunkLength = end - begin;
+		if (scoringFunction == inlierCount) {
+			for (unsigned int i = 0; i < chunkLength; ++i) {
+				score.numberOfInliers += (distances[i] < threshold) ? 1 : 0;
+			}
+		} else {
+			for (unsigned int i = 0; i < chunkLength; ++i) {
+				score.residualPenalty += std::min(distances[i], threshold);
+				score.numberOfInliers += (distances[i] <= threshold) ? 1 : 0;
+			}
+		}
+		begin = end;
+
+		if (!bestScore.isValid) {
+			continue;
+		}
+
+		/* pretest: the inlier ratio of the sample is less than half of the best inlier ratio */
+		if (end == pretestEnd &&
+				2.0 * score.numberOfInliers * numberOfPoints < static_cast<double>(bestScore.numberOfInliers) * pretestEnd) {
+			return Score();
+		}
+
+		/* the hypothesis cannot beat the best one anymore, even if all remaining points fit perfectly */
+		if (scoringFunction == inlierCount) {
+			if (score.numberOfInliers + (numberOfPoints - end) <= bestScore.numberOfInliers) {
+				return Score();
+			}
+		} else {
+			if (score.residualPenalty >= bestScore.residualPenalty) {
+				return Score();
+			}
+		}
+	}
+
+	score.isValid = true;
+	return score;
+}
+
+bool SACHypothesisEvaluator::isBetter(const Score& candidate, const Score& reference) const {
+	if (!candidate.isValid) {
+		return false;
+	}
+	if (!reference.isValid) {
+		return true;
+	}
+	if (scoringFunction == inlierCount) {
+		return candidate.numberOfInliers > reference.numberOfInliers;
+	}
+	return candidate.residualPenalty < reference.residualPenalty;
+}
+
+unsigned int SACHypothesisEvaluator::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void SACHypothesisEvaluator::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+unsigned int SACHypothesisEvaluator::getPretestSize() const {
+	return pretestSize;
+}
+
+void SACHypothesisEvaluator::setPretestSize(unsigned int pretestSize) {
+	this->pretestSize = pretestSize;
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,173 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_SACHYPOTHESISEVALUATOR_H_
+#define BRICS_3D_SACHYPOTHESISEVALUATOR_H_
+
+#include "brics_3d/algorithm/segmentation/objectModels/IObjectModel.h"
+
+#include <vector>
+
+namespace brics_3d {
+
+/**
+ * @brief Scores batches of model hypotheses for the sample consensus methods.
+ * @ingroup segmentation
+ *
+ * The classic SAC loop scores one hypothesis at a time and creates the full inlier index vector for each of them.
+ * This evaluator is used by the batch mode of the SAC methods (see ISACMethods::setHypothesesPerBatch()):
+ *  - The input point cloud of the object model is packed once into a PointCloud3DSoA, in a random order.
+ *    Distances are computed chunk wise with IObjectModel::getPackedDistancesToModel().
+ *  - A hypothesis only yields a Score (number of inliers, truncated residual). Inlier indices are
+ *    created by the SAC method for the final winner only.
+ *  - The hypotheses of a batch are distributed among several worker threads (see setNumberOfThreads()).
+ *  - Hypotheses that cannot beat the best score so far are rejected early: after each chunk it is checked if the
+ *    hypothesis can still win. This test does not change the result. Optionally, a pretest on the first
+ *    points (a random sample, as the points are shuffled) rejects hypotheses whose inlier ratio is less than
+ *    half of the best one (see setPretestSize()).
+ *
+ * All hypotheses of a batch are compared against the same best score, thus the result does not depend on
+ * the number of threads.
+ */
+class SACHypothesisEvaluator {
+public:
+
+	/**
+	 * @brief The function that rates a hypothesis.
+	 */
+	enum ScoringFunction {
+		inlierCount,        ///< Maximize the number of points with a distance below the threshold (RANSAC).
+		truncatedResidual   ///< Minimize the sum of distances, truncated at the threshold (MSAC).
+	};
+
+	/**
+	 * @brief The rating of a hypothesis.
+	 */
+	class Score {
+	public:
+		Score() : numberOfInliers(0), residualPenalty(DBL_MAX), isValid(false) {};
+
+		/// Number of points within the distance threshold.
+		unsigned int numberOfInliers;
+
+		/// Sum of the distances, truncated at the threshold. Only computed for the truncatedResidual scoring function.
+		double residualPenalty;
+
+		/// False if the hypothesis was rejected early or not evaluated yet.
+		bool isValid;
+	};
+
+	/**
+	 * @brief Constructor that packs the input point cloud of the object model.
+	 * @param objectModel The object model with an input point cloud. Has to stay valid as long as the evaluator is used.
+	 * @param threshold The distance threshold for inliers.
+	 * @param scoringFunction The function that rates a hypothesis.
+	 */
+	SACHypothesisEvaluator(IObjectModel* objectModel, double threshold, ScoringFunction scoringFunction);
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~SACHypothesisEvaluator();
+
+	/**
+	 * @brief Score a batch of hypotheses.
+	 * @param[in] hypotheses The model coefficients of the hypotheses.
+	 * @param[in] bestScore Score of the best hypothesis so far. Hypotheses that cannot beat it are rejected early.
+	 * An invalid score disables the early rejection.
+	 * @param[out] scores One score per hypothesis.
+	 */
+	void evaluate(const std::vector<Eigen::VectorXd>& hypotheses, const Score& bestScore, std::vector<Score>& scores) const;
+
+	/**
+	 * @brief Check whether a score is better than another one with respect to the scoring function.
+	 * @param candidate The score in question.
+	 * @param reference The score to compare with, e.g. the best one so far.
+	 * @return True if candidate is valid and strictly better than reference.
+	 */
+	bool isBetter(const Score& candidate, const Score& reference) const;
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/**
+	 * @brief Get the number of points of the pretest.
+	 * @return The number of points.
+	 */
+	unsigned int getPretestSize() const;
+
+	/**
+	 * @brief Set the number of points of the pretest.
+	 * @param pretestSize Number of (randomly chosen) points that a hypothesis is tested on first. 0 disables the
+	 * pretest (default).
+	 */
+	void setPretestSize(unsigned int pretestSize);
+
+	/// Number of points whose distances are computed at once.
+	static const unsigned int chunkSize;
+
+	/// Minimal number of point to model distances that are assigned to a worker thread. Smaller batches are processed by fewer threads.
+	static const unsigned int minDistancesPerThread;
+
+private:
+
+	/// Score the hypotheses with the indices first, first + stride, first + 2*stride, ...
+	void evaluateHypotheses(const std::vector<Eigen::VectorXd>* hypotheses, const Score* bestScore,
+			std::vector<Score>* scores, unsigned int first, unsigned int stride) const;
+
+	/// Score a single hypothesis. distances is a buffer of chunkSize elements.
+	Score evaluateHypothesis(const Eigen::VectorXd& hypothesis, const Score& bestScore, double* distances) const;
+
+	/// The model that computes the distances.
+	IObjectModel* objectModel;
+
+	/// Distance threshold for inliers.
+	double threshold;
+
+	/// Function that rates a hypothesis.
+	ScoringFunction scoringFunction;
+
+	/// The shuffled coordinates of the input point cloud.
+	PointCloud3DSoA<Coordinate> points;
+
+	/// The index of each shuffled point in the input point cloud.
+	std::vector<int> pointIndices;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
+
+	/// Number of points for the pretest
+	unsigned int pretestSize;
+};
+
+}
+
+#endif /* BRICS_3D_SACHYPOTHESISEVALUATOR_H_ */
+
+/* EOF */
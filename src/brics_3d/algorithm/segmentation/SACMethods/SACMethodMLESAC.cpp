@@ -156,9 +156,9 @@ void SACMethodMLESAC::computeMedian (PointCloud3D *cloud, Eigen::Vector4f &media
 
 	for (size_t i = 0; i < cloud->getSize(); ++i)
 	{
-		x[i] = (*cloud->getPointCloud())[i].getX();
-		y[i] = (*cloud->getPointCloud())[i].getY();;
-		z[i] = (*cloud->getPointCloud())[i].getZ();;
+		x[i] = (*cloud->getConstPointCloud())[i].getX();
+		y[i] = (*cloud->getConstPointCloud())[i].getY();;
+		z[i] = (*cloud->getConstPointCloud())[i].getZ();;
 	}
 
 	std::sort (x.begin (), x.end ());
@@ -195,7 +195,7 @@ double SACMethodMLESAC::computeMedianAbsoluteDeviation (PointCloud3D *cloud,doub
 	{
 		for (size_t i = 0; i < cloud->getSize(); ++i)
 		{
-			pt = Eigen::Vector4f ((*cloud->getPointCloud())[i].getX(), (*cloud->getPointCloud())[i].getY(), (*cloud->getPointCloud())[i].getZ(), 0);
+			pt = Eigen::Vector4f ((*cloud->getConstPointCloud())[i].getX(), (*cloud->getConstPointCloud())[i].getY(), (*cloud->getConstPointCloud())[i].getZ(), 0);
 			pt -= median;
 			distances[i] = pt.dot (pt);
 		}
@@ -222,13 +222,13 @@ void SACMethodMLESAC::getMinMax (PointCloud3D *cloud, Eigen::Vector4d &minP, Eig
 
 	for (size_t i = 0; i < cloud->getSize(); ++i)
 	{
-		if ((*cloud->getPointCloud())[i].getX() < minP[0]) minP[0] = (*cloud->getPointCloud())[i].getX();
-		if ((*cloud->getPointCloud())[i].getY() < minP[1]) minP[1] = (*cloud->getPointCloud())[i].getY();
-		if ((*cloud->getPointCloud())[i].getZ() < minP[2]) minP[2] = (*cloud->getPointCloud())[i].getZ();
+		if ((*cloud->getConstPointCloud())[i].getX() < minP[0]) minP[0] = (*cloud->getConstPointCloud())[i].getX();
+		if ((*cloud->getConstPointCloud())[i].getY() < minP[1]) minP[1] = (*cloud->getConstPointCloud())[i].getY();
+		if ((*cloud->getConstPointCloud())[i].getZ() < minP[2]) minP[2] = (*cloud->getConstPointCloud())[i].getZ();
 
-		if ((*cloud->getPointCloud())[i].getX() > maxP[0]) maxP[0] = (*cloud->getPointCloud())[i].getX();
-		if ((*cloud->getPointCloud())[i].getY() > maxP[1]) maxP[1] = (*cloud->getPointCloud())[i].getY();
-		if ((*cloud->getPointCloud())[i].getZ() > maxP[2]) maxP[2] = (*cloud->getPointCloud())[i].getZ();
+		if ((*cloud->getConstPointCloud())[i].getX() > maxP[0]) maxP[0] = (*cloud->getConstPointCloud())[i].getX();
+		if ((*cloud->getConstPointCloud())[i].getY() > maxP[1]) maxP[1] = (*cloud->getConstPointCloud())[i].getY();
+		if ((*cloud->getConstPointCloud())[i].getZ() > maxP[2]) maxP[2] = (*cloud->getConstPointCloud())[i].getZ();
 	}
 
 }
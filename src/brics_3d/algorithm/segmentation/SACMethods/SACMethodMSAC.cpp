@@ -6,6 +6,7 @@
  */
 
 #include "SACMethodMSAC.h"
+#include "SACHypothesisEvaluator.h"
 
 namespace brics_3d {
 
@@ -22,6 +23,9 @@ bool SACMethodMSAC::computeModel(){
 		return (false);
 	}
 
+	if (this->hypothesesPerBatch > 1)
+		return (computeModelInBatches ());
+
 	this->iterations = 0;
 	double minResidualPenaltyFound = DBL_MAX;
 	double k = 1.0;
@@ -108,4 +112,81 @@ bool SACMethodMSAC::computeModel(){
 
 }
 
+bool SACMethodMSAC::computeModelInBatches(){
+
+	SACHypothesisEvaluator evaluator (this->objectModel, this->threshold, SACHypothesisEvaluator::truncatedResidual);
+	evaluator.setNumberOfThreads (this->numberOfThreads);
+	evaluator.setPretestSize (this->pretestSize);
+
+	this->iterations = 0;
+	this->inliers.clear ();
+	double k = 1.0;
+	bool isDegenerate = true;
+
+	SACHypothesisEvaluator::Score bestScore;
+	std::vector<Eigen::VectorXd> hypotheses;
+	std::vector<SACHypothesisEvaluator::Score> scores;
+	Eigen::VectorXd estimatedModelCoefficients;
+	std::vector<double> distances;
+
+	while (this->iterations < k && isDegenerate)
+	{
+		//Generate a batch of random models. The random sampling itself is cheap and not thread safe,
+		//so only the scoring is done in parallel.
+		hypotheses.clear ();
+		while (hypotheses.size () < this->hypothesesPerBatch && this->iterations <= this->maxIterations)
+		{
+			bool modelFound = false;
+			this->objectModel->computeRandomModel(this->iterations,estimatedModelCoefficients,isDegenerate,modelFound);
+			if (!isDegenerate) break;
+
+			this->iterations++;
+			if (modelFound)
+				hypotheses.push_back (estimatedModelCoefficients);
+		}
+
+		//Compute the residual penalties of all models of the batch, compared against the best model so far
+		evaluator.evaluate (hypotheses, bestScore, scores);
+		for (size_t i = 0; i < hypotheses.size (); ++i)
+		{
+			if (evaluator.isBetter (scores[i], bestScore))
+			{
+				bestScore = scores[i];
+				this->modelCoefficients = hypotheses[i];
+				k = computeRequiredIterations (bestScore.numberOfInliers);
+			}
+		}
+
+		if (this->iterations > this->maxIterations)
+		{
+				cout<<"[MSAC::computeModel] MSAC reached the maximum number of trials."<<endl;
+			break;
+		}
+	}
+
+	if (!bestScore.isValid)
+	{
+		cout<<"[MSAC::computeModel] Unable to find a solution!"<<endl;
+		return (false);
+	}
+
+	//Only the inliers of the final model are extracted
+	this->objectModel->getDistancesToModel (this->modelCoefficients, distances);
+
+	this->inliers.resize (distances.size ());
+	int noInliers = 0;
+	for (size_t i = 0; i < distances.size (); ++i)
+		if (distances[i] <= this->threshold)
+			this->inliers[noInliers++] = i;
+	this->inliers.resize (noInliers);
+
+	if (this->inliers.size () == 0)
+	{
+		cout<<"[MSAC::computeModel] Unable to find a solution!"<<endl;
+		return (false);
+	}
+
+	return (true);
+}
+
 }
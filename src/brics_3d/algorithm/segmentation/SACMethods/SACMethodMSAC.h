@@ -27,6 +27,11 @@ public:
 	SACMethodMSAC();
 	bool computeModel();
 	virtual ~SACMethodMSAC();
+
+private:
+
+	/** @brief Compute the model with batches of hypotheses, see setHypothesesPerBatch(). */
+	bool computeModelInBatches ();
 };
 
 }
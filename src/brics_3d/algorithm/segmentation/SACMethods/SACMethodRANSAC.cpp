@@ -6,6 +6,7 @@
  */
 
 #include "SACMethodRANSAC.h"
+#include "SACHypothesisEvaluator.h"
 
 namespace brics_3d {
 
@@ -23,6 +24,8 @@ bool SACMethodRANSAC::computeModel(){
        return (false);
      }
 
+     if (this->hypothesesPerBatch > 1)
+       return (computeModelInBatches ());
 
      this->iterations = 0;
      int noMaxInliersFound = std::numeric_limits<int>::min();
@@ -95,4 +98,70 @@ bool SACMethodRANSAC::computeModel(){
      return (true);
 }
 
+bool SACMethodRANSAC::computeModelInBatches(){
+
+     SACHypothesisEvaluator evaluator (this->objectModel, this->threshold, SACHypothesisEvaluator::inlierCount);
+     evaluator.setNumberOfThreads (this->numberOfThreads);
+     evaluator.setPretestSize (this->pretestSize);
+
+     this->iterations = 0;
+     this->inliers.clear ();
+     double k = 1.0;
+     bool isDegenerate = true;
+
+     SACHypothesisEvaluator::Score bestScore;
+     std::vector<Eigen::VectorXd> hypotheses;
+     std::vector<SACHypothesisEvaluator::Score> scores;
+     Eigen::VectorXd estimatedModelCoefficients;
+
+     while (this->iterations < k && isDegenerate)
+     {
+
+       //Generate a batch of random models. The random sampling itself is cheap and not thread safe,
+       //so only the scoring is done in parallel.
+       hypotheses.clear ();
+       while (hypotheses.size () < this->hypothesesPerBatch && this->iterations <= this->maxIterations)
+       {
+         bool modelFound = false;
+         this->objectModel->computeRandomModel(this->iterations,estimatedModelCoefficients,isDegenerate,modelFound);
+         if (!isDegenerate) break;
+
+         this->iterations++;
+         if (modelFound)
+           hypotheses.push_back (estimatedModelCoefficients);
+       }
+
+
+       //Count the inliers of all models of the batch, compared against the best model so far
+       evaluator.evaluate (hypotheses, bestScore, scores);
+       for (size_t i = 0; i < hypotheses.size (); ++i)
+       {
+         if (evaluator.isBetter (scores[i], bestScore))
+         {
+           bestScore = scores[i];
+           this->modelCoefficients = hypotheses[i];
+           k = computeRequiredIterations (bestScore.numberOfInliers);
+         }
+       }
+
+
+       if (this->iterations > this->maxIterations)
+       {
+           cout<<"[RANSAC::computeModel] RANSAC reached the maximum number of trials";
+         break;
+       }
+
+     }
+
+
+     //Only the inliers of the final model are extracted
+     if (!bestScore.isValid)
+       return (false);
+     this->objectModel->selectWithinDistance (this->modelCoefficients, this->threshold, this->inliers);
+
+     if (this->inliers.size() == 0)
+       return (false);
+     return (true);
+}
+
 }
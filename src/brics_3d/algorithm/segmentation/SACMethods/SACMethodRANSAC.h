@@ -28,6 +28,11 @@ public:
 	SACMethodRANSAC();
 	bool computeModel ();
 	virtual ~SACMethodRANSAC();
+
+private:
+
+	/** @brief Compute the model with batches of hypotheses, see setHypothesesPerBatch(). */
+	bool computeModelInBatches ();
 };
 
 }
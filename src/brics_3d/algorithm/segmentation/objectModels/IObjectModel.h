@@ -22,10 +22,14 @@
 
 #include <Eigen/Geometry>
 #include <set>
+#include <vector>
+#include <algorithm>
 #include <float.h>
+#include <assert.h>
 
 #include "brics_3d/core/Point3D.h"
 #include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/PointCloud3DSoA.h"
 #include "brics_3d/algorithm/featureExtraction/NormalEstimation.h"
 
 
@@ -104,6 +108,36 @@ public:
 	virtual void getInlierDistance (std::vector<int> &inliers,
 			const Eigen::VectorXd &model_coefficients,  std::vector<double> &distances)= 0;
 
+	/** @brief Compute the distances of a range of packed points to a given model.
+	 *
+	 * This is used for the batch evaluation of hypotheses (see SACHypothesisEvaluator) and is called
+	 * concurrently, so implementations must not modify the object model. The default implementation forwards
+	 * the original indices of the points to getInlierDistance(); models with a simple closed form distance
+	 * override it with a kernel that works directly on the coordinate arrays.
+	 * Points that cannot belong to the model at all (e.g. because the model violates some constraints) get
+	 * a distance of DBL_MAX.
+	 * @param model_coefficients the coefficients of a model that we need to compute distances to
+	 * @param points the (possibly reordered) coordinates of the input point cloud
+	 * @param indices the index of each of the packed points in the input point cloud
+	 * @param begin index of the first packed point
+	 * @param end index behind the last packed point
+	 * @param distances the resultant distances. Has to provide space for end - begin values.
+	 */
+	virtual void getPackedDistancesToModel (const Eigen::VectorXd &model_coefficients, const PointCloud3DSoA<Coordinate> &points,
+			const std::vector<int> &indices, unsigned int begin, unsigned int end, double* distances)
+	{
+		assert(begin <= end && end <= points.getSize() && points.getSize() == indices.size());
+		std::vector<int> rangeIndices (indices.begin() + begin, indices.begin() + end);
+		std::vector<double> rangeDistances;
+		getInlierDistance (rangeIndices, model_coefficients, rangeDistances);
+
+		if (rangeDistances.size() < rangeIndices.size()) {
+			std::fill (distances, distances + (end - begin), DBL_MAX);
+			return;
+		}
+		std::copy (rangeDistances.begin(), rangeDistances.begin() + (end - begin), distances);
+	}
+
 
 	/** @brief Verify whether a subset of indices verifies a given set of model coefficients. Pure virtual.
 	 * @param indices the data indices that need to be tested against the model
@@ -81,13 +81,13 @@ bool ObjectModelLine::computeModelCoefficients (const std::vector<int> &samples,
 	assert (samples.size () == 2);
 
 	model_coefficients.resize (6);
-	model_coefficients[0] = (*inputPointCloud->getPointCloud())[samples[0]].getX();
-	model_coefficients[1] = (*inputPointCloud->getPointCloud())[samples[0]].getY();
-	model_coefficients[2] = (*inputPointCloud->getPointCloud())[samples[0]].getZ();
+	model_coefficients[0] = (*inputPointCloud->getConstPointCloud())[samples[0]].getX();
+	model_coefficients[1] = (*inputPointCloud->getConstPointCloud())[samples[0]].getY();
+	model_coefficients[2] = (*inputPointCloud->getConstPointCloud())[samples[0]].getZ();
 
-	model_coefficients[3] = (*inputPointCloud->getPointCloud())[samples[1]].getX() - model_coefficients[0];
-	model_coefficients[4] = (*inputPointCloud->getPointCloud())[samples[1]].getY() - model_coefficients[1];
-	model_coefficients[5] = (*inputPointCloud->getPointCloud())[samples[1]].getZ() - model_coefficients[2];
+	model_coefficients[3] = (*inputPointCloud->getConstPointCloud())[samples[1]].getX() - model_coefficients[0];
+	model_coefficients[4] = (*inputPointCloud->getConstPointCloud())[samples[1]].getY() - model_coefficients[1];
+	model_coefficients[5] = (*inputPointCloud->getConstPointCloud())[samples[1]].getZ() - model_coefficients[2];
 
 #ifdef EIGEN3
 	model_coefficients.tail<3> ().normalize ();
@@ -154,8 +154,8 @@ void ObjectModelLine::getDistancesToModel (const Eigen::VectorXd &model_coeffici
 	{
 		// Calculate the distance from the point to the line
 		// D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-		Eigen::Vector4d pt ((*inputPointCloud->getPointCloud())[i].getX(), (*inputPointCloud->getPointCloud())[i].getY(),
-				(*inputPointCloud->getPointCloud())[i].getZ(), 0);
+		Eigen::Vector4d pt ((*inputPointCloud->getConstPointCloud())[i].getX(), (*inputPointCloud->getConstPointCloud())[i].getY(),
+				(*inputPointCloud->getConstPointCloud())[i].getZ(), 0);
 		Eigen::Vector4d pp = line_p2 - pt;
 
 #ifdef EIGEN3
@@ -187,8 +187,8 @@ void ObjectModelLine::selectWithinDistance (const Eigen::VectorXd &model_coeffic
 	{
 		// Calculate the distance from the point to the line
 		// D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-		Eigen::Vector4d pt ((*inputPointCloud->getPointCloud())[i].getX(),
-				(*inputPointCloud->getPointCloud())[i].getY(), (*inputPointCloud->getPointCloud())[i].getZ(), 0);
+		Eigen::Vector4d pt ((*inputPointCloud->getConstPointCloud())[i].getX(),
+				(*inputPointCloud->getConstPointCloud())[i].getY(), (*inputPointCloud->getConstPointCloud())[i].getZ(), 0);
 		Eigen::Vector4d pp = line_p2 - pt;
 
 #ifdef EIGEN3
@@ -215,7 +215,7 @@ void ObjectModelLine::getInlierDistance (std::vector<int> &inliers, const Eigen:
 
 	assert (model_coefficients.size () == 6);
 
-	distances.resize (this->inputPointCloud->getSize());
+	distances.resize (inliers.size());
 
 	// Obtain the line point and direction
 	Eigen::Vector4d line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
@@ -223,12 +223,12 @@ void ObjectModelLine::getInlierDistance (std::vector<int> &inliers, const Eigen:
 	Eigen::Vector4d line_p2 = line_pt + line_dir;
 
 	// Iterate through the 3d points and calculate the distances from them to the line
-	for (size_t i = 0; i < this->inputPointCloud->getSize(); ++i)
+	for (size_t i = 0; i < inliers.size(); ++i)
 	{
 		// Calculate the distance from the point to the line
 		// D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-		Eigen::Vector4d pt ((*inputPointCloud->getPointCloud())[inliers[i]].getX(), (*inputPointCloud->getPointCloud())[inliers[i]].getY(),
-				(*inputPointCloud->getPointCloud())[inliers[i]].getZ(), 0);
+		Eigen::Vector4d pt ((*inputPointCloud->getConstPointCloud())[inliers[i]].getX(), (*inputPointCloud->getConstPointCloud())[inliers[i]].getY(),
+				(*inputPointCloud->getConstPointCloud())[inliers[i]].getZ(), 0);
 		Eigen::Vector4d pp = line_p2 - pt;
 
 #ifdef EIGEN3
@@ -255,8 +255,8 @@ void ObjectModelLine::projectPoints (const std::vector<int> &inliers, const Eige
 	// Iterate through the 3d points and calculate the distances from them to the line
 	for (size_t i = 0; i < inliers.size (); ++i)
 	{
-		Eigen::Vector4d pt ((*inputPointCloud->getPointCloud())[inliers[i]].getX(), (*inputPointCloud->getPointCloud())[inliers[i]].getY(),
-				(*inputPointCloud->getPointCloud())[inliers[i]].getZ(), 0);
+		Eigen::Vector4d pt ((*inputPointCloud->getConstPointCloud())[inliers[i]].getX(), (*inputPointCloud->getConstPointCloud())[inliers[i]].getY(),
+				(*inputPointCloud->getConstPointCloud())[inliers[i]].getZ(), 0);
 		// double k = (DOT_PROD_3D (points[i], p21) - dotA_B) / dotB_B;
 		double k = (pt.dot (line_dir) - line_pt.dot (line_dir)) / line_dir.dot (line_dir);
 
@@ -287,8 +287,8 @@ bool ObjectModelLine::doSamplesVerifyModel (const std::set<int> &indices, const
      {
        // Calculate the distance from the point to the line
        // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1|| = norm (cross (p2-p1, p2-p0)) / norm(p2-p1)
-       Eigen::Vector4d pt ((*inputPointCloud->getPointCloud())[*it].getX(), (*inputPointCloud->getPointCloud())[*it].getY(),
-    		   (*inputPointCloud->getPointCloud())[*it].getZ(), 0);
+       Eigen::Vector4d pt ((*inputPointCloud->getConstPointCloud())[*it].getX(), (*inputPointCloud->getConstPointCloud())[*it].getY(),
+    		   (*inputPointCloud->getConstPointCloud())[*it].getZ(), 0);
        Eigen::Vector4d pp = line_p2 - pt;
 
 #ifdef EIGEN3
@@ -70,8 +70,8 @@ void ObjectModelNormalPlane::getSamples(int &iterations, std::vector<int> &sampl
 	// Get the values at the two points
 	Eigen::Vector4d p0, p1, p2;
 	// SSE friendly data check
-	p1 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[1]].getX(), (*inputPointCloud->getPointCloud())[samples[1]].getY(), (*inputPointCloud->getPointCloud())[samples[1]].getZ(), 0);
-	p0 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[0]].getX(), (*inputPointCloud->getPointCloud())[samples[0]].getY(), (*inputPointCloud->getPointCloud())[samples[0]].getZ(), 0);
+	p1 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[1]].getX(), (*inputPointCloud->getConstPointCloud())[samples[1]].getY(), (*inputPointCloud->getConstPointCloud())[samples[1]].getZ(), 0);
+	p0 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[0]].getX(), (*inputPointCloud->getConstPointCloud())[samples[0]].getY(), (*inputPointCloud->getConstPointCloud())[samples[0]].getZ(), 0);
 
 	// Compute the segment values (in 3d) between p1 and p0
 	p1 -= p0;
@@ -90,7 +90,7 @@ void ObjectModelNormalPlane::getSamples(int &iterations, std::vector<int> &sampl
 		iterations--;
 
 		// SSE friendly data check
-		p2 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[2]].getX(), (*inputPointCloud->getPointCloud())[samples[2]].getY(), (*inputPointCloud->getPointCloud())[samples[2]].getZ(), 0);
+		p2 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[2]].getX(), (*inputPointCloud->getConstPointCloud())[samples[2]].getY(), (*inputPointCloud->getConstPointCloud())[samples[2]].getZ(), 0);
 
 		// Compute the segment values (in 3d) between p2 and p0
 		p2 -= p0;
@@ -122,9 +122,9 @@ bool ObjectModelNormalPlane::computeModelCoefficients (const std::vector<int> &s
 
 	Eigen::Vector4d p0, p1, p2;
 	// SSE friendly data check
-	p0 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[0]].getX(), (*inputPointCloud->getPointCloud())[samples[0]].getY(), (*inputPointCloud->getPointCloud())[samples[0]].getZ(), 0);
-	p1 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[1]].getX(), (*inputPointCloud->getPointCloud())[samples[1]].getY(), (*inputPointCloud->getPointCloud())[samples[1]].getZ(), 0);
-	p2 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[2]].getX(), (*inputPointCloud->getPointCloud())[samples[2]].getY(), (*inputPointCloud->getPointCloud())[samples[2]].getZ(), 0);
+	p0 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[0]].getX(), (*inputPointCloud->getConstPointCloud())[samples[0]].getY(), (*inputPointCloud->getConstPointCloud())[samples[0]].getZ(), 0);
+	p1 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[1]].getX(), (*inputPointCloud->getConstPointCloud())[samples[1]].getY(), (*inputPointCloud->getConstPointCloud())[samples[1]].getZ(), 0);
+	p2 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[2]].getX(), (*inputPointCloud->getConstPointCloud())[samples[2]].getY(), (*inputPointCloud->getConstPointCloud())[samples[2]].getZ(), 0);
 
 	// Compute the segment values (in 3d) between p1 and p0
 	p1 -= p0;
@@ -169,9 +169,9 @@ ObjectModelNormalPlane::getInlierDistance (std::vector<int> &inliers, const Eige
 	{
 		// Calculate the distance from the point to the plane normal as the dot product
 		// D = (P-A).N/|N|
-		distances[i]=fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[inliers[i]].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[inliers[i]].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[inliers[i]].getZ() +
+		distances[i]=fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getZ() +
 				model_coefficients[3]);
 	}
 }
@@ -184,9 +184,9 @@ ObjectModelNormalPlane::doSamplesVerifyModel (const std::set<int> &indices,
 	assert (model_coefficients.size () == 4);
 
 	for (std::set<int>::iterator it = indices.begin (); it != indices.end (); ++it)
-		if (fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[*it].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[*it].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[*it].getZ() +
+		if (fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[*it].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[*it].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[*it].getZ() +
 				model_coefficients[3]) > threshold)
 			return (false);
 
@@ -234,8 +234,8 @@ void
     {
       // Calculate the distance from the point to the plane normal as the dot product
       // D = (P-A).N/|N|
-      Eigen::Vector4d p = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[i].getX(),
-    		  (*inputPointCloud->getPointCloud())[i].getY(), (*inputPointCloud->getPointCloud())[i].getZ(), 0);
+      Eigen::Vector4d p = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[i].getX(),
+    		  (*inputPointCloud->getConstPointCloud())[i].getY(), (*inputPointCloud->getConstPointCloud())[i].getZ(), 0);
 
       Eigen::Vector4d n = Eigen::Vector4d (this->normals->getNormals()->data()[i].getX(),
     		  this->normals->getNormals()->data()[i].getY(),
@@ -301,8 +301,8 @@ void
     {
       // Calculate the distance from the point to the plane normal as the dot product
       // D = (P-A).N/|N|
-      Eigen::Vector4d p = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[i].getX(),
-    		  (*inputPointCloud->getPointCloud())[i].getY(), (*inputPointCloud->getPointCloud())[i].getZ(), 0);
+      Eigen::Vector4d p = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[i].getX(),
+    		  (*inputPointCloud->getConstPointCloud())[i].getY(), (*inputPointCloud->getConstPointCloud())[i].getZ(), 0);
 
       Eigen::Vector4d n = Eigen::Vector4d (this->normals->getNormals()->data()[i].getX(),
     		  this->normals->getNormals()->data()[i].getY(), this->normals->getNormals()->data()[i].getZ(), 0);
@@ -70,4 +70,29 @@ void ObjectModelOrientedPlane::getDistancesToModel (const Eigen::VectorXd &model
     this->getDistancesToModel (model_coefficients, distances);
 }
 
+
+void ObjectModelOrientedPlane::getPackedDistancesToModel (const Eigen::VectorXd &model_coefficients,
+		const PointCloud3DSoA<Coordinate> &points, const std::vector<int> &indices, unsigned int begin, unsigned int end, double* distances){
+    assert (model_coefficients.size () == 4);
+
+    // Obtain the plane normal
+    Eigen::Vector4d coeff = model_coefficients;
+    coeff[3] = 0;
+
+    // Check against template, if given
+    if (epsAngle > 0.0)
+    {
+      double angleDifference = fabs (getAngle3D (axis, coeff));
+      angleDifference = fmin (angleDifference, M_PI - angleDifference);
+      // No point can be an inlier of a plane that violates the angle threshold criterion
+      if (angleDifference > epsAngle)
+      {
+        std::fill (distances, distances + (end - begin), DBL_MAX);
+        return;
+      }
+    }
+
+    ObjectModelPlane::getPackedDistancesToModel (model_coefficients, points, indices, begin, end, distances);
+}
+
 }
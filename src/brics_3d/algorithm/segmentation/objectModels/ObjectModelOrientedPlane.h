@@ -81,6 +81,8 @@ public:
     void selectWithinDistance (const Eigen::VectorXd &model_coefficients, double threshold,
     			std::vector<int> &inliers);
     void getDistancesToModel (const Eigen::VectorXd &model_coefficients, std::vector<double> &distances);
+    void getPackedDistancesToModel (const Eigen::VectorXd &model_coefficients, const PointCloud3DSoA<Coordinate> &points,
+    		const std::vector<int> &indices, unsigned int begin, unsigned int end, double* distances);
 
 };
 }
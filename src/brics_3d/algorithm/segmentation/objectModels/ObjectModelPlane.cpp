@@ -69,8 +69,8 @@ void ObjectModelPlane::getSamples(int &iterations, std::vector<int> &samples){
 	// Get the values at the two points
 	Eigen::Vector4d p0, p1, p2;
 	// SSE friendly data check
-	p1 = Eigen::Vector4d ( (*inputPointCloud->getPointCloud())[samples[1]].getX(), (*inputPointCloud->getPointCloud())[samples[1]].getY(), (*inputPointCloud->getPointCloud())[samples[1]].getZ(), 0);
-	p0 = Eigen::Vector4d ( (*inputPointCloud->getPointCloud())[samples[0]].getX(), (*inputPointCloud->getPointCloud())[samples[0]].getY(), (*inputPointCloud->getPointCloud())[samples[0]].getZ(), 0);
+	p1 = Eigen::Vector4d ( (*inputPointCloud->getConstPointCloud())[samples[1]].getX(), (*inputPointCloud->getConstPointCloud())[samples[1]].getY(), (*inputPointCloud->getConstPointCloud())[samples[1]].getZ(), 0);
+	p0 = Eigen::Vector4d ( (*inputPointCloud->getConstPointCloud())[samples[0]].getX(), (*inputPointCloud->getConstPointCloud())[samples[0]].getY(), (*inputPointCloud->getConstPointCloud())[samples[0]].getZ(), 0);
 
 	// Compute the segment values (in 3d) between p1 and p0
 	p1 -= p0;
@@ -89,7 +89,7 @@ void ObjectModelPlane::getSamples(int &iterations, std::vector<int> &samples){
 		iterations--;
 
 		// SSE friendly data check
-		p2 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[2]].getX(), (*inputPointCloud->getPointCloud())[samples[2]].getY(), (*inputPointCloud->getPointCloud())[samples[2]].getZ(), 0);
+		p2 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[2]].getX(), (*inputPointCloud->getConstPointCloud())[samples[2]].getY(), (*inputPointCloud->getConstPointCloud())[samples[2]].getZ(), 0);
 
 		// Compute the segment values (in 3d) between p2 and p0
 		p2 -= p0;
@@ -119,9 +119,9 @@ bool ObjectModelPlane::computeModelCoefficients (const std::vector<int> &samples
 
 	Eigen::Vector4d p0, p1, p2;
 	// SSE friendly data check
-	p0 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[0]].getX(), (*inputPointCloud->getPointCloud())[samples[0]].getY(), (*inputPointCloud->getPointCloud())[samples[0]].getZ(), 0);
-	p1 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[1]].getX(), (*inputPointCloud->getPointCloud())[samples[1]].getY(), (*inputPointCloud->getPointCloud())[samples[1]].getZ(), 0);
-	p2 = Eigen::Vector4d ((*inputPointCloud->getPointCloud())[samples[2]].getX(), (*inputPointCloud->getPointCloud())[samples[2]].getY(), (*inputPointCloud->getPointCloud())[samples[2]].getZ(), 0);
+	p0 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[0]].getX(), (*inputPointCloud->getConstPointCloud())[samples[0]].getY(), (*inputPointCloud->getConstPointCloud())[samples[0]].getZ(), 0);
+	p1 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[1]].getX(), (*inputPointCloud->getConstPointCloud())[samples[1]].getY(), (*inputPointCloud->getConstPointCloud())[samples[1]].getZ(), 0);
+	p2 = Eigen::Vector4d ((*inputPointCloud->getConstPointCloud())[samples[2]].getX(), (*inputPointCloud->getConstPointCloud())[samples[2]].getY(), (*inputPointCloud->getConstPointCloud())[samples[2]].getZ(), 0);
 
 	// Compute the segment values (in 3d) between p1 and p0
 	p1 -= p0;
@@ -167,9 +167,9 @@ ObjectModelPlane::getDistancesToModel (const Eigen::VectorXd &model_coefficients
 	{
 		// Calculate the distance from the point to the plane normal as the dot product
 		// D = (P-A).N/|N|
-		distances[i] = fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[i].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[i].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[i].getZ() +
+		distances[i] = fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[i].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[i].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[i].getZ() +
 				model_coefficients[3]);
 	}
 }
@@ -188,9 +188,9 @@ ObjectModelPlane::selectWithinDistance (const Eigen::VectorXd &model_coefficient
 	{
 		// Calculate the distance from the point to the plane normal as the dot product
 		// D = (P-A).N/|N|
-		if (fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[i].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[i].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[i].getZ() +
+		if (fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[i].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[i].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[i].getZ() +
 				model_coefficients[3]) < threshold)
 		{
 			// Returns the indices of the points whose distances are smaller than the threshold
@@ -212,23 +212,55 @@ ObjectModelPlane::getInlierDistance (std::vector<int> &inliers, const Eigen::Vec
 	{
 		// Calculate the distance from the point to the plane normal as the dot product
 		// D = (P-A).N/|N|
-		distances[i]=fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[inliers[i]].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[inliers[i]].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[inliers[i]].getZ() +
+		distances[i]=fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[inliers[i]].getZ() +
 				model_coefficients[3]);
 	}
 }
 
 
+void
+ObjectModelPlane::getPackedDistancesToModel (const Eigen::VectorXd &model_coefficients, const PointCloud3DSoA<Coordinate> &points,
+		const std::vector<int> &/*indices*/, unsigned int begin, unsigned int end, double* distances)
+{
+	assert(model_coefficients.size() == 4);
+	assert(begin <= end && end <= points.getSize());
+	if (begin == end)
+		return;
+
+	const unsigned int size = end - begin;
+	const double a = model_coefficients[0];
+	const double b = model_coefficients[1];
+	const double c = model_coefficients[2];
+	const double d = model_coefficients[3];
+
+#ifdef EIGEN3
+	// D = |a*x + b*y + c*z + d| on whole coordinate arrays; Eigen vectorizes this expression
+	Eigen::Map<const Eigen::ArrayXd> x (points.getXCoordinates() + begin, size);
+	Eigen::Map<const Eigen::ArrayXd> y (points.getYCoordinates() + begin, size);
+	Eigen::Map<const Eigen::ArrayXd> z (points.getZCoordinates() + begin, size);
+	Eigen::Map<Eigen::ArrayXd> result (distances, size);
+	result = (a * x + b * y + c * z + d).abs ();
+#else
+	const double* x = points.getXCoordinates() + begin;
+	const double* y = points.getYCoordinates() + begin;
+	const double* z = points.getZCoordinates() + begin;
+	for (unsigned int i = 0; i < size; ++i)
+		distances[i] = fabs (a * x[i] + b * y[i] + c * z[i] + d);
+#endif
+}
+
+
 bool
 ObjectModelPlane::doSamplesVerifyModel (const std::set<int> &indices, const Eigen::VectorXd &model_coefficients, double threshold)
 {
 	assert(model_coefficients.size() == 4);
 
 	for (std::set<int>::iterator it = indices.begin (); it != indices.end (); ++it)
-		if (fabs (model_coefficients[0] * (*inputPointCloud->getPointCloud())[*it].getX() +
-				model_coefficients[1] * (*inputPointCloud->getPointCloud())[*it].getY() +
-				model_coefficients[2] * (*inputPointCloud->getPointCloud())[*it].getZ() +
+		if (fabs (model_coefficients[0] * (*inputPointCloud->getConstPointCloud())[*it].getX() +
+				model_coefficients[1] * (*inputPointCloud->getConstPointCloud())[*it].getY() +
+				model_coefficients[2] * (*inputPointCloud->getConstPointCloud())[*it].getZ() +
 				model_coefficients[3]) > threshold)
 			return (false);
 
@@ -67,6 +67,8 @@ public:
 			std::vector<int> &inliers);
 	void getInlierDistance (std::vector<int> &inliers, const Eigen::VectorXd &model_coefficients,  std::vector<double> &distances);
 	bool doSamplesVerifyModel (const std::set<int> &indices, const Eigen::VectorXd &model_coefficients, double threshold);
+	void getPackedDistancesToModel (const Eigen::VectorXd &model_coefficients, const PointCloud3DSoA<Coordinate> &points,
+			const std::vector<int> &indices, unsigned int begin, unsigned int end, double* distances);
 
 	void computeRandomModel (int &iterations, Eigen::VectorXd &model_coefficients, bool &isDegenerate, bool &modelFound);
 
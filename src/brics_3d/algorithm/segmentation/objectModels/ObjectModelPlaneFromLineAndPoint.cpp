@@ -72,8 +72,8 @@ void ObjectModelPlaneFromLineAndPoint::getSamples (int &iterations, std::vector<
 	// Get the values at the two points
 	Eigen::Vector4f p0, p1, p2;
 	// SSE friendly data check
-	p1 = Eigen::Vector4f ((*inputPointCloud->getPointCloud())[samples[1]].getX(), (*inputPointCloud->getPointCloud())[samples[1]].getY(), (*inputPointCloud->getPointCloud())[samples[1]].getZ(), 0);
-	p0 = Eigen::Vector4f ((*inputPointCloud->getPointCloud())[samples[0]].getX(), (*inputPointCloud->getPointCloud())[samples[0]].getY(), (*inputPointCloud->getPointCloud())[samples[0]].getZ(), 0);
+	p1 = Eigen::Vector4f ((*inputPointCloud->getConstPointCloud())[samples[1]].getX(), (*inputPointCloud->getConstPointCloud())[samples[1]].getY(), (*inputPointCloud->getConstPointCloud())[samples[1]].getZ(), 0);
+	p0 = Eigen::Vector4f ((*inputPointCloud->getConstPointCloud())[samples[0]].getX(), (*inputPointCloud->getConstPointCloud())[samples[0]].getY(), (*inputPointCloud->getConstPointCloud())[samples[0]].getZ(), 0);
 
 	// Compute the segment values (in 3d) between p1 and p0
 	p1 -= p0;
@@ -92,7 +92,7 @@ void ObjectModelPlaneFromLineAndPoint::getSamples (int &iterations, std::vector<
 		iterations--;
 
 		// SSE friendly data check
-		p2 = Eigen::Vector4f ((*inputPointCloud->getPointCloud())[samples[2]].getX(), (*inputPointCloud->getPointCloud())[samples[2]].getY(), (*inputPointCloud->getPointCloud())[samples[2]].getZ(), 0);
+		p2 = Eigen::Vector4f ((*inputPointCloud->getConstPointCloud())[samples[2]].getX(), (*inputPointCloud->getConstPointCloud())[samples[2]].getY(), (*inputPointCloud->getConstPointCloud())[samples[2]].getZ(), 0);
 
 		// Compute the segment values (in 3d) between p2 and p0
 		p2 -= p0;
@@ -122,17 +122,17 @@ ObjectModelPlaneFromLineAndPoint::computeModelCoefficients (const std::vector<in
 	line line1,line2;
 
 	//Create line1 from sample[0] and sample[1]
-	line1.pbase = (*inputPointCloud->getPointCloud())[sample[0]];
+	line1.pbase = (*inputPointCloud->getConstPointCloud())[sample[0]];
 	line1.director.resize(3);
-	line1.director[0]=(*inputPointCloud->getPointCloud())[sample[1]].getX() - (*inputPointCloud->getPointCloud())[sample[0]].getX();
-	line1.director[1]=(*inputPointCloud->getPointCloud())[sample[1]].getY() - (*inputPointCloud->getPointCloud())[sample[0]].getY();
-	line1.director[2]=(*inputPointCloud->getPointCloud())[sample[1]].getZ() - (*inputPointCloud->getPointCloud())[sample[0]].getZ();
+	line1.director[0]=(*inputPointCloud->getConstPointCloud())[sample[1]].getX() - (*inputPointCloud->getConstPointCloud())[sample[0]].getX();
+	line1.director[1]=(*inputPointCloud->getConstPointCloud())[sample[1]].getY() - (*inputPointCloud->getConstPointCloud())[sample[0]].getY();
+	line1.director[2]=(*inputPointCloud->getConstPointCloud())[sample[1]].getZ() - (*inputPointCloud->getConstPointCloud())[sample[0]].getZ();
 
 	//Compute the model coefficients
 
-	double dx1=(*inputPointCloud->getPointCloud())[sample[2]].getX()-line1.pbase.getX();
-	double dy1=(*inputPointCloud->getPointCloud())[sample[2]].getY()-line1.pbase.getY();
-	double dz1=(*inputPointCloud->getPointCloud())[sample[1]].getZ()-line1.pbase.getZ();
+	double dx1=(*inputPointCloud->getConstPointCloud())[sample[2]].getX()-line1.pbase.getX();
+	double dy1=(*inputPointCloud->getConstPointCloud())[sample[2]].getY()-line1.pbase.getY();
+	double dz1=(*inputPointCloud->getConstPointCloud())[sample[1]].getZ()-line1.pbase.getZ();
 
 	modelCoefficients.resize(4);
 
@@ -145,9 +145,9 @@ ObjectModelPlaneFromLineAndPoint::computeModelCoefficients (const std::vector<in
 		cout<<"Point is contained in the line"<<endl;
 		return false;
 	}
-	modelCoefficients[3]=-modelCoefficients[0]*(*inputPointCloud->getPointCloud())[sample[2]].getX()-
-			modelCoefficients[1]*(*inputPointCloud->getPointCloud())[sample[2]].getY()-
-			modelCoefficients[2]*(*inputPointCloud->getPointCloud())[sample[2]].getZ();
+	modelCoefficients[3]=-modelCoefficients[0]*(*inputPointCloud->getConstPointCloud())[sample[2]].getX()-
+			modelCoefficients[1]*(*inputPointCloud->getConstPointCloud())[sample[2]].getY()-
+			modelCoefficients[2]*(*inputPointCloud->getConstPointCloud())[sample[2]].getZ();
 
 	return true;
 }
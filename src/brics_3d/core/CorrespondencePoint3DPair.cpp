@@ -22,12 +22,22 @@
 namespace brics_3d {
 
 CorrespondencePoint3DPair::CorrespondencePoint3DPair() {
-
+	this->firstIndex = -1;
+	this->secondIndex = -1;
 }
 
 CorrespondencePoint3DPair::CorrespondencePoint3DPair(Point3D firstPoint, Point3D secondPoint) {
 	this->firstPoint = Point3D(firstPoint);
 	this->secondPoint = Point3D(secondPoint);
+	this->firstIndex = -1;
+	this->secondIndex = -1;
+}
+
+CorrespondencePoint3DPair::CorrespondencePoint3DPair(Point3D firstPoint, Point3D secondPoint, int firstIndex, int secondIndex) {
+	this->firstPoint = Point3D(firstPoint);
+	this->secondPoint = Point3D(secondPoint);
+	this->firstIndex = firstIndex;
+	this->secondIndex = secondIndex;
 }
 
 CorrespondencePoint3DPair::~CorrespondencePoint3DPair() {
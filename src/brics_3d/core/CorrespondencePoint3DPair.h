@@ -43,6 +43,15 @@ public:
 	 */
 	CorrespondencePoint3DPair(Point3D firstPoint, Point3D secondPoint);
 
+	/**
+	 * @brief Constructor that initializes the corresponding points and their indices
+	 * @param firstPoint Initialize the first point
+	 * @param secondPoint Initialize the second point
+	 * @param firstIndex Index of the first point in the first set
+	 * @param secondIndex Index of the second point in the second set
+	 */
+	CorrespondencePoint3DPair(Point3D firstPoint, Point3D secondPoint, int firstIndex, int secondIndex);
+
 	/**
 	 * @brief Standard destructor
 	 */
@@ -53,6 +62,12 @@ public:
 
 	/// Corresponding point in second set
 	Point3D secondPoint;
+
+	/// Index of the first point in the first set, -1 if unknown. Allows to look up per point data like normals.
+	int firstIndex;
+
+	/// Index of the second point in the second set, -1 if unknown.
+	int secondIndex;
 };
 
 }
@@ -0,0 +1,173 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "HomogeneousTransformationKernel.h"
+#include "ParallelExecution.h"
+
+#include <typeinfo>
+#include <assert.h>
+#include <boost/bind.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace brics_3d {
+
+namespace {
+
+/*
+ * Kernels for a single x,y,z triple. The overloads cover both possible Coordinate types;
+ * see HomogeneousTransformationKernel::coefficients for the layout of c.
+ */
+inline void transformTriple(const double* c, double& x, double& y, double& z) {
+#ifdef __SSE2__
+	__m128d xx = _mm_set1_pd(x);
+	__m128d yy = _mm_set1_pd(y);
+	__m128d zz = _mm_set1_pd(z);
+	__m128d resultXY = _mm_add_pd(
+			_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(&c[0]), xx), _mm_mul_pd(_mm_loadu_pd(&c[2]), yy)),
+			_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(&c[4]), zz), _mm_loadu_pd(&c[6])));
+	z = x * c[8] + y * c[9] + z * c[10] + c[11];
+	_mm_storel_pd(&x, resultXY);
+	_mm_storeh_pd(&y, resultXY);
+#else
+	const double oldX = x;
+	const double oldY = y;
+	const double oldZ = z;
+	x = oldX * c[0] + oldY * c[2] + oldZ * c[4] + c[6];
+	y = oldX * c[1] + oldY * c[3] + oldZ * c[5] + c[7];
+	z = oldX * c[8] + oldY * c[9] + oldZ * c[10] + c[11];
+#endif
+}
+
+inline void transformTriple(const double* c, float& x, float& y, float& z) {
+	const double oldX = x;
+	const double oldY = y;
+	const double oldZ = z;
+	x = static_cast<float>(oldX * c[0] + oldY * c[2] + oldZ * c[4] + c[6]);
+	y = static_cast<float>(oldX * c[1] + oldY * c[3] + oldZ * c[5] + c[7]);
+	z = static_cast<float>(oldX * c[8] + oldY * c[9] + oldZ * c[10] + c[11]);
+}
+
+}
+
+const unsigned int HomogeneousTransformationKernel::minPointsPerThread = 50000;
+
+HomogeneousTransformationKernel::HomogeneousTransformationKernel(IHomogeneousMatrix44* transformation) {
+	assert(transformation != 0);
+	const double* matrix = transformation->getRawData();
+
+	/*
+	 * layout of the matrix:
+	 * 0 4 8  12
+	 * 1 5 9  13
+	 * 2 6 10 14
+	 * 3 7 11 15
+	 */
+	for (int column = 0; column < 4; ++column) {
+		coefficients[2 * column + 0] = matrix[4 * column + 0];
+		coefficients[2 * column + 1] = matrix[4 * column + 1];
+		coefficients[8 + column] = matrix[4 * column + 2];
+	}
+	this->transformation = transformation;
+	this->numberOfThreads = 1;
+}
+
+HomogeneousTransformationKernel::~HomogeneousTransformationKernel() {
+
+}
+
+void HomogeneousTransformationKernel::transformPackedCoordinates(Coordinate* coordinates, unsigned int numberOfPoints) const {
+	assert(coordinates != 0 || numberOfPoints == 0);
+	ParallelExecution::forEachRange(numberOfPoints, getThreadCount(numberOfPoints),
+			boost::bind(&HomogeneousTransformationKernel::transformPackedRange, this, coordinates, _1, _2));
+}
+
+void HomogeneousTransformationKernel::transformPoints(Point3D* points, unsigned int numberOfPoints) const {
+	assert(points != 0 || numberOfPoints == 0);
+	ParallelExecution::forEachRange(numberOfPoints, getThreadCount(numberOfPoints),
+			boost::bind(&HomogeneousTransformationKernel::transformPointRange, this, points, _1, _2));
+}
+
+void HomogeneousTransformationKernel::transformPoints(boost::ptr_vector<Point3D>* points) const {
+	assert(points != 0);
+	unsigned int numberOfPoints = static_cast<unsigned int>(points->size());
+	ParallelExecution::forEachRange(numberOfPoints, getThreadCount(numberOfPoints),
+			boost::bind(&HomogeneousTransformationKernel::transformPointPointerRange, this, points, _1, _2));
+}
+
+void HomogeneousTransformationKernel::transformCoordinateArrays(double* x, double* y, double* z, unsigned int numberOfPoints) const {
+	assert((x != 0 && y != 0 && z != 0) || numberOfPoints == 0);
+	ParallelExecution::forEachRange(numberOfPoints, getThreadCount(numberOfPoints),
+			boost::bind(&HomogeneousTransformationKernel::transformArrayRange<double>, this, x, y, z, _1, _2));
+}
+
+void HomogeneousTransformationKernel::transformCoordinateArrays(float* x, float* y, float* z, unsigned int numberOfPoints) const {
+	assert((x != 0 && y != 0 && z != 0) || numberOfPoints == 0);
+	ParallelExecution::forEachRange(numberOfPoints, getThreadCount(numberOfPoints),
+			boost::bind(&HomogeneousTransformationKernel::transformArrayRange<float>, this, x, y, z, _1, _2));
+}
+
+void HomogeneousTransformationKernel::transformPackedRange(Coordinate* coordinates, unsigned int begin, unsigned int end) const {
+	for (unsigned int i = begin; i < end; ++i) {
+		transformTriple(coefficients, coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+	}
+}
+
+void HomogeneousTransformationKernel::transformPointRange(Point3D* points, unsigned int begin, unsigned int end) const {
+	for (unsigned int i = begin; i < end; ++i) {
+		transformTriple(coefficients, points[i].x, points[i].y, points[i].z);
+	}
+}
+
+void HomogeneousTransformationKernel::transformPointPointerRange(boost::ptr_vector<Point3D>* points, unsigned int begin, unsigned int end) const {
+	for (unsigned int i = begin; i < end; ++i) {
+		Point3D& point = (*points)[i];
+		if (typeid(point) == typeid(Point3D)) {
+			transformTriple(coefficients, point.x, point.y, point.z);
+		} else { // decoration layers might transform more than the coordinates, e.g. normals
+			point.homogeneousTransformation(transformation);
+		}
+	}
+}
+
+template <typename ScalarT>
+void HomogeneousTransformationKernel::transformArrayRange(ScalarT* x, ScalarT* y, ScalarT* z, unsigned int begin, unsigned int end) const {
+	for (unsigned int i = begin; i < end; ++i) {
+		transformTriple(coefficients, x[i], y[i], z[i]);
+	}
+}
+
+unsigned int HomogeneousTransformationKernel::getThreadCount(unsigned int numberOfPoints) const {
+	return ParallelExecution::getThreadCount(numberOfThreads, numberOfPoints, minPointsPerThread);
+}
+
+unsigned int HomogeneousTransformationKernel::getNumberOfThreads() const {
+	return numberOfThreads;
+}
+
+void HomogeneousTransformationKernel::setNumberOfThreads(unsigned int numberOfThreads) {
+	numberOfThreads = ParallelExecution::resolveNumberOfThreads(numberOfThreads);
+	this->numberOfThreads = numberOfThreads;
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,164 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_HOMOGENEOUSTRANSFORMATIONKERNEL_H_
+#define BRICS_3D_HOMOGENEOUSTRANSFORMATIONKERNEL_H_
+
+#include "IHomogeneousMatrix44.h"
+#include "Point3D.h"
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
+namespace brics_3d {
+
+/**
+ * @brief Applies one homogeneous transformation to a bulk of coordinates.
+ *
+ * Point3D::homogeneousTransformation() is a virtual call per point that fetches the matrix
+ * data each time. This kernel loads the rotation and translation (the upper 3x4 part of the matrix)
+ * once in the constructor and then runs a tight loop over the coordinates. On SSE2 capable
+ * targets the x and y rows are computed with packed double instructions.
+ *
+ * Large data can be distributed among several worker threads (see setNumberOfThreads()). Each
+ * thread transforms a contiguous range.
+ *
+ * PointCloud3D, PointCloud3DSoA, TriangleMeshExplicit and TriangleMeshImplicit use this kernel for their
+ * homogeneousTransformation() implementations.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  HomogeneousTransformationKernel kernel(transformation);
+ *  kernel.setNumberOfThreads(0); // use all available cores
+ *  kernel.transformPoints(pointCloud->getPointCloud());
+ *
+ * @endcode
+ */
+class HomogeneousTransformationKernel {
+public:
+
+	/**
+	 * @brief Constructor that loads the matrix coefficients.
+	 * @param[in] transformation The homogeneous transformation. Later changes of the matrix are not reflected by the kernel.
+	 * The matrix has to stay valid as long as decorated points are transformed.
+	 */
+	HomogeneousTransformationKernel(IHomogeneousMatrix44* transformation);
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~HomogeneousTransformationKernel();
+
+	/**
+	 * @brief Transform packed coordinates in place.
+	 * @param[in,out] coordinates Buffer with the layout x0 y0 z0 x1 y1 z1 ...
+	 * @param numberOfPoints Number of points, i.e. a third of the buffer size.
+	 */
+	void transformPackedCoordinates(Coordinate* coordinates, unsigned int numberOfPoints) const;
+
+	/**
+	 * @brief Transform a contiguous array of points, like the content of a std::vector<Point3D>.
+	 *
+	 * The points are plain Point3D objects, thus there are no decoration layers. Their coordinates
+	 * are accessed directly, without any virtual calls.
+	 *
+	 * @param[in,out] points Pointer to the first point.
+	 * @param numberOfPoints Number of points.
+	 */
+	void transformPoints(Point3D* points, unsigned int numberOfPoints) const;
+
+	/**
+	 * @brief Transform all points of a pointer vector as it is used by the PointCloud3D.
+	 *
+	 * Plain Point3D objects are transformed directly, decorated points are transformed via
+	 * their virtual homogeneousTransformation() function.
+	 *
+	 * @param[in,out] points The points.
+	 */
+	void transformPoints(boost::ptr_vector<Point3D>* points) const;
+
+	/**
+	 * @brief Transform coordinates that are stored in three separate arrays, as in a PointCloud3DSoA.
+	 * @param[in,out] x Array with the x coordinates.
+	 * @param[in,out] y Array with the y coordinates.
+	 * @param[in,out] z Array with the z coordinates.
+	 * @param numberOfPoints Number of points, i.e. the size of each array.
+	 */
+	void transformCoordinateArrays(double* x, double* y, double* z, unsigned int numberOfPoints) const;
+
+	/**
+	 * @brief Single precision version of transformCoordinateArrays(). The computation is done in double precision.
+	 */
+	void transformCoordinateArrays(float* x, float* y, float* z, unsigned int numberOfPoints) const;
+
+	/**
+	 * @brief Get the number of worker threads.
+	 * @return The number of threads.
+	 */
+	unsigned int getNumberOfThreads() const;
+
+	/**
+	 * @brief Set the number of worker threads.
+	 * @param numberOfThreads Number of threads. 1 means serial processing (default). 0 means one thread per available
+	 * hardware thread.
+	 */
+	void setNumberOfThreads(unsigned int numberOfThreads);
+
+	/// Minimal number of points that are assigned to a worker thread. Smaller data is processed by fewer threads.
+	static const unsigned int minPointsPerThread;
+
+private:
+
+	/// Transform the packed coordinates of the points in the range [begin, end).
+	void transformPackedRange(Coordinate* coordinates, unsigned int begin, unsigned int end) const;
+
+	/// Transform the points in the range [begin, end) of an array.
+	void transformPointRange(Point3D* points, unsigned int begin, unsigned int end) const;
+
+	/// Transform the points in the range [begin, end) of a pointer vector.
+	void transformPointPointerRange(boost::ptr_vector<Point3D>* points, unsigned int begin, unsigned int end) const;
+
+	/// Transform the points in the range [begin, end) of three separate coordinate arrays.
+	template <typename ScalarT>
+	void transformArrayRange(ScalarT* x, ScalarT* y, ScalarT* z, unsigned int begin, unsigned int end) const;
+
+	/// Number of threads that are used for numberOfPoints.
+	unsigned int getThreadCount(unsigned int numberOfPoints) const;
+
+	/**
+	 * @brief Matrix coefficients: the x and y rows of the three rotation columns and the translation, followed by the z row.
+	 *
+	 * The x and y rows of a column are adjacent, so they can be loaded as one packed SSE2 register.
+	 * layout: r11 r21 | r12 r22 | r13 r23 | tx ty | r31 r32 r33 tz
+	 */
+	double coefficients[12];
+
+	/// The original transformation. Required for decorated points.
+	IHomogeneousMatrix44* transformation;
+
+	/// Number of worker threads
+	unsigned int numberOfThreads;
+};
+
+}
+
+#endif /* BRICS_3D_HOMOGENEOUSTRANSFORMATIONKERNEL_H_ */
+
+/* EOF */
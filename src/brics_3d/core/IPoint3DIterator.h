@@ -44,6 +44,22 @@ namespace brics_3d {
  *	}
  *	delete it;
  * @endcode
+ *
+ * Algorithms that process all points should rather fetch the coordinates in chunks. This avoids
+ * the virtual calls per coordinate and allows implementations to transform a whole chunk at once:
+ *
+ *  @code
+ *	std::vector<Coordinate> chunk(3 * IPoint3DIterator::defaultChunkSize);
+ *	unsigned int numberOfPoints;
+ *	it->begin();
+ *	while ((numberOfPoints = it->getNextChunk(&chunk[0], IPoint3DIterator::defaultChunkSize)) > 0) {
+ *		for (unsigned int i = 0; i < numberOfPoints; ++i) {
+ *			chunk[3 * i + 0]; // x
+ *			chunk[3 * i + 1]; // y
+ *			chunk[3 * i + 2]; // z
+ *		}
+ *	}
+ * @endcode
  */
 class IPoint3DIterator {
 public:
@@ -51,6 +67,9 @@ public:
 	typedef boost::shared_ptr<IPoint3DIterator> IPoint3DIteratorPtr;
 	typedef boost::shared_ptr<IPoint3DIterator const> IPoint3DIteratorConstPtr;
 
+	/// Recommended number of points per chunk for getNextChunk().
+	static const unsigned int defaultChunkSize = 4096;
+
 	/**
 	 * @brief Default constructor.
 	 */
@@ -109,6 +128,27 @@ public:
 	 */
 	virtual Point3D* getRawData() = 0; //not transformed, but might have additional data like color, etc.
 
+	/**
+	 * @brief Copy the (possibly transformed) coordinates of the current and the following points into a buffer.
+	 *
+	 * The iterator advances behind the last copied point. This default implementation is based on getX(), getY(),
+	 * getZ() and next(); implementations should override it with a more efficient version.
+	 *
+	 * @param[out] coordinates Buffer for at least 3 * maxNumberOfPoints coordinates. The layout is x0 y0 z0 x1 y1 z1 ...
+	 * @param maxNumberOfPoints Maximum number of points that will be copied.
+	 * @return Number of copied points. Less than maxNumberOfPoints only if the end has been reached.
+	 */
+	virtual unsigned int getNextChunk(Coordinate* coordinates, unsigned int maxNumberOfPoints) {
+		unsigned int numberOfPoints = 0;
+		for (; (numberOfPoints < maxNumberOfPoints) && !end(); next()) {
+			coordinates[3 * numberOfPoints + 0] = getX();
+			coordinates[3 * numberOfPoints + 1] = getY();
+			coordinates[3 * numberOfPoints + 2] = getZ();
+			numberOfPoints++;
+		}
+		return numberOfPoints;
+	}
+
 };
 
 }
@@ -0,0 +1,134 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include "OrganizedPointCloud3D.h"
+
+#include <algorithm>
+#include <limits>
+#include <assert.h>
+
+namespace brics_3d {
+
+OrganizedPointCloud3D::OrganizedPointCloud3D() {
+	resize(0, 0);
+}
+
+OrganizedPointCloud3D::OrganizedPointCloud3D(unsigned int width, unsigned int height) {
+	resize(width, height);
+}
+
+OrganizedPointCloud3D::~OrganizedPointCloud3D() {
+
+}
+
+void OrganizedPointCloud3D::resize(unsigned int width, unsigned int height) {
+	this->width = width;
+	this->height = height;
+	coordinates.resize(width * height);
+	validMask.resize(width * height);
+	clear();
+}
+
+void OrganizedPointCloud3D::clear() {
+	const Coordinate nan = std::numeric_limits<Coordinate>::quiet_NaN();
+	unsigned int size = coordinates.getSize();
+	std::fill(coordinates.getXCoordinates(), coordinates.getXCoordinates() + size, nan);
+	std::fill(coordinates.getYCoordinates(), coordinates.getYCoordinates() + size, nan);
+	std::fill(coordinates.getZCoordinates(), coordinates.getZCoordinates() + size, nan);
+	std::fill(validMask.begin(), validMask.end(), 0);
+}
+
+unsigned int OrganizedPointCloud3D::getNumberOfValidPoints() const {
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < validMask.size(); ++i) {
+		count += validMask[i];
+	}
+	return count;
+}
+
+void OrganizedPointCloud3D::setPoint(unsigned int row, unsigned int col, Coordinate x, Coordinate y, Coordinate z) {
+	unsigned int index = getIndex(row, col);
+	coordinates.setPoint(index, x, y, z);
+	validMask[index] = 1;
+}
+
+void OrganizedPointCloud3D::setInvalid(unsigned int row, unsigned int col) {
+	const Coordinate nan = std::numeric_limits<Coordinate>::quiet_NaN();
+	unsigned int index = getIndex(row, col);
+	coordinates.setPoint(index, nan, nan, nan);
+	validMask[index] = 0;
+}
+
+Point3D OrganizedPointCloud3D::getPoint(unsigned int row, unsigned int col) const {
+	return coordinates.getPoint(getIndex(row, col));
+}
+
+bool OrganizedPointCloud3D::getNeighbor(unsigned int index, int rowOffset, int colOffset, unsigned int& neighborIndex) const {
+	int row = static_cast<int>(index / width) + rowOffset;
+	int col = static_cast<int>(index % width) + colOffset;
+	if (row < 0 || col < 0 || row >= static_cast<int>(height) || col >= static_cast<int>(width)) {
+		return false;
+	}
+	neighborIndex = getIndex(row, col);
+	return validMask[neighborIndex] != 0;
+}
+
+unsigned int OrganizedPointCloud3D::getNeighborIndices(unsigned int row, unsigned int col, unsigned int radius,
+		std::vector<unsigned int>& neighborIndices) const {
+	neighborIndices.clear();
+	if (row >= height || col >= width) {
+		return 0;
+	}
+	unsigned int rowBegin = (row > radius) ? row - radius : 0;
+	unsigned int rowEnd = std::min(row + radius + 1, height);
+	unsigned int colBegin = (col > radius) ? col - radius : 0;
+	unsigned int colEnd = std::min(col + radius + 1, width);
+	for (unsigned int neighborRow = rowBegin; neighborRow < rowEnd; ++neighborRow) {
+		for (unsigned int index = getIndex(neighborRow, colBegin); index < getIndex(neighborRow, colEnd); ++index) {
+			if (validMask[index]) {
+				neighborIndices.push_back(index);
+			}
+		}
+	}
+	return static_cast<unsigned int>(neighborIndices.size());
+}
+
+void OrganizedPointCloud3D::copyTo(PointCloud3D* pointCloud, std::vector<unsigned int>* indices) const {
+	assert(pointCloud != 0);
+	unsigned int numberOfValidPoints = getNumberOfValidPoints();
+	pointCloud->getPointCloud()->reserve(pointCloud->getSize() + numberOfValidPoints);
+	if (indices != 0) {
+		indices->clear();
+		indices->reserve(numberOfValidPoints);
+	}
+	for (unsigned int i = 0; i < validMask.size(); ++i) {
+		if (!validMask[i]) {
+			continue;
+		}
+		pointCloud->addPoint(coordinates.getPoint(i));
+		if (indices != 0) {
+			indices->push_back(i);
+		}
+	}
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,265 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef BRICS_3D_ORGANIZEDPOINTCLOUD3D_H_
+#define BRICS_3D_ORGANIZEDPOINTCLOUD3D_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "PointCloud3D.h"
+#include "PointCloud3DSoA.h"
+
+namespace brics_3d {
+
+/**
+ * @brief Cartesian 3D point cloud that keeps the pixel grid of the sensor.
+ *
+ * Depth cameras deliver one point per pixel. The PointCloud3D discards this structure, so algorithms have to
+ * build a nearest neighbor index to find the neighbors of a point. This cloud stores width x height points in
+ * row major order, the point of pixel (row, col) has the index row * width + col. Pixels without a measurement
+ * are marked as invalid; their coordinates are NaN. Thus the neighbors of a point are found in constant time
+ * via the row and column offsets (see getNeighbor() and getNeighborIndices()).
+ *
+ * The coordinates are kept in a PointCloud3DSoA, i.e. in three contiguous arrays. The validity is stored as a mask
+ * with one byte per pixel (1 = valid, 0 = invalid).
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  OrganizedPointCloud3D organizedCloud(640, 480); // all points invalid
+ *  organizedCloud.setPoint(240, 320, 0.0, 1.5, 0.0);
+ *
+ *  std::vector<unsigned int> neighbors;
+ *  organizedCloud.getNeighborIndices(240, 320, 1, neighbors); // valid points of the 3x3 window
+ *
+ *  organizedCloud.copyTo(pointCloud); // append the valid points to a PointCloud3D
+ *
+ * @endcode
+ */
+class OrganizedPointCloud3D {
+public:
+
+	typedef boost::shared_ptr<OrganizedPointCloud3D> OrganizedPointCloud3DPtr;
+	typedef boost::shared_ptr<OrganizedPointCloud3D const> OrganizedPointCloud3DConstPtr;
+
+	/**
+	 * @brief Standard constructor. Creates an empty cloud.
+	 */
+	OrganizedPointCloud3D();
+
+	/**
+	 * @brief Constructor that creates a grid of invalid points.
+	 * @param width Number of columns.
+	 * @param height Number of rows.
+	 */
+	OrganizedPointCloud3D(unsigned int width, unsigned int height);
+
+	/**
+	 * @brief Standard destructor
+	 */
+	virtual ~OrganizedPointCloud3D();
+
+	/**
+	 * @brief Change the size of the grid. All points are invalid afterwards.
+	 * @param width Number of columns.
+	 * @param height Number of rows.
+	 */
+	void resize(unsigned int width, unsigned int height);
+
+	/**
+	 * @brief Mark all points as invalid. The size of the grid is kept.
+	 */
+	void clear();
+
+	/// Get the number of columns.
+	unsigned int getWidth() const {
+		return width;
+	}
+
+	/// Get the number of rows.
+	unsigned int getHeight() const {
+		return height;
+	}
+
+	/// Get the number of points, i.e. width * height including the invalid ones.
+	unsigned int getSize() const {
+		return width * height;
+	}
+
+	/**
+	 * @brief Count the valid points.
+	 */
+	unsigned int getNumberOfValidPoints() const;
+
+	/**
+	 * @brief Index of the point of a pixel. It is not range checked.
+	 */
+	unsigned int getIndex(unsigned int row, unsigned int col) const {
+		return row * width + col;
+	}
+
+	/**
+	 * @brief Check if a point carries a measurement.
+	 * @param index Index of the point. It is not range checked.
+	 */
+	bool isValid(unsigned int index) const {
+		return validMask[index] != 0;
+	}
+
+	/// @see isValid(unsigned int)
+	bool isValid(unsigned int row, unsigned int col) const {
+		return validMask[getIndex(row, col)] != 0;
+	}
+
+	/**
+	 * @brief Set the coordinates of a point and mark it as valid.
+	 * @param row Row of the pixel. It is not range checked.
+	 * @param col Column of the pixel. It is not range checked.
+	 */
+	void setPoint(unsigned int row, unsigned int col, Coordinate x, Coordinate y, Coordinate z);
+
+	/**
+	 * @brief Mark a point as invalid.
+	 * @param row Row of the pixel. It is not range checked.
+	 * @param col Column of the pixel. It is not range checked.
+	 */
+	void setInvalid(unsigned int row, unsigned int col);
+
+	/**
+	 * @brief Get a copy of a single point. Invalid points have NaN coordinates.
+	 * @param row Row of the pixel. It is not range checked.
+	 * @param col Column of the pixel. It is not range checked.
+	 */
+	Point3D getPoint(unsigned int row, unsigned int col) const;
+
+	/**
+	 * @brief Constant time access to a neighbor in the pixel grid.
+	 * @param index Index of the point.
+	 * @param rowOffset Row of the neighbor relative to the point, e.g. -1 for the pixel above.
+	 * @param colOffset Column of the neighbor relative to the point, e.g. 1 for the pixel to the right.
+	 * @param[out] neighborIndex Index of the neighbor.
+	 * @return False if the neighbor is outside of the grid or invalid.
+	 */
+	bool getNeighbor(unsigned int index, int rowOffset, int colOffset, unsigned int& neighborIndex) const;
+
+	/**
+	 * @brief Get the valid points of a square window around a pixel.
+	 * @param row Row of the center pixel.
+	 * @param col Column of the center pixel.
+	 * @param radius Half of the edge length of the window, i.e. the window covers (2 * radius + 1)^2 pixels. The window
+	 * is clipped at the border of the grid.
+	 * @param[out] neighborIndices The indices of the valid points in row major order, including the center pixel
+	 * if it is valid. Previous content will be overwritten.
+	 * @return The number of found neighbors.
+	 */
+	unsigned int getNeighborIndices(unsigned int row, unsigned int col, unsigned int radius,
+			std::vector<unsigned int>& neighborIndices) const;
+
+	/**
+	 * @brief Access to the coordinates of all width * height points in row major order.
+	 * Only the coordinates may be changed, not the size.
+	 */
+	PointCloud3DSoA<Coordinate>& getCoordinates() {
+		return coordinates;
+	}
+
+	/// @see getCoordinates()
+	const PointCloud3DSoA<Coordinate>& getCoordinates() const {
+		return coordinates;
+	}
+
+	/**
+	 * @brief Raw access to the contiguous array of x coordinates in row major order.
+	 * @return Pointer to the first x coordinate or null if the grid is empty.
+	 * The pointer is invalidated by resize().
+	 */
+	Coordinate* getXCoordinates() {
+		return coordinates.getXCoordinates();
+	}
+
+	/// @see getXCoordinates()
+	const Coordinate* getXCoordinates() const {
+		return coordinates.getXCoordinates();
+	}
+
+	/// @see getXCoordinates()
+	Coordinate* getYCoordinates() {
+		return coordinates.getYCoordinates();
+	}
+
+	/// @see getXCoordinates()
+	const Coordinate* getYCoordinates() const {
+		return coordinates.getYCoordinates();
+	}
+
+	/// @see getXCoordinates()
+	Coordinate* getZCoordinates() {
+		return coordinates.getZCoordinates();
+	}
+
+	/// @see getXCoordinates()
+	const Coordinate* getZCoordinates() const {
+		return coordinates.getZCoordinates();
+	}
+
+	/**
+	 * @brief Raw access to the validity mask (1 = valid, 0 = invalid) in row major order.
+	 * Writing to the mask directly does not reset the coordinates of invalidated points.
+	 * @see getXCoordinates()
+	 */
+	unsigned char* getValidMask() {
+		return validMask.empty() ? 0 : &validMask[0];
+	}
+
+	/// @see getValidMask()
+	const unsigned char* getValidMask() const {
+		return validMask.empty() ? 0 : &validMask[0];
+	}
+
+	/**
+	 * @brief Append the valid points to an unorganized point cloud, in row major order.
+	 * @param[out] pointCloud The point cloud where the points will be added to.
+	 * @param[out] indices If not null, the index in this organized cloud of each appended point. Previous content
+	 * will be overwritten.
+	 */
+	void copyTo(PointCloud3D* pointCloud, std::vector<unsigned int>* indices = 0) const;
+
+private:
+
+	/// Number of columns
+	unsigned int width;
+
+	/// Number of rows
+	unsigned int height;
+
+	/// Coordinates of all pixels, NaN for invalid ones
+	PointCloud3DSoA<Coordinate> coordinates;
+
+	/// 1 for valid points, 0 for invalid ones
+	std::vector<unsigned char> validMask;
+};
+
+}
+
+#endif /* BRICS_3D_ORGANIZEDPOINTCLOUD3D_H_ */
+
+/* EOF */
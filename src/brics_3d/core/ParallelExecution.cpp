@@ -0,0 +1,76 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include "ParallelExecution.h"
+
+#include <algorithm>
+#include <boost/thread.hpp>
+
+namespace brics_3d {
+
+unsigned int ParallelExecution::resolveNumberOfThreads(unsigned int numberOfThreads) {
+	if (numberOfThreads == 0) {
+		return std::max(boost::thread::hardware_concurrency(), 1u);
+	}
+	return numberOfThreads;
+}
+
+unsigned int ParallelExecution::getThreadCount(unsigned int numberOfThreads, unsigned int workSize, unsigned int minWorkPerThread) {
+	unsigned int threadCount = std::min(numberOfThreads, workSize / std::max(minWorkPerThread, 1u));
+	return std::max(threadCount, 1u);
+}
+
+void ParallelExecution::getRange(unsigned int workSize, unsigned int threadCount, unsigned int threadNum, unsigned int& begin, unsigned int& end) {
+	begin = static_cast<unsigned int>((static_cast<unsigned long long>(workSize) * threadNum) / threadCount);
+	end = static_cast<unsigned int>((static_cast<unsigned long long>(workSize) * (threadNum + 1)) / threadCount);
+}
+
+void ParallelExecution::forEachRange(unsigned int workSize, unsigned int threadCount, const RangeFunction& rangeFunction) {
+	if (threadCount <= 1) {
+		rangeFunction(0, workSize);
+		return;
+	}
+
+	boost::thread_group workers;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		unsigned int begin = 0;
+		unsigned int end = 0;
+		getRange(workSize, threadCount, threadNum, begin, end);
+		workers.create_thread(boost::bind(rangeFunction, begin, end));
+	}
+	workers.join_all();
+}
+
+void ParallelExecution::forEachStride(unsigned int threadCount, const StrideFunction& strideFunction) {
+	if (threadCount <= 1) {
+		strideFunction(0, 1);
+		return;
+	}
+
+	boost::thread_group workers;
+	for (unsigned int threadNum = 0; threadNum < threadCount; ++threadNum) {
+		workers.create_thread(boost::bind(strideFunction, threadNum, threadCount));
+	}
+	workers.join_all();
+}
+
+}
+
+/* EOF */
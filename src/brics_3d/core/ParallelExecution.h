@@ -0,0 +1,97 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef BRICS_3D_PARALLELEXECUTION_H_
+#define BRICS_3D_PARALLELEXECUTION_H_
+
+#include <boost/function.hpp>
+
+namespace brics_3d {
+
+/**
+ * @brief Helpers to distribute a workload among several worker threads.
+ *
+ * Algorithms with a setNumberOfThreads() option share the same scheme: the requested number of threads
+ * (0 means one per hardware thread) is limited by a minimal workload per thread, and the work items
+ * [0, workSize) are split into contiguous ranges that are processed by a boost::thread_group. A single
+ * range is processed in the calling thread, without creating any thread.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  unsigned int threadCount = ParallelExecution::getThreadCount(numberOfThreads, numberOfPoints, minPointsPerThread);
+ *  ParallelExecution::forEachRange(numberOfPoints, threadCount, boost::bind(&MyAlgorithm::processRange, this, data, _1, _2));
+ *
+ * @endcode
+ */
+class ParallelExecution {
+public:
+
+	/// A function that processes the work items [begin, end).
+	typedef boost::function<void (unsigned int begin, unsigned int end)> RangeFunction;
+
+	/// A function that processes the work items first, first + stride, first + 2 * stride, ...
+	typedef boost::function<void (unsigned int first, unsigned int stride)> StrideFunction;
+
+	/**
+	 * @brief Resolve a requested number of threads.
+	 * @param numberOfThreads The requested number. 0 means one thread per available hardware thread.
+	 * @return The number of threads, at least 1.
+	 */
+	static unsigned int resolveNumberOfThreads(unsigned int numberOfThreads);
+
+	/**
+	 * @brief Get the number of threads that is worth to be used for a workload.
+	 * @param numberOfThreads The maximal number of threads.
+	 * @param workSize The number of work items.
+	 * @param minWorkPerThread The minimal number of work items per thread.
+	 * @return min(numberOfThreads, workSize / minWorkPerThread), but at least 1.
+	 */
+	static unsigned int getThreadCount(unsigned int numberOfThreads, unsigned int workSize, unsigned int minWorkPerThread);
+
+	/**
+	 * @brief Get the range of a thread, if [0, workSize) is split into threadCount contiguous ranges of (almost) the same size.
+	 * @param workSize The number of work items.
+	 * @param threadCount The number of ranges.
+	 * @param threadNum The index of the range.
+	 * @param[out] begin The first work item of the range.
+	 * @param[out] end The work item behind the range.
+	 */
+	static void getRange(unsigned int workSize, unsigned int threadCount, unsigned int threadNum, unsigned int& begin, unsigned int& end);
+
+	/**
+	 * @brief Process [0, workSize) with threadCount threads, each on a contiguous range (see getRange()).
+	 * Returns when all ranges are processed.
+	 */
+	static void forEachRange(unsigned int workSize, unsigned int threadCount, const RangeFunction& rangeFunction);
+
+	/**
+	 * @brief Process the work items with threadCount threads, where thread i gets the items i, i + threadCount, ...
+	 * This balances workloads whose items have very different costs. Returns when all threads are done.
+	 */
+	static void forEachStride(unsigned int threadCount, const StrideFunction& strideFunction);
+};
+
+}
+
+#endif /* BRICS_3D_PARALLELEXECUTION_H_ */
+
+/* EOF */
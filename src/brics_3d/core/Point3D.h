@@ -204,6 +204,9 @@ public:
 
 private:
 
+	/// Bulk transformations access the coordinates directly.
+	friend class HomogeneousTransformationKernel;
+
 	/// X coordinate in Cartesian system
 	Coordinate x;
 
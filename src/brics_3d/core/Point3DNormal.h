@@ -29,6 +29,7 @@ namespace brics_3d {
  * Decoration layer for a Point3D that carries normal vector information.
  */
 class Point3DNormal : public Point3DDecorator  {
+public:
 
 	Point3DNormal();
 	Point3DNormal(Point3D* point);
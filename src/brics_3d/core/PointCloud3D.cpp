@@ -18,6 +18,7 @@
 ******************************************************************************/
 
 #include "PointCloud3D.h"
+#include "HomogeneousTransformationKernel.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -49,14 +50,21 @@ PointCloud3D::~PointCloud3D() {
 #ifdef USE_POINTER_VECTOR
 
 void PointCloud3D::addPoint(Point3D point) {
+	invalidatePackedCoordinates();
 	pointCloud->push_back(new Point3D(point));
 }
 
 void PointCloud3D::addPointPtr(Point3D* point) {
+	invalidatePackedCoordinates();
 	pointCloud->push_back(point);
 }
 
 boost::ptr_vector<Point3D> *PointCloud3D::getPointCloud() {
+	invalidatePackedCoordinates();
+	return pointCloud;
+}
+
+const boost::ptr_vector<Point3D>* PointCloud3D::getConstPointCloud() const {
 	return pointCloud;
 }
 
@@ -66,20 +74,28 @@ void PointCloud3D::setPointCloud(boost::ptr_vector<Point3D> *pointCloud) {
 		delete pointCloud;
 	}
 	this->pointCloud = pointCloud;
+	invalidatePackedCoordinates();
 }
 
 #else
 
 void PointCloud3D::addPoint(Point3D point) {
+	invalidatePackedCoordinates();
 	pointCloud->push_back(point);
 }
 
 void PointCloud3D::addPointPtr(Point3D* point) {
+	invalidatePackedCoordinates();
 	pointCloud->push_back(new Point3D(point));
 	delete point;
 }
 
 std::vector<Point3D> *PointCloud3D::getPointCloud() {
+	invalidatePackedCoordinates();
+	return pointCloud;
+}
+
+const std::vector<Point3D>* PointCloud3D::getConstPointCloud() const {
 	return pointCloud;
 }
 
@@ -89,6 +105,7 @@ void PointCloud3D::setPointCloud(std::vector<Point3D> *pointCloud) {
 		delete pointCloud;
 	}
 	this->pointCloud = pointCloud;
+	invalidatePackedCoordinates();
 }
 
 
@@ -189,16 +206,60 @@ istream& operator>>(istream &inStream, PointCloud3D &pointCloud) {
 
 ostream& operator<<(ostream &outStream, PointCloud3D &pointCloud) {
 	for (unsigned int i = 0; i < pointCloud.getSize(); ++i) {
-		outStream << (*pointCloud.getPointCloud())[i] << endl;
+		outStream << (*pointCloud.getConstPointCloud())[i] << endl;
 	}
 
 	return outStream;
 }
 
 void PointCloud3D::homogeneousTransformation(IHomogeneousMatrix44 *transformation) {
-	for (unsigned int i = 0; i < pointCloud->size(); ++i) {
-		(*pointCloud)[i].homogeneousTransformation(transformation);
+	homogeneousTransformation(transformation, 1);
+}
+
+void PointCloud3D::homogeneousTransformation(IHomogeneousMatrix44 *transformation, unsigned int numberOfThreads) {
+	invalidatePackedCoordinates();
+	HomogeneousTransformationKernel kernel(transformation);
+	kernel.setNumberOfThreads(numberOfThreads);
+#ifdef USE_POINTER_VECTOR
+	kernel.transformPoints(pointCloud);
+#else
+	if (!pointCloud->empty()) {
+		kernel.transformPoints(&(*pointCloud)[0], static_cast<unsigned int>(pointCloud->size()));
 	}
+#endif
+}
+
+PointCloud3D::PackedCoordinatesConstPtr PointCloud3D::getPackedCoordinates() {
+	if (!packedCoordinates) {
+		unsigned int size = static_cast<unsigned int>(pointCloud->size());
+		std::vector<double>* coordinates = new std::vector<double>(size * 3);
+		for (unsigned int i = 0; i < size; ++i) {
+			(*coordinates)[3 * i + 0] = static_cast<double>((*pointCloud)[i].getX());
+			(*coordinates)[3 * i + 1] = static_cast<double>((*pointCloud)[i].getY());
+			(*coordinates)[3 * i + 2] = static_cast<double>((*pointCloud)[i].getZ());
+		}
+		packedCoordinates.reset(coordinates);
+	}
+	return packedCoordinates;
+}
+
+PointCloud3D::PackedFloatCoordinatesConstPtr PointCloud3D::getPackedFloatCoordinates() {
+	if (!packedFloatCoordinates) {
+		unsigned int size = static_cast<unsigned int>(pointCloud->size());
+		std::vector<float>* coordinates = new std::vector<float>(size * 3);
+		for (unsigned int i = 0; i < size; ++i) {
+			(*coordinates)[3 * i + 0] = static_cast<float>((*pointCloud)[i].getX());
+			(*coordinates)[3 * i + 1] = static_cast<float>((*pointCloud)[i].getY());
+			(*coordinates)[3 * i + 2] = static_cast<float>((*pointCloud)[i].getZ());
+		}
+		packedFloatCoordinates.reset(coordinates);
+	}
+	return packedFloatCoordinates;
+}
+
+void PointCloud3D::invalidatePackedCoordinates() {
+	packedCoordinates.reset();
+	packedFloatCoordinates.reset();
 }
 
 }
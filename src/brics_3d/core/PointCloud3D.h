@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "Point3D.h"
 
@@ -39,6 +40,12 @@ public:
 	typedef boost::shared_ptr<PointCloud3D> PointCloud3DPtr;
 	typedef boost::shared_ptr<PointCloud3D const> PointCloud3DConstPtr;
 
+	/// Read-only buffer of packed coordinates (x0 y0 z0 x1 y1 z1 ...) in double precision.
+	typedef boost::shared_ptr<std::vector<double> const> PackedCoordinatesConstPtr;
+
+	/// Read-only buffer of packed coordinates (x0 y0 z0 x1 y1 z1 ...) in single precision.
+	typedef boost::shared_ptr<std::vector<float> const> PackedFloatCoordinatesConstPtr;
+
 	/**
 	 * @brief Standard constuctor
 	 */
@@ -64,11 +71,26 @@ public:
 
 #ifdef USE_POINTER_VECTOR
 	/**
-	 * @brief Get the pointer to the point cloud
+	 * @brief Get the pointer to the point cloud for modifications.
+	 *
+	 * As the returned vector allows to modify the points, any cached packed coordinates
+	 * (see getPackedCoordinates()) will be invalidated. Modifications that are made later via
+	 * a pointer retrieved before are not noticed; call invalidatePackedCoordinates() after them.
+	 * Use getConstPointCloud() for read-only access.
+	 *
 	 * @return Pointer to point cloud
 	 */
     boost::ptr_vector<Point3D>* getPointCloud();
 
+	/**
+	 * @brief Get read-only access to the point cloud.
+	 *
+	 * Cached packed coordinates stay valid.
+	 *
+	 * @return Pointer to point cloud
+	 */
+    const boost::ptr_vector<Point3D>* getConstPointCloud() const;
+
 	/**
 	 * @brief Set the pointer to the point cloud
 	 * @param pointCloud Pointer to new point cloud
@@ -77,6 +99,7 @@ public:
 
 #else
     std::vector<Point3D>* getPointCloud();
+    const std::vector<Point3D>* getConstPointCloud() const;
     void setPointCloud(std::vector<Point3D>* pointCloud);
 #endif
 
@@ -129,10 +152,53 @@ public:
 	/**
 	 * @brief Applies a homogeneous transformation to the point cloud
 	 *
+	 * The matrix is loaded only once for all points, see HomogeneousTransformationKernel.
+	 *
 	 * @param[in] transformation The homogeneous transformation matrix that will be applied
 	 */
 	void homogeneousTransformation(IHomogeneousMatrix44* transformation);
 
+	/**
+	 * @brief Applies a homogeneous transformation to the point cloud with multiple threads.
+	 *
+	 * @param[in] transformation The homogeneous transformation matrix that will be applied
+	 * @param numberOfThreads Number of worker threads. 0 means one thread per available hardware thread.
+	 * Small point clouds are processed by fewer threads.
+	 */
+	void homogeneousTransformation(IHomogeneousMatrix44* transformation, unsigned int numberOfThreads);
+
+	/**
+	 * @brief Get the coordinates of all points as one contiguous buffer.
+	 *
+	 * The layout is x0 y0 z0 x1 y1 z1 ..., so the buffer has 3*getSize() elements.
+	 * It can be directly handed over to nearest neighbor or octree libraries without
+	 * any per point copies or allocations.
+	 *
+	 * The buffer is lazily created on the first call and then cached until the point cloud
+	 * is modified via addPoint(), addPointPtr(), setPointCloud(), homogeneousTransformation()
+	 * or the mutable accessor getPointCloud(). Read access via getConstPointCloud() keeps the cache. A cache invalidation does not affect a buffer that has
+	 * been returned before: it stays valid (but outdated) as long as someone holds the pointer.
+	 *
+	 * <b>NOTE:</b> The lazy creation is not thread-safe.
+	 *
+	 * @return Shared pointer to read-only packed coordinates.
+	 */
+	PackedCoordinatesConstPtr getPackedCoordinates();
+
+	/**
+	 * @brief Same as getPackedCoordinates() but in single precision.
+	 * @return Shared pointer to read-only packed coordinates.
+	 */
+	PackedFloatCoordinatesConstPtr getPackedFloatCoordinates();
+
+	/**
+	 * @brief Drop cached packed coordinates.
+	 *
+	 * Only required if points have been modified by other means than the member
+	 * functions of this class, e.g. via a pointer that was retrieved by getPointCloud() before.
+	 */
+	void invalidatePackedCoordinates();
+
 protected:
 
 #ifdef USE_POINTER_VECTOR
@@ -144,6 +210,12 @@ protected:
 	std::vector<Point3D>* pointCloud;
 #endif
 
+	/// Lazily created packed coordinates in double precision. Null if invalid.
+	PackedCoordinatesConstPtr packedCoordinates;
+
+	/// Lazily created packed coordinates in single precision. Null if invalid.
+	PackedFloatCoordinatesConstPtr packedFloatCoordinates;
+
 };
 
 }
@@ -0,0 +1,1011 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "PointCloud3DFileHandler.h"
+#include "ColoredPoint3D.h"
+#include "Point3DNormal.h"
+#include "Logger.h"
+
+#include <assert.h>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <boost/cstdint.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BRICS_3D_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+namespace brics_3d {
+
+namespace {
+
+/// Scalar types of PLY properties and PCD fields.
+enum ScalarType {
+	int8Type,
+	uint8Type,
+	int16Type,
+	uint16Type,
+	int32Type,
+	uint32Type,
+	float32Type,
+	float64Type
+};
+
+unsigned int getTypeSize(ScalarType type) {
+	switch (type) {
+	case int8Type:
+	case uint8Type:
+		return 1;
+	case int16Type:
+	case uint16Type:
+		return 2;
+	case int32Type:
+	case uint32Type:
+	case float32Type:
+		return 4;
+	case float64Type:
+		return 8;
+	}
+	return 0;
+}
+
+bool isFloatingPoint(ScalarType type) {
+	return (type == float32Type) || (type == float64Type);
+}
+
+/// A property of a point record.
+struct Field {
+	string name;
+	ScalarType type;
+	unsigned int count;
+	size_t offset;
+};
+
+/// Layout of a point record and the indices of the fields that are relevant for a point and its decorations.
+struct RecordLayout {
+
+	RecordLayout() : recordSize(0), x(-1), y(-1), z(-1), red(-1), green(-1), blue(-1), packedColor(-1), normalX(-1), normalY(-1), normalZ(-1) {
+	}
+
+	/// Append a field. Throws if the record size exceeds the range of size_t.
+	void addField(const string& name, ScalarType type, unsigned int count) {
+		size_t typeSize = getTypeSize(type);
+		if (count > (std::numeric_limits<size_t>::max() - recordSize) / typeSize) {
+			throw runtime_error("ERROR: The size of a point record is too large.");
+		}
+		int index = static_cast<int>(fields.size());
+		Field field;
+		field.name = name;
+		field.type = type;
+		field.count = count;
+		field.offset = recordSize;
+		fields.push_back(field);
+		recordSize += typeSize * count;
+
+		if (name == "x") {
+			x = index;
+		} else if (name == "y") {
+			y = index;
+		} else if (name == "z") {
+			z = index;
+		} else if (name == "red" || name == "diffuse_red") {
+			red = index;
+		} else if (name == "green" || name == "diffuse_green") {
+			green = index;
+		} else if (name == "blue" || name == "diffuse_blue") {
+			blue = index;
+		} else if (name == "rgb" || name == "rgba") {
+			packedColor = index;
+		} else if (name == "nx" || name == "normal_x") {
+			normalX = index;
+		} else if (name == "ny" || name == "normal_y") {
+			normalY = index;
+		} else if (name == "nz" || name == "normal_z") {
+			normalZ = index;
+		}
+	}
+
+	bool hasCoordinates() const {
+		return (x >= 0) && (y >= 0) && (z >= 0);
+	}
+
+	bool hasColor() const {
+		return (packedColor >= 0) || ((red >= 0) && (green >= 0) && (blue >= 0));
+	}
+
+	bool hasNormal() const {
+		return (normalX >= 0) && (normalY >= 0) && (normalZ >= 0);
+	}
+
+	/// Indices of all fields that are required to create a point.
+	vector<int> getRelevantFields() const {
+		vector<int> relevantFields;
+		relevantFields.push_back(x);
+		relevantFields.push_back(y);
+		relevantFields.push_back(z);
+		if (packedColor >= 0) {
+			relevantFields.push_back(packedColor);
+		} else if (hasColor()) {
+			relevantFields.push_back(red);
+			relevantFields.push_back(green);
+			relevantFields.push_back(blue);
+		}
+		if (hasNormal()) {
+			relevantFields.push_back(normalX);
+			relevantFields.push_back(normalY);
+			relevantFields.push_back(normalZ);
+		}
+		return relevantFields;
+	}
+
+	/// Number of values of a record.
+	size_t getNumberOfValues() const {
+		size_t numberOfValues = 0;
+		for (unsigned int i = 0; i < fields.size(); ++i) {
+			numberOfValues += fields[i].count;
+		}
+		return numberOfValues;
+	}
+
+	vector<Field> fields;
+	size_t recordSize;
+	int x;
+	int y;
+	int z;
+	int red;
+	int green;
+	int blue;
+	int packedColor;
+	int normalX;
+	int normalY;
+	int normalZ;
+};
+
+/// Check if the buffer [data, end) is large enough for numberOfRecords binary records, without overflowing.
+bool containsRecords(const char* data, const char* end, unsigned int numberOfRecords, size_t recordSize) {
+	return (recordSize == 0) || (numberOfRecords <= static_cast<size_t>(end - data) / recordSize);
+}
+
+bool isBigEndianHost() {
+	const boost::uint16_t probe = 1;
+	return *reinterpret_cast<const unsigned char*>(&probe) == 0;
+}
+
+/// Read a binary value and convert it to double.
+double readBinaryValue(const char* data, ScalarType type, bool swap) {
+	char buffer[8];
+	unsigned int size = getTypeSize(type);
+	memcpy(buffer, data, size);
+	if (swap) {
+		std::reverse(buffer, buffer + size);
+	}
+
+	switch (type) {
+	case int8Type: {
+		boost::int8_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case uint8Type: {
+		boost::uint8_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case int16Type: {
+		boost::int16_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case uint16Type: {
+		boost::uint16_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case int32Type: {
+		boost::int32_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case uint32Type: {
+		boost::uint32_t value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case float32Type: {
+		float value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	case float64Type: {
+		double value;
+		memcpy(&value, buffer, size);
+		return value;
+	}
+	}
+	return 0.0;
+}
+
+/// Read the raw bits of a packed 0x00RRGGBB color (PCD rgb/rgba field).
+double readBinaryColor(const char* data, bool swap) {
+	char buffer[4];
+	memcpy(buffer, data, 4);
+	if (swap) {
+		std::reverse(buffer, buffer + 4);
+	}
+	boost::uint32_t value;
+	memcpy(&value, buffer, 4);
+	return value;
+}
+
+/// Append the little endian representation of a value to a buffer.
+template<typename T>
+void appendBinaryValue(vector<char>* buffer, T value, bool swap) {
+	char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	if (swap) {
+		std::reverse(bytes, bytes + sizeof(T));
+	}
+	buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+/// Convert a color value to a channel. Floating point colors are expected to be in [0,1].
+unsigned char toColorChannel(double value, ScalarType type) {
+	if (isFloatingPoint(type)) {
+		value *= 255.0;
+	}
+	value = std::max(0.0, std::min(255.0, value + 0.5));
+	return static_cast<unsigned char>(value);
+}
+
+/**
+ * @brief Create a point with all decorations of the layout.
+ * @param values Values of all fields of a record. A packed color is represented by its raw bits.
+ * @return False if the point has invalid coordinates and has been skipped.
+ */
+bool appendPoint(boost::ptr_vector<Point3D>* points, const RecordLayout& layout, const vector<double>& values) {
+	double x = values[layout.x];
+	double y = values[layout.y];
+	double z = values[layout.z];
+	if (x != x || y != y || z != z) { // NaN
+		return false;
+	}
+
+	Point3D* point = new Point3D(x, y, z);
+	if (layout.packedColor >= 0) {
+		boost::uint32_t color = static_cast<boost::uint32_t>(values[layout.packedColor]);
+		point = new ColoredPoint3D(point, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+	} else if (layout.hasColor()) {
+		point = new ColoredPoint3D(point,
+				toColorChannel(values[layout.red], layout.fields[layout.red].type),
+				toColorChannel(values[layout.green], layout.fields[layout.green].type),
+				toColorChannel(values[layout.blue], layout.fields[layout.blue].type));
+	}
+	if (layout.hasNormal()) {
+		point = new Point3DNormal(point, Normal3D(values[layout.normalX], values[layout.normalY], values[layout.normalZ]));
+	}
+	points->push_back(point);
+	return true;
+}
+
+/**
+ * @brief Read-only view on the content of a file.
+ *
+ * On POSIX systems the file is mapped into memory, otherwise it is read into a buffer.
+ */
+class MappedFile {
+public:
+	MappedFile(const string& filename);
+	~MappedFile();
+
+	const char* begin() const {
+		return data;
+	}
+
+	const char* end() const {
+		return data + size;
+	}
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* data;
+	size_t size;
+#ifdef BRICS_3D_USE_MMAP
+	void* mapping;
+#else
+	vector<char> buffer;
+#endif
+};
+
+MappedFile::MappedFile(const string& filename) {
+	data = 0;
+	size = 0;
+#ifdef BRICS_3D_USE_MMAP
+	mapping = 0;
+	int fileDescriptor = open(filename.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		throw runtime_error("ERROR: Cannot open file " + filename);
+	}
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0) {
+		close(fileDescriptor);
+		throw runtime_error("ERROR: Cannot determine the size of file " + filename);
+	}
+	size = static_cast<size_t>(fileStatus.st_size);
+	if (size > 0) {
+		mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mapping == MAP_FAILED) {
+			mapping = 0;
+			close(fileDescriptor);
+			throw runtime_error("ERROR: Cannot map file " + filename);
+		}
+		madvise(mapping, size, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(mapping);
+	}
+	close(fileDescriptor); // the mapping stays valid
+#else
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		throw runtime_error("ERROR: Cannot open file " + filename);
+	}
+	file.seekg(0, std::ios::end);
+	size = static_cast<size_t>(file.tellg());
+	file.seekg(0, std::ios::beg);
+	buffer.resize(size);
+	if (size > 0) {
+		file.read(&buffer[0], size);
+		data = &buffer[0];
+	}
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef BRICS_3D_USE_MMAP
+	if (mapping != 0) {
+		munmap(mapping, size);
+	}
+#endif
+}
+
+/// Extract the next line. The cursor is moved behind the line.
+bool readLine(const char*& cursor, const char* end, string* line) {
+	if (cursor >= end) {
+		return false;
+	}
+	const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+	if (lineEnd == 0) {
+		lineEnd = end;
+	}
+	line->assign(cursor, lineEnd);
+	if (!line->empty() && (*line)[line->size() - 1] == '\r') {
+		line->erase(line->size() - 1);
+	}
+	cursor = (lineEnd < end) ? lineEnd + 1 : end;
+	return true;
+}
+
+/// Parse the next number of an ASCII record. The cursor is moved behind the number.
+bool parseAsciiValue(const char*& cursor, const char* lineEnd, double* value) {
+	while (cursor < lineEnd && isspace(*cursor)) {
+		++cursor;
+	}
+	if (cursor >= lineEnd) {
+		return false;
+	}
+
+	char buffer[64];
+	unsigned int length = 0;
+	while (cursor < lineEnd && !isspace(*cursor)) {
+		if (length < sizeof(buffer) - 1) {
+			buffer[length++] = *cursor;
+		}
+		++cursor;
+	}
+	buffer[length] = '\0';
+
+	char* parseEnd;
+	*value = strtod(buffer, &parseEnd);
+	return parseEnd != buffer;
+}
+
+/**
+ * @brief Decode binary records.
+ * @return Number of points that have been added.
+ */
+unsigned int decodeBinaryRecords(const char* data, const char* end, unsigned int numberOfRecords, const RecordLayout& layout, bool swap, PointCloud3D* pointCloud) {
+	if (!containsRecords(data, end, numberOfRecords, layout.recordSize)) {
+		throw runtime_error("ERROR: The file is truncated.");
+	}
+
+	boost::ptr_vector<Point3D>* points = pointCloud->getPointCloud();
+	points->reserve(points->size() + numberOfRecords);
+	vector<int> relevantFields = layout.getRelevantFields();
+	vector<double> values(layout.fields.size(), 0.0);
+	unsigned int addedPoints = 0;
+
+	for (unsigned int i = 0; i < numberOfRecords; ++i) {
+		const char* record = data + i * layout.recordSize;
+		for (unsigned int j = 0; j < relevantFields.size(); ++j) {
+			const Field& field = layout.fields[relevantFields[j]];
+			if (relevantFields[j] == layout.packedColor) {
+				values[relevantFields[j]] = readBinaryColor(record + field.offset, swap);
+			} else {
+				values[relevantFields[j]] = readBinaryValue(record + field.offset, field.type, swap);
+			}
+		}
+		if (appendPoint(points, layout, values)) {
+			addedPoints++;
+		}
+	}
+	return addedPoints;
+}
+
+/**
+ * @brief Decode ASCII records. Each record is a line.
+ * @return Number of points that have been added.
+ */
+unsigned int decodeAsciiRecords(const char* data, const char* end, unsigned int numberOfRecords, const RecordLayout& layout, PointCloud3D* pointCloud) {
+	boost::ptr_vector<Point3D>* points = pointCloud->getPointCloud();
+
+	/* the header count is not trusted: a record needs at least one character and one separator per value */
+	size_t maxNumberOfRecords = (static_cast<size_t>(end - data) + 1) / 2 / std::max<size_t>(layout.getNumberOfValues(), 1);
+	points->reserve(points->size() + std::min<size_t>(numberOfRecords, maxNumberOfRecords));
+	vector<double> values(layout.fields.size(), 0.0);
+	unsigned int addedPoints = 0;
+	const char* cursor = data;
+
+	for (unsigned int i = 0; i < numberOfRecords; ) {
+		if (cursor >= end) {
+			throw runtime_error("ERROR: The file is truncated.");
+		}
+		const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+		if (lineEnd == 0) {
+			lineEnd = end;
+		}
+
+		double value;
+		const char* valueCursor = cursor;
+		if (!parseAsciiValue(valueCursor, lineEnd, &value)) { // empty line
+			cursor = (lineEnd < end) ? lineEnd + 1 : end;
+			continue;
+		}
+		for (unsigned int j = 0; j < layout.fields.size(); ++j) {
+			for (unsigned int k = 0; k < layout.fields[j].count; ++k) {
+				if ((j > 0 || k > 0) && !parseAsciiValue(valueCursor, lineEnd, &value)) {
+					throw runtime_error("ERROR: Incomplete point record.");
+				}
+				if (k == 0) {
+					values[j] = value;
+				}
+			}
+		}
+		if (layout.packedColor >= 0 && layout.fields[layout.packedColor].type == float32Type) { // the bits of the float are the color
+			float packedColor = static_cast<float>(values[layout.packedColor]);
+			boost::uint32_t color;
+			memcpy(&color, &packedColor, 4);
+			values[layout.packedColor] = color;
+		}
+
+		if (appendPoint(points, layout, values)) {
+			addedPoints++;
+		}
+		cursor = (lineEnd < end) ? lineEnd + 1 : end;
+		++i;
+	}
+	return addedPoints;
+}
+
+/// Skip a number of non empty lines.
+const char* skipAsciiRecords(const char* data, const char* end, unsigned int numberOfRecords) {
+	string line;
+	for (unsigned int i = 0; i < numberOfRecords; ) {
+		if (!readLine(data, end, &line)) {
+			throw runtime_error("ERROR: The file is truncated.");
+		}
+		if (line.find_first_not_of(" \t") != string::npos) {
+			++i;
+		}
+	}
+	return data;
+}
+
+bool parsePlyType(const string& name, ScalarType* type) {
+	if (name == "char" || name == "int8") {
+		*type = int8Type;
+	} else if (name == "uchar" || name == "uint8") {
+		*type = uint8Type;
+	} else if (name == "short" || name == "int16") {
+		*type = int16Type;
+	} else if (name == "ushort" || name == "uint16") {
+		*type = uint16Type;
+	} else if (name == "int" || name == "int32") {
+		*type = int32Type;
+	} else if (name == "uint" || name == "uint32") {
+		*type = uint32Type;
+	} else if (name == "float" || name == "float32") {
+		*type = float32Type;
+	} else if (name == "double" || name == "float64") {
+		*type = float64Type;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parsePcdType(char typeName, unsigned int size, ScalarType* type) {
+	if (typeName == 'F' && size == 4) {
+		*type = float32Type;
+	} else if (typeName == 'F' && size == 8) {
+		*type = float64Type;
+	} else if (typeName == 'I' && size == 1) {
+		*type = int8Type;
+	} else if (typeName == 'I' && size == 2) {
+		*type = int16Type;
+	} else if (typeName == 'I' && size == 4) {
+		*type = int32Type;
+	} else if (typeName == 'U' && size == 1) {
+		*type = uint8Type;
+	} else if (typeName == 'U' && size == 2) {
+		*type = uint16Type;
+	} else if (typeName == 'U' && size == 4) {
+		*type = uint32Type;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/// An element of a PLY file, e.g. vertex or face.
+struct PlyElement {
+	string name;
+	unsigned int count;
+	RecordLayout layout;
+	bool hasList;
+};
+
+/// Point data that is written to a file.
+struct PointRecord {
+	float x;
+	float y;
+	float z;
+	unsigned char red;
+	unsigned char green;
+	unsigned char blue;
+	float normalX;
+	float normalY;
+	float normalZ;
+};
+
+/// Check which decorations are present in a point cloud.
+void detectDecorations(PointCloud3D* pointCloud, bool* hasColor, bool* hasNormal) {
+	*hasColor = false;
+	*hasNormal = false;
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		Point3D* point = const_cast<Point3D*>(&(*pointCloud->getConstPointCloud())[i]); // the decoration queries do not modify the point
+		if (point->asColoredPoint3D() != 0) {
+			*hasColor = true;
+		}
+		if (getPointType<Point3DNormal>(point) != 0) {
+			*hasNormal = true;
+		}
+	}
+}
+
+PointRecord getPointRecord(Point3D* point) {
+	PointRecord record;
+	record.x = static_cast<float>(point->getX());
+	record.y = static_cast<float>(point->getY());
+	record.z = static_cast<float>(point->getZ());
+	record.red = 0;
+	record.green = 0;
+	record.blue = 0;
+	record.normalX = 0;
+	record.normalY = 0;
+	record.normalZ = 0;
+
+	ColoredPoint3D* coloredPoint = point->asColoredPoint3D();
+	if (coloredPoint != 0) {
+		record.red = coloredPoint->getR();
+		record.green = coloredPoint->getG();
+		record.blue = coloredPoint->getB();
+	}
+	Point3DNormal* pointWithNormal = getPointType<Point3DNormal>(point);
+	if (pointWithNormal != 0) {
+		Normal3D normal = pointWithNormal->getNormal();
+		record.normalX = static_cast<float>(normal.getX());
+		record.normalY = static_cast<float>(normal.getY());
+		record.normalZ = static_cast<float>(normal.getZ());
+	}
+	return record;
+}
+
+boost::uint32_t packColor(const PointRecord& record) {
+	return (static_cast<boost::uint32_t>(record.red) << 16) | (static_cast<boost::uint32_t>(record.green) << 8) | static_cast<boost::uint32_t>(record.blue);
+}
+
+/// Write the points as binary little endian records: x y z [rgb] [normal]
+void writeBinaryRecords(std::ofstream& outputFile, PointCloud3D* pointCloud, bool hasColor, bool hasNormal, bool packedColor) {
+	const bool swap = isBigEndianHost();
+	const unsigned int recordsPerChunk = 65536;
+	vector<char> buffer;
+	buffer.reserve(recordsPerChunk * 28);
+
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		PointRecord record = getPointRecord(const_cast<Point3D*>(&(*pointCloud->getConstPointCloud())[i]));
+		appendBinaryValue(&buffer, record.x, swap);
+		appendBinaryValue(&buffer, record.y, swap);
+		appendBinaryValue(&buffer, record.z, swap);
+		if (hasColor && packedColor) {
+			appendBinaryValue(&buffer, packColor(record), swap);
+		} else if (hasColor) {
+			buffer.push_back(static_cast<char>(record.red));
+			buffer.push_back(static_cast<char>(record.green));
+			buffer.push_back(static_cast<char>(record.blue));
+		}
+		if (hasNormal) {
+			appendBinaryValue(&buffer, record.normalX, swap);
+			appendBinaryValue(&buffer, record.normalY, swap);
+			appendBinaryValue(&buffer, record.normalZ, swap);
+		}
+		if ((i + 1) % recordsPerChunk == 0) {
+			outputFile.write(&buffer[0], buffer.size());
+			buffer.clear();
+		}
+	}
+	if (!buffer.empty()) {
+		outputFile.write(&buffer[0], buffer.size());
+	}
+}
+
+/// Write the points as ASCII records: x y z [rgb] [normal]
+void writeAsciiRecords(std::ofstream& outputFile, PointCloud3D* pointCloud, bool hasColor, bool hasNormal, bool packedColor) {
+	outputFile.precision(9); // sufficient for a float
+	for (unsigned int i = 0; i < pointCloud->getSize(); ++i) {
+		PointRecord record = getPointRecord(const_cast<Point3D*>(&(*pointCloud->getConstPointCloud())[i]));
+		outputFile << record.x << " " << record.y << " " << record.z;
+		if (hasColor && packedColor) { // stored as float with the same bits
+			boost::uint32_t color = packColor(record);
+			float colorAsFloat;
+			memcpy(&colorAsFloat, &color, 4);
+			outputFile << " " << colorAsFloat;
+		} else if (hasColor) {
+			outputFile << " " << static_cast<int>(record.red) << " " << static_cast<int>(record.green) << " " << static_cast<int>(record.blue);
+		}
+		if (hasNormal) {
+			outputFile << " " << record.normalX << " " << record.normalY << " " << record.normalZ;
+		}
+		outputFile << "\n";
+	}
+}
+
+}
+
+PointCloud3DFileHandler::PointCloud3DFileHandler() {
+
+}
+
+PointCloud3DFileHandler::~PointCloud3DFileHandler() {
+
+}
+
+void PointCloud3DFileHandler::readFromPlyFile(std::string filename, PointCloud3D* pointCloud) {
+	assert(pointCloud != 0);
+	MappedFile file(filename);
+	const char* cursor = file.begin();
+	string line;
+
+	/* parse the header */
+	if (!readLine(cursor, file.end(), &line) || line != "ply") {
+		throw runtime_error("ERROR: " + filename + " is not a PLY file.");
+	}
+
+	string format;
+	vector<PlyElement> elements;
+	bool headerComplete = false;
+	while (readLine(cursor, file.end(), &line)) {
+		std::istringstream tokens(line);
+		string keyword;
+		tokens >> keyword;
+
+		if (keyword == "format") {
+			tokens >> format;
+		} else if (keyword == "element") {
+			PlyElement element;
+			tokens >> element.name >> element.count;
+			element.hasList = false;
+			elements.push_back(element);
+		} else if (keyword == "property") {
+			if (elements.empty()) {
+				throw runtime_error("ERROR: PLY property without an element in " + filename);
+			}
+			string typeName;
+			string propertyName;
+			tokens >> typeName;
+			if (typeName == "list") {
+				elements.back().hasList = true;
+				continue;
+			}
+			tokens >> propertyName;
+			ScalarType type;
+			if (!parsePlyType(typeName, &type)) {
+				throw runtime_error("ERROR: Unknown PLY property type " + typeName + " in " + filename);
+			}
+			elements.back().layout.addField(propertyName, type, 1);
+		} else if (keyword == "end_header") {
+			headerComplete = true;
+			break;
+		} // comments etc. are ignored
+	}
+	if (!headerComplete) {
+		throw runtime_error("ERROR: Incomplete PLY header in " + filename);
+	}
+
+	bool binary;
+	bool swap;
+	if (format == "ascii") {
+		binary = false;
+		swap = false;
+	} else if (format == "binary_little_endian") {
+		binary = true;
+		swap = isBigEndianHost();
+	} else if (format == "binary_big_endian") {
+		binary = true;
+		swap = !isBigEndianHost();
+	} else {
+		throw runtime_error("ERROR: Unknown PLY format " + format + " in " + filename);
+	}
+
+	/* skip all elements in front of the vertices */
+	unsigned int elementIndex = 0;
+	for (; elementIndex < elements.size() && elements[elementIndex].name != "vertex"; ++elementIndex) {
+		const PlyElement& element = elements[elementIndex];
+		if (!binary) {
+			cursor = skipAsciiRecords(cursor, file.end(), element.count);
+		} else if (element.hasList) {
+			throw runtime_error("ERROR: Binary PLY elements with lists in front of the vertices are not supported.");
+		} else {
+			if (!containsRecords(cursor, file.end(), element.count, element.layout.recordSize)) {
+				throw runtime_error("ERROR: The file " + filename + " is truncated.");
+			}
+			cursor += element.count * element.layout.recordSize;
+		}
+	}
+	if (elementIndex == elements.size()) {
+		LOG(WARNING) << "PLY file " << filename << " has no vertex element.";
+		return;
+	}
+
+	const PlyElement& vertices = elements[elementIndex];
+	if (vertices.hasList) {
+		throw runtime_error("ERROR: PLY vertices with list properties are not supported.");
+	}
+	if (!vertices.layout.hasCoordinates()) {
+		throw runtime_error("ERROR: PLY vertices in " + filename + " have no x, y and z properties.");
+	}
+
+	/* decode the vertex block */
+	unsigned int addedPoints;
+	if (binary) {
+		addedPoints = decodeBinaryRecords(cursor, file.end(), vertices.count, vertices.layout, swap, pointCloud);
+	} else {
+		addedPoints = decodeAsciiRecords(cursor, file.end(), vertices.count, vertices.layout, pointCloud);
+	}
+	LOG(DEBUG) << "PointCloud3DFileHandler: " << addedPoints << " points read from " << filename;
+	if (addedPoints < vertices.count) {
+		LOG(WARNING) << "PointCloud3DFileHandler: " << vertices.count - addedPoints << " points with invalid coordinates have been skipped.";
+	}
+}
+
+void PointCloud3DFileHandler::storeToPlyFile(std::string filename, PointCloud3D* pointCloud, Encoding encoding) {
+	assert(pointCloud != 0);
+	std::ofstream outputFile(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!outputFile.is_open()) {
+		throw runtime_error("ERROR: Cannot write file " + filename);
+	}
+
+	bool hasColor;
+	bool hasNormal;
+	detectDecorations(pointCloud, &hasColor, &hasNormal);
+
+	/* header */
+	outputFile << "ply\n";
+	outputFile << "format " << ((encoding == binary) ? "binary_little_endian" : "ascii") << " 1.0\n";
+	outputFile << "comment created by brics_3d::PointCloud3DFileHandler\n";
+	outputFile << "element vertex " << pointCloud->getSize() << "\n";
+	outputFile << "property float x\n";
+	outputFile << "property float y\n";
+	outputFile << "property float z\n";
+	if (hasColor) {
+		outputFile << "property uchar red\n";
+		outputFile << "property uchar green\n";
+		outputFile << "property uchar blue\n";
+	}
+	if (hasNormal) {
+		outputFile << "property float nx\n";
+		outputFile << "property float ny\n";
+		outputFile << "property float nz\n";
+	}
+	outputFile << "end_header\n";
+
+	/* data */
+	if (encoding == binary) {
+		writeBinaryRecords(outputFile, pointCloud, hasColor, hasNormal, false);
+	} else {
+		writeAsciiRecords(outputFile, pointCloud, hasColor, hasNormal, false);
+	}
+
+	if (!outputFile.good()) {
+		throw runtime_error("ERROR: Cannot write file " + filename);
+	}
+	outputFile.close();
+}
+
+void PointCloud3DFileHandler::readFromPcdFile(std::string filename, PointCloud3D* pointCloud) {
+	assert(pointCloud != 0);
+	MappedFile file(filename);
+	const char* cursor = file.begin();
+	string line;
+
+	/* parse the header */
+	vector<string> names;
+	vector<unsigned int> sizes;
+	vector<char> types;
+	vector<unsigned int> counts;
+	unsigned int width = 0;
+	unsigned int height = 1;
+	unsigned int numberOfPoints = 0;
+	bool hasNumberOfPoints = false;
+	string dataFormat;
+	while (readLine(cursor, file.end(), &line)) {
+		std::istringstream tokens(line);
+		string keyword;
+		tokens >> keyword;
+		if (keyword.empty() || keyword[0] == '#') {
+			continue;
+		}
+
+		if (keyword == "FIELDS") {
+			string name;
+			while (tokens >> name) {
+				names.push_back(name);
+			}
+		} else if (keyword == "SIZE") {
+			unsigned int size;
+			while (tokens >> size) {
+				sizes.push_back(size);
+			}
+		} else if (keyword == "TYPE") {
+			char type;
+			while (tokens >> type) {
+				types.push_back(type);
+			}
+		} else if (keyword == "COUNT") {
+			unsigned int count;
+			while (tokens >> count) {
+				counts.push_back(count);
+			}
+		} else if (keyword == "WIDTH") {
+			tokens >> width;
+		} else if (keyword == "HEIGHT") {
+			tokens >> height;
+		} else if (keyword == "POINTS") {
+			tokens >> numberOfPoints;
+			hasNumberOfPoints = true;
+		} else if (keyword == "DATA") {
+			tokens >> dataFormat;
+			break;
+		} // VERSION and VIEWPOINT are ignored
+	}
+
+	if (dataFormat.empty()) {
+		throw runtime_error("ERROR: Incomplete PCD header in " + filename);
+	}
+	if (counts.empty()) {
+		counts.resize(names.size(), 1);
+	}
+	if (sizes.size() != names.size() || types.size() != names.size() || counts.size() != names.size()) {
+		throw runtime_error("ERROR: Inconsistent PCD header in " + filename);
+	}
+	if (!hasNumberOfPoints) {
+		numberOfPoints = width * height;
+	}
+
+	RecordLayout layout;
+	for (unsigned int i = 0; i < names.size(); ++i) {
+		ScalarType type;
+		if (!parsePcdType(types[i], sizes[i], &type)) {
+			throw runtime_error("ERROR: Unsupported PCD field type of " + names[i] + " in " + filename);
+		}
+		layout.addField(names[i], type, counts[i]);
+	}
+	if (!layout.hasCoordinates()) {
+		throw runtime_error("ERROR: PCD file " + filename + " has no x, y and z fields.");
+	}
+
+	/* decode the data block */
+	unsigned int addedPoints;
+	if (dataFormat == "binary") {
+		addedPoints = decodeBinaryRecords(cursor, file.end(), numberOfPoints, layout, isBigEndianHost(), pointCloud);
+	} else if (dataFormat == "ascii") {
+		addedPoints = decodeAsciiRecords(cursor, file.end(), numberOfPoints, layout, pointCloud);
+	} else {
+		throw runtime_error("ERROR: Unsupported PCD data format " + dataFormat + " in " + filename);
+	}
+	LOG(DEBUG) << "PointCloud3DFileHandler: " << addedPoints << " points read from " << filename;
+	if (addedPoints < numberOfPoints) {
+		LOG(WARNING) << "PointCloud3DFileHandler: " << numberOfPoints - addedPoints << " points with invalid coordinates have been skipped.";
+	}
+}
+
+void PointCloud3DFileHandler::storeToPcdFile(std::string filename, PointCloud3D* pointCloud, Encoding encoding) {
+	assert(pointCloud != 0);
+	std::ofstream outputFile(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!outputFile.is_open()) {
+		throw runtime_error("ERROR: Cannot write file " + filename);
+	}
+
+	bool hasColor;
+	bool hasNormal;
+	detectDecorations(pointCloud, &hasColor, &hasNormal);
+
+	/* header */
+	outputFile << "# .PCD v0.7 - Point Cloud Data file format\n";
+	outputFile << "VERSION 0.7\n";
+	outputFile << "FIELDS x y z" << (hasColor ? " rgb" : "") << (hasNormal ? " normal_x normal_y normal_z" : "") << "\n";
+	outputFile << "SIZE 4 4 4" << (hasColor ? " 4" : "") << (hasNormal ? " 4 4 4" : "") << "\n";
+	outputFile << "TYPE F F F" << (hasColor ? " F" : "") << (hasNormal ? " F F F" : "") << "\n";
+	outputFile << "COUNT 1 1 1" << (hasColor ? " 1" : "") << (hasNormal ? " 1 1 1" : "") << "\n";
+	outputFile << "WIDTH " << pointCloud->getSize() << "\n";
+	outputFile << "HEIGHT 1\n";
+	outputFile << "VIEWPOINT 0 0 0 1 0 0 0\n";
+	outputFile << "POINTS " << pointCloud->getSize() << "\n";
+	outputFile << "DATA " << ((encoding == binary) ? "binary" : "ascii") << "\n";
+
+	/* data */
+	if (encoding == binary) {
+		writeBinaryRecords(outputFile, pointCloud, hasColor, hasNormal, true);
+	} else {
+		writeAsciiRecords(outputFile, pointCloud, hasColor, hasNormal, true);
+	}
+
+	if (!outputFile.good()) {
+		throw runtime_error("ERROR: Cannot write file " + filename);
+	}
+	outputFile.close();
+}
+
+}
+
+/* EOF */
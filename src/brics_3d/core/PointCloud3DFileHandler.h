@@ -0,0 +1,109 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_POINTCLOUD3DFILEHANDLER_H_
+#define BRICS_3D_POINTCLOUD3DFILEHANDLER_H_
+
+#include "PointCloud3D.h"
+
+#include <string>
+
+namespace brics_3d {
+
+/**
+ * @brief Reads and writes point clouds as PLY (Stanford polygon file format) or PCD (Point Cloud Library) files.
+ *
+ * Both the ASCII and the binary variants are supported. Binary files are written in little endian byte order;
+ * binary PLY files in big endian byte order can be read as well. Compressed PCD files are not supported.
+ *
+ * Files are read via a memory mapping (on POSIX systems): the header is parsed, the point cloud
+ * is reserved once for all points and then the vertex block is decoded in a single pass without any
+ * intermediate copies or per line streams.
+ *
+ * Besides the x, y and z coordinates, the following properties are taken into account:
+ *  - colors (PLY: red, green, blue; PCD: rgb or rgba) are mapped to a ColoredPoint3D decoration
+ *  - normals (PLY: nx, ny, nz; PCD: normal_x, normal_y, normal_z) are mapped to a Point3DNormal decoration
+ * Other properties or elements (e.g. faces) are ignored. When a file is written, colors and normals are
+ * stored if at least one point of the cloud has such a decoration. Points without it get zero values.
+ *
+ * Points with invalid (NaN) coordinates, as they appear in organized PCD files, are skipped while reading.
+ * Coordinates are stored in single precision.
+ */
+class PointCloud3DFileHandler {
+public:
+
+	/**
+	 * @brief The encoding of the point data.
+	 */
+	enum Encoding {
+		ascii,
+		binary
+	};
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	PointCloud3DFileHandler();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~PointCloud3DFileHandler();
+
+	/**
+	 * @brief Append the points of a PLY file to a point cloud.
+	 * @param filename The name of the file e.g. point_cloud.ply
+	 * @param[out] pointCloud The point cloud where the points will be added to.
+	 * @throws runtime_error if the file cannot be read or has an unsupported format.
+	 */
+	void readFromPlyFile(std::string filename, PointCloud3D* pointCloud);
+
+	/**
+	 * @brief Store a point cloud into a PLY file.
+	 * @param filename The name of the file e.g. point_cloud.ply
+	 * @param[in] pointCloud The point cloud that will be stored.
+	 * @param encoding ASCII or binary (default) encoding.
+	 * @throws runtime_error if the file cannot be written.
+	 */
+	void storeToPlyFile(std::string filename, PointCloud3D* pointCloud, Encoding encoding = binary);
+
+	/**
+	 * @brief Append the points of a PCD file to a point cloud.
+	 * @param filename The name of the file e.g. point_cloud.pcd
+	 * @param[out] pointCloud The point cloud where the points will be added to.
+	 * @throws runtime_error if the file cannot be read or has an unsupported format.
+	 */
+	void readFromPcdFile(std::string filename, PointCloud3D* pointCloud);
+
+	/**
+	 * @brief Store a point cloud into a PCD file.
+	 * @param filename The name of the file e.g. point_cloud.pcd
+	 * @param[in] pointCloud The point cloud that will be stored.
+	 * @param encoding ASCII or binary (default) encoding.
+	 * @throws runtime_error if the file cannot be written.
+	 */
+	void storeToPcdFile(std::string filename, PointCloud3D* pointCloud, Encoding encoding = binary);
+
+};
+
+}
+
+#endif /* BRICS_3D_POINTCLOUD3DFILEHANDLER_H_ */
+
+/* EOF */
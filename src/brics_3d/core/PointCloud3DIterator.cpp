@@ -20,8 +20,12 @@
 
 #include "PointCloud3DIterator.h"
 #include "HomogeneousMatrix44.h"
+#include "HomogeneousTransformationKernel.h"
 #include "Logger.h"
 
+#include <algorithm>
+#include <assert.h>
+
 namespace brics_3d {
 
 PointCloud3DIterator::PointCloud3DIterator() {
@@ -38,68 +42,22 @@ std::string PointCloud3DIterator::getPointCloudTypeName() {
 
 void PointCloud3DIterator::begin() {
 	index = 0;
-	pointCloudsIterator = pointCloudsWithTransforms.begin();
-	associatedTransformIsIdentityIterator = associatedTransformIsIdentity.begin();
-
-	while(!end() && (pointCloudsIterator->first->getSize() <= 0)) { //skip empty clouds
-		pointCloudsIterator++;
-		associatedTransformIsIdentityIterator++;
-		LOG(WARNING) << "PointCloud3DIterator contains empty point clouds.";
-	}
-
-	if ( !end() ) {
-
-		Point3D* tmpHandle = &((*pointCloudsIterator->first->getPointCloud())[index]); //only one operator[] access - which is sightly faster
-		currentTransformedPoint.setX(tmpHandle->getX());
-		currentTransformedPoint.setY(tmpHandle->getY());
-		currentTransformedPoint.setZ(tmpHandle->getZ());
-		if(*associatedTransformIsIdentityIterator == false) { // the non "lazyness" case
-			currentTransformedPoint.homogeneousTransformation(pointCloudsIterator->second.get());
-		}
-
-	} else {
-		pointCloudsIterator = pointCloudsWithTransforms.end(); // empty iterator
-	}
+	pointCloudIndex = 0;
+	skipExhaustedPointClouds();
+	updateCurrentTransformedPoint();
 }
 
 void PointCloud3DIterator::next() {
-	++index;
-
-	if ( !end() ) {
-
-		if(index >= pointCloudsIterator->first->getSize()) { //wrap over - advance to next point cloud
-			index = 0;
-			pointCloudsIterator++;
-			associatedTransformIsIdentityIterator++;
-
-			while(!end() && (pointCloudsIterator->first->getSize() <= 0)) { //skip further empty clouds
-				pointCloudsIterator++;
-				associatedTransformIsIdentityIterator++;
-				LOG(WARNING) << "PointCloud3DIterator contains empty point clouds.";
-			}
-		}
-
-		if ( !end() ) { // end could be reach meanwhile so we have to check again
-
-			Point3D* tmpHandle = &((*pointCloudsIterator->first->getPointCloud())[index]); //only one operator[] access - which is slightly faster
-			currentTransformedPoint.setX(tmpHandle->getX());
-			currentTransformedPoint.setY(tmpHandle->getY());
-			currentTransformedPoint.setZ(tmpHandle->getZ());
-			if(*associatedTransformIsIdentityIterator == false) { // the non "lazyness" case
-				currentTransformedPoint.homogeneousTransformation(pointCloudsIterator->second.get());
-			}
-
-		}
-	} else {
-		/* no further iterations, we are at the end */
+	if (end()) { // no further iterations, we are at the end
+		return;
 	}
+	++index;
+	skipExhaustedPointClouds();
+	updateCurrentTransformedPoint();
 }
 
 bool PointCloud3DIterator::end() {
-	if (pointCloudsIterator ==  pointCloudsWithTransforms.end()) {
-			return true;
-	}
-	return false;
+	return pointCloudIndex >= pointCloudsWithTransforms.size();
 }
 
 Coordinate PointCloud3DIterator::getX() {
@@ -115,14 +73,53 @@ Coordinate PointCloud3DIterator::getZ() {
 }
 
 Point3D* PointCloud3DIterator::getRawData() {
-	return &(*pointCloudsIterator->first->getPointCloud())[index];
+	return &(*pointCloudsWithTransforms[pointCloudIndex].pointCloud->getPointCloud())[index];
+}
+
+unsigned int PointCloud3DIterator::getNextChunk(Coordinate* coordinates, unsigned int maxNumberOfPoints) {
+	assert(coordinates != 0 || maxNumberOfPoints == 0);
+	unsigned int numberOfPoints = 0;
+
+	while (!end() && (numberOfPoints < maxNumberOfPoints)) {
+		PointCloudWithTransform& current = pointCloudsWithTransforms[pointCloudIndex];
+		PointCloud3D::PackedCoordinatesConstPtr packedCoordinates = current.pointCloud->getPackedCoordinates();
+
+		/* copy a contiguous range of the cached packed coordinates of the current point cloud ... */
+		unsigned int rangeSize = std::min(maxNumberOfPoints - numberOfPoints, static_cast<unsigned int>(packedCoordinates->size() / 3) - index);
+		Coordinate* range = &coordinates[3 * numberOfPoints];
+		std::vector<double>::const_iterator rangeBegin = packedCoordinates->begin() + 3 * index;
+		std::copy(rangeBegin, rangeBegin + 3 * rangeSize, range);
+
+		/* ... and transform it at once */
+		if (!current.transformIsIdentity) {
+			HomogeneousTransformationKernel kernel(current.transform.get());
+			kernel.transformPackedCoordinates(range, rangeSize);
+		}
+
+		numberOfPoints += rangeSize;
+		index += rangeSize;
+		skipExhaustedPointClouds();
+	}
+
+	updateCurrentTransformedPoint();
+	return numberOfPoints;
 }
 
 void PointCloud3DIterator::insert(PointCloud3D::PointCloud3DPtr pointCloud, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr associatedTransform) {
 	assert(pointCloud != 0);
 	assert(associatedTransform != 0);
-	pointCloudsWithTransforms.insert(std::make_pair(pointCloud, associatedTransform));
-	associatedTransformIsIdentity.push_back(associatedTransform->isIdentity());
+	for (unsigned int i = 0; i < pointCloudsWithTransforms.size(); ++i) {
+		if (pointCloudsWithTransforms[i].pointCloud == pointCloud) {
+			LOG(WARNING) << "PointCloud3DIterator already contains this point cloud. Ignoring it.";
+			return;
+		}
+	}
+
+	PointCloudWithTransform entry;
+	entry.pointCloud = pointCloud;
+	entry.transform = associatedTransform;
+	entry.transformIsIdentity = associatedTransform->isIdentity();
+	pointCloudsWithTransforms.push_back(entry);
 }
 
 void PointCloud3DIterator::insert(PointCloud3D::PointCloud3DPtr pointCloud) {
@@ -130,6 +127,30 @@ void PointCloud3DIterator::insert(PointCloud3D::PointCloud3DPtr pointCloud) {
 	insert(pointCloud, identityTransform);
 }
 
+void PointCloud3DIterator::skipExhaustedPointClouds() {
+	while (!end() && (index >= pointCloudsWithTransforms[pointCloudIndex].pointCloud->getSize())) {
+		if (index == 0) {
+			LOG(WARNING) << "PointCloud3DIterator contains empty point clouds.";
+		}
+		index = 0;
+		pointCloudIndex++;
+	}
+}
+
+void PointCloud3DIterator::updateCurrentTransformedPoint() {
+	if (end()) {
+		return;
+	}
+
+	const Point3D* tmpHandle = &((*pointCloudsWithTransforms[pointCloudIndex].pointCloud->getConstPointCloud())[index]); //only one operator[] access - which is sightly faster
+	currentTransformedPoint.setX(tmpHandle->getX());
+	currentTransformedPoint.setY(tmpHandle->getY());
+	currentTransformedPoint.setZ(tmpHandle->getZ());
+	if (!pointCloudsWithTransforms[pointCloudIndex].transformIsIdentity) { // the non "lazyness" case
+		currentTransformedPoint.homogeneousTransformation(pointCloudsWithTransforms[pointCloudIndex].transform.get());
+	}
+}
+
 }
 
 /* EOF */
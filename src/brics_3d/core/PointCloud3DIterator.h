@@ -21,7 +21,7 @@
 #ifndef BRICS_3D_POINTCLOUD3DITERATOR_H_
 #define BRICS_3D_POINTCLOUD3DITERATOR_H_
 
-#include <map>
+#include <vector>
 
 #include "IPoint3DIterator.h"
 #include "PointCloud3D.h"
@@ -35,6 +35,10 @@ namespace brics_3d {
  * The PointCloud3DIterator can hold a list of point clouds with associated rigid transforms.
  * While iterating and invocing getX(), getY() or getZ() the points will be multiplied with this is respective transforms.
  * The raw data in the point clouds remains unmodified and could be accessed via the getRawData function.
+ * The point clouds are traversed in the order of insertion.
+ *
+ * getNextChunk() copies up to a whole chunk of the cached packed coordinates (see PointCloud3D::getPackedCoordinates())
+ * and applies the transform of each point cloud once in bulk (cf. HomogeneousTransformationKernel).
  *
  *  @code
  *	PointCloud3D::PointCloud3DPtr cloud1(new PointCloud3D());
@@ -84,6 +88,7 @@ public:
 	virtual Coordinate getY(); // (possibly) transformed
 	virtual Coordinate getZ(); // (possibly) transformed
 	virtual Point3D* getRawData(); //not transformed, but might have additional data like color, etc.
+	virtual unsigned int getNextChunk(Coordinate* coordinates, unsigned int maxNumberOfPoints);
 
 	/**
 	 * @brief Add a point cloud with its associated transform.
@@ -103,28 +108,37 @@ public:
 protected:
 
 	/**
-	 * The stored pointers to the point clouds with associated transforms.
-	 * Destruction of the iterator will not delete the pointers.
+	 * @brief A point cloud with its associated transform.
 	 */
-	std::map<PointCloud3D::PointCloud3DPtr, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr> pointCloudsWithTransforms;
-
+	struct PointCloudWithTransform {
+		PointCloud3D::PointCloud3DPtr pointCloud;
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
 
-	/// Internal outer iteration handle.
-	std::map<PointCloud3D::PointCloud3DPtr, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr>::iterator pointCloudsIterator;
+		/**
+		 * Shortcut if the associated transform is the Identity transform.
+		 * By having this memory we can avoid sucessive calls of IHomogeneousMatrix44::isIdentity() -
+		 * which is a rather expensive operation.
+		 */
+		bool transformIsIdentity;
+	};
 
+	/// Advance to the next non empty point cloud if the current one is exhausted.
+	void skipExhaustedPointClouds();
 
-	/// Internal inner iteration handle.
-	unsigned int index;
-
+	/// Update currentTransformedPoint for the point at the current position.
+	void updateCurrentTransformedPoint();
 
 	/**
-	 * Shortcut if an associated transform is the Identity transform.
-	 * Assumes ith entry in this vector belongs to ith entry in pointCloudsWithTransforms.
-	 * By having this memory we can avoid sucessive calls of IHomogeneousMatrix44::isIdentity() -
-	 * which is a rather expensive operation.
+	 * The stored pointers to the point clouds with associated transforms.
+	 * Destruction of the iterator will not delete the pointers.
 	 */
-	std::vector<bool> associatedTransformIsIdentity;
-	std::vector<bool>::iterator associatedTransformIsIdentityIterator;
+	std::vector<PointCloudWithTransform> pointCloudsWithTransforms;
+
+	/// Internal outer iteration handle: index of the current point cloud.
+	unsigned int pointCloudIndex;
+
+	/// Internal inner iteration handle.
+	unsigned int index;
 
 	/// The cached data.
 	Point3D currentTransformedPoint;
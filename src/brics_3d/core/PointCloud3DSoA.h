@@ -0,0 +1,292 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_POINTCLOUD3DSOA_H_
+#define BRICS_3D_POINTCLOUD3DSOA_H_
+
+#include <vector>
+#include <assert.h>
+#include <boost/shared_ptr.hpp>
+
+#include "PointCloud3D.h"
+#include "HomogeneousTransformationKernel.h"
+
+namespace brics_3d {
+
+/**
+ * @brief Contiguous structure-of-arrays storage for Cartesian 3D points.
+ *
+ * In contrast to the PointCloud3D, which stores polymorphic Point3D objects,
+ * this class keeps the x, y and z coordinates in three separate, contiguous arrays.
+ * There is neither a vtable pointer per point nor a virtual call per coordinate
+ * access. Algorithms that need to run tight loops over all coordinates
+ * (filters, ICP, normal estimation, ...) can work on the raw arrays
+ * returned by getXCoordinates(), getYCoordinates() and getZCoordinates().
+ *
+ * The precision of the coordinates is defined by the template parameter. It defaults
+ * to the Coordinate type, but float can be used to halve the memory footprint.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  PointCloud3DSoA<float> soaCloud(pointCloud); // copy coordinates of a PointCloud3D
+ *
+ *  const float* x = soaCloud.getXCoordinates();
+ *  const float* y = soaCloud.getYCoordinates();
+ *  const float* z = soaCloud.getZCoordinates();
+ *  float maxHeight = z[0];
+ *  for (unsigned int i = 1; i < soaCloud.getSize(); ++i) {
+ *  	maxHeight = std::max(maxHeight, z[i]);
+ *  }
+ *
+ *  soaCloud.copyTo(resultPointCloud); // append coordinates to a PointCloud3D
+ *
+ * @endcode
+ *
+ * Decorations of points like color or normals are not represented in this storage.
+ *
+ * The PointCloud3D keeps its Point3D based storage, as the decorator pattern and the existing
+ * algorithms depend on it. This class is used where the coordinates are processed many times,
+ * e.g. for the hypothesis evaluation of the SAC methods (see SACHypothesisEvaluator), and as the
+ * coordinate storage of the OrganizedPointCloud3D. Algorithms
+ * that read the coordinates of a PointCloud3D only once should rather use its packed coordinate
+ * cache (see PointCloud3D::getPackedCoordinates()).
+ */
+template<typename ScalarT = Coordinate>
+class PointCloud3DSoA {
+public:
+
+	typedef ScalarT Scalar;
+	typedef boost::shared_ptr<PointCloud3DSoA<ScalarT> > PointCloud3DSoAPtr;
+	typedef boost::shared_ptr<PointCloud3DSoA<ScalarT> const> PointCloud3DSoAConstPtr;
+
+	/**
+	 * @brief Standard constructor
+	 */
+	PointCloud3DSoA() {
+		clear();
+	}
+
+	/**
+	 * @brief Constructor that copies all coordinates of an existing point cloud.
+	 * @param pointCloud The point cloud whose coordinates will be copied.
+	 */
+	PointCloud3DSoA(PointCloud3D* pointCloud) {
+		copyFrom(pointCloud);
+	}
+
+	/**
+	 * @brief Standard destructor
+	 */
+	virtual ~PointCloud3DSoA() {
+		clear();
+	}
+
+	/**
+	 * @brief Add a point to the end of the arrays.
+	 */
+	void addPoint(ScalarT x, ScalarT y, ScalarT z) {
+		xCoordinates.push_back(x);
+		yCoordinates.push_back(y);
+		zCoordinates.push_back(z);
+	}
+
+	/**
+	 * @brief Add a point to the end of the arrays. Only the coordinates are taken into account.
+	 */
+	void addPoint(const Point3D& point) {
+		addPoint(static_cast<ScalarT>(point.getX()), static_cast<ScalarT>(point.getY()), static_cast<ScalarT>(point.getZ()));
+	}
+
+	/**
+	 * @brief Get a copy of a single point.
+	 * @param index Index of the point. It is not range checked.
+	 */
+	Point3D getPoint(unsigned int index) const {
+		return Point3D(static_cast<Coordinate>(xCoordinates[index]),
+				static_cast<Coordinate>(yCoordinates[index]),
+				static_cast<Coordinate>(zCoordinates[index]));
+	}
+
+	/**
+	 * @brief Overwrite the coordinates of a single point.
+	 * @param index Index of the point. It is not range checked.
+	 */
+	void setPoint(unsigned int index, ScalarT x, ScalarT y, ScalarT z) {
+		xCoordinates[index] = x;
+		yCoordinates[index] = y;
+		zCoordinates[index] = z;
+	}
+
+	/**
+	 * @brief Get the number of points.
+	 */
+	unsigned int getSize() const {
+		return static_cast<unsigned int>(xCoordinates.size());
+	}
+
+	/**
+	 * @brief Reserve memory for a number of points, so consecutive addPoint() calls do not reallocate.
+	 */
+	void reserve(unsigned int size) {
+		xCoordinates.reserve(size);
+		yCoordinates.reserve(size);
+		zCoordinates.reserve(size);
+	}
+
+	/**
+	 * @brief Resize the arrays. New points are initialized with zeros.
+	 */
+	void resize(unsigned int size) {
+		xCoordinates.resize(size, 0);
+		yCoordinates.resize(size, 0);
+		zCoordinates.resize(size, 0);
+	}
+
+	/**
+	 * @brief Delete all points.
+	 */
+	void clear() {
+		xCoordinates.clear();
+		yCoordinates.clear();
+		zCoordinates.clear();
+	}
+
+	/**
+	 * @brief Raw access to the contiguous array of x coordinates.
+	 * @return Pointer to the first x coordinate or null if the storage is empty.
+	 * The pointer is invalidated by operations that change the size.
+	 */
+	ScalarT* getXCoordinates() {
+		return xCoordinates.empty() ? 0 : &xCoordinates[0];
+	}
+
+	/// @see getXCoordinates()
+	const ScalarT* getXCoordinates() const {
+		return xCoordinates.empty() ? 0 : &xCoordinates[0];
+	}
+
+	/**
+	 * @brief Raw access to the contiguous array of y coordinates.
+	 * @see getXCoordinates()
+	 */
+	ScalarT* getYCoordinates() {
+		return yCoordinates.empty() ? 0 : &yCoordinates[0];
+	}
+
+	/// @see getYCoordinates()
+	const ScalarT* getYCoordinates() const {
+		return yCoordinates.empty() ? 0 : &yCoordinates[0];
+	}
+
+	/**
+	 * @brief Raw access to the contiguous array of z coordinates.
+	 * @see getXCoordinates()
+	 */
+	ScalarT* getZCoordinates() {
+		return zCoordinates.empty() ? 0 : &zCoordinates[0];
+	}
+
+	/// @see getZCoordinates()
+	const ScalarT* getZCoordinates() const {
+		return zCoordinates.empty() ? 0 : &zCoordinates[0];
+	}
+
+	/**
+	 * @brief Replace the content by the coordinates of a PointCloud3D.
+	 * @param pointCloud The point cloud whose coordinates will be copied.
+	 */
+	void copyFrom(PointCloud3D* pointCloud) {
+		assert(pointCloud != 0);
+		PointCloud3D::PackedCoordinatesConstPtr packedCoordinates = pointCloud->getPackedCoordinates();
+		unsigned int size = pointCloud->getSize();
+		resize(size);
+		for (unsigned int i = 0; i < size; ++i) {
+			xCoordinates[i] = static_cast<ScalarT>((*packedCoordinates)[3 * i]);
+			yCoordinates[i] = static_cast<ScalarT>((*packedCoordinates)[3 * i + 1]);
+			zCoordinates[i] = static_cast<ScalarT>((*packedCoordinates)[3 * i + 2]);
+		}
+	}
+
+	/**
+	 * @brief Replace the content by a selection of points of a PointCloud3D, e.g. in a shuffled order.
+	 * @param pointCloud The point cloud whose coordinates will be copied.
+	 * @param indices The indices of the points that will be copied, in the order of the new arrays.
+	 */
+	void copyFrom(PointCloud3D* pointCloud, const std::vector<int>& indices) {
+		assert(pointCloud != 0);
+		PointCloud3D::PackedCoordinatesConstPtr packedCoordinates = pointCloud->getPackedCoordinates();
+		const double* coordinates = packedCoordinates->empty() ? 0 : &(*packedCoordinates)[0];
+		unsigned int size = static_cast<unsigned int>(indices.size());
+		resize(size);
+		for (unsigned int i = 0; i < size; ++i) {
+			assert(indices[i] >= 0 && static_cast<unsigned int>(indices[i]) < pointCloud->getSize());
+			const double* point = coordinates + 3 * indices[i];
+			xCoordinates[i] = static_cast<ScalarT>(point[0]);
+			yCoordinates[i] = static_cast<ScalarT>(point[1]);
+			zCoordinates[i] = static_cast<ScalarT>(point[2]);
+		}
+	}
+
+	/**
+	 * @brief Append all points to a PointCloud3D.
+	 * @param[out] pointCloud The point cloud where the points will be added to.
+	 */
+	void copyTo(PointCloud3D* pointCloud) const {
+		assert(pointCloud != 0);
+		unsigned int size = getSize();
+		pointCloud->getPointCloud()->reserve(pointCloud->getSize() + size);
+		for (unsigned int i = 0; i < size; ++i) {
+			pointCloud->addPoint(Point3D(static_cast<Coordinate>(xCoordinates[i]),
+					static_cast<Coordinate>(yCoordinates[i]),
+					static_cast<Coordinate>(zCoordinates[i])));
+		}
+	}
+
+	/**
+	 * @brief Applies a homogeneous transformation to all points.
+	 *
+	 * Uses the HomogeneousTransformationKernel, i.e. the same code path as
+	 * PointCloud3D::homogeneousTransformation().
+	 *
+	 * @param[in] transformation The homogeneous transformation matrix that will be applied
+	 */
+	void homogeneousTransformation(IHomogeneousMatrix44* transformation) {
+		HomogeneousTransformationKernel kernel(transformation);
+		kernel.transformCoordinateArrays(getXCoordinates(), getYCoordinates(), getZCoordinates(), getSize());
+	}
+
+private:
+
+	/// Contiguous array of x coordinates
+	std::vector<ScalarT> xCoordinates;
+
+	/// Contiguous array of y coordinates
+	std::vector<ScalarT> yCoordinates;
+
+	/// Contiguous array of z coordinates
+	std::vector<ScalarT> zCoordinates;
+};
+
+}
+
+#endif /* BRICS_3D_POINTCLOUD3DSOA_H_ */
+
+/* EOF */
@@ -18,6 +18,7 @@
 ******************************************************************************/
 
 #include "Triangle.h"
+#include "HomogeneousTransformationKernel.h"
 #include "assert.h"
 
 namespace brics_3d {
@@ -57,9 +58,8 @@ void Triangle::setVertex(int vertexIndex, Point3D vertex) {
 }
 
 void Triangle::homogeneousTransformation(IHomogeneousMatrix44 *transformation) {
-	for (int i = 0; i <= 2; ++i) { // propagate transformation to vertices
-		vertices[i].homogeneousTransformation(transformation);
-	}
+	HomogeneousTransformationKernel kernel(transformation); // propagate transformation to vertices
+	kernel.transformPoints(vertices, 3);
 }
 
 ostream& operator<<(ostream &outStream, Triangle &triangle) {
@@ -18,6 +18,7 @@
 ******************************************************************************/
 
 #include "TriangleMeshExplicit.h"
+#include "HomogeneousTransformationKernel.h"
 #include "assert.h"
 
 
@@ -79,8 +80,9 @@ void TriangleMeshExplicit::removeTriangle (int triangleIndex) {
 }
 
 void TriangleMeshExplicit::homogeneousTransformation(IHomogeneousMatrix44 *transformation) {
-	for (int i = 0; i < this->getSize(); ++i) { // propagate transformation to triangles
-		(*triangles)[i].homogeneousTransformation(transformation);
+	HomogeneousTransformationKernel kernel(transformation);
+	for (int i = 0; i < this->getSize(); ++i) { // propagate transformation to the vertices of the triangles
+		kernel.transformPoints((*triangles)[i].getVertex(0), 3);
 	}
 }
 
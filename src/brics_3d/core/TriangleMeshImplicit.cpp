@@ -18,6 +18,7 @@
 ******************************************************************************/
 
 #include "TriangleMeshImplicit.h"
+#include "HomogeneousTransformationKernel.h"
 #include "assert.h"
 
 namespace brics_3d {
@@ -108,9 +109,11 @@ void TriangleMeshImplicit::removeTriangle (int triangleIndex) {
 }
 
 void TriangleMeshImplicit::homogeneousTransformation(IHomogeneousMatrix44 *transformation) {
-	for (int i = 0; i < static_cast<int>(vertices->size()); ++i) { // propagate transformation to triangles
-		(*vertices)[i].homogeneousTransformation(transformation);
+	if (vertices->empty()) {
+		return;
 	}
+	HomogeneousTransformationKernel kernel(transformation); // vertices are stored contiguously
+	kernel.transformPoints(&(*vertices)[0], static_cast<unsigned int>(vertices->size()));
 }
 
 void TriangleMeshImplicit::read(std::istream& inStream) {
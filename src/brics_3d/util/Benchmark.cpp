@@ -43,11 +43,20 @@ std::string Benchmark::directoryName = ""; // deduced from time-stamp
 #endif
 
 Benchmark::Benchmark() {
-	Benchmark("unnamedBenchmark");
+	this->benchmarkName = "unnamedBenchmark";
+	this->fileExtension = "txt";
+	setupTargetFile();
 }
 
 Benchmark::Benchmark(std::string benchmarkName) {
 	this->benchmarkName = benchmarkName;
+	this->fileExtension = "txt";
+	setupTargetFile();
+}
+
+Benchmark::Benchmark(std::string benchmarkName, std::string fileExtension) {
+	this->benchmarkName = benchmarkName;
+	this->fileExtension = fileExtension;
 	setupTargetFile();
 }
 
@@ -101,7 +110,7 @@ void Benchmark::setupTargetFile() {
 	}
 
 	/* concatenate resulting filename string */
-	fileName = Benchmark::directoryName + Benchmark::seperator + benchmarkName + ".txt";
+	fileName = Benchmark::directoryName + Benchmark::seperator + benchmarkName + "." + fileExtension;
 	cout << "INFO: Logging benchmark results to: " << fileName << endl;
 
 	output.open(fileName.c_str(), ios::trunc);
@@ -61,6 +61,13 @@ public:
 	 */
 	Benchmark(std::string benchmarkName);
 
+	/**
+	 * @brief Constructor that allows to specify a benchmark name and the type of the output file
+	 * @param benchmarkName Name of the benchmark. The benchmark output will be saved in a file called like this name.
+	 * @param fileExtension Suffix of the file without the dot, e.g. "json" or "csv".
+	 */
+	Benchmark(std::string benchmarkName, std::string fileExtension);
+
 	/**
 	 * Standard destructor.
 	 */
@@ -81,6 +88,9 @@ private:
 	/// The name of this benchmark. The benchmark output will be saved in a file called like this name.
 	std::string benchmarkName;
 
+	/// Suffix of the file name, "txt" by default.
+	std::string fileExtension;
+
 	/// Resulting file name. Is a concatenation of directoryName and benchmarkName.
 	std::string fileName;
 
@@ -0,0 +1,242 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "brics_3d/util/Timer.h"
+#include "brics_3d/core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <assert.h>
+
+namespace brics_3d {
+
+BenchmarkRunner::BenchmarkRunner() {
+	this->warmupRuns = 1;
+	this->repetitions = 10;
+	this->filter = "";
+}
+
+BenchmarkRunner::~BenchmarkRunner() {
+
+}
+
+bool BenchmarkRunner::run(std::string name, Function body, double itemsPerRun, Function prepare) {
+	assert(body);
+	if (!filter.empty() && name.find(filter) == std::string::npos) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i < warmupRuns; ++i) {
+		if (prepare) {
+			prepare();
+		}
+		body();
+	}
+
+	Timer timer;
+	std::vector<double> timings;
+	timings.reserve(repetitions);
+	for (unsigned int i = 0; i < repetitions; ++i) {
+		if (prepare) {
+			prepare();
+		}
+		timer.reset();
+		body();
+		timings.push_back(static_cast<double>(timer.getElapsedTime()));
+	}
+
+	Result result;
+	result.name = name;
+	if (!timings.empty()) {
+		computeStatistics(timings, itemsPerRun, result);
+	}
+	results.push_back(result);
+
+	LOG(INFO) << "Benchmark " << name << ": median " << result.median << " ms, p90 " << result.percentile90
+			<< " ms, throughput " << result.throughput << " items/s";
+	return true;
+}
+
+const std::vector<BenchmarkRunner::Result>& BenchmarkRunner::getResults() const {
+	return results;
+}
+
+void BenchmarkRunner::setContext(std::string key, std::string value) {
+	for (unsigned int i = 0; i < context.size(); ++i) {
+		if (context[i].first == key) {
+			context[i].second = value;
+			return;
+		}
+	}
+	context.push_back(std::make_pair(key, value));
+}
+
+void BenchmarkRunner::writeJSON(std::ostream& output) const {
+	std::ostringstream json; // fixed formatting that does not alter the state of output
+	json << std::setprecision(9);
+
+	json << "{" << std::endl;
+	json << "  \"context\": {";
+	json << "\"warmupRuns\": " << warmupRuns << ", \"repetitions\": " << repetitions;
+	for (unsigned int i = 0; i < context.size(); ++i) {
+		json << ", \"" << escape(context[i].first) << "\": \"" << escape(context[i].second) << "\"";
+	}
+	json << "}," << std::endl;
+
+	json << "  \"results\": [" << std::endl;
+	for (unsigned int i = 0; i < results.size(); ++i) {
+		const Result& result = results[i];
+		json << "    {\"name\": \"" << escape(result.name) << "\""
+				<< ", \"repetitions\": " << result.repetitions
+				<< ", \"itemsPerRun\": " << result.itemsPerRun
+				<< ", \"minimum\": " << result.minimum
+				<< ", \"median\": " << result.median
+				<< ", \"mean\": " << result.mean
+				<< ", \"standardDeviation\": " << result.standardDeviation
+				<< ", \"percentile90\": " << result.percentile90
+				<< ", \"percentile99\": " << result.percentile99
+				<< ", \"maximum\": " << result.maximum
+				<< ", \"throughput\": " << result.throughput << "}";
+		json << ((i + 1 < results.size()) ? "," : "") << std::endl;
+	}
+	json << "  ]" << std::endl;
+	json << "}" << std::endl;
+
+	output << json.str();
+}
+
+void BenchmarkRunner::writeCSV(std::ostream& output) const {
+	std::ostringstream csv;
+	csv << std::setprecision(9);
+
+	csv << "name,repetitions,itemsPerRun,minimum [ms],median [ms],mean [ms],standardDeviation [ms],percentile90 [ms],percentile99 [ms],maximum [ms],throughput [items/s]" << std::endl;
+	for (unsigned int i = 0; i < results.size(); ++i) {
+		const Result& result = results[i];
+		if (result.name.find_first_of(",\"") != std::string::npos) { // quote as in RFC 4180
+			std::string quotedName = result.name;
+			for (std::string::size_type position = quotedName.find('"'); position != std::string::npos; position = quotedName.find('"', position + 2)) {
+				quotedName.insert(position, "\"");
+			}
+			csv << "\"" << quotedName << "\"";
+		} else {
+			csv << result.name;
+		}
+		csv << "," << result.repetitions << "," << result.itemsPerRun << ","
+				<< result.minimum << "," << result.median << "," << result.mean << "," << result.standardDeviation << ","
+				<< result.percentile90 << "," << result.percentile99 << "," << result.maximum << "," << result.throughput << std::endl;
+	}
+
+	output << csv.str();
+}
+
+void BenchmarkRunner::computeStatistics(std::vector<double> timings, double itemsPerRun, Result& result) {
+	assert(!timings.empty());
+	std::sort(timings.begin(), timings.end());
+	unsigned int count = static_cast<unsigned int>(timings.size());
+
+	double sum = 0.0;
+	for (unsigned int i = 0; i < count; ++i) {
+		sum += timings[i];
+	}
+	double mean = sum / count;
+	double squaredDeviations = 0.0;
+	for (unsigned int i = 0; i < count; ++i) {
+		squaredDeviations += (timings[i] - mean) * (timings[i] - mean);
+	}
+
+	result.repetitions = count;
+	result.itemsPerRun = itemsPerRun;
+	result.minimum = timings.front();
+	result.maximum = timings.back();
+	result.mean = mean;
+	result.standardDeviation = (count > 1) ? std::sqrt(squaredDeviations / (count - 1)) : 0.0; // sample standard deviation
+	result.median = getPercentile(timings, 50.0);
+	result.percentile90 = getPercentile(timings, 90.0);
+	result.percentile99 = getPercentile(timings, 99.0);
+	result.throughput = (result.median > 0.0) ? itemsPerRun / (result.median / 1000.0) : 0.0;
+}
+
+double BenchmarkRunner::getPercentile(const std::vector<double>& sortedValues, double percent) {
+	assert(!sortedValues.empty());
+	percent = std::max(0.0, std::min(100.0, percent));
+	double rank = percent / 100.0 * (sortedValues.size() - 1);
+	unsigned int lower = static_cast<unsigned int>(std::floor(rank));
+	unsigned int upper = std::min(lower + 1, static_cast<unsigned int>(sortedValues.size() - 1));
+	double fraction = rank - lower;
+	return sortedValues[lower] + fraction * (sortedValues[upper] - sortedValues[lower]);
+}
+
+std::string BenchmarkRunner::escape(const std::string& value) {
+	std::ostringstream escaped;
+	for (unsigned int i = 0; i < value.size(); ++i) {
+		char c = value[i];
+		switch (c) {
+		case '"':
+			escaped << "\\\"";
+			break;
+		case '\\':
+			escaped << "\\\\";
+			break;
+		case '\n':
+			escaped << "\\n";
+			break;
+		case '\t':
+			escaped << "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+			} else {
+				escaped << c;
+			}
+		}
+	}
+	return escaped.str();
+}
+
+unsigned int BenchmarkRunner::getWarmupRuns() const {
+	return warmupRuns;
+}
+
+void BenchmarkRunner::setWarmupRuns(unsigned int warmupRuns) {
+	this->warmupRuns = warmupRuns;
+}
+
+unsigned int BenchmarkRunner::getRepetitions() const {
+	return repetitions;
+}
+
+void BenchmarkRunner::setRepetitions(unsigned int repetitions) {
+	this->repetitions = repetitions;
+}
+
+std::string BenchmarkRunner::getFilter() const {
+	return filter;
+}
+
+void BenchmarkRunner::setFilter(std::string filter) {
+	this->filter = filter;
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,203 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef BRICS_3D_BENCHMARKRUNNER_H_
+#define BRICS_3D_BENCHMARKRUNNER_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include <boost/function.hpp>
+
+namespace brics_3d {
+
+/**
+ * @brief Repeated timing of benchmark cases with statistics and machine readable output.
+ *
+ * Each case runs a number of untimed warmup runs first and then a number of timed repetitions.
+ * Per case the minimum, maximum, mean, standard deviation, median, 90th and 99th percentile of the run time
+ * and the throughput are reported. The median is used for the throughput, as it is robust against
+ * single disturbed runs.
+ *
+ * The results can be written as JSON (writeJSON()) or CSV (writeCSV()), e.g. to a file created by Benchmark.
+ * Context entries (see setContext()) like the data size or the number of threads are part of the JSON output,
+ * so results of different releases can be compared.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  BenchmarkRunner runner;
+ *  runner.setRepetitions(20);
+ *  runner.run("filtering/voxelgrid", boost::bind(&VoxelGridFilter::filter, &filter, &input, &output), input.getSize());
+ *
+ *  Benchmark jsonOutput("myBenchmark", "json");
+ *  runner.writeJSON(jsonOutput.output);
+ *
+ * @endcode
+ */
+class BenchmarkRunner {
+public:
+
+	/**
+	 * @brief Function that is executed by a benchmark case.
+	 */
+	typedef boost::function<void ()> Function;
+
+	/**
+	 * @brief Statistics of one benchmark case. All timings are in [ms].
+	 */
+	class Result {
+	public:
+		Result() : repetitions(0), itemsPerRun(0.0), minimum(0.0), maximum(0.0), mean(0.0), standardDeviation(0.0),
+			median(0.0), percentile90(0.0), percentile99(0.0), throughput(0.0) {};
+
+		/// Name of the case.
+		std::string name;
+
+		/// Number of timed runs.
+		unsigned int repetitions;
+
+		/// Number of items (e.g. points or queries) that are processed per run.
+		double itemsPerRun;
+
+		double minimum;
+		double maximum;
+		double mean;
+		double standardDeviation;
+		double median;
+		double percentile90;
+		double percentile99;
+
+		/// Processed items per second, based on the median.
+		double throughput;
+	};
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	BenchmarkRunner();
+
+	/**
+	 * @brief Standard destructor.
+	 */
+	virtual ~BenchmarkRunner();
+
+	/**
+	 * @brief Run and time a benchmark case.
+	 * @param name Name of the case. Cases that do not match the filter are skipped.
+	 * @param body The function to be timed.
+	 * @param itemsPerRun Number of items that body processes. Used for the throughput.
+	 * @param prepare Optional function that is executed before each run of body, but is not timed.
+	 * E.g. to restore the input of an in place operation.
+	 * @return True if the case has been run, false if it has been skipped.
+	 */
+	bool run(std::string name, Function body, double itemsPerRun = 1.0, Function prepare = Function());
+
+	/**
+	 * @brief Get the results of all cases that have been run so far.
+	 * @return The results in the order of execution.
+	 */
+	const std::vector<Result>& getResults() const;
+
+	/**
+	 * @brief Add a context entry that is reported along with the results. An existing key is overwritten.
+	 * @param key The name of the entry, e.g. "points".
+	 * @param value The value of the entry.
+	 */
+	void setContext(std::string key, std::string value);
+
+	/**
+	 * @brief Write context and results as JSON object.
+	 * @param output The stream to write to.
+	 */
+	void writeJSON(std::ostream& output) const;
+
+	/**
+	 * @brief Write the results as CSV table with one header line.
+	 * @param output The stream to write to.
+	 */
+	void writeCSV(std::ostream& output) const;
+
+	/**
+	 * @brief Compute the statistics of a set of timings.
+	 * @param timings The run times in [ms]. Must not be empty.
+	 * @param itemsPerRun Number of items per run.
+	 * @param[out] result The statistics. Name is not modified.
+	 */
+	static void computeStatistics(std::vector<double> timings, double itemsPerRun, Result& result);
+
+	/**
+	 * @brief Get a percentile of sorted values, linearly interpolated between the closest ranks.
+	 * @param sortedValues Values in ascending order. Must not be empty.
+	 * @param percent The percentile in [0, 100].
+	 * @return The interpolated percentile.
+	 */
+	static double getPercentile(const std::vector<double>& sortedValues, double percent);
+
+	unsigned int getWarmupRuns() const;
+
+	/**
+	 * @brief Set the number of untimed runs before the timed ones. Default is 1.
+	 */
+	void setWarmupRuns(unsigned int warmupRuns);
+
+	unsigned int getRepetitions() const;
+
+	/**
+	 * @brief Set the number of timed runs. Default is 10.
+	 */
+	void setRepetitions(unsigned int repetitions);
+
+	std::string getFilter() const;
+
+	/**
+	 * @brief Set a filter for the cases to be run.
+	 * @param filter Only cases whose name contains this string are run. Empty means all cases (default).
+	 */
+	void setFilter(std::string filter);
+
+private:
+
+	/// Escape a string for JSON
+	static std::string escape(const std::string& value);
+
+	/// Number of untimed runs
+	unsigned int warmupRuns;
+
+	/// Number of timed runs
+	unsigned int repetitions;
+
+	/// Only cases whose name contains this string are run
+	std::string filter;
+
+	/// Key value pairs that describe the setup
+	std::vector<std::pair<std::string, std::string> > context;
+
+	/// The results
+	std::vector<Result> results;
+};
+
+}
+
+#endif /* BRICS_3D_BENCHMARKRUNNER_H_ */
+
+/* EOF */
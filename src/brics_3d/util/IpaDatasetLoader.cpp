@@ -19,6 +19,7 @@
 
 #include "IpaDatasetLoader.h"
 #include "brics_3d/core/ColoredPoint3D.h"
+#include <algorithm>
 
 namespace brics_3d {
 
@@ -174,6 +175,29 @@ PointCloud3D* IpaDatasetLoader::getColoredPointCloud() {
 	return pointCloud;
 }
 
+OrganizedPointCloud3D* IpaDatasetLoader::getOrganizedPointCloud() {
+	if (xyzImage == NULL || colorImage == NULL) {
+		LOG(ERROR) << "IpaDatasetLoader::getOrganizedPointCloud: Color image or intensity image is a NULL-pointer";
+		return NULL;
+	}
+
+	int width = std::min(xyzImage->width, colorImage->width);
+	int height = std::min(xyzImage->height, colorImage->height);
+	OrganizedPointCloud3D* pointCloud = new OrganizedPointCloud3D(width, height);
+
+	for (int row = 0; row < height; ++row) {
+		const float* xyz = reinterpret_cast<const float*>(xyzImage->imageData + row * xyzImage->widthStep);
+		const unsigned char* color = reinterpret_cast<const unsigned char*>(colorImage->imageData + row * colorImage->widthStep);
+		for (int col = 0; col < width; ++col) {
+			if (!((color[3 * col] == 0) && (color[3 * col + 1] == 0) && (color[3 * col + 2] == 0))) { //discard "black" points as they don't belong to the object itself
+				pointCloud->setPoint(row, col, xyz[3 * col], xyz[3 * col + 1], xyz[3 * col + 2]);
+			}
+		}
+	}
+
+	return pointCloud;
+}
+
 }
 
 /* EOF */
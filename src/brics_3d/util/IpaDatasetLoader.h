@@ -21,6 +21,7 @@
 #define BRICS_3D_IPADATASETLOADER_H_
 
 #include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/OrganizedPointCloud3D.h"
 #include "brics_3d/core/Logger.h"
 
 #ifdef WIN32
@@ -111,6 +112,14 @@ public:
 	 */
 	PointCloud3D* getColoredPointCloud();
 
+	/**
+	 * @brief Get an <code>OrganizedPointCloud3D</code> representation of the data, that keeps the image grid.
+	 *
+	 * Pixels with a black color are invalid, like the points that are discarded by getPointCloud().
+	 * @return New point cloud of the size of the xyz image, or NULL if no data is loaded. The caller takes the ownership.
+	 */
+	OrganizedPointCloud3D* getOrganizedPointCloud();
+
 private:
 
 	/// The 3D coordinates
@@ -196,8 +196,8 @@ osg::ref_ptr<osg::Node> OSGPointCloudVisualizer::createPointCloudNode(PointCloud
 //	for (i = 0; i < 60032; ++i, j += 2) { //TODO: strange limit on a windows machine; higher results in crash
 
 		osg::Vec3 tmpPoint;
-		tmpPoint.set((float) ((*pointCloud->getPointCloud())[i].getX()), (float) ((*pointCloud->getPointCloud())[i].getY()),
-				(float) ((*pointCloud->getPointCloud())[i].getZ()));
+		tmpPoint.set((float) ((*pointCloud->getConstPointCloud())[i].getX()), (float) ((*pointCloud->getConstPointCloud())[i].getY()),
+				(float) ((*pointCloud->getConstPointCloud())[i].getZ()));
 		vertices->push_back(tmpPoint);
 
 		/*
@@ -349,9 +349,9 @@ osg::ref_ptr<osg::Node> OSGPointCloudVisualizer::createColoredPointCloudNode(Poi
 	for (i = 0; i < coloredPointCloud->getSize(); ++i, j += 2) {
 
 		osg::Vec3 tmpPoint;
-		tmpPoint.set((float) ((*coloredPointCloud->getPointCloud())[i].getX()),
-				(float) ((*coloredPointCloud->getPointCloud())[i].getY()),
-				(float) ((*coloredPointCloud->getPointCloud())[i].getZ()));
+		tmpPoint.set((float) ((*coloredPointCloud->getConstPointCloud())[i].getX()),
+				(float) ((*coloredPointCloud->getConstPointCloud())[i].getY()),
+				(float) ((*coloredPointCloud->getConstPointCloud())[i].getZ()));
 		vertices->push_back(tmpPoint);
 
 		osg::Vec4ub tmpColor;
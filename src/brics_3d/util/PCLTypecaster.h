@@ -48,9 +48,9 @@ public:
 			pclCloudPtr->points.resize( pclCloudPtr->width * pclCloudPtr->height );
 
 			for (unsigned int i =0 ; i<pointCloud3DPtr->getSize() ; i++){
-				pclCloudPtr->points[i].x = (*pointCloud3DPtr->getPointCloud())[i].getX();
-				pclCloudPtr->points[i].y = (*pointCloud3DPtr->getPointCloud())[i].getY();
-				pclCloudPtr->points[i].z = (*pointCloud3DPtr->getPointCloud())[i].getZ();
+				pclCloudPtr->points[i].x = (*pointCloud3DPtr->getConstPointCloud())[i].getX();
+				pclCloudPtr->points[i].y = (*pointCloud3DPtr->getConstPointCloud())[i].getY();
+				pclCloudPtr->points[i].z = (*pointCloud3DPtr->getConstPointCloud())[i].getZ();
 			}
 		}
 
@@ -184,9 +184,9 @@ public:
 		float rgbVal24bit=0;
 
 		for (unsigned int i =0 ; i<pointCloud3DPtr->getSize() ; i++){
-			pclCloudPtr->points[i].x = (*pointCloud3DPtr->getPointCloud())[i].getX();
-			pclCloudPtr->points[i].y = (*pointCloud3DPtr->getPointCloud())[i].getY();
-			pclCloudPtr->points[i].z = (*pointCloud3DPtr->getPointCloud())[i].getZ();
+			pclCloudPtr->points[i].x = (*pointCloud3DPtr->getConstPointCloud())[i].getX();
+			pclCloudPtr->points[i].y = (*pointCloud3DPtr->getConstPointCloud())[i].getY();
+			pclCloudPtr->points[i].z = (*pointCloud3DPtr->getConstPointCloud())[i].getZ();
 
 			if( (*pointCloud3DPtr->getPointCloud())[i].asColoredPoint3D() == 0) {
 				/*this point does not contain color information so provide the default */
@@ -111,6 +111,18 @@ unsigned int Group::getNumberOfChildren() const {
 	return static_cast<unsigned int>(children.size());
 }
 
+void Group::invalidateGlobalTransform() {
+	if (!isGlobalTransformValid()) { // then the descendants are already outdated as well
+		return;
+	}
+	Node::invalidateGlobalTransform();
+	for(unsigned i = 0; i < getNumberOfChildren(); ++i) {
+		if (getChild(i)->getParent(0) == this) { // the global transform only depends on the first parent
+			getChild(i)->invalidateGlobalTransform();
+		}
+	}
+}
+
 void Group::accept(INodeVisitor* visitor){
 	visitor->visit(this);
 	if (visitor->getDirection() == INodeVisitor::upwards) { //TODO move to "traverseUpwards" method?
@@ -55,6 +55,10 @@ public:
 
     virtual void accept(INodeVisitor* visitor);
 
+  protected:
+
+    virtual void invalidateGlobalTransform();
+
   private:
     vector<NodePtr> children;
 
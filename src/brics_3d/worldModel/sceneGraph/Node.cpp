@@ -19,6 +19,8 @@
 
 #include "Node.h"
 #include "Attribute.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/Logger.h"
 #include <stdexcept>
 
 namespace brics_3d {
@@ -29,6 +31,7 @@ Node::Node() {
 	this->id = 0;
 	this->attributes.clear();
 	this->parents.clear();
+	this->globalTransformIsValid = false;
 }
 
 Node::~Node() {
@@ -58,6 +61,9 @@ void Node::setId(Id id)
 void Node::addParent(Node* node)
 {
     parents.push_back(node);
+    if (parents.size() == 1) { // the global transform only depends on the first parent
+    	invalidateGlobalTransform();
+    }
 }
 
 void Node::removeParent(Node* node)
@@ -65,7 +71,11 @@ void Node::removeParent(Node* node)
 
 	std::vector<Node*>::iterator parentIterator = std::find(parents.begin(), parents.end(), node);
     if (parentIterator!=parents.end()) {
+    	bool isFirstParent = (parentIterator == parents.begin());
     	parents.erase(parentIterator);
+    	if (isFirstParent) {
+    		invalidateGlobalTransform();
+    	}
     }
 }
 
@@ -98,6 +108,35 @@ void Node::accept(INodeVisitor* visitor) {
 	}
 }
 
+IHomogeneousMatrix44::IHomogeneousMatrix44ConstPtr Node::getCachedGlobalTransform() {
+	if (!globalTransformIsValid) {
+		/* a new matrix rather than an in place update, as the previous one might still be in use */
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr newGlobalTransform(new HomogeneousMatrix44()); //identity matrix
+		computeGlobalTransform(newGlobalTransform.get());
+		globalTransform = newGlobalTransform;
+		globalTransformIsValid = true;
+	}
+	return globalTransform;
+}
+
+void Node::invalidateGlobalTransform() {
+	globalTransformIsValid = false;
+}
+
+void Node::computeGlobalTransform(IHomogeneousMatrix44* result) {
+	assert(result != 0);
+	if (getNumberOfParents() > 0) { // != root
+		*result = *(getParent(0)->getCachedGlobalTransform());
+		if (getNumberOfParents() > 1) {
+			LOG(WARNING) << "Multiple transform paths to this node detected. Taking fist path and ignoring the rest.";
+		}
+	}
+}
+
+bool Node::isGlobalTransformValid() const {
+	return globalTransformIsValid;
+}
+
 } // namespace brics_3d::RSG
 
 } // namespace brics_3d
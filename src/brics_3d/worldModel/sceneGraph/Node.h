@@ -23,6 +23,7 @@
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
+#include "brics_3d/core/IHomogeneousMatrix44.h"
 #include "Id.h"
 #include "Attribute.h"
 #include "INodeVisitor.h"
@@ -76,6 +77,38 @@ public:
 
     virtual void accept(INodeVisitor* visitor);
 
+    /**
+     * @brief Get the accumulated transform from the root to this node.
+     *
+     * The result is cached. It will only be recomputed if the latest transform of a Transform on the
+     * path to the root has changed or if the parent relations on that path have changed. Thus repeated
+     * queries are O(1). In case the node has multiple parents the path via the first parent is taken.
+     * In case the node is a transform node it will be taken into account too.
+     *
+     * Please note that a query updates the cache, i.e. concurrent queries have to be synchronized.
+     *
+     * @return Shared pointer to the cached transform.
+     */
+    IHomogeneousMatrix44::IHomogeneousMatrix44ConstPtr getCachedGlobalTransform();
+
+protected:
+
+    /**
+     * @brief Mark the cached root to node transform as outdated.
+     *
+     * A group invalidates all its descendants as well.
+     */
+    virtual void invalidateGlobalTransform();
+
+    /**
+     * @brief Calculate the root to node transform based on the cached transform of the first parent.
+     * @param[out] result The accumulated transform.
+     */
+    virtual void computeGlobalTransform(IHomogeneousMatrix44* result);
+
+    /// Is the cached root to node transform up to date?
+    bool isGlobalTransformValid() const;
+
 
 private:
 
@@ -92,6 +125,12 @@ private:
 	/// List of pointers to the parent Nodes.
 	vector<Node*> parents; //these are rather weak references to prevent cyclic strong pointers
 
+	/// Cached transform from the root to this node. See getCachedGlobalTransform().
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr globalTransform;
+
+	/// Flag if globalTransform is up to date.
+	bool globalTransformIsValid;
+
 };
 
 } // namespace brics_3d::rsg
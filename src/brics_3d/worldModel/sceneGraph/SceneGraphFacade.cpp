@@ -20,7 +20,8 @@
 #include "SceneGraphFacade.h"
 #include "SimpleIdGenerator.h"
 #include "brics_3d/core/Logger.h"
-#include "AttributeFinder.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include <algorithm>
 
 namespace brics_3d {
 
@@ -50,32 +51,92 @@ void SceneGraphFacade::initialize() {
 	assert(rootNode->getId() == idGenerator->getRootId());
 	idLookUpTable.insert(std::make_pair(rootNode->getId(), rootNode));
 	updateObservers.clear();
+	concurrencyMode = singleThreaded;
+	updateDepth = 0;
 }
 
 unsigned int SceneGraphFacade::getRootId() {
 	return idGenerator->getRootId();
 }
 
+void SceneGraphFacade::setConcurrencyMode(ConcurrencyMode concurrencyMode) {
+	this->concurrencyMode = concurrencyMode;
+	if (concurrencyMode == snapshotIsolation) {
+		rebuildSnapshot();
+	} else {
+		boost::atomic_store(&snapshot, SceneGraphSnapshot::SceneGraphSnapshotPtr());
+	}
+}
+
+SceneGraphFacade::ConcurrencyMode SceneGraphFacade::getConcurrencyMode() const {
+	return concurrencyMode;
+}
+
+SceneGraphSnapshot::SceneGraphSnapshotPtr SceneGraphFacade::getSnapshot() {
+	return boost::atomic_load(&snapshot);
+}
+
 bool SceneGraphFacade::getNodes(vector<Attribute> attributes, vector<unsigned int>& ids) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getNodes(attributes, ids);
+	}
 	LOG(DEBUG) << " Current idLookUpTable lenght = " << idLookUpTable.size();
 	ids.clear();
-	Node::NodeWeakPtr tmpNode = findNodeRecerence(getRootId());
-	Node::NodePtr node = tmpNode.lock();
-	if (node != 0) {
-			AttributeFinder attributeFinder;
-			attributeFinder.setQueryAttributes(attributes);
-			node->accept(&attributeFinder);
-			for (unsigned int i = 0; i < static_cast<unsigned int>(attributeFinder.getMatchingNodes().size()) ; ++i) {
-				ids.push_back((*attributeFinder.getMatchingNodes()[i]).getId());
+	if (attributes.empty()) {
+		return true;
+	}
+
+	/* collect the ID sets of all query attributes */
+	vector<IdSet*> idSets;
+	unsigned int smallestIdSet = 0;
+	for (unsigned int i = 0; i < static_cast<unsigned int>(attributes.size()); ++i) {
+		boost::unordered_map<AttributeKey, IdSet>::iterator indexIterator = attributeIndex.find(AttributeKey(attributes[i].key, attributes[i].value));
+		if (indexIterator == attributeIndex.end()) {
+			return true; // no node has this attribute
+		}
+		idSets.push_back(&indexIterator->second);
+		if (indexIterator->second.size() < idSets[smallestIdSet]->size()) {
+			smallestIdSet = i;
+		}
+	}
+
+	/* intersect (logical AND) starting with the smallest set */
+	vector<unsigned int> orphanedIds;
+	for (IdSet::const_iterator idIterator = idSets[smallestIdSet]->begin(); idIterator != idSets[smallestIdSet]->end(); ++idIterator) {
+		bool isInAllSets = true;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(idSets.size()); ++i) {
+			if ((i != smallestIdSet) && (idSets[i]->find(*idIterator) == idSets[i]->end())) {
+				isInAllSets = false;
+				break;
 			}
+		}
+		if (!isInAllSets) {
+			continue;
+		}
 
-		return true;
+		nodeIterator = idLookUpTable.find(*idIterator);
+		if ((nodeIterator != idLookUpTable.end()) && !nodeIterator->second.expired()) {
+			ids.push_back(*idIterator);
+		} else {
+			orphanedIds.push_back(*idIterator);
+		}
 	}
-	LOG(ERROR) << "Cannot find root node. Aborting attribute search.";
-	return false;
+
+	/* lazy clean up of implicitly deleted nodes */
+	for (unsigned int i = 0; i < static_cast<unsigned int>(orphanedIds.size()); ++i) {
+		for (unsigned int j = 0; j < static_cast<unsigned int>(idSets.size()); ++j) {
+			idSets[j]->erase(orphanedIds[i]);
+		}
+	}
+
+	std::sort(ids.begin(), ids.end());
+	return true;
 }
 
 bool SceneGraphFacade::getNodeAttributes(unsigned int id, vector<Attribute>& attributes) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getNodeAttributes(id, attributes);
+	}
 	attributes.clear();
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -91,6 +152,9 @@ bool SceneGraphFacade::getNodeAttributes(unsigned int id, vector<Attribute>& att
 }
 
 bool SceneGraphFacade::getNodeParents(unsigned int id, vector<unsigned int>& parentIds) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getNodeParents(id, parentIds);
+	}
 	parentIds.clear();
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -104,6 +168,9 @@ bool SceneGraphFacade::getNodeParents(unsigned int id, vector<unsigned int>& par
 }
 
 bool SceneGraphFacade::getGroupChildren(unsigned int id, vector<unsigned int>& childIds) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getGroupChildren(id, childIds);
+	}
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	Group::GroupPtr group = boost::dynamic_pointer_cast<Group>(node);
@@ -118,6 +185,9 @@ bool SceneGraphFacade::getGroupChildren(unsigned int id, vector<unsigned int>& c
 }
 
 bool SceneGraphFacade::getTransform(unsigned int id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getTransform(id, timeStamp, transform);
+	}
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	rsg::Transform::TransformPtr transformNode = boost::dynamic_pointer_cast<rsg::Transform>(node);
@@ -130,6 +200,9 @@ bool SceneGraphFacade::getTransform(unsigned int id, TimeStamp timeStamp, IHomog
 }
 
 bool SceneGraphFacade::getUncertainTransform(unsigned int id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform, ITransformUncertainty::ITransformUncertaintyPtr &uncertainty) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getUncertainTransform(id, timeStamp, transform, uncertainty);
+	}
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	rsg::UncertainTransform::UncertainTransformPtr transformNode = boost::dynamic_pointer_cast<rsg::UncertainTransform>(node);
@@ -143,6 +216,9 @@ bool SceneGraphFacade::getUncertainTransform(unsigned int id, TimeStamp timeStam
 }
 
 bool SceneGraphFacade::getGeometry(unsigned int id, Shape::ShapePtr& shape, TimeStamp& timeStamp) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getGeometry(id, shape, timeStamp);
+	}
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	GeometricNode::GeometricNodePtr geometricNode = boost::dynamic_pointer_cast<GeometricNode>(node);
@@ -156,6 +232,9 @@ bool SceneGraphFacade::getGeometry(unsigned int id, Shape::ShapePtr& shape, Time
 }
 
 bool SceneGraphFacade::getTransformForNode (unsigned int id, unsigned int idReferenceNode, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform) {
+	if (concurrencyMode == snapshotIsolation) {
+		return getSnapshot()->getTransformForNode(id, idReferenceNode, timeStamp, transform);
+	}
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	Node::NodeWeakPtr tmpReferenceNode = findNodeRecerence(idReferenceNode);
@@ -170,6 +249,7 @@ bool SceneGraphFacade::getTransformForNode (unsigned int id, unsigned int idRefe
 
 
 bool SceneGraphFacade::addNode(unsigned int parentId, unsigned int& assignedId, vector<Attribute> attributes, bool forcedId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	bool idIsOk = false;
 	unsigned int id;
@@ -199,7 +279,10 @@ bool SceneGraphFacade::addNode(unsigned int parentId, unsigned int& assignedId,
 		parentGroup->addChild(newNode);
 		assignedId = newNode->getId();
 		idLookUpTable.insert(std::make_pair(newNode->getId(), newNode));
+		addToAttributeIndex(newNode->getId(), attributes);
 		operationSucceeded = true;
+		recordChange(assignedId);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -220,6 +303,7 @@ bool SceneGraphFacade::addNode(unsigned int parentId, unsigned int& assignedId,
 }
 
 bool SceneGraphFacade::addGroup(unsigned int parentId, unsigned int& assignedId, vector<Attribute> attributes, bool forcedId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	bool idIsOk = false;
 	unsigned int id;
@@ -250,7 +334,10 @@ bool SceneGraphFacade::addGroup(unsigned int parentId, unsigned int& assignedId,
 		parentGroup->addChild(newGroup);
 		assignedId = newGroup->getId();
 		idLookUpTable.insert(std::make_pair(newGroup->getId(), newGroup));
+		addToAttributeIndex(newGroup->getId(), attributes);
 		operationSucceeded = true;
+		recordChange(assignedId);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -271,6 +358,7 @@ bool SceneGraphFacade::addGroup(unsigned int parentId, unsigned int& assignedId,
 }
 
 bool SceneGraphFacade::addTransformNode(unsigned int parentId, unsigned int& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	bool idIsOk = false;
 	unsigned int id;
@@ -302,7 +390,10 @@ bool SceneGraphFacade::addTransformNode(unsigned int parentId, unsigned int& ass
 		parentGroup->addChild(newTransform);
 		assignedId = newTransform->getId();
 		idLookUpTable.insert(std::make_pair(newTransform->getId(), newTransform));
+		addToAttributeIndex(newTransform->getId(), attributes);
 		operationSucceeded = true;
+		recordChange(assignedId);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -323,6 +414,7 @@ bool SceneGraphFacade::addTransformNode(unsigned int parentId, unsigned int& ass
 }
 
 bool SceneGraphFacade::addUncertainTransformNode(unsigned int parentId, unsigned int& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	bool idIsOk = false;
 	unsigned int id;
@@ -352,7 +444,10 @@ bool SceneGraphFacade::addUncertainTransformNode(unsigned int parentId, unsigned
 		parentGroup->addChild(newTransform);
 		assignedId = newTransform->getId();
 		idLookUpTable.insert(std::make_pair(newTransform->getId(), newTransform));
+		addToAttributeIndex(newTransform->getId(), attributes);
 		operationSucceeded = true;
+		recordChange(assignedId);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -374,6 +469,7 @@ bool SceneGraphFacade::addUncertainTransformNode(unsigned int parentId, unsigned
 }
 
 bool SceneGraphFacade::addGeometricNode(unsigned int parentId, unsigned int& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	bool idIsOk = false;
 	unsigned int id;
@@ -405,7 +501,10 @@ bool SceneGraphFacade::addGeometricNode(unsigned int parentId, unsigned int& ass
 		parentGroup->addChild(newGeometricNode);
 		assignedId = newGeometricNode->getId();
 		idLookUpTable.insert(std::make_pair(newGeometricNode->getId(), newGeometricNode));
+		addToAttributeIndex(newGeometricNode->getId(), attributes);
 		operationSucceeded = true;
+		recordChange(assignedId);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -427,12 +526,16 @@ bool SceneGraphFacade::addGeometricNode(unsigned int parentId, unsigned int& ass
 
 
 bool SceneGraphFacade::setNodeAttributes(unsigned int id, vector<Attribute> newAttributes) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
 	if (node != 0) {
+		removeFromAttributeIndex(id, node->getAttributes());
 		node->setAttributes(newAttributes);
+		addToAttributeIndex(id, newAttributes);
 		operationSucceeded = true;
+		recordChange(id);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -450,6 +553,7 @@ bool SceneGraphFacade::setNodeAttributes(unsigned int id, vector<Attribute> newA
 }
 
 bool SceneGraphFacade::setTransform(unsigned int id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -457,6 +561,7 @@ bool SceneGraphFacade::setTransform(unsigned int id, IHomogeneousMatrix44::IHomo
 	if (transformNode != 0) {
 		transformNode->insertTransform(transform, timeStamp);
 		operationSucceeded = true;
+		recordTransformChange(id, transform, ITransformUncertainty::ITransformUncertaintyPtr(), timeStamp);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -474,6 +579,7 @@ bool SceneGraphFacade::setTransform(unsigned int id, IHomogeneousMatrix44::IHomo
 }
 
 bool SceneGraphFacade::setUncertainTransform(unsigned int id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -481,6 +587,7 @@ bool SceneGraphFacade::setUncertainTransform(unsigned int id, IHomogeneousMatrix
 	if (transformNode != 0) {
 		transformNode->insertTransform(transform, uncertainty, timeStamp);
 		operationSucceeded = true;
+		recordTransformChange(id, transform, uncertainty, timeStamp);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -499,6 +606,7 @@ bool SceneGraphFacade::setUncertainTransform(unsigned int id, IHomogeneousMatrix
 }
 
 bool SceneGraphFacade::deleteNode(unsigned int id) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -514,6 +622,9 @@ bool SceneGraphFacade::deleteNode(unsigned int id) {
 			 * so we found the handle to the current node; now we will invoke
 			 * the according delete function for every parent
 			 */
+			for (unsigned int i = 0; i < node->getNumberOfParents(); ++i) {
+				recordChange(node->getParent(i)->getId());
+			}
 			while (node->getNumberOfParents() > 0) { //NOTE: node->getNumberOfParents() will decrease within every iteration...
 				unsigned int i = 0;
 				rsg::Node* parentNode;
@@ -526,8 +637,10 @@ bool SceneGraphFacade::deleteNode(unsigned int id) {
 				}
 			}
 			idLookUpTable.erase(id); //erase by ID (if not done here there would be orphaned IDs)
+			removeFromAttributeIndex(id, node->getAttributes());
 			// TODO: do we have to delete children?
 			operationSucceeded = true;
+			recordChange(id);
 		}
 	}
 
@@ -545,6 +658,7 @@ bool SceneGraphFacade::deleteNode(unsigned int id) {
 }
 
 bool SceneGraphFacade::addParent(unsigned int id, unsigned int parentId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -555,6 +669,8 @@ bool SceneGraphFacade::addParent(unsigned int id, unsigned int parentId) {
 	if (parentGroup != 0 && node != 0) {
 		parentGroup->addChild(node);
 		operationSucceeded = true;
+		recordChange(id);
+		recordChange(parentId);
 	}
 
 	/* Call all observers regardless if an error occured or not */
@@ -572,6 +688,7 @@ bool SceneGraphFacade::addParent(unsigned int id, unsigned int parentId) {
 }
 
 bool SceneGraphFacade::removeParent(unsigned int id, unsigned int parentId) {
+	UpdateGuard guard(this);
 	bool operationSucceeded = false;
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(id);
 	Node::NodePtr node = tmpNode.lock();
@@ -596,6 +713,8 @@ bool SceneGraphFacade::removeParent(unsigned int id, unsigned int parentId) {
 					if (parentGroup != 0 ) {
 						parentGroup->removeChild(node);
 						operationSucceeded = true;
+						recordChange(id);
+						recordChange(parentId);
 					} else {
 						assert(false); // actually parents need to be groups otherwise sth. really went wrong
 					}
@@ -621,12 +740,14 @@ bool SceneGraphFacade::removeParent(unsigned int id, unsigned int parentId) {
 
 bool SceneGraphFacade::attachUpdateObserver(ISceneGraphUpdateObserver* observer) {
 	assert(observer != 0);
+	UpdateGuard guard(this); // the observer list must not change while an update is propagated
 	updateObservers.push_back(observer);
 	return true;
 }
 
 bool SceneGraphFacade::detachUpdateObserver(ISceneGraphUpdateObserver* observer) {
 	assert(observer != 0);
+	UpdateGuard guard(this);
 	std::vector<ISceneGraphUpdateObserver*>::iterator observerIterator = std::find(updateObservers.begin(), updateObservers.end(), observer);
     if (observerIterator!=updateObservers.end()) {
     	updateObservers.erase(observerIterator);
@@ -637,15 +758,184 @@ bool SceneGraphFacade::detachUpdateObserver(ISceneGraphUpdateObserver* observer)
 }
 
 bool SceneGraphFacade::executeGraphTraverser(INodeVisitor* visitor, unsigned int subgraphId) {
+	UpdateGuard guard(this);
 	Node::NodeWeakPtr tmpNode = findNodeRecerence(subgraphId);
 	Node::NodePtr node = tmpNode.lock();
 	if (node != 0) {
 		node->accept(visitor);
+		if (concurrencyMode == snapshotIsolation) { // the visitor might have changed any node
+			rebuildSnapshot();
+		}
 		return true;
 	}
 	return false;
 }
 
+SceneGraphFacade::UpdateGuard::UpdateGuard(SceneGraphFacade* facade) {
+	this->facade = facade;
+	if (facade->concurrencyMode == snapshotIsolation) {
+		facade->updateMutex.lock();
+		facade->updateDepth++;
+	}
+}
+
+SceneGraphFacade::UpdateGuard::~UpdateGuard() {
+	if (facade->concurrencyMode == snapshotIsolation) {
+		facade->updateDepth--;
+		if (facade->updateDepth == 0) {
+			facade->publishChanges();
+		}
+		facade->updateMutex.unlock();
+	}
+}
+
+void SceneGraphFacade::recordChange(Id id) {
+	if (concurrencyMode == snapshotIsolation) {
+		changedIds.push_back(id);
+	}
+}
+
+void SceneGraphFacade::recordTransformChange(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) {
+	if (concurrencyMode == snapshotIsolation) {
+		TransformChange change;
+		change.id = id;
+		change.transform = IHomogeneousMatrix44::IHomogeneousMatrix44Ptr(new HomogeneousMatrix44());
+		*change.transform = *transform; // a copy, as the caller might modify it later
+		change.uncertainty = uncertainty;
+		change.timeStamp = timeStamp;
+		changedTransforms.push_back(change);
+	}
+}
+
+void SceneGraphFacade::publishChanges() {
+	if (changedIds.empty() && changedTransforms.empty()) {
+		return;
+	}
+
+	/* the next version shares everything with the current one, except the shards that are changed */
+	SceneGraphSnapshot::SceneGraphSnapshotPtr currentSnapshot = boost::atomic_load(&snapshot);
+	SceneGraphSnapshot::SceneGraphSnapshotPtr nextSnapshot(new SceneGraphSnapshot(*currentSnapshot));
+	nextSnapshot->version++;
+
+	for (std::vector<TransformChange>::iterator change = changedTransforms.begin(); change != changedTransforms.end(); ++change) {
+		SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr record = nextSnapshot->getNodeRecord(change->id);
+		if (record == 0) {
+			continue;
+		}
+		SceneGraphSnapshot::NodeRecord* newRecord = new SceneGraphSnapshot::NodeRecord(*record);
+		newRecord->history = SceneGraphSnapshot::insertIntoHistory(record->history, change->transform, change->uncertainty, change->timeStamp, record->maxHistoryDuration);
+		nextSnapshot->setNodeRecord(SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr(newRecord));
+	}
+	for (std::vector<Id>::iterator id = changedIds.begin(); id != changedIds.end(); ++id) {
+		refreshNodeRecord(nextSnapshot.get(), *id);
+	}
+	changedIds.clear();
+	changedTransforms.clear();
+
+	boost::atomic_store(&snapshot, nextSnapshot);
+}
+
+void SceneGraphFacade::rebuildSnapshot() {
+	SceneGraphSnapshot::SceneGraphSnapshotPtr currentSnapshot = boost::atomic_load(&snapshot);
+	SceneGraphSnapshot::SceneGraphSnapshotPtr nextSnapshot(new SceneGraphSnapshot(getRootId()));
+	nextSnapshot->version = (currentSnapshot != 0) ? currentSnapshot->version + 1 : 0;
+	for (nodeIterator = idLookUpTable.begin(); nodeIterator != idLookUpTable.end(); ++nodeIterator) {
+		Node::NodePtr node = nodeIterator->second.lock();
+		if (node != 0) {
+			nextSnapshot->setNodeRecord(createNodeRecord(node, SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr()));
+		}
+	}
+	changedIds.clear();
+	changedTransforms.clear();
+
+	boost::atomic_store(&snapshot, nextSnapshot);
+}
+
+void SceneGraphFacade::refreshNodeRecord(SceneGraphSnapshot* nextSnapshot, Id id) {
+	Node::NodePtr node;
+	nodeIterator = idLookUpTable.find(id);
+	if (nodeIterator != idLookUpTable.end()) {
+		node = nodeIterator->second.lock();
+	}
+	if (node != 0) {
+		nextSnapshot->setNodeRecord(createNodeRecord(node, nextSnapshot->getNodeRecord(id)));
+		return;
+	}
+
+	/* the node has been deleted: remove it and all descendants that have been deleted implicitly */
+	std::vector<Id> deletedIds;
+	deletedIds.push_back(id);
+	while (!deletedIds.empty()) {
+		Id deletedId = deletedIds.back();
+		deletedIds.pop_back();
+		SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr record = nextSnapshot->getNodeRecord(deletedId);
+		if (record == 0) {
+			continue;
+		}
+		nextSnapshot->removeNodeRecord(deletedId);
+		for (unsigned int i = 0; i < static_cast<unsigned int>(record->childIds.size()); ++i) {
+			Node::NodePtr child;
+			nodeIterator = idLookUpTable.find(record->childIds[i]);
+			if (nodeIterator != idLookUpTable.end()) {
+				child = nodeIterator->second.lock();
+			}
+			if (child != 0) { // still reachable via another parent
+				nextSnapshot->setNodeRecord(createNodeRecord(child, nextSnapshot->getNodeRecord(child->getId())));
+			} else {
+				deletedIds.push_back(record->childIds[i]);
+			}
+		}
+	}
+}
+
+SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr SceneGraphFacade::createNodeRecord(Node::NodePtr node, SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr previousRecord) {
+	SceneGraphSnapshot::NodeRecord* record = new SceneGraphSnapshot::NodeRecord();
+	record->id = node->getId();
+	record->attributes = node->getAttributes();
+	for (unsigned int i = 0; i < node->getNumberOfParents(); ++i) {
+		record->parentIds.push_back(node->getParent(i)->getId());
+	}
+
+	Group::GroupPtr group = boost::dynamic_pointer_cast<Group>(node);
+	if (group != 0) {
+		record->type = SceneGraphSnapshot::group;
+		for (unsigned int i = 0; i < group->getNumberOfChildren(); ++i) {
+			record->childIds.push_back(group->getChild(i)->getId());
+		}
+	}
+
+	rsg::Transform::TransformPtr transformNode = boost::dynamic_pointer_cast<rsg::Transform>(node);
+	if (transformNode != 0) {
+		rsg::UncertainTransform::UncertainTransformPtr uncertainTransformNode = boost::dynamic_pointer_cast<rsg::UncertainTransform>(node);
+		record->type = (uncertainTransformNode != 0) ? SceneGraphSnapshot::uncertainTransform : SceneGraphSnapshot::transform;
+		record->maxHistoryDuration = transformNode->getMaxHistoryDuration();
+		if (previousRecord != 0) {
+			record->history = previousRecord->history;
+		} else {
+			std::vector< std::pair<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr, TimeStamp> > transformHistory;
+			transformNode->getTransformHistory(transformHistory);
+			for (int i = static_cast<int>(transformHistory.size()) - 1; i >= 0; --i) { // oldest first
+				IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transformCopy(new HomogeneousMatrix44());
+				*transformCopy = *transformHistory[i].first;
+				ITransformUncertainty::ITransformUncertaintyPtr uncertainty;
+				if (uncertainTransformNode != 0) {
+					uncertainty = uncertainTransformNode->getTransformUncertainty(transformHistory[i].second);
+				}
+				record->history = SceneGraphSnapshot::insertIntoHistory(record->history, transformCopy, uncertainty, transformHistory[i].second, record->maxHistoryDuration);
+			}
+		}
+	}
+
+	GeometricNode::GeometricNodePtr geometricNode = boost::dynamic_pointer_cast<GeometricNode>(node);
+	if (geometricNode != 0) {
+		record->type = SceneGraphSnapshot::geometricNode;
+		record->shape = geometricNode->getShape();
+		record->shapeTimeStamp = geometricNode->getTimeStamp();
+	}
+
+	return SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr(record);
+}
+
 Node::NodeWeakPtr SceneGraphFacade::findNodeRecerence(unsigned int id) {
 	nodeIterator = idLookUpTable.find(id);
 	if (nodeIterator != idLookUpTable.end()) { //TODO multiple IDs?
@@ -668,6 +958,24 @@ bool SceneGraphFacade::doesIdExist(unsigned int id) {
 	return false;
 }
 
+void SceneGraphFacade::addToAttributeIndex(unsigned int id, const vector<Attribute>& attributes) {
+	for (unsigned int i = 0; i < static_cast<unsigned int>(attributes.size()); ++i) {
+		attributeIndex[AttributeKey(attributes[i].key, attributes[i].value)].insert(id);
+	}
+}
+
+void SceneGraphFacade::removeFromAttributeIndex(unsigned int id, const vector<Attribute>& attributes) {
+	for (unsigned int i = 0; i < static_cast<unsigned int>(attributes.size()); ++i) {
+		boost::unordered_map<AttributeKey, IdSet>::iterator indexIterator = attributeIndex.find(AttributeKey(attributes[i].key, attributes[i].value));
+		if (indexIterator != attributeIndex.end()) {
+			indexIterator->second.erase(id);
+			if (indexIterator->second.empty()) {
+				attributeIndex.erase(indexIterator);
+			}
+		}
+	}
+}
+
 } // namespace brics_3d::RSG
 
 } // namespace brics_3d
@@ -30,9 +30,13 @@
 #include "UncertainTransform.h"
 #include "GeometricNode.h"
 #include "Shape.h"
+#include "SceneGraphSnapshot.h"
 
 #include <map>
 #include <boost/weak_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 using std::map;
 
 
@@ -50,11 +54,31 @@ namespace rsg {
  * The SceneGraphFacade takes care (maintains consistency) of mapping between IDs and internal pointers.
  * The implemented interfaces allow to create and maintain a scengraph bases on the node IDs only.
  *
+ * Besides the hash table for the IDs the facade maintains an inverted index that maps each attribute
+ * to the IDs of the nodes that carry it. Thus getNodes() does not need to traverse the graph; it
+ * intersects the ID sets of the query attributes instead. The index is kept up to date by the update
+ * interfaces, so attributes must not be changed directly at the nodes.
+ *
+ * By default the facade is not synchronized. In the snapshotIsolation concurrency mode (see setConcurrencyMode())
+ * it can be shared among threads: updates are serialized and each update publishes a new immutable
+ * SceneGraphSnapshot. Queries are answered by the latest snapshot without any lock, so readers
+ * are never blocked by writers. Readers that need a consistent view over several queries
+ * can hold a snapshot with getSnapshot().
+ *
  * @ingroup sceneGraph
  */
 class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
 
   public:
+
+	/**
+	 * @brief Synchronization of queries and updates.
+	 */
+	enum ConcurrencyMode {
+		singleThreaded,   ///< No synchronization (default). The facade must not be accessed concurrently.
+		snapshotIsolation ///< Updates are serialized and publish snapshots. Queries run lock-free on the latest snapshot.
+	};
+
 	SceneGraphFacade();
 
     SceneGraphFacade(IIdGenerator* idGenerator);
@@ -64,7 +88,41 @@ class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
     /* Facade specific methods */
     unsigned int getRootId();
 
+    /**
+     * @brief Set the synchronization of queries and updates.
+     *
+     * Switching to snapshotIsolation creates a first snapshot of the whole scene graph.
+     * Must not be called while other threads access the facade.
+     * @param concurrencyMode The new mode.
+     */
+    void setConcurrencyMode(ConcurrencyMode concurrencyMode);
+
+    /**
+     * @brief Get the synchronization of queries and updates.
+     */
+    ConcurrencyMode getConcurrencyMode() const;
+
+    /**
+     * @brief Get the latest published version of the scene graph.
+     *
+     * Can be called concurrently to updates. The snapshot remains unchanged by later updates.
+     * @return The snapshot. Null unless the concurrency mode is snapshotIsolation.
+     */
+    SceneGraphSnapshot::SceneGraphSnapshotPtr getSnapshot();
+
     /* Implemented query interfaces */
+
+    /**
+     * @brief Find all nodes that have at least the specified attributes.
+     *
+     * The result is computed from the attribute index, not by a traversal of the graph. Thus the IDs are
+     * returned in ascending order, independent of the position of the nodes in the graph. The same order
+     * is used in the snapshotIsolation mode (see SceneGraphSnapshot::getNodes()).
+     *
+     * @param attributes All of these attributes have to be present at a node.
+     * @param[out] ids The IDs of the matching nodes in ascending order. Existing content is replaced.
+     * @return True on success.
+     */
     bool getNodes(vector<Attribute> attributes, vector<unsigned int>& ids); //subgraph?
     bool getNodeAttributes(unsigned int id, vector<Attribute>& attributes);
     bool getNodeParents(unsigned int id, vector<unsigned int>& parentIds);
@@ -73,6 +131,10 @@ class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
     bool getUncertainTransform(unsigned int id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform, ITransformUncertainty::ITransformUncertaintyPtr &uncertainty);
     bool getGeometry(unsigned int id, Shape::ShapePtr& shape, TimeStamp& timeStamp);
 
+    /**
+     * @brief Get the transform between two nodes.
+     * The time stamp is ignored: the latest transforms along the path of the first parents are used (in both concurrency modes).
+     */
     bool getTransformForNode (unsigned int id, unsigned int idReferenceNode, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform);
 
     /* Implemented update interfaces */
@@ -97,6 +159,54 @@ class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
 
   private:
 
+    /**
+     * @brief Serializes an update in the snapshotIsolation mode and publishes the recorded changes at its end.
+     * Nested updates (e.g. by an observer) are published together with the outermost one.
+     */
+    class UpdateGuard {
+      public:
+    	UpdateGuard(SceneGraphFacade* facade);
+    	~UpdateGuard();
+      private:
+    	SceneGraphFacade* facade;
+    };
+
+    /**
+     * @brief A new transform that has to be added to the history of the next snapshot.
+     */
+    class TransformChange {
+      public:
+    	Id id;
+    	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+    	ITransformUncertainty::ITransformUncertaintyPtr uncertainty;
+    	TimeStamp timeStamp;
+    };
+
+    /**
+     * @brief Remember that the structure or the attributes of a node have changed.
+     * Does nothing unless the concurrency mode is snapshotIsolation.
+     * @param id The ID of the node. If the node does not exist anymore, it and its orphaned descendants are removed from the next snapshot.
+     */
+    void recordChange(Id id);
+
+    /**
+     * @brief Remember that a transform has been added to the history of a node.
+     * Does nothing unless the concurrency mode is snapshotIsolation.
+     */
+    void recordTransformChange(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp);
+
+    /// Create the next snapshot from the recorded changes and publish it.
+    void publishChanges();
+
+    /// Create and publish a snapshot of the complete scene graph.
+    void rebuildSnapshot();
+
+    /// Update or remove the record of a node in an unpublished snapshot.
+    void refreshNodeRecord(SceneGraphSnapshot* nextSnapshot, Id id);
+
+    /// Create the record of a node. The history of a transform is taken from the previous record if it exists.
+    SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr createNodeRecord(Node::NodePtr node, SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr previousRecord);
+
 	/// Internal initiaization.
     void initialize();
 
@@ -114,14 +224,42 @@ class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
      */
     bool doesIdExist(unsigned int id);
 
+    /**
+     * @brief Add a node to the attribute index.
+     * @param id The ID of the node.
+     * @param attributes The attributes of the node.
+     */
+    void addToAttributeIndex(unsigned int id, const vector<Attribute>& attributes);
+
+    /**
+     * @brief Remove a node from the attribute index.
+     * @param id The ID of the node.
+     * @param attributes The attributes of the node.
+     */
+    void removeFromAttributeIndex(unsigned int id, const vector<Attribute>& attributes);
+
+    /// (key, value) of an attribute
+    typedef std::pair<string, string> AttributeKey;
+
+    /// IDs of the nodes that share an attribute.
+    typedef boost::unordered_set<unsigned int> IdSet;
+
     /// The root of all evil...
     Group::GroupPtr rootNode;
 
     /// Table that maps IDs to references.
-    map<unsigned int, Node::NodeWeakPtr > idLookUpTable;
+    boost::unordered_map<unsigned int, Node::NodeWeakPtr > idLookUpTable;
 
     /// Iterator for idLookUpTable
-    map<unsigned int, Node::NodeWeakPtr >::const_iterator nodeIterator;
+    boost::unordered_map<unsigned int, Node::NodeWeakPtr >::const_iterator nodeIterator;
+
+    /**
+     * @brief Inverted index that maps attributes to the IDs of the nodes that have this attribute.
+     *
+     * Nodes that are implicitly deleted, as their parents have been deleted, are removed lazily
+     * while getNodes() is processed.
+     */
+    boost::unordered_map<AttributeKey, IdSet> attributeIndex;
 
     /// Handle to ID generator. Can be optionally specified at creation.
     IIdGenerator* idGenerator;
@@ -129,6 +267,24 @@ class SceneGraphFacade : public ISceneGraphQuery, public ISceneGraphUpdate {
     /// Set of observers that will be notified when the update function will be called.
     std::vector<ISceneGraphUpdateObserver*> updateObservers;
 
+    /// Synchronization of queries and updates.
+    ConcurrencyMode concurrencyMode;
+
+    /// Latest published snapshot. Only accessed with boost::atomic_load() and boost::atomic_store().
+    SceneGraphSnapshot::SceneGraphSnapshotPtr snapshot;
+
+    /// Serializes the updates in the snapshotIsolation mode.
+    boost::recursive_mutex updateMutex;
+
+    /// Nesting level of the current update.
+    unsigned int updateDepth;
+
+    /// Nodes whose records have to be refreshed in the next snapshot.
+    std::vector<Id> changedIds;
+
+    /// Transforms that have to be added in the next snapshot.
+    std::vector<TransformChange> changedTransforms;
+
 
 };
 
@@ -0,0 +1,99 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef RSG_SCENEGRAPHLOGFORMAT_H
+#define RSG_SCENEGRAPHLOGFORMAT_H
+
+namespace brics_3d {
+
+namespace rsg {
+
+/**
+ * @brief Constants of the binary scene graph log format, as written by SceneGraphLogWriter and read by SceneGraphLogReader.
+ *
+ * A log file consists of a header followed by records. All values are stored in the native (little endian)
+ * byte order, numbers are 32 bit unsigned integers (u32) or 64 bit IEEE doubles (f64).
+ *
+ * Header (headerSize bytes): u32 magic, u32 version, u32 ID of the root node, u32 reserved (0).
+ *
+ * Record: u32 record type, u32 payload size in bytes, payload. The payload contains the arguments of the
+ * corresponding ISceneGraphUpdate function in the order of the function signature (the forcedId flag is omitted,
+ * as IDs are always restored):
+ *  - ID: u32
+ *  - attributes: u32 count, then per attribute u32 key length, key, u32 value length, value
+ *  - transform: 16 f64, column-major as IHomogeneousMatrix44::getRawData()
+ *  - uncertainty: u32 rows, u32 columns, rows*columns f64
+ *  - time stamp: f64 seconds
+ *  - shape: u32 shape type, followed by
+ *    - box: f64 sizeX, sizeY, sizeZ
+ *    - cylinder: f64 radius, height
+ *    - pointCloud3D: u32 number of points n, 3n f64 (x0 y0 z0 x1 ...)
+ *    - triangleMesh: u32 number of triangles n, 9n f64 (the three vertices of each triangle)
+ *    - indexedTriangleMesh: u32 number of vertices n, 3n f64, u32 number of indices m, m u32
+ *
+ * A full snapshot is a sequence of records that rebuilds the graph, a delta log appends one record per update.
+ * Both can be stored in the same file. Readers ignore an incomplete record at the end of a file (e.g. after a crash
+ * while appending) and unknown record types of a newer minor revision are skipped via the payload size.
+ */
+class SceneGraphLogFormat {
+  public:
+
+	enum Constants {
+		magic = 0x47535242,  ///< "BRSG" in little endian byte order
+		version = 1,         ///< Current version of the format
+		headerSize = 16,     ///< Size of the file header in bytes
+		recordHeaderSize = 8 ///< Size of type and payload size of a record in bytes
+	};
+
+	/**
+	 * @brief The update function that a record stands for.
+	 */
+	enum RecordType {
+		addNodeRecord = 1,
+		addGroupRecord = 2,
+		addTransformNodeRecord = 3,
+		addUncertainTransformNodeRecord = 4,
+		addGeometricNodeRecord = 5,
+		setNodeAttributesRecord = 6,
+		setTransformRecord = 7,
+		setUncertainTransformRecord = 8,
+		deleteNodeRecord = 9,
+		addParentRecord = 10,
+		removeParentRecord = 11
+	};
+
+	/**
+	 * @brief The type of the shape of a geometric node.
+	 */
+	enum ShapeType {
+		box = 1,
+		cylinder = 2,
+		pointCloud3D = 3,        ///< PointCloud<PointCloud3D>, only the coordinates are stored
+		triangleMesh = 4,        ///< Mesh<ITriangleMesh>, restored as TriangleMeshExplicit
+		indexedTriangleMesh = 5  ///< Mesh<ITriangleMesh> with a TriangleMeshImplicit
+	};
+};
+
+}
+
+}
+
+#endif /* RSG_SCENEGRAPHLOGFORMAT_H */
+
+/* EOF */
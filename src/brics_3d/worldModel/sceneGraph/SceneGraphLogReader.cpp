@@ -0,0 +1,532 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "SceneGraphLogReader.h"
+#include "SceneGraphFacade.h"
+#include "Box.h"
+#include "Cylinder.h"
+#include "PointCloud.h"
+#include "Mesh.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/CovarianceMatrix66.h"
+#include "brics_3d/core/TriangleMeshExplicit.h"
+#include "brics_3d/core/TriangleMeshImplicit.h"
+#include "brics_3d/core/Logger.h"
+
+#include <cstring>
+#include <fstream>
+#include <assert.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace brics_3d {
+
+namespace rsg {
+
+namespace {
+
+/// Reads the values of a record payload. Any read beyond the end of the payload marks the decoder as failed.
+class PayloadDecoder {
+  public:
+	PayloadDecoder(const char* payload, unsigned int payloadSize) : position(payload), end(payload + payloadSize), failed(false) {};
+
+	unsigned int readUInt32() {
+		unsigned int value = 0;
+		if (canRead(4)) {
+			memcpy(&value, position, 4);
+			position += 4;
+		}
+		return value;
+	}
+
+	double readDouble() {
+		double value = 0.0;
+		readDoubles(&value, 1);
+		return value;
+	}
+
+	void readDoubles(double* values, unsigned int count) {
+		if (canReadElements(count, sizeof(double))) {
+			memcpy(values, position, count * sizeof(double));
+			position += count * sizeof(double);
+		}
+	}
+
+	/// Returns a pointer to count elements of doublesPerElement doubles within the payload (not necessarily aligned) or null.
+	const char* skipDoubles(unsigned int count, unsigned int doublesPerElement) {
+		const char* begin = position;
+		if (!canReadElements(count, doublesPerElement * sizeof(double))) {
+			return 0;
+		}
+		position += static_cast<size_t>(count) * doublesPerElement * sizeof(double);
+		return begin;
+	}
+
+	std::string readString() {
+		unsigned int length = readUInt32();
+		if (!canRead(length)) {
+			return std::string();
+		}
+		std::string value(position, length);
+		position += length;
+		return value;
+	}
+
+	void readAttributes(vector<Attribute>& attributes) {
+		unsigned int count = readUInt32();
+		attributes.clear();
+		for (unsigned int i = 0; (i < count) && !failed; ++i) {
+			Attribute attribute;
+			attribute.key = readString();
+			attribute.value = readString();
+			attributes.push_back(attribute);
+		}
+	}
+
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr readTransform() {
+		HomogeneousMatrix44* transform = new HomogeneousMatrix44();
+		readDoubles(transform->setRawData(), 16);
+		return IHomogeneousMatrix44::IHomogeneousMatrix44Ptr(transform);
+	}
+
+	ITransformUncertainty::ITransformUncertaintyPtr readUncertainty() {
+		unsigned int rows = readUInt32();
+		unsigned int columns = readUInt32();
+		if (rows == 0 && columns == 0) {
+			return ITransformUncertainty::ITransformUncertaintyPtr();
+		}
+		if (rows != 6 || columns != 6) { // CovarianceMatrix66 is the only implementation so far
+			LOG(ERROR) << "SceneGraphLogReader: Unsupported uncertainty with " << rows << "x" << columns << " elements.";
+			failed = true;
+			return ITransformUncertainty::ITransformUncertaintyPtr();
+		}
+		CovarianceMatrix66* uncertainty = new CovarianceMatrix66();
+		readDoubles(uncertainty->setRawData(), 36);
+		return ITransformUncertainty::ITransformUncertaintyPtr(uncertainty);
+	}
+
+	TimeStamp readTimeStamp() {
+		return TimeStamp(readDouble());
+	}
+
+	Shape::ShapePtr readShape() {
+		unsigned int shapeType = readUInt32();
+		switch (shapeType) {
+		case SceneGraphLogFormat::box: {
+			double size[3];
+			readDoubles(size, 3);
+			return Shape::ShapePtr(new Box(size[0], size[1], size[2]));
+		}
+		case SceneGraphLogFormat::cylinder: {
+			double radius = readDouble();
+			double height = readDouble();
+			return Shape::ShapePtr(new Cylinder(radius, height));
+		}
+		case SceneGraphLogFormat::pointCloud3D: {
+			unsigned int numberOfPoints = readUInt32();
+			const char* coordinates = skipDoubles(numberOfPoints, 3);
+			if (coordinates == 0) {
+				return Shape::ShapePtr();
+			}
+			PointCloud<PointCloud3D>::PointCloudPtr pointCloud(new PointCloud<PointCloud3D>());
+			pointCloud->data = boost::shared_ptr<PointCloud3D>(new PointCloud3D());
+			pointCloud->data->getPointCloud()->reserve(numberOfPoints);
+			double point[3];
+			for (unsigned int i = 0; i < numberOfPoints; ++i) {
+				memcpy(point, coordinates + i * 3 * sizeof(double), 3 * sizeof(double));
+				pointCloud->data->addPoint(Point3D(point[0], point[1], point[2]));
+			}
+			return pointCloud;
+		}
+		case SceneGraphLogFormat::triangleMesh: {
+			unsigned int numberOfTriangles = readUInt32();
+			const char* vertices = skipDoubles(numberOfTriangles, 9);
+			if (vertices == 0) {
+				return Shape::ShapePtr();
+			}
+			Mesh<ITriangleMesh>::MeshPtr mesh(new Mesh<ITriangleMesh>());
+			mesh->data = boost::shared_ptr<ITriangleMesh>(new TriangleMeshExplicit());
+			double triangle[9];
+			for (unsigned int i = 0; i < numberOfTriangles; ++i) {
+				memcpy(triangle, vertices + i * 9 * sizeof(double), 9 * sizeof(double));
+				mesh->data->addTriangle(Point3D(triangle[0], triangle[1], triangle[2]),
+						Point3D(triangle[3], triangle[4], triangle[5]),
+						Point3D(triangle[6], triangle[7], triangle[8]));
+			}
+			return mesh;
+		}
+		case SceneGraphLogFormat::indexedTriangleMesh: {
+			unsigned int numberOfVertices = readUInt32();
+			const char* vertexData = skipDoubles(numberOfVertices, 3);
+			unsigned int numberOfIndices = readUInt32();
+			if ((vertexData == 0) || !canReadElements(numberOfIndices, 4)) {
+				return Shape::ShapePtr();
+			}
+			if (numberOfIndices % 3 != 0) {
+				LOG(ERROR) << "SceneGraphLogReader: Indexed triangle mesh with " << numberOfIndices << " indices.";
+				failed = true;
+				return Shape::ShapePtr();
+			}
+			TriangleMeshImplicit* indexedMesh = new TriangleMeshImplicit();
+			Mesh<ITriangleMesh>::MeshPtr mesh(new Mesh<ITriangleMesh>());
+			mesh->data = boost::shared_ptr<ITriangleMesh>(indexedMesh);
+			indexedMesh->getVertices()->reserve(numberOfVertices);
+			double vertex[3];
+			for (unsigned int i = 0; i < numberOfVertices; ++i) {
+				memcpy(vertex, vertexData + i * 3 * sizeof(double), 3 * sizeof(double));
+				indexedMesh->getVertices()->push_back(Point3D(vertex[0], vertex[1], vertex[2]));
+			}
+			indexedMesh->getIndices()->reserve(numberOfIndices);
+			for (unsigned int i = 0; i < numberOfIndices; ++i) {
+				unsigned int index = readUInt32();
+				if (index >= numberOfVertices) {
+					LOG(ERROR) << "SceneGraphLogReader: Vertex index " << index << " exceeds the " << numberOfVertices << " vertices of a mesh.";
+					failed = true;
+					return Shape::ShapePtr();
+				}
+				indexedMesh->getIndices()->push_back(static_cast<int>(index));
+			}
+			return mesh;
+		}
+		default:
+			LOG(ERROR) << "SceneGraphLogReader: Unknown shape type " << shapeType << ".";
+			failed = true;
+			return Shape::ShapePtr();
+		}
+	}
+
+	/// True if a read exceeded the payload or an unsupported value was found.
+	bool hasFailed() const {
+		return failed;
+	}
+
+  private:
+	bool canRead(size_t size) {
+		if (failed || static_cast<size_t>(end - position) < size) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	/// Checks count * elementSize bytes without overflowing the multiplication.
+	bool canReadElements(unsigned int count, size_t elementSize) {
+		if (failed || static_cast<size_t>(end - position) / elementSize < count) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	const char* position;
+	const char* end;
+	bool failed;
+};
+
+}
+
+SceneGraphLogReader::SceneGraphLogReader() {
+	data = 0;
+	fileSize = 0;
+	validSize = 0;
+	isMapped = false;
+	version = 0;
+	rootId = 0;
+	receiverRootId = 0;
+	numberOfRecords = 0;
+}
+
+SceneGraphLogReader::~SceneGraphLogReader() {
+	close();
+}
+
+bool SceneGraphLogReader::open(std::string fileName) {
+	close();
+
+#ifndef WIN32
+	int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		LOG(ERROR) << "SceneGraphLogReader: Cannot open " << fileName << ".";
+		return false;
+	}
+	struct stat fileStatus;
+	if ((fstat(fileDescriptor, &fileStatus) == 0) && (fileStatus.st_size > 0)) {
+		fileSize = static_cast<unsigned long>(fileStatus.st_size);
+		void* mapping = mmap(0, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mapping != MAP_FAILED) {
+			madvise(mapping, fileSize, MADV_SEQUENTIAL);
+			data = static_cast<const char*>(mapping);
+			isMapped = true;
+		}
+	}
+	::close(fileDescriptor); // the mapping stays valid
+#endif
+
+	if (!isMapped) { // fall back to reading the whole file
+		std::ifstream file(fileName.c_str(), std::ios::binary);
+		if (!file.is_open()) {
+			LOG(ERROR) << "SceneGraphLogReader: Cannot open " << fileName << ".";
+			return false;
+		}
+		fallbackBuffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		fileSize = static_cast<unsigned long>(fallbackBuffer.size());
+		data = (fileSize > 0) ? &fallbackBuffer[0] : 0;
+	}
+
+	/* header */
+	unsigned int magic = 0;
+	if (fileSize >= SceneGraphLogFormat::headerSize) {
+		memcpy(&magic, data, 4);
+		memcpy(&version, data + 4, 4);
+		memcpy(&rootId, data + 8, 4);
+	}
+	if (magic != SceneGraphLogFormat::magic) {
+		LOG(ERROR) << "SceneGraphLogReader: " << fileName << " is not a scene graph log.";
+		close();
+		return false;
+	}
+	if (version > SceneGraphLogFormat::version) {
+		LOG(ERROR) << "SceneGraphLogReader: " << fileName << " has the unsupported version " << version << ".";
+		close();
+		return false;
+	}
+
+	/* find the end of the last complete record */
+	unsigned long offset = SceneGraphLogFormat::headerSize;
+	numberOfRecords = 0;
+	while (offset + SceneGraphLogFormat::recordHeaderSize <= fileSize) {
+		unsigned int payloadSize = 0;
+		memcpy(&payloadSize, data + offset + 4, 4);
+		unsigned long recordEnd = offset + SceneGraphLogFormat::recordHeaderSize + payloadSize;
+		if (recordEnd > fileSize) {
+			break;
+		}
+		offset = recordEnd;
+		numberOfRecords++;
+	}
+	validSize = offset;
+	if (validSize < fileSize) {
+		LOG(WARNING) << "SceneGraphLogReader: Ignoring an incomplete record at the end of " << fileName << ".";
+	}
+
+	return true;
+}
+
+void SceneGraphLogReader::close() {
+#ifndef WIN32
+	if (isMapped) {
+		munmap(const_cast<char*>(data), fileSize);
+	}
+#endif
+	isMapped = false;
+	fallbackBuffer.clear();
+	data = 0;
+	fileSize = 0;
+	validSize = 0;
+	numberOfRecords = 0;
+}
+
+bool SceneGraphLogReader::isOpen() const {
+	return data != 0;
+}
+
+bool SceneGraphLogReader::replay(ISceneGraphUpdate* receiver, Id receiverRootId) {
+	assert(receiver != 0);
+	if (!isOpen()) {
+		LOG(ERROR) << "SceneGraphLogReader: Cannot replay as no file is open.";
+		return false;
+	}
+	this->receiverRootId = receiverRootId;
+
+	unsigned long offset = SceneGraphLogFormat::headerSize;
+	unsigned long numberOfFailedUpdates = 0;
+	bool allRecordsDecoded = true;
+	while (offset < validSize) {
+		unsigned int type = 0;
+		unsigned int payloadSize = 0;
+		memcpy(&type, data + offset, 4);
+		memcpy(&payloadSize, data + offset + 4, 4);
+		bool updateSucceeded = true;
+		if (!replayRecord(type, data + offset + SceneGraphLogFormat::recordHeaderSize, payloadSize, receiver, updateSucceeded)) {
+			LOG(ERROR) << "SceneGraphLogReader: Malformed record of type " << type << " at offset " << offset << ".";
+			allRecordsDecoded = false;
+		}
+		if (!updateSucceeded) {
+			numberOfFailedUpdates++;
+		}
+		offset += SceneGraphLogFormat::recordHeaderSize + payloadSize;
+	}
+
+	if (numberOfFailedUpdates > 0) {
+		LOG(WARNING) << "SceneGraphLogReader: " << numberOfFailedUpdates << " of " << numberOfRecords << " updates failed.";
+	}
+	return allRecordsDecoded && (numberOfFailedUpdates == 0);
+}
+
+bool SceneGraphLogReader::restore(SceneGraphFacade* scene) {
+	assert(scene != 0);
+	return replay(scene, scene->getRootId());
+}
+
+bool SceneGraphLogReader::replayRecord(unsigned int type, const char* payload, unsigned int payloadSize, ISceneGraphUpdate* receiver, bool& updateSucceeded) {
+	PayloadDecoder decoder(payload, payloadSize);
+	vector<Attribute> attributes;
+	Id id = 0;
+	Id parentId = 0;
+
+	switch (type) {
+	case SceneGraphLogFormat::addNodeRecord:
+	case SceneGraphLogFormat::addGroupRecord: {
+		parentId = mapId(decoder.readUInt32());
+		id = decoder.readUInt32();
+		decoder.readAttributes(attributes);
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		if (type == SceneGraphLogFormat::addNodeRecord) {
+			updateSucceeded = receiver->addNode(parentId, id, attributes, true);
+		} else {
+			updateSucceeded = receiver->addGroup(parentId, id, attributes, true);
+		}
+		return true;
+	}
+	case SceneGraphLogFormat::addTransformNodeRecord: {
+		parentId = mapId(decoder.readUInt32());
+		id = decoder.readUInt32();
+		decoder.readAttributes(attributes);
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform = decoder.readTransform();
+		TimeStamp timeStamp = decoder.readTimeStamp();
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->addTransformNode(parentId, id, attributes, transform, timeStamp, true);
+		return true;
+	}
+	case SceneGraphLogFormat::addUncertainTransformNodeRecord: {
+		parentId = mapId(decoder.readUInt32());
+		id = decoder.readUInt32();
+		decoder.readAttributes(attributes);
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform = decoder.readTransform();
+		ITransformUncertainty::ITransformUncertaintyPtr uncertainty = decoder.readUncertainty();
+		TimeStamp timeStamp = decoder.readTimeStamp();
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->addUncertainTransformNode(parentId, id, attributes, transform, uncertainty, timeStamp, true);
+		return true;
+	}
+	case SceneGraphLogFormat::addGeometricNodeRecord: {
+		parentId = mapId(decoder.readUInt32());
+		id = decoder.readUInt32();
+		decoder.readAttributes(attributes);
+		Shape::ShapePtr shape = decoder.readShape();
+		TimeStamp timeStamp = decoder.readTimeStamp();
+		if (decoder.hasFailed() || (shape == 0)) {
+			return false;
+		}
+		updateSucceeded = receiver->addGeometricNode(parentId, id, attributes, shape, timeStamp, true);
+		return true;
+	}
+	case SceneGraphLogFormat::setNodeAttributesRecord: {
+		id = mapId(decoder.readUInt32());
+		decoder.readAttributes(attributes);
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->setNodeAttributes(id, attributes);
+		return true;
+	}
+	case SceneGraphLogFormat::setTransformRecord: {
+		id = decoder.readUInt32();
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform = decoder.readTransform();
+		TimeStamp timeStamp = decoder.readTimeStamp();
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->setTransform(id, transform, timeStamp);
+		return true;
+	}
+	case SceneGraphLogFormat::setUncertainTransformRecord: {
+		id = decoder.readUInt32();
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform = decoder.readTransform();
+		ITransformUncertainty::ITransformUncertaintyPtr uncertainty = decoder.readUncertainty();
+		TimeStamp timeStamp = decoder.readTimeStamp();
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->setUncertainTransform(id, transform, uncertainty, timeStamp);
+		return true;
+	}
+	case SceneGraphLogFormat::deleteNodeRecord: {
+		id = decoder.readUInt32();
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		updateSucceeded = receiver->deleteNode(id);
+		return true;
+	}
+	case SceneGraphLogFormat::addParentRecord:
+	case SceneGraphLogFormat::removeParentRecord: {
+		id = decoder.readUInt32();
+		parentId = mapId(decoder.readUInt32());
+		if (decoder.hasFailed()) {
+			return false;
+		}
+		if (type == SceneGraphLogFormat::addParentRecord) {
+			updateSucceeded = receiver->addParent(id, parentId);
+		} else {
+			updateSucceeded = receiver->removeParent(id, parentId);
+		}
+		return true;
+	}
+	default:
+		LOG(WARNING) << "SceneGraphLogReader: Skipping record of unknown type " << type << ".";
+		return true;
+	}
+}
+
+unsigned int SceneGraphLogReader::getVersion() const {
+	return version;
+}
+
+Id SceneGraphLogReader::getRootId() const {
+	return rootId;
+}
+
+unsigned long SceneGraphLogReader::getNumberOfRecords() const {
+	return numberOfRecords;
+}
+
+unsigned long SceneGraphLogReader::getFileSize() const {
+	return fileSize;
+}
+
+unsigned long SceneGraphLogReader::getValidSize() const {
+	return validSize;
+}
+
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,168 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef RSG_SCENEGRAPHLOGREADER_H
+#define RSG_SCENEGRAPHLOGREADER_H
+
+#include "ISceneGraphUpdate.h"
+#include "SceneGraphLogFormat.h"
+#include "Attribute.h"
+
+#include <string>
+#include <vector>
+
+namespace brics_3d {
+
+namespace rsg {
+
+class SceneGraphFacade;
+
+/**
+ * @brief Restores a scene graph from a binary log file (see SceneGraphLogFormat and SceneGraphLogWriter).
+ *
+ * The file is mapped into memory and the records are decoded in place, so no stream or intermediate
+ * copies are involved. Each record is replayed as the corresponding ISceneGraphUpdate call with forced IDs,
+ * so the restored nodes have the same IDs as the original ones. References to the root node of the logged
+ * graph are redirected to the root node of the receiver.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  SceneGraphFacade scene;
+ *  SceneGraphLogReader logReader;
+ *  if (logReader.open("map.rsg")) {
+ *  	logReader.restore(&scene);
+ *  }
+ *
+ * @endcode
+ *
+ * @ingroup sceneGraph
+ */
+class SceneGraphLogReader {
+  public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	SceneGraphLogReader();
+
+	/**
+	 * @brief Standard destructor. Closes the file.
+	 */
+	virtual ~SceneGraphLogReader();
+
+	/**
+	 * @brief Open (map) a log file and check its header.
+	 *
+	 * The record headers are scanned to find the end of the last complete record. An incomplete
+	 * record at the end of the file is ignored.
+	 *
+	 * @param fileName Name of the file.
+	 * @return False if the file cannot be read or is not a scene graph log of a supported version.
+	 */
+	bool open(std::string fileName);
+
+	/**
+	 * @brief Unmap the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Check whether a file is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Replay all records of the log.
+	 * @param receiver The receiver of the updates, e.g. a SceneGraphFacade.
+	 * @param receiverRootId The root ID of the receiver. Records that refer to the logged root node are redirected to it.
+	 * @return True if all records could be decoded and all updates succeeded. Failing updates are logged as warnings,
+	 * the replay continues.
+	 */
+	bool replay(ISceneGraphUpdate* receiver, Id receiverRootId);
+
+	/**
+	 * @brief Restore the logged graph into a scene graph. Same as replay(scene, scene->getRootId()).
+	 */
+	bool restore(SceneGraphFacade* scene);
+
+	/**
+	 * @brief Get the format version of the file.
+	 */
+	unsigned int getVersion() const;
+
+	/**
+	 * @brief Get the ID of the root node of the logged graph.
+	 */
+	Id getRootId() const;
+
+	/**
+	 * @brief Get the number of complete records.
+	 */
+	unsigned long getNumberOfRecords() const;
+
+	/**
+	 * @brief Get the size of the file in bytes.
+	 */
+	unsigned long getFileSize() const;
+
+	/**
+	 * @brief Get the size of the header and all complete records in bytes.
+	 */
+	unsigned long getValidSize() const;
+
+  private:
+
+	/// Decode and replay one record. Returns false if the payload is malformed.
+	bool replayRecord(unsigned int type, const char* payload, unsigned int payloadSize, ISceneGraphUpdate* receiver, bool& updateSucceeded);
+
+	/// Redirect the logged root ID to the root ID of the receiver.
+	Id mapId(Id id) const {
+		return (id == rootId) ? receiverRootId : id;
+	}
+
+	/// Begin of the mapped file.
+	const char* data;
+
+	/// Size of the file.
+	unsigned long fileSize;
+
+	/// End of the last complete record.
+	unsigned long validSize;
+
+	/// True if data is a memory mapping, false if it points to fallbackBuffer.
+	bool isMapped;
+
+	/// File contents if the file cannot be mapped.
+	std::vector<char> fallbackBuffer;
+
+	unsigned int version;
+	Id rootId;
+	Id receiverRootId;
+	unsigned long numberOfRecords;
+};
+
+}
+
+}
+
+#endif /* RSG_SCENEGRAPHLOGREADER_H */
+
+/* EOF */
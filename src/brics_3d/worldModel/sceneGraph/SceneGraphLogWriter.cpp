@@ -0,0 +1,452 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "SceneGraphLogWriter.h"
+#include "SceneGraphLogReader.h"
+#include "SceneGraphFacade.h"
+#include "SceneGraphToUpdatesTraverser.h"
+#include "Box.h"
+#include "Cylinder.h"
+#include "PointCloud.h"
+#include "Mesh.h"
+#include "brics_3d/core/ITriangleMesh.h"
+#include "brics_3d/core/TriangleMeshImplicit.h"
+#include "brics_3d/core/Logger.h"
+
+#include <cstring>
+#include <assert.h>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+namespace brics_3d {
+
+namespace rsg {
+
+const unsigned int SceneGraphLogWriter::bufferSize = 1 << 16;
+
+SceneGraphLogWriter::SceneGraphLogWriter() {
+	recordBegin = 0;
+	fileSize = 0;
+	numberOfRecords = 0;
+	rootId = 0;
+}
+
+SceneGraphLogWriter::~SceneGraphLogWriter() {
+	close();
+}
+
+bool SceneGraphLogWriter::open(std::string fileName, Id rootId, bool append) {
+	close();
+	this->rootId = rootId;
+	numberOfRecords = 0;
+	fileSize = 0;
+
+	if (append) {
+		SceneGraphLogReader existingLog;
+		std::ifstream existingFile(fileName.c_str(), std::ios::binary);
+		bool fileExists = existingFile.good() && (existingFile.peek() != std::ifstream::traits_type::eof());
+		existingFile.close();
+		if (fileExists) {
+			if (!existingLog.open(fileName)) {
+				LOG(ERROR) << "SceneGraphLogWriter: Cannot append to " << fileName << " as it is not a valid scene graph log.";
+				return false;
+			}
+			if (existingLog.getRootId() != rootId) {
+				LOG(ERROR) << "SceneGraphLogWriter: Cannot append to " << fileName << " as it has been written for root ID " << existingLog.getRootId() << ".";
+				return false;
+			}
+			fileSize = existingLog.getValidSize();
+			if (fileSize < existingLog.getFileSize()) {
+				LOG(WARNING) << "SceneGraphLogWriter: Removing an incomplete record at the end of " << fileName << ".";
+#ifndef WIN32
+				if (truncate(fileName.c_str(), fileSize) != 0) {
+					LOG(ERROR) << "SceneGraphLogWriter: Cannot truncate " << fileName << ".";
+					return false;
+				}
+#endif
+			}
+			existingLog.close();
+			file.open(fileName.c_str(), std::ios::binary | std::ios::out | std::ios::app);
+			if (!file.is_open()) {
+				LOG(ERROR) << "SceneGraphLogWriter: Cannot open " << fileName << " for writing.";
+				return false;
+			}
+			return true;
+		}
+	}
+
+	file.open(fileName.c_str(), std::ios::binary | std::ios::out | std::ios::trunc);
+	if (!file.is_open()) {
+		LOG(ERROR) << "SceneGraphLogWriter: Cannot open " << fileName << " for writing.";
+		return false;
+	}
+	writeUInt32(SceneGraphLogFormat::magic);
+	writeUInt32(SceneGraphLogFormat::version);
+	writeUInt32(rootId);
+	writeUInt32(0u);
+	return flush();
+}
+
+void SceneGraphLogWriter::close() {
+	if (file.is_open()) {
+		flush();
+		file.close();
+	}
+	buffer.clear();
+}
+
+bool SceneGraphLogWriter::isOpen() const {
+	return file.is_open();
+}
+
+bool SceneGraphLogWriter::flush() {
+	if (!file.is_open()) {
+		return false;
+	}
+	if (buffer.size() > 0) {
+		file.write(&buffer[0], buffer.size());
+		fileSize += buffer.size();
+		buffer.clear();
+	}
+	file.flush();
+	if (!file.good()) {
+		LOG(ERROR) << "SceneGraphLogWriter: Writing to the log file failed.";
+		return false;
+	}
+	return true;
+}
+
+bool SceneGraphLogWriter::writeSnapshot(SceneGraphFacade* scene) {
+	assert(scene != 0);
+	if (!file.is_open()) {
+		LOG(ERROR) << "SceneGraphLogWriter: Cannot write a snapshot as no file is open.";
+		return false;
+	}
+	if (scene->getRootId() != rootId) {
+		LOG(ERROR) << "SceneGraphLogWriter: The root ID " << scene->getRootId() << " of the scene does not match the one of the log file.";
+		return false;
+	}
+
+	unsigned long recordsBefore = numberOfRecords;
+	vector<Attribute> rootAttributes;
+	scene->getNodeAttributes(rootId, rootAttributes);
+	if (rootAttributes.size() > 0) {
+		setNodeAttributes(rootId, rootAttributes);
+	}
+
+	SceneGraphToUpdatesTraverser traverser(this);
+	traverser.setEnableTransformHistory(true);
+	scene->executeGraphTraverser(&traverser, rootId);
+
+	LOG(DEBUG) << "SceneGraphLogWriter: Snapshot with " << numberOfRecords - recordsBefore << " records written.";
+	return flush();
+}
+
+unsigned long SceneGraphLogWriter::getNumberOfRecords() const {
+	return numberOfRecords;
+}
+
+unsigned long SceneGraphLogWriter::getSize() const {
+	return fileSize + buffer.size();
+}
+
+bool SceneGraphLogWriter::addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool /*forcedId*/) {
+	if (!beginRecord(SceneGraphLogFormat::addNodeRecord)) {
+		return false;
+	}
+	writeUInt32(parentId);
+	writeUInt32(assignedId);
+	writeAttributes(attributes);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool /*forcedId*/) {
+	if (!beginRecord(SceneGraphLogFormat::addGroupRecord)) {
+		return false;
+	}
+	writeUInt32(parentId);
+	writeUInt32(assignedId);
+	writeAttributes(attributes);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool /*forcedId*/) {
+	if (!beginRecord(SceneGraphLogFormat::addTransformNodeRecord)) {
+		return false;
+	}
+	writeUInt32(parentId);
+	writeUInt32(assignedId);
+	writeAttributes(attributes);
+	writeTransform(transform);
+	writeTimeStamp(timeStamp);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool /*forcedId*/) {
+	if (!beginRecord(SceneGraphLogFormat::addUncertainTransformNodeRecord)) {
+		return false;
+	}
+	writeUInt32(parentId);
+	writeUInt32(assignedId);
+	writeAttributes(attributes);
+	writeTransform(transform);
+	writeUncertainty(uncertainty);
+	writeTimeStamp(timeStamp);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool /*forcedId*/) {
+	if (!beginRecord(SceneGraphLogFormat::addGeometricNodeRecord)) {
+		return false;
+	}
+	writeUInt32(parentId);
+	writeUInt32(assignedId);
+	writeAttributes(attributes);
+	if (!writeShape(shape)) {
+		LOG(WARNING) << "SceneGraphLogWriter: The shape of geometric node " << assignedId << " is not supported. The node is not logged.";
+		abortRecord();
+		return false;
+	}
+	writeTimeStamp(timeStamp);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::setNodeAttributes(Id id, vector<Attribute> newAttributes) {
+	if (!beginRecord(SceneGraphLogFormat::setNodeAttributesRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	writeAttributes(newAttributes);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) {
+	if (!beginRecord(SceneGraphLogFormat::setTransformRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	writeTransform(transform);
+	writeTimeStamp(timeStamp);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) {
+	if (!beginRecord(SceneGraphLogFormat::setUncertainTransformRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	writeTransform(transform);
+	writeUncertainty(uncertainty);
+	writeTimeStamp(timeStamp);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::deleteNode(Id id) {
+	if (!beginRecord(SceneGraphLogFormat::deleteNodeRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::addParent(Id id, Id parentId) {
+	if (!beginRecord(SceneGraphLogFormat::addParentRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	writeUInt32(parentId);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::removeParent(Id id, Id parentId) {
+	if (!beginRecord(SceneGraphLogFormat::removeParentRecord)) {
+		return false;
+	}
+	writeUInt32(id);
+	writeUInt32(parentId);
+	endRecord();
+	return true;
+}
+
+bool SceneGraphLogWriter::beginRecord(SceneGraphLogFormat::RecordType type) {
+	if (!file.is_open()) {
+		return false;
+	}
+	recordBegin = buffer.size();
+	writeUInt32(type);
+	writeUInt32(0u); // payload size, filled in by endRecord()
+	return true;
+}
+
+void SceneGraphLogWriter::endRecord() {
+	unsigned int payloadSize = static_cast<unsigned int>(buffer.size() - recordBegin - SceneGraphLogFormat::recordHeaderSize);
+	memcpy(&buffer[recordBegin + 4], &payloadSize, 4);
+	numberOfRecords++;
+	if (buffer.size() >= bufferSize) {
+		flush();
+	}
+}
+
+void SceneGraphLogWriter::abortRecord() {
+	buffer.resize(recordBegin);
+}
+
+void SceneGraphLogWriter::writeUInt32(unsigned int value) {
+	size_t offset = buffer.size();
+	buffer.resize(offset + 4);
+	memcpy(&buffer[offset], &value, 4);
+}
+
+void SceneGraphLogWriter::writeDouble(double value) {
+	writeDoubles(&value, 1);
+}
+
+void SceneGraphLogWriter::writeDoubles(const double* values, unsigned int count) {
+	if (count == 0) {
+		return;
+	}
+	size_t offset = buffer.size();
+	buffer.resize(offset + count * sizeof(double));
+	memcpy(&buffer[offset], values, count * sizeof(double));
+}
+
+void SceneGraphLogWriter::writeString(const std::string& value) {
+	writeUInt32(static_cast<unsigned int>(value.size()));
+	buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+void SceneGraphLogWriter::writeAttributes(const vector<Attribute>& attributes) {
+	writeUInt32(static_cast<unsigned int>(attributes.size()));
+	for (unsigned int i = 0; i < attributes.size(); ++i) {
+		writeString(attributes[i].key);
+		writeString(attributes[i].value);
+	}
+}
+
+void SceneGraphLogWriter::writeTransform(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform) {
+	if (transform == 0) {
+		const double identity[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+		writeDoubles(identity, 16);
+		return;
+	}
+	writeDoubles(transform->getRawData(), 16);
+}
+
+void SceneGraphLogWriter::writeUncertainty(ITransformUncertainty::ITransformUncertaintyPtr uncertainty) {
+	if (uncertainty == 0) {
+		writeUInt32(0u);
+		writeUInt32(0u);
+		return;
+	}
+	unsigned int rows = uncertainty->getRowDimension();
+	unsigned int columns = uncertainty->getColumnDimension();
+	writeUInt32(rows);
+	writeUInt32(columns);
+	writeDoubles(uncertainty->getRawData(), rows * columns);
+}
+
+void SceneGraphLogWriter::writeTimeStamp(TimeStamp timeStamp) {
+	writeDouble(timeStamp.getSeconds());
+}
+
+bool SceneGraphLogWriter::writeShape(Shape::ShapePtr shape) {
+	if (shape == 0) {
+		return false;
+	}
+
+	Box::BoxPtr box = boost::dynamic_pointer_cast<Box>(shape);
+	if (box != 0) {
+		writeUInt32(SceneGraphLogFormat::box);
+		writeDouble(box->getSizeX());
+		writeDouble(box->getSizeY());
+		writeDouble(box->getSizeZ());
+		return true;
+	}
+
+	Cylinder::CylinderPtr cylinder = boost::dynamic_pointer_cast<Cylinder>(shape);
+	if (cylinder != 0) {
+		writeUInt32(SceneGraphLogFormat::cylinder);
+		writeDouble(cylinder->getRadius());
+		writeDouble(cylinder->getHeight());
+		return true;
+	}
+
+	PointCloud<PointCloud3D>::PointCloudPtr pointCloud = boost::dynamic_pointer_cast<PointCloud<PointCloud3D> >(shape);
+	if ((pointCloud != 0) && (pointCloud->data != 0)) {
+		PointCloud3D::PackedCoordinatesConstPtr coordinates = pointCloud->data->getPackedCoordinates();
+		unsigned int numberOfPoints = static_cast<unsigned int>(coordinates->size() / 3);
+		writeUInt32(SceneGraphLogFormat::pointCloud3D);
+		writeUInt32(numberOfPoints);
+		if (numberOfPoints > 0) {
+			writeDoubles(&(*coordinates)[0], 3 * numberOfPoints);
+		}
+		return true;
+	}
+
+	Mesh<ITriangleMesh>::MeshPtr mesh = boost::dynamic_pointer_cast<Mesh<ITriangleMesh> >(shape);
+	if ((mesh != 0) && (mesh->data != 0)) {
+		TriangleMeshImplicit* indexedMesh = dynamic_cast<TriangleMeshImplicit*>(mesh->data.get());
+		if (indexedMesh != 0) {
+			std::vector<Point3D>* vertices = indexedMesh->getVertices();
+			std::vector<int>* indices = indexedMesh->getIndices();
+			writeUInt32(SceneGraphLogFormat::indexedTriangleMesh);
+			writeUInt32(static_cast<unsigned int>(vertices->size()));
+			for (unsigned int i = 0; i < vertices->size(); ++i) {
+				double vertex[3] = {(*vertices)[i].getX(), (*vertices)[i].getY(), (*vertices)[i].getZ()};
+				writeDoubles(vertex, 3);
+			}
+			writeUInt32(static_cast<unsigned int>(indices->size()));
+			for (unsigned int i = 0; i < indices->size(); ++i) {
+				writeUInt32(static_cast<unsigned int>((*indices)[i]));
+			}
+			return true;
+		}
+
+		int numberOfTriangles = mesh->data->getSize();
+		writeUInt32(SceneGraphLogFormat::triangleMesh);
+		writeUInt32(static_cast<unsigned int>(numberOfTriangles));
+		for (int triangle = 0; triangle < numberOfTriangles; ++triangle) {
+			for (int vertexIndex = 0; vertexIndex < 3; ++vertexIndex) {
+				Point3D* vertex = mesh->data->getTriangleVertex(triangle, vertexIndex);
+				double coordinates[3] = {vertex->getX(), vertex->getY(), vertex->getZ()};
+				writeDoubles(coordinates, 3);
+			}
+		}
+		return true;
+	}
+
+	return false;
+}
+
+}
+
+}
+
+/* EOF */
@@ -0,0 +1,186 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef RSG_SCENEGRAPHLOGWRITER_H
+#define RSG_SCENEGRAPHLOGWRITER_H
+
+#include "ISceneGraphUpdateObserver.h"
+#include "SceneGraphLogFormat.h"
+#include "Attribute.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace brics_3d {
+
+namespace rsg {
+
+class SceneGraphFacade;
+
+/**
+ * @brief Writes scene graph updates to a binary log file (see SceneGraphLogFormat).
+ *
+ * The writer supports a full snapshot of a scene graph as well as an append-only delta log:
+ *  - writeSnapshot() stores the nodes, attributes, complete transform histories and geometries of a graph.
+ *  - As an observer of a SceneGraphFacade every update is appended as one record.
+ *
+ * Both can be combined, e.g. a snapshot at startup followed by the deltas. A log is restored with a
+ * SceneGraphLogReader. Records are buffered in memory, call flush() to write them to the file.
+ *
+ * Geometric nodes are stored if the shape is a Box, a Cylinder, a PointCloud<PointCloud3D> or a
+ * Mesh<ITriangleMesh>. Other shapes are not logged (the update function returns false).
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  SceneGraphLogWriter logWriter;
+ *  logWriter.open("map.rsg", scene.getRootId());
+ *  logWriter.writeSnapshot(&scene);
+ *  scene.attachUpdateObserver(&logWriter); // append all further updates
+ *
+ * @endcode
+ *
+ * @ingroup sceneGraph
+ */
+class SceneGraphLogWriter : public ISceneGraphUpdateObserver {
+  public:
+
+	/**
+	 * @brief Standard constructor.
+	 */
+	SceneGraphLogWriter();
+
+	/**
+	 * @brief Standard destructor. Flushes and closes the file.
+	 */
+	virtual ~SceneGraphLogWriter();
+
+	/**
+	 * @brief Open a log file.
+	 * @param fileName Name of the file.
+	 * @param rootId ID of the root node of the logged graph.
+	 * @param append If true and the file exists, new records are appended. The file has to be a log with the
+	 * same format version and root ID. An incomplete record at its end is removed.
+	 * Otherwise the file is overwritten.
+	 * @return True if the file could be opened.
+	 */
+	bool open(std::string fileName, Id rootId, bool append = false);
+
+	/**
+	 * @brief Flush and close the file.
+	 */
+	void close();
+
+	/**
+	 * @brief Check whether a file is open.
+	 */
+	bool isOpen() const;
+
+	/**
+	 * @brief Write the buffered records to the file.
+	 * @return False if writing failed.
+	 */
+	bool flush();
+
+	/**
+	 * @brief Append a full snapshot of a scene graph.
+	 *
+	 * All nodes below the root are written with their attributes, transform histories and shapes. Nodes
+	 * with more than one parent are written once, followed by addParent() records.
+	 *
+	 * @param scene The scene graph. Its root ID has to match the one that the file has been opened with.
+	 * @return True if the snapshot has been written. False if the file is not open or a shape could not be stored.
+	 */
+	bool writeSnapshot(SceneGraphFacade* scene);
+
+	/**
+	 * @brief Get the number of records that have been written since the file has been opened.
+	 */
+	unsigned long getNumberOfRecords() const;
+
+	/**
+	 * @brief Get the size of the file including the buffered records in bytes.
+	 */
+	unsigned long getSize() const;
+
+	/* implementations of observer interface */
+	bool addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false);
+	bool addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false);
+	bool addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId = false);
+	bool addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId = false);
+	bool addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId = false);
+	bool setNodeAttributes(Id id, vector<Attribute> newAttributes);
+	bool setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp);
+	bool setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp);
+	bool deleteNode(Id id);
+	bool addParent(Id id, Id parentId);
+	bool removeParent(Id id, Id parentId);
+
+	/// Size of the record buffer in bytes that triggers an automatic flush().
+	static const unsigned int bufferSize;
+
+  private:
+
+	/// Start a new record in the buffer. Returns false if no file is open.
+	bool beginRecord(SceneGraphLogFormat::RecordType type);
+
+	/// Complete the current record: fill in its payload size.
+	void endRecord();
+
+	/// Discard the current record, e.g. if a shape cannot be stored.
+	void abortRecord();
+
+	void writeUInt32(unsigned int value);
+	void writeDouble(double value);
+	void writeDoubles(const double* values, unsigned int count);
+	void writeString(const std::string& value);
+	void writeAttributes(const vector<Attribute>& attributes);
+	void writeTransform(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform);
+	void writeUncertainty(ITransformUncertainty::ITransformUncertaintyPtr uncertainty);
+	void writeTimeStamp(TimeStamp timeStamp);
+	bool writeShape(Shape::ShapePtr shape);
+
+	/// The log file.
+	std::ofstream file;
+
+	/// Records that have not been written to the file yet.
+	std::vector<char> buffer;
+
+	/// Offset of the current record in the buffer.
+	size_t recordBegin;
+
+	/// Bytes that have been written to the file.
+	unsigned long fileSize;
+
+	/// Number of written records.
+	unsigned long numberOfRecords;
+
+	/// Root ID of the logged graph.
+	Id rootId;
+};
+
+}
+
+}
+
+#endif /* RSG_SCENEGRAPHLOGWRITER_H */
+
+/* EOF */
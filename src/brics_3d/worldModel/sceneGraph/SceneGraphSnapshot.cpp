@@ -0,0 +1,430 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#include "SceneGraphSnapshot.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/Logger.h"
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+
+namespace brics_3d {
+
+namespace rsg {
+
+const unsigned int SceneGraphSnapshot::numberOfShards = 64;
+
+/// Compare two attribute lists element wise.
+static bool areEqual(const vector<Attribute>& attributes, const vector<Attribute>& otherAttributes) {
+	if (attributes.size() != otherAttributes.size()) {
+		return false;
+	}
+	for (unsigned int i = 0; i < static_cast<unsigned int>(attributes.size()); ++i) {
+		if ((attributes[i].key != otherAttributes[i].key) || (attributes[i].value != otherAttributes[i].value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+SceneGraphSnapshot::SceneGraphSnapshot(Id rootId) {
+	this->version = 0;
+	this->rootId = rootId;
+	this->numberOfNodes = 0;
+	nodeShards = boost::shared_ptr<NodeTable>(new NodeTable());
+	attributeShards = boost::shared_ptr<AttributeTable>(new AttributeTable());
+	for (unsigned int i = 0; i < numberOfShards; ++i) {
+		nodeShards->push_back(boost::shared_ptr<NodeShard>(new NodeShard()));
+		attributeShards->push_back(boost::shared_ptr<AttributeShard>(new AttributeShard()));
+	}
+
+	NodeRecord* rootRecord = new NodeRecord();
+	rootRecord->id = rootId;
+	rootRecord->type = group;
+	setNodeRecord(NodeRecord::NodeRecordConstPtr(rootRecord));
+}
+
+SceneGraphSnapshot::~SceneGraphSnapshot() {
+
+}
+
+unsigned int SceneGraphSnapshot::getVersion() const {
+	return version;
+}
+
+Id SceneGraphSnapshot::getRootId() const {
+	return rootId;
+}
+
+unsigned int SceneGraphSnapshot::getNumberOfNodes() const {
+	return numberOfNodes;
+}
+
+SceneGraphSnapshot::NodeRecord::NodeRecordConstPtr SceneGraphSnapshot::getNodeRecord(Id id) const {
+	const NodeShard& shard = *(*nodeShards)[id % numberOfShards];
+	NodeShard::const_iterator recordIterator = shard.find(id);
+	if (recordIterator == shard.end()) {
+		return NodeRecord::NodeRecordConstPtr();
+	}
+	return recordIterator->second;
+}
+
+bool SceneGraphSnapshot::getNodes(vector<Attribute> attributes, vector<Id>& ids) {
+	ids.clear();
+	if (attributes.empty()) {
+		return true;
+	}
+
+	/* collect the ID sets of all query attributes */
+	vector<const IdSet*> idSets;
+	unsigned int smallestIdSet = 0;
+	for (unsigned int i = 0; i < static_cast<unsigned int>(attributes.size()); ++i) {
+		AttributeKey key(attributes[i].key, attributes[i].value);
+		const AttributeShard& shard = *(*attributeShards)[boost::hash_value(key) % numberOfShards];
+		AttributeShard::const_iterator indexIterator = shard.find(key);
+		if (indexIterator == shard.end()) {
+			return true; // no node has this attribute
+		}
+		idSets.push_back(indexIterator->second.get());
+		if (indexIterator->second->size() < idSets[smallestIdSet]->size()) {
+			smallestIdSet = i;
+		}
+	}
+
+	/* intersect (logical AND) starting with the smallest set */
+	for (IdSet::const_iterator idIterator = idSets[smallestIdSet]->begin(); idIterator != idSets[smallestIdSet]->end(); ++idIterator) {
+		bool isInAllSets = true;
+		for (unsigned int i = 0; i < static_cast<unsigned int>(idSets.size()); ++i) {
+			if ((i != smallestIdSet) && (idSets[i]->find(*idIterator) == idSets[i]->end())) {
+				isInAllSets = false;
+				break;
+			}
+		}
+		if (isInAllSets) {
+			ids.push_back(*idIterator);
+		}
+	}
+
+	std::sort(ids.begin(), ids.end());
+	return true;
+}
+
+bool SceneGraphSnapshot::getNodeAttributes(Id id, vector<Attribute>& attributes) {
+	attributes.clear();
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if (record == 0) {
+		return false;
+	}
+	attributes = record->attributes;
+	return true;
+}
+
+bool SceneGraphSnapshot::getNodeParents(Id id, vector<Id>& parentIds) {
+	parentIds.clear();
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if (record == 0) {
+		return false;
+	}
+	parentIds = record->parentIds;
+	return true;
+}
+
+bool SceneGraphSnapshot::getGroupChildren(Id id, vector<Id>& childIds) {
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if ((record == 0) || (record->type == node) || (record->type == geometricNode)) {
+		LOG(ERROR) << "Node with ID " << id << " is not a group. Cannot return child IDs";
+		return false;
+	}
+	childIds.insert(childIds.end(), record->childIds.begin(), record->childIds.end());
+	return true;
+}
+
+bool SceneGraphSnapshot::getTransform(Id id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform) {
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if ((record == 0) || ((record->type != SceneGraphSnapshot::transform) && (record->type != uncertainTransform))) {
+		LOG(ERROR) << "Node with ID " << id << " is not a transform. Cannot return transform data.";
+		return false;
+	}
+	HistoryEntry::HistoryEntryConstPtr entry = findClosestEntry(record->history, timeStamp, record->maxHistoryDuration);
+	if (entry == 0) {
+		transform = IHomogeneousMatrix44::IHomogeneousMatrix44Ptr();
+		return true;
+	}
+	transform = IHomogeneousMatrix44::IHomogeneousMatrix44Ptr(new HomogeneousMatrix44());
+	*transform = *entry->transform; // a copy, as the caller might modify it
+	return true;
+}
+
+bool SceneGraphSnapshot::getUncertainTransform(Id id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform, ITransformUncertainty::ITransformUncertaintyPtr &uncertainty) {
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if ((record == 0) || (record->type != uncertainTransform)) {
+		LOG(ERROR) << "Node with ID " << id << " is not an uncertain transform. Cannot return transform data.";
+		return false;
+	}
+	HistoryEntry::HistoryEntryConstPtr entry = findClosestEntry(record->history, timeStamp, record->maxHistoryDuration);
+	if (entry == 0) {
+		transform = IHomogeneousMatrix44::IHomogeneousMatrix44Ptr();
+		uncertainty = ITransformUncertainty::ITransformUncertaintyPtr();
+		return true;
+	}
+	transform = IHomogeneousMatrix44::IHomogeneousMatrix44Ptr(new HomogeneousMatrix44());
+	*transform = *entry->transform;
+	uncertainty = entry->uncertainty;
+	return true;
+}
+
+bool SceneGraphSnapshot::getGeometry(Id id, Shape::ShapePtr& shape, TimeStamp& timeStamp) {
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if ((record == 0) || (record->type != geometricNode)) {
+		LOG(ERROR) << "Node with ID " << id << " is not a geometric node. Cannot return shape data.";
+		return false;
+	}
+	shape = record->shape;
+	timeStamp = record->shapeTimeStamp;
+	return true;
+}
+
+bool SceneGraphSnapshot::getTransformForNode(Id id, Id idReferenceNode, TimeStamp /*timeStamp*/, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform) {
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr rootToNodeTransform(new HomogeneousMatrix44());
+	if (!getGlobalTransform(id, rootToNodeTransform.get())) {
+		return false;
+	}
+	if (idReferenceNode == rootId) { // the common case
+		transform = rootToNodeTransform;
+		return true;
+	}
+
+	HomogeneousMatrix44 rootToReferenceNodeTransform;
+	if (!getGlobalTransform(idReferenceNode, &rootToReferenceNodeTransform)) {
+		return false;
+	}
+	rootToReferenceNodeTransform.inverse();
+	rootToReferenceNodeTransform * (*rootToNodeTransform); // in place
+	*rootToNodeTransform = rootToReferenceNodeTransform; //cf. Craig p39
+	transform = rootToNodeTransform;
+	return true;
+}
+
+SceneGraphSnapshot::HistoryEntry::HistoryEntryConstPtr SceneGraphSnapshot::insertIntoHistory(HistoryEntry::HistoryEntryConstPtr history,
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty,
+		TimeStamp timeStamp, TimeStamp maxHistoryDuration) {
+
+	/* newer entries have to be copied, as the list is shared */
+	vector<HistoryEntry::HistoryEntryConstPtr> newerEntries;
+	HistoryEntry::HistoryEntryConstPtr older = history;
+	while ((older != 0) && (older->timeStamp > timeStamp)) {
+		newerEntries.push_back(older);
+		older = older->older;
+	}
+
+	HistoryEntry* newEntry = new HistoryEntry();
+	newEntry->transform = transform;
+	newEntry->uncertainty = uncertainty;
+	if ((uncertainty == 0) && (older != 0)) {
+		newEntry->uncertainty = older->uncertainty;
+	}
+	newEntry->timeStamp = timeStamp;
+	newEntry->older = older;
+	newEntry->length = (older != 0) ? older->length + 1 : 1;
+	newEntry->lengthAfterTrim = (older != 0) ? older->lengthAfterTrim : 1;
+	HistoryEntry::HistoryEntryConstPtr result(newEntry);
+
+	for (vector<HistoryEntry::HistoryEntryConstPtr>::reverse_iterator newer = newerEntries.rbegin(); newer != newerEntries.rend(); ++newer) {
+		HistoryEntry* copy = new HistoryEntry(**newer);
+		copy->older = result;
+		copy->length = result->length + 1;
+		copy->lengthAfterTrim = result->lengthAfterTrim;
+		result = HistoryEntry::HistoryEntryConstPtr(copy);
+	}
+
+	if (result->length < 2 * result->lengthAfterTrim) {
+		return result;
+	}
+
+	/* remove the outdated entries: copy the valid ones */
+	vector<HistoryEntry::HistoryEntryConstPtr> validEntries;
+	TimeStamp latestTimeStamp = result->timeStamp;
+	for (HistoryEntry::HistoryEntryConstPtr entry = result; entry != 0; entry = entry->older) {
+		if (entry->timeStamp + maxHistoryDuration < latestTimeStamp) {
+			break;
+		}
+		validEntries.push_back(entry);
+	}
+	if (validEntries.size() == result->length) { // nothing to remove
+		HistoryEntry* head = new HistoryEntry(*result);
+		head->lengthAfterTrim = result->length;
+		return HistoryEntry::HistoryEntryConstPtr(head);
+	}
+
+	result = HistoryEntry::HistoryEntryConstPtr();
+	unsigned int length = static_cast<unsigned int>(validEntries.size());
+	for (vector<HistoryEntry::HistoryEntryConstPtr>::reverse_iterator valid = validEntries.rbegin(); valid != validEntries.rend(); ++valid) {
+		HistoryEntry* copy = new HistoryEntry(**valid);
+		copy->older = result;
+		copy->length = (result != 0) ? result->length + 1 : 1;
+		copy->lengthAfterTrim = length;
+		result = HistoryEntry::HistoryEntryConstPtr(copy);
+	}
+	return result;
+}
+
+SceneGraphSnapshot::HistoryEntry::HistoryEntryConstPtr SceneGraphSnapshot::findClosestEntry(HistoryEntry::HistoryEntryConstPtr history,
+		TimeStamp timeStamp, TimeStamp maxHistoryDuration) {
+	if (history == 0) {
+		return history;
+	}
+
+	/* first entry that is not newer than the time stamp; remember: entries have a descending order */
+	TimeStamp latestTimeStamp = history->timeStamp;
+	HistoryEntry::HistoryEntryConstPtr newer;
+	HistoryEntry::HistoryEntryConstPtr entry = history;
+	while (entry->timeStamp > timeStamp) {
+		if ((entry->older == 0) || (entry->older->timeStamp + maxHistoryDuration < latestTimeStamp)) {
+			return entry; // older than the oldest (valid) entry
+		}
+		newer = entry;
+		entry = entry->older;
+	}
+	if (newer == 0) {
+		return entry;
+	}
+
+	/* a newer entry exists => compare which is actually the closest */
+	if ((newer->timeStamp - timeStamp) <= (timeStamp - entry->timeStamp)) {
+		return newer;
+	}
+	return entry;
+}
+
+void SceneGraphSnapshot::setNodeRecord(NodeRecord::NodeRecordConstPtr record) {
+	assert(record != 0);
+	NodeShard& shard = getWritableNodeShard(record->id);
+	NodeShard::iterator recordIterator = shard.find(record->id);
+	if (recordIterator == shard.end()) {
+		updateAttributeIndex(record->id, 0, &record->attributes);
+		shard.insert(std::make_pair(record->id, record));
+		numberOfNodes++;
+	} else {
+		if (!areEqual(recordIterator->second->attributes, record->attributes)) {
+			updateAttributeIndex(record->id, &recordIterator->second->attributes, &record->attributes);
+		}
+		recordIterator->second = record;
+	}
+}
+
+void SceneGraphSnapshot::removeNodeRecord(Id id) {
+	NodeShard& shard = getWritableNodeShard(id);
+	NodeShard::iterator recordIterator = shard.find(id);
+	if (recordIterator != shard.end()) {
+		updateAttributeIndex(id, &recordIterator->second->attributes, 0);
+		shard.erase(recordIterator);
+		numberOfNodes--;
+	}
+}
+
+SceneGraphSnapshot::NodeShard& SceneGraphSnapshot::getWritableNodeShard(Id id) {
+	if (!nodeShards.unique()) { // shared with another version
+		nodeShards = boost::shared_ptr<NodeTable>(new NodeTable(*nodeShards));
+	}
+	boost::shared_ptr<NodeShard>& shard = (*nodeShards)[id % numberOfShards];
+	if (!shard.unique()) {
+		shard = boost::shared_ptr<NodeShard>(new NodeShard(*shard));
+	}
+	return *shard;
+}
+
+SceneGraphSnapshot::AttributeShard& SceneGraphSnapshot::getWritableAttributeShard(const AttributeKey& key) {
+	if (!attributeShards.unique()) {
+		attributeShards = boost::shared_ptr<AttributeTable>(new AttributeTable(*attributeShards));
+	}
+	boost::shared_ptr<AttributeShard>& shard = (*attributeShards)[boost::hash_value(key) % numberOfShards];
+	if (!shard.unique()) {
+		shard = boost::shared_ptr<AttributeShard>(new AttributeShard(*shard));
+	}
+	return *shard;
+}
+
+void SceneGraphSnapshot::updateAttributeIndex(Id id, const vector<Attribute>* oldAttributes, const vector<Attribute>* newAttributes) {
+	for (int pass = 0; pass < 2; ++pass) {
+		const vector<Attribute>* attributes = (pass == 0) ? oldAttributes : newAttributes;
+		if (attributes == 0) {
+			continue;
+		}
+		for (unsigned int i = 0; i < static_cast<unsigned int>(attributes->size()); ++i) {
+			AttributeKey key((*attributes)[i].key, (*attributes)[i].value);
+			AttributeShard& shard = getWritableAttributeShard(key);
+			boost::shared_ptr<IdSet>& idSet = shard[key];
+			if (idSet == 0) {
+				idSet = boost::shared_ptr<IdSet>(new IdSet());
+			} else if (!idSet.unique()) {
+				idSet = boost::shared_ptr<IdSet>(new IdSet(*idSet));
+			}
+			if (pass == 0) {
+				idSet->erase(id);
+				if (idSet->empty()) {
+					shard.erase(key);
+				}
+			} else {
+				idSet->insert(id);
+			}
+		}
+	}
+}
+
+bool SceneGraphSnapshot::getGlobalTransform(Id id, IHomogeneousMatrix44* result) const {
+	NodeRecord::NodeRecordConstPtr record = getNodeRecord(id);
+	if (record == 0) {
+		return false;
+	}
+
+	/*
+	 * The affine part is accumulated with plain arithmetic on the column-major
+	 * raw data, as this is the hot path of concurrent queries.
+	 */
+	double accumulated[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+	double product[16];
+	unsigned int depth = 0;
+	while (record != 0) {
+		if (((record->type == SceneGraphSnapshot::transform) || (record->type == uncertainTransform)) && (record->history != 0)) {
+			const double* transform = record->history->transform->getRawData(); // multiplied from the left
+			for (int column = 0; column < 4; ++column) {
+				for (int row = 0; row < 3; ++row) {
+					product[column * 4 + row] = transform[row] * accumulated[column * 4] +
+							transform[4 + row] * accumulated[column * 4 + 1] +
+							transform[8 + row] * accumulated[column * 4 + 2] +
+							((column == 3) ? transform[12 + row] : 0.0);
+				}
+				product[column * 4 + 3] = (column == 3) ? 1.0 : 0.0;
+			}
+			std::copy(product, product + 16, accumulated);
+		}
+		if (record->parentIds.empty() || (++depth > numberOfNodes)) { // the depth limit protects against cycles
+			break;
+		}
+		record = getNodeRecord(record->parentIds[0]);
+	}
+	std::copy(accumulated, accumulated + 16, result->setRawData());
+	return true;
+}
+
+} // namespace brics_3d::rsg
+
+} // namespace brics_3d
+
+/* EOF */
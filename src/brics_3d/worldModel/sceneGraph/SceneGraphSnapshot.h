@@ -0,0 +1,307 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+
+#ifndef RSG_SCENEGRAPHSNAPSHOT_H
+#define RSG_SCENEGRAPHSNAPSHOT_H
+
+#include "ISceneGraphQuery.h"
+#include "Attribute.h"
+#include "Id.h"
+
+#include <vector>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+namespace brics_3d {
+
+namespace rsg {
+
+class SceneGraphFacade;
+
+/**
+ * @brief An immutable version of the scene graph that can be queried concurrently.
+ *
+ * A snapshot is created and published by the SceneGraphFacade in its snapshot concurrency mode
+ * (see SceneGraphFacade::setConcurrencyMode()). Once published it will never change again, so any
+ * number of threads can run queries on it without locks - even while a writer publishes newer versions.
+ * A snapshot stays valid as long as a reference to it is held.
+ *
+ * The snapshot does not contain the nodes of the scene graph but immutable records of them (ID, type,
+ * attributes, parent and child IDs, transform history or geometry). Consecutive versions share
+ * everything that has not been changed:
+ *  - The records and the attribute index are split into shards. A new version copies the shard of
+ *    a changed record only (copy-on-write); all other shards are shared with the previous version.
+ *  - The transform history is a persistent list (newest first). An update prepends one entry and
+ *    shares the older ones.
+ *
+ * Returned transforms are copies. Shapes and uncertainties are shared with the scene graph and
+ * must not be modified.
+ *
+ * @ingroup sceneGraph
+ */
+class SceneGraphSnapshot : public ISceneGraphQuery {
+
+	friend class SceneGraphFacade;
+
+  public:
+
+	typedef boost::shared_ptr<SceneGraphSnapshot> SceneGraphSnapshotPtr;
+	typedef boost::shared_ptr<SceneGraphSnapshot const> SceneGraphSnapshotConstPtr;
+
+	/**
+	 * @brief The type of a node.
+	 */
+	enum NodeType {
+		node,
+		group,
+		transform,
+		uncertainTransform,
+		geometricNode
+	};
+
+	/**
+	 * @brief An entry of the transform history of a record.
+	 *
+	 * The entries form a singly linked list in descending temporal order that is shared among the versions.
+	 */
+	class HistoryEntry {
+	  public:
+		typedef boost::shared_ptr<HistoryEntry const> HistoryEntryConstPtr;
+
+		HistoryEntry() : length(1), lengthAfterTrim(1) {};
+
+		/// Releases the older entries iteratively, as a recursive destruction of a long list might exhaust the stack.
+		~HistoryEntry() {
+			HistoryEntryConstPtr entry = older;
+			older.reset();
+			while ((entry != 0) && entry.unique()) {
+				HistoryEntryConstPtr next = entry->older;
+				entry = next;
+			}
+		};
+
+		/// The transform.
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+
+		/// The uncertainty of the transform. Only set for uncertain transforms.
+		ITransformUncertainty::ITransformUncertaintyPtr uncertainty;
+
+		/// The time stamp of the transform.
+		TimeStamp timeStamp;
+
+		/// The next older entry. Null for the oldest one.
+		HistoryEntryConstPtr older;
+
+		/// Number of entries of the list that starts with this one.
+		unsigned int length;
+
+		/// Length of the list when outdated entries had been removed the last time.
+		unsigned int lengthAfterTrim;
+	};
+
+	/**
+	 * @brief The state of a node at the version of the snapshot.
+	 */
+	class NodeRecord {
+	  public:
+		typedef boost::shared_ptr<NodeRecord const> NodeRecordConstPtr;
+
+		NodeRecord() : id(0), type(node) {};
+
+		/// ID of the node.
+		Id id;
+
+		/// Type of the node.
+		NodeType type;
+
+		/// Attributes of the node.
+		vector<Attribute> attributes;
+
+		/// IDs of the parents in the order of the scene graph.
+		vector<Id> parentIds;
+
+		/// IDs of the children in the order of the scene graph. Only used for groups and transforms.
+		vector<Id> childIds;
+
+		/// Latest entry of the transform history. Only used for transforms.
+		HistoryEntry::HistoryEntryConstPtr history;
+
+		/// Entries that are older than the latest one minus this duration are outdated.
+		TimeStamp maxHistoryDuration;
+
+		/// The shape. Only used for geometric nodes.
+		Shape::ShapePtr shape;
+
+		/// Time stamp of the shape. Only used for geometric nodes.
+		TimeStamp shapeTimeStamp;
+	};
+
+	/**
+	 * @brief Constructor for an empty scene graph that consists of a root group.
+	 * @param rootId ID of the root node.
+	 */
+	SceneGraphSnapshot(Id rootId);
+
+	/**
+	 * @brief Default destructor.
+	 */
+	virtual ~SceneGraphSnapshot();
+
+	/**
+	 * @brief The version of the scene graph. Each published update increments the version.
+	 */
+	unsigned int getVersion() const;
+
+	/**
+	 * @brief ID of the root node.
+	 */
+	Id getRootId() const;
+
+	/**
+	 * @brief Number of nodes in this version.
+	 */
+	unsigned int getNumberOfNodes() const;
+
+	/**
+	 * @brief Get the record of a node.
+	 * @param id The ID of the node.
+	 * @return The record or null in case the node does not exist in this version.
+	 */
+	NodeRecord::NodeRecordConstPtr getNodeRecord(Id id) const;
+
+	/* Implemented query interfaces */
+
+	/// Same contract as SceneGraphFacade::getNodes(): the IDs are returned in ascending order.
+	bool getNodes(vector<Attribute> attributes, vector<Id>& ids);
+	bool getNodeAttributes(Id id, vector<Attribute>& attributes);
+	bool getNodeParents(Id id, vector<Id>& parentIds);
+	bool getGroupChildren(Id id, vector<Id>& childIds);
+	bool getTransform(Id id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform);
+	bool getUncertainTransform(Id id, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform, ITransformUncertainty::ITransformUncertaintyPtr &uncertainty);
+	bool getGeometry(Id id, Shape::ShapePtr& shape, TimeStamp& timeStamp);
+
+	/**
+	 * @brief Get the transform between two nodes, based on the latest transforms (cf. SceneGraphFacade::getTransformForNode()).
+	 *
+	 * Limitations, identical to the locked concurrency mode so both modes return the same result:
+	 *  - The time stamp is ignored; the latest entry of each transform history is used.
+	 *  - In case a node has multiple paths to the root node, the path along the first parents (parentIds[0]) is taken.
+	 *
+	 * @param id ID of the node.
+	 * @param idReferenceNode ID of the node the transform is relative to.
+	 * @param timeStamp Currently ignored.
+	 * @param[out] transform The transform from the reference node to the node.
+	 * @return False in case one of the nodes does not exist in this version.
+	 */
+	bool getTransformForNode(Id id, Id idReferenceNode, TimeStamp timeStamp, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& transform);
+
+	/**
+	 * @brief Prepend an entry to a transform history.
+	 *
+	 * Out-of-order time stamps are sorted in (which copies the newer entries). Outdated entries are
+	 * removed from time to time: whenever the length has doubled since the last removal. Thus they do not
+	 * accumulate, but the amortized cost of an update stays constant.
+	 *
+	 * @param history The latest entry of the history. Might be null.
+	 * @param transform The new transform.
+	 * @param uncertainty The new uncertainty. If null, the uncertainty of the next older entry is taken over.
+	 * @param timeStamp The time stamp of the transform.
+	 * @param maxHistoryDuration Maximum duration between the latest and the oldest entry.
+	 * @return The latest entry of the new history.
+	 */
+	static HistoryEntry::HistoryEntryConstPtr insertIntoHistory(HistoryEntry::HistoryEntryConstPtr history,
+			IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty,
+			TimeStamp timeStamp, TimeStamp maxHistoryDuration);
+
+	/**
+	 * @brief Find the entry of a history whose time stamp matches best a given stamp.
+	 *
+	 * Same semantics as the TemporalCache: in case the stamp is exactly between two entries the newer one is taken.
+	 * Outdated entries are ignored.
+	 *
+	 * @return The entry or null for an empty history.
+	 */
+	static HistoryEntry::HistoryEntryConstPtr findClosestEntry(HistoryEntry::HistoryEntryConstPtr history,
+			TimeStamp timeStamp, TimeStamp maxHistoryDuration);
+
+	/// Number of shards of the node records and of the attribute index.
+	static const unsigned int numberOfShards;
+
+  private:
+
+	/// (key, value) of an attribute
+	typedef std::pair<string, string> AttributeKey;
+
+	/// IDs of the nodes that share an attribute.
+	typedef boost::unordered_set<Id> IdSet;
+
+	typedef boost::unordered_map<Id, NodeRecord::NodeRecordConstPtr> NodeShard;
+	typedef boost::unordered_map<AttributeKey, boost::shared_ptr<IdSet> > AttributeShard;
+	typedef std::vector< boost::shared_ptr<NodeShard> > NodeTable;
+	typedef std::vector< boost::shared_ptr<AttributeShard> > AttributeTable;
+
+	/**
+	 * @brief Insert or replace the record of a node. Used by the SceneGraphFacade to create the next version.
+	 * Must not be called after the snapshot has been published.
+	 */
+	void setNodeRecord(NodeRecord::NodeRecordConstPtr record);
+
+	/**
+	 * @brief Remove the record of a node. Used by the SceneGraphFacade to create the next version.
+	 * Must not be called after the snapshot has been published.
+	 */
+	void removeNodeRecord(Id id);
+
+	/// Shard of a record that can be modified by this version, i.e. that is not shared with another version.
+	NodeShard& getWritableNodeShard(Id id);
+
+	/// Shard of an attribute that can be modified by this version.
+	AttributeShard& getWritableAttributeShard(const AttributeKey& key);
+
+	/// Update the attribute index for one node.
+	void updateAttributeIndex(Id id, const vector<Attribute>* oldAttributes, const vector<Attribute>* newAttributes);
+
+	/// Accumulate the latest transforms from the root to a node along the first parents.
+	bool getGlobalTransform(Id id, IHomogeneousMatrix44* result) const;
+
+	/// The version.
+	unsigned int version;
+
+	/// ID of the root node.
+	Id rootId;
+
+	/// Number of nodes.
+	unsigned int numberOfNodes;
+
+	/// Records by ID. The table and its shards are shared with other versions, unless modified by this version.
+	boost::shared_ptr<NodeTable> nodeShards;
+
+	/// Inverted index that maps attributes to the IDs of the nodes that have this attribute. Shared as nodeShards.
+	boost::shared_ptr<AttributeTable> attributeShards;
+};
+
+} // namespace brics_3d::rsg
+
+} // namespace brics_3d
+#endif
+
+/* EOF */
@@ -30,6 +30,7 @@ SceneGraphToUpdatesTraverser::SceneGraphToUpdatesTraverser(ISceneGraphUpdate* up
 	this->updatesRecieverHandle = updatesRecieverHandle;
 	assert(updatesRecieverHandle != 0);
 	enableForcedIds = true; // default value
+	enableTransformHistory = false;
 	reset();
 }
 
@@ -57,8 +58,37 @@ void SceneGraphToUpdatesTraverser::visit(Group* node) {
 void SceneGraphToUpdatesTraverser::visit(Transform* node) {
 	unsigned int nodeId = node->getId();
 	unsigned int parentId;
-	if(!handleExistingNode(node, parentId)) {
-		updatesRecieverHandle->addTransformNode(parentId, nodeId, node->getAttributes(), node->getLatestTransform(), node->getLatestTimeStamp(), enableForcedIds);
+	if(handleExistingNode(node, parentId)) {
+		return;
+	}
+
+	std::vector< std::pair<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr, TimeStamp> > history;
+	if (enableTransformHistory) {
+		node->getTransformHistory(history); // latest first
+	}
+	if (history.size() == 0) {
+		history.push_back(std::make_pair(node->getLatestTransform(), node->getLatestTimeStamp()));
+	}
+
+	UncertainTransform* uncertainNode = dynamic_cast<UncertainTransform*>(node);
+	for (int i = static_cast<int>(history.size()) - 1; i >= 0; --i) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform = history[i].first;
+		TimeStamp timeStamp = history[i].second;
+		bool isOldest = (i == static_cast<int>(history.size()) - 1);
+		if (uncertainNode != 0) {
+			ITransformUncertainty::ITransformUncertaintyPtr uncertainty = uncertainNode->getTransformUncertainty(timeStamp);
+			if (isOldest) {
+				updatesRecieverHandle->addUncertainTransformNode(parentId, nodeId, node->getAttributes(), transform, uncertainty, timeStamp, enableForcedIds);
+			} else {
+				updatesRecieverHandle->setUncertainTransform(nodeId, transform, uncertainty, timeStamp);
+			}
+		} else {
+			if (isOldest) {
+				updatesRecieverHandle->addTransformNode(parentId, nodeId, node->getAttributes(), transform, timeStamp, enableForcedIds);
+			} else {
+				updatesRecieverHandle->setTransform(nodeId, transform, timeStamp);
+			}
+		}
 	}
 }
 
@@ -82,6 +112,14 @@ void SceneGraphToUpdatesTraverser::setEnableForcedIds(bool enableForcedIds) {
     this->enableForcedIds = enableForcedIds;
 }
 
+bool SceneGraphToUpdatesTraverser::getEnableTransformHistory() {
+    return enableTransformHistory;
+}
+
+void SceneGraphToUpdatesTraverser::setEnableTransformHistory(bool enableTransformHistory) {
+    this->enableTransformHistory = enableTransformHistory;
+}
+
 
 bool SceneGraphToUpdatesTraverser::handleExistingNode(Node* node, unsigned int& parentId) {
 	unsigned int nodeId = node->getId();
@@ -23,6 +23,7 @@
 #include "Node.h"
 #include "Group.h"
 #include "Transform.h"
+#include "UncertainTransform.h"
 #include "GeometricNode.h"
 #include "INodeVisitor.h"
 #include "ISceneGraphUpdate.h"
@@ -46,6 +47,11 @@ namespace rsg {
  * This needs to be recovered.
  * - Potential duplications of parent-child relation could occour while traversing a more complex graph.
  *
+ * Uncertain transforms are forwarded via addUncertainTransformNode(). By default only the latest transform
+ * of a transform node is forwarded. With setEnableTransformHistory() the complete history is forwarded:
+ * the oldest entry with the add function, all newer ones in temporal order with setTransform() or
+ * setUncertainTransform().
+ *
  * @ingroup sceneGraph
  */
 class SceneGraphToUpdatesTraverser : public INodeVisitor {
@@ -73,6 +79,9 @@ public:
     bool getEnableForcedIds();
     void setEnableForcedIds(bool enableForcedIds);
 
+    bool getEnableTransformHistory();
+    void setEnableTransformHistory(bool enableTransformHistory);
+
 private:
 
 	/**
@@ -93,6 +102,9 @@ private:
 	/// This will be passed as flag to the update functions. Default is true.
 	bool enableForcedIds;
 
+	/// If true the complete history of transform nodes is forwarded instead of the latest entry only. Default is false.
+	bool enableTransformHistory;
+
 	/// Memory of what already visited nodes, including wich partent per node have been already added.
 	std::map<Node*, vector<Node*> > alreadyVisitedNodesWithPendingStatus;
 	std::map<Node*, vector<Node*> >::iterator alreadyVisitedNodesIterator;
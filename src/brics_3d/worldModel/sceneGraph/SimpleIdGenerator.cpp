@@ -18,7 +18,6 @@
 ******************************************************************************/
 
 #include "SimpleIdGenerator.h"
-#include <algorithm>
 
 namespace brics_3d {
 
@@ -28,8 +27,8 @@ SimpleIdGenerator::SimpleIdGenerator() {
 	rootId = 1u; //just an arbitrary choice here
 	runningNumber = rootId + 1;
 	idPool.clear();
-	idPool.push_back(0u);
-	idPool.push_back(rootId);
+	idPool.insert(0u);
+	idPool.insert(rootId);
 }
 
 SimpleIdGenerator::~SimpleIdGenerator(){
@@ -37,8 +36,11 @@ SimpleIdGenerator::~SimpleIdGenerator(){
 }
 
 unsigned int SimpleIdGenerator::getNextValidId(){
+	while (idPool.find(runningNumber) != idPool.end()) { // skip IDs that have been forced before
+		runningNumber++;
+	}
 	unsigned int NextValidId = runningNumber++;
-	removeIdFromPool(NextValidId);
+	idPool.insert(NextValidId);
 	return NextValidId;
 }
 
@@ -47,13 +49,12 @@ unsigned int SimpleIdGenerator::getRootId(){
 }
 
 bool SimpleIdGenerator::removeIdFromPool(unsigned int id) {
-	std::vector<unsigned int>::iterator lookUpResult = 	std::find(idPool.begin(), idPool.end(), id);
-//	if (id < runningNumber) {
-	if (lookUpResult != idPool.end()) {
+	if (!idPool.insert(id).second) {
 		return false;
 	}
-	idPool.push_back(id);
-	runningNumber = id + 1; //Generated IDs might not be continous, but that does not really matters...
+	if (id >= runningNumber) {
+		runningNumber = id + 1; //Generated IDs might not be continous, but that does not really matters...
+	}
 	return true;
 }
 
@@ -21,7 +21,7 @@
 #define RSG_SIMPLEIDGENERATOR_H
 
 #include "IIdGenerator.h"
-#include <vector>
+#include <boost/unordered_set.hpp>
 
 namespace brics_3d {
 
@@ -45,7 +45,8 @@ private:
 	unsigned int runningNumber;
 	unsigned int rootId;
 
-	std::vector<unsigned int> idPool;
+	/// IDs that are in use. A hash set, as forced IDs (e.g. while restoring a graph) are checked one by one.
+	boost::unordered_set<unsigned int> idPool;
 };
 
 } // namespace brics_3d::rsg
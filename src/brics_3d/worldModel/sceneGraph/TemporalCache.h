@@ -23,6 +23,7 @@
 #include "TimeStamp.h"
 #include "brics_3d/core/Logger.h"
 #include <vector>
+#include <algorithm>
 
 using brics_3d::Logger;
 
@@ -95,7 +96,7 @@ public:
 	 */
 	TemporalCache(TimeStamp maxHistoryDuration = TimeStamp(10.0, Units::Second)) {
 		this->setMaxHistoryDuration(maxHistoryDuration);
-		history.clear();
+		clear();
 	}
 
 	/**
@@ -130,30 +131,26 @@ public:
     void insertData(T newData, TimeStamp timeStamp) {
 
     	/* history policy: descending order of timestamps (the older the closer to the end - like humans...)
-    	 *  latest              oldest
-    	 *   |-------------------|
-    	 *  begin               end
+    	 *  spare     latest              oldest
+    	 *  |-----|-------------------|
+    	 *        begin               end
     	 */
 
-    	historyIterator = history.begin();
-
-    	/* insert new data at its correct place in time */
-    	while(historyIterator != history.end()) { // loop over history
-    		if (historyIterator->second <= timeStamp) {
-    			break;
-    		}
-    		historyIterator++;
+    	if (getNumberOfCacheEntries() == 0 || timeStamp >= getLatestTimeStamp()) { // the common case: new latest entry
+    		reserveFront();
+    		historyBegin--;
+    		history[historyBegin] = std::make_pair(newData, timeStamp);
+    	} else { // insert new data at its correct place in time
+    		typename std::vector<std::pair<T, TimeStamp> >::iterator historyIterator = std::lower_bound(history.begin() + historyBegin, history.end(), timeStamp, NewerThan());
+    		history.insert(historyIterator, std::make_pair(newData, timeStamp)); // fit into correct temporal place
     	}
-    	history.insert(historyIterator, std::make_pair(newData, timeStamp)); // fit into correct temporal place
-
 
     	/*
     	 * Clean up outdated data.
     	 * In this case the temporal reference is deduced from the stored data and not
     	 * from the current (real) time.
     	 */
-    	historyIterator = history.begin(); // we already know that there is already one element...
-    	TimeStamp latestTimeStamp = history.begin()->second;
+    	TimeStamp latestTimeStamp = history[historyBegin].second; // we already know that there is already one element...
     	deleteOutdatedData(latestTimeStamp);
     }
 
@@ -164,7 +161,7 @@ public:
      * stamp is closest will be picked. Even if the query reaches beyond the cache limits.
      * I.e. a query older then the oldest entry will return the oldest entry in the cache.
      * Queries that are newer then the latest entry will return the latest one. There is
-     * no interpolation of data.
+     * no interpolation of data. See getInterpolatedData() for that purpose.
      *
      * To check how far a query is beyond the cache limits, use the getLatestTimeStamp() or
      * getOldestTimeStamp() functions.
@@ -182,12 +179,55 @@ public:
     	return closestTransform->first;
     }
 
+    /**
+     * @brief Retrive data from the cache that is interpolated for a given time stamp.
+     *
+     * The two entries around the time stamp are combined by interpolateData(). Queries beyond
+     * the cache limits are not extrapolated: they return the oldest or the latest entry respectively.
+     *
+     * @param timeStamp Based on tis time stamp a value will be returned.
+     * @return Returns the interpolated data. The actual type is defined by the template parameter.
+     */
+    T getInterpolatedData(TimeStamp timeStamp) {
+    	if (getNumberOfCacheEntries() == 0) {
+    		LOG(WARNING) << "TemporalCache is empty. Cannot find data for time stamp at "  << timeStamp.getSeconds() << " [s]";
+    		return returnNullData();
+    	}
+
+    	typename std::vector<std::pair<T, TimeStamp> >::iterator olderIterator = std::lower_bound(history.begin() + historyBegin, history.end(), timeStamp, NewerThan());
+    	if (olderIterator == history.begin() + historyBegin) { // newer than the latest entry
+    		return olderIterator->first;
+    	}
+    	if (olderIterator == history.end()) { // older than the oldest entry
+    		return history.back().first;
+    	}
+    	if (olderIterator->second == timeStamp) {
+    		return olderIterator->first;
+    	}
+
+    	typename std::vector<std::pair<T, TimeStamp> >::iterator newerIterator = olderIterator - 1;
+    	double ratio = (timeStamp - olderIterator->second).getSeconds() / (newerIterator->second - olderIterator->second).getSeconds();
+    	return interpolateData(olderIterator->first, newerIterator->first, ratio);
+    }
+
+    /**
+     * @brief Retrive the latest entry of the cache.
+     * @return Returns the latest entry. The actual type is defined by the template parameter.
+     */
+    T getLatestData() {
+    	if (getNumberOfCacheEntries() == 0) {
+    		LOG(WARNING) << "TemporalCache is empty. Cannot return latest data.";
+    		return returnNullData();
+    	}
+    	return history[historyBegin].first;
+    }
+
     /**
      * @brief Get a read-only iterator in descending order at the beginning of the cache (latest).
      * @return Iteratror
      */
     typename std::vector<std::pair<T, TimeStamp> >::const_iterator begin() {
-    	return history.begin();
+    	return history.begin() + historyBegin;
     }
 
     /**
@@ -213,7 +253,7 @@ public:
      * @return Iteratror
      */
     typename std::vector<std::pair<T, TimeStamp> >::const_reverse_iterator rend() {
-    	return history.rend();
+    	return typename std::vector<std::pair<T, TimeStamp> >::const_reverse_iterator(history.begin() + historyBegin);
     }
 
 
@@ -241,7 +281,7 @@ public:
      * @brief Returns the number of elements that are stored in the history cache.
      */
     unsigned int getNumberOfCacheEntries() {
-    	return static_cast<unsigned int>(history.size());
+    	return static_cast<unsigned int>(history.size() - historyBegin);
     }
 
     /**
@@ -249,12 +289,11 @@ public:
      * @return The latest time stamp or 0.0 in case of an empty history cache.
      */
     TimeStamp getLatestTimeStamp() {
-    	typename std::vector<std::pair<T, TimeStamp> >::iterator historyIterator = history.begin();
-    	if(historyIterator == history.end()) {
+    	if(getNumberOfCacheEntries() == 0) {
     		LOG(WARNING) << "The TemporalCache is empty. Returning TimeStamp(0.0) instead.";
     		return TimeStamp(0.0);
     	}
-    	return history.front().second;
+    	return history[historyBegin].second;
     }
 
     /**
@@ -262,8 +301,7 @@ public:
      * @return The oldest time stamp or 0.0 in case of an empty history cache.
      */
     TimeStamp getOldestTimeStamp() {
-    	typename std::vector<std::pair<T, TimeStamp> >::iterator historyIterator = history.begin();
-    	if(historyIterator == history.end()) {
+    	if(getNumberOfCacheEntries() == 0) {
     		LOG(WARNING) << "The TemporalCache is empty. Returning TimeStamp(0.0) instead.";
     		return TimeStamp(0.0);
     	}
@@ -275,6 +313,7 @@ public:
      */
     void clear() {
     	history.clear();
+    	historyBegin = 0;
     }
 
     /**
@@ -288,17 +327,44 @@ public:
     	 * delete all data where the durartion (delta between latestTime and stored) exeeds
     	 * the defined maximum history duration
     	 */
-    	while(!history.empty() && (history.back().second + maxHistoryDuration < latestTimeStamp)) {
+    	while(getNumberOfCacheEntries() > 0 && (history.back().second + maxHistoryDuration < latestTimeStamp)) {
     		history.pop_back();
     	}
+    	if (getNumberOfCacheEntries() == 0) { // release the spare slots
+    		clear();
+    	}
     }
 
 protected:
-    /// Data cache. Each data T has an associated time stamp.
+    /// Data cache. Each data T has an associated time stamp. The entries start at historyBegin, the slots in front are spare.
     std::vector<std::pair<T, TimeStamp> > history;
 
-    /// Iterator for the cache entries.
-    typename std::vector<std::pair<T, TimeStamp> >::iterator historyIterator;
+    /// Index of the latest entry in the history.
+    unsigned int historyBegin;
+
+    /// Minimal number of spare slots that are reserved in front of the latest entry.
+    static const unsigned int minSpareEntries = 16;
+
+    /// Predicate for a binary search in the descending history.
+    struct NewerThan {
+    	bool operator()(const std::pair<T, TimeStamp>& entry, const TimeStamp& timeStamp) const {
+    		return entry.second > timeStamp;
+    	}
+    };
+
+    /**
+     * @brief Make sure that there is at least one spare slot in front of the latest entry.
+     *
+     * If all slots are used up, as many slots as entries are added. Thus appending is amortized O(1).
+     */
+    void reserveFront() {
+    	if (historyBegin > 0) {
+    		return;
+    	}
+    	unsigned int spareEntries = std::max(getNumberOfCacheEntries(), minSpareEntries);
+    	history.insert(history.begin(), spareEntries, std::pair<T, TimeStamp>());
+    	historyBegin = spareEntries;
+    }
 
     /// Size of the cache.
     TimeStamp maxHistoryDuration; //TODO: should be of some Duration type not a time stamp...
@@ -311,37 +377,29 @@ protected:
      */
     typename std::vector<std::pair<T, TimeStamp> >::iterator getClosestData(TimeStamp timeStamp) {
 
-    	typename std::vector<std::pair<T, TimeStamp> >::iterator resultIterator;
-    	typename std::vector<std::pair<T, TimeStamp> >::iterator previousIterator; //remember: values have a decending order
-    	resultIterator = history.begin();
-
-    	if(getNumberOfCacheEntries() == 1) { // special case for first element -> just return it
-    		return resultIterator;
+    	typename std::vector<std::pair<T, TimeStamp> >::iterator latestIterator = history.begin() + historyBegin;
+    	if(getNumberOfCacheEntries() <= 1) { // special case for empty cache or first element -> just return it
+    		return latestIterator;
     	}
 
-    	while(resultIterator != history.end()) { // loop over history
-    		if (timeStamp >= resultIterator->second) {
-    			if(resultIterator != history.begin()) { // i.e. a previous element exists => coMpare wich is actually the closest
-    				previousIterator = resultIterator - 1;
-    				if ( (previousIterator->second - timeStamp) <= (timeStamp - resultIterator->second) ) {
-    					return previousIterator;
-    				} else {
-    					return resultIterator;
-    				}
-    			} else {
-    				return resultIterator;
-    			}
-    		}
-    		resultIterator++;
+    	/* first entry that is not newer than the time stamp; remember: values have a decending order */
+    	typename std::vector<std::pair<T, TimeStamp> >::iterator resultIterator = std::lower_bound(latestIterator, history.end(), timeStamp, NewerThan());
+    	if (resultIterator == latestIterator) {
+    		return resultIterator;
     	}
 
     	/*
     	 * We might reach this line when timeStamp is older thant the oldest element in the history.
     	 * In that case we want to return the last/oldest element.
     	 */
-    	if(getNumberOfCacheEntries() > 1) {
-    		resultIterator = history.end() - 1;
-    		assert(timeStamp < resultIterator->second); // just to be sure...
+    	if (resultIterator == history.end()) {
+    		return history.end() - 1;
+    	}
+
+    	/* a previous element exists => compare wich is actually the closest */
+    	typename std::vector<std::pair<T, TimeStamp> >::iterator previousIterator = resultIterator - 1;
+    	if ( (previousIterator->second - timeStamp) <= (timeStamp - resultIterator->second) ) {
+    		return previousIterator;
     	}
     	return resultIterator;
     }
@@ -358,8 +416,26 @@ protected:
     T returnNullData() {
     	return 0;
     }
+
+    /**
+     * @brief Interpolate between two entries.
+     *
+     * The default implementation does not interpolate but returns the closer entry. Specializations for types
+     * that support interpolation can be provided.
+     *
+     * @param olderData The entry before the queried time stamp.
+     * @param newerData The entry after the queried time stamp.
+     * @param ratio Relative position of the queried time stamp. 0 corresponds to olderData, 1 to newerData.
+     * @return The interpolated data.
+     */
+    T interpolateData(const T& olderData, const T& newerData, double ratio) {
+    	return (ratio < 0.5) ? olderData : newerData;
+    }
 };
 
+template<typename T>
+const unsigned int TemporalCache<T>::minSpareEntries;
+
 }
 
 }
@@ -22,12 +22,45 @@
 /* for transform tools: */
 #include "brics_3d/core/HomogeneousMatrix44.h"
 #include "brics_3d/core/Logger.h"
-#include "PathCollector.h"
 
 namespace brics_3d {
 
 namespace rsg {
 
+template<>
+IHomogeneousMatrix44::IHomogeneousMatrix44Ptr TemporalCache<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr>::interpolateData(const IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& olderData, const IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& newerData, double ratio) {
+	assert(olderData != 0);
+	assert(newerData != 0);
+	const double* olderMatrix = olderData->getRawData();
+	const double* newerMatrix = newerData->getRawData();
+
+	/* rotation; layout see IHomogeneousMatrix44 */
+	Eigen::Matrix3d olderRotation;
+	Eigen::Matrix3d newerRotation;
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 3; ++col) {
+			olderRotation(row, col) = olderMatrix[col * 4 + row];
+			newerRotation(row, col) = newerMatrix[col * 4 + row];
+		}
+	}
+	Eigen::Quaterniond olderQuaternion(olderRotation);
+	Eigen::Quaterniond newerQuaternion(newerRotation);
+	Eigen::Matrix3d rotation = olderQuaternion.slerp(ratio, newerQuaternion).toRotationMatrix();
+
+	/* translation */
+	double translation[3];
+	for (int i = 0; i < 3; ++i) {
+		translation[i] = olderMatrix[12 + i] + ratio * (newerMatrix[12 + i] - olderMatrix[12 + i]);
+	}
+
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr result(new HomogeneousMatrix44(
+			rotation(0,0), rotation(0,1), rotation(0,2),
+			rotation(1,0), rotation(1,1), rotation(1,2),
+			rotation(2,0), rotation(2,1), rotation(2,2),
+			translation[0], translation[1], translation[2]));
+	return result;
+}
+
 IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getGlobalTransformAlongPath(Node::NodePath nodePath){
 	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr result(new HomogeneousMatrix44()); //identity matrix
 	for (unsigned int i = 0; i < static_cast<unsigned int>(nodePath.size()); ++i) {
@@ -41,25 +74,7 @@ IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getGlobalTransformAlongPath(Node::
 
 IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getGlobalTransform(Node::NodePtr node) {
 	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr result(new HomogeneousMatrix44()); //identity matrix
-	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr accumulatedTransform;
-
-	/* accumulate parent paths and take the _first_ found path  */
-	PathCollector* pathCollector = new PathCollector();
-	node->accept(pathCollector);
-	if (static_cast<unsigned int>(pathCollector->getNodePaths().size()) > 0) { // != root
-		*result = *((*result) * (*(getGlobalTransformAlongPath(pathCollector->getNodePaths()[0]))));
-		if (static_cast<unsigned int>(pathCollector->getNodePaths().size()) > 1) {
-			LOG(WARNING) << "Multiple transform paths to this node detected. Taking fist path and ignoring the rest.";
-		}
-	}
-
-	/* check if node is a transform on its own ... */
-	Transform::TransformPtr tmpTransform = boost::dynamic_pointer_cast<Transform>(node);
-	if (tmpTransform) {
-		*result = *( (*result) * (*tmpTransform->getLatestTransform()) );
-	}
-
-	delete pathCollector;
+	*result = *(node->getCachedGlobalTransform()); // a copy, as the caller might modify it
 	return result;
 }
 
@@ -94,12 +109,24 @@ Transform::~Transform() {
 
 void Transform::insertTransform(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr newTransform, TimeStamp timeStamp) {
 	assert(newTransform != 0);
+	/* same policy as the history: a time stamp not older than the latest one yields the new latest entry */
+	bool isLatest = (history.getNumberOfCacheEntries() == 0) || (timeStamp >= history.getLatestTimeStamp());
 	history.insertData(newTransform, timeStamp);
 	updateCount ++;
+	if (isLatest) { // older data does not affect the global transforms
+		invalidateGlobalTransform();
+	}
 }
 
 void Transform::deleteOutdatedTransforms(TimeStamp latestTimeStamp) {
+	if (history.getNumberOfCacheEntries() == 0) {
+		return;
+	}
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr previousLatestTransform = history.getLatestData();
 	history.deleteOutdatedData(latestTimeStamp);
+	if (history.getNumberOfCacheEntries() == 0 || history.getLatestData() != previousLatestTransform) {
+		invalidateGlobalTransform();
+	}
 }
 
 IHomogeneousMatrix44::IHomogeneousMatrix44Ptr  Transform::getTransform(TimeStamp timeStamp) {
@@ -107,7 +134,11 @@ IHomogeneousMatrix44::IHomogeneousMatrix44Ptr  Transform::getTransform(TimeStamp
 }
 
 IHomogeneousMatrix44::IHomogeneousMatrix44Ptr Transform::getLatestTransform(){
-	return history.getData(history.getLatestTimeStamp());
+	return history.getLatestData();
+}
+
+IHomogeneousMatrix44::IHomogeneousMatrix44Ptr Transform::getInterpolatedTransform(TimeStamp timeStamp) {
+	return history.getInterpolatedData(timeStamp);
 }
 
 TimeStamp Transform::getMaxHistoryDuration() {
@@ -134,6 +165,21 @@ unsigned int Transform::getUpdateCount() {
     return updateCount;
 }
 
+void Transform::getTransformHistory(std::vector< std::pair<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr, TimeStamp> >& transformHistory) {
+	transformHistory.assign(history.begin(), history.end());
+}
+
+void Transform::computeGlobalTransform(IHomogeneousMatrix44* result) {
+	Node::computeGlobalTransform(result);
+	if (history.getNumberOfCacheEntries() == 0) {
+		return;
+	}
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr latestTransform = getLatestTransform();
+	if (latestTransform) {
+		*result = *( (*result) * (*latestTransform) );
+	}
+}
+
 void Transform::accept(INodeVisitor* visitor){
 	visitor->visit(this);
 	if (visitor->getDirection() == INodeVisitor::upwards) { //TODO move to "traverseUpwards" method?
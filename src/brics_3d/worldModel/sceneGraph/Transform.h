@@ -37,6 +37,14 @@ inline IHomogeneousMatrix44::IHomogeneousMatrix44Ptr TemporalCache<IHomogeneousM
 	return IHomogeneousMatrix44::IHomogeneousMatrix44Ptr(); // should be kind of null...
 }
 
+/**
+ * Specialaization for IHomogeneousMatrix44::IHomogeneousMatrix44Ptr type that interpolates
+ * the translation linearly and the rotation by a spherical linear interpolation (SLERP)
+ * of the corresponding quaternions.
+ */
+template<>
+IHomogeneousMatrix44::IHomogeneousMatrix44Ptr TemporalCache<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr>::interpolateData(const IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& olderData, const IHomogeneousMatrix44::IHomogeneousMatrix44Ptr& newerData, double ratio);
+
 typedef std::vector< std::pair<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr, TimeStamp> >::iterator HistoryIterator;
 
 /**
@@ -52,8 +60,10 @@ extern IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getGlobalTransformAlongPath
  *
  * In case the node is a transform node it will be taken into account too.
  * In case the node has multiple paths to root node, the first found path will be taken!
+ * The transform is taken from the cache of the node (see Node::getCachedGlobalTransform()),
+ * so it is only recalculated if something on the path to the root has changed.
  * @param node The node to where the transform from root will calculated.
- * @return Shared pointer to the accumulated transform.
+ * @return Shared pointer to (a copy of) the accumulated transform.
  * @ingroup sceneGraph
  */
 extern IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getGlobalTransform(Node::NodePtr node);
@@ -109,6 +119,17 @@ class Transform : public Group {
      */
     IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getLatestTransform();
 
+    /**
+     * @brief Retrieve a transform that is interpolated between the two transforms around a given stamp.
+     *
+     * The translation is interpolated linearly, the rotation spherically (SLERP). Time stamps beyond
+     * the limits of the history cache yield the oldest or the latest transform respectively.
+     *
+     * @param timeStamp Time stamp for wich the transform shall be interpolated.
+     * @return Shared pointer to the transform. It will be null in case that no transform is found.
+     */
+    IHomogeneousMatrix44::IHomogeneousMatrix44Ptr getInterpolatedTransform(TimeStamp timeStamp);
+
     /**
      * Getter for maxHistoryDuration
      */
@@ -141,6 +162,12 @@ class Transform : public Group {
      */
     unsigned int getUpdateCount();
 
+    /**
+     * @brief Get a copy of the history cache.
+     * @param[out] transformHistory Pairs of transform and time stamp, the latest first. Previous content will be overwritten.
+     */
+    void getTransformHistory(std::vector< std::pair<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr, TimeStamp> >& transformHistory);
+
 
     void accept(INodeVisitor* visitor);
 
@@ -152,6 +179,11 @@ class Transform : public Group {
      */
     void deleteOutdatedTransforms(TimeStamp latestTimeStamp);
 
+  protected:
+
+    /// Accumulate the latest transform of this node to the root to parent transform.
+    virtual void computeGlobalTransform(IHomogeneousMatrix44* result);
+
   private:
 
     /// History of transforms. Each transform has an associated time stamp.
@@ -0,0 +1,418 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#include "UpdateObserverDispatcher.h"
+#include "brics_3d/core/Logger.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
+
+#include <assert.h>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/unordered_set.hpp>
+
+namespace brics_3d {
+
+namespace rsg {
+
+const unsigned int UpdateObserverDispatcher::maxBatchSize = 256;
+
+UpdateObserverDispatcher::UpdateObserverDispatcher(ISceneGraphUpdateObserver* observer, unsigned int queueCapacity, bool coalesceTransforms) :
+		observer(observer),
+		queueCapacity(queueCapacity),
+		coalesceTransforms(coalesceTransforms),
+		queue(queueCapacity),
+		overflowPending(false),
+		enqueuedCount(0),
+		dequeuedCount(0),
+		processedCount(0),
+		maxQueueDepth(0),
+		dispatchedCount(0),
+		coalescedCount(0),
+		droppedCount(0),
+		dispatcherWaiting(false),
+		stopRequested(false),
+		dispatchThread(boost::bind(&UpdateObserverDispatcher::dispatchLoop, this)) {
+	assert(observer != 0);
+	assert(queueCapacity > 0);
+}
+
+UpdateObserverDispatcher::~UpdateObserverDispatcher() {
+	stopRequested.store(true);
+	{
+		boost::mutex::scoped_lock lock(waitMutex);
+		updatesAvailable.notify_one();
+	}
+	dispatchThread.join();
+}
+
+bool UpdateObserverDispatcher::addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId) {
+	Update update;
+	update.type = addNodeUpdate;
+	update.id = assignedId;
+	update.parentId = parentId;
+	update.attributes = attributes;
+	update.forcedId = forcedId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId) {
+	Update update;
+	update.type = addGroupUpdate;
+	update.id = assignedId;
+	update.parentId = parentId;
+	update.attributes = attributes;
+	update.forcedId = forcedId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId) {
+	Update update;
+	update.type = addTransformNodeUpdate;
+	update.id = assignedId;
+	update.parentId = parentId;
+	update.attributes = attributes;
+	update.transform = copyTransform(transform);
+	update.timeStamp = timeStamp;
+	update.forcedId = forcedId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId) {
+	Update update;
+	update.type = addUncertainTransformNodeUpdate;
+	update.id = assignedId;
+	update.parentId = parentId;
+	update.attributes = attributes;
+	update.transform = copyTransform(transform);
+	update.uncertainty = uncertainty;
+	update.timeStamp = timeStamp;
+	update.forcedId = forcedId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId) {
+	Update update;
+	update.type = addGeometricNodeUpdate;
+	update.id = assignedId;
+	update.parentId = parentId;
+	update.attributes = attributes;
+	update.shape = shape;
+	update.timeStamp = timeStamp;
+	update.forcedId = forcedId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::setNodeAttributes(Id id, vector<Attribute> newAttributes) {
+	Update update;
+	update.type = setNodeAttributesUpdate;
+	update.id = id;
+	update.attributes = newAttributes;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) {
+	Update update;
+	update.type = setTransformUpdate;
+	update.id = id;
+	update.transform = copyTransform(transform);
+	update.timeStamp = timeStamp;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp) {
+	Update update;
+	update.type = setUncertainTransformUpdate;
+	update.id = id;
+	update.transform = copyTransform(transform);
+	update.uncertainty = uncertainty;
+	update.timeStamp = timeStamp;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::deleteNode(Id id) {
+	Update update;
+	update.type = deleteNodeUpdate;
+	update.id = id;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::addParent(Id id, Id parentId) {
+	Update update;
+	update.type = addParentUpdate;
+	update.id = id;
+	update.parentId = parentId;
+	return enqueue(update);
+}
+
+bool UpdateObserverDispatcher::removeParent(Id id, Id parentId) {
+	Update update;
+	update.type = removeParentUpdate;
+	update.id = id;
+	update.parentId = parentId;
+	return enqueue(update);
+}
+
+void UpdateObserverDispatcher::flush() {
+	unsigned long target = enqueuedCount.load();
+	boost::mutex::scoped_lock lock(waitMutex);
+	while (processedCount.load() < target) {
+		updatesAvailable.notify_one();
+		updatesProcessed.timed_wait(lock, boost::posix_time::milliseconds(10));
+	}
+}
+
+unsigned int UpdateObserverDispatcher::getQueueDepth() const {
+	unsigned long dequeued = dequeuedCount.load(); // read first, so the difference cannot be negative
+	return static_cast<unsigned int>(enqueuedCount.load() - dequeued);
+}
+
+unsigned int UpdateObserverDispatcher::getMaxQueueDepth() const {
+	return maxQueueDepth.load();
+}
+
+unsigned long UpdateObserverDispatcher::getNumberOfDispatchedUpdates() const {
+	return dispatchedCount.load();
+}
+
+unsigned long UpdateObserverDispatcher::getNumberOfCoalescedUpdates() const {
+	return coalescedCount.load();
+}
+
+unsigned long UpdateObserverDispatcher::getNumberOfDroppedUpdates() const {
+	return droppedCount.load();
+}
+
+unsigned int UpdateObserverDispatcher::getQueueCapacity() const {
+	return queueCapacity;
+}
+
+bool UpdateObserverDispatcher::getCoalesceTransforms() const {
+	return coalesceTransforms;
+}
+
+bool UpdateObserverDispatcher::enqueue(const Update& update) {
+	bool isTransformUpdate = (update.type == setTransformUpdate) || (update.type == setUncertainTransformUpdate);
+	if (overflowPending.load()) {
+		if (isTransformUpdate) {
+			return enqueueInOverflowSlot(update); // do not overtake the pending transforms
+		}
+		boost::mutex::scoped_lock lock(overflowMutex);
+		moveOverflowSlotsToQueue(); // the structural update has to follow the pending transforms
+	}
+
+	while (!queue.push(update)) {
+		if (isTransformUpdate) {
+			return enqueueInOverflowSlot(update);
+		}
+		notifyDispatcher();
+		boost::this_thread::yield(); // structural updates must not get lost
+	}
+	recordEnqueued();
+	notifyDispatcher();
+	return true;
+}
+
+bool UpdateObserverDispatcher::enqueueInOverflowSlot(const Update& update) {
+	bool isNewSlot = false;
+	{
+		boost::mutex::scoped_lock lock(overflowMutex);
+		boost::unordered_map<Id, unsigned int>::iterator slot = overflowSlotIndices.find(update.id);
+		if (slot != overflowSlotIndices.end()) {
+			overflowSlots[slot->second] = update; // only the latest value of a node is kept
+			droppedCount.fetch_add(1);
+		} else {
+			overflowSlotIndices[update.id] = static_cast<unsigned int>(overflowSlots.size());
+			overflowSlots.push_back(update);
+			isNewSlot = true;
+		}
+		overflowPending.store(true);
+	}
+
+	if (isNewSlot) {
+		recordEnqueued();
+	}
+	notifyDispatcher();
+	return true;
+}
+
+void UpdateObserverDispatcher::moveOverflowSlotsToQueue() {
+	for (unsigned int i = 0; i < overflowSlots.size(); ++i) { // already counted as queued
+		while (!queue.push(overflowSlots[i])) {
+			notifyDispatcher();
+			boost::this_thread::yield();
+		}
+	}
+	overflowSlots.clear();
+	overflowSlotIndices.clear();
+	overflowPending.store(false);
+}
+
+bool UpdateObserverDispatcher::takeOverflowSlots(std::vector<Update>& batch) {
+	boost::mutex::scoped_lock lock(overflowMutex);
+	if (!overflowPending.load() || (queue.read_available() > 0)) { // the queued updates are older than the slots
+		return false;
+	}
+	batch.insert(batch.end(), overflowSlots.begin(), overflowSlots.end());
+	overflowSlots.clear();
+	overflowSlotIndices.clear();
+	overflowPending.store(false);
+	return true;
+}
+
+void UpdateObserverDispatcher::recordEnqueued() {
+	unsigned long enqueued = enqueuedCount.fetch_add(1) + 1;
+	unsigned int depth = static_cast<unsigned int>(enqueued - dequeuedCount.load());
+	if (depth > maxQueueDepth.load()) {
+		maxQueueDepth.store(depth);
+	}
+}
+
+IHomogeneousMatrix44::IHomogeneousMatrix44Ptr UpdateObserverDispatcher::copyTransform(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform) {
+	if (!transform) {
+		return transform;
+	}
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transformCopy(new HomogeneousMatrix44());
+	*transformCopy = *transform; // the caller might modify its matrix while the update is queued
+	return transformCopy;
+}
+
+void UpdateObserverDispatcher::notifyDispatcher() {
+	/* pairs with the dispatch thread that sets the waiting flag before it checks the queue a last time */
+	boost::atomic_thread_fence(boost::memory_order_seq_cst);
+	if (dispatcherWaiting.load()) {
+		boost::mutex::scoped_lock lock(waitMutex);
+		updatesAvailable.notify_one();
+	}
+}
+
+void UpdateObserverDispatcher::dispatchLoop() {
+	std::vector<Update> batch;
+	std::vector<bool> skip;
+	batch.reserve(maxBatchSize);
+	Update update;
+
+	while (true) {
+		batch.clear();
+		while ((batch.size() < maxBatchSize) && queue.pop(update)) {
+			batch.push_back(update);
+		}
+		update = Update(); // do not keep the data of the last update alive
+		if (batch.empty() && overflowPending.load()) {
+			takeOverflowSlots(batch);
+		}
+
+		if (batch.empty()) {
+			if (stopRequested.load() && (queue.read_available() == 0) && !overflowPending.load()) {
+				break;
+			}
+			boost::mutex::scoped_lock lock(waitMutex);
+			dispatcherWaiting.store(true);
+			if ((queue.read_available() == 0) && !overflowPending.load() && !stopRequested.load()) {
+				/* the timeout is only a safety net, the producer notifies if it sees the waiting flag */
+				updatesAvailable.timed_wait(lock, boost::posix_time::milliseconds(10));
+			}
+			dispatcherWaiting.store(false);
+			continue;
+		}
+		dequeuedCount.fetch_add(batch.size());
+
+		skip.assign(batch.size(), false);
+		if (coalesceTransforms) {
+			coalesce(batch, skip);
+		}
+		for (unsigned int i = 0; i < batch.size(); ++i) {
+			if (skip[i]) {
+				coalescedCount.fetch_add(1);
+				continue;
+			}
+			try {
+				forward(batch[i]);
+			} catch (std::exception& e) {
+				LOG(ERROR) << "UpdateObserverDispatcher: Observer failed to process an update: " << e.what();
+			}
+			dispatchedCount.fetch_add(1);
+		}
+
+		processedCount.fetch_add(batch.size());
+		boost::mutex::scoped_lock lock(waitMutex);
+		updatesProcessed.notify_all();
+	}
+}
+
+void UpdateObserverDispatcher::coalesce(const std::vector<Update>& batch, std::vector<bool>& skip) {
+	/*
+	 * Walk backwards: the first setTransform of a node that is seen is the newest one. Structural updates
+	 * separate the batch into segments that are coalesced independently, so nothing is moved across them.
+	 */
+	boost::unordered_set<Id> updatedIds;
+	for (int i = static_cast<int>(batch.size()) - 1; i >= 0; --i) {
+		if (batch[i].type == setTransformUpdate) {
+			if (!updatedIds.insert(batch[i].id).second) {
+				skip[i] = true;
+			}
+		} else if (batch[i].type != setUncertainTransformUpdate) {
+			updatedIds.clear();
+		}
+	}
+}
+
+void UpdateObserverDispatcher::forward(Update& update) {
+	Id assignedId = update.id;
+	switch (update.type) {
+	case addNodeUpdate:
+		observer->addNode(update.parentId, assignedId, update.attributes, update.forcedId);
+		break;
+	case addGroupUpdate:
+		observer->addGroup(update.parentId, assignedId, update.attributes, update.forcedId);
+		break;
+	case addTransformNodeUpdate:
+		observer->addTransformNode(update.parentId, assignedId, update.attributes, update.transform, update.timeStamp, update.forcedId);
+		break;
+	case addUncertainTransformNodeUpdate:
+		observer->addUncertainTransformNode(update.parentId, assignedId, update.attributes, update.transform, update.uncertainty, update.timeStamp, update.forcedId);
+		break;
+	case addGeometricNodeUpdate:
+		observer->addGeometricNode(update.parentId, assignedId, update.attributes, update.shape, update.timeStamp, update.forcedId);
+		break;
+	case setNodeAttributesUpdate:
+		observer->setNodeAttributes(update.id, update.attributes);
+		break;
+	case setTransformUpdate:
+		observer->setTransform(update.id, update.transform, update.timeStamp);
+		break;
+	case setUncertainTransformUpdate:
+		observer->setUncertainTransform(update.id, update.transform, update.uncertainty, update.timeStamp);
+		break;
+	case deleteNodeUpdate:
+		observer->deleteNode(update.id);
+		break;
+	case addParentUpdate:
+		observer->addParent(update.id, update.parentId);
+		break;
+	case removeParentUpdate:
+		observer->removeParent(update.id, update.parentId);
+		break;
+	}
+}
+
+}
+
+}
+
+/* EOF */
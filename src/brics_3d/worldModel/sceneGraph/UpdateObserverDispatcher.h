@@ -0,0 +1,268 @@
+/******************************************************************************
+* BRICS_3D - 3D Perception and Modeling Library
+* Copyright (c) 2011, GPS GmbH
+*
+* Author: Sebastian Blumenthal
+*
+*
+* This software is published under a dual-license: GNU Lesser General Public
+* License LGPL 2.1 and Modified BSD license. The dual-license implies that
+* users of this code may choose which terms they prefer.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU Lesser General Public License LGPL and the BSD license for
+* more details.
+*
+******************************************************************************/
+
+#ifndef RSG_UPDATEOBSERVERDISPATCHER_H
+#define RSG_UPDATEOBSERVERDISPATCHER_H
+
+#include "ISceneGraphUpdateObserver.h"
+#include "Attribute.h"
+
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace brics_3d {
+
+namespace rsg {
+
+/**
+ * @brief Forwards the updates of a scene graph asynchronously to another observer.
+ *
+ * The SceneGraphFacade calls its observers inline, so a slow observer (e.g. a visualizer or
+ * a network bridge) throttles the writer. A dispatcher is attached to the facade instead of the
+ * observer itself:
+ *  - An update is copied into a bounded lock-free single producer/single consumer queue and the
+ *    update function returns immediately. The update functions must not be called concurrently,
+ *    which is the case for updates from a SceneGraphFacade.
+ *  - A dedicated dispatch thread takes the updates out of the queue in batches and calls the
+ *    wrapped observer in the original order.
+ *  - Optionally, setTransform() updates are coalesced: within a batch only the newest one per node is
+ *    forwarded. Updates that change the structure of the graph (everything except setTransform()
+ *    and setUncertainTransform()) are never dropped and nothing is reordered across them.
+ *  - If the queue is full, setTransform() and setUncertainTransform() updates are kept in an overflow
+ *    slot per node that only holds the latest value, i.e. an older pending transform of the node is
+ *    dropped. The slots are forwarded once the queue has been drained and before any later structural
+ *    update. Structural updates wait until the queue has space again.
+ *
+ * The return value of an update function only tells whether the update has been queued, not
+ * what the wrapped observer returns. Transforms are copied, so the caller may reuse and modify
+ * its matrix. Uncertainties and shapes are shared with the caller and must not be modified after
+ * the update. Each dispatcher has its own queue and thread, so one slow observer does not delay
+ * the others.
+ *
+ * Example usage:
+ *
+ * @code
+ *
+ *  OSGVisualizer visualizer;
+ *  UpdateObserverDispatcher dispatcher(&visualizer, 1024, true);
+ *  scene.attachUpdateObserver(&dispatcher);
+ *
+ * @endcode
+ *
+ * @ingroup sceneGraph
+ */
+class UpdateObserverDispatcher : public ISceneGraphUpdateObserver {
+  public:
+
+	/**
+	 * @brief Constructor that starts the dispatch thread.
+	 * @param observer The observer that receives the updates. Ownership is not transferred.
+	 * @param queueCapacity Maximal number of updates in the queue.
+	 * @param coalesceTransforms If true only the newest setTransform() per node of a batch is forwarded.
+	 */
+	UpdateObserverDispatcher(ISceneGraphUpdateObserver* observer, unsigned int queueCapacity = 1024, bool coalesceTransforms = false);
+
+	/**
+	 * @brief Destructor that forwards all pending updates and stops the dispatch thread.
+	 */
+	virtual ~UpdateObserverDispatcher();
+
+	/* implementations of observer interface */
+	bool addNode(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false);
+	bool addGroup(Id parentId, Id& assignedId, vector<Attribute> attributes, bool forcedId = false);
+	bool addTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp, bool forcedId = false);
+	bool addUncertainTransformNode(Id parentId, Id& assignedId, vector<Attribute> attributes, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp, bool forcedId = false);
+	bool addGeometricNode(Id parentId, Id& assignedId, vector<Attribute> attributes, Shape::ShapePtr shape, TimeStamp timeStamp, bool forcedId = false);
+	bool setNodeAttributes(Id id, vector<Attribute> newAttributes);
+	bool setTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp);
+	bool setUncertainTransform(Id id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, ITransformUncertainty::ITransformUncertaintyPtr uncertainty, TimeStamp timeStamp);
+	bool deleteNode(Id id);
+	bool addParent(Id id, Id parentId);
+	bool removeParent(Id id, Id parentId);
+
+	/**
+	 * @brief Block until all updates that have been queued so far are forwarded to the observer.
+	 */
+	void flush();
+
+	/**
+	 * @brief Get the number of updates that are currently queued, including the overflow slots.
+	 */
+	unsigned int getQueueDepth() const;
+
+	/**
+	 * @brief Get the maximal number of updates that have been queued at the same time.
+	 */
+	unsigned int getMaxQueueDepth() const;
+
+	/**
+	 * @brief Get the number of updates that have been forwarded to the observer.
+	 */
+	unsigned long getNumberOfDispatchedUpdates() const;
+
+	/**
+	 * @brief Get the number of setTransform() updates that have been superseded by a newer one of the same batch.
+	 */
+	unsigned long getNumberOfCoalescedUpdates() const;
+
+	/**
+	 * @brief Get the number of transform updates that have been dropped, because a newer one of the same node replaced them in the overflow slots.
+	 */
+	unsigned long getNumberOfDroppedUpdates() const;
+
+	/**
+	 * @brief Get the capacity of the queue.
+	 */
+	unsigned int getQueueCapacity() const;
+
+	/**
+	 * @brief Check whether setTransform() updates are coalesced.
+	 */
+	bool getCoalesceTransforms() const;
+
+	/// Maximal number of updates that the dispatch thread takes out of the queue at once.
+	static const unsigned int maxBatchSize;
+
+  private:
+
+	/// The kind of a queued update.
+	enum UpdateType {
+		addNodeUpdate,
+		addGroupUpdate,
+		addTransformNodeUpdate,
+		addUncertainTransformNodeUpdate,
+		addGeometricNodeUpdate,
+		setNodeAttributesUpdate,
+		setTransformUpdate,
+		setUncertainTransformUpdate,
+		deleteNodeUpdate,
+		addParentUpdate,
+		removeParentUpdate
+	};
+
+	/// A queued update with the arguments of the update function. Unused arguments stay empty.
+	class Update {
+	  public:
+		Update() : type(addNodeUpdate), id(0), parentId(0), forcedId(false) {};
+
+		UpdateType type;
+		Id id;
+		Id parentId;
+		vector<Attribute> attributes;
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+		ITransformUncertainty::ITransformUncertaintyPtr uncertainty;
+		Shape::ShapePtr shape;
+		TimeStamp timeStamp;
+		bool forcedId;
+	};
+
+	/// Queue an update.
+	bool enqueue(const Update& update);
+
+	/// Keep a transform update in the overflow slot of its node, if it does not fit into the queue.
+	bool enqueueInOverflowSlot(const Update& update);
+
+	/// Update the metrics for a newly queued update.
+	void recordEnqueued();
+
+	/// Move the overflow slots into the queue, so a structural update can follow them. Requires a lock on overflowMutex.
+	void moveOverflowSlotsToQueue();
+
+	/// Take the overflow slots out, if the queue is empty. Called by the dispatch thread.
+	bool takeOverflowSlots(std::vector<Update>& batch);
+
+	/// Create a copy of a transform that is not shared with the caller.
+	static IHomogeneousMatrix44::IHomogeneousMatrix44Ptr copyTransform(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform);
+
+	/// Main loop of the dispatch thread.
+	void dispatchLoop();
+
+	/// Mark the setTransform() updates of a batch that are superseded by a newer one.
+	void coalesce(const std::vector<Update>& batch, std::vector<bool>& skip);
+
+	/// Call the observer function that belongs to the update.
+	void forward(Update& update);
+
+	/// Wake up the dispatch thread if it is waiting for updates.
+	void notifyDispatcher();
+
+	/// The observer that receives the updates.
+	ISceneGraphUpdateObserver* observer;
+
+	/// Capacity of the queue.
+	unsigned int queueCapacity;
+
+	/// Coalescing flag.
+	bool coalesceTransforms;
+
+	/// Queue between the updating thread (producer) and the dispatch thread (consumer).
+	boost::lockfree::spsc_queue<Update> queue;
+
+	/// Latest transform updates per node that did not fit into the queue, in the order of their first overflow.
+	std::vector<Update> overflowSlots;
+
+	/// Position of a node in the overflow slots.
+	boost::unordered_map<Id, unsigned int> overflowSlotIndices;
+
+	/// Set if the overflow slots are in use. Then all transform updates go into the slots as well, so nothing is reordered.
+	boost::atomic<bool> overflowPending;
+
+	/// Protects the overflow slots.
+	boost::mutex overflowMutex;
+
+	/// Number of updates that have been queued. Written by the producer only.
+	boost::atomic<unsigned long> enqueuedCount;
+
+	/// Number of updates that have been taken out of the queue. Written by the consumer only.
+	boost::atomic<unsigned long> dequeuedCount;
+
+	/// Number of updates that have been processed, i.e. forwarded or coalesced. Written by the consumer only.
+	boost::atomic<unsigned long> processedCount;
+
+	/// Metrics.
+	boost::atomic<unsigned int> maxQueueDepth;
+	boost::atomic<unsigned long> dispatchedCount;
+	boost::atomic<unsigned long> coalescedCount;
+	boost::atomic<unsigned long> droppedCount;
+
+	/// Set if the dispatch thread waits for updates.
+	boost::atomic<bool> dispatcherWaiting;
+
+	/// Set by the destructor to stop the dispatch thread.
+	boost::atomic<bool> stopRequested;
+
+	/// Mutex and conditions for the (rare) cases that the dispatch thread or flush() have to wait.
+	boost::mutex waitMutex;
+	boost::condition_variable updatesAvailable;
+	boost::condition_variable updatesProcessed;
+
+	/// The dispatch thread.
+	boost::thread dispatchThread;
+};
+
+}
+
+}
+
+#endif /* RSG_UPDATEOBSERVERDISPATCHER_H */
+
+/* EOF */
@@ -0,0 +1,152 @@
+/**
+ * @file 
+ * BenchmarkRunnerTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "BenchmarkRunnerTest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BenchmarkRunnerTest );
+
+namespace {
+
+void increment(int* counter) {
+	(*counter)++;
+}
+
+}
+
+void BenchmarkRunnerTest::setUp() {
+
+}
+
+void BenchmarkRunnerTest::tearDown() {
+
+}
+
+void BenchmarkRunnerTest::testStatistics() {
+	std::vector<double> timings;
+	for (int i = 10; i >= 1; --i) { // unsorted on purpose
+		timings.push_back(i);
+	}
+
+	BenchmarkRunner::Result result;
+	BenchmarkRunner::computeStatistics(timings, 1000.0, result);
+	CPPUNIT_ASSERT_EQUAL(10u, result.repetitions);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1000.0, result.itemsPerRun, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, result.minimum, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, result.maximum, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.5, result.mean, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0276504, result.standardDeviation, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.5, result.median, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(9.1, result.percentile90, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(9.91, result.percentile99, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1000.0 / 0.0055, result.throughput, 0.001); // items per second
+
+	/* percentiles */
+	std::vector<double> sortedValues;
+	sortedValues.push_back(2.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, BenchmarkRunner::getPercentile(sortedValues, 0.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, BenchmarkRunner::getPercentile(sortedValues, 50.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, BenchmarkRunner::getPercentile(sortedValues, 100.0), maxTolerance);
+	sortedValues.push_back(4.0);
+	sortedValues.push_back(10.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, BenchmarkRunner::getPercentile(sortedValues, 0.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, BenchmarkRunner::getPercentile(sortedValues, 25.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, BenchmarkRunner::getPercentile(sortedValues, 50.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, BenchmarkRunner::getPercentile(sortedValues, 75.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, BenchmarkRunner::getPercentile(sortedValues, 100.0), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, BenchmarkRunner::getPercentile(sortedValues, 150.0), maxTolerance); // clamped
+
+	/* single timing */
+	timings.assign(1, 3.0);
+	BenchmarkRunner::computeStatistics(timings, 1.0, result);
+	CPPUNIT_ASSERT_EQUAL(1u, result.repetitions);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, result.median, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, result.standardDeviation, maxTolerance);
+}
+
+void BenchmarkRunnerTest::testRun() {
+	BenchmarkRunner runner;
+	CPPUNIT_ASSERT_EQUAL(1u, runner.getWarmupRuns());
+	CPPUNIT_ASSERT_EQUAL(10u, runner.getRepetitions());
+	runner.setWarmupRuns(2);
+	runner.setRepetitions(5);
+
+	int bodyCounter = 0;
+	int prepareCounter = 0;
+	CPPUNIT_ASSERT(runner.run("test/withPrepare", boost::bind(&increment, &bodyCounter), 100.0, boost::bind(&increment, &prepareCounter)));
+	CPPUNIT_ASSERT_EQUAL(7, bodyCounter);
+	CPPUNIT_ASSERT_EQUAL(7, prepareCounter);
+
+	bodyCounter = 0;
+	CPPUNIT_ASSERT(runner.run("test/withoutPrepare", boost::bind(&increment, &bodyCounter)));
+	CPPUNIT_ASSERT_EQUAL(7, bodyCounter);
+
+	/* filter */
+	runner.setFilter("other");
+	bodyCounter = 0;
+	CPPUNIT_ASSERT(!runner.run("test/filtered", boost::bind(&increment, &bodyCounter)));
+	CPPUNIT_ASSERT_EQUAL(0, bodyCounter);
+	CPPUNIT_ASSERT(runner.run("test/other", boost::bind(&increment, &bodyCounter)));
+	CPPUNIT_ASSERT_EQUAL(7, bodyCounter);
+
+	const std::vector<BenchmarkRunner::Result>& results = runner.getResults();
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(results.size()));
+	CPPUNIT_ASSERT(results[0].name.compare("test/withPrepare") == 0);
+	CPPUNIT_ASSERT_EQUAL(5u, results[0].repetitions);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, results[0].itemsPerRun, maxTolerance);
+	CPPUNIT_ASSERT(results[0].minimum <= results[0].median);
+	CPPUNIT_ASSERT(results[0].median <= results[0].percentile90);
+	CPPUNIT_ASSERT(results[0].percentile90 <= results[0].maximum);
+	CPPUNIT_ASSERT(results[1].name.compare("test/withoutPrepare") == 0);
+	CPPUNIT_ASSERT(results[2].name.compare("test/other") == 0);
+}
+
+void BenchmarkRunnerTest::testOutput() {
+	BenchmarkRunner runner;
+	runner.setRepetitions(3);
+	runner.setContext("points", "1000");
+	runner.setContext("release", "x");
+	runner.setContext("release", "1.0 \"beta\""); // overwrite
+	int counter = 0;
+	runner.run("a/first", boost::bind(&increment, &counter), 10.0);
+	runner.run("b,second", boost::bind(&increment, &counter), 20.0);
+
+	std::stringstream json;
+	runner.writeJSON(json);
+	std::string jsonString = json.str();
+	CPPUNIT_ASSERT(jsonString.find("\"repetitions\": 3") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"points\": \"1000\"") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"release\": \"1.0 \\\"beta\\\"\"") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"release\": \"x\"") == std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"name\": \"a/first\"") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"name\": \"b,second\"") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"median\": ") != std::string::npos);
+	CPPUNIT_ASSERT(jsonString.find("\"throughput\": ") != std::string::npos);
+
+	std::stringstream csv;
+	runner.writeCSV(csv);
+	std::string line;
+	std::vector<std::string> lines;
+	while (std::getline(csv, line)) {
+		lines.push_back(line);
+	}
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(lines.size()));
+	CPPUNIT_ASSERT(lines[0].find("name,repetitions,itemsPerRun,") == 0);
+	CPPUNIT_ASSERT(lines[1].find("a/first,3,10,") == 0);
+	CPPUNIT_ASSERT(lines[2].find("\"b,second\",3,20,") == 0);
+}
+
+}
+
+/* EOF */
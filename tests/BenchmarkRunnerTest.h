@@ -0,0 +1,45 @@
+/**
+ * @file 
+ * BenchmarkRunnerTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef BENCHMARKRUNNERTEST_H_
+#define BENCHMARKRUNNERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/util/BenchmarkRunner.h"
+
+using namespace brics_3d;
+
+namespace unitTests {
+
+class BenchmarkRunnerTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( BenchmarkRunnerTest );
+	CPPUNIT_TEST( testStatistics );
+	CPPUNIT_TEST( testRun );
+	CPPUNIT_TEST( testOutput );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testStatistics();
+	void testRun();
+	void testOutput();
+
+private:
+	static const double maxTolerance = 0.00001;
+};
+
+}
+
+#endif /* BENCHMARKRUNNERTEST_H_ */
+
+/* EOF */
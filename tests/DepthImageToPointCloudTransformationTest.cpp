@@ -0,0 +1,198 @@
+/**
+ * @file 
+ * DepthImageToPointCloudTransformationTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifdef BRICS_OPENCV_ENABLE
+
+#include "DepthImageToPointCloudTransformationTest.h"
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( DepthImageToPointCloudTransformationTest );
+
+void DepthImageToPointCloudTransformationTest::setUp() {
+	grayImage = cvCreateImage(cvSize(40, 30), IPL_DEPTH_8U, 1);
+	depthImage = cvCreateImage(cvSize(640, 480), IPL_DEPTH_16U, 1);
+
+	for (int row = 0; row < grayImage->height; ++row) {
+		unsigned char* pixels = reinterpret_cast<unsigned char*>(grayImage->imageData + row * grayImage->widthStep);
+		for (int col = 0; col < grayImage->width; ++col) {
+			pixels[col] = static_cast<unsigned char>((row * grayImage->width + col) % 256);
+		}
+	}
+
+	for (int row = 0; row < depthImage->height; ++row) {
+		unsigned short* pixels = reinterpret_cast<unsigned short*>(depthImage->imageData + row * depthImage->widthStep);
+		for (int col = 0; col < depthImage->width; ++col) {
+			pixels[col] = ((row + col) % 7 == 0) ? 0 : static_cast<unsigned short>(500 + row + col);
+		}
+	}
+}
+
+void DepthImageToPointCloudTransformationTest::tearDown() {
+	cvReleaseImage(&grayImage);
+	cvReleaseImage(&depthImage);
+}
+
+void DepthImageToPointCloudTransformationTest::testUncalibrated() {
+	DepthImageToPointCloudTransformation projection;
+	PointCloud3D pointCloud;
+
+	/* all pixels, in row major order */
+	projection.transformDepthImageToPointCloud(grayImage, &pointCloud);
+	CPPUNIT_ASSERT_EQUAL(1200u, pointCloud.getSize());
+	Point3D point = (*pointCloud.getPointCloud())[41]; // row 1, col 1
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, point.getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(MAX_DEPTHIMAGE_VALUE - 41.0, point.getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(29.0, point.getZ(), maxTolerance);
+
+	/* threshold; points are appended */
+	projection.transformDepthImageToPointCloud(grayImage, &pointCloud, 200.0);
+	unsigned int expectedCount = 0;
+	for (int i = 0; i < 1200; ++i) {
+		expectedCount += (i % 256 >= 200) ? 1 : 0;
+	}
+	CPPUNIT_ASSERT_EQUAL(1200u + expectedCount, pointCloud.getSize());
+	for (unsigned int i = 1200; i < pointCloud.getSize(); ++i) {
+		CPPUNIT_ASSERT(MAX_DEPTHIMAGE_VALUE - (*pointCloud.getPointCloud())[i].getY() >= 200.0);
+	}
+
+	/* 16bit images require intrinsics */
+	PointCloud3D emptyCloud;
+	projection.transformDepthImageToPointCloud(depthImage, &emptyCloud);
+	CPPUNIT_ASSERT_EQUAL(0u, emptyCloud.getSize());
+}
+
+void DepthImageToPointCloudTransformationTest::testCalibrated() {
+	double fx = 525.0;
+	double fy = 520.0;
+	double cx = 319.5;
+	double cy = 239.5;
+	DepthImageToPointCloudTransformation projection;
+	projection.setIntrinsics(fx, fy, cx, cy);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, projection.getDepthScale(), maxTolerance);
+
+	PointCloud3D pointCloud;
+	projection.transformDepthImageToPointCloud(depthImage, &pointCloud);
+
+	/* zero pixels are skipped, the remaining ones are back projected with the pinhole model */
+	unsigned int index = 0;
+	for (int row = 0; row < depthImage->height; ++row) {
+		for (int col = 0; col < depthImage->width; ++col) {
+			if ((row + col) % 7 == 0) {
+				continue;
+			}
+			CPPUNIT_ASSERT(index < pointCloud.getSize());
+			double depth = (500 + row + col) * 0.001;
+			Point3D point = (*pointCloud.getPointCloud())[index++];
+			CPPUNIT_ASSERT_DOUBLES_EQUAL((col - cx) / fx * depth, point.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(depth, point.getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(-(row - cy) / fy * depth, point.getZ(), maxTolerance);
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(index, pointCloud.getSize());
+
+	/* the distortion moves points away from the principal point, the undistorted rays compensate it */
+	double k1 = -0.2;
+	projection.setDistortion(k1, 0.0, 0.0, 0.0);
+	PointCloud3D undistortedCloud;
+	projection.transformDepthImageToPointCloud(depthImage, &undistortedCloud);
+	CPPUNIT_ASSERT_EQUAL(pointCloud.getSize(), undistortedCloud.getSize());
+	Point3D corner = (*undistortedCloud.getPointCloud())[0]; // row 0, col 1
+	double x = corner.getX() / corner.getY();
+	double y = -corner.getZ() / corner.getY();
+	double radial = 1.0 + k1 * (x * x + y * y);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((1 - cx) / fx, x * radial, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((0 - cy) / fy, y * radial, maxTolerance);
+
+	/* 8bit images use the same projection */
+	projection.setDistortion(0.0, 0.0, 0.0, 0.0);
+	projection.setDepthScale(0.01);
+	PointCloud3D grayCloud;
+	projection.transformDepthImageToPointCloud(grayImage, &grayCloud);
+	CPPUNIT_ASSERT_EQUAL(1200u - 5u, grayCloud.getSize()); // 5 pixels with value 0
+	Point3D point = (*grayCloud.getPointCloud())[0]; // row 0, col 1
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.01, point.getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((1 - cx) / fx * 0.01, point.getX(), maxTolerance);
+
+	/* back to the uncalibrated projection */
+	projection.resetIntrinsics();
+	double fxResult, fyResult, cxResult, cyResult;
+	CPPUNIT_ASSERT(projection.getIntrinsics(fxResult, fyResult, cxResult, cyResult) == false);
+}
+
+void DepthImageToPointCloudTransformationTest::testThreads() {
+	DepthImageToPointCloudTransformation projection;
+	projection.setIntrinsics(525.0, 525.0, 319.5, 239.5);
+	CPPUNIT_ASSERT_EQUAL(1u, projection.getNumberOfThreads());
+
+	PointCloud3D serialCloud;
+	projection.transformDepthImageToPointCloud(depthImage, &serialCloud, 600.0);
+
+	projection.setNumberOfThreads(4);
+	CPPUNIT_ASSERT_EQUAL(4u, projection.getNumberOfThreads());
+	PointCloud3D parallelCloud;
+	parallelCloud.addPoint(Point3D(1.0, 2.0, 3.0));
+	projection.transformDepthImageToPointCloud(depthImage, &parallelCloud, 600.0);
+
+	/* same points in the same order, appended to the existing one */
+	CPPUNIT_ASSERT(serialCloud.getSize() > 0u);
+	CPPUNIT_ASSERT_EQUAL(serialCloud.getSize() + 1, parallelCloud.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, (*parallelCloud.getPointCloud())[0].getY(), maxTolerance);
+	for (unsigned int i = 0; i < serialCloud.getSize(); ++i) {
+		Point3D serialPoint = (*serialCloud.getPointCloud())[i];
+		Point3D parallelPoint = (*parallelCloud.getPointCloud())[i + 1];
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPoint.getX(), parallelPoint.getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPoint.getY(), parallelPoint.getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPoint.getZ(), parallelPoint.getZ(), maxTolerance);
+		CPPUNIT_ASSERT(serialPoint.getY() >= 0.6 - maxTolerance);
+	}
+}
+
+void DepthImageToPointCloudTransformationTest::testOrganized() {
+	DepthImageToPointCloudTransformation projection;
+	projection.setIntrinsics(525.0, 525.0, 319.5, 239.5);
+	projection.setNumberOfThreads(4);
+
+	PointCloud3D pointCloud;
+	projection.transformDepthImageToPointCloud(depthImage, &pointCloud);
+	OrganizedPointCloud3D organizedCloud;
+	projection.transformDepthImageToOrganizedPointCloud(depthImage, &organizedCloud);
+
+	/* same points, but at the position of their pixel */
+	CPPUNIT_ASSERT_EQUAL(640u, organizedCloud.getWidth());
+	CPPUNIT_ASSERT_EQUAL(480u, organizedCloud.getHeight());
+	CPPUNIT_ASSERT_EQUAL(pointCloud.getSize(), organizedCloud.getNumberOfValidPoints());
+	CPPUNIT_ASSERT(!organizedCloud.isValid(0, 0));
+	CPPUNIT_ASSERT(!organizedCloud.isValid(2, 5));
+	unsigned int index = 0;
+	for (unsigned int i = 0; i < organizedCloud.getSize(); ++i) {
+		if (!organizedCloud.isValid(i)) {
+			continue;
+		}
+		const Point3D& point = (*pointCloud.getPointCloud())[index++];
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(point.getX(), organizedCloud.getXCoordinates()[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(point.getY(), organizedCloud.getYCoordinates()[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(point.getZ(), organizedCloud.getZCoordinates()[i], maxTolerance);
+	}
+
+	/* uncalibrated projection with threshold */
+	DepthImageToPointCloudTransformation uncalibratedProjection;
+	uncalibratedProjection.transformDepthImageToOrganizedPointCloud(grayImage, &organizedCloud, 128.0);
+	CPPUNIT_ASSERT_EQUAL(1200u, organizedCloud.getSize());
+	CPPUNIT_ASSERT(!organizedCloud.isValid(0, 1));
+	CPPUNIT_ASSERT(organizedCloud.isValid(3, 10)); // value 130
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, organizedCloud.getPoint(3, 10).getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(MAX_DEPTHIMAGE_VALUE - 130.0, organizedCloud.getPoint(3, 10).getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(27.0, organizedCloud.getPoint(3, 10).getZ(), maxTolerance);
+}
+
+}
+
+#endif /* BRICS_OPENCV_ENABLE */
+
+/* EOF */
@@ -0,0 +1,59 @@
+/**
+ * @file 
+ * DepthImageToPointCloudTransformationTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef DEPTHIMAGETOPOINTCLOUDTRANSFORMATIONTEST_H_
+#define DEPTHIMAGETOPOINTCLOUDTRANSFORMATIONTEST_H_
+
+#ifdef BRICS_OPENCV_ENABLE
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/algorithm/depthPerception/DepthImageToPointCloudTransformation.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class DepthImageToPointCloudTransformationTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( DepthImageToPointCloudTransformationTest );
+	CPPUNIT_TEST( testUncalibrated );
+	CPPUNIT_TEST( testCalibrated );
+	CPPUNIT_TEST( testThreads );
+	CPPUNIT_TEST( testOrganized );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testUncalibrated();
+	void testCalibrated();
+	void testThreads();
+	void testOrganized();
+
+private:
+
+	/// 8bit image with a gradient and some zero pixels
+	IplImage* grayImage;
+
+	/// 16bit image with depth values in millimeters and some zero pixels
+	IplImage* depthImage;
+
+	static const double maxTolerance = 0.00001;
+};
+
+}
+
+#endif /* BRICS_OPENCV_ENABLE */
+
+#endif /* DEPTHIMAGETOPOINTCLOUDTRANSFORMATIONTEST_H_ */
+
+/* EOF */
@@ -0,0 +1,250 @@
+/**
+ * @file 
+ * EuclideanClusteringTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "EuclideanClusteringTest.h"
+#include <cstdlib>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EuclideanClusteringTest );
+
+void EuclideanClusteringTest::setUp() {
+	pointCloud = new PointCloud3D();
+
+	/* two lines of points with a spacing of 0.1 and a gap of 0.5 in between */
+	for (int i = 0; i < 10; ++i) {
+		pointCloud->addPoint(Point3D(i * 0.1, 0, 0));
+	}
+	for (int i = 0; i < 5; ++i) {
+		pointCloud->addPoint(Point3D(0.9 + 0.5 + i * 0.1, 0, 0));
+	}
+	pointCloud->addPoint(Point3D(-3, -3, -3)); // outlier
+}
+
+void EuclideanClusteringTest::tearDown() {
+	delete pointCloud;
+}
+
+void EuclideanClusteringTest::testSimpleClusters() {
+	EuclideanClustering clusterExtractor;
+	std::vector<PointCloud3D*> clusters;
+
+	clusterExtractor.setClusterTolerance(0.15);
+	clusterExtractor.setPointCloud(pointCloud);
+	clusterExtractor.segment();
+	clusterExtractor.getExtractedClusters(clusters);
+
+	CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(clusters.size()));
+	CPPUNIT_ASSERT_EQUAL(10u, clusters[0]->getSize()); // ordered by the first point
+	CPPUNIT_ASSERT_EQUAL(5u, clusters[1]->getSize());
+	CPPUNIT_ASSERT_EQUAL(1u, clusters[2]->getSize());
+	for (unsigned int i = 0; i < clusters[0]->getSize(); ++i) { // order of the input
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(i * 0.1, (*clusters[0]->getPointCloud())[i].getX(), maxTolerance);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-3.0, (*clusters[2]->getPointCloud())[0].getZ(), maxTolerance);
+	deleteClusters(&clusters);
+
+	/* the gap is bridged with a larger tolerance */
+	clusterExtractor.setClusterTolerance(0.6);
+	clusterExtractor.segment();
+	clusterExtractor.getExtractedClusters(clusters);
+	CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(clusters.size()));
+	CPPUNIT_ASSERT_EQUAL(15u, clusters[0]->getSize());
+	deleteClusters(&clusters);
+}
+
+void EuclideanClusteringTest::testClusterSizeLimits() {
+	EuclideanClustering clusterExtractor;
+	std::vector<PointCloud3D*> clusters;
+
+	clusterExtractor.setClusterTolerance(0.15);
+	clusterExtractor.setMinClusterSize(2);
+	clusterExtractor.setMaxClusterSize(9);
+	clusterExtractor.setPointCloud(pointCloud);
+	clusterExtractor.segment();
+	clusterExtractor.getExtractedClusters(clusters);
+
+	CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(clusters.size()));
+	CPPUNIT_ASSERT_EQUAL(5u, clusters[0]->getSize());
+	deleteClusters(&clusters);
+}
+
+void EuclideanClusteringTest::testReferenceClusters() {
+
+	/* random blobs that partially touch each other */
+	PointCloud3D randomPointCloud;
+	srand(42);
+	for (int blob = 0; blob < 20; ++blob) {
+		double centerX = (rand() % 1000) / 250.0;
+		double centerY = (rand() % 1000) / 250.0;
+		double centerZ = (rand() % 1000) / 1000.0;
+		for (int i = 0; i < 1500; ++i) {
+			randomPointCloud.addPoint(Point3D(centerX + (rand() % 1000) / 2500.0,
+					centerY + (rand() % 1000) / 2500.0,
+					centerZ + (rand() % 1000) / 2500.0));
+		}
+	}
+	const double tolerance = 0.03125; // exactly representable as float
+
+	std::vector<int> referenceLabels;
+	computeReferenceLabels(&randomPointCloud, tolerance, &referenceLabels);
+	unsigned int referenceClusterCount = 0;
+	for (unsigned int i = 0; i < referenceLabels.size(); ++i) {
+		if (referenceLabels[i] == static_cast<int>(i)) {
+			referenceClusterCount++;
+		}
+	}
+	CPPUNIT_ASSERT(referenceClusterCount > 1u);
+
+	EuclideanClustering clusterExtractor;
+	clusterExtractor.setClusterTolerance(tolerance);
+	clusterExtractor.setPointCloud(&randomPointCloud);
+
+	unsigned int threadCounts[] = {1, 3};
+	for (unsigned int t = 0; t < 2; ++t) {
+		clusterExtractor.setNumberOfThreads(threadCounts[t]);
+		CPPUNIT_ASSERT_EQUAL(threadCounts[t], clusterExtractor.getNumberOfThreads());
+
+		std::vector<PointCloud3D*> clusters;
+		clusterExtractor.segment();
+		clusterExtractor.getExtractedClusters(clusters);
+		CPPUNIT_ASSERT_EQUAL(referenceClusterCount, static_cast<unsigned int>(clusters.size()));
+
+		/* the clusters appear in the order of their first point, and the points in the order of the input */
+		std::vector<unsigned int> nextPoint(clusters.size(), 0);
+		unsigned int clusterIndex = 0;
+		std::vector<int> clusterOfLabel(randomPointCloud.getSize(), -1);
+		for (unsigned int i = 0; i < randomPointCloud.getSize(); ++i) {
+			int label = referenceLabels[i];
+			if (clusterOfLabel[label] < 0) {
+				clusterOfLabel[label] = clusterIndex++;
+			}
+			int cluster = clusterOfLabel[label];
+			Point3D expected = (*randomPointCloud.getPointCloud())[i];
+			Point3D actual = (*clusters[cluster]->getPointCloud())[nextPoint[cluster]++];
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getX(), actual.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getY(), actual.getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getZ(), actual.getZ(), maxTolerance);
+		}
+		for (unsigned int i = 0; i < clusters.size(); ++i) {
+			CPPUNIT_ASSERT_EQUAL(clusters[i]->getSize(), nextPoint[i]);
+		}
+		deleteClusters(&clusters);
+	}
+}
+
+void EuclideanClusteringTest::computeReferenceLabels(PointCloud3D* pointCloud, double tolerance, std::vector<int>* labels) {
+	NearestNeighborANN nearestNeighborSearch;
+	nearestNeighborSearch.setData(pointCloud);
+
+	unsigned int size = pointCloud->getSize();
+	labels->assign(size, -1);
+	for (unsigned int i = 0; i < size; ++i) {
+		if ((*labels)[i] >= 0) {
+			continue;
+		}
+		std::vector<int> seedQueue;
+		seedQueue.push_back(i);
+		(*labels)[i] = i;
+		for (unsigned int s = 0; s < seedQueue.size(); ++s) {
+			std::vector<int> neighborIndices;
+			Point3D seed = (*pointCloud->getPointCloud())[seedQueue[s]];
+			nearestNeighborSearch.findNeighborsWithinRadius(&seed, tolerance, &neighborIndices);
+			for (unsigned int j = 0; j < neighborIndices.size(); ++j) {
+				if ((*labels)[neighborIndices[j]] < 0) {
+					(*labels)[neighborIndices[j]] = i;
+					seedQueue.push_back(neighborIndices[j]);
+				}
+			}
+		}
+	}
+}
+
+void EuclideanClusteringTest::deleteClusters(std::vector<PointCloud3D*>* clusters) {
+	for (unsigned int i = 0; i < clusters->size(); ++i) {
+		delete (*clusters)[i];
+	}
+	clusters->clear();
+}
+
+void EuclideanClusteringTest::testOrganizedConnectedComponents() {
+	/* two patches at different depths; the invalid column 5 splits the first one */
+	OrganizedPointCloud3D organizedCloud(20, 10);
+	for (unsigned int row = 0; row < 10; ++row) {
+		for (unsigned int col = 0; col < 20; ++col) {
+			if (col != 5) {
+				organizedCloud.setPoint(row, col, col * 0.01, (col < 10) ? 1.0 : 2.0, row * -0.01);
+			}
+		}
+	}
+
+	OrganizedConnectedComponents segmentation;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.02, segmentation.getDistanceThreshold(), maxTolerance);
+	segmentation.setPointCloud(&organizedCloud);
+	CPPUNIT_ASSERT_EQUAL(3, segmentation.segment());
+
+	std::vector<int> labels;
+	segmentation.getLabels(labels);
+	CPPUNIT_ASSERT_EQUAL(200u, static_cast<unsigned int>(labels.size()));
+	CPPUNIT_ASSERT_EQUAL(0, labels[organizedCloud.getIndex(9, 4)]);
+	CPPUNIT_ASSERT_EQUAL(-1, labels[organizedCloud.getIndex(3, 5)]);
+	CPPUNIT_ASSERT_EQUAL(1, labels[organizedCloud.getIndex(0, 6)]);
+	CPPUNIT_ASSERT_EQUAL(2, labels[organizedCloud.getIndex(5, 19)]);
+
+	std::vector<std::vector<unsigned int> > clusterIndices;
+	segmentation.getClusterIndices(clusterIndices);
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(clusterIndices.size()));
+	CPPUNIT_ASSERT_EQUAL(50u, static_cast<unsigned int>(clusterIndices[0].size()));
+	CPPUNIT_ASSERT_EQUAL(40u, static_cast<unsigned int>(clusterIndices[1].size()));
+	CPPUNIT_ASSERT_EQUAL(100u, static_cast<unsigned int>(clusterIndices[2].size()));
+	CPPUNIT_ASSERT_EQUAL(10u, clusterIndices[2][0]);
+
+	/* size limits */
+	segmentation.setMinClusterSize(45);
+	CPPUNIT_ASSERT_EQUAL(2, segmentation.segment());
+	segmentation.getLabels(labels);
+	CPPUNIT_ASSERT_EQUAL(-1, labels[organizedCloud.getIndex(0, 6)]);
+	CPPUNIT_ASSERT_EQUAL(1, labels[organizedCloud.getIndex(0, 10)]);
+
+	std::vector<PointCloud3D*> extractedClusters;
+	segmentation.getExtractedClusters(extractedClusters);
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(extractedClusters.size()));
+	CPPUNIT_ASSERT_EQUAL(50u, extractedClusters[0]->getSize());
+	CPPUNIT_ASSERT_EQUAL(100u, extractedClusters[1]->getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, (*extractedClusters[1]->getPointCloud())[0].getY(), maxTolerance);
+	for (unsigned int i = 0; i < extractedClusters.size(); ++i) {
+		delete extractedClusters[i];
+	}
+
+	/* a folded surface is connected in space, the normals separate both sides */
+	OrganizedPointCloud3D foldedCloud(20, 10);
+	for (unsigned int row = 0; row < 10; ++row) {
+		for (unsigned int col = 0; col < 20; ++col) {
+			foldedCloud.setPoint(row, col, col * 0.01, (col < 10) ? 1.0 : 1.0 + (col - 9) * 0.01, row * -0.01);
+		}
+	}
+	OrganizedConnectedComponents normalSegmentation;
+	normalSegmentation.setPointCloud(&foldedCloud);
+	CPPUNIT_ASSERT_EQUAL(1, normalSegmentation.segment());
+
+	IntegralImageNormalEstimation normalEstimator;
+	normalEstimator.setWindowRadius(1);
+	NormalSet3D normals;
+	normalEstimator.estimateNormals(&foldedCloud, &normals);
+	normalSegmentation.setNormals(&normals);
+	normalSegmentation.setAngleThreshold(0.1);
+	CPPUNIT_ASSERT(normalSegmentation.segment() >= 2);
+	normalSegmentation.getLabels(labels);
+	CPPUNIT_ASSERT_EQUAL(0, labels[0]);
+	CPPUNIT_ASSERT(labels[19] > 0);
+	CPPUNIT_ASSERT_EQUAL(labels[19], labels[foldedCloud.getIndex(9, 15)]);
+}
+
+}  // namespace unitTests
+
+/* EOF */
@@ -0,0 +1,58 @@
+/**
+ * @file 
+ * EuclideanClusteringTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef EUCLIDEANCLUSTERINGTEST_H_
+#define EUCLIDEANCLUSTERINGTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/algorithm/segmentation/EuclideanClustering.h"
+#include "brics_3d/algorithm/segmentation/OrganizedConnectedComponents.h"
+#include "brics_3d/algorithm/featureExtraction/IntegralImageNormalEstimation.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class EuclideanClusteringTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( EuclideanClusteringTest );
+	CPPUNIT_TEST( testSimpleClusters );
+	CPPUNIT_TEST( testClusterSizeLimits );
+	CPPUNIT_TEST( testReferenceClusters );
+	CPPUNIT_TEST( testOrganizedConnectedComponents );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testSimpleClusters();
+	void testClusterSizeLimits();
+	void testReferenceClusters();
+	void testOrganizedConnectedComponents();
+
+private:
+
+	/// Region growing with radius searches that labels each point with the smallest point index of its cluster.
+	static void computeReferenceLabels(PointCloud3D* pointCloud, double tolerance, std::vector<int>* labels);
+
+	static void deleteClusters(std::vector<PointCloud3D*>* clusters);
+
+	static const double maxTolerance = 0.00001;
+
+	PointCloud3D* pointCloud;
+};
+
+}
+
+#endif /* EUCLIDEANCLUSTERINGTEST_H_ */
+
+/* EOF */
@@ -0,0 +1,241 @@
+/**
+ * @file 
+ * IncrementalOctreeTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "IncrementalOctreeTest.h"
+#include <stdexcept>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( IncrementalOctreeTest );
+
+void IncrementalOctreeTest::setUp() {
+	pointCloudCube = new PointCloud3D();
+
+	pointCloudCube->addPoint(Point3D(0,0,0));
+	pointCloudCube->addPoint(Point3D(0,0,1));
+	pointCloudCube->addPoint(Point3D(0,1,1));
+	pointCloudCube->addPoint(Point3D(0,1,0));
+	pointCloudCube->addPoint(Point3D(1,0,0));
+	pointCloudCube->addPoint(Point3D(1,0,1));
+	pointCloudCube->addPoint(Point3D(1,1,1));
+	pointCloudCube->addPoint(Point3D(1,1,0));
+	pointCloudCube->addPoint(Point3D(1,1,0.9)); //some new points that will be filtered away
+	pointCloudCube->addPoint(Point3D(1,1,0.2));
+}
+
+void IncrementalOctreeTest::tearDown() {
+	delete pointCloudCube;
+}
+
+void IncrementalOctreeTest::testSetupInterface() {
+	IOctreeSetup* octreeSetup = new IncrementalOctree();
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, octreeSetup->getVoxelSize(), maxTolerance);
+	octreeSetup->setVoxelSize(1.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, octreeSetup->getVoxelSize(), maxTolerance);
+	CPPUNIT_ASSERT_THROW(octreeSetup->setVoxelSize(-1.0), runtime_error); //check invalid input
+
+	CPPUNIT_ASSERT(dynamic_cast<IOctreePartition*>(octreeSetup) != 0);
+	CPPUNIT_ASSERT(dynamic_cast<IOctreeReductionFilter*>(octreeSetup) != 0);
+
+	delete octreeSetup;
+}
+
+void IncrementalOctreeTest::testSizeReduction() {
+	IncrementalOctree octree;
+	PointCloud3D pointCloudResult;
+
+	octree.filter(pointCloudCube, &pointCloudResult); //no filtering involved with standard parameters
+	CPPUNIT_ASSERT_EQUAL(10u, pointCloudResult.getSize());
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize()); //filter() inserts into the map
+	CPPUNIT_ASSERT_EQUAL(10u, pointCloudCube->getSize()); //input size must not change
+
+	octree.setVoxelSize(0.5); // the existing points are sorted into the new leaves; (1,1,0.2) shares a leaf with (1,1,0)
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(9u, octree.getNumberOfLeaves());
+
+	octree.clear();
+	CPPUNIT_ASSERT_EQUAL(0u, octree.getSize());
+	octree.filter(pointCloudCube, &pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(9u, pointCloudResult.getSize());
+	octree.filter(pointCloudCube, &pointCloudResult); //the points are in the map twice, but the occupied leaves are the same
+	CPPUNIT_ASSERT_EQUAL(9u, pointCloudResult.getSize());
+	CPPUNIT_ASSERT_EQUAL(20u, octree.getSize());
+
+	/* the result consists of the leaf centers */
+	bool foundCenter = false;
+	for (unsigned int i = 0; i < pointCloudResult.getSize(); ++i) {
+		Point3D center = (*pointCloudResult.getPointCloud())[i];
+		if (std::abs(center.getX() - 1.25) < maxTolerance && std::abs(center.getY() - 1.25) < maxTolerance && std::abs(center.getZ() - 0.25) < maxTolerance) {
+			foundCenter = true;
+		}
+	}
+	CPPUNIT_ASSERT(foundCenter);
+
+	std::vector<unsigned int> pointCounts;
+	PointCloud3D centers;
+	octree.getVoxelCenters(&centers, &pointCounts);
+	CPPUNIT_ASSERT_EQUAL(9u, centers.getSize());
+	CPPUNIT_ASSERT_EQUAL(9, static_cast<int>(pointCounts.size()));
+	unsigned int totalCount = 0;
+	for (unsigned int i = 0; i < pointCounts.size(); ++i) {
+		totalCount += pointCounts[i];
+	}
+	CPPUNIT_ASSERT_EQUAL(20u, totalCount);
+
+	octree.clear();
+	octree.setVoxelSize(4.0);
+	octree.filter(pointCloudCube, &pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(1u, pointCloudResult.getSize());
+}
+
+void IncrementalOctreeTest::testIncrementalInsertion() {
+	IncrementalOctree octree;
+	octree.setVoxelSize(0.5);
+
+	/* first batch */
+	PointCloud3D firstBatch;
+	for (unsigned int i = 0; i < 5; ++i) {
+		firstBatch.addPoint((*pointCloudCube->getPointCloud())[i]);
+	}
+	octree.insertPoints(&firstBatch);
+	CPPUNIT_ASSERT_EQUAL(5u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(5u, octree.getNumberOfLeaves());
+
+	/* second batch is added to the existing map */
+	PointCloud3D secondBatch;
+	for (unsigned int i = 5; i < pointCloudCube->getSize(); ++i) {
+		secondBatch.addPoint((*pointCloudCube->getPointCloud())[i]);
+	}
+	PointCloud3D pointCloudResult;
+	octree.filter(&secondBatch, &pointCloudResult); //the result is the reduced map, not only the reduced batch
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(9u, pointCloudResult.getSize());
+
+	/* points far away and with negative coordinates let the tree grow */
+	octree.insertPoint(Point3D(-100.2, 50.1, -3.3));
+	octree.insertPoint(Point3D(1000.0, -1000.0, 1000.0));
+	CPPUNIT_ASSERT_EQUAL(12u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(11u, octree.getNumberOfLeaves());
+
+	PointCloud3D centers;
+	octree.getVoxelCenters(&centers);
+	CPPUNIT_ASSERT_EQUAL(11u, centers.getSize());
+	bool foundCenter = false;
+	for (unsigned int i = 0; i < centers.getSize(); ++i) {
+		Point3D center = (*centers.getPointCloud())[i];
+		if (std::abs(center.getX() + 100.25) < maxTolerance && std::abs(center.getY() - 50.25) < maxTolerance && std::abs(center.getZ() + 3.25) < maxTolerance) {
+			foundCenter = true;
+		}
+	}
+	CPPUNIT_ASSERT(foundCenter);
+}
+
+void IncrementalOctreeTest::testRemoval() {
+	IncrementalOctree octree;
+	octree.setVoxelSize(0.5);
+	octree.insertPoints(pointCloudCube);
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize());
+
+	CPPUNIT_ASSERT(octree.removePoint(Point3D(1,1,0.2)));
+	CPPUNIT_ASSERT(!octree.removePoint(Point3D(1,1,0.2))); // already removed
+	CPPUNIT_ASSERT(!octree.removePoint(Point3D(1,1,0.3))); // never inserted
+	CPPUNIT_ASSERT(!octree.removePoint(Point3D(10,10,10))); // outside the map
+	CPPUNIT_ASSERT_EQUAL(9u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(9u, octree.getNumberOfLeaves());
+
+	CPPUNIT_ASSERT(octree.removePoint(Point3D(1,1,0.9)));
+	CPPUNIT_ASSERT_EQUAL(8u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(8u, octree.getNumberOfLeaves()); // the leaf is empty now
+
+	/* remove the lower half of the cube */
+	unsigned int removedPoints = octree.removePointsInBox(Point3D(-1, -1, -1), Point3D(2, 2, 0.5));
+	CPPUNIT_ASSERT_EQUAL(4u, removedPoints);
+	CPPUNIT_ASSERT_EQUAL(4u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(4u, octree.getNumberOfLeaves());
+
+	CPPUNIT_ASSERT_EQUAL(4u, octree.removePoints(pointCloudCube));
+	CPPUNIT_ASSERT_EQUAL(0u, octree.getSize());
+	CPPUNIT_ASSERT_EQUAL(0u, octree.getNumberOfLeaves());
+
+	/* the map can be reused */
+	octree.insertPoints(pointCloudCube);
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize());
+}
+
+void IncrementalOctreeTest::testBoxQuery() {
+	PointCloud3D pointCloud;
+	for (int x = -10; x < 10; ++x) {
+		for (int y = -10; y < 10; ++y) {
+			for (int z = -10; z < 10; ++z) {
+				pointCloud.addPoint(Point3D(x * 0.1 + 0.05, y * 0.1 + 0.05, z * 0.1 + 0.05));
+			}
+		}
+	}
+
+	IncrementalOctree octree;
+	octree.setVoxelSize(0.15);
+	octree.insertPoints(&pointCloud);
+
+	Point3D minCorner(-0.32, -0.5, 0.1);
+	Point3D maxCorner(0.41, 0.2, 0.93);
+	unsigned int expectedCount = 0;
+	for (unsigned int i = 0; i < pointCloud.getSize(); ++i) {
+		Point3D point = (*pointCloud.getPointCloud())[i];
+		if (point.getX() >= minCorner.getX() && point.getX() <= maxCorner.getX() &&
+				point.getY() >= minCorner.getY() && point.getY() <= maxCorner.getY() &&
+				point.getZ() >= minCorner.getZ() && point.getZ() <= maxCorner.getZ()) {
+			expectedCount++;
+		}
+	}
+	CPPUNIT_ASSERT(expectedCount > 0u);
+
+	PointCloud3D pointsInBox;
+	octree.getPointsInBox(minCorner, maxCorner, &pointsInBox);
+	CPPUNIT_ASSERT_EQUAL(expectedCount, pointsInBox.getSize());
+	for (unsigned int i = 0; i < pointsInBox.getSize(); ++i) {
+		Point3D point = (*pointsInBox.getPointCloud())[i];
+		CPPUNIT_ASSERT(point.getX() >= minCorner.getX() && point.getX() <= maxCorner.getX());
+		CPPUNIT_ASSERT(point.getY() >= minCorner.getY() && point.getY() <= maxCorner.getY());
+		CPPUNIT_ASSERT(point.getZ() >= minCorner.getZ() && point.getZ() <= maxCorner.getZ());
+	}
+
+	CPPUNIT_ASSERT_EQUAL(expectedCount, octree.removePointsInBox(minCorner, maxCorner));
+	CPPUNIT_ASSERT_EQUAL(pointCloud.getSize() - expectedCount, octree.getSize());
+	pointsInBox.getPointCloud()->clear();
+	octree.getPointsInBox(minCorner, maxCorner, &pointsInBox);
+	CPPUNIT_ASSERT_EQUAL(0u, pointsInBox.getSize());
+}
+
+void IncrementalOctreeTest::testPartition() {
+	IncrementalOctree octree;
+	vector<PointCloud3D*> partition;
+
+	octree.partitionPointCloud(pointCloudCube, &partition); //only one partition with default parameter 0.0
+	CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(partition.size()));
+	CPPUNIT_ASSERT_EQUAL(10u, partition[0]->getSize());
+	delete partition[0];
+	partition.clear();
+	CPPUNIT_ASSERT_EQUAL(10u, octree.getSize()); //partitionPointCloud() inserts into the map
+
+	octree.setVoxelSize(0.5);
+	octree.getPartition(&partition);
+	CPPUNIT_ASSERT_EQUAL(9, static_cast<int>(partition.size()));
+
+	/* check if total amount of points is "invariant" */
+	unsigned int pointCount = 0;
+	for (unsigned int i = 0; i < partition.size(); ++i) {
+		pointCount += partition[i]->getSize();
+		delete partition[i];
+	}
+	CPPUNIT_ASSERT_EQUAL(10u, pointCount);
+}
+
+}  // namespace unitTests
+
+/* EOF */
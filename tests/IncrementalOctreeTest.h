@@ -0,0 +1,55 @@
+/**
+ * @file 
+ * IncrementalOctreeTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef INCREMENTALOCTREETEST_H_
+#define INCREMENTALOCTREETEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/algorithm/filtering/IncrementalOctree.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class IncrementalOctreeTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( IncrementalOctreeTest );
+	CPPUNIT_TEST( testSetupInterface );
+	CPPUNIT_TEST( testSizeReduction );
+	CPPUNIT_TEST( testIncrementalInsertion );
+	CPPUNIT_TEST( testRemoval );
+	CPPUNIT_TEST( testBoxQuery );
+	CPPUNIT_TEST( testPartition );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testSetupInterface();
+	void testSizeReduction();
+	void testIncrementalInsertion();
+	void testRemoval();
+	void testBoxQuery();
+	void testPartition();
+
+private:
+
+	static const double maxTolerance = 0.00001;
+
+	PointCloud3D* pointCloudCube;
+};
+
+}
+
+#endif /* INCREMENTALOCTREETEST_H_ */
+
+/* EOF */
@@ -76,6 +76,33 @@ void IterativeClosestPointFactoryTest::testUnitTestConfig() {
 
 }
 
+void IterativeClosestPointFactoryTest::testParseResolutionLevels() {
+	std::vector<IIterativeClosestPointSetup::ResolutionLevel> levels;
+
+	CPPUNIT_ASSERT(IterativeClosestPointFactory::parseResolutionLevels("0.2 10 0.001; 0.05 15 0.0001;0 5 0.00001;", &levels));
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(levels.size()));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, levels[0].voxelSize, maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(10, levels[0].maxIterations);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, levels[0].convergenceThreshold, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, levels[1].voxelSize, maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(15, levels[1].maxIterations);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0001, levels[1].convergenceThreshold, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, levels[2].voxelSize, maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(5, levels[2].maxIterations);
+
+	CPPUNIT_ASSERT(IterativeClosestPointFactory::parseResolutionLevels("", &levels));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(levels.size()));
+
+	/* malformed */
+	CPPUNIT_ASSERT(!IterativeClosestPointFactory::parseResolutionLevels("0.2 10", &levels));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(levels.size()));
+	CPPUNIT_ASSERT(!IterativeClosestPointFactory::parseResolutionLevels("0.2 10 0.001 7", &levels));
+	CPPUNIT_ASSERT(!IterativeClosestPointFactory::parseResolutionLevels("0.2 ten 0.001", &levels));
+	CPPUNIT_ASSERT(!IterativeClosestPointFactory::parseResolutionLevels("-0.2 10 0.001", &levels));
+	CPPUNIT_ASSERT(!IterativeClosestPointFactory::parseResolutionLevels("0.2 10 0.001; 0.1 -1 0.001", &levels));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(levels.size()));
+}
+
 }
 
 /* EOF */
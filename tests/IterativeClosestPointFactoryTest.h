@@ -25,6 +25,7 @@ class IterativeClosestPointFactoryTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testConstructor );
 	CPPUNIT_TEST( testDefault );
 	CPPUNIT_TEST( testUnitTestConfig );
+	CPPUNIT_TEST( testParseResolutionLevels );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -34,6 +35,7 @@ public:
 	void testConstructor();
 	void testDefault();
 	void testUnitTestConfig();
+	void testParseResolutionLevels();
 
 private:
 	IterativeClosestPointFactory* icpFactory;
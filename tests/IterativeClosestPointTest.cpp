@@ -11,6 +11,7 @@
 #include <sstream>
 #include <cmath>
 #include <stdexcept>
+#include <cstdlib>
 
 using namespace Eigen;
 
@@ -366,9 +367,136 @@ void IterativeClosestPointTest::testSetupInterface(){
 	convergenceThreshold = -1.0;
 	CPPUNIT_ASSERT_THROW(icpSetup->setConvergenceThreshold(convergenceThreshold), runtime_error);
 
+	/* check resolution levels */
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(icpSetup->getResolutionLevels().size()));
+	std::vector<IIterativeClosestPointSetup::ResolutionLevel> levels;
+	levels.push_back(IIterativeClosestPointSetup::ResolutionLevel(0.2, 10, 0.001));
+	levels.push_back(IIterativeClosestPointSetup::ResolutionLevel(0.0, 5, 0.0001));
+	icpSetup->setResolutionLevels(levels);
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(icpSetup->getResolutionLevels().size()));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, icpSetup->getResolutionLevels()[0].voxelSize, maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(10, icpSetup->getResolutionLevels()[0].maxIterations);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.001, icpSetup->getResolutionLevels()[0].convergenceThreshold, maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, icpSetup->getResolutionLevels()[1].voxelSize, maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(5, icpSetup->getResolutionLevels()[1].maxIterations);
+
+	levels[1].voxelSize = -1.0;
+	CPPUNIT_ASSERT_THROW(icpSetup->setResolutionLevels(levels), runtime_error);
+	levels[1].voxelSize = 0.0;
+	levels[1].maxIterations = -1;
+	CPPUNIT_ASSERT_THROW(icpSetup->setResolutionLevels(levels), runtime_error);
+	levels[1].maxIterations = 5;
+	levels[1].convergenceThreshold = -1.0;
+	CPPUNIT_ASSERT_THROW(icpSetup->setResolutionLevels(levels), runtime_error);
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(icpSetup->getResolutionLevels().size())); // unchanged
+
+	levels.clear();
+	icpSetup->setResolutionLevels(levels);
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(icpSetup->getResolutionLevels().size()));
 
 }
 
+void IterativeClosestPointTest::testCoarseToFineAlignment() {
+	/* randomly sampled corner of a cube (three faces), so the alignment is well constrained */
+	PointCloud3D model;
+	std::srand(0);
+	for (int i = 0; i < 3000; ++i) {
+		double coordinates[3] = {0.0, 0.0, 0.0};
+		coordinates[(i + 1) % 3] = std::rand() / static_cast<double>(RAND_MAX);
+		coordinates[(i + 2) % 3] = std::rand() / static_cast<double>(RAND_MAX);
+		model.addPoint(Point3D(coordinates[0], coordinates[1], coordinates[2]));
+	}
+
+	PointCloud3D data;
+	PointCloud3D dataCopy;
+	for (unsigned int i = 0; i < model.getSize(); ++i) {
+		data.addPoint((*model.getPointCloud())[i]);
+	}
+
+	/* manipulate data */
+	Transform3d transformation;
+	transformation = AngleAxis<double>(M_PI_2/8.0, Vector3d(1,1,0).normalized());
+	transformation.translation() = Vector3d(0.05, -0.03, 0.02);
+	HomogeneousMatrix44 homogeneousTrans(&transformation);
+	data.homogeneousTransformation(&homogeneousTrans);
+	for (unsigned int i = 0; i < data.getSize(); ++i) {
+		dataCopy.addPoint((*data.getPointCloud())[i]);
+	}
+
+	/* coarse-to-fine ICP */
+	icp = new IterativeClosestPoint(new PointCorrespondenceKDTree(), new RigidTransformationEstimationSVD());
+	std::vector<IIterativeClosestPointSetup::ResolutionLevel> levels;
+	levels.push_back(IIterativeClosestPointSetup::ResolutionLevel(0.2, 20, 0.00001));
+	levels.push_back(IIterativeClosestPointSetup::ResolutionLevel(0.1, 20, 0.00001));
+	levels.push_back(IIterativeClosestPointSetup::ResolutionLevel(0.0, 20, 0.0000001));
+	icp->setResolutionLevels(levels);
+
+	HomogeneousMatrix44 resultTransformation;
+	icp->match(&model, &data, &resultTransformation);
+	CPPUNIT_ASSERT(icp->icpresultIterations > 0);
+
+	/* aligned data is the same as the model */
+	for (unsigned int i = 0; i < model.getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getX(), (*data.getPointCloud())[i].getX(), 0.0001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getY(), (*data.getPointCloud())[i].getY(), 0.0001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getZ(), (*data.getPointCloud())[i].getZ(), 0.0001);
+	}
+
+	/* the accumulated transformation covers all levels */
+	dataCopy.homogeneousTransformation(&resultTransformation);
+	for (unsigned int i = 0; i < model.getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*data.getPointCloud())[i].getX(), (*dataCopy.getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*data.getPointCloud())[i].getY(), (*dataCopy.getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*data.getPointCloud())[i].getZ(), (*dataCopy.getPointCloud())[i].getZ(), maxTolerance);
+	}
+}
+
+void IterativeClosestPointTest::testPointToPlaneAlignment() {
+	/* randomly sampled corner of a cube (three faces) */
+	PointCloud3D model;
+	std::srand(0);
+	for (int i = 0; i < 3000; ++i) {
+		double coordinates[3] = {0.0, 0.0, 0.0};
+		coordinates[(i + 1) % 3] = std::rand() / static_cast<double>(RAND_MAX);
+		coordinates[(i + 2) % 3] = std::rand() / static_cast<double>(RAND_MAX);
+		model.addPoint(Point3D(coordinates[0], coordinates[1], coordinates[2]));
+	}
+
+	PointCloud3D data;
+	PointCloud3D dataPointToPoint;
+	for (unsigned int i = 0; i < model.getSize(); ++i) {
+		data.addPoint((*model.getPointCloud())[i]);
+	}
+
+	/* manipulate data */
+	Transform3d transformation;
+	transformation = AngleAxis<double>(M_PI_2/16.0, Vector3d(1,1,0).normalized());
+	transformation.translation() = Vector3d(0.03, -0.02, 0.01);
+	HomogeneousMatrix44 homogeneousTrans(&transformation);
+	data.homogeneousTransformation(&homogeneousTrans);
+	for (unsigned int i = 0; i < data.getSize(); ++i) {
+		dataPointToPoint.addPoint((*data.getPointCloud())[i]);
+	}
+
+	/* point-to-plane ICP, the model normals are estimated by the default normal estimator */
+	icp = new IterativeClosestPoint(new PointCorrespondenceKDTree(), new RigidTransformationEstimationPointToPlane(), 0.0000001, 50);
+	HomogeneousMatrix44 resultTransformation;
+	icp->match(&model, &data, &resultTransformation);
+	int pointToPlaneIterations = icp->icpresultIterations;
+	delete icp;
+
+	for (unsigned int i = 0; i < model.getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getX(), (*data.getPointCloud())[i].getX(), 0.0001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getY(), (*data.getPointCloud())[i].getY(), 0.0001);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*model.getPointCloud())[i].getZ(), (*data.getPointCloud())[i].getZ(), 0.0001);
+	}
+
+	/* point-to-point ICP needs more iterations for the same problem */
+	icp = new IterativeClosestPoint(new PointCorrespondenceKDTree(), new RigidTransformationEstimationSVD(), 0.0000001, 50);
+	icp->match(&model, &dataPointToPoint, &resultTransformation);
+	CPPUNIT_ASSERT(pointToPlaneIterations < icp->icpresultIterations);
+}
+
 }  // namespace unitTests
 
 /* EOF */
@@ -19,6 +19,7 @@
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationQUAT.h"
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationHELIX.h"
 #include "brics_3d/algorithm/registration/RigidTransformationEstimationAPX.h"
+#include "brics_3d/algorithm/registration/RigidTransformationEstimationPointToPlane.h"
 #include "brics_3d/algorithm/registration/IterativeClosestPoint.h"
 
 #include <Eigen/Geometry>
@@ -39,6 +40,8 @@ class IterativeClosestPointTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testSimpleAlignmentAPX );
 	CPPUNIT_TEST( testStatefullInterface );
 	CPPUNIT_TEST( testSetupInterface );
+	CPPUNIT_TEST( testCoarseToFineAlignment );
+	CPPUNIT_TEST( testPointToPlaneAlignment );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -52,6 +55,8 @@ public:
 	void testSimpleAlignmentAPX();
 	void testStatefullInterface();
 	void testSetupInterface();
+	void testCoarseToFineAlignment();
+	void testPointToPlaneAlignment();
 
 	EIGEN_MAKE_ALIGNED_OPERATOR_NEW //Required by Eigen2
 
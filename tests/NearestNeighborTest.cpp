@@ -675,6 +675,205 @@ void NearestNeighborTest::testANNHighDimension() {
 
 }
 
+void NearestNeighborTest::testBatchQueries() {
+	srand(0); // the randomized k-d trees of FLANN depend on it
+	nearestNeigborFLANN = new NearestNeighborFLANN();
+	nearestNeigborSTANN = new NearestNeighborSTANN();
+	nearestNeigborANN = new NearestNeighborANN();
+	INearestPoint3DNeighbor* point3DNeighbors[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+	INearestNeighborSetup* setups[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+
+	vector<int> resultIndices;
+	vector<double> resultDistances;
+	unsigned int k = 4;
+
+	/* query all corners of the cube: every corner has 3 neighbors with distance 1 */
+	for (unsigned int n = 0; n < 3; ++n) {
+		point3DNeighbors[n]->setData(pointCloudCube);
+		setups[n]->setMaxDistance(-1);
+		point3DNeighbors[n]->findNearestNeighbors(pointCloudCube, &resultIndices, &resultDistances, k);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(pointCloudCube->getSize() * k), static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(resultIndices.size(), resultDistances.size());
+		for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), resultIndices[i * k]); // must find the same (index)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, resultDistances[i * k], maxTolerance);
+			for (unsigned int j = 1; j < k; ++j) {
+				CPPUNIT_ASSERT(resultIndices[i * k + j] >= 0);
+				CPPUNIT_ASSERT(resultIndices[i * k + j] != static_cast<int>(i));
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultDistances[i * k + j], maxTolerance);
+			}
+		}
+
+		/* neighbors beyond the maximum distance are marked */
+		setups[n]->setMaxDistance(0.5);
+		point3DNeighbors[n]->findNearestNeighbors(pointCloudCube, &resultIndices, 0, k);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(pointCloudCube->getSize() * k), static_cast<int>(resultIndices.size()));
+		for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), resultIndices[i * k]);
+			for (unsigned int j = 1; j < k; ++j) {
+				CPPUNIT_ASSERT_EQUAL(-1, resultIndices[i * k + j]);
+			}
+		}
+		setups[n]->setMaxDistance(-1);
+
+		CPPUNIT_ASSERT_THROW(point3DNeighbors[n]->findNearestNeighbors(pointCloudCube, &resultIndices, 0, pointCloudCube->getSize() + 1), runtime_error);
+	}
+
+	/* a batch with generic data has to give the same result as single queries */
+	vector< vector<double> > data;
+	for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+		vector<double> tmpElement;
+		tmpElement.push_back((*pointCloudCube->getPointCloud())[i].getX());
+		tmpElement.push_back((*pointCloudCube->getPointCloud())[i].getY());
+		tmpElement.push_back((*pointCloudCube->getPointCloud())[i].getZ());
+		data.push_back(tmpElement);
+	}
+	vector< vector<double> > highDimensionalData;
+	double value = 0.0;
+	for (int i = 0; i < 10; ++i) {
+		vector<double> tmpElement;
+		for (unsigned int j = 0; j < brics_3d::STANNDimension; ++j) {
+			tmpElement.push_back(value);
+			value++;
+		}
+		highDimensionalData.push_back(tmpElement);
+	}
+
+	INearestNeighbor* neighbors[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+	vector< vector<double> >* datasets[] = {&data, &highDimensionalData, &data};
+	vector<int> singleResultIndices;
+	k = 3;
+	for (unsigned int n = 0; n < 3; ++n) {
+		neighbors[n]->setData(datasets[n]);
+		neighbors[n]->findNearestNeighbors(datasets[n], &resultIndices, &resultDistances, k);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(datasets[n]->size() * k), static_cast<int>(resultIndices.size()));
+		for (unsigned int i = 0; i < datasets[n]->size(); ++i) {
+			neighbors[n]->findNearestNeighbors(&(*datasets[n])[i], &singleResultIndices, k);
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(k), static_cast<int>(singleResultIndices.size()));
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), resultIndices[i * k]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, resultDistances[i * k], maxTolerance);
+			for (unsigned int j = 0; j < k; ++j) {
+				CPPUNIT_ASSERT_EQUAL(singleResultIndices[j], resultIndices[i * k + j]);
+			}
+		}
+
+		vector< vector<double> > invalidQueries(1, vector<double>(datasets[n]->front().size() + 1));
+		CPPUNIT_ASSERT_THROW(neighbors[n]->findNearestNeighbors(&invalidQueries, &resultIndices, 0, k), runtime_error);
+	}
+}
+
+void NearestNeighborTest::testDistances() {
+	nearestNeigborFLANN = new NearestNeighborFLANN();
+	nearestNeigborSTANN = new NearestNeighborSTANN();
+	nearestNeigborANN = new NearestNeighborANN();
+	INearestPoint3DNeighbor* point3DNeighbors[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+	INearestNeighborSetup* setups[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+
+	vector<int> resultIndices;
+	vector<double> resultDistances;
+	double expectedDistances[] = {0.0, 1.0, 1.0, 1.0, sqrt(2.0), sqrt(2.0), sqrt(2.0), sqrt(3.0)};
+
+	for (unsigned int n = 0; n < 3; ++n) {
+		point3DNeighbors[n]->setData(pointCloudCube);
+		setups[n]->setMaxDistance(-1);
+		point3DNeighbors[n]->findNearestNeighbors(point000, &resultIndices, &resultDistances, 8);
+		CPPUNIT_ASSERT_EQUAL(8, static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(8, static_cast<int>(resultDistances.size()));
+		CPPUNIT_ASSERT_EQUAL(0, resultIndices[0]);
+		CPPUNIT_ASSERT_EQUAL(6, resultIndices[7]); // point111
+		for (unsigned int i = 0; i < resultDistances.size(); ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedDistances[i], resultDistances[i], maxTolerance);
+		}
+
+		setups[n]->setMaxDistance(1.0); // at border line to 4 neighbors
+		point3DNeighbors[n]->findNearestNeighbors(point000, &resultIndices, &resultDistances, 8);
+		CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(resultDistances.size()));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultDistances[3], maxTolerance);
+		setups[n]->setMaxDistance(-1);
+
+		CPPUNIT_ASSERT_THROW(point3DNeighbors[n]->findNearestNeighbors(point000, &resultIndices, &resultDistances, 9), runtime_error);
+	}
+}
+
+static double pointDistance(const Point3D& first, const Point3D& second) {
+	double dx = first.getX() - second.getX();
+	double dy = first.getY() - second.getY();
+	double dz = first.getZ() - second.getZ();
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void NearestNeighborTest::testRadiusSearch() {
+	nearestNeigborFLANN = new NearestNeighborFLANN();
+	nearestNeigborSTANN = new NearestNeighborSTANN();
+	nearestNeigborANN = new NearestNeighborANN();
+	INearestPoint3DNeighbor* point3DNeighbors[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+	INearestNeighborSetup* setups[] = {nearestNeigborFLANN, nearestNeigborSTANN, nearestNeigborANN};
+
+	vector<int> resultIndices;
+	vector<double> resultDistances;
+
+	/* a regular grid with 10x10x10 points */
+	PointCloud3D grid;
+	for (int x = 0; x < 10; ++x) {
+		for (int y = 0; y < 10; ++y) {
+			for (int z = 0; z < 10; ++z) {
+				grid.addPoint(Point3D(x, y, z));
+			}
+		}
+	}
+	Point3D query(4.2, 5.1, 4.9);
+	double radius = 2.5;
+	int expectedCount = 0;
+	for (unsigned int i = 0; i < grid.getSize(); ++i) {
+		if (pointDistance(query, (*grid.getPointCloud())[i]) <= radius) {
+			expectedCount++;
+		}
+	}
+	CPPUNIT_ASSERT(expectedCount > static_cast<int>(NearestNeighborSTANN::initialRadiusSearchNeighbors)); // force STANN to extend its search
+
+	FLANNParameters exactSearch = nearestNeigborFLANN->getParameters();
+	exactSearch.checks = grid.getSize(); // otherwise FLANN might skip some neighbors in the radius
+	nearestNeigborFLANN->setParameters(exactSearch);
+
+	for (unsigned int n = 0; n < 3; ++n) {
+		point3DNeighbors[n]->setData(pointCloudCube);
+		setups[n]->setMaxDistance(0.1); // has no influence on a radius search
+
+		point3DNeighbors[n]->findNeighborsWithinRadius(point000, 0.5, &resultIndices, &resultDistances);
+		CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(0, resultIndices[0]);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, resultDistances[0], maxTolerance);
+
+		point3DNeighbors[n]->findNeighborsWithinRadius(point000, 1.0, &resultIndices, &resultDistances);
+		CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(resultDistances.size()));
+		CPPUNIT_ASSERT_EQUAL(0, resultIndices[0]);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultDistances[3], maxTolerance);
+
+		point3DNeighbors[n]->findNeighborsWithinRadius(point000, sqrt(2.0) + 0.001, &resultIndices);
+		CPPUNIT_ASSERT_EQUAL(7, static_cast<int>(resultIndices.size()));
+
+		point3DNeighbors[n]->findNeighborsWithinRadius(point000, 2.0, &resultIndices, &resultDistances);
+		CPPUNIT_ASSERT_EQUAL(8, static_cast<int>(resultIndices.size()));
+		CPPUNIT_ASSERT_EQUAL(6, resultIndices[7]); // point111
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(sqrt(3.0), resultDistances[7], maxTolerance);
+		setups[n]->setMaxDistance(-1);
+
+		/* more neighbors than a typical k */
+		point3DNeighbors[n]->setData(&grid);
+		point3DNeighbors[n]->findNeighborsWithinRadius(&query, radius, &resultIndices, &resultDistances);
+		CPPUNIT_ASSERT_EQUAL(expectedCount, static_cast<int>(resultIndices.size()));
+		for (unsigned int i = 0; i < resultIndices.size(); ++i) {
+			CPPUNIT_ASSERT(resultDistances[i] <= radius);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(pointDistance(query, (*grid.getPointCloud())[resultIndices[i]]), resultDistances[i], maxTolerance);
+			if (i > 0) {
+				CPPUNIT_ASSERT(resultDistances[i - 1] <= resultDistances[i]);
+			}
+		}
+	}
+}
+
 }
 
 /* EOF */
@@ -39,6 +39,9 @@ class NearestNeighborTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testANNSimple );
 	CPPUNIT_TEST( testANNExtended );
 	CPPUNIT_TEST( testANNHighDimension );
+	CPPUNIT_TEST( testBatchQueries );
+	CPPUNIT_TEST( testDistances );
+	CPPUNIT_TEST( testRadiusSearch );
 	CPPUNIT_TEST_SUITE_END();
 
 
@@ -58,6 +61,9 @@ public:
 	void testANNSimple();
 	void testANNExtended();
 	void testANNHighDimension();
+	void testBatchQueries();
+	void testDistances();
+	void testRadiusSearch();
 
 private:
 
@@ -0,0 +1,250 @@
+/**
+ * @file 
+ * NormalEstimationTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "NormalEstimationTest.h"
+#include <cstdlib>
+#include <cmath>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( NormalEstimationTest );
+
+void NormalEstimationTest::setUp() {
+	std::srand(0);
+	pointCloud = new PointCloud3D();
+	for (int i = 0; i < 60; ++i) {
+		for (int j = 0; j < 60; ++j) { // jittered grid, so there are no ties between neighbor distances
+			double x = -1.5 + i * 0.05 + 0.02 * std::rand() / static_cast<double>(RAND_MAX);
+			double y = -1.5 + j * 0.05 + 0.02 * std::rand() / static_cast<double>(RAND_MAX);
+			pointCloud->addPoint(Point3D(x, y, 0.3 * (x * x + y * y)));
+		}
+	}
+}
+
+void NormalEstimationTest::tearDown() {
+	delete pointCloud;
+}
+
+void NormalEstimationTest::compareNormals(NormalSet3D* expectedNormals, NormalSet3D* normals, double tolerance) {
+	CPPUNIT_ASSERT_EQUAL(expectedNormals->getSize(), normals->getSize());
+	for (unsigned int i = 0; i < normals->getSize(); ++i) {
+		const Normal3D& expected = (*expectedNormals->getNormals())[i];
+		const Normal3D& normal = (*normals->getNormals())[i];
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getX(), normal.getX(), tolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getY(), normal.getY(), tolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getZ(), normal.getZ(), tolerance);
+	}
+}
+
+void NormalEstimationTest::testSmallestEigenvector() {
+	std::srand(0);
+	double covariance[6];
+	double normal[3];
+
+	/* diagonal matrix */
+	double diagonal[6] = {3.0, 0.0, 0.0, 0.5, 0.0, 2.0};
+	CPPUNIT_ASSERT(ParallelNormalEstimation::computeSmallestEigenvector(diagonal, normal));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal[0], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, fabs(normal[1]), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal[2], maxTolerance);
+
+	/* random covariance matrices compared to the iterative solver */
+	for (int run = 0; run < 100; ++run) {
+		Eigen::Matrix3d points = Eigen::Matrix3d::Zero();
+		for (int i = 0; i < 3; ++i) {
+			for (int j = 0; j < 3; ++j) {
+				points(i, j) = std::rand() / static_cast<double>(RAND_MAX) - 0.5;
+			}
+		}
+		Eigen::Matrix3d matrix = points * points.transpose();
+		covariance[0] = matrix(0, 0);
+		covariance[1] = matrix(0, 1);
+		covariance[2] = matrix(0, 2);
+		covariance[3] = matrix(1, 1);
+		covariance[4] = matrix(1, 2);
+		covariance[5] = matrix(2, 2);
+
+		Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(matrix);
+		Eigen::Vector3d expected = solver.eigenvectors().col(0);
+		CPPUNIT_ASSERT(ParallelNormalEstimation::computeSmallestEigenvector(covariance, normal));
+		double sign = (expected[0] * normal[0] + expected[1] * normal[1] + expected[2] * normal[2] < 0) ? -1.0 : 1.0;
+		for (int i = 0; i < 3; ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], sign * normal[i], 0.0001);
+		}
+	}
+
+	/* points on a line: any direction orthogonal to the line */
+	double line[6] = {1.0, 1.0, 0.0, 1.0, 0.0, 0.0};
+	CPPUNIT_ASSERT(ParallelNormalEstimation::computeSmallestEigenvector(line, normal));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal[0] + normal[1], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]), maxTolerance);
+
+	/* degenerated */
+	double zero[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	CPPUNIT_ASSERT(!ParallelNormalEstimation::computeSmallestEigenvector(zero, normal));
+}
+
+void NormalEstimationTest::testPlaneNormals() {
+	PointCloud3D plane;
+	for (int i = 0; i < 20; ++i) {
+		for (int j = 0; j < 20; ++j) {
+			plane.addPoint(Point3D(1000.0 + i * 0.01, -500.0 + j * 0.01, 0.5 * i * 0.01 + 2000.0)); // far away from the origin
+		}
+	}
+	plane.addPoint(Point3D(std::numeric_limits<double>::quiet_NaN(), 0, 0));
+
+	NearestNeighborSTANN nearestNeighborSearch;
+	ParallelNormalEstimation normalEstimator;
+	CPPUNIT_ASSERT_EQUAL(10u, normalEstimator.getkNeighbors());
+	normalEstimator.setSearchMethod(&nearestNeighborSearch);
+	normalEstimator.setViewPoint(1000.0, -500.0, 3000.0);
+
+	NormalSet3D normals;
+	normals.addNormal(Normal3D(1, 2, 3)); // previous content is replaced
+	normalEstimator.estimateNormals(&plane, &normals);
+	CPPUNIT_ASSERT_EQUAL(plane.getSize(), normals.getSize());
+
+	double length = sqrt(0.5 * 0.5 + 1.0);
+	for (unsigned int i = 0; i < plane.getSize() - 1; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(-0.5 / length, (*normals.getNormals())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, (*normals.getNormals())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0 / length, (*normals.getNormals())[i].getZ(), maxTolerance);
+	}
+	double lastX = (*normals.getNormals())[plane.getSize() - 1].getX();
+	CPPUNIT_ASSERT(lastX != lastX); // NaN
+}
+
+void NormalEstimationTest::testParallelNormalEstimation() {
+	/* reference */
+	NearestNeighborSTANN referenceSearch;
+	NormalEstimation referenceEstimator;
+	referenceEstimator.setInputCloud(pointCloud);
+	referenceEstimator.setSearchMethod(&referenceSearch);
+	referenceEstimator.setViewPoint(0, 0, 10);
+	NormalSet3D referenceNormals;
+	referenceEstimator.estimateNormals(pointCloud, &referenceNormals);
+	CPPUNIT_ASSERT_EQUAL(pointCloud->getSize(), referenceNormals.getSize());
+	CPPUNIT_ASSERT((*referenceNormals.getNormals())[0].getZ() > 0);
+
+	ParallelNormalEstimation normalEstimator;
+	normalEstimator.setViewPoint(0, 0, 10);
+	NormalSet3D normals;
+
+	/* serial */
+	NearestNeighborSTANN nearestNeighborSearch;
+	normalEstimator.setSearchMethod(&nearestNeighborSearch);
+	CPPUNIT_ASSERT_EQUAL(1u, normalEstimator.getNumberOfThreads());
+	normalEstimator.estimateNormals(pointCloud, &normals);
+	compareNormals(&referenceNormals, &normals, maxTolerance);
+
+	/* multiple threads; the STANN queries are serialized */
+	CPPUNIT_ASSERT(!nearestNeighborSearch.supportsConcurrentQueries());
+	normalEstimator.setNumberOfThreads(4);
+	normalEstimator.estimateNormals(pointCloud, &normals);
+	compareNormals(&referenceNormals, &normals, maxTolerance);
+
+	/* serial queries, parallel normal computation */
+	NearestNeighborANN serialSearch;
+	CPPUNIT_ASSERT(!serialSearch.supportsConcurrentQueries());
+	normalEstimator.setSearchMethod(&serialSearch);
+	normalEstimator.estimateNormals(pointCloud, &normals);
+	compareNormals(&referenceNormals, &normals, maxTolerance);
+}
+
+void NormalEstimationTest::testIntegralImageNormalEstimation() {
+	/* tilted plane y = 1 + 0.5 * (x - 100), far from the origin, every 7th pixel without measurement */
+	const unsigned int width = 320;
+	const unsigned int height = 240;
+	OrganizedPointCloud3D organizedCloud(width, height);
+	for (unsigned int row = 0; row < height; ++row) {
+		for (unsigned int col = 0; col < width; ++col) {
+			if ((row * width + col) % 7 == 3) {
+				continue;
+			}
+			double x = 100.0 + col * 0.01;
+			organizedCloud.setPoint(row, col, x, 1.0 + 0.5 * (x - 100.0), 1.0 - row * 0.01);
+		}
+	}
+
+	IntegralImageNormalEstimation normalEstimator;
+	CPPUNIT_ASSERT_EQUAL(3u, normalEstimator.getWindowRadius());
+	CPPUNIT_ASSERT_EQUAL(3u, normalEstimator.getMinNeighbors());
+	normalEstimator.setViewPoint(100.0, 0.0, 0.0);
+	NormalSet3D normals;
+	normalEstimator.estimateNormals(&organizedCloud, &normals);
+	CPPUNIT_ASSERT_EQUAL(width * height, normals.getSize());
+
+	double length = sqrt(1.25);
+	for (unsigned int i = 0; i < width * height; ++i) {
+		const Normal3D& normal = (*normals.getNormals())[i];
+		if (!organizedCloud.isValid(i)) {
+			CPPUNIT_ASSERT(normal.getX() != normal.getX()); // NaN
+			continue;
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5 / length, normal.getX(), maxTolerance); // flipped towards the viewpoint
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0 / length, normal.getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal.getZ(), maxTolerance);
+	}
+
+	/* the same normals with several threads and another window size */
+	normalEstimator.setWindowRadius(1);
+	normalEstimator.estimateNormals(&organizedCloud, &normals);
+	NormalSet3D parallelNormals;
+	normalEstimator.setNumberOfThreads(4);
+	normalEstimator.estimateNormals(&organizedCloud, &parallelNormals);
+	CPPUNIT_ASSERT_EQUAL(normals.getSize(), parallelNormals.getSize());
+	for (unsigned int i = 0; i < width * height; ++i) {
+		if (organizedCloud.isValid(i)) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL((*normals.getNormals())[i].getX(), (*parallelNormals.getNormals())[i].getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL((*normals.getNormals())[i].getY(), (*parallelNormals.getNormals())[i].getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL((*normals.getNormals())[i].getZ(), (*parallelNormals.getNormals())[i].getZ(), maxTolerance);
+		}
+	}
+
+	/* too few valid neighbors */
+	OrganizedPointCloud3D sparseCloud(5, 5);
+	sparseCloud.setPoint(0, 0, 0.0, 1.0, 0.0);
+	sparseCloud.setPoint(0, 1, 0.1, 1.0, 0.0);
+	sparseCloud.setPoint(4, 4, 0.4, 1.0, -0.4);
+	normalEstimator.estimateNormals(&sparseCloud, &normals);
+	CPPUNIT_ASSERT_EQUAL(25u, normals.getSize());
+	CPPUNIT_ASSERT((*normals.getNormals())[0].getX() != (*normals.getNormals())[0].getX());
+	CPPUNIT_ASSERT((*normals.getNormals())[24].getX() != (*normals.getNormals())[24].getX());
+
+	/* two parallel planes with a depth step between the columns 19 and 20 */
+	OrganizedPointCloud3D steppedCloud(40, 20);
+	for (unsigned int row = 0; row < 20; ++row) {
+		for (unsigned int col = 0; col < 40; ++col) {
+			steppedCloud.setPoint(row, col, col * 0.01, row * 0.01, (col < 20) ? 1.0 : 2.0);
+		}
+	}
+	IntegralImageNormalEstimation stepEstimator;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.05, stepEstimator.getMaxDepthChangeFactor(), maxTolerance);
+	stepEstimator.estimateNormals(&steppedCloud, &normals);
+	for (unsigned int row = 0; row < 20; ++row) {
+		for (unsigned int col = 0; col < 40; ++col) {
+			const Normal3D& normal = (*normals.getNormals())[steppedCloud.getIndex(row, col)];
+			if (col == 19 || col == 20) { // directly at the step
+				CPPUNIT_ASSERT(normal.getX() != normal.getX());
+				continue;
+			}
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, normal.getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, normal.getZ(), maxTolerance);
+		}
+	}
+
+	/* without the check the windows next to the step cover both planes */
+	stepEstimator.setMaxDepthChangeFactor(0.0);
+	stepEstimator.estimateNormals(&steppedCloud, &normals);
+	CPPUNIT_ASSERT(fabs((*normals.getNormals())[steppedCloud.getIndex(10, 18)].getX()) > 0.1);
+}
+
+}
+
+/* EOF */
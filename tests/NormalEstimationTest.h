@@ -0,0 +1,61 @@
+/**
+ * @file 
+ * NormalEstimationTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef NORMALESTIMATIONTEST_H_
+#define NORMALESTIMATIONTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/NormalSet3D.h"
+#include "brics_3d/algorithm/featureExtraction/NormalEstimation.h"
+#include "brics_3d/algorithm/featureExtraction/ParallelNormalEstimation.h"
+#include "brics_3d/algorithm/featureExtraction/IntegralImageNormalEstimation.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborSTANN.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborANN.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class NormalEstimationTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( NormalEstimationTest );
+	CPPUNIT_TEST( testSmallestEigenvector );
+	CPPUNIT_TEST( testPlaneNormals );
+	CPPUNIT_TEST( testParallelNormalEstimation );
+	CPPUNIT_TEST( testIntegralImageNormalEstimation );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testSmallestEigenvector();
+	void testPlaneNormals();
+	void testParallelNormalEstimation();
+	void testIntegralImageNormalEstimation();
+
+private:
+
+	/// Compare two normal sets. Both sets have to be oriented consistently.
+	static void compareNormals(NormalSet3D* expectedNormals, NormalSet3D* normals, double tolerance);
+
+	static const double maxTolerance = 0.00001;
+
+	/// Points on a paraboloid, viewed from above.
+	PointCloud3D* pointCloud;
+};
+
+}
+
+#endif /* NORMALESTIMATIONTEST_H_ */
+
+/* EOF */
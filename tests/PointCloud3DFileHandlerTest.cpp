@@ -0,0 +1,218 @@
+/**
+ * @file 
+ * PointCloud3DFileHandlerTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "PointCloud3DFileHandlerTest.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace unitTests {
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( PointCloud3DFileHandlerTest );
+
+void PointCloud3DFileHandlerTest::setUp() {
+	plyFilename = "pointCloud3DFileHandlerTest.ply";
+	pcdFilename = "pointCloud3DFileHandlerTest.pcd";
+
+	pointCloud = new PointCloud3D();
+	pointCloud->addPoint(Point3D(0,0,0));
+	pointCloud->addPoint(Point3D(1.5,-2.25,3.125));
+	pointCloud->addPoint(Point3D(-100.5,200.25,-300.125));
+	pointCloud->addPoint(Point3D(0.001,0.002,0.003));
+	pointCloud->addPoint(Point3D(0.5,0.5,0.5));
+
+	decoratedPointCloud = new PointCloud3D();
+	decoratedPointCloud->addPointPtr(new Point3DNormal(new ColoredPoint3D(new Point3D(1,2,3), 255, 128, 0), Normal3D(0,0,1)));
+	decoratedPointCloud->addPointPtr(new Point3DNormal(new ColoredPoint3D(new Point3D(4,5,6), 0, 1, 2), Normal3D(1,0,0)));
+	decoratedPointCloud->addPointPtr(new Point3DNormal(new ColoredPoint3D(new Point3D(-7,-8,-9), 10, 20, 30), Normal3D(0,-1,0)));
+}
+
+void PointCloud3DFileHandlerTest::tearDown() {
+	delete pointCloud;
+	delete decoratedPointCloud;
+	std::remove(plyFilename.c_str());
+	std::remove(pcdFilename.c_str());
+}
+
+void PointCloud3DFileHandlerTest::comparePointClouds(PointCloud3D* expected, PointCloud3D* actual) {
+	CPPUNIT_ASSERT_EQUAL(expected->getSize(), actual->getSize());
+	for (unsigned int i = 0; i < expected->getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*expected->getPointCloud())[i].getX(), (*actual->getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*expected->getPointCloud())[i].getY(), (*actual->getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*expected->getPointCloud())[i].getZ(), (*actual->getPointCloud())[i].getZ(), maxTolerance);
+	}
+}
+
+void PointCloud3DFileHandlerTest::testPlyRoundTrip() {
+	PointCloud3DFileHandler fileHandler;
+
+	PointCloud3D binaryResult;
+	fileHandler.storeToPlyFile(plyFilename, pointCloud);
+	fileHandler.readFromPlyFile(plyFilename, &binaryResult);
+	comparePointClouds(pointCloud, &binaryResult);
+	CPPUNIT_ASSERT((*binaryResult.getPointCloud())[0].asColoredPoint3D() == 0); // no decorations
+	CPPUNIT_ASSERT(getPointType<Point3DNormal>(&(*binaryResult.getPointCloud())[0]) == 0);
+
+	PointCloud3D asciiResult;
+	fileHandler.storeToPlyFile(plyFilename, pointCloud, PointCloud3DFileHandler::ascii);
+	fileHandler.readFromPlyFile(plyFilename, &asciiResult);
+	comparePointClouds(pointCloud, &asciiResult);
+
+	/* points are appended */
+	fileHandler.readFromPlyFile(plyFilename, &asciiResult);
+	CPPUNIT_ASSERT_EQUAL(2 * pointCloud->getSize(), asciiResult.getSize());
+
+	/* empty cloud */
+	PointCloud3D emptyPointCloud;
+	PointCloud3D emptyResult;
+	fileHandler.storeToPlyFile(plyFilename, &emptyPointCloud);
+	fileHandler.readFromPlyFile(plyFilename, &emptyResult);
+	CPPUNIT_ASSERT_EQUAL(0u, emptyResult.getSize());
+}
+
+void PointCloud3DFileHandlerTest::testPcdRoundTrip() {
+	PointCloud3DFileHandler fileHandler;
+
+	PointCloud3D binaryResult;
+	fileHandler.storeToPcdFile(pcdFilename, pointCloud);
+	fileHandler.readFromPcdFile(pcdFilename, &binaryResult);
+	comparePointClouds(pointCloud, &binaryResult);
+
+	PointCloud3D asciiResult;
+	fileHandler.storeToPcdFile(pcdFilename, pointCloud, PointCloud3DFileHandler::ascii);
+	fileHandler.readFromPcdFile(pcdFilename, &asciiResult);
+	comparePointClouds(pointCloud, &asciiResult);
+}
+
+void PointCloud3DFileHandlerTest::testDecorations() {
+	PointCloud3DFileHandler fileHandler;
+	PointCloud3D results[4];
+	fileHandler.storeToPlyFile(plyFilename, decoratedPointCloud);
+	fileHandler.readFromPlyFile(plyFilename, &results[0]);
+	fileHandler.storeToPlyFile(plyFilename, decoratedPointCloud, PointCloud3DFileHandler::ascii);
+	fileHandler.readFromPlyFile(plyFilename, &results[1]);
+	fileHandler.storeToPcdFile(pcdFilename, decoratedPointCloud);
+	fileHandler.readFromPcdFile(pcdFilename, &results[2]);
+	fileHandler.storeToPcdFile(pcdFilename, decoratedPointCloud, PointCloud3DFileHandler::ascii);
+	fileHandler.readFromPcdFile(pcdFilename, &results[3]);
+
+	for (int r = 0; r < 4; ++r) {
+		comparePointClouds(decoratedPointCloud, &results[r]);
+		for (unsigned int i = 0; i < decoratedPointCloud->getSize(); ++i) {
+			Point3D* expectedPoint = &(*decoratedPointCloud->getPointCloud())[i];
+			Point3D* resultPoint = &(*results[r].getPointCloud())[i];
+
+			ColoredPoint3D* expectedColor = expectedPoint->asColoredPoint3D();
+			ColoredPoint3D* resultColor = resultPoint->asColoredPoint3D();
+			CPPUNIT_ASSERT(resultColor != 0);
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(expectedColor->getR()), static_cast<int>(resultColor->getR()));
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(expectedColor->getG()), static_cast<int>(resultColor->getG()));
+			CPPUNIT_ASSERT_EQUAL(static_cast<int>(expectedColor->getB()), static_cast<int>(resultColor->getB()));
+
+			Point3DNormal* resultNormal = getPointType<Point3DNormal>(resultPoint);
+			CPPUNIT_ASSERT(resultNormal != 0);
+			Normal3D expectedNormal = getPointType<Point3DNormal>(expectedPoint)->getNormal();
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedNormal.getX(), resultNormal->getNormal().getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedNormal.getY(), resultNormal->getNormal().getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedNormal.getZ(), resultNormal->getNormal().getZ(), maxTolerance);
+		}
+	}
+}
+
+void PointCloud3DFileHandlerTest::testForeignFiles() {
+	PointCloud3DFileHandler fileHandler;
+
+	/* big endian binary PLY with double coordinates, a face element and an additional property */
+	std::ofstream plyFile(plyFilename.c_str(), std::ios::out | std::ios::binary);
+	plyFile << "ply\r\nformat binary_big_endian 1.0\r\ncomment some tool\r\nelement vertex 2\r\n"
+			<< "property double x\r\nproperty double y\r\nproperty double z\r\nproperty float confidence\r\n"
+			<< "element face 1\r\nproperty list uchar int vertex_indices\r\nend_header\r\n";
+	double coordinates[] = {1.0, 2.0, 3.0, -4.0, -5.0, -6.0};
+	for (int i = 0; i < 6; ++i) {
+		unsigned char bytes[8];
+		memcpy(bytes, &coordinates[i], 8);
+		const unsigned short probe = 1;
+		if (*reinterpret_cast<const unsigned char*>(&probe) == 1) { // little endian host
+			std::reverse(bytes, bytes + 8);
+		}
+		plyFile.write(reinterpret_cast<char*>(bytes), 8);
+		if (i % 3 == 2) {
+			plyFile.write("\0\0\0\0", 4); // confidence
+		}
+	}
+	plyFile.close();
+
+	PointCloud3D plyResult;
+	fileHandler.readFromPlyFile(plyFilename, &plyResult);
+	CPPUNIT_ASSERT_EQUAL(2u, plyResult.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, (*plyResult.getPointCloud())[0].getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, (*plyResult.getPointCloud())[0].getZ(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-5.0, (*plyResult.getPointCloud())[1].getY(), maxTolerance);
+
+	/* organized ASCII PCD with invalid points and a field with several elements */
+	std::ofstream pcdFile(pcdFilename.c_str());
+	pcdFile << "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\nFIELDS x y z histogram\n"
+			<< "SIZE 4 4 4 4\nTYPE F F F F\nCOUNT 1 1 1 2\nWIDTH 2\nHEIGHT 2\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS 4\nDATA ascii\n"
+			<< "1 2 3 0 0\nnan nan nan 0 0\n4 5 6 0 0\nnan nan nan 0 0\n";
+	pcdFile.close();
+
+	PointCloud3D pcdResult;
+	fileHandler.readFromPcdFile(pcdFilename, &pcdResult);
+	CPPUNIT_ASSERT_EQUAL(2u, pcdResult.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, (*pcdResult.getPointCloud())[1].getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, (*pcdResult.getPointCloud())[1].getZ(), maxTolerance);
+}
+
+void PointCloud3DFileHandlerTest::testInvalidFiles() {
+	PointCloud3DFileHandler fileHandler;
+	PointCloud3D result;
+
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPlyFile("/this/file/does/not/exist.ply", &result), runtime_error);
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPcdFile("/this/file/does/not/exist.pcd", &result), runtime_error);
+
+	/* truncated binary data */
+	fileHandler.storeToPlyFile(plyFilename, pointCloud);
+	std::ifstream inputFile(plyFilename.c_str(), std::ios::in | std::ios::binary);
+	std::string content((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+	inputFile.close();
+	std::ofstream truncatedFile(plyFilename.c_str(), std::ios::out | std::ios::binary);
+	truncatedFile << content.substr(0, content.size() - 5);
+	truncatedFile.close();
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPlyFile(plyFilename, &result), runtime_error);
+
+	/* compressed PCD */
+	std::ofstream pcdFile(pcdFilename.c_str());
+	pcdFile << "VERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\nWIDTH 1\nHEIGHT 1\nPOINTS 1\nDATA binary_compressed\n";
+	pcdFile.close();
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPcdFile(pcdFilename, &result), runtime_error);
+
+	/* record size that overflows 32 bit, and a point count that exceeds the data */
+	pcdFile.open(pcdFilename.c_str());
+	pcdFile << "VERSION 0.7\nFIELDS x y z histogram\nSIZE 4 4 4 8\nTYPE F F F F\nCOUNT 1 1 1 536870912\nWIDTH 1\nHEIGHT 1\nPOINTS 1\nDATA binary\n"
+			<< "0123456789abcdef0123456789abcdef";
+	pcdFile.close();
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPcdFile(pcdFilename, &result), runtime_error);
+	pcdFile.open(pcdFilename.c_str());
+	pcdFile << "VERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\nWIDTH 4000000000\nHEIGHT 1\nPOINTS 4000000000\nDATA ascii\n1 2 3\n";
+	pcdFile.close();
+	PointCloud3D partialResult; // the records in front of the truncation are kept
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPcdFile(pcdFilename, &partialResult), runtime_error);
+
+	/* not a PLY file */
+	CPPUNIT_ASSERT_THROW(fileHandler.readFromPlyFile(pcdFilename, &result), runtime_error);
+	CPPUNIT_ASSERT_EQUAL(0u, result.getSize());
+}
+
+}
+
+/* EOF */
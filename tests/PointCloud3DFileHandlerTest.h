@@ -0,0 +1,62 @@
+/**
+ * @file 
+ * PointCloud3DFileHandlerTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef POINTCLOUD3DFILEHANDLERTEST_H_
+#define POINTCLOUD3DFILEHANDLERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/PointCloud3DFileHandler.h"
+#include "brics_3d/core/ColoredPoint3D.h"
+#include "brics_3d/core/Point3DNormal.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class PointCloud3DFileHandlerTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( PointCloud3DFileHandlerTest );
+	CPPUNIT_TEST( testPlyRoundTrip );
+	CPPUNIT_TEST( testPcdRoundTrip );
+	CPPUNIT_TEST( testDecorations );
+	CPPUNIT_TEST( testForeignFiles );
+	CPPUNIT_TEST( testInvalidFiles );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testPlyRoundTrip();
+	void testPcdRoundTrip();
+	void testDecorations();
+	void testForeignFiles();
+	void testInvalidFiles();
+
+private:
+
+	/// Compare the coordinates of two point clouds.
+	void comparePointClouds(PointCloud3D* expected, PointCloud3D* actual);
+
+	static const double maxTolerance = 0.00001;
+
+	PointCloud3D* pointCloud;
+	PointCloud3D* decoratedPointCloud;
+	string plyFilename;
+	string pcdFilename;
+};
+
+}
+
+#endif /* POINTCLOUD3DFILEHANDLERTEST_H_ */
+
+/* EOF */
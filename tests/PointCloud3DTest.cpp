@@ -274,6 +274,250 @@ void PointCloud3DTest::testTransformation() {
 	delete homogeneousTransformation;
 }
 
+void PointCloud3DTest::testStructureOfArrays() {
+	PointCloud3DSoA<> soaCloud(pointCloudCube);
+	CPPUNIT_ASSERT_EQUAL(8u, soaCloud.getSize());
+
+	/* check raw arrays against the original cloud */
+	const Coordinate* x = soaCloud.getXCoordinates();
+	const Coordinate* y = soaCloud.getYCoordinates();
+	const Coordinate* z = soaCloud.getZCoordinates();
+	for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), x[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), y[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), z[i], maxTolerance);
+	}
+
+	/* float precision */
+	PointCloud3DSoA<float> soaFloatCloud;
+	CPPUNIT_ASSERT_EQUAL(0u, soaFloatCloud.getSize());
+	CPPUNIT_ASSERT(soaFloatCloud.getXCoordinates() == 0);
+	soaFloatCloud.copyFrom(pointCloudCube);
+	CPPUNIT_ASSERT_EQUAL(8u, soaFloatCloud.getSize());
+	soaFloatCloud.addPoint(Point3D(1.5, 2.5, 3.5));
+	CPPUNIT_ASSERT_EQUAL(9u, soaFloatCloud.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, soaFloatCloud.getPoint(8).getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, soaFloatCloud.getPoint(8).getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.5, soaFloatCloud.getPoint(8).getZ(), maxTolerance);
+
+	/* bulk transformation has to match the per point transformation */
+	AngleAxis<double> rotation(M_PI_2, Vector3d(1,0,0));
+	transformation = rotation;
+	transformation.translation() = Vector3d(1,2,3);
+	IHomogeneousMatrix44 *homogeneousTransformation = new HomogeneousMatrix44(&transformation);
+
+	soaCloud.homogeneousTransformation(homogeneousTransformation);
+	pointCloudCube->homogeneousTransformation(homogeneousTransformation);
+	for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), x[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), y[i], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), z[i], maxTolerance);
+	}
+
+	/* convert back */
+	pointCloudCubeCopy = new PointCloud3D();
+	soaCloud.copyTo(pointCloudCubeCopy);
+	CPPUNIT_ASSERT_EQUAL(8u, pointCloudCubeCopy->getSize());
+	for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), (*pointCloudCubeCopy->getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), (*pointCloudCubeCopy->getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), (*pointCloudCubeCopy->getPointCloud())[i].getZ(), maxTolerance);
+	}
+	delete pointCloudCubeCopy;
+	pointCloudCubeCopy = 0;
+
+	soaCloud.clear();
+	CPPUNIT_ASSERT_EQUAL(0u, soaCloud.getSize());
+
+	delete homogeneousTransformation;
+}
+
+void PointCloud3DTest::testPackedCoordinates() {
+	PointCloud3D::PackedCoordinatesConstPtr packed = pointCloudCube->getPackedCoordinates();
+	CPPUNIT_ASSERT(packed != 0);
+	CPPUNIT_ASSERT_EQUAL(24u, static_cast<unsigned int>(packed->size()));
+
+	PointCloud3D::PackedFloatCoordinatesConstPtr packedFloat = pointCloudCube->getPackedFloatCoordinates();
+	CPPUNIT_ASSERT_EQUAL(24u, static_cast<unsigned int>(packedFloat->size()));
+
+	for (unsigned int i = 0; i < pointCloudCube->getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), (*packed)[3*i + 0], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), (*packed)[3*i + 1], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), (*packed)[3*i + 2], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), (*packedFloat)[3*i + 0], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), (*packedFloat)[3*i + 1], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), (*packedFloat)[3*i + 2], maxTolerance);
+	}
+
+	/* as long as the cloud is not modified the same buffer is returned */
+	packed = pointCloudCube->getPackedCoordinates();
+	CPPUNIT_ASSERT(packed == pointCloudCube->getPackedCoordinates());
+
+	/* read-only access keeps the cache */
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((*packed)[3], (*pointCloudCube->getConstPointCloud())[1].getX(), maxTolerance);
+	CPPUNIT_ASSERT_EQUAL(8u, static_cast<unsigned int>(pointCloudCube->getConstPointCloud()->size()));
+	CPPUNIT_ASSERT(packed == pointCloudCube->getPackedCoordinates());
+
+	/* modifications via a pointer that has been retrieved before have to be announced */
+	boost::ptr_vector<Point3D>* points = pointCloudCube->getPointCloud();
+	packed = pointCloudCube->getPackedCoordinates();
+	(*points)[0].setX(-5.0);
+	CPPUNIT_ASSERT(packed == pointCloudCube->getPackedCoordinates());
+	pointCloudCube->invalidatePackedCoordinates();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-5.0, (*pointCloudCube->getPackedCoordinates())[0], maxTolerance);
+	packed = pointCloudCube->getPackedCoordinates();
+
+	/* modifications invalidate the cache, but old buffers stay valid */
+	pointCloudCube->addPoint(Point3D(2, 3, 4));
+	PointCloud3D::PackedCoordinatesConstPtr updatedPacked = pointCloudCube->getPackedCoordinates();
+	CPPUNIT_ASSERT(packed != updatedPacked);
+	CPPUNIT_ASSERT_EQUAL(24u, static_cast<unsigned int>(packed->size()));
+	CPPUNIT_ASSERT_EQUAL(27u, static_cast<unsigned int>(updatedPacked->size()));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, (*updatedPacked)[24], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, (*updatedPacked)[25], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, (*updatedPacked)[26], maxTolerance);
+
+	IHomogeneousMatrix44 *homogeneousTransformation = new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 1,0,0);
+	pointCloudCube->homogeneousTransformation(homogeneousTransformation);
+	packed = pointCloudCube->getPackedCoordinates();
+	CPPUNIT_ASSERT(packed != updatedPacked);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, (*packed)[24], maxTolerance);
+
+	pointCloudCube->getPointCloud()->clear();
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(pointCloudCube->getPackedCoordinates()->size()));
+
+	delete homogeneousTransformation;
+}
+
+void PointCloud3DTest::testBulkTransformation() {
+
+	/* rotation about an arbitrary axis and a translation */
+	AngleAxis<double> rotation(0.7, Vector3d(1,2,3).normalized());
+	transformation = rotation;
+	transformation.translation() = Vector3d(-1.5, 2.0, 10.0);
+	HomogeneousMatrix44 homogeneousTransformation(&transformation);
+
+	/* large enough to be split among several threads */
+	const unsigned int numberOfPoints = 3 * HomogeneousTransformationKernel::minPointsPerThread;
+	PointCloud3D pointCloud;
+	std::vector<Point3D> referencePoints;
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		Point3D point(i * 0.01, -0.5 * i, (i % 100) - 50.0);
+		if (i % 1000 == 0) { // some decorated points
+			pointCloud.addPointPtr(new ColoredPoint3D(new Point3D(point), 1, 2, 3));
+		} else {
+			pointCloud.addPoint(point);
+		}
+		point.homogeneousTransformation(&homogeneousTransformation); // reference: per point path
+		referencePoints.push_back(point);
+	}
+
+	pointCloud.homogeneousTransformation(&homogeneousTransformation, 4);
+	CPPUNIT_ASSERT_EQUAL(numberOfPoints, pointCloud.getSize());
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getX(), (*pointCloud.getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getY(), (*pointCloud.getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getZ(), (*pointCloud.getPointCloud())[i].getZ(), maxTolerance);
+	}
+
+	/* decorations are preserved */
+	ColoredPoint3D* decoratedPoint = dynamic_cast<ColoredPoint3D*>(&(*pointCloud.getPointCloud())[1000]);
+	CPPUNIT_ASSERT(decoratedPoint != 0);
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(1), decoratedPoint->getR());
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(3), decoratedPoint->getB());
+
+	/* packed coordinates */
+	HomogeneousTransformationKernel kernel(&homogeneousTransformation);
+	kernel.setNumberOfThreads(0);
+	CPPUNIT_ASSERT(kernel.getNumberOfThreads() >= 1u);
+	std::vector<Coordinate> packedCoordinates(3 * numberOfPoints);
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		packedCoordinates[3 * i + 0] = i * 0.01;
+		packedCoordinates[3 * i + 1] = -0.5 * i;
+		packedCoordinates[3 * i + 2] = (i % 100) - 50.0;
+	}
+	kernel.transformPackedCoordinates(&packedCoordinates[0], numberOfPoints);
+	for (unsigned int i = 0; i < numberOfPoints; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getX(), packedCoordinates[3 * i + 0], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getY(), packedCoordinates[3 * i + 1], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referencePoints[i].getZ(), packedCoordinates[3 * i + 2], maxTolerance);
+	}
+
+	/* contiguous array of points; the inverse transformation yields the original points */
+	Transform3d inverse = transformation.inverse();
+	HomogeneousMatrix44 inverseHomogeneousTransformation(&inverse);
+	HomogeneousTransformationKernel inverseKernel(&inverseHomogeneousTransformation);
+	inverseKernel.transformPoints(&referencePoints[0], numberOfPoints);
+	for (unsigned int i = 0; i < numberOfPoints; i += 97) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(i * 0.01, referencePoints[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(-0.5 * i, referencePoints[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((i % 100) - 50.0, referencePoints[i].getZ(), maxTolerance);
+	}
+}
+
+void PointCloud3DTest::testOrganizedPointCloud() {
+	OrganizedPointCloud3D organizedCloud(4, 3);
+	CPPUNIT_ASSERT_EQUAL(4u, organizedCloud.getWidth());
+	CPPUNIT_ASSERT_EQUAL(3u, organizedCloud.getHeight());
+	CPPUNIT_ASSERT_EQUAL(12u, organizedCloud.getSize());
+	CPPUNIT_ASSERT_EQUAL(0u, organizedCloud.getNumberOfValidPoints());
+	CPPUNIT_ASSERT(!organizedCloud.isValid(1, 2));
+	Point3D invalidPoint = organizedCloud.getPoint(1, 2);
+	CPPUNIT_ASSERT(invalidPoint.getX() != invalidPoint.getX()); // NaN
+
+	/* all pixels valid except (1, 1) */
+	for (unsigned int row = 0; row < 3; ++row) {
+		for (unsigned int col = 0; col < 4; ++col) {
+			organizedCloud.setPoint(row, col, col, 1.0, -1.0 * row);
+		}
+	}
+	organizedCloud.setInvalid(1, 1);
+	CPPUNIT_ASSERT_EQUAL(11u, organizedCloud.getNumberOfValidPoints());
+	CPPUNIT_ASSERT_EQUAL(6u, organizedCloud.getIndex(1, 2));
+	CPPUNIT_ASSERT(organizedCloud.isValid(6));
+	CPPUNIT_ASSERT(!organizedCloud.isValid(1, 1));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, organizedCloud.getXCoordinates()[6], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, organizedCloud.getPoint(1, 2).getZ(), maxTolerance);
+
+	/* constant time neighbor access */
+	unsigned int neighborIndex = 0;
+	CPPUNIT_ASSERT(organizedCloud.getNeighbor(6, -1, 0, neighborIndex));
+	CPPUNIT_ASSERT_EQUAL(2u, neighborIndex);
+	CPPUNIT_ASSERT(organizedCloud.getNeighbor(6, 1, 1, neighborIndex));
+	CPPUNIT_ASSERT_EQUAL(11u, neighborIndex);
+	CPPUNIT_ASSERT(!organizedCloud.getNeighbor(6, 0, -1, neighborIndex)); // invalid
+	CPPUNIT_ASSERT(!organizedCloud.getNeighbor(7, 0, 1, neighborIndex)); // right border
+	CPPUNIT_ASSERT(!organizedCloud.getNeighbor(0, -1, 0, neighborIndex)); // upper border
+
+	std::vector<unsigned int> neighbors;
+	CPPUNIT_ASSERT_EQUAL(8u, organizedCloud.getNeighborIndices(1, 1, 1, neighbors)); // center is invalid
+	CPPUNIT_ASSERT_EQUAL(0u, neighbors[0]);
+	CPPUNIT_ASSERT_EQUAL(10u, neighbors[7]);
+	CPPUNIT_ASSERT_EQUAL(4u, organizedCloud.getNeighborIndices(0, 3, 1, neighbors)); // clipped at the corner
+	CPPUNIT_ASSERT_EQUAL(11u, organizedCloud.getNeighborIndices(1, 1, 5, neighbors));
+	CPPUNIT_ASSERT_EQUAL(0u, organizedCloud.getNeighborIndices(3, 0, 1, neighbors)); // outside
+
+	/* flatten */
+	PointCloud3D flatCloud;
+	flatCloud.addPoint(Point3D(7.0, 7.0, 7.0));
+	std::vector<unsigned int> indices;
+	organizedCloud.copyTo(&flatCloud, &indices);
+	CPPUNIT_ASSERT_EQUAL(12u, flatCloud.getSize());
+	CPPUNIT_ASSERT_EQUAL(11u, static_cast<unsigned int>(indices.size()));
+	CPPUNIT_ASSERT_EQUAL(6u, indices[5]);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, (*flatCloud.getPointCloud())[6].getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, (*flatCloud.getPointCloud())[6].getZ(), maxTolerance);
+
+	organizedCloud.resize(2, 2);
+	CPPUNIT_ASSERT_EQUAL(4u, organizedCloud.getSize());
+	CPPUNIT_ASSERT_EQUAL(0u, organizedCloud.getNumberOfValidPoints());
+
+	OrganizedPointCloud3D emptyCloud;
+	CPPUNIT_ASSERT_EQUAL(0u, emptyCloud.getSize());
+	CPPUNIT_ASSERT(emptyCloud.getXCoordinates() == 0);
+	CPPUNIT_ASSERT(emptyCloud.getValidMask() == 0);
+}
+
 }
 
 /* EOF */
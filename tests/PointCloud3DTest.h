@@ -13,7 +13,11 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "brics_3d/core/PointCloud3D.h"
+#include "brics_3d/core/PointCloud3DSoA.h"
+#include "brics_3d/core/OrganizedPointCloud3D.h"
 #include "brics_3d/core/HomogeneousMatrix44.h"
+#include "brics_3d/core/HomogeneousTransformationKernel.h"
+#include "brics_3d/core/ColoredPoint3D.h"
 
 using namespace std;
 using namespace brics_3d;
@@ -32,6 +36,10 @@ class PointCloud3DTest: public CPPUNIT_NS::TestFixture {
 	//CPPUNIT_TEST( testLimits ); //is time consuming
 	CPPUNIT_TEST( testStreaming );
 	CPPUNIT_TEST( testTransformation );
+	CPPUNIT_TEST( testStructureOfArrays );
+	CPPUNIT_TEST( testPackedCoordinates );
+	CPPUNIT_TEST( testBulkTransformation );
+	CPPUNIT_TEST( testOrganizedPointCloud );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -43,6 +51,10 @@ public:
 	  void testLimits();
 	  void testStreaming();
 	  void testTransformation();
+	  void testStructureOfArrays();
+	  void testPackedCoordinates();
+	  void testBulkTransformation();
+	  void testOrganizedPointCloud();
 
 	  EIGEN_MAKE_ALIGNED_OPERATOR_NEW //Required by Eigen2
 
@@ -121,6 +121,18 @@ void PointCorrespondenceTest::testSimpleCorrespondence() {
 		CPPUNIT_ASSERT_DOUBLES_EQUAL((int)(*pointCloudCube->getPointCloud())[i].getZ(), (int)(*pointPairs)[i].firstPoint.getZ(), maxTolerance);
 		CPPUNIT_ASSERT_DOUBLES_EQUAL((int)(*pointCloudCubeCopy->getPointCloud())[i].getZ(), (int)(*pointPairs)[i].secondPoint.getZ(), maxTolerance);
 
+		/* the indices refer to the points in the clouds */
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), (*pointPairs)[i].firstIndex);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), (*pointPairs)[i].secondIndex);
+	}
+
+	/* the same for the generic nearest neighbor search */
+	PointCorrespondenceGenericNN genericAssigner(new NearestNeighborANN());
+	genericAssigner.createNearestNeighborCorrespondence(pointCloudCube, pointCloudCubeCopy, pointPairs);
+	CPPUNIT_ASSERT_EQUAL((int)pointCloudCube->getSize(), (int)pointPairs->size());
+	for (unsigned int i = 0;  i < pointPairs->size(); ++ i) {
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), (*pointPairs)[i].firstIndex);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), (*pointPairs)[i].secondIndex);
 	}
 
 
@@ -150,5 +162,112 @@ void PointCorrespondenceTest::testSimpleCorrespondence() {
 	delete homogeneousTrans;
 }
 
+void PointCorrespondenceTest::testModelCache() {
+	vector<CorrespondencePoint3DPair>* pointPairs = new vector<CorrespondencePoint3DPair>();
+	IHomogeneousMatrix44* translation = new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 0.1,0,0);
+
+	assigner = new PointCorrespondenceKDTree();
+	abstractAssigner = new PointCorrespondenceGenericNN(new NearestNeighborANN());
+	IPointCorrespondence* assigners[] = {assigner, abstractAssigner};
+
+	for (unsigned int a = 0; a < 2; ++a) {
+		PointCloud3D model;
+		model.addPoint(Point3D(0,0,0));
+		model.addPoint(Point3D(10,0,0));
+
+		PointCloud3D data;
+		data.addPoint(Point3D(1,0,0));
+
+		/* repeated queries reuse the cached model */
+		for (int i = 0; i < 3; ++i) {
+			assigners[a]->createNearestNeighborCorrespondence(&model, &data, pointPairs);
+			CPPUNIT_ASSERT_EQUAL(1, (int)pointPairs->size());
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, (*pointPairs)[0].firstPoint.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0 + 0.1 * i, (*pointPairs)[0].secondPoint.getX(), maxTolerance);
+			data.homogeneousTransformation(translation);
+		}
+
+		/* modifications of the model have to be taken into account */
+		model.addPoint(Point3D(1.5,0,0));
+		assigners[a]->createNearestNeighborCorrespondence(&model, &data, pointPairs);
+		CPPUNIT_ASSERT_EQUAL(1, (int)pointPairs->size());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, (*pointPairs)[0].firstPoint.getX(), maxTolerance);
+
+		(*model.getPointCloud())[2].setX(1.4);
+		assigners[a]->createNearestNeighborCorrespondence(&model, &data, pointPairs);
+		CPPUNIT_ASSERT_EQUAL(1, (int)pointPairs->size());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.4, (*pointPairs)[0].firstPoint.getX(), maxTolerance);
+
+		/* a different model */
+		PointCloud3D otherModel;
+		otherModel.addPoint(Point3D(-1,0,0));
+		assigners[a]->createNearestNeighborCorrespondence(&otherModel, &data, pointPairs);
+		CPPUNIT_ASSERT_EQUAL(1, (int)pointPairs->size());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, (*pointPairs)[0].firstPoint.getX(), maxTolerance);
+	}
+
+	assigner->invalidateModelCache();
+	CPPUNIT_ASSERT_NO_THROW(assigner->invalidateModelCache());
+
+	delete translation;
+	delete pointPairs;
+}
+
+void PointCorrespondenceTest::testParallelCorrespondence() {
+	vector<CorrespondencePoint3DPair> serialPointPairs;
+	vector<CorrespondencePoint3DPair> parallelPointPairs;
+
+	/* a regular grid that is large enough to be split among several threads */
+	PointCloud3D model;
+	PointCloud3D data;
+	for (int i = 0; i < 30; ++i) {
+		for (int j = 0; j < 30; ++j) {
+			for (int k = 0; k < 10; ++k) {
+				model.addPoint(Point3D(i, j, k));
+				data.addPoint(Point3D(i + 0.2, j + 0.1, k + 0.05));
+			}
+		}
+	}
+
+	assigner = new PointCorrespondenceKDTree();
+	abstractAssigner = new PointCorrespondenceGenericNN(new NearestNeighborSTANN());
+	PointCorrespondenceGenericNN* genericAssigner = dynamic_cast<PointCorrespondenceGenericNN*>(abstractAssigner);
+	CPPUNIT_ASSERT(genericAssigner != 0);
+
+	CPPUNIT_ASSERT_EQUAL(1u, assigner->getNumberOfThreads());
+	CPPUNIT_ASSERT_EQUAL(1u, genericAssigner->getNumberOfThreads());
+	assigner->setNumberOfThreads(1000);
+	CPPUNIT_ASSERT_EQUAL(PointCorrespondenceKDTree::maxNumberOfThreads, assigner->getNumberOfThreads());
+	assigner->setNumberOfThreads(0);
+	CPPUNIT_ASSERT(assigner->getNumberOfThreads() >= 1u);
+
+	IPointCorrespondence* assigners[] = {assigner, abstractAssigner};
+	for (unsigned int a = 0; a < 2; ++a) {
+		assigner->setNumberOfThreads(1);
+		genericAssigner->setNumberOfThreads(1);
+		assigners[a]->createNearestNeighborCorrespondence(&model, &data, &serialPointPairs);
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(data.getSize()), static_cast<int>(serialPointPairs.size()));
+
+		assigner->setNumberOfThreads(4);
+		genericAssigner->setNumberOfThreads(4);
+		assigners[a]->createNearestNeighborCorrespondence(&model, &data, &parallelPointPairs);
+
+		/* same result in the same order */
+		CPPUNIT_ASSERT_EQUAL(serialPointPairs.size(), parallelPointPairs.size());
+		for (unsigned int i = 0; i < serialPointPairs.size(); ++i) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].firstPoint.getX(), parallelPointPairs[i].firstPoint.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].firstPoint.getY(), parallelPointPairs[i].firstPoint.getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].firstPoint.getZ(), parallelPointPairs[i].firstPoint.getZ(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].secondPoint.getX(), parallelPointPairs[i].secondPoint.getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].secondPoint.getY(), parallelPointPairs[i].secondPoint.getY(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(serialPointPairs[i].secondPoint.getZ(), parallelPointPairs[i].secondPoint.getZ(), maxTolerance);
+		}
+
+		/* the data is shifted by less than half of the grid resolution */
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(data.getPointCloud()->back().getX() - 0.2, parallelPointPairs.back().firstPoint.getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(data.getPointCloud()->back().getZ() - 0.05, parallelPointPairs.back().firstPoint.getZ(), maxTolerance);
+	}
+}
+
 }
 /* EOF */
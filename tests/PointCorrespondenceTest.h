@@ -15,6 +15,9 @@
 #include "brics_3d/core/PointCloud3D.h"
 #include "brics_3d/core/HomogeneousMatrix44.h"
 #include "brics_3d/algorithm/registration/PointCorrespondenceKDTree.h"
+#include "brics_3d/algorithm/registration/PointCorrespondenceGenericNN.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborANN.h"
+#include "brics_3d/algorithm/nearestNeighbor/NearestNeighborSTANN.h"
 
 #include <Eigen/Geometry>
 #include <iostream>
@@ -29,6 +32,8 @@ class PointCorrespondenceTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST_SUITE( PointCorrespondenceTest );
 	CPPUNIT_TEST( testConstructor );
 	CPPUNIT_TEST( testSimpleCorrespondence );
+	CPPUNIT_TEST( testModelCache );
+	CPPUNIT_TEST( testParallelCorrespondence );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +42,8 @@ public:
 
 	void testConstructor();
 	void testSimpleCorrespondence();
+	void testModelCache();
+	void testParallelCorrespondence();
 
 	EIGEN_MAKE_ALIGNED_OPERATOR_NEW //Required by Eigen2
 
@@ -0,0 +1,232 @@
+/**
+ * @file 
+ * SACMethodsTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "SACMethodsTest.h"
+#include <cstdlib>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SACMethodsTest );
+
+void SACMethodsTest::setUp() {
+	std::srand(0);
+	pointCloud = new PointCloud3D();
+
+	for (unsigned int i = 0; i < numberOfPlanePoints; ++i) {
+		double x = std::rand() / static_cast<double>(RAND_MAX);
+		double y = std::rand() / static_cast<double>(RAND_MAX);
+		double noise = (std::rand() / static_cast<double>(RAND_MAX) - 0.5) * 0.002;
+		pointCloud->addPoint(Point3D(x, y, 0.5 + noise));
+	}
+	for (unsigned int i = 0; i < numberOfOutliers; ++i) {
+		double x = std::rand() / static_cast<double>(RAND_MAX);
+		double y = std::rand() / static_cast<double>(RAND_MAX);
+		double z = std::rand() / static_cast<double>(RAND_MAX);
+		if (fabs(z - 0.5) < 0.05) { // keep the outliers away from the plane
+			z += 0.1;
+		}
+		pointCloud->addPoint(Point3D(x, y, z));
+	}
+}
+
+void SACMethodsTest::tearDown() {
+	delete pointCloud;
+}
+
+void SACMethodsTest::checkPlaneCoefficients(const Eigen::VectorXd& modelCoefficients) {
+	CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(modelCoefficients.size()));
+	double sign = (modelCoefficients[2] < 0) ? -1.0 : 1.0;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, modelCoefficients[0], 0.01);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, modelCoefficients[1], 0.01);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, sign * modelCoefficients[2], 0.01);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-0.5, sign * modelCoefficients[3], 0.01);
+}
+
+void SACMethodsTest::testPackedDistances() {
+	std::vector<int> indices(pointCloud->getSize());
+	for (unsigned int i = 0; i < indices.size(); ++i) {
+		indices[i] = i;
+	}
+	std::random_shuffle(indices.begin(), indices.end());
+	PointCloud3DSoA<Coordinate> packedPoints;
+	packedPoints.copyFrom(pointCloud, indices);
+	CPPUNIT_ASSERT_EQUAL(pointCloud->getSize(), packedPoints.getSize());
+
+	/* the shuffled points are a permutation of the original ones */
+	std::vector<int> sortedIndices = indices;
+	std::sort(sortedIndices.begin(), sortedIndices.end());
+	for (unsigned int i = 0; i < sortedIndices.size(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), sortedIndices[i]);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloud->getPointCloud())[indices[7]].getY(), packedPoints.getYCoordinates()[7], maxTolerance);
+
+	/* plane: dedicated kernel */
+	ObjectModelPlane plane;
+	plane.setInputCloud(pointCloud);
+	Eigen::VectorXd planeCoefficients(4);
+	planeCoefficients << 0.36, 0.48, 0.8, -0.3;
+	std::vector<double> referenceDistances;
+	plane.getDistancesToModel(planeCoefficients, referenceDistances);
+
+	unsigned int begin = 5;
+	unsigned int end = 1030;
+	std::vector<double> distances(end - begin);
+	plane.getPackedDistancesToModel(planeCoefficients, packedPoints, indices, begin, end, &distances[0]);
+	for (unsigned int i = begin; i < end; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceDistances[indices[i]], distances[i - begin], maxTolerance);
+	}
+
+	/* sphere: default implementation via getInlierDistance() */
+	ObjectModelSphere sphere;
+	sphere.setInputCloud(pointCloud);
+	Eigen::VectorXd sphereCoefficients(4);
+	sphereCoefficients << 0.5, 0.5, 0.5, 0.3;
+	sphere.getDistancesToModel(sphereCoefficients, referenceDistances);
+	sphere.getPackedDistancesToModel(sphereCoefficients, packedPoints, indices, begin, end, &distances[0]);
+	for (unsigned int i = begin; i < end; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceDistances[indices[i]], distances[i - begin], maxTolerance);
+	}
+}
+
+void SACMethodsTest::testHypothesisEvaluation() {
+	const double threshold = 0.01;
+	ObjectModelPlane plane;
+	plane.setInputCloud(pointCloud);
+
+	std::vector<Eigen::VectorXd> hypotheses;
+	Eigen::VectorXd coefficients(4);
+	coefficients << 0.0, 0.0, 1.0, -0.5; // the true plane
+	hypotheses.push_back(coefficients);
+	coefficients << 1.0, 0.0, 0.0, -0.5; // a vertical plane
+	hypotheses.push_back(coefficients);
+	coefficients << 0.0, 0.0, -1.0, 0.5; // the true plane, flipped
+	hypotheses.push_back(coefficients);
+
+	std::vector<int> inliers;
+	plane.selectWithinDistance(hypotheses[0], threshold, inliers);
+	unsigned int expectedInliers = static_cast<unsigned int>(inliers.size());
+	CPPUNIT_ASSERT_EQUAL(numberOfPlanePoints, expectedInliers);
+	plane.selectWithinDistance(hypotheses[1], threshold, inliers);
+	unsigned int expectedVerticalInliers = static_cast<unsigned int>(inliers.size());
+
+	/* without a best score, all hypotheses are fully evaluated */
+	SACHypothesisEvaluator evaluator(&plane, threshold, SACHypothesisEvaluator::inlierCount);
+	evaluator.setNumberOfThreads(2);
+	SACHypothesisEvaluator::Score noScore;
+	std::vector<SACHypothesisEvaluator::Score> scores;
+	evaluator.evaluate(hypotheses, noScore, scores);
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(scores.size()));
+	for (unsigned int i = 0; i < scores.size(); ++i) {
+		CPPUNIT_ASSERT(scores[i].isValid);
+	}
+	CPPUNIT_ASSERT_EQUAL(expectedInliers, scores[0].numberOfInliers);
+	CPPUNIT_ASSERT_EQUAL(expectedVerticalInliers, scores[1].numberOfInliers);
+	CPPUNIT_ASSERT_EQUAL(expectedInliers, scores[2].numberOfInliers);
+	CPPUNIT_ASSERT(evaluator.isBetter(scores[0], scores[1]));
+	CPPUNIT_ASSERT(!evaluator.isBetter(scores[2], scores[0])); // ties do not win
+	CPPUNIT_ASSERT(evaluator.isBetter(scores[1], noScore));
+
+	/* early rejection: the vertical plane can not beat the true plane, but an exact evaluation is not affected */
+	evaluator.evaluate(hypotheses, scores[1], scores);
+	CPPUNIT_ASSERT(scores[0].isValid);
+	CPPUNIT_ASSERT_EQUAL(expectedInliers, scores[0].numberOfInliers);
+	CPPUNIT_ASSERT(!scores[1].isValid);
+
+	SACHypothesisEvaluator::Score bestScore = scores[0];
+	evaluator.evaluate(hypotheses, bestScore, scores);
+	CPPUNIT_ASSERT(!scores[0].isValid);
+	CPPUNIT_ASSERT(!scores[1].isValid);
+	CPPUNIT_ASSERT(!scores[2].isValid);
+
+	/* the pretest rejects the vertical plane after a few points */
+	evaluator.setPretestSize(100);
+	SACHypothesisEvaluator::Score mediocreScore;
+	mediocreScore.isValid = true;
+	mediocreScore.numberOfInliers = expectedInliers / 2;
+	evaluator.evaluate(hypotheses, mediocreScore, scores);
+	CPPUNIT_ASSERT(scores[0].isValid);
+	CPPUNIT_ASSERT_EQUAL(expectedInliers, scores[0].numberOfInliers);
+	CPPUNIT_ASSERT(!scores[1].isValid);
+
+	/* truncated residual */
+	SACHypothesisEvaluator residualEvaluator(&plane, threshold, SACHypothesisEvaluator::truncatedResidual);
+	residualEvaluator.evaluate(hypotheses, noScore, scores);
+	std::vector<double> distances;
+	plane.getDistancesToModel(hypotheses[1], distances);
+	double expectedPenalty = 0.0;
+	for (unsigned int i = 0; i < distances.size(); ++i) {
+		expectedPenalty += std::min(distances[i], threshold);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedPenalty, scores[1].residualPenalty, maxTolerance);
+	CPPUNIT_ASSERT(residualEvaluator.isBetter(scores[0], scores[1]));
+	residualEvaluator.evaluate(hypotheses, scores[0], scores);
+	CPPUNIT_ASSERT(!scores[1].isValid);
+}
+
+void SACMethodsTest::testBatchRANSAC() {
+	ObjectModelPlane plane;
+	plane.setInputCloud(pointCloud);
+
+	/* reference: one hypothesis at a time */
+	SACMethodRANSAC ransac;
+	ransac.setObjectModel(&plane);
+	ransac.setPointCloud(pointCloud);
+	ransac.setDistanceThreshold(0.01);
+	CPPUNIT_ASSERT_EQUAL(1u, ransac.getHypothesesPerBatch());
+	CPPUNIT_ASSERT(ransac.computeModel());
+
+	std::vector<int> referenceInliers;
+	Eigen::VectorXd modelCoefficients;
+	ransac.getInliers(referenceInliers);
+	ransac.getModelCoefficients(modelCoefficients);
+	CPPUNIT_ASSERT_EQUAL(numberOfPlanePoints, static_cast<unsigned int>(referenceInliers.size()));
+	checkPlaneCoefficients(modelCoefficients);
+
+	/* batches */
+	SACMethodRANSAC batchRansac;
+	batchRansac.setObjectModel(&plane);
+	batchRansac.setPointCloud(pointCloud);
+	batchRansac.setDistanceThreshold(0.01);
+	batchRansac.setHypothesesPerBatch(16);
+	batchRansac.setNumberOfThreads(4);
+	batchRansac.setPretestSize(100);
+	CPPUNIT_ASSERT(batchRansac.computeModel());
+
+	std::vector<int> inliers;
+	batchRansac.getInliers(inliers);
+	batchRansac.getModelCoefficients(modelCoefficients);
+	CPPUNIT_ASSERT(inliers == referenceInliers);
+	checkPlaneCoefficients(modelCoefficients);
+}
+
+void SACMethodsTest::testBatchMSAC() {
+	ObjectModelPlane plane;
+	plane.setInputCloud(pointCloud);
+
+	SACMethodMSAC msac;
+	msac.setObjectModel(&plane);
+	msac.setPointCloud(pointCloud);
+	msac.setDistanceThreshold(0.01);
+	msac.setHypothesesPerBatch(8);
+	msac.setNumberOfThreads(2);
+	CPPUNIT_ASSERT(msac.computeModel());
+
+	std::vector<int> inliers;
+	Eigen::VectorXd modelCoefficients;
+	msac.getInliers(inliers);
+	msac.getModelCoefficients(modelCoefficients);
+	CPPUNIT_ASSERT_EQUAL(numberOfPlanePoints, static_cast<unsigned int>(inliers.size()));
+	for (unsigned int i = 0; i < inliers.size(); ++i) {
+		CPPUNIT_ASSERT(inliers[i] < static_cast<int>(numberOfPlanePoints));
+	}
+	checkPlaneCoefficients(modelCoefficients);
+}
+
+}
+
+/* EOF */
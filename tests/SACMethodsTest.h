@@ -0,0 +1,63 @@
+/**
+ * @file 
+ * SACMethodsTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef SACMETHODSTEST_H_
+#define SACMETHODSTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/algorithm/segmentation/objectModels/ObjectModelPlane.h"
+#include "brics_3d/algorithm/segmentation/objectModels/ObjectModelSphere.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACMethodRANSAC.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACMethodMSAC.h"
+#include "brics_3d/algorithm/segmentation/SACMethods/SACHypothesisEvaluator.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class SACMethodsTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( SACMethodsTest );
+	CPPUNIT_TEST( testPackedDistances );
+	CPPUNIT_TEST( testHypothesisEvaluation );
+	CPPUNIT_TEST( testBatchRANSAC );
+	CPPUNIT_TEST( testBatchMSAC );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testPackedDistances();
+	void testHypothesisEvaluation();
+	void testBatchRANSAC();
+	void testBatchMSAC();
+
+private:
+
+	/// Check that the coefficients describe the plane z = 0.5 (in either orientation).
+	static void checkPlaneCoefficients(const Eigen::VectorXd& modelCoefficients);
+
+	static const double maxTolerance = 0.00001;
+
+	static const unsigned int numberOfPlanePoints = 3000;
+
+	static const unsigned int numberOfOutliers = 1000;
+
+	/// Points of the plane z = 0.5 with some noise plus uniformly distributed outliers.
+	PointCloud3D* pointCloud;
+};
+
+}
+
+#endif /* SACMETHODSTEST_H_ */
+
+/* EOF */
@@ -8,6 +8,10 @@
 
 #include "SceneGraphNodesTest.h"
 #include <stdexcept>
+#include <cstdio>
+#include <fstream>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 #include "brics_3d/core/Logger.h"
 
 namespace unitTests {
@@ -2076,6 +2080,112 @@ void SceneGraphNodesTest::testGlobalTransformCalculation() {
 
 }
 
+void SceneGraphNodesTest::testGlobalTransformCache() {
+	/* Graph structure:
+	 *            root
+	 *              |
+	 *        ------+-----
+	 *        |          |
+	 *       tf1        tf2
+	 *        |          |
+	 *      group3      node5
+	 *        |
+	 *       node4
+	 */
+	Group::GroupPtr root(new Group());
+	rsg::Transform::TransformPtr tf1(new rsg::Transform());
+	rsg::Transform::TransformPtr tf2(new rsg::Transform());
+	Group::GroupPtr group3(new Group());
+	Node::NodePtr node4(new Node());
+	Node::NodePtr node5(new Node());
+
+	root->addChild(tf1);
+	root->addChild(tf2);
+	tf1->addChild(group3);
+	group3->addChild(node4);
+	tf2->addChild(node5);
+
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform123(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 1,2,3));
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform456(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 4,5,6));
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform789(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 7,8,9));
+	tf1->insertTransform(transform123, TimeStamp(1.0));
+	tf2->insertTransform(transform456, TimeStamp(1.0));
+
+	/* an empty transform node counts as identity */
+	rsg::Transform::TransformPtr emptyTransform(new rsg::Transform());
+	CPPUNIT_ASSERT(getGlobalTransform(emptyTransform)->isIdentity());
+
+	/* repeated queries are served from the cache */
+	IHomogeneousMatrix44::IHomogeneousMatrix44ConstPtr cachedTransform = node4->getCachedGlobalTransform();
+	matrixPtr = cachedTransform->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, matrixPtr[14], maxTolerance);
+	CPPUNIT_ASSERT(cachedTransform == node4->getCachedGlobalTransform());
+	IHomogeneousMatrix44::IHomogeneousMatrix44ConstPtr cachedTransformNode5 = node5->getCachedGlobalTransform();
+
+	/* modifying the result of getGlobalTransform does not affect the cache */
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr resultTransform = getGlobalTransform(node4);
+	resultTransform->inverse();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, node4->getCachedGlobalTransform()->getRawData()[12], maxTolerance);
+
+	/* older data does not change the latest transform */
+	tf1->insertTransform(transform789, TimeStamp(0.5));
+	CPPUNIT_ASSERT(cachedTransform == node4->getCachedGlobalTransform());
+
+	/* a new latest transform invalidates the subgraph, but not its siblings */
+	tf1->insertTransform(transform789, TimeStamp(2.0));
+	CPPUNIT_ASSERT(cachedTransform != node4->getCachedGlobalTransform());
+	matrixPtr = node4->getCachedGlobalTransform()->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, matrixPtr[14], maxTolerance);
+	CPPUNIT_ASSERT(cachedTransformNode5 == node5->getCachedGlobalTransform());
+	matrixPtr = cachedTransform->getRawData(); // previous results stay untouched
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrixPtr[12], maxTolerance);
+
+	/* updates are propagated although intermediate nodes have not been queried */
+	tf1->insertTransform(transform123, TimeStamp(3.0));
+	tf1->insertTransform(transform456, TimeStamp(4.0));
+	matrixPtr = node4->getCachedGlobalTransform()->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, matrixPtr[14], maxTolerance);
+
+	/* changes of the graph structure */
+	group3->removeChild(node4);
+	tf2->addChild(node4);
+	matrixPtr = getGlobalTransform(node4)->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, matrixPtr[14], maxTolerance);
+
+	tf1->addChild(node5); // second parent: the first path is still used
+	tf1->insertTransform(transform789, TimeStamp(5.0));
+	CPPUNIT_ASSERT(cachedTransformNode5 == node5->getCachedGlobalTransform());
+	tf2->removeChild(node5);
+	matrixPtr = node5->getCachedGlobalTransform()->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, matrixPtr[14], maxTolerance);
+
+	/* the relative transform uses the cached ones */
+	resultTransform = getTransformBetweenNodes(node5, node4);
+	matrixPtr = resultTransform->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, matrixPtr[14], maxTolerance);
+
+	/* re-inserting an in-place modified matrix as latest transform invalidates the cache as well */
+	node5->getCachedGlobalTransform();
+	transform789->setRawData()[12] = 10.0;
+	tf1->insertTransform(transform789, TimeStamp(6.0));
+	matrixPtr = node5->getCachedGlobalTransform()->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, matrixPtr[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(8.0, matrixPtr[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(9.0, matrixPtr[14], maxTolerance);
+}
+
 void SceneGraphNodesTest::testAttributeFinder() {
 	/* Graph structure: (remember: nodes can only serve as are leaves)
 	 *                 root
@@ -2989,6 +3099,80 @@ void SceneGraphNodesTest::testSceneGraphFacadeTransforms() {
 
 }
 
+void SceneGraphNodesTest::testSceneGraphFacadeAttributeQueries() {
+	SceneGraphFacade scene;
+	vector<Attribute> attributes;
+	vector<unsigned int> resultIds;
+	unsigned int groupId;
+	unsigned int boxIds[3];
+	unsigned int childId;
+
+	attributes.push_back(Attribute("name","table"));
+	CPPUNIT_ASSERT(scene.addGroup(scene.getRootId(), groupId, attributes));
+	for (int i = 0; i < 3; ++i) {
+		attributes.clear();
+		attributes.push_back(Attribute("shapeType","Box"));
+		attributes.push_back(Attribute("color", (i == 1) ? "green" : "red"));
+		attributes.push_back(Attribute("color", (i == 1) ? "green" : "red")); // duplicates are harmless
+		CPPUNIT_ASSERT(scene.addNode(groupId, boxIds[i], attributes));
+	}
+	attributes.clear();
+	attributes.push_back(Attribute("color","red"));
+	CPPUNIT_ASSERT(scene.addNode(boxIds[0], childId, attributes) == false); // a node is not a group
+	CPPUNIT_ASSERT(scene.addGroup(groupId, childId, attributes));
+
+	/* empty and unknown queries */
+	attributes.clear();
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+	attributes.push_back(Attribute("color","blue"));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+
+	/* single attribute; the IDs are sorted */
+	attributes.clear();
+	attributes.push_back(Attribute("color","red"));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(boxIds[0], resultIds[0]);
+	CPPUNIT_ASSERT_EQUAL(boxIds[2], resultIds[1]);
+	CPPUNIT_ASSERT_EQUAL(childId, resultIds[2]);
+
+	/* conjunctive query */
+	attributes.push_back(Attribute("shapeType","Box"));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(boxIds[0], resultIds[0]);
+	CPPUNIT_ASSERT_EQUAL(boxIds[2], resultIds[1]);
+
+	/* updated attributes */
+	vector<Attribute> newAttributes;
+	newAttributes.push_back(Attribute("shapeType","Box"));
+	newAttributes.push_back(Attribute("color","green"));
+	CPPUNIT_ASSERT(scene.setNodeAttributes(boxIds[0], newAttributes));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(boxIds[2], resultIds[0]);
+	CPPUNIT_ASSERT(scene.getNodes(newAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(boxIds[0], resultIds[0]);
+	CPPUNIT_ASSERT_EQUAL(boxIds[1], resultIds[1]);
+
+	/* explicitly deleted node */
+	CPPUNIT_ASSERT(scene.deleteNode(boxIds[2]));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+
+	/* implicitly deleted nodes (the whole subgraph) */
+	CPPUNIT_ASSERT(scene.deleteNode(groupId));
+	CPPUNIT_ASSERT(scene.getNodes(newAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+	attributes.clear();
+	attributes.push_back(Attribute("color","red"));
+	CPPUNIT_ASSERT(scene.getNodes(attributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+}
+
 void SceneGraphNodesTest::testPointCloud() {
 	/* Graph structure: (remember: nodes can only serve as are leaves)
 	 *                 root
@@ -3595,9 +3779,9 @@ void SceneGraphNodesTest::testPointIterator() {
 //		std::cout << "RAW        : ("<< tmpPoint->getX() << "," << tmpPoint->getY() << "," << tmpPoint->getZ() << ")" << std::endl;
 
 		Point3D resultPoint = (*cloudAggregated->getPointCloud())[count];
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getX(), it->getX(), maxTolerance); // hard to test as there is no dereministic order in the map iteration
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getY(), it->getY(), maxTolerance);
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getZ(), it->getZ(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getX(), it->getX(), maxTolerance); // point clouds are traversed in insertion order
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getY(), it->getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getZ(), it->getZ(), maxTolerance);
 
 		count++;
 	}
@@ -3616,14 +3800,51 @@ void SceneGraphNodesTest::testPointIterator() {
 //		std::cout << "RAW        : ("<< tmpPoint->getX() << "," << tmpPoint->getY() << "," << tmpPoint->getZ() << ")" << std::endl;
 
 		Point3D resultPoint = (*cloudAggregated->getPointCloud())[count];
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getX(), it->getX(), maxTolerance);
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getY(), it->getY(), maxTolerance);
-//		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getZ(), it->getZ(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getX(), it->getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getY(), it->getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getZ(), it->getZ(), maxTolerance);
 
 		count++;
 	}
 	CPPUNIT_ASSERT_EQUAL(8, count);
 
+	/* chunked iteration; chunks span several point clouds */
+	PointCloud3D::PointCloud3DPtr emptyCloud(new PointCloud3D());
+	it->insert(emptyCloud, shift100);
+	it->insert(cloud1, shift100); // already contained
+	Coordinate chunk[3 * 3];
+	unsigned int chunkSizes[] = {3, 3, 2, 0};
+	PointCloud3D::PackedCoordinatesConstPtr packedCloud1 = cloud1->getPackedCoordinates();
+	count = 0;
+	it->begin();
+	for (int i = 0; i < 4; ++i) {
+		unsigned int chunkSize = it->getNextChunk(chunk, 3);
+		CPPUNIT_ASSERT_EQUAL(chunkSizes[i], chunkSize);
+		for (unsigned int j = 0; j < chunkSize; ++j) {
+			Point3D resultPoint = (*cloudAggregated->getPointCloud())[count];
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getX(), chunk[3 * j + 0], maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getY(), chunk[3 * j + 1], maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(resultPoint.getZ(), chunk[3 * j + 2], maxTolerance);
+			count++;
+		}
+		if (i == 0) { // chunks and single steps can be mixed
+			CPPUNIT_ASSERT(!it->end());
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(110.0, it->getX(), maxTolerance);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, it->getRawData()->getX(), maxTolerance);
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(8, count);
+	CPPUNIT_ASSERT(it->end());
+	CPPUNIT_ASSERT(packedCloud1 == cloud1->getPackedCoordinates()); // chunks are read from the packed cache without invalidating it
+
+	/* the default implementation of the interface yields the same data */
+	Coordinate referenceChunk[3 * 8];
+	it->begin();
+	CPPUNIT_ASSERT_EQUAL(8u, it->IPoint3DIterator::getNextChunk(referenceChunk, IPoint3DIterator::defaultChunkSize));
+	for (int j = 0; j < 8; ++j) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*cloudAggregated->getPointCloud())[j].getZ(), referenceChunk[3 * j + 2], maxTolerance);
+	}
+
 	delete it;
 
 	CPPUNIT_ASSERT_EQUAL(3u, cloud1->getSize());
@@ -4278,6 +4499,577 @@ void SceneGraphNodesTest::testRemoveParents() {
 
 }
 
+void SceneGraphNodesTest::testSceneGraphSnapshot() {
+	/* Graph structure:
+	 *            root
+	 *              |
+	 *        ------+-----
+	 *        |          |
+	 *       tf1        geo4
+	 *        |
+	 *      group2
+	 *        |
+	 *      node3
+	 */
+	unsigned int tf1Id = 0;
+	unsigned int group2Id = 0;
+	unsigned int node3Id = 0;
+	unsigned int geo4Id = 0;
+	vector<unsigned int> resultIds;
+	vector<Attribute> resultAttributes;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr resultTransform;
+
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform001(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 0,0,-1));
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform123(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 1,2,3));
+
+	SceneGraphFacade scene;
+	CPPUNIT_ASSERT(scene.getConcurrencyMode() == SceneGraphFacade::singleThreaded);
+	CPPUNIT_ASSERT(scene.getSnapshot() == 0);
+
+	vector<Attribute> tmpAttributes;
+	CPPUNIT_ASSERT(scene.addTransformNode(scene.getRootId(), tf1Id, tmpAttributes, transform001, TimeStamp(1.0)));
+	tmpAttributes.push_back(Attribute("name","group2"));
+	CPPUNIT_ASSERT(scene.addGroup(tf1Id, group2Id, tmpAttributes));
+
+	/* the first snapshot contains the existing graph */
+	scene.setConcurrencyMode(SceneGraphFacade::snapshotIsolation);
+	SceneGraphSnapshot::SceneGraphSnapshotPtr snapshot0 = scene.getSnapshot();
+	CPPUNIT_ASSERT(snapshot0 != 0);
+	CPPUNIT_ASSERT_EQUAL(3u, snapshot0->getNumberOfNodes());
+	CPPUNIT_ASSERT(scene.getNodes(tmpAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(group2Id, resultIds[0]);
+
+	tmpAttributes.clear();
+	tmpAttributes.push_back(Attribute("color","red"));
+	CPPUNIT_ASSERT(scene.addNode(group2Id, node3Id, tmpAttributes));
+	Box::BoxPtr box(new Box(1,2,3));
+	CPPUNIT_ASSERT(scene.addGeometricNode(scene.getRootId(), geo4Id, tmpAttributes, box, TimeStamp(1.0)));
+
+	SceneGraphSnapshot::SceneGraphSnapshotPtr snapshot1 = scene.getSnapshot();
+	CPPUNIT_ASSERT(snapshot1->getVersion() > snapshot0->getVersion());
+	CPPUNIT_ASSERT_EQUAL(5u, snapshot1->getNumberOfNodes());
+	CPPUNIT_ASSERT_EQUAL(3u, snapshot0->getNumberOfNodes()); // unchanged
+
+	CPPUNIT_ASSERT(scene.getNodes(tmpAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT(snapshot0->getNodes(tmpAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+
+	resultIds.clear();
+	CPPUNIT_ASSERT(scene.getGroupChildren(scene.getRootId(), resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(tf1Id, resultIds[0]);
+	CPPUNIT_ASSERT_EQUAL(geo4Id, resultIds[1]);
+	CPPUNIT_ASSERT(scene.getNodeParents(node3Id, resultIds));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(group2Id, resultIds[0]);
+
+	Shape::ShapePtr resultShape;
+	TimeStamp resultTime;
+	CPPUNIT_ASSERT(scene.getGeometry(geo4Id, resultShape, resultTime));
+	CPPUNIT_ASSERT(resultShape == box);
+	CPPUNIT_ASSERT(resultTime == TimeStamp(1.0));
+
+	/* transforms: the history is shared, old versions keep their view */
+	CPPUNIT_ASSERT(scene.setTransform(tf1Id, transform123, TimeStamp(2.0)));
+	SceneGraphSnapshot::SceneGraphSnapshotPtr snapshot2 = scene.getSnapshot();
+	CPPUNIT_ASSERT(snapshot2->getVersion() > snapshot1->getVersion());
+
+	CPPUNIT_ASSERT(scene.getTransform(tf1Id, TimeStamp(2.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultTransform->getRawData()[12], maxTolerance);
+	CPPUNIT_ASSERT(scene.getTransform(tf1Id, TimeStamp(1.2), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, resultTransform->getRawData()[14], maxTolerance);
+	CPPUNIT_ASSERT(scene.getTransform(tf1Id, TimeStamp(1.5), resultTransform)); // equal distance -> the newer one
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, resultTransform->getRawData()[14], maxTolerance);
+	CPPUNIT_ASSERT(snapshot1->getTransform(tf1Id, TimeStamp(2.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, resultTransform->getRawData()[14], maxTolerance);
+	CPPUNIT_ASSERT(!scene.getTransform(group2Id, TimeStamp(2.0), resultTransform));
+
+	CPPUNIT_ASSERT(scene.getTransformForNode(node3Id, scene.getRootId(), TimeStamp(2.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultTransform->getRawData()[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, resultTransform->getRawData()[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, resultTransform->getRawData()[14], maxTolerance);
+	CPPUNIT_ASSERT(scene.getTransformForNode(scene.getRootId(), node3Id, TimeStamp(2.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, resultTransform->getRawData()[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-2.0, resultTransform->getRawData()[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-3.0, resultTransform->getRawData()[14], maxTolerance);
+
+	/* attributes */
+	vector<Attribute> newAttributes;
+	newAttributes.push_back(Attribute("color","blue"));
+	CPPUNIT_ASSERT(scene.setNodeAttributes(node3Id, newAttributes));
+	CPPUNIT_ASSERT(scene.getNodes(tmpAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(geo4Id, resultIds[0]);
+	CPPUNIT_ASSERT(scene.getNodeAttributes(node3Id, resultAttributes));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultAttributes.size()));
+	CPPUNIT_ASSERT(resultAttributes[0] == Attribute("color","blue"));
+	CPPUNIT_ASSERT(snapshot2->getNodes(tmpAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+
+	/* deleting a group implicitly deletes its child */
+	CPPUNIT_ASSERT(scene.deleteNode(group2Id));
+	CPPUNIT_ASSERT_EQUAL(3u, scene.getSnapshot()->getNumberOfNodes());
+	CPPUNIT_ASSERT(!scene.getNodeAttributes(group2Id, resultAttributes));
+	CPPUNIT_ASSERT(!scene.getNodeAttributes(node3Id, resultAttributes));
+	CPPUNIT_ASSERT(scene.getNodes(newAttributes, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+	resultIds.clear();
+	CPPUNIT_ASSERT(scene.getGroupChildren(tf1Id, resultIds));
+	CPPUNIT_ASSERT_EQUAL(0u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT(snapshot2->getNodeAttributes(node3Id, resultAttributes));
+
+	/* removing the last parent deletes a node */
+	CPPUNIT_ASSERT(scene.removeParent(geo4Id, scene.getRootId()));
+	CPPUNIT_ASSERT_EQUAL(2u, scene.getSnapshot()->getNumberOfNodes());
+	CPPUNIT_ASSERT(!scene.getGeometry(geo4Id, resultShape, resultTime));
+
+	/* back to the unsynchronized mode */
+	scene.setConcurrencyMode(SceneGraphFacade::singleThreaded);
+	CPPUNIT_ASSERT(scene.getSnapshot() == 0);
+	CPPUNIT_ASSERT(scene.getTransform(tf1Id, TimeStamp(2.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultTransform->getRawData()[12], maxTolerance);
+}
+
+/// Sets the translation of a transform node to 1, 2, 3, ...
+static void writeTransforms(SceneGraphFacade* scene, unsigned int id, unsigned int numberOfUpdates) {
+	for (unsigned int i = 1; i <= numberOfUpdates; ++i) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, i,0,0));
+		scene->setTransform(id, transform, TimeStamp(i * 0.001));
+	}
+}
+
+/// Queries the global transform of a node until the last update is visible. Counts the queries with decreasing translations.
+static void readTransforms(SceneGraphFacade* scene, unsigned int id, unsigned int numberOfUpdates, unsigned int* errors) {
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform;
+	double previousTranslation = 0.0;
+	vector<Attribute> attributes;
+	attributes.push_back(Attribute("name","leaf"));
+	vector<unsigned int> ids;
+	while (previousTranslation < numberOfUpdates) {
+		if (!scene->getTransformForNode(id, scene->getRootId(), TimeStamp(0.0), transform) || transform->getRawData()[12] < previousTranslation) {
+			(*errors)++;
+			return;
+		}
+		previousTranslation = transform->getRawData()[12];
+		if (!scene->getNodes(attributes, ids) || ids.size() != 1) {
+			(*errors)++;
+			return;
+		}
+	}
+}
+
+void SceneGraphNodesTest::testConcurrentSnapshotQueries() {
+	const unsigned int numberOfUpdates = 2000;
+	const unsigned int numberOfReaders = 3;
+	unsigned int tfId = 0;
+	unsigned int leafId = 0;
+	vector<Attribute> tmpAttributes;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr identity(new HomogeneousMatrix44());
+
+	SceneGraphFacade scene;
+	scene.setConcurrencyMode(SceneGraphFacade::snapshotIsolation);
+	CPPUNIT_ASSERT(scene.addTransformNode(scene.getRootId(), tfId, tmpAttributes, identity, TimeStamp(0.0)));
+	tmpAttributes.push_back(Attribute("name","leaf"));
+	CPPUNIT_ASSERT(scene.addNode(tfId, leafId, tmpAttributes));
+
+	unsigned int errors[numberOfReaders] = {0, 0, 0};
+	boost::thread_group threads;
+	for (unsigned int i = 0; i < numberOfReaders; ++i) {
+		threads.create_thread(boost::bind(&readTransforms, &scene, leafId, numberOfUpdates, &errors[i]));
+	}
+	threads.create_thread(boost::bind(&writeTransforms, &scene, tfId, numberOfUpdates));
+	threads.join_all();
+
+	for (unsigned int i = 0; i < numberOfReaders; ++i) {
+		CPPUNIT_ASSERT_EQUAL(0u, errors[i]);
+	}
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr resultTransform;
+	CPPUNIT_ASSERT(scene.getTransform(tfId, TimeStamp(1.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1000.0, resultTransform->getRawData()[12], maxTolerance);
+}
+
+void SceneGraphNodesTest::testUpdateObserverDispatcher() {
+	SceneGraphFacade scene;
+	unsigned int groupId = 0;
+	unsigned int tfId = 0;
+	unsigned int uncertainTfId = 0;
+	unsigned int geodeId = 0;
+	unsigned int nodeId = 0;
+	vector<Attribute> tmpAttributes;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform123(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 1,2,3));
+	ITransformUncertainty::ITransformUncertaintyPtr uncertainty123(new CovarianceMatrix66(0.91,0.92,0.93, 0.1,0.2,0.3));
+	Cylinder::CylinderPtr cylinder1(new Cylinder(0.2,0.1));
+
+	/* the same updates have to arrive at a directly attached observer and at a dispatched one */
+	MyObserver directObserver;
+	MyObserver dispatchedObserver;
+	UpdateObserverDispatcher dispatcher(&dispatchedObserver);
+	CPPUNIT_ASSERT(scene.attachUpdateObserver(&directObserver));
+	CPPUNIT_ASSERT(scene.attachUpdateObserver(&dispatcher));
+	CPPUNIT_ASSERT_EQUAL(1024u, dispatcher.getQueueCapacity());
+	CPPUNIT_ASSERT(!dispatcher.getCoalesceTransforms());
+
+	CPPUNIT_ASSERT(scene.addGroup(scene.getRootId(), groupId, tmpAttributes));
+	CPPUNIT_ASSERT(scene.addTransformNode(groupId, tfId, tmpAttributes, transform123, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(scene.addUncertainTransformNode(groupId, uncertainTfId, tmpAttributes, transform123, uncertainty123, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(scene.addGeometricNode(tfId, geodeId, tmpAttributes, cylinder1, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(scene.addNode(tfId, nodeId, tmpAttributes));
+	tmpAttributes.push_back(Attribute("name","test"));
+	CPPUNIT_ASSERT(scene.setNodeAttributes(nodeId, tmpAttributes));
+	for (unsigned int i = 0; i < 10; ++i) {
+		CPPUNIT_ASSERT(scene.setTransform(tfId, transform123, TimeStamp(2.0 + i)));
+	}
+	CPPUNIT_ASSERT(scene.setUncertainTransform(uncertainTfId, transform123, uncertainty123, TimeStamp(2.0)));
+	CPPUNIT_ASSERT(scene.addParent(nodeId, uncertainTfId));
+	CPPUNIT_ASSERT(scene.removeParent(nodeId, uncertainTfId));
+	CPPUNIT_ASSERT(scene.deleteNode(nodeId));
+
+	dispatcher.flush();
+	CPPUNIT_ASSERT_EQUAL(0u, dispatcher.getQueueDepth());
+	CPPUNIT_ASSERT_EQUAL(20ul, dispatcher.getNumberOfDispatchedUpdates());
+	CPPUNIT_ASSERT_EQUAL(0ul, dispatcher.getNumberOfCoalescedUpdates());
+	CPPUNIT_ASSERT_EQUAL(0ul, dispatcher.getNumberOfDroppedUpdates());
+	CPPUNIT_ASSERT(dispatcher.getMaxQueueDepth() >= 1u);
+
+	CPPUNIT_ASSERT_EQUAL(directObserver.addNodeCounter, dispatchedObserver.addNodeCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.addGroupCounter, dispatchedObserver.addGroupCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.addTransformCounter, dispatchedObserver.addTransformCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.addUncertainTransformCounter, dispatchedObserver.addUncertainTransformCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.addGeometricNodeCounter, dispatchedObserver.addGeometricNodeCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.setNodeAttributesCounter, dispatchedObserver.setNodeAttributesCounter);
+	CPPUNIT_ASSERT_EQUAL(10, dispatchedObserver.setTransformCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.setTransformCounter, dispatchedObserver.setTransformCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.setUncertainTransformCounter, dispatchedObserver.setUncertainTransformCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.addParentCounter, dispatchedObserver.addParentCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.removeParentCounter, dispatchedObserver.removeParentCounter);
+	CPPUNIT_ASSERT_EQUAL(directObserver.deleteNodeCounter, dispatchedObserver.deleteNodeCounter);
+
+	/* the destructor forwards all pending updates */
+	MyObserver drainedObserver;
+	{
+		UpdateObserverDispatcher drainingDispatcher(&drainedObserver);
+		for (unsigned int i = 0; i < 100; ++i) {
+			CPPUNIT_ASSERT(drainingDispatcher.setTransform(tfId, transform123, TimeStamp(i)));
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(100, drainedObserver.setTransformCounter);
+
+	/* a full queue keeps only the latest transform per node but does not block the writer */
+	BlockingObserver slowObserver;
+	UpdateObserverDispatcher boundedDispatcher(&slowObserver, 4);
+	slowObserver.block();
+	CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(0.0)));
+	slowObserver.waitUntilBlocked(); // the first update has been taken out of the queue
+	for (unsigned int i = 1; i <= 4; ++i) {
+		CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(i)));
+	}
+	CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(5.0)));
+	CPPUNIT_ASSERT(boundedDispatcher.setTransform(groupId, transform123, TimeStamp(5.0)));
+	CPPUNIT_ASSERT_EQUAL(0ul, boundedDispatcher.getNumberOfDroppedUpdates());
+	transform123->setRawData()[12] = 7.0; // the dispatcher has its own copies
+	CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(6.0)));
+	transform123->setRawData()[12] = 1.0;
+	CPPUNIT_ASSERT_EQUAL(1ul, boundedDispatcher.getNumberOfDroppedUpdates());
+	CPPUNIT_ASSERT_EQUAL(6u, boundedDispatcher.getQueueDepth());
+	CPPUNIT_ASSERT_EQUAL(6u, boundedDispatcher.getMaxQueueDepth());
+
+	slowObserver.release();
+	boundedDispatcher.flush();
+	CPPUNIT_ASSERT_EQUAL(0u, boundedDispatcher.getQueueDepth());
+	CPPUNIT_ASSERT_EQUAL(7ul, boundedDispatcher.getNumberOfDispatchedUpdates());
+	CPPUNIT_ASSERT_EQUAL(7u, static_cast<unsigned int>(slowObserver.receivedUpdates.size()));
+	CPPUNIT_ASSERT(slowObserver.receivedTimeStamps[4] == TimeStamp(4.0));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[5] == std::make_pair(std::string("setTransform"), tfId)); // the newest one of the node
+	CPPUNIT_ASSERT(slowObserver.receivedTimeStamps[5] == TimeStamp(6.0));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(7.0, slowObserver.receivedTransforms[5]->getRawData()[12], maxTolerance);
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[6] == std::make_pair(std::string("setTransform"), groupId));
+
+	/* a structural update follows the pending transforms */
+	slowObserver.block();
+	CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(7.0)));
+	slowObserver.waitUntilBlocked();
+	for (unsigned int i = 8; i <= 13; ++i) {
+		CPPUNIT_ASSERT(boundedDispatcher.setTransform(tfId, transform123, TimeStamp(i)));
+	}
+	slowObserver.release();
+	CPPUNIT_ASSERT(boundedDispatcher.deleteNode(tfId));
+	boundedDispatcher.flush();
+	CPPUNIT_ASSERT_EQUAL(2ul, boundedDispatcher.getNumberOfDroppedUpdates());
+	CPPUNIT_ASSERT_EQUAL(14u, static_cast<unsigned int>(slowObserver.receivedUpdates.size()));
+	CPPUNIT_ASSERT(slowObserver.receivedTimeStamps[12] == TimeStamp(13.0));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[13] == std::make_pair(std::string("deleteNode"), tfId));
+}
+
+void SceneGraphNodesTest::testUpdateObserverDispatcherCoalescing() {
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr identity(new HomogeneousMatrix44());
+	BlockingObserver slowObserver;
+	UpdateObserverDispatcher dispatcher(&slowObserver, 64, true);
+	CPPUNIT_ASSERT(dispatcher.getCoalesceTransforms());
+
+	/* keep the dispatch thread busy, so the following updates end up in one batch */
+	slowObserver.block();
+	CPPUNIT_ASSERT(dispatcher.setTransform(1, identity, TimeStamp(0.0)));
+	slowObserver.waitUntilBlocked();
+
+	CPPUNIT_ASSERT(dispatcher.setTransform(2, identity, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(dispatcher.setTransform(3, identity, TimeStamp(2.0)));
+	CPPUNIT_ASSERT(dispatcher.setTransform(2, identity, TimeStamp(3.0)));
+	CPPUNIT_ASSERT(dispatcher.addParent(2, 5)); // nothing is coalesced across structural updates
+	CPPUNIT_ASSERT(dispatcher.setTransform(2, identity, TimeStamp(4.0)));
+	CPPUNIT_ASSERT(dispatcher.setTransform(2, identity, TimeStamp(5.0)));
+	CPPUNIT_ASSERT_EQUAL(6u, dispatcher.getQueueDepth());
+
+	slowObserver.release();
+	dispatcher.flush();
+	CPPUNIT_ASSERT_EQUAL(0u, dispatcher.getQueueDepth());
+	CPPUNIT_ASSERT_EQUAL(6u, dispatcher.getMaxQueueDepth());
+	CPPUNIT_ASSERT_EQUAL(5ul, dispatcher.getNumberOfDispatchedUpdates());
+	CPPUNIT_ASSERT_EQUAL(2ul, dispatcher.getNumberOfCoalescedUpdates());
+	CPPUNIT_ASSERT_EQUAL(0ul, dispatcher.getNumberOfDroppedUpdates());
+
+	/* the newest transform of each node survives, the order is preserved */
+	CPPUNIT_ASSERT_EQUAL(5u, static_cast<unsigned int>(slowObserver.receivedUpdates.size()));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[0] == std::make_pair(std::string("setTransform"), 1u));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[1] == std::make_pair(std::string("setTransform"), 3u));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[2] == std::make_pair(std::string("setTransform"), 2u));
+	CPPUNIT_ASSERT(slowObserver.receivedTimeStamps[2] == TimeStamp(3.0));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[3] == std::make_pair(std::string("addParent"), 2u));
+	CPPUNIT_ASSERT(slowObserver.receivedUpdates[4] == std::make_pair(std::string("setTransform"), 2u));
+	CPPUNIT_ASSERT(slowObserver.receivedTimeStamps[4] == TimeStamp(5.0));
+}
+
+void SceneGraphNodesTest::testSceneGraphLogSnapshot() {
+	const std::string logFile = "sceneGraphLogSnapshotTest.rsg";
+	SceneGraphFacade scene;
+	unsigned int groupId = 0;
+	unsigned int tfId = 0;
+	unsigned int uncertainTfId = 0;
+	unsigned int boxId = 0;
+	unsigned int cylinderId = 0;
+	unsigned int pointCloudId = 0;
+	unsigned int meshId = 0;
+	vector<Attribute> tmpAttributes;
+	vector<Attribute> resultAttributes;
+	vector<unsigned int> resultIds;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr resultTransform;
+	ITransformUncertainty::ITransformUncertaintyPtr resultUncertainty;
+	Shape::ShapePtr resultShape;
+	TimeStamp resultTime;
+
+	/* a graph with all node types, a transform history, a node with two parents and all supported shapes */
+	tmpAttributes.push_back(Attribute("name","world"));
+	CPPUNIT_ASSERT(scene.setNodeAttributes(scene.getRootId(), tmpAttributes));
+	tmpAttributes.clear();
+	tmpAttributes.push_back(Attribute("name","group"));
+	tmpAttributes.push_back(Attribute("type","test"));
+	CPPUNIT_ASSERT(scene.addGroup(scene.getRootId(), groupId, tmpAttributes));
+	tmpAttributes.clear();
+	for (unsigned int i = 1; i <= 3; ++i) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, i,2,3));
+		if (i == 1) {
+			CPPUNIT_ASSERT(scene.addTransformNode(groupId, tfId, tmpAttributes, transform, TimeStamp(i)));
+		} else {
+			CPPUNIT_ASSERT(scene.setTransform(tfId, transform, TimeStamp(i)));
+		}
+	}
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform456(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, 4,5,6));
+	ITransformUncertainty::ITransformUncertaintyPtr uncertainty123(new CovarianceMatrix66(0.91,0.92,0.93, 0.1,0.2,0.3));
+	CPPUNIT_ASSERT(scene.addUncertainTransformNode(scene.getRootId(), uncertainTfId, tmpAttributes, transform456, uncertainty123, TimeStamp(1.0)));
+
+	Box::BoxPtr box(new Box(1.0, 2.0, 3.0));
+	CPPUNIT_ASSERT(scene.addGeometricNode(tfId, boxId, tmpAttributes, box, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(scene.addParent(boxId, uncertainTfId));
+	Cylinder::CylinderPtr cylinder(new Cylinder(0.2, 0.1));
+	CPPUNIT_ASSERT(scene.addGeometricNode(uncertainTfId, cylinderId, tmpAttributes, cylinder, TimeStamp(2.0)));
+	PointCloud<PointCloud3D>::PointCloudPtr pointCloud(new PointCloud<PointCloud3D>());
+	pointCloud->data = boost::shared_ptr<PointCloud3D>(new PointCloud3D());
+	for (int i = 0; i < 100; ++i) {
+		pointCloud->data->addPoint(Point3D(i, -i, 0.5 * i));
+	}
+	CPPUNIT_ASSERT(scene.addGeometricNode(groupId, pointCloudId, tmpAttributes, pointCloud, TimeStamp(3.0)));
+	Mesh<ITriangleMesh>::MeshPtr mesh(new Mesh<ITriangleMesh>());
+	mesh->data = boost::shared_ptr<ITriangleMesh>(new TriangleMeshExplicit());
+	mesh->data->addTriangle(Point3D(0,0,0), Point3D(1,0,0), Point3D(0,1,0));
+	mesh->data->addTriangle(Point3D(0,0,1), Point3D(1,0,1), Point3D(0,1,1));
+	CPPUNIT_ASSERT(scene.addGeometricNode(groupId, meshId, tmpAttributes, mesh, TimeStamp(4.0)));
+
+	SceneGraphLogWriter logWriter;
+	CPPUNIT_ASSERT(!logWriter.writeSnapshot(&scene)); // not open yet
+	CPPUNIT_ASSERT(logWriter.open(logFile, scene.getRootId()));
+	CPPUNIT_ASSERT(logWriter.writeSnapshot(&scene));
+	/* root attributes, 7 nodes, 2 additional transforms in the history, 1 additional parent */
+	CPPUNIT_ASSERT_EQUAL(11ul, logWriter.getNumberOfRecords());
+	logWriter.close();
+
+	SceneGraphLogReader logReader;
+	CPPUNIT_ASSERT(logReader.open(logFile));
+	CPPUNIT_ASSERT_EQUAL(1u, logReader.getVersion());
+	CPPUNIT_ASSERT_EQUAL(scene.getRootId(), logReader.getRootId());
+	CPPUNIT_ASSERT_EQUAL(11ul, logReader.getNumberOfRecords());
+	CPPUNIT_ASSERT_EQUAL(logReader.getFileSize(), logReader.getValidSize());
+
+	SceneGraphFacade restoredScene;
+	CPPUNIT_ASSERT(logReader.restore(&restoredScene));
+
+	CPPUNIT_ASSERT(restoredScene.getNodeAttributes(restoredScene.getRootId(), resultAttributes));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultAttributes.size()));
+	CPPUNIT_ASSERT(resultAttributes[0] == Attribute("name","world"));
+	CPPUNIT_ASSERT(restoredScene.getNodeAttributes(groupId, resultAttributes));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultAttributes.size()));
+	CPPUNIT_ASSERT(resultAttributes[1] == Attribute("type","test"));
+	CPPUNIT_ASSERT(restoredScene.getGroupChildren(groupId, resultIds));
+	CPPUNIT_ASSERT_EQUAL(3u, static_cast<unsigned int>(resultIds.size()));
+
+	/* complete transform history */
+	for (unsigned int i = 1; i <= 3; ++i) {
+		CPPUNIT_ASSERT(restoredScene.getTransform(tfId, TimeStamp(i), resultTransform));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(static_cast<double>(i), resultTransform->getRawData()[12], maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, resultTransform->getRawData()[14], maxTolerance);
+	}
+	CPPUNIT_ASSERT(restoredScene.getUncertainTransform(uncertainTfId, TimeStamp(1.0), resultTransform, resultUncertainty));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, resultTransform->getRawData()[13], maxTolerance);
+	CPPUNIT_ASSERT(resultUncertainty != 0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.91, resultUncertainty->getRawData()[0], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3, resultUncertainty->getRawData()[35], maxTolerance);
+
+	/* the box has both parents */
+	CPPUNIT_ASSERT(restoredScene.getNodeParents(boxId, resultIds));
+	CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(tfId, resultIds[0]);
+	CPPUNIT_ASSERT_EQUAL(uncertainTfId, resultIds[1]);
+
+	/* shapes */
+	CPPUNIT_ASSERT(restoredScene.getGeometry(boxId, resultShape, resultTime));
+	Box::BoxPtr resultBox = boost::dynamic_pointer_cast<Box>(resultShape);
+	CPPUNIT_ASSERT(resultBox != 0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, resultBox->getSizeZ(), maxTolerance);
+	CPPUNIT_ASSERT(restoredScene.getGeometry(cylinderId, resultShape, resultTime));
+	Cylinder::CylinderPtr resultCylinder = boost::dynamic_pointer_cast<Cylinder>(resultShape);
+	CPPUNIT_ASSERT(resultCylinder != 0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, resultCylinder->getRadius(), maxTolerance);
+	CPPUNIT_ASSERT(resultTime == TimeStamp(2.0));
+	CPPUNIT_ASSERT(restoredScene.getGeometry(pointCloudId, resultShape, resultTime));
+	PointCloud<PointCloud3D>::PointCloudPtr resultPointCloud = boost::dynamic_pointer_cast<PointCloud<PointCloud3D> >(resultShape);
+	CPPUNIT_ASSERT(resultPointCloud != 0);
+	CPPUNIT_ASSERT_EQUAL(100u, resultPointCloud->data->getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-99.0, (*resultPointCloud->data->getPointCloud())[99].getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(49.5, (*resultPointCloud->data->getPointCloud())[99].getZ(), maxTolerance);
+	CPPUNIT_ASSERT(restoredScene.getGeometry(meshId, resultShape, resultTime));
+	Mesh<ITriangleMesh>::MeshPtr resultMesh = boost::dynamic_pointer_cast<Mesh<ITriangleMesh> >(resultShape);
+	CPPUNIT_ASSERT(resultMesh != 0);
+	CPPUNIT_ASSERT_EQUAL(2, resultMesh->data->getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, resultMesh->data->getTriangleVertex(1, 2)->getZ(), maxTolerance);
+
+	/* new IDs do not collide with the restored ones */
+	unsigned int newId = 0;
+	CPPUNIT_ASSERT(restoredScene.addNode(restoredScene.getRootId(), newId, tmpAttributes));
+	CPPUNIT_ASSERT(newId > meshId);
+
+	/* a mesh that refers to a vertex that does not exist is rejected */
+	Mesh<ITriangleMesh>::MeshPtr invalidMesh(new Mesh<ITriangleMesh>());
+	TriangleMeshImplicit* invalidIndexedMesh = new TriangleMeshImplicit();
+	invalidMesh->data = boost::shared_ptr<ITriangleMesh>(invalidIndexedMesh);
+	for (int i = 0; i < 3; ++i) {
+		invalidIndexedMesh->getVertices()->push_back(Point3D(i, 0, 0));
+	}
+	invalidIndexedMesh->getIndices()->push_back(0);
+	invalidIndexedMesh->getIndices()->push_back(1);
+	invalidIndexedMesh->getIndices()->push_back(5);
+	unsigned int invalidMeshId = meshId + 100;
+	CPPUNIT_ASSERT(logWriter.open(logFile, scene.getRootId()));
+	CPPUNIT_ASSERT(logWriter.addGeometricNode(scene.getRootId(), invalidMeshId, tmpAttributes, invalidMesh, TimeStamp(1.0)));
+	logWriter.close();
+	CPPUNIT_ASSERT(logReader.open(logFile));
+	SceneGraphFacade invalidScene;
+	CPPUNIT_ASSERT(!logReader.restore(&invalidScene));
+	CPPUNIT_ASSERT(!invalidScene.getGeometry(invalidMeshId, resultShape, resultTime));
+	logReader.close();
+
+	/* not a log file */
+	std::ofstream invalidFile(logFile.c_str(), std::ios::binary | std::ios::trunc);
+	invalidFile << "no scene graph";
+	invalidFile.close();
+	CPPUNIT_ASSERT(!logReader.open(logFile));
+	CPPUNIT_ASSERT(!logReader.isOpen());
+	std::remove(logFile.c_str());
+	CPPUNIT_ASSERT(!logReader.open(logFile));
+}
+
+void SceneGraphNodesTest::testSceneGraphLogAppend() {
+	const std::string logFile = "sceneGraphLogAppendTest.rsg";
+	SceneGraphFacade scene;
+	unsigned int groupId = 0;
+	unsigned int tfId = 0;
+	unsigned int nodeId = 0;
+	vector<Attribute> tmpAttributes;
+	vector<unsigned int> resultIds;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr resultTransform;
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr identity(new HomogeneousMatrix44());
+
+	/* delta log of a running scene */
+	SceneGraphLogWriter logWriter;
+	CPPUNIT_ASSERT(logWriter.open(logFile, scene.getRootId()));
+	CPPUNIT_ASSERT(scene.attachUpdateObserver(&logWriter));
+	CPPUNIT_ASSERT(scene.addGroup(scene.getRootId(), groupId, tmpAttributes));
+	CPPUNIT_ASSERT(scene.addTransformNode(groupId, tfId, tmpAttributes, identity, TimeStamp(1.0)));
+	CPPUNIT_ASSERT(scene.addNode(tfId, nodeId, tmpAttributes));
+	CPPUNIT_ASSERT(scene.deleteNode(nodeId));
+	CPPUNIT_ASSERT_EQUAL(4ul, logWriter.getNumberOfRecords());
+	CPPUNIT_ASSERT(scene.detachUpdateObserver(&logWriter));
+	logWriter.close();
+
+	/* continue the log later on */
+	CPPUNIT_ASSERT(!logWriter.open(logFile, scene.getRootId() + 1, true)); // wrong root
+	CPPUNIT_ASSERT(logWriter.open(logFile, scene.getRootId(), true));
+	CPPUNIT_ASSERT(scene.attachUpdateObserver(&logWriter));
+	for (unsigned int i = 2; i <= 5; ++i) {
+		IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform(new HomogeneousMatrix44(1,0,0, 0,1,0, 0,0,1, i,0,0));
+		CPPUNIT_ASSERT(scene.setTransform(tfId, transform, TimeStamp(i)));
+	}
+	CPPUNIT_ASSERT(scene.detachUpdateObserver(&logWriter));
+	CPPUNIT_ASSERT_EQUAL(4ul, logWriter.getNumberOfRecords());
+	unsigned long logSize = logWriter.getSize();
+	logWriter.close();
+
+	/* a crash while appending leaves an incomplete record */
+	std::ofstream crashedFile(logFile.c_str(), std::ios::binary | std::ios::app);
+	unsigned int incompleteRecord[3] = {SceneGraphLogFormat::setTransformRecord, 144u, 0u};
+	crashedFile.write(reinterpret_cast<const char*>(incompleteRecord), sizeof(incompleteRecord));
+	crashedFile.close();
+
+	SceneGraphLogReader logReader;
+	CPPUNIT_ASSERT(logReader.open(logFile));
+	CPPUNIT_ASSERT_EQUAL(8ul, logReader.getNumberOfRecords());
+	CPPUNIT_ASSERT_EQUAL(logSize, logReader.getValidSize());
+	CPPUNIT_ASSERT_EQUAL(logSize + 12, logReader.getFileSize());
+
+	SceneGraphFacade restoredScene;
+	CPPUNIT_ASSERT(logReader.restore(&restoredScene));
+	CPPUNIT_ASSERT(restoredScene.getGroupChildren(groupId, resultIds));
+	CPPUNIT_ASSERT_EQUAL(1u, static_cast<unsigned int>(resultIds.size()));
+	CPPUNIT_ASSERT_EQUAL(tfId, resultIds[0]);
+	CPPUNIT_ASSERT(!restoredScene.getNodeParents(nodeId, resultIds)); // deleted
+	CPPUNIT_ASSERT(restoredScene.getTransform(tfId, TimeStamp(5.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, resultTransform->getRawData()[12], maxTolerance);
+	CPPUNIT_ASSERT(restoredScene.getTransform(tfId, TimeStamp(3.0), resultTransform));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, resultTransform->getRawData()[12], maxTolerance);
+	logReader.close();
+
+	/* appending removes the incomplete record */
+	CPPUNIT_ASSERT(logWriter.open(logFile, scene.getRootId(), true));
+	CPPUNIT_ASSERT_EQUAL(logSize, logWriter.getSize());
+	CPPUNIT_ASSERT(logWriter.setTransform(tfId, identity, TimeStamp(6.0)));
+	logWriter.close();
+	CPPUNIT_ASSERT(logReader.open(logFile));
+	CPPUNIT_ASSERT_EQUAL(9ul, logReader.getNumberOfRecords());
+	CPPUNIT_ASSERT_EQUAL(logReader.getFileSize(), logReader.getValidSize());
+	logReader.close();
+
+	std::remove(logFile.c_str());
+}
+
 }  // namespace unitTests
 
 /* EOF */
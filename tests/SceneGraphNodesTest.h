@@ -33,12 +33,20 @@
 #include "brics_3d/worldModel/sceneGraph/PointCloud.h"
 #include "brics_3d/worldModel/sceneGraph/SubGraphChecker.h"
 #include "brics_3d/worldModel/sceneGraph/SceneGraphToUpdatesTraverser.h"
+#include "brics_3d/worldModel/sceneGraph/UpdateObserverDispatcher.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphLogWriter.h"
+#include "brics_3d/worldModel/sceneGraph/SceneGraphLogReader.h"
+#include "brics_3d/worldModel/sceneGraph/Mesh.h"
+#include "brics_3d/core/TriangleMeshExplicit.h"
+#include "brics_3d/core/TriangleMeshImplicit.h"
 #include "brics_3d/worldModel/sceneGraph/UncertainTransform.h"
 #include "brics_3d/core/PointCloud3D.h"
 #include "brics_3d/core/PointCloud3DIterator.h"
 
 #include "brics_3d/util/Timer.h"
 
+#include <boost/thread.hpp>
+
 namespace unitTests {
 
 using namespace brics_3d;
@@ -183,6 +191,75 @@ public:
 	int removeParentCounter;
 };
 
+/*
+ * Observer that logs the received transform updates and can be blocked to simulate a slow consumer.
+ */
+class BlockingObserver : public MyObserver {
+
+public:
+	BlockingObserver() : blocked(false), waiting(false) {}
+
+	bool setTransform(unsigned int id, IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform, TimeStamp timeStamp) {
+		boost::mutex::scoped_lock lock(mutex);
+		receivedUpdates.push_back(std::make_pair(std::string("setTransform"), id));
+		receivedTimeStamps.push_back(timeStamp);
+		receivedTransforms.push_back(transform);
+		waiting = true;
+		condition.notify_all();
+		while (blocked) {
+			condition.wait(lock);
+		}
+		waiting = false;
+		return MyObserver::setTransform(id, transform, timeStamp);
+	}
+
+	bool addParent(unsigned int id, unsigned int parentId) {
+		boost::mutex::scoped_lock lock(mutex);
+		receivedUpdates.push_back(std::make_pair(std::string("addParent"), id));
+		receivedTimeStamps.push_back(TimeStamp());
+		receivedTransforms.push_back(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr());
+		return MyObserver::addParent(id, parentId);
+	}
+
+	bool deleteNode(unsigned int id) {
+		boost::mutex::scoped_lock lock(mutex);
+		receivedUpdates.push_back(std::make_pair(std::string("deleteNode"), id));
+		receivedTimeStamps.push_back(TimeStamp());
+		receivedTransforms.push_back(IHomogeneousMatrix44::IHomogeneousMatrix44Ptr());
+		return MyObserver::deleteNode(id);
+	}
+
+	/// Let setTransform() block until release() is called.
+	void block() {
+		boost::mutex::scoped_lock lock(mutex);
+		blocked = true;
+	}
+
+	/// Wait until a setTransform() call is blocked.
+	void waitUntilBlocked() {
+		boost::mutex::scoped_lock lock(mutex);
+		while (!waiting) {
+			condition.wait(lock);
+		}
+	}
+
+	void release() {
+		boost::mutex::scoped_lock lock(mutex);
+		blocked = false;
+		condition.notify_all();
+	}
+
+	std::vector<std::pair<std::string, unsigned int> > receivedUpdates;
+	std::vector<TimeStamp> receivedTimeStamps;
+	std::vector<IHomogeneousMatrix44::IHomogeneousMatrix44Ptr> receivedTransforms;
+
+private:
+	boost::mutex mutex;
+	boost::condition_variable condition;
+	bool blocked;
+	bool waiting;
+};
+
 
 class SceneGraphNodesTest : public CPPUNIT_NS::TestFixture {
 
@@ -202,11 +279,13 @@ class SceneGraphNodesTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testTransformVisitor );
 	CPPUNIT_TEST( testUncertainTransformVisitor );
 	CPPUNIT_TEST( testGlobalTransformCalculation );
+	CPPUNIT_TEST( testGlobalTransformCache );
 	CPPUNIT_TEST( testAttributeFinder );
 	CPPUNIT_TEST( testOutdatedDataDeleter );
 	CPPUNIT_TEST( testIdGenerator );
 	CPPUNIT_TEST( testSceneGraphFacade );
 	CPPUNIT_TEST( testSceneGraphFacadeTransforms );
+	CPPUNIT_TEST( testSceneGraphFacadeAttributeQueries );
 	CPPUNIT_TEST( testPointCloud );
 	CPPUNIT_TEST( testUpdateObserver );
 	CPPUNIT_TEST( testDotGraphGenerator );
@@ -216,6 +295,12 @@ class SceneGraphNodesTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testForcedIds );
 	CPPUNIT_TEST( testSceneGraphToUpdates );
 	CPPUNIT_TEST( testRemoveParents );
+	CPPUNIT_TEST( testSceneGraphSnapshot );
+	CPPUNIT_TEST( testConcurrentSnapshotQueries );
+	CPPUNIT_TEST( testUpdateObserverDispatcher );
+	CPPUNIT_TEST( testUpdateObserverDispatcherCoalescing );
+	CPPUNIT_TEST( testSceneGraphLogSnapshot );
+	CPPUNIT_TEST( testSceneGraphLogAppend );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -237,11 +322,13 @@ public:
 	void testTransformVisitor();
 	void testUncertainTransformVisitor();
 	void testGlobalTransformCalculation();
+	void testGlobalTransformCache();
 	void testAttributeFinder();
 	void testOutdatedDataDeleter();
 	void testIdGenerator();
 	void testSceneGraphFacade();
 	void testSceneGraphFacadeTransforms();
+	void testSceneGraphFacadeAttributeQueries();
 	void testPointCloud();
 	void testUpdateObserver();
 	void testDotGraphGenerator();
@@ -251,6 +338,12 @@ public:
 	void testForcedIds();
 	void testSceneGraphToUpdates();
 	void testRemoveParents();
+	void testSceneGraphSnapshot();
+	void testConcurrentSnapshotQueries();
+	void testUpdateObserverDispatcher();
+	void testUpdateObserverDispatcherCoalescing();
+	void testSceneGraphLogSnapshot();
+	void testSceneGraphLogAppend();
 
 private:
 	  /// Maximum deviation for equality check of double variables
@@ -314,6 +314,122 @@ void TemporalCacheTest::testCacheConfiguration() {
 	CPPUNIT_ASSERT(TimeStamp(0.0, Units::Second) == cache3.getMaxHistoryDuration());
 }
 
+void TemporalCacheTest::testLongHistory() {
+	typedef std::vector<std::pair<int, TimeStamp> >::const_iterator IntCacheIterator;
+	const int numberOfEntries = 10000;
+	TemporalCache<int> cache(TimeStamp(numberOfEntries, Units::Second));
+
+	/* stream of data: every entry is the latest one */
+	for (int i = 1; i <= numberOfEntries; ++i) {
+		cache.insertData(i, TimeStamp(i, Units::Second));
+		CPPUNIT_ASSERT_EQUAL(i, cache.getLatestData());
+	}
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(numberOfEntries), cache.getNumberOfCacheEntries());
+	CPPUNIT_ASSERT(cache.getOldestTimeStamp() == TimeStamp(1, Units::Second));
+	CPPUNIT_ASSERT(cache.getLatestTimeStamp() == TimeStamp(numberOfEntries, Units::Second));
+
+	for (int i = 1; i <= numberOfEntries; i += 7) {
+		CPPUNIT_ASSERT_EQUAL(i, cache.getData(TimeStamp(i, Units::Second)));
+		CPPUNIT_ASSERT_EQUAL(i, cache.getData(TimeStamp(i + 0.4, Units::Second)));
+		CPPUNIT_ASSERT_EQUAL(i, cache.getData(TimeStamp(i - 0.4, Units::Second)));
+	}
+	CPPUNIT_ASSERT_EQUAL(2, cache.getData(TimeStamp(1.5, Units::Second))); // tie: the newer one wins
+	CPPUNIT_ASSERT_EQUAL(1, cache.getData(TimeStamp(-100, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(numberOfEntries, cache.getData(TimeStamp(2 * numberOfEntries, Units::Second)));
+
+	/* descending order is preserved */
+	int counter = numberOfEntries;
+	for (IntCacheIterator iterator = cache.begin(); iterator != cache.end(); ++iterator) {
+		CPPUNIT_ASSERT_EQUAL(counter, iterator->first);
+		counter--;
+	}
+	CPPUNIT_ASSERT_EQUAL(0, counter);
+
+	/* an out of order insertion */
+	cache.insertData(-1, TimeStamp(100.25, Units::Second));
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(numberOfEntries + 1), cache.getNumberOfCacheEntries());
+	CPPUNIT_ASSERT_EQUAL(-1, cache.getData(TimeStamp(100.3, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(100, cache.getData(TimeStamp(100.1, Units::Second)));
+
+	/* the history slides with the stream */
+	cache.insertData(numberOfEntries + 1, TimeStamp(numberOfEntries + 1000, Units::Second));
+	CPPUNIT_ASSERT(cache.getOldestTimeStamp() == TimeStamp(1000, Units::Second));
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(numberOfEntries - 999 + 1), cache.getNumberOfCacheEntries());
+	CPPUNIT_ASSERT_EQUAL(numberOfEntries + 1, cache.getLatestData());
+
+	/* copies are independent */
+	TemporalCache<int> copiedCache(cache);
+	cache.clear();
+	CPPUNIT_ASSERT_EQUAL(0u, cache.getNumberOfCacheEntries());
+	CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(numberOfEntries - 999 + 1), copiedCache.getNumberOfCacheEntries());
+	CPPUNIT_ASSERT_EQUAL(numberOfEntries + 1, copiedCache.getLatestData());
+	CPPUNIT_ASSERT_EQUAL(1000, copiedCache.getData(TimeStamp(0, Units::Second)));
+}
+
+void TemporalCacheTest::testInterpolation() {
+	TemporalCache<int> cache;
+	CPPUNIT_ASSERT_EQUAL(0, cache.getInterpolatedData(TimeStamp(1.0, Units::Second))); // empty
+
+	cache.insertData(1, TimeStamp(1.0, Units::Second));
+	CPPUNIT_ASSERT_EQUAL(1, cache.getInterpolatedData(TimeStamp(0.0, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(1, cache.getInterpolatedData(TimeStamp(2.0, Units::Second)));
+
+	cache.insertData(2, TimeStamp(2.0, Units::Second));
+	cache.insertData(3, TimeStamp(3.0, Units::Second));
+
+	/* types without interpolation fall back to the closest entry */
+	CPPUNIT_ASSERT_EQUAL(1, cache.getInterpolatedData(TimeStamp(0.5, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(1, cache.getInterpolatedData(TimeStamp(1.4, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(2, cache.getInterpolatedData(TimeStamp(1.6, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(2, cache.getInterpolatedData(TimeStamp(2.0, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(3, cache.getInterpolatedData(TimeStamp(2.5, Units::Second)));
+	CPPUNIT_ASSERT_EQUAL(3, cache.getInterpolatedData(TimeStamp(10.0, Units::Second)));
+}
+
+void TemporalCacheTest::testTransformInterpolation() {
+	Transform::TransformPtr transform(new Transform());
+	CPPUNIT_ASSERT(transform->getInterpolatedTransform(TimeStamp(1.0, Units::Second)) == 0);
+
+	/* from identity to a rotation of 90 deg about z and a translation */
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform1(new HomogeneousMatrix44());
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr transform2(new HomogeneousMatrix44(0,-1,0, 1,0,0, 0,0,1, 2,4,-6));
+	transform->insertTransform(transform1, TimeStamp(1.0, Units::Second));
+	transform->insertTransform(transform2, TimeStamp(2.0, Units::Second));
+
+	CPPUNIT_ASSERT(transform->getLatestTransform() == transform2);
+	CPPUNIT_ASSERT(transform->getInterpolatedTransform(TimeStamp(0.0, Units::Second)) == transform1);
+	CPPUNIT_ASSERT(transform->getInterpolatedTransform(TimeStamp(1.0, Units::Second)) == transform1);
+	CPPUNIT_ASSERT(transform->getInterpolatedTransform(TimeStamp(2.0, Units::Second)) == transform2);
+	CPPUNIT_ASSERT(transform->getInterpolatedTransform(TimeStamp(3.0, Units::Second)) == transform2);
+
+	/* 45 deg at the half way */
+	IHomogeneousMatrix44::IHomogeneousMatrix44Ptr result = transform->getInterpolatedTransform(TimeStamp(1.5, Units::Second));
+	CPPUNIT_ASSERT(result != 0);
+	const double* matrix = result->getRawData();
+	double cos45 = sqrt(0.5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(cos45, matrix[0], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(cos45, matrix[1], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, matrix[2], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-cos45, matrix[4], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(cos45, matrix[5], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, matrix[6], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, matrix[8], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, matrix[9], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[10], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, matrix[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-3.0, matrix[14], maxTolerance);
+
+	/* a quarter of the way */
+	result = transform->getInterpolatedTransform(TimeStamp(1.25, Units::Second));
+	matrix = result->getRawData();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(cos(M_PI / 8.0), matrix[0], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(sin(M_PI / 8.0), matrix[1], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, matrix[12], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[13], maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.5, matrix[14], maxTolerance);
+}
+
 }
 
 /* EOF */
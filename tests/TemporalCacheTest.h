@@ -25,6 +25,7 @@
 
 #include <brics_3d/worldModel/sceneGraph/SceneGraphFacade.h>
 #include <brics_3d/worldModel/sceneGraph/TemporalCache.h>
+#include <brics_3d/core/HomogeneousMatrix44.h>
 
 
 namespace unitTests {
@@ -43,6 +44,9 @@ class TemporalCacheTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testSimpleCache );
 	CPPUNIT_TEST( testCacheInsertions );
 	CPPUNIT_TEST( testCacheConfiguration );
+	CPPUNIT_TEST( testLongHistory );
+	CPPUNIT_TEST( testInterpolation );
+	CPPUNIT_TEST( testTransformInterpolation );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -53,6 +57,9 @@ public:
 	void testSimpleCache();
 	void testCacheInsertions();
 	void testCacheConfiguration();
+	void testLongHistory();
+	void testInterpolation();
+	void testTransformInterpolation();
 
 private:
 
@@ -167,6 +167,46 @@ void TriangleMeshTest::testImplicitMeshModification() {
 	delete mesh;
 }
 
+void TriangleMeshTest::testMeshTransformation() {
+
+	/* rotate 90 deg about z and translate */
+	HomogeneousMatrix44 transformation(0,-1,0, 1,0,0, 0,0,1, 1,2,3);
+
+	TriangleMeshExplicit explicitMesh;
+	explicitMesh.addTriangle(*vertex000, *vertex100, *vertex101);
+	explicitMesh.addTriangle(*vertex101, *vertex110, *vertex111);
+	explicitMesh.homogeneousTransformation(&transformation);
+	CPPUNIT_ASSERT_EQUAL(2, explicitMesh.getSize());
+
+	/* (1,0,0) -> (1,3,3) */
+	Point3D* vertex = explicitMesh.getTriangleVertex(0, 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, vertex->getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, vertex->getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, vertex->getZ(), maxTolerance);
+
+	/* (1,1,1) -> (0,3,4) */
+	vertex = explicitMesh.getTriangleVertex(1, 2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, vertex->getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, vertex->getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, vertex->getZ(), maxTolerance);
+
+	/* all vertices of an implicit mesh are transformed like single points */
+	TriangleMeshImplicit implicitMesh;
+	Point3D* vertices[6] = {vertex000, vertex100, vertex101, vertex001, vertex110, vertex111};
+	for (int i = 0; i < 6; ++i) {
+		implicitMesh.getVertices()->push_back(*vertices[i]);
+	}
+	implicitMesh.homogeneousTransformation(&transformation);
+	CPPUNIT_ASSERT_EQUAL(6, implicitMesh.getNumberOfVertices());
+	for (int i = 0; i < 6; ++i) {
+		Point3D reference = *vertices[i];
+		reference.homogeneousTransformation(&transformation);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(reference.getX(), (*implicitMesh.getVertices())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(reference.getY(), (*implicitMesh.getVertices())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(reference.getZ(), (*implicitMesh.getVertices())[i].getZ(), maxTolerance);
+	}
+}
+
 }
 
 /* EOF */
@@ -14,6 +14,7 @@
 
 #include "brics_3d/core/TriangleMeshExplicit.h"
 #include "brics_3d/core/TriangleMeshImplicit.h"
+#include "brics_3d/core/HomogeneousMatrix44.h"
 
 using namespace brics_3d;
 using namespace std;
@@ -28,6 +29,7 @@ class TriangleMeshTest : public CPPUNIT_NS::TestFixture {
 	CPPUNIT_TEST( testImplicitMeshConstructor );
 	CPPUNIT_TEST( testPolymorphMeshConstructor );
 	CPPUNIT_TEST( testImplicitMeshModification );
+	CPPUNIT_TEST( testMeshTransformation );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -38,6 +40,7 @@ public:
 	void testImplicitMeshConstructor();
 	void testPolymorphMeshConstructor();
 	void testImplicitMeshModification();
+	void testMeshTransformation();
 
 private:
 
@@ -55,6 +58,8 @@ private:
 
 	ITriangleMesh* abstractMesh;
 
+	static const double maxTolerance = 0.00001;
+
 };
 
 }
@@ -0,0 +1,155 @@
+/**
+ * @file 
+ * VoxelGridFilterTest.cpp
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#include "VoxelGridFilterTest.h"
+#include <stdexcept>
+
+namespace unitTests {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( VoxelGridFilterTest );
+
+void VoxelGridFilterTest::setUp() {
+	pointCloudCube = new PointCloud3D();
+
+	pointCloudCube->addPoint(Point3D(0,0,0));
+	pointCloudCube->addPoint(Point3D(0,0,1));
+	pointCloudCube->addPoint(Point3D(0,1,1));
+	pointCloudCube->addPoint(Point3D(0,1,0));
+	pointCloudCube->addPoint(Point3D(1,0,0));
+	pointCloudCube->addPoint(Point3D(1,0,1));
+	pointCloudCube->addPoint(Point3D(1,1,1));
+	pointCloudCube->addPoint(Point3D(1,1,0));
+	pointCloudCube->addPoint(Point3D(1,1,0.9)); //some new points that will be filtered away
+	pointCloudCube->addPoint(Point3D(1,1,0.2));
+}
+
+void VoxelGridFilterTest::tearDown() {
+	delete pointCloudCube;
+}
+
+void VoxelGridFilterTest::testSetup() {
+	VoxelGridFilter voxelGrid;
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, voxelGrid.getVoxelSize(), maxTolerance);
+	voxelGrid.setVoxelSize(1.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, voxelGrid.getVoxelSize(), maxTolerance);
+	CPPUNIT_ASSERT_THROW(voxelGrid.setVoxelSize(-1.0), runtime_error); //check invalid input
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, voxelGrid.getVoxelSize(), maxTolerance);
+
+	CPPUNIT_ASSERT(voxelGrid.getReductionMode() == VoxelGridFilter::centroid);
+	voxelGrid.setReductionMode(VoxelGridFilter::firstPoint);
+	CPPUNIT_ASSERT(voxelGrid.getReductionMode() == VoxelGridFilter::firstPoint);
+
+	CPPUNIT_ASSERT_EQUAL(1u, voxelGrid.getNumberOfThreads());
+	voxelGrid.setNumberOfThreads(4);
+	CPPUNIT_ASSERT_EQUAL(4u, voxelGrid.getNumberOfThreads());
+	voxelGrid.setNumberOfThreads(0);
+	CPPUNIT_ASSERT(voxelGrid.getNumberOfThreads() >= 1u);
+}
+
+void VoxelGridFilterTest::testSizeReduction() {
+	IFiltering* filter = new VoxelGridFilter();
+	VoxelGridFilter* voxelGrid = dynamic_cast<VoxelGridFilter*>(filter);
+	CPPUNIT_ASSERT(voxelGrid != 0);
+
+	PointCloud3D* pointCloudResult = new PointCloud3D();
+
+	filter->filter(pointCloudCube, pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(10u, pointCloudCube->getSize()); //input size must not change
+	CPPUNIT_ASSERT_EQUAL(pointCloudCube->getSize(), pointCloudResult->getSize()); //no filtering involved with standard parameters
+
+	voxelGrid->setVoxelSize(0.05); //no change (too fine grid in this case)
+	filter->filter(pointCloudCube, pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(10u, pointCloudResult->getSize());
+
+	voxelGrid->setVoxelSize(0.5); // (1,1,0.2) falls into the same voxel as (1,1,0)
+	filter->filter(pointCloudCube, pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(9u, pointCloudResult->getSize());
+
+	voxelGrid->setVoxelSize(2.0);
+	filter->filter(pointCloudCube, pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(1u, pointCloudResult->getSize());
+
+	/* empty input */
+	PointCloud3D emptyPointCloud;
+	filter->filter(&emptyPointCloud, pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(0u, pointCloudResult->getSize());
+
+	CPPUNIT_ASSERT_EQUAL(10u, pointCloudCube->getSize());
+
+	delete pointCloudResult;
+	delete filter;
+}
+
+void VoxelGridFilterTest::testReductionModes() {
+	VoxelGridFilter voxelGrid;
+	PointCloud3D pointCloudResult;
+	voxelGrid.setVoxelSize(2.0);
+
+	voxelGrid.filter(pointCloudCube, &pointCloudResult); // centroid is default
+	CPPUNIT_ASSERT_EQUAL(1u, pointCloudResult.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.6, (*pointCloudResult.getPointCloud())[0].getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.6, (*pointCloudResult.getPointCloud())[0].getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.51, (*pointCloudResult.getPointCloud())[0].getZ(), maxTolerance);
+
+	voxelGrid.setReductionMode(VoxelGridFilter::center);
+	voxelGrid.filter(pointCloudCube, &pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(1u, pointCloudResult.getSize());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, (*pointCloudResult.getPointCloud())[0].getX(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, (*pointCloudResult.getPointCloud())[0].getY(), maxTolerance);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, (*pointCloudResult.getPointCloud())[0].getZ(), maxTolerance);
+
+	voxelGrid.setReductionMode(VoxelGridFilter::firstPoint);
+	voxelGrid.setVoxelSize(0.5);
+	voxelGrid.filter(pointCloudCube, &pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(9u, pointCloudResult.getSize());
+	for (unsigned int i = 0; i < pointCloudResult.getSize(); ++i) { // order of first occurrence
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getX(), (*pointCloudResult.getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getY(), (*pointCloudResult.getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*pointCloudCube->getPointCloud())[i].getZ(), (*pointCloudResult.getPointCloud())[i].getZ(), maxTolerance);
+	}
+
+	/* negative coordinates must not share a voxel with positive ones */
+	PointCloud3D pointCloud;
+	pointCloud.addPoint(Point3D(-0.1, -0.1, -0.1));
+	pointCloud.addPoint(Point3D(0.1, 0.1, 0.1));
+	voxelGrid.filter(&pointCloud, &pointCloudResult);
+	CPPUNIT_ASSERT_EQUAL(2u, pointCloudResult.getSize());
+}
+
+void VoxelGridFilterTest::testParallelFilter() {
+	PointCloud3D pointCloud;
+	for (int x = 0; x < 40; ++x) {
+		for (int y = 0; y < 40; ++y) {
+			for (int z = 0; z < 40; ++z) {
+				pointCloud.addPoint(Point3D(x * 0.1 - 2.0, y * 0.1 - 2.0, z * 0.1 + 0.01 * ((x + y) % 3)));
+			}
+		}
+	}
+
+	VoxelGridFilter voxelGrid;
+	voxelGrid.setVoxelSize(0.35);
+	PointCloud3D serialResult;
+	voxelGrid.filter(&pointCloud, &serialResult);
+	CPPUNIT_ASSERT(serialResult.getSize() > 1u);
+	CPPUNIT_ASSERT(serialResult.getSize() < pointCloud.getSize());
+
+	voxelGrid.setNumberOfThreads(4);
+	PointCloud3D parallelResult;
+	voxelGrid.filter(&pointCloud, &parallelResult);
+	CPPUNIT_ASSERT_EQUAL(serialResult.getSize(), parallelResult.getSize());
+	for (unsigned int i = 0; i < serialResult.getSize(); ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*serialResult.getPointCloud())[i].getX(), (*parallelResult.getPointCloud())[i].getX(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*serialResult.getPointCloud())[i].getY(), (*parallelResult.getPointCloud())[i].getY(), maxTolerance);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL((*serialResult.getPointCloud())[i].getZ(), (*parallelResult.getPointCloud())[i].getZ(), maxTolerance);
+	}
+}
+
+}  // namespace unitTests
+
+/* EOF */
@@ -0,0 +1,52 @@
+/**
+ * @file 
+ * VoxelGridFilterTest.h
+ *
+ * @date: Oct 18, 2026
+ * @author: sblume
+ */
+
+#ifndef VOXELGRIDFILTERTEST_H_
+#define VOXELGRIDFILTERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "brics_3d/algorithm/filtering/IFiltering.h"
+#include "brics_3d/algorithm/filtering/VoxelGridFilter.h"
+
+using namespace std;
+using namespace brics_3d;
+
+namespace unitTests {
+
+class VoxelGridFilterTest : public CPPUNIT_NS::TestFixture {
+
+	CPPUNIT_TEST_SUITE( VoxelGridFilterTest );
+	CPPUNIT_TEST( testSetup );
+	CPPUNIT_TEST( testSizeReduction );
+	CPPUNIT_TEST( testReductionModes );
+	CPPUNIT_TEST( testParallelFilter );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+	void tearDown();
+
+	void testSetup();
+	void testSizeReduction();
+	void testReductionModes();
+	void testParallelFilter();
+
+private:
+
+	static const double maxTolerance = 0.00001;
+
+	PointCloud3D* pointCloudCube;
+};
+
+}
+
+#endif /* VOXELGRIDFILTERTEST_H_ */
+
+/* EOF */